@@ -17,6 +17,9 @@
 #include <catboost/libs/cat_feature/cat_feature.h>
 #include <catboost/libs/model/model_export/model_exporter.h>
 
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
 #include <util/generic/mem_copy.h>
 #include <util/generic/singleton.h>
@@ -25,6 +28,7 @@
 #include <util/system/info.h>
 
 #include <algorithm>
+#include <limits>
 
 #if defined(SIZEOF_SIZE_T)
 #undef SIZEOF_SIZE_T
@@ -104,6 +108,83 @@ static NJson::TJsonValue LoadFitParams(SEXP fitParamsAsJson) {
     return result;
 }
 
+namespace {
+    /* Feature column of R matrix or data.frame.
+     * R API is accessed only on creation, so columns can be converted in parallel afterwards.
+     */
+    struct TRFeatureColumn {
+        const double* RealValues = nullptr;
+        const int* IntValues = nullptr; // integer, logical or factor codes
+
+        bool IsFactor = false;
+        // hashes of factor levels indexed by (code - 1), the last element is the hash of missing values
+        TVector<ui32> FactorLevelHashes;
+
+    public:
+        float GetFloatValue(ui32 objectIdx) const {
+            if (RealValues) {
+                return static_cast<float>(RealValues[objectIdx]);
+            }
+            const int value = IntValues[objectIdx];
+            return (value == NA_INTEGER) ? std::numeric_limits<float>::quiet_NaN() : static_cast<float>(value);
+        }
+
+        ui32 GetCatValue(ui32 objectIdx) const {
+            if (IsFactor) {
+                const int code = IntValues[objectIdx];
+                return (code == NA_INTEGER) ? FactorLevelHashes.back() : FactorLevelHashes[code - 1];
+            }
+            // values of non-factor categorical columns are already hashed with CatBoostHashStrings_R
+            return ConvertFloatCatFeatureToIntHash(GetFloatValue(objectIdx));
+        }
+    };
+}
+
+static TRFeatureColumn MakeRFeatureColumn(SEXP values, size_t offset) {
+    TRFeatureColumn column;
+    switch (TYPEOF(values)) {
+        case REALSXP:
+            column.RealValues = REAL(values) + offset;
+            break;
+        case INTSXP:
+            column.IntValues = INTEGER(values) + offset;
+            if (isFactor(values)) {
+                column.IsFactor = true;
+                SEXP levels = getAttrib(values, R_LevelsSymbol);
+                column.FactorLevelHashes.yresize(length(levels) + 1);
+                for (auto levelIdx : xrange(length(levels))) {
+                    column.FactorLevelHashes[levelIdx] = CalcCatFeatureHash(CHAR(STRING_ELT(levels, levelIdx)));
+                }
+                column.FactorLevelHashes.back() = CalcCatFeatureHash(CHAR(NA_STRING));
+            }
+            break;
+        case LGLSXP:
+            column.IntValues = LOGICAL(values) + offset;
+            break;
+        default:
+            CB_ENSURE(false, "unsupported feature column type: numeric, integer, logical or factor is required");
+    }
+    return column;
+}
+
+// matrixParam is either a column-major matrix or a data.frame (a list of columns)
+static TVector<TRFeatureColumn> GetRFeatureColumns(SEXP matrixParam, ui32 dataRows, ui32 dataColumns) {
+    TVector<TRFeatureColumn> result;
+    result.reserve(dataColumns);
+    for (auto featureIdx : xrange(dataColumns)) {
+        if (TYPEOF(matrixParam) == VECSXP) {
+            SEXP column = VECTOR_ELT(matrixParam, featureIdx);
+            CB_ENSURE(
+                SafeIntegerCast<ui32>(length(column)) == dataRows,
+                "data.frame column " << featureIdx << " length differs from the object count");
+            result.push_back(MakeRFeatureColumn(column, /*offset*/ 0));
+        } else {
+            result.push_back(MakeRFeatureColumn(matrixParam, (size_t)dataRows * featureIdx));
+        }
+    }
+    return result;
+}
+
 static int UpdateThreadCount(int threadCount) {
     if (threadCount == -1) {
         threadCount = NSystemInfo::CachedNumberOfCpus();
@@ -173,9 +254,17 @@ SEXP CatBoostCreateFromMatrix_R(SEXP matrixParam,
                                 SEXP featureNamesParam) {
     SEXP result = NULL;
     R_API_BEGIN();
-    SEXP dataDim = getAttrib(matrixParam, R_DimSymbol);
-    ui32 dataRows = SafeIntegerCast<ui32>(INTEGER(dataDim)[0]);
-    ui32 dataColumns = SafeIntegerCast<ui32>(INTEGER(dataDim)[1]);
+    ui32 dataRows = 0;
+    ui32 dataColumns = 0;
+    if (TYPEOF(matrixParam) == VECSXP) {
+        dataColumns = SafeIntegerCast<ui32>(length(matrixParam));
+        dataRows = dataColumns ? SafeIntegerCast<ui32>(length(VECTOR_ELT(matrixParam, 0))) : 0;
+    } else {
+        SEXP dataDim = getAttrib(matrixParam, R_DimSymbol);
+        dataRows = SafeIntegerCast<ui32>(INTEGER(dataDim)[0]);
+        dataColumns = SafeIntegerCast<ui32>(INTEGER(dataDim)[1]);
+    }
+    const TVector<TRFeatureColumn> featureColumns = GetRFeatureColumns(matrixParam, dataRows, dataColumns);
     SEXP targetDim = getAttrib(targetParam, R_DimSymbol);
     ui32 targetRows = 0;
     ui32 targetColumns = 0;
@@ -201,9 +290,18 @@ SEXP CatBoostCreateFromMatrix_R(SEXP matrixParam,
             }
         }
 
+        // factor columns are categorical even if they are not listed explicitly
+        TVector<ui32> catFeatures = ToUnsigned(GetVectorFromSEXP<int>(catFeaturesParam));
+        for (auto featureIdx : xrange(dataColumns)) {
+            if (featureColumns[featureIdx].IsFactor && !IsIn(catFeatures, featureIdx)) {
+                catFeatures.push_back(featureIdx);
+            }
+        }
+        Sort(catFeatures);
+
         metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
             dataColumns,
-            ToUnsigned(GetVectorFromSEXP<int>(catFeaturesParam)),
+            catFeatures,
             TVector<ui32>{}, // TODO(d-kruchinin) support text features in R
             featureId);
 
@@ -262,22 +360,40 @@ SEXP CatBoostCreateFromMatrix_R(SEXP matrixParam,
             }
         }
 
-        for (size_t j = 0; j < dataColumns; ++j) {
-            if (metaInfo.FeaturesLayout->GetExternalFeatureType(j) == EFeatureType::Categorical) {
-                TVector<ui32> catValues;
-                catValues.yresize(dataRows);
-                for (ui32 i = 0; i < dataRows; ++i) {
-                    catValues[i] =
-                        ConvertFloatCatFeatureToIntHash(static_cast<float>(REAL(matrixParam)[i + dataRows * j]));
+        // columns are converted in parallel, R API is not called inside the loop
+        TVector<TVector<float>> floatValues(dataColumns);
+        TVector<TVector<ui32>> catValues(dataColumns);
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(NSystemInfo::CachedNumberOfCpus() - 1);
+        localExecutor.ExecRangeWithThrow(
+            [&] (int featureIdx) {
+                const auto& column = featureColumns[featureIdx];
+                if (metaInfo.FeaturesLayout->GetExternalFeatureType(featureIdx) == EFeatureType::Categorical) {
+                    catValues[featureIdx].yresize(dataRows);
+                    for (auto objectIdx : xrange(dataRows)) {
+                        catValues[featureIdx][objectIdx] = column.GetCatValue(objectIdx);
+                    }
+                } else {
+                    CB_ENSURE(!column.IsFactor, "factor column " << featureIdx << " is not categorical");
+                    floatValues[featureIdx].yresize(dataRows);
+                    for (auto objectIdx : xrange(dataRows)) {
+                        floatValues[featureIdx][objectIdx] = column.GetFloatValue(objectIdx);
+                    }
                 }
-                visitor->AddCatFeature(j, TMaybeOwningConstArrayHolder<ui32>::CreateOwning(std::move(catValues)));
+            },
+            0,
+            SafeIntegerCast<int>(dataColumns),
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+
+        for (auto featureIdx : xrange(dataColumns)) {
+            if (metaInfo.FeaturesLayout->GetExternalFeatureType(featureIdx) == EFeatureType::Categorical) {
+                visitor->AddCatFeature(
+                    featureIdx,
+                    TMaybeOwningConstArrayHolder<ui32>::CreateOwning(std::move(catValues[featureIdx])));
             } else {
-                TVector<float> floatValues;
-                floatValues.yresize(dataRows);
-                for (ui32 i = 0; i < dataRows; ++i) {
-                    floatValues[i] = static_cast<float>(REAL(matrixParam)[i + dataRows * j]);
-                }
-                visitor->AddFloatFeature(j, MakeTypeCastArrayHolderFromVector<float, float>(floatValues));
+                visitor->AddFloatFeature(
+                    featureIdx,
+                    MakeTypeCastArrayHolderFromVector<float, float>(floatValues[featureIdx]));
             }
         }
 
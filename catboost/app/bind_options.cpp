@@ -374,6 +374,12 @@ static void BindOutputParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* p
             (*plainJsonPtr)["snapshot_interval"] = FromString<int>(interval);
         });
 
+    parser.AddLongOption("init-model-approxes-cache", "file to store approxes of the init model on learn and eval datasets for reuse in training continuations")
+        .RequiredArgument("PATH")
+        .Handler1T<TString>([plainJsonPtr](const TString& path) {
+            (*plainJsonPtr)["init_model_approxes_cache"] = path;
+        });
+
     parser.AddLongOption("output-columns")
             .RequiredArgument("Comma separated list of column indexes")
             .Handler1T<TString>([plainJsonPtr](const TString& indexesLine) {
@@ -750,6 +756,18 @@ static void BindTreeParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* pla
                 (*plainJsonPtr)["sparse_features_conflict_fraction"] = fraction;
             });
 
+    const auto histogramPrecisionHelp = TString::Join(
+        "CPU only. Precision of bucket statistics accumulation in score calculation. "
+        "Float halves the memory traffic of statistics updates but changes results "
+        "due to numerical accuracy differences. Possible values are ",
+        GetEnumAllNames<EHistogramPrecision>());
+    parser.AddLongOption("cpu-histogram-precision")
+        .RequiredArgument("string")
+        .Handler1T<EHistogramPrecision>([plainJsonPtr](const EHistogramPrecision precision) {
+            (*plainJsonPtr)["cpu_histogram_precision"] = ToString(precision);
+        })
+        .Help(histogramPrecisionHelp);
+
     parser.AddLongOption("random-strength")
         .RequiredArgument("float")
         .Handler1T<float>([plainJsonPtr](float randomStrength) {
@@ -849,7 +867,7 @@ static void BindTreeParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* pla
         .Handler1T<float>([plainJsonPtr](float rate) {
             (*plainJsonPtr)["subsample"] = rate;
         })
-        .Help("Controls sample rate for bagging. Could be used iff bootstrap-type is Poisson, Bernoulli or MVS. \
+        .Help("Controls sample rate for bagging. Could be used iff bootstrap-type is Poisson, Bernoulli, MVS or GOSS. \
             Possible values are from (0, 1]; 0.66 by default for Bernoulli and Poisson, 0.8 by default for MVS."
         );
 
@@ -861,6 +879,16 @@ static void BindTreeParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* pla
         })
         .Help("Controls the weight of denominator in MVS procedure.");
 
+    parser
+        .AddLongOption("goss-top-rate")
+        .RequiredArgument("Float")
+        .Handler1T<float>([plainJsonPtr](float gossTopRate) {
+            (*plainJsonPtr)["goss_top_rate"] = gossTopRate;
+        })
+        .Help("Fraction of objects with the largest gradients that are always taken by GOSS bootstrap. \
+            The rest of objects are sampled to get subsample fraction in total. Possible values are from [0, subsample]; 0.2 by default."
+        );
+
     parser
         .AddLongOption("observations-to-bootstrap")
         .RequiredArgument("FLAG")
@@ -10,12 +10,17 @@
 #include <catboost/libs/model/model.h>
 #include <catboost/private/libs/options/analytical_mode_params.h>
 #include <catboost/private/libs/options/loss_description.h>
+#include <catboost/private/libs/options/output_file_options.h>
 #include <catboost/private/libs/target/data_providers.h>
 
 #include <library/cpp/getopt/small/last_getopt_opts.h>
 #include <library/cpp/getopt/small/last_getopt_parse_result.h>
 
+#include <util/folder/path.h>
 #include <util/folder/tempdir.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/string/cast.h>
 #include <util/string/split.h>
 #include <util/system/compiler.h>
 
@@ -31,6 +36,7 @@ struct TModeEvalMetricsParams {
     TString MetricsDescription;
     TString ResultDirectory;
     TString TmpDir;
+    TVector<TString> ExtraModelFileNames;
 
     void BindParserOpts(NLastGetopt::TOpts& parser) {
         parser.AddLongOption("ntree-start", "Start iteration.")
@@ -56,6 +62,11 @@ struct TModeEvalMetricsParams {
                 .RequiredArgument("String")
                 .DefaultValue("-")
                 .StoreResult(&TmpDir);
+        parser.AddLongOption("extra-model-file",
+                "Model to evaluate during the same passes over the dataset, can be repeated. "
+                "With extra models results are saved to <result-dir>/<model index>, 0 is for --model-file.")
+                .RequiredArgument("PATH")
+                .AppendTo(&ExtraModelFileNames);
     }
 };
 
@@ -73,27 +84,106 @@ static TVector<NCatboostOptions::TLossDescription> CreateMetricDescriptions(
 }
 
 
-static void ReadDatasetParts(
-    const NCB::TAnalyticalModeCommonParams& params,
-    int blockSize,
-    TConstArrayRef<NCatboostOptions::TLossDescription> metricDescriptions,
-    const TFullModel& model,
-    TRestorableFastRng64* rand,
-    NPar::TLocalExecutor* executor,
-    TVector<TProcessedDataProvider>* processedDatasetParts) {
-
-    processedDatasetParts->clear();
-    ReadAndProceedPoolInBlocks(params.DatasetReadingParams, blockSize, [&](TDataProviderPtr datasetPart) {
-        auto processedDataProvider = CreateModelCompatibleProcessedDataProvider(
-            *datasetPart,
-            metricDescriptions,
-            model,
-            GetMonopolisticFreeCpuRam(),
-            rand,
-            executor);
-        processedDatasetParts->push_back(std::move(processedDataProvider));
-    },
-    executor);
+namespace {
+    // models evaluated during the same passes over the dataset
+    class TEvaluatedModels {
+    public:
+        TEvaluatedModels(
+            const NCB::TAnalyticalModeCommonParams& params,
+            const TModeEvalMetricsParams& plotParams,
+            NPar::TLocalExecutor* executor)
+            : MetricDescriptions(CreateMetricDescriptions(plotParams.MetricsDescription))
+        {
+            Models.push_back(ReadModel(params.ModelFileName, params.ModelFormat));
+            for (const auto& modelFileName : plotParams.ExtraModelFileNames) {
+                Models.push_back(ReadModel(modelFileName, NCatboostOptions::DefineModelFormat(modelFileName)));
+            }
+
+            const size_t modelCount = Models.size();
+            Metrics.reserve(modelCount);
+            PlotCalcers.reserve(modelCount);
+            DatasetParts.resize(modelCount);
+            for (auto modelIdx : xrange(modelCount)) {
+                const TFullModel& model = Models[modelIdx];
+                CB_ENSURE(
+                    model.GetUsedCatFeaturesCount() == 0
+                        || params.DatasetReadingParams.ColumnarPoolFormatParams.CdFilePath.Inited(),
+                    "Model has categorical features. Specify column_description file with correct categorical features.");
+                CB_ENSURE(
+                    model.GetModelClassLabels() == Models[0].GetModelClassLabels(),
+                    "All models must have the same class labels");
+
+                TString tmpDir = plotParams.TmpDir;
+                if (tmpDir == "-") {
+                    tmpDir = TTempDir().Name();
+                } else if (modelCount > 1) {
+                    tmpDir += "_" + ToString(modelIdx);
+                }
+
+                Metrics.push_back(CreateMetrics(MetricDescriptions, model.GetDimensionsCount()));
+                PlotCalcers.push_back(
+                    CreateMetricCalcer(
+                        model,
+                        plotParams.FirstIteration,
+                        plotParams.EndIteration,
+                        plotParams.Step,
+                        /*processedIterationsStep=*/50, // TODO(nikitxskv): Make auto estimation of this parameter based on the free RAM and pool size.
+                        tmpDir,
+                        Metrics.back(),
+                        executor));
+            }
+        }
+
+        size_t GetModelCount() const {
+            return Models.size();
+        }
+
+        const TFullModel& GetModel(size_t modelIdx) const {
+            return Models[modelIdx];
+        }
+
+        TMetricsPlotCalcer& GetPlotCalcer(size_t modelIdx) {
+            return PlotCalcers[modelIdx];
+        }
+
+        TVector<TProcessedDataProvider>& GetDatasetParts(size_t modelIdx) {
+            return DatasetParts[modelIdx];
+        }
+
+        TProcessedDataProvider CreateProcessedDataProvider(
+            const TDataProvider& datasetPart,
+            size_t modelIdx,
+            TRestorableFastRng64* rand,
+            NPar::TLocalExecutor* executor) const {
+
+            return CreateModelCompatibleProcessedDataProvider(
+                datasetPart,
+                MetricDescriptions,
+                Models[modelIdx],
+                GetMonopolisticFreeCpuRam(),
+                rand,
+                executor);
+        }
+
+        bool HasAdditiveMetric() const {
+            return AnyOf(PlotCalcers, [] (const TMetricsPlotCalcer& plotCalcer) { return plotCalcer.HasAdditiveMetric(); });
+        }
+
+        bool HasNonAdditiveMetric() const {
+            return AnyOf(PlotCalcers, [] (const TMetricsPlotCalcer& plotCalcer) { return plotCalcer.HasNonAdditiveMetric(); });
+        }
+
+        bool AreAllIterationsProcessed() const {
+            return AllOf(PlotCalcers, [] (const TMetricsPlotCalcer& plotCalcer) { return plotCalcer.AreAllIterationsProcessed(); });
+        }
+
+    private:
+        TVector<NCatboostOptions::TLossDescription> MetricDescriptions;
+        TVector<TFullModel> Models;
+        TVector<TVector<THolder<IMetric>>> Metrics; // referenced by PlotCalcers
+        TVector<TMetricsPlotCalcer> PlotCalcers;
+        TVector<TVector<TProcessedDataProvider>> DatasetParts;
+    };
 }
 
 
@@ -129,86 +219,103 @@ int mode_eval_metrics(int argc, const char* argv[]) {
 
     params.DatasetReadingParams.ValidatePoolParams();
 
-    TFullModel model = ReadModel(params.ModelFileName, params.ModelFormat);
-    CB_ENSURE(
-        model.GetUsedCatFeaturesCount() == 0 || params.DatasetReadingParams.ColumnarPoolFormatParams.CdFilePath.Inited(),
-        "Model has categorical features. Specify column_description file with correct categorical features.");
-    params.DatasetReadingParams.ClassLabels = model.GetModelClassLabels();
-
-    if (plotParams.EndIteration == 0) {
-        plotParams.EndIteration = model.GetTreeCount();
-    }
-    if (plotParams.TmpDir == "-") {
-        plotParams.TmpDir = TTempDir().Name();
-    }
-
     NPar::TLocalExecutor executor;
     executor.RunAdditionalThreads(params.ThreadCount - 1);
 
-    TRestorableFastRng64 rand(0);
+    TEvaluatedModels models(params, plotParams, &executor);
+    params.DatasetReadingParams.ClassLabels = models.GetModel(0).GetModelClassLabels();
 
-    auto metricDescriptions = CreateMetricDescriptions(plotParams.MetricsDescription);
-    auto metrics = CreateMetrics(metricDescriptions, model.GetDimensionsCount());
+    const size_t modelCount = models.GetModelCount();
 
-    TMetricsPlotCalcer plotCalcer = CreateMetricCalcer(
-        model,
-        plotParams.FirstIteration,
-        plotParams.EndIteration,
-        plotParams.Step,
-        /*processedIterationsStep=*/50, // TODO(nikitxskv): Make auto estimation of this parameter based on the free RAM and pool size.
-        plotParams.TmpDir,
-        metrics,
-        &executor
-    );
+    // each dataset block is read and parsed once and then passed to all models
+    TVector<TRestorableFastRng64> rands;
+    rands.reserve(modelCount);
+    for (size_t i = 0; i < modelCount; ++i) {
+        rands.emplace_back(0);
+    }
 
-    TVector<TProcessedDataProvider> datasetParts;
-    if (plotCalcer.HasAdditiveMetric()) {
+    if (models.HasAdditiveMetric()) {
         ReadAndProceedPoolInBlocks(
             params.DatasetReadingParams,
             plotParams.ReadBlockSize,
             [&](TDataProviderPtr datasetPart) {
-                auto processedDataProvider = CreateModelCompatibleProcessedDataProvider(
-                    *datasetPart,
-                    metricDescriptions,
-                    model,
-                    GetMonopolisticFreeCpuRam(),
-                    &rand,
-                    &executor);
-
-                plotCalcer.ProceedDataSetForAdditiveMetrics(processedDataProvider);
-                if (plotCalcer.HasNonAdditiveMetric() && !calcOnParts) {
-                    datasetParts.push_back(std::move(processedDataProvider));
+                for (auto modelIdx : xrange(modelCount)) {
+                    auto& plotCalcer = models.GetPlotCalcer(modelIdx);
+                    auto processedDataProvider = models.CreateProcessedDataProvider(
+                        *datasetPart,
+                        modelIdx,
+                        &rands[modelIdx],
+                        &executor);
+
+                    plotCalcer.ProceedDataSetForAdditiveMetrics(processedDataProvider);
+                    if (plotCalcer.HasNonAdditiveMetric() && !calcOnParts) {
+                        models.GetDatasetParts(modelIdx).push_back(std::move(processedDataProvider));
+                    }
                 }
             },
             &executor);
     }
 
-    if (plotCalcer.HasNonAdditiveMetric() && calcOnParts) {
-        while (!plotCalcer.AreAllIterationsProcessed()) {
+    if (models.HasNonAdditiveMetric() && calcOnParts) {
+        while (!models.AreAllIterationsProcessed()) {
+            TVector<size_t> modelsToProceed;
+            for (auto modelIdx : xrange(modelCount)) {
+                const auto& plotCalcer = models.GetPlotCalcer(modelIdx);
+                if (plotCalcer.HasNonAdditiveMetric() && !plotCalcer.AreAllIterationsProcessed()) {
+                    modelsToProceed.push_back(modelIdx);
+                }
+            }
             ReadAndProceedPoolInBlocks(
                 params.DatasetReadingParams,
                 plotParams.ReadBlockSize,
                 [&](TDataProviderPtr datasetPart) {
-                    auto processedDataProvider = CreateModelCompatibleProcessedDataProvider(
-                        *datasetPart,
-                        metricDescriptions,
-                        model,
-                        GetMonopolisticFreeCpuRam(),
-                        &rand,
-                        &executor);
-                    plotCalcer.ProceedDataSetForNonAdditiveMetrics(processedDataProvider);
+                    for (auto modelIdx : modelsToProceed) {
+                        auto processedDataProvider = models.CreateProcessedDataProvider(
+                            *datasetPart,
+                            modelIdx,
+                            &rands[modelIdx],
+                            &executor);
+                        models.GetPlotCalcer(modelIdx).ProceedDataSetForNonAdditiveMetrics(processedDataProvider);
+                    }
                 },
                 &executor);
-            plotCalcer.FinishProceedDataSetForNonAdditiveMetrics();
+            for (auto modelIdx : modelsToProceed) {
+                models.GetPlotCalcer(modelIdx).FinishProceedDataSetForNonAdditiveMetrics();
+            }
         }
     }
 
-    if (plotCalcer.HasNonAdditiveMetric() && !calcOnParts) {
-        if (datasetParts.empty()) {
-            ReadDatasetParts(params, plotParams.ReadBlockSize, metricDescriptions, model, &rand, &executor, &datasetParts);
+    if (models.HasNonAdditiveMetric() && !calcOnParts) {
+        if (!models.HasAdditiveMetric()) {
+            ReadAndProceedPoolInBlocks(
+                params.DatasetReadingParams,
+                plotParams.ReadBlockSize,
+                [&](TDataProviderPtr datasetPart) {
+                    for (auto modelIdx : xrange(modelCount)) {
+                        if (models.GetPlotCalcer(modelIdx).HasNonAdditiveMetric()) {
+                            models.GetDatasetParts(modelIdx).push_back(
+                                models.CreateProcessedDataProvider(*datasetPart, modelIdx, &rands[modelIdx], &executor));
+                        }
+                    }
+                },
+                &executor);
+        }
+        for (auto modelIdx : xrange(modelCount)) {
+            auto& plotCalcer = models.GetPlotCalcer(modelIdx);
+            if (plotCalcer.HasNonAdditiveMetric()) {
+                plotCalcer.ComputeNonAdditiveMetrics(models.GetDatasetParts(modelIdx));
+            }
         }
-        plotCalcer.ComputeNonAdditiveMetrics(datasetParts);
     }
-    plotCalcer.SaveResult(plotParams.ResultDirectory, params.OutputPath.Path, true /*saveMetrics*/, saveStats).ClearTempFiles();
+
+    for (auto modelIdx : xrange(modelCount)) {
+        // results of extra models are saved to subdirectories named by model index
+        const TString resultDirectory = (modelCount == 1) ?
+            plotParams.ResultDirectory :
+            JoinFsPaths(plotParams.ResultDirectory, ToString(modelIdx));
+        models.GetPlotCalcer(modelIdx)
+            .SaveResult(resultDirectory, params.OutputPath.Path, true /*saveMetrics*/, saveStats)
+            .ClearTempFiles();
+    }
     return 0;
 }
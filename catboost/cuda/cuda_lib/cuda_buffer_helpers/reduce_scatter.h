@@ -546,6 +546,28 @@ namespace NCudaLib {
         }
     };
 
+    //elements which would be reduced between devices of the same host without peer access,
+    //such reduces are staged through a temp buffer and are much slower than NVLink / same PCI root transfers
+    template <EReduceAlgorithm Algorithm>
+    inline ui64 CountStagedLocalReduceSize(const TStripeMapping& resultMapping) {
+        auto& manager = GetCudaManager();
+        const ui32 devCount = manager.GetDeviceCount();
+        const auto& peerDevicesHelper = GetPeerDevicesHelper();
+
+        TPassTasksGenerator<Algorithm> tasksGenerator(resultMapping, devCount);
+        ui64 stagedSize = 0;
+        for (ui32 pass = 0; pass < tasksGenerator.GetPassCount(); ++pass) {
+            for (const TReduceTask& task : tasksGenerator.PassTasks(pass)) {
+                const auto readDevice = manager.GetDeviceId(task.ReadDevice);
+                const auto writeDevice = manager.GetDeviceId(task.WriteDevice);
+                if (readDevice.HostId == writeDevice.HostId && !peerDevicesHelper.HasPeerAccess(readDevice.DeviceId, writeDevice.DeviceId)) {
+                    stagedSize += task.ToSlice.Size();
+                }
+            }
+        }
+        return stagedSize;
+    }
+
     template <class T, EReduceAlgorithm Algorithm>
     inline void RunReduceScatter(TCudaBuffer<T, NCudaLib::TStripeMapping>& data,
                                  NCudaLib::TStripeMapping& reducedMapping,
@@ -565,7 +587,10 @@ inline void ReduceScatter(TCudaBuffer<T, NCudaLib::TStripeMapping>& data,
                           ui32 streamId) {
     const bool isPowerOfTwoDevice = IsPowerOf2(NCudaLib::GetCudaManager().GetDeviceCount());
     //TODO(noxoomo): tree-reduce for non power of two devices + performance check
-    if (isPowerOfTwoDevice) {
+    //tree has less passes, but it pairs distant devices, so ring is used if it needs less transfers without peer access
+    if (isPowerOfTwoDevice &&
+        NCudaLib::CountStagedLocalReduceSize<NCudaLib::EReduceAlgorithm::Tree>(reducedMapping) <=
+        NCudaLib::CountStagedLocalReduceSize<NCudaLib::EReduceAlgorithm::Ring>(reducedMapping)) {
         NCudaLib::RunReduceScatter<T, NCudaLib::EReduceAlgorithm::Tree>(data, reducedMapping, compress, streamId);
     } else {
         NCudaLib::RunReduceScatter<T, NCudaLib::EReduceAlgorithm::Ring>(data, reducedMapping, compress, streamId);
@@ -128,6 +128,16 @@ namespace NCudaLib {
         ui64 FreeMemory;
         TIntrusivePtr<TAllocatedBlock> LastBlock;
 
+        // first free block before the last one that can hold size bytes
+        TAllocatedBlock* FindFreeHole(ui64 size) const {
+            for (TAllocatedBlock* cursor = FirstFreeBlock.Get(); cursor != LastBlock.Get(); cursor = cursor->Next.Get()) {
+                if (cursor->IsFree && cursor->Size >= size) {
+                    return cursor;
+                }
+            }
+            return nullptr;
+        }
+
         ui64 CalculateFragmentedMemorySize() const {
             ui64 fragmentedMemory = 0;
             TAllocatedBlock* cursor = FirstFreeBlock.Get();
@@ -200,8 +210,12 @@ namespace NCudaLib {
 
             const ui64 defragmentedMemory = (temp - (startPtr + writeOffset));
             GetDefaultStream().Synchronize();
+            const TDuration defragmentationTime = Now() - startTime;
+            ++Stats.DefragmentationCount;
+            Stats.MovedBytes += newBlockOffset;
+            Stats.DefragmentationTime += defragmentationTime;
             CATBOOST_DEBUG_LOG << "Defragment " << defragmentedMemory * 1.0 / 1024 / 1024 << " memory"
-                               << " in " << (Now() - startTime).SecondsFloat() << " seconds " << Endl;
+                               << " in " << defragmentationTime.SecondsFloat() << " seconds " << Endl;
             LastBlock->Size += defragmentedMemory;
             LastBlock->Ptr = startPtr + writeOffset;
 
@@ -215,6 +229,17 @@ namespace NCudaLib {
                    MEMORY_ALIGMENT_BYTES;
         }
 
+    public:
+        struct TMemoryPoolStats {
+            ui64 DefragmentationCount = 0;
+            ui64 MovedBytes = 0; // live memory copied by defragmentations
+            TDuration DefragmentationTime;
+            ui64 AllocationsInFreeHoles = 0; // allocations that avoided defragmentation
+        };
+
+    private:
+        TMemoryPoolStats Stats;
+
     public:
         template <typename T>
         class TMemoryBlock: private TNonCopyable {
@@ -265,6 +290,9 @@ namespace NCudaLib {
         }
 
         ~TStackLikeMemoryPool() noexcept(false) {
+            CATBOOST_DEBUG_LOG << "Memory pool: " << Stats.DefragmentationCount << " defragmentations moved "
+                               << Stats.MovedBytes / MB << " MB in " << Stats.DefragmentationTime.SecondsFloat() << " seconds, "
+                               << Stats.AllocationsInFreeHoles << " allocations reused free blocks" << Endl;
             TAllocatedBlock* block = LastBlock.Get();
 
             while (block != nullptr) {
@@ -281,7 +309,8 @@ namespace NCudaLib {
         bool NeedSyncForAllocation(ui64 size) const {
             const ui64 requestedBlockSize = GetBlockSize<T>(size) + MEMORY_REQUEST_ADJUSTMENT;
             const bool canUseFirstFreeBlock = FirstFreeBlock != LastBlock && (FirstFreeBlock->Size >= requestedBlockSize);
-            return (LastBlock->Size < requestedBlockSize || ((LastBlock->Size - requestedBlockSize) <= MINIMUM_FREE_MEMORY_TO_DEFRAGMENTATION)) && !canUseFirstFreeBlock;
+            const bool needDefragment = (LastBlock->Size < requestedBlockSize || ((LastBlock->Size - requestedBlockSize) <= MINIMUM_FREE_MEMORY_TO_DEFRAGMENTATION)) && !canUseFirstFreeBlock;
+            return needDefragment && (FindFreeHole(GetBlockSize<T>(size)) == nullptr);
         }
 
         template <typename T = char>
@@ -296,14 +325,21 @@ namespace NCudaLib {
             } else {
                 const ui64 adjustedMemoryRequestSize = (requestedBlockSize + MEMORY_REQUEST_ADJUSTMENT);
                 const bool needDefragment = (LastBlock->Size < adjustedMemoryRequestSize || ((LastBlock->Size - requestedBlockSize) <= MINIMUM_FREE_MEMORY_TO_DEFRAGMENTATION));
-                if (needDefragment) {
-                    TryDefragment();
-                }
-                if (LastBlock->Size < adjustedMemoryRequestSize) {
-                    ythrow TOutOfMemoryError() << "Error: Out of memory. Requested " << requestedBlockSize / MB << " MB; Free "
-                                               << (LastBlock->Size) / MB << " MB";
+                // a free block between live ones can be reused without moving anything
+                TAllocatedBlock* freeHole = needDefragment ? FindFreeHole(requestedBlockSize) : nullptr;
+                if (freeHole) {
+                    ++Stats.AllocationsInFreeHoles;
+                    block = SplitFreeBlock(TIntrusivePtr<TAllocatedBlock>(freeHole), requestedBlockSize);
+                } else {
+                    if (needDefragment) {
+                        TryDefragment();
+                    }
+                    if (LastBlock->Size < adjustedMemoryRequestSize) {
+                        ythrow TOutOfMemoryError() << "Error: Out of memory. Requested " << requestedBlockSize / MB << " MB; Free "
+                                                   << (LastBlock->Size) / MB << " MB";
+                    }
+                    block = SplitFreeBlock(LastBlock, requestedBlockSize);
                 }
-                block = SplitFreeBlock(LastBlock, requestedBlockSize);
                 Y_ASSERT(FirstFreeBlock->Ptr <= LastBlock->Ptr);
             }
             Y_ASSERT(FirstFreeBlock->Ptr <= LastBlock->Ptr);
@@ -338,6 +374,10 @@ namespace NCudaLib {
         ui64 GetFreeMemorySize() const {
             return FreeMemory;
         }
+
+        const TMemoryPoolStats& GetStats() const {
+            return Stats;
+        }
     };
 
     extern template class TStackLikeMemoryPool<EPtrType::CudaDevice>;
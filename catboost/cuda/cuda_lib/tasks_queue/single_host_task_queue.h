@@ -6,6 +6,8 @@
 #include <util/system/event.h>
 #include <util/system/yield.h>
 
+#include <atomic>
+
 namespace NCudaLib {
     class TSingleHostTaskQueue {
     public:
@@ -40,15 +42,23 @@ namespace NCudaLib {
                     SchedYield();
                 }
             }
+            // producers signal JobsEvent only while the worker could be sleeping on it:
+            // either they see IsWaiting or the worker sees their task
+            IsWaiting.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
             if (InputTaskQueue.IsEmpty()) {
                 JobsEvent.WaitT(time);
             }
+            IsWaiting.store(false);
         }
 
         template <class TTask>
         void AddTask(THolder<TTask>&& task) {
             InputTaskQueue.Enqueue(std::move(task));
-            JobsEvent.Signal();
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (IsWaiting.load()) {
+                JobsEvent.Signal();
+            }
         }
 
         template <class TTask,
@@ -59,6 +69,7 @@ namespace NCudaLib {
 
     private:
         TManualEvent JobsEvent;
+        std::atomic<bool> IsWaiting{false};
         TQueue InputTaskQueue;
     };
 }
@@ -177,13 +177,37 @@ namespace NCatboostCuda {
             IQuantizedFeatureColumn* quantizedFeatureColumn,
             TValueProcessor&& valueProcessor = TIdentity()
         ) {
+            CheckCanWrite(dataSetId, featureId);
+            WriteBinsVector(
+                dataSetId,
+                featureId,
+                binCount,
+                /*permute=*/ false,
+                PackBins(dataSetId, quantizedFeatureColumn, std::move(valueProcessor))
+            );
+            return *this;
+        }
+
+        void CheckCanWrite(const ui32 dataSetId, const ui32 featureId) const {
             CB_ENSURE(IsWritingStage, "Error: prepare to write first");
             CB_ENSURE(dataSetId < GatherIndex.size(), "DataSet id is out of bounds: " << dataSetId << " "
                                                                                       << " total dataSets " << GatherIndex.size());
-            auto& dataSet = *CompressedIndex.DataSets[dataSetId];
+            CB_ENSURE(!SeenFeatures[dataSetId].contains(featureId), "Error: can't write feature twice");
+        }
+
+        /* CPU-only part of Write: reorders the column for the dataSet and applies valueProcessor.
+         * Doesn't touch GPU, so it could be run in a LocalExecutor thread while the main thread
+         * uploads the previous feature with WriteBinsVector (call CheckCanWrite on the main thread first)
+         */
+        template <typename IQuantizedFeatureColumn, typename TValueProcessor = TIdentity>
+        TVector<ui8> PackBins(
+            const ui32 dataSetId,
+            IQuantizedFeatureColumn* quantizedFeatureColumn,
+            TValueProcessor&& valueProcessor = TIdentity()
+        ) {
+            const auto& dataSet = *CompressedIndex.DataSets[dataSetId];
             const auto& docsMapping = dataSet.SamplesMapping;
             CB_ENSURE(quantizedFeatureColumn->GetSize() == docsMapping.GetObjectsSlice().Size());
-            CB_ENSURE(!SeenFeatures[dataSetId].contains(featureId), "Error: can't write feature twice");
             THolder<IQuantizedFeatureColumn> reorderedColumn;
             if (GatherIndex[dataSetId]) {
                 NCB::TCloningParams cloningParams;
@@ -219,14 +243,7 @@ namespace NCatboostCuda {
                 },
                 4096 /*blockSize*/
             );
-            WriteBinsVector(
-                dataSetId,
-                featureId,
-                binCount,
-                /*permute=*/ false,
-                writeBins
-            );
-            return *this;
+            return writeBins;
         }
 
         // TODO(kirillovs): figure out, why compilation without template fails here
@@ -11,6 +11,7 @@
 #include <catboost/cuda/data/binarizations_manager.h>
 #include <catboost/cuda/data/data_utils.h>
 
+#include <library/cpp/threading/future/future.h>
 #include <library/cpp/threading/local_executor/local_executor.h>
 #include <util/generic/fwd.h>
 
@@ -102,18 +103,22 @@ namespace NCatboostCuda {
             }
             const auto& objectsData = *dataProvider.ObjectsData;
             const auto featureCount = features.size();
-            TVector<ui32> featureBinCounts(featureCount);
-            for (auto taskIdx : xrange(featureCount)) {
+            if (featureCount == 0) {
+                return;
+            }
+            for (auto feature : features) {
+                IndexBuilder.CheckCanWrite(DataSetId, feature);
+            }
+
+            auto packFeature = [&] (ui32 taskIdx, TVector<ui8>* bins) {
                 const auto feature = features[taskIdx];
                 const auto dataProviderFeatureId = FeaturesManager.GetDataProviderId(feature);
                 const auto floatFeatureIdx = dataProvider.MetaInfo.FeaturesLayout->GetInternalFeatureIdx<EFeatureType::Float>(dataProviderFeatureId);
                 auto& subFeatures = FeaturesManager.GetFeatureManagerIdForFloatFeature(dataProviderFeatureId);
 
                 if (subFeatures.size() == 1) {
-                    IndexBuilder.Write(
+                    *bins = IndexBuilder.PackBins(
                         DataSetId,
-                        features[taskIdx],
-                        FeaturesManager.GetBinCount(feature),
                         *objectsData.GetFloatFeature(*floatFeatureIdx)
                     );
                 } else {
@@ -121,16 +126,56 @@ namespace NCatboostCuda {
                     CB_ENSURE_INTERNAL(subFeaturePosition != subFeatures.end(), "Sub feature not found");
                     auto subFeatureId = subFeaturePosition - subFeatures.begin();
                     ui16 baseValue = subFeatureId * 255;
-                    IndexBuilder.Write(
+                    *bins = IndexBuilder.PackBins(
                         DataSetId,
-                        features[taskIdx],
-                        FeaturesManager.GetBinCount(feature),
                         *objectsData.GetFloatFeature(*floatFeatureIdx),
                         [baseValue] (ui16 value) -> ui8 {
                             return (ui8)Min(Max(value - baseValue, 0), 255);
                         }
                     );
                 }
+            };
+
+            // pack next feature on CPU while current one is copied to devices
+            TVector<ui8> currentBins;
+            TVector<ui8> nextBins;
+            packFeature(0, &currentBins);
+            for (auto taskIdx : xrange<ui32>(featureCount)) {
+                const bool hasNext = taskIdx + 1 < featureCount;
+                NThreading::TFuture<void> nextPacked;
+                if (hasNext && LocalExecutor->GetThreadCount() > 0) {
+                    auto futures = LocalExecutor->ExecRangeWithFutures(
+                        [&packFeature, &nextBins, taskIdx] (int) {
+                            packFeature(taskIdx + 1, &nextBins);
+                        },
+                        0,
+                        1,
+                        NPar::TLocalExecutor::HIGH_PRIORITY
+                    );
+                    Y_VERIFY(futures.size() == 1);
+                    nextPacked = std::move(futures[0]);
+                }
+                try {
+                    IndexBuilder.WriteBinsVector(
+                        DataSetId,
+                        features[taskIdx],
+                        FeaturesManager.GetBinCount(features[taskIdx]),
+                        /*permute=*/ false,
+                        currentBins
+                    );
+                } catch (...) {
+                    // packing task refers to local buffers, so wait for it before unwinding
+                    if (nextPacked.Initialized()) {
+                        nextPacked.Wait();
+                    }
+                    throw;
+                }
+                if (nextPacked.Initialized()) {
+                    nextPacked.GetValueSync(); // will rethrow if there was an exception during packing
+                } else if (hasNext) {
+                    packFeature(taskIdx + 1, &nextBins);
+                }
+                currentBins.swap(nextBins);
             }
         }
 
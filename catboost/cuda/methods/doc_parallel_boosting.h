@@ -562,8 +562,26 @@ namespace NCatboostCuda {
                 &baseCursors->Cursors,
                 TestDataProvider ? &baseCursors->TestCursor : nullptr
             );
-            auto startingBaseCursors = CreateCursors(*baseInputData);
-            startingBaseCursors->CopyFrom(*baseCursors);
+            // base model approximations at experiment starts do not depend on the evaluated feature set,
+            // so they are calculated once and shared by all feature sets
+            TVector<THolder<TBoostingCursors>> experimentStartBaseCursors;
+            experimentStartBaseCursors.reserve(experimentCount);
+            for (ui32 experimentIdx : xrange(experimentCount)) {
+                if (experimentIdx > 0) {
+                    AppendEnsembles(
+                        baseInputData->DataSets,
+                        baseModels,
+                        baseInputData->GetEstimationPermutation(),
+                        /*iterStart*/ getExperimentStart(experimentIdx - 1),
+                        /*iterEnd*/ getExperimentStart(experimentIdx),
+                        &baseWeak,
+                        &baseCursors->Cursors,
+                        TestDataProvider ? &baseCursors->TestCursor : nullptr
+                    );
+                }
+                experimentStartBaseCursors.push_back(CreateCursors(*baseInputData));
+                experimentStartBaseCursors.back()->CopyFrom(*baseCursors);
+            }
 
             const ui32 experimentSize = ModelBasedEvalConfig.ExperimentSize;
             const ui64 savedBaseSeed = BaseIterationSeed;
@@ -597,12 +615,11 @@ namespace NCatboostCuda {
                 auto inputData = CreateInputData(permutationCount, &featureManager);
                 auto weak = MakeWeakLearner<TWeakLearner>(featureManager, CatBoostOptions);
 
-                baseCursors->CopyFrom(*startingBaseCursors);
                 for (experimentIdx = 0; experimentIdx < ModelBasedEvalConfig.ExperimentCount; ++experimentIdx) {
                     auto metricSaver = ProgressTracker->Clone(forceMetricSaveFunc);
                     TVector<TEnsemble> ignoredModels(permutationCount);
                     auto experimentCursors = CreateCursors(*inputData);
-                    experimentCursors->CopyFrom(*baseCursors);
+                    experimentCursors->CopyFrom(*experimentStartBaseCursors[experimentIdx]);
                     BaseIterationSeed = savedBaseSeed + getExperimentStart(experimentIdx);
                     Fit(inputData->DataSets,
                         inputData->GetEstimationPermutation(),
@@ -615,16 +632,6 @@ namespace NCatboostCuda {
                         &ignoredModels,
                         experimentCursors->BestTestCursor.Get()
                     );
-                    AppendEnsembles(
-                        baseInputData->DataSets,
-                        baseModels,
-                        baseInputData->GetEstimationPermutation(),
-                        /*iterStart*/ getExperimentStart(experimentIdx),
-                        /*iterEnd*/ getExperimentStart(experimentIdx + 1),
-                        &weak,
-                        &baseCursors->Cursors,
-                        TestDataProvider ? &baseCursors->TestCursor : nullptr
-                    );
                 }
             } // for indexSet
             BaseIterationSeed = savedBaseSeed;
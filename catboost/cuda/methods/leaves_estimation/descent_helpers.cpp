@@ -175,6 +175,13 @@ namespace NCatboostCuda {
                 estimator.MoveInOptimalDirection(nextPoint, step);
 
                 Oracle.Regularize(&nextPoint);
+
+                //nothing to check at last point without backtracking, so don't compute anything on device
+                const bool isLastIteration = iteration + 1 >= Iterations;
+                if (isLastIteration && StepEstimationType == ELeavesEstimationStepBacktracking::No) {
+                    return Oracle.MakeEstimationResult(nextPoint);
+                }
+
                 Oracle.MoveTo(nextPoint);
                 Oracle.WriteValueAndFirstDerivatives(&nextPointWithFuncInfo.Value,
                                                      &nextPointWithFuncInfo.Gradient);
@@ -183,12 +190,16 @@ namespace NCatboostCuda {
                                                 nextPointWithFuncInfo.Value,
                                                 nextPointWithFuncInfo.Gradient))
                 {
-                    Oracle.WriteSecondDerivatives(&nextPointWithFuncInfo.Hessian);
                     double gradNorm = nextPointWithFuncInfo.GradientNorm();
 
                     CATBOOST_DEBUG_LOG
                         << "Next point gradient norm: " << gradNorm << " Func value: " << nextPointWithFuncInfo.Value
                         << " Moved with step: " << step << Endl;
+                    //second derivatives and next direction are needed only for next iteration
+                    if (isLastIteration) {
+                        return Oracle.MakeEstimationResult(nextPoint);
+                    }
+                    Oracle.WriteSecondDerivatives(&nextPointWithFuncInfo.Hessian);
                     estimator.NextPoint(nextPointWithFuncInfo);
                     ++iteration;
                     updated = true;
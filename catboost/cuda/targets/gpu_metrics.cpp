@@ -274,6 +274,11 @@ namespace NCatboostCuda {
                 case ELossFunction::ZeroOneLoss: {
                     return Accuracy(BuildConfusionMatrixAtPoint(target, weights, cursor, NumClasses, cache).Stats);
                 }
+                case ELossFunction::HammingLoss: {
+                    TMetricHolder result = Accuracy(BuildConfusionMatrixAtPoint(target, weights, cursor, NumClasses, cache).Stats);
+                    result.Stats[0] = result.Stats[1] - result.Stats[0];
+                    return result;
+                }
                 case ELossFunction::Recall: {
                     return Recall(BuildConfusionMatrixAtPoint(target, weights, cursor, NumClasses, cache).Stats, ClassIdx);
                 }
@@ -569,7 +574,12 @@ namespace NCatboostCuda {
             }
 
             case ELossFunction::HammingLoss: {
-                result.emplace_back(new TCpuFallbackMetric(CreateSingleMetric(metricType, params, approxDim), metricDescription));
+                //confusion matrix on GPU is built with fixed probability threshold
+                if (params.GetParamsMap().contains("border")) {
+                    result.emplace_back(new TCpuFallbackMetric(CreateSingleMetric(metricType, params, approxDim), metricDescription));
+                } else {
+                    result.push_back(new TGpuPointwiseMetric(metricDescription, approxDim));
+                }
                 break;
             }
 
@@ -68,14 +68,58 @@ namespace NCatboostCuda {
         }
     }
 
-    inline void UpdateDataPartitionType(const TBinarizedFeaturesManager& featuresManager,
+    /* Rough per-tree communication estimate for multi-device plain boosting: doc-parallel
+     * reduces histograms for all leaves of every level, feature-parallel broadcasts
+     * derivatives once per tree and doc bins on every level. Histogram computation itself
+     * is split evenly between devices in both layouts, so it's not taken into account
+     */
+    inline EDataPartitionType SelectDataPartitionType(const NCB::TTrainingDataProvider& learn,
+                                                      const TBinarizedFeaturesManager& featuresManager,
+                                                      const NCatboostOptions::TCatBoostOptions& catBoostOptions) {
+        const ui32 devCount = NCudaLib::GetEnabledDevices(catBoostOptions.SystemOptions->Devices,
+                                                          NCudaLib::GetDevicesProvider().GetDeviceCount())
+                                  .size();
+        if (devCount <= 1) {
+            return EDataPartitionType::DocParallel;
+        }
+
+        ui64 binCount = 0;
+        for (auto floatFeature : featuresManager.GetFloatFeatureIds()) {
+            binCount += featuresManager.GetBinCount(floatFeature);
+        }
+        for (auto catFeature : featuresManager.GetCatFeatureIds()) {
+            if (featuresManager.UseForOneHotEncoding(catFeature)) {
+                binCount += featuresManager.GetBinCount(catFeature);
+            }
+        }
+        const ui32 depth = catBoostOptions.ObliviousTreeOptions->MaxDepth;
+        const double docCount = learn.GetObjectCount();
+        const double reduceFraction = 2.0 * (devCount - 1) / devCount;
+
+        const double docParallelBytes = reduceFraction * binCount * 2 * sizeof(float) * (1ULL << depth);
+        const double featureParallelBytes = (devCount - 1) * docCount * (2 * sizeof(float) + depth * sizeof(ui32));
+
+        const auto partitionType = featureParallelBytes < docParallelBytes
+            ? EDataPartitionType::FeatureParallel
+            : EDataPartitionType::DocParallel;
+        CATBOOST_INFO_LOG << "Selected " << partitionType << " data partition for " << devCount << " devices: "
+                          << "estimated transfers per tree are " << docParallelBytes / 1024 / 1024 << " MB for doc-parallel and "
+                          << featureParallelBytes / 1024 / 1024 << " MB for feature-parallel" << Endl;
+        return partitionType;
+    }
+
+    inline void UpdateDataPartitionType(const NCB::TTrainingDataProvider& learn,
+                                        const TBinarizedFeaturesManager& featuresManager,
+                                        bool allowFeatureParallel,
                                         NCatboostOptions::TCatBoostOptions& catBoostOptions) {
         if (catBoostOptions.CatFeatureParams->MaxTensorComplexity > 1 && featuresManager.GetCatFeatureIds().size()) {
             return;
         } else {
             if (catBoostOptions.BoostingOptions->BoostingType == EBoostingType::Plain) {
                 if (catBoostOptions.BoostingOptions->DataPartitionType.NotSet()) {
-                    catBoostOptions.BoostingOptions->DataPartitionType = EDataPartitionType::DocParallel;
+                    catBoostOptions.BoostingOptions->DataPartitionType = allowFeatureParallel
+                        ? SelectDataPartitionType(learn, featuresManager, catBoostOptions)
+                        : EDataPartitionType::DocParallel;
                 }
             }
         }
@@ -210,10 +254,11 @@ namespace NCatboostCuda {
                                                const NCB::TTrainingDataProvider* testProvider,
                                                NCatboostOptions::TCatBoostOptions& catBoostOptions,
                                                TBinarizedFeaturesManager& featuresManager,
+                                               bool isModelBasedEval,
                                                NPar::TLocalExecutor* localExecutor) {
         UpdateGpuSpecificDefaults(catBoostOptions, featuresManager);
         EstimatePriors(dataProvider, featuresManager, catBoostOptions.CatFeatureParams, localExecutor);
-        UpdateDataPartitionType(featuresManager, catBoostOptions);
+        UpdateDataPartitionType(dataProvider, featuresManager, /*allowFeatureParallel*/ !isModelBasedEval, catBoostOptions);
         UpdatePinnedMemorySizeOption(dataProvider, testProvider, featuresManager, catBoostOptions);
     }
 
@@ -362,6 +407,7 @@ namespace NCatboostCuda {
                 !trainingData.Test.empty() ? trainingData.Test[0].Get() : nullptr,
                 updatedCatboostOptions,
                 featuresManager,
+                /*isModelBasedEval*/ false,
                 localExecutor);
 
             InitializeEvalMetricIfNotSet(updatedCatboostOptions.MetricOptions->ObjectiveMetric, &updatedCatboostOptions.MetricOptions->EvalMetric);
@@ -529,6 +575,7 @@ namespace NCatboostCuda {
                 trainingData.Test[0].Get(),
                 updatedCatboostOptions,
                 featuresManager,
+                /*isModelBasedEval*/ true,
                 localExecutor);
 
             NCB::TOnCpuGridBuilderFactory gridBuilderFactory;
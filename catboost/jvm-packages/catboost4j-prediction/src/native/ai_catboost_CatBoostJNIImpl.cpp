@@ -655,5 +655,127 @@ JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredict_
     Y_END_JNI_API_CALL();
 }
 
+// Feature matrices are used in place through `TFeatureColumn` views, so both row-major
+// (`columnMajor == false`, `[documentIdx * featureCount + featureIdx]`) and column-major
+// (`[featureIdx * documentCount + documentIdx]`) layouts need neither copies nor pinning.
+static void CalcOnFeatureMatrices(
+    const TFullModel& model,
+    const float* const numericFeatures,
+    const size_t documentCount,
+    const size_t numericFeatureCount,
+    const bool columnMajor,
+    const int* const catFeatures,
+    const size_t catFeatureCount,
+    double* const predictions) {
+
+    const size_t minNumericFeatureCount = model.GetNumFloatFeatures();
+    const size_t minCatFeatureCount = model.GetNumCatFeatures();
+    CB_ENSURE(
+        numericFeatureCount >= minNumericFeatureCount,
+        LabeledOutput(numericFeatureCount, minNumericFeatureCount));
+    CB_ENSURE(
+        catFeatureCount >= minCatFeatureCount,
+        LabeledOutput(catFeatureCount, minCatFeatureCount));
+    CB_ENSURE(!numericFeatureCount || numericFeatures, "got nullptr numeric features");
+    CB_ENSURE(!catFeatureCount || catFeatures, "got nullptr cat features");
+    CB_ENSURE(predictions, "got nullptr predictions");
+
+    using NCB::NModelEvaluation::TFeatureColumn;
+    TVector<TFeatureColumn<float>> numericColumns(numericFeatureCount);
+    for (size_t i = 0; i < numericFeatureCount; ++i) {
+        numericColumns[i].Data = numericFeatures + (columnMajor ? i * documentCount : i);
+        numericColumns[i].Stride = columnMajor ? 1 : numericFeatureCount;
+    }
+    TVector<TFeatureColumn<int>> catColumns(catFeatureCount);
+    for (size_t i = 0; i < catFeatureCount; ++i) {
+        catColumns[i].Data = catFeatures + (columnMajor ? i * documentCount : i);
+        catColumns[i].Stride = columnMajor ? 1 : catFeatureCount;
+    }
+
+    model.CalcColumnar(
+        numericColumns,
+        catColumns,
+        documentCount,
+        MakeArrayRef(predictions, documentCount * model.GetDimensionsCount()));
+}
+
+template <typename T>
+static T* GetDirectBufferData(
+    JNIEnv* const jenv,
+    const jobject buffer,
+    const size_t expectedSize,
+    const TStringBuf bufferName) {
+
+    if (jenv->IsSameObject(buffer, NULL) == JNI_TRUE) {
+        CB_ENSURE(expectedSize == 0, "`" << bufferName << "` buffer is null");
+        return nullptr;
+    }
+    void* const data = jenv->GetDirectBufferAddress(buffer);
+    CB_ENSURE(data, "`" << bufferName << "` must be a direct buffer");
+    const jlong capacity = jenv->GetDirectBufferCapacity(buffer);
+    CB_ENSURE(
+        capacity >= 0 && static_cast<size_t>(capacity) >= expectedSize * sizeof(T),
+        "`" << bufferName << "` buffer is too small: "
+        LabeledOutput(capacity, expectedSize * sizeof(T)));
+    return static_cast<T*>(data);
+}
+
+JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredictDirect
+  (JNIEnv* jenv, jclass, jlong jhandle, jobject jnumericFeatures, jint jdocumentCount, jint jnumericFeatureCount,
+   jboolean jcolumnMajor, jobject jcatFeatures, jint jcatFeatureCount, jobject jpredictions) {
+    Y_BEGIN_JNI_API_CALL();
+
+    const auto* const model = ToConstFullModelPtr(jhandle);
+    CB_ENSURE(model, "got nullptr model pointer");
+    CB_ENSURE(
+        jdocumentCount >= 0 && jnumericFeatureCount >= 0 && jcatFeatureCount >= 0,
+        "got negative size " LabeledOutput(jdocumentCount, jnumericFeatureCount, jcatFeatureCount));
+    const size_t documentCount = jdocumentCount;
+    if (documentCount == 0) {
+        return nullptr;
+    }
+    const size_t numericFeatureCount = jnumericFeatureCount;
+    const size_t catFeatureCount = jcatFeatureCount;
+
+    CalcOnFeatureMatrices(
+        *model,
+        GetDirectBufferData<const float>(jenv, jnumericFeatures, documentCount * numericFeatureCount, "numericFeatures"),
+        documentCount,
+        numericFeatureCount,
+        jcolumnMajor == JNI_TRUE,
+        GetDirectBufferData<const int>(jenv, jcatFeatures, documentCount * catFeatureCount, "catFeatures"),
+        catFeatureCount,
+        GetDirectBufferData<double>(jenv, jpredictions, documentCount * model->GetDimensionsCount(), "predictions"));
+
+    Y_END_JNI_API_CALL();
+}
+
+JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredictAddress
+  (JNIEnv* jenv, jclass, jlong jhandle, jlong jnumericFeaturesAddress, jint jdocumentCount, jint jnumericFeatureCount,
+   jboolean jcolumnMajor, jlong jcatFeaturesAddress, jint jcatFeatureCount, jlong jpredictionsAddress) {
+    Y_BEGIN_JNI_API_CALL();
+
+    const auto* const model = ToConstFullModelPtr(jhandle);
+    CB_ENSURE(model, "got nullptr model pointer");
+    CB_ENSURE(
+        jdocumentCount >= 0 && jnumericFeatureCount >= 0 && jcatFeatureCount >= 0,
+        "got negative size " LabeledOutput(jdocumentCount, jnumericFeatureCount, jcatFeatureCount));
+    if (jdocumentCount == 0) {
+        return nullptr;
+    }
+
+    CalcOnFeatureMatrices(
+        *model,
+        reinterpret_cast<const float*>(jnumericFeaturesAddress),
+        jdocumentCount,
+        jnumericFeatureCount,
+        jcolumnMajor == JNI_TRUE,
+        reinterpret_cast<const int*>(jcatFeaturesAddress),
+        jcatFeatureCount,
+        reinterpret_cast<double*>(jpredictionsAddress));
+
+    Y_END_JNI_API_CALL();
+}
+
 #undef Y_BEGIN_JNI_API_CALL
 #undef Y_END_JNI_API_CALL
@@ -129,6 +129,22 @@ JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredict_
 JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredict__J_3_3F_3_3I_3D
   (JNIEnv *, jclass, jlong, jobjectArray, jobjectArray, jdoubleArray);
 
+/*
+ * Class:     ai_catboost_CatBoostJNIImpl
+ * Method:    catBoostModelPredictDirect
+ * Signature: (JLjava/nio/ByteBuffer;IIZLjava/nio/ByteBuffer;ILjava/nio/ByteBuffer;)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredictDirect
+  (JNIEnv *, jclass, jlong, jobject, jint, jint, jboolean, jobject, jint, jobject);
+
+/*
+ * Class:     ai_catboost_CatBoostJNIImpl
+ * Method:    catBoostModelPredictAddress
+ * Signature: (JJIIZJIJ)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredictAddress
+  (JNIEnv *, jclass, jlong, jlong, jint, jint, jboolean, jlong, jint, jlong);
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,15 +19,26 @@ namespace NCB {
     template <class TData>
     class TAsyncRowProcessor {
     public:
-        TAsyncRowProcessor(NPar::TLocalExecutor* localExecutor, size_t blockSize)
+        /* readAheadBlockCount blocks are read in the background while the current block is processed,
+         * blocks are read sequentially one after another
+         */
+        TAsyncRowProcessor(NPar::TLocalExecutor* localExecutor, size_t blockSize, size_t readAheadBlockCount = 1)
             : LocalExecutor(localExecutor)
             , BlockSize(blockSize)
             , FirstLineInReadBuffer(false)
+            , ReadBuffers(readAheadBlockCount)
+            , ReadFutures(readAheadBlockCount)
+            , ReadHead(0)
+            , ReadBlockCount(0)
+            , ReadFinished(false)
             , LinesProcessed(0)
         {
             CB_ENSURE(BlockSize, "TAsyncRowProcessor: blockSize == 0");
+            CB_ENSURE(readAheadBlockCount, "TAsyncRowProcessor: readAheadBlockCount == 0");
 
-            ReadBuffer.yresize(blockSize);
+            for (auto& readBuffer : ReadBuffers) {
+                readBuffer.yresize(blockSize);
+            }
             ParseBuffer.yresize(blockSize);
         }
 
@@ -38,36 +49,20 @@ namespace NCB {
         // sometimes we need to separately process first data, but add it to usual processing as well
         void AddFirstLine(TData&& firstLine) {
             CB_ENSURE(!FirstLineInReadBuffer, "TAsyncRowProcessor: double call to AddFirstLine");
-            ReadBuffer[0] = std::move(firstLine);
+            CB_ENSURE(!ReadBlockCount, "TAsyncRowProcessor: AddFirstLine called after reading has started");
+            ReadBuffers[ReadHead][0] = std::move(firstLine);
             FirstLineInReadBuffer = true;
         }
 
         /*
          * readFunc should be of type 'bool(TData* data)',
          *  fill the data and return true if data was read
+         * starts reading of blocks into all free read-ahead buffers
          */
         template <class TReadDataFunc>
         void ReadBlockAsync(TReadDataFunc readFunc) {
-            auto readLineBufferLambda = [this, readFunc = std::move(readFunc)](int) {
-                for (size_t lineIdx = (FirstLineInReadBuffer ? 1 : 0); lineIdx < BlockSize; ++lineIdx) {
-                    if (!readFunc(&(ReadBuffer[lineIdx]))) {
-                        ReadBuffer.yresize(lineIdx);
-                        break;
-                    }
-                }
-                FirstLineInReadBuffer = false;
-            };
-            if (LocalExecutor->GetThreadCount() > 0) {
-                auto readFuturesVector = LocalExecutor->ExecRangeWithFutures(
-                    readLineBufferLambda,
-                    0,
-                    1,
-                    NPar::TLocalExecutor::HIGH_PRIORITY
-                );
-                Y_VERIFY(readFuturesVector.size() == 1);
-                ReadFuture = std::move(readFuturesVector[0]);
-            } else {
-                readLineBufferLambda(0);
+            while (ReadBlockCount < ReadBuffers.size()) {
+                EnqueueBlockRead(readFunc);
             }
         }
 
@@ -77,15 +72,20 @@ namespace NCB {
          */
         template <class TReadDataFunc>
         bool ReadBlock(TReadDataFunc readFunc) {
-            if (ReadFuture.Initialized()) { // ReadFuture is not used if there's only one thread
-                ReadFuture.GetValueSync(); // will rethrow if there was an exception during read
+            if (!ReadBlockCount) {
+                ParseBuffer.resize(0);
+                return false;
+            }
+            auto& readFuture = ReadFutures[ReadHead];
+            if (readFuture.Initialized()) { // ReadFuture is not used if there's only one thread
+                readFuture.GetValueSync(); // will rethrow if there was an exception during read
+                readFuture = NThreading::TFuture<void>();
             }
-            ReadBuffer.swap(ParseBuffer);
+            ReadBuffers[ReadHead].swap(ParseBuffer);
+            ReadHead = (ReadHead + 1) % ReadBuffers.size();
+            --ReadBlockCount;
             if (ParseBuffer.size() == BlockSize) { // more data could be available
-                ReadBlockAsync(readFunc);
-            } else {
-                ReadBuffer.resize(0);
-                ReadFuture = NThreading::TFuture<void>();
+                ReadBlockAsync(std::move(readFunc));
             }
             return !!ParseBuffer;
         }
@@ -121,11 +121,61 @@ namespace NCB {
          * arguments in ReadBlock and ProcessBlock
          */
         void FinishAsyncProcessing() {
-            // make sure that async reading that uses ReadBuffer has finished
-            if (ReadFuture.Initialized()) { // ReadFuture is not used if there's only one thread
-                ReadFuture.Wait();
-                ReadFuture = NThreading::TFuture<void>();
+            // make sure that async reading that uses ReadBuffers has finished
+            for (auto& readFuture : ReadFutures) {
+                if (readFuture.Initialized()) { // ReadFutures are not used if there's only one thread
+                    readFuture.Wait();
+                    readFuture = NThreading::TFuture<void>();
+                }
+            }
+            LastReadFuture = NThreading::TFuture<void>();
+        }
+
+    private:
+        template <class TReadDataFunc>
+        void EnqueueBlockRead(TReadDataFunc readFunc) {
+            const size_t bufferIdx = (ReadHead + ReadBlockCount) % ReadBuffers.size();
+            auto readLineBufferLambda = [this, bufferIdx, readFunc = std::move(readFunc)](int) {
+                auto& readBuffer = ReadBuffers[bufferIdx];
+                if (ReadFinished) {
+                    readBuffer.resize(0);
+                    return;
+                }
+                readBuffer.yresize(BlockSize);
+                for (size_t lineIdx = (FirstLineInReadBuffer ? 1 : 0); lineIdx < BlockSize; ++lineIdx) {
+                    if (!readFunc(&(readBuffer[lineIdx]))) {
+                        readBuffer.yresize(lineIdx);
+                        ReadFinished = true;
+                        break;
+                    }
+                }
+                FirstLineInReadBuffer = false;
+            };
+            if (LocalExecutor->GetThreadCount() > 0) {
+                auto startRead = [this, readLineBufferLambda = std::move(readLineBufferLambda)] () {
+                    auto readFuturesVector = LocalExecutor->ExecRangeWithFutures(
+                        readLineBufferLambda,
+                        0,
+                        1,
+                        NPar::TLocalExecutor::HIGH_PRIORITY
+                    );
+                    Y_VERIFY(readFuturesVector.size() == 1);
+                    return readFuturesVector[0];
+                };
+                // blocks are read from the same source so the next read starts only after the previous one
+                LastReadFuture = LastReadFuture.Initialized()
+                    ? LastReadFuture.Apply(
+                        [startRead = std::move(startRead)] (const NThreading::TFuture<void>& prevRead) {
+                            prevRead.TryRethrow();
+                            return startRead();
+                        }
+                    )
+                    : startRead();
+                ReadFutures[bufferIdx] = LastReadFuture;
+            } else {
+                readLineBufferLambda(0);
             }
+            ++ReadBlockCount;
         }
 
     private:
@@ -134,9 +184,15 @@ namespace NCB {
 
         TVector<TData> ParseBuffer;
 
-        bool FirstLineInReadBuffer; // if true, first line in ReadBuffer is already filled
-        TVector<TData> ReadBuffer;
-        NThreading::TFuture<void> ReadFuture;
+        bool FirstLineInReadBuffer; // if true, first line in the first read buffer is already filled
+
+        // ring of read-ahead buffers, ReadBlockCount buffers starting from ReadHead are being read or are ready
+        TVector<TVector<TData>> ReadBuffers;
+        TVector<NThreading::TFuture<void>> ReadFutures;
+        size_t ReadHead;
+        size_t ReadBlockCount;
+        NThreading::TFuture<void> LastReadFuture;
+        bool ReadFinished; // accessed only by reads that are executed sequentially
 
         size_t LinesProcessed;
     };
@@ -7,13 +7,55 @@
 
 #include <util/generic/algorithm.h>
 #include <util/generic/is_in.h>
+#include <util/stream/mem.h>
+#include <util/ysaveload.h>
 
 
 namespace {
     const TString CLASS_NAME_DELIMITER = ":Class=";
+
+    const TString BINARY_BASELINE_MAGIC = "CBBaseline";
+    constexpr ui32 BINARY_BASELINE_VERSION = 1;
+}
+
+// returns offset of the first row
+static size_t ReadBinaryBaselineHeader(const TBlob& data, NCB::TBinaryBaselineHeader* header) {
+    TMemoryInput in(data.AsCharPtr(), data.Size());
+    TString magic;
+    ui32 version;
+    ::Load(&in, magic);
+    CB_ENSURE(magic == BINARY_BASELINE_MAGIC, "Wrong binary baseline file header");
+    ::Load(&in, version);
+    CB_ENSURE(version == BINARY_BASELINE_VERSION, "Unsupported binary baseline file version " << version);
+    ::Load(&in, header->ValueSize);
+    CB_ENSURE(
+        header->ValueSize == sizeof(float) || header->ValueSize == sizeof(double),
+        "Binary baseline values must be float32 or float64, got value size " << header->ValueSize
+    );
+    ::Load(&in, header->BaselineCount);
+    CB_ENSURE(header->BaselineCount, "Binary baseline file must contain at least one baseline");
+    ::Load(&in, header->ClassNames);
+    CB_ENSURE(
+        header->ClassNames.empty() || header->ClassNames.size() == header->BaselineCount,
+        "Inconsistent class names in binary baseline file header"
+    );
+
+    const size_t dataOffset = data.Size() - in.Avail();
+    CB_ENSURE(
+        (data.Size() - dataOffset) % ((size_t)header->ValueSize * header->BaselineCount) == 0,
+        "Binary baseline file size does not match baseline count " << header->BaselineCount
+    );
+    return dataOffset;
 }
 
 static void GetClassNamesFromBaselineFile(const NCB::TPathWithScheme& baselineFilePath, TVector<TString>* classNames) {
+    if (baselineFilePath.Scheme == NCB::BinaryBaselineScheme) {
+        NCB::TBinaryBaselineHeader header;
+        ReadBinaryBaselineHeader(TBlob::FromFile(baselineFilePath.Path), &header);
+        *classNames = std::move(header.ClassNames);
+        return;
+    }
+
     THolder<NCB::ILineDataReader> reader = GetLineDataReader(baselineFilePath);
     TString header;
     reader->ReadLine(&header);
@@ -40,8 +82,47 @@ static void GetClassNamesFromBaselineFile(const NCB::TPathWithScheme& baselineFi
 }
 
 namespace NCB {
+    void SaveBinaryBaselineHeader(ui32 baselineCount, const TVector<TString>& classNames, IOutputStream* out) {
+        CB_ENSURE_INTERNAL(baselineCount, "SaveBinaryBaselineHeader: zero baseline count");
+        CB_ENSURE_INTERNAL(
+            classNames.empty() || classNames.size() == baselineCount,
+            "SaveBinaryBaselineHeader: class names count does not match baseline count"
+        );
+        const ui32 valueSize = sizeof(float);
+
+        ::Save(out, BINARY_BASELINE_MAGIC);
+        ::Save(out, BINARY_BASELINE_VERSION);
+        ::Save(out, valueSize);
+        ::Save(out, baselineCount);
+        ::Save(out, classNames);
+    }
+
+    void SaveBinaryBaselineRows(TConstArrayRef<TVector<double>> baseline, IOutputStream* out) {
+        if (baseline.empty()) {
+            return;
+        }
+        TVector<float> row(baseline.size());
+        for (auto objectIdx : xrange(baseline[0].size())) {
+            for (auto baselineIdx : xrange(baseline.size())) {
+                row[baselineIdx] = static_cast<float>(baseline[baselineIdx][objectIdx]);
+            }
+            out->Write(row.data(), row.size() * sizeof(float));
+        }
+    }
+
+    void SaveBinaryBaseline(
+        TConstArrayRef<TVector<double>> baseline,
+        const TVector<TString>& classNames,
+        IOutputStream* out
+    ) {
+        SaveBinaryBaselineHeader(SafeIntegerCast<ui32>(baseline.size()), classNames, out);
+        SaveBinaryBaselineRows(baseline, out);
+    }
+
     TBaselineReader::TBaselineReader(const TPathWithScheme& baselineFilePath, const TVector<TString>& classNames) {
-        if (baselineFilePath.Inited()) {
+        if (baselineFilePath.Scheme == BinaryBaselineScheme) {
+            InitBinary(baselineFilePath, classNames);
+        } else if (baselineFilePath.Inited()) {
             Reader_ = GetProcessor<ILineDataReader, TLineDataReaderArgs>(
                 baselineFilePath, TLineDataReaderArgs{baselineFilePath, TDsvFormatOptions{true, DELIMITER_}});
             auto header = Reader_->GetHeader();
@@ -69,6 +150,35 @@ namespace NCB {
         }
     }
 
+    void TBaselineReader::InitBinary(const TPathWithScheme& baselineFilePath, const TVector<TString>& classNames) {
+        BinaryData_ = TBlob::FromFile(baselineFilePath.Path);
+        BinaryHeader_.ConstructInPlace();
+        BinaryDataOffset_ = ReadBinaryBaselineHeader(BinaryData_, BinaryHeader_.Get());
+        BaselineSize_ = BinaryHeader_->BaselineCount;
+
+        const auto& fileClassNames = BinaryHeader_->ClassNames;
+        if ((BaselineSize_ != 1) && !classNames.empty() && !fileClassNames.empty()) {
+            CB_ENSURE(fileClassNames == classNames, "Class names in binary baseline file header differ from class names of the data");
+        }
+        CB_ENSURE((BaselineSize_ == 1 && (classNames.empty() || (classNames.size() == 2))) ||
+                  (!classNames.empty() && BaselineSize_ == classNames.size()),
+                  "Binary baseline file for multiclass should contain one baseline or a baseline for each class");
+
+        BaselineIndexes_.resize(BaselineSize_);
+        Iota(BaselineIndexes_.begin(), BaselineIndexes_.end(), 0);
+        Inited_ = true;
+    }
+
+    bool TBaselineReader::ReadBinaryRow(TString* line) {
+        const size_t rowSize = (size_t)BinaryHeader_->ValueSize * BaselineSize_;
+        if (BinaryDataOffset_ + rowSize > BinaryData_.Size()) {
+            return false;
+        }
+        line->assign(BinaryData_.AsCharPtr() + BinaryDataOffset_, rowSize);
+        BinaryDataOffset_ += rowSize;
+        return true;
+    }
+
     void UpdateClassLabelsFromBaselineFile(
         const TPathWithScheme& baselineFilePath,
         TVector<NJson::TJsonValue>* classLabels
@@ -85,3 +195,8 @@ namespace NCB {
         }
     }
 }
+
+namespace {
+    NCB::TExistsCheckerFactory::TRegistrator<NCB::TFSExistsChecker> FSBinaryBaselineExistsCheckerReg(
+        TString(NCB::BinaryBaselineScheme));
+}
@@ -4,6 +4,7 @@
 #include <catboost/private/libs/data_util/line_data_reader.h>
 #include <catboost/libs/helpers/exception.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/cast.h>
 #include <util/generic/maybe.h>
 #include <util/generic/ptr.h>
@@ -11,11 +12,15 @@
 #include <util/generic/strbuf.h>
 #include <util/generic/string.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/memory/blob.h>
 #include <util/stream/labeled.h>
+#include <util/stream/output.h>
 #include <util/string/cast.h>
 #include <util/string/escape.h>
 #include <util/string/split.h>
 #include <util/system/types.h>
+#include <util/system/unaligned_mem.h>
 
 
 namespace NJson {
@@ -24,6 +29,31 @@ namespace NJson {
 
 
 namespace NCB {
+    /* Binary baseline file format, used with 'cbbinary' path scheme:
+     *   header saved with ::Save: magic "CBBaseline", ui32 version, ui32 value size (4 for float32 or 8 for float64),
+     *     ui32 baseline count (approx dimension), TVector<TString> class names (empty if there are no class names),
+     *   then rows of baseline count values for each object.
+     * Rows are read from the memory-mapped file without parsing.
+     */
+    constexpr TStringBuf BinaryBaselineScheme = "cbbinary";
+
+    struct TBinaryBaselineHeader {
+        ui32 ValueSize = sizeof(float);
+        ui32 BaselineCount = 0;
+        TVector<TString> ClassNames;
+    };
+
+    // classNames can be empty
+    void SaveBinaryBaselineHeader(ui32 baselineCount, const TVector<TString>& classNames, IOutputStream* out);
+
+    // baseline is [approxIdx][objectIdx], rows can be saved by parts after the header
+    void SaveBinaryBaselineRows(TConstArrayRef<TVector<double>> baseline, IOutputStream* out);
+
+    void SaveBinaryBaseline(
+        TConstArrayRef<TVector<double>> baseline,
+        const TVector<TString>& classNames,
+        IOutputStream* out);
+
     class TBaselineReader {
     public:
         TBaselineReader() {}
@@ -46,12 +76,21 @@ namespace NCB {
             return BaselineIndexes_;
         }
 
+        // for binary baseline files line contains raw values of one row
         bool ReadLine(TString* line) {
+            if (BinaryHeader_) {
+                return ReadBinaryRow(line);
+            }
             return Reader_->ReadLine(line);
         }
 
         template <class TFunc>
         void Parse(TFunc addBaselineFunc, TStringBuf line, ui32 lineIdx) {
+            if (BinaryHeader_) {
+                ParseBinaryRow(addBaselineFunc, line, lineIdx);
+                return;
+            }
+
             ui32 baselineIdx = 0;
             ui32 columnIdx = 0;
             for (const TStringBuf token : StringSplitter(line).Split(DELIMITER_)) {
@@ -75,8 +114,36 @@ namespace NCB {
             CB_ENSURE(columnIdx == BaselineSize_, "Not enough columns in baseline file line " << LabeledOutput(lineIdx));
         }
 
+    private:
+        void InitBinary(const TPathWithScheme& baselineFilePath, const TVector<TString>& classNames);
+
+        bool ReadBinaryRow(TString* line);
+
+        template <class TFunc>
+        void ParseBinaryRow(TFunc addBaselineFunc, TStringBuf line, ui32 lineIdx) {
+            const ui32 valueSize = BinaryHeader_->ValueSize;
+            CB_ENSURE(
+                line.size() == (size_t)valueSize * BaselineSize_,
+                "Wrong row size in binary baseline file for " << LabeledOutput(lineIdx)
+            );
+            for (auto baselineIdx : xrange(BaselineSize_)) {
+                const char* value = line.data() + (size_t)baselineIdx * valueSize;
+                if (valueSize == sizeof(float)) {
+                    addBaselineFunc(baselineIdx, ReadUnaligned<float>(value));
+                } else {
+                    addBaselineFunc(baselineIdx, static_cast<float>(ReadUnaligned<double>(value)));
+                }
+            }
+        }
+
     private:
         THolder<ILineDataReader> Reader_;
+
+        TMaybe<TBinaryBaselineHeader> BinaryHeader_;
+        TBlob BinaryData_; // memory-mapped binary baseline file
+        size_t BinaryDataOffset_ = 0; // offset of the next row to read
+
+
         TVector<ui32> BaselineIndexes_;
         ui32 BaselineSize_ = 0;
         bool Inited_ = false;
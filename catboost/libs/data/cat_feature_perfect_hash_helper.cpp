@@ -2,10 +2,17 @@
 
 #include "util.h"
 
+#include <catboost/libs/helpers/parallel_sort/parallel_sort.h>
+#include <catboost/private/libs/index_range/index_range.h>
+
+#include <library/cpp/containers/dense_hash/dense_hash.h>
+
 #include <util/system/guard.h>
 #include <util/system/yassert.h>
 #include <util/generic/cast.h>
 #include <util/generic/map.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
 
 #include <util/generic/ylimits.h>
 
@@ -14,13 +21,275 @@
 
 namespace NCB {
 
+    static constexpr size_t MAX_UNIQ_CAT_VALUES =
+        static_cast<size_t>(Max<ui32>()) + ((sizeof(size_t) > sizeof(ui32)) ? 1 : 0);
+
+    // objects are processed in parallel only by blocks not smaller than this
+    static constexpr int MIN_PERFECT_HASH_BUILD_BLOCK_SIZE = 65536;
+
+
+    namespace {
+        // TDenseHash reserves one key as an empty marker, so the value for this key is stored separately
+        class TCatValuesDenseHash {
+        public:
+            TCatValuesDenseHash()
+                : Hash(EmptyMarker)
+            {}
+
+            // inserts TValueWithCount{0, 0} for new hashedCatValue
+            TValueWithCount& operator[](ui32 hashedCatValue) {
+                if (Y_UNLIKELY(hashedCatValue == EmptyMarker)) {
+                    if (!EmptyMarkerValue) {
+                        EmptyMarkerValue.ConstructInPlace();
+                    }
+                    return *EmptyMarkerValue;
+                }
+                return Hash[hashedCatValue];
+            }
+
+            // hashedCatValue must be present
+            TValueWithCount& Get(ui32 hashedCatValue) {
+                if (Y_UNLIKELY(hashedCatValue == EmptyMarker)) {
+                    return *EmptyMarkerValue;
+                }
+                return Hash.at(hashedCatValue);
+            }
+
+            size_t Size() const {
+                return Hash.Size() + (EmptyMarkerValue ? 1 : 0);
+            }
+
+            // f is called with (hashedCatValue, const TValueWithCount&) arguments
+            template <class F>
+            void ForEach(F&& f) const {
+                for (const auto& [hashedCatValue, valueWithCount] : Hash) {
+                    f(hashedCatValue, valueWithCount);
+                }
+                if (EmptyMarkerValue) {
+                    f(EmptyMarker, *EmptyMarkerValue);
+                }
+            }
+
+        private:
+            static constexpr ui32 EmptyMarker = Max<ui32>();
+
+            TDenseHash<ui32, TValueWithCount> Hash;
+            TMaybe<TValueWithCount> EmptyMarkerValue;
+        };
+    }
+
+
+    // f is called with (idx, hashedCatValue) arguments for idx in indexRange
+    template <class F>
+    static void ForEachInRange(
+        const ITypedArraySubset<ui32>& hashedCatArraySubset,
+        TIndexRange<ui32> indexRange,
+        F&& f
+    ) {
+        IDynamicBlockIteratorPtr<ui32> blockIterator = hashedCatArraySubset.GetBlockIterator(indexRange.Begin);
+        ui32 idx = indexRange.Begin;
+        while (idx < indexRange.End) {
+            auto block = blockIterator->Next(indexRange.End - idx);
+            Y_ASSERT(!block.empty());
+            for (auto hashedCatValue : block) {
+                f(idx++, hashedCatValue);
+            }
+        }
+    }
+
+
+    /* Adds values from hashedCatArraySubset to perfectHashMap that can contain only a mapping for the
+     * default value, new bins are assigned in order of the first occurrence of values, as for
+     * sequential insertion.
+     * Values are counted in per-block hashes sharded by value and then shards are merged in parallel.
+     */
+    static void BuildPerfectHashMapInParallel(
+        const TCatFeatureIdx catFeatureIdx,
+        const ITypedArraySubset<ui32>& hashedCatArraySubset,
+        TArrayRef<ui32> dstBins, // can be empty
+        NPar::TLocalExecutor* localExecutor,
+        TCatFeaturePerfectHash* perfectHashMap
+    ) {
+        Y_ASSERT(perfectHashMap->GetSize() <= 1);
+
+        // counts are not updated for DefaultMap
+        TMaybe<ui32> knownSrcValue;
+        TValueWithCount* knownDstValueWithCount = nullptr;
+        if (perfectHashMap->DefaultMap) {
+            knownSrcValue = perfectHashMap->DefaultMap->SrcValue;
+        } else if (!perfectHashMap->Map.empty()) {
+            knownSrcValue = perfectHashMap->Map.begin()->first;
+            knownDstValueWithCount = &(perfectHashMap->Map.begin()->second);
+        }
+        const ui32 knownBin = perfectHashMap->DefaultMap ?
+            perfectHashMap->DefaultMap->DstValueWithCount.Value :
+            (knownDstValueWithCount ? knownDstValueWithCount->Value : 0);
+
+        const ui32 size = hashedCatArraySubset.GetSize();
+        if (!size) {
+            return;
+        }
+
+        NPar::TLocalExecutor::TExecRangeParams blockParams(0, SafeIntegerCast<int>(size));
+        blockParams.SetBlockSize(
+            Max(CeilDiv(SafeIntegerCast<int>(size), localExecutor->GetThreadCount() + 1), MIN_PERFECT_HASH_BUILD_BLOCK_SIZE)
+        );
+        const int blockCount = blockParams.GetBlockCount();
+        const int shardCount = blockCount;
+
+        // high bits are used because TDenseHash selects buckets by low bits
+        const auto getShardIdx = [shardCount] (ui32 hashedCatValue) {
+            return (int)((ui64(hashedCatValue) * ui64(shardCount)) >> 32);
+        };
+
+        // Value is an index of the first occurrence here
+        TVector<TVector<TCatValuesDenseHash>> blocksShardHashes(blockCount); // [blockIdx][shardIdx]
+        TVector<ui32> knownValueBlockCounts(blockCount, 0);
+
+        localExecutor->ExecRangeWithThrow(
+            [&] (int blockIdx) {
+                auto& shardHashes = blocksShardHashes[blockIdx];
+                shardHashes.resize(shardCount);
+                ui32& knownValueCount = knownValueBlockCounts[blockIdx];
+
+                const ui32 blockBegin = blockIdx * blockParams.GetBlockSize();
+                const ui32 blockEnd = Min(blockBegin + (ui32)blockParams.GetBlockSize(), size);
+
+                ForEachInRange(
+                    hashedCatArraySubset,
+                    TIndexRange<ui32>(blockBegin, blockEnd),
+                    [&] (ui32 idx, ui32 hashedCatValue) {
+                        if (knownSrcValue && (hashedCatValue == *knownSrcValue)) {
+                            ++knownValueCount;
+                            return;
+                        }
+                        auto& valueWithCount = shardHashes[getShardIdx(hashedCatValue)][hashedCatValue];
+                        if (!valueWithCount.Count) {
+                            valueWithCount.Value = idx;
+                        }
+                        ++valueWithCount.Count;
+                    }
+                );
+            },
+            0,
+            blockCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+
+        if (knownDstValueWithCount) {
+            for (auto knownValueBlockCount : knownValueBlockCounts) {
+                knownDstValueWithCount->Count += knownValueBlockCount;
+            }
+        }
+
+        TVector<TCatValuesDenseHash> shardHashes(shardCount);
+        localExecutor->ExecRangeWithThrow(
+            [&] (int shardIdx) {
+                auto& shardHash = shardHashes[shardIdx];
+                shardHash = std::move(blocksShardHashes[0][shardIdx]);
+
+                // blocks are merged in order, so the first occurrence is in the first block with the value
+                for (auto blockIdx : xrange(1, blockCount)) {
+                    auto& blockShardHash = blocksShardHashes[blockIdx][shardIdx];
+                    blockShardHash.ForEach(
+                        [&] (ui32 hashedCatValue, const TValueWithCount& blockValueWithCount) {
+                            auto& valueWithCount = shardHash[hashedCatValue];
+                            if (!valueWithCount.Count) {
+                                valueWithCount.Value = blockValueWithCount.Value;
+                            }
+                            valueWithCount.Count += blockValueWithCount.Count;
+                        }
+                    );
+                    blockShardHash = TCatValuesDenseHash();
+                }
+            },
+            0,
+            shardCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+        blocksShardHashes.clear();
+
+        TVector<size_t> shardOffsets(shardCount + 1, 0);
+        for (auto shardIdx : xrange(shardCount)) {
+            shardOffsets[shardIdx + 1] = shardOffsets[shardIdx] + shardHashes[shardIdx].Size();
+        }
+        const size_t newValuesCount = shardOffsets.back();
+
+        CB_ENSURE(
+            perfectHashMap->GetSize() + newValuesCount <= MAX_UNIQ_CAT_VALUES,
+            "Error: categorical feature with id #" << *catFeatureIdx
+            << " has more than " << MAX_UNIQ_CAT_VALUES
+            << " unique values, which is currently unsupported"
+        );
+
+        // (hashedCatValue, TValueWithCount{first occurrence idx, count}) and then bins in Value
+        TVector<std::pair<ui32, TValueWithCount>> newValues;
+        newValues.yresize(newValuesCount);
+        localExecutor->ExecRangeWithThrow(
+            [&] (int shardIdx) {
+                size_t i = shardOffsets[shardIdx];
+                shardHashes[shardIdx].ForEach(
+                    [&] (ui32 hashedCatValue, const TValueWithCount& valueWithCount) {
+                        newValues[i++] = std::make_pair(hashedCatValue, valueWithCount);
+                    }
+                );
+            },
+            0,
+            shardCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+
+        ParallelRadixSort(
+            [] (const std::pair<ui32, TValueWithCount>& newValue) { return newValue.second.Value; },
+            &newValues,
+            localExecutor
+        );
+
+        const ui32 binsBegin = (ui32)perfectHashMap->GetSize();
+        NPar::ParallelFor(
+            *localExecutor,
+            0,
+            SafeIntegerCast<ui32>(newValuesCount),
+            [&] (ui32 i) {
+                const ui32 bin = binsBegin + i;
+                newValues[i].second.Value = bin;
+                shardHashes[getShardIdx(newValues[i].first)].Get(newValues[i].first).Value = bin;
+            }
+        );
+
+        if (!dstBins.empty()) {
+            hashedCatArraySubset.ParallelForEach(
+                [&] (ui32 idx, ui32 hashedCatValue) {
+                    if (knownSrcValue && (hashedCatValue == *knownSrcValue)) {
+                        dstBins[idx] = knownBin;
+                    } else {
+                        dstBins[idx] = shardHashes[getShardIdx(hashedCatValue)].Get(hashedCatValue).Value;
+                    }
+                },
+                localExecutor
+            );
+        }
+        shardHashes.clear();
+
+        ParallelRadixSort(
+            [] (const std::pair<ui32, TValueWithCount>& newValue) { return newValue.first; },
+            &newValues,
+            localExecutor
+        );
+        for (const auto& [hashedCatValue, valueWithCount] : newValues) {
+            perfectHashMap->Map.emplace_hint(perfectHashMap->Map.end(), hashedCatValue, valueWithCount);
+        }
+    }
+
+
     void TCatFeaturesPerfectHashHelper::UpdatePerfectHashAndMaybeQuantize(
         const TCatFeatureIdx catFeatureIdx,
         const ITypedArraySubset<ui32>& hashedCatArraySubset,
         bool mapMostFrequentValueTo0,
         TMaybe<TDefaultValue<ui32>> hashedCatDefaultValue,
         TMaybe<float> quantizedDefaultBinFraction,
-        TMaybe<TArrayRef<ui32>*> dstBins
+        TMaybe<TArrayRef<ui32>*> dstBins,
+        NPar::TLocalExecutor* localExecutor
     ) {
         QuantizedFeaturesInfo->CheckCorrectPerTypeFeatureIdx(catFeatureIdx);
         auto& featuresHash = QuantizedFeaturesInfo->CatFeaturesPerfectHash;
@@ -50,9 +319,6 @@ namespace NCB {
         // if perfectHashMap is already non-empty existing mapping can't be modified
         const bool perfectHashMapWasEmptyBeforeUpdate = perfectHashMap.Empty();
 
-        constexpr size_t MAX_UNIQ_CAT_VALUES =
-            static_cast<size_t>(Max<ui32>()) + ((sizeof(size_t) > sizeof(ui32)) ? 1 : 0);
-
         ui32 datasetSize = hashedCatArraySubset.GetSize();
 
         if (hashedCatDefaultValue) {
@@ -130,7 +396,15 @@ namespace NCB {
             }
         };
 
-        if (perfectHashMap.DefaultMap) {
+        if (perfectHashMapWasEmptyBeforeUpdate) {
+            BuildPerfectHashMapInParallel(
+                catFeatureIdx,
+                hashedCatArraySubset,
+                dstBinsValue,
+                localExecutor,
+                &perfectHashMap
+            );
+        } else if (perfectHashMap.DefaultMap) {
             const TCatFeaturePerfectHashDefaultValue defaultMap = *perfectHashMap.DefaultMap;
             const ui32 defaultHashedCatValue = defaultMap.SrcValue;
             const ui32 defaultMappedValue = defaultMap.DstValueWithCount.Value;
@@ -7,8 +7,10 @@
 #include <catboost/libs/helpers/mem_usage.h>
 
 #include <library/cpp/object_factory/object_factory.h>
+#include <library/cpp/sse/sse.h>
 #include <library/cpp/string_utils/csv/csv.h>
 
+#include <util/generic/bitops.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/vector.h>
 #include <util/stream/file.h>
@@ -19,10 +21,86 @@
 
 namespace NCB {
 
+    namespace {
+        /* Splitter for lines without quoting (the only ones that can contain just float features).
+         * Delimiter positions are found 16 bytes at a time and then taken from the match bitmask,
+         * so each byte of the line is examined once. Same Consume()/Step() protocol as
+         * NCsvFormat::CsvSplitter with quote = '\0'.
+         */
+        class TDelimiterSplitter {
+        public:
+            TDelimiterSplitter(TStringBuf line, char delimiter)
+                : Line(line)
+                , Delimiter(delimiter)
+                , BlockStart(0)
+                , Mask(LoadMask(0))
+                , TokenBegin(0)
+                , TokenEnd(NextDelimiter())
+            {
+            }
+
+            TStringBuf Consume() const {
+                return Line.SubStr(TokenBegin, TokenEnd - TokenBegin);
+            }
+
+            bool Step() {
+                if (TokenEnd == Line.size()) {
+                    return false;
+                }
+                TokenBegin = TokenEnd + 1;
+                TokenEnd = NextDelimiter();
+                return true;
+            }
+
+        private:
+            static constexpr size_t BlockSize = 16;
+
+            ui32 LoadMask(size_t blockStart) const {
+#ifdef ARCADIA_SSE
+                if (blockStart + BlockSize <= Line.size()) {
+                    const __m128i block = _mm_loadu_si128((const __m128i*)(Line.data() + blockStart));
+                    return (ui32)_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(Delimiter)));
+                }
+#endif
+                ui32 mask = 0;
+                const size_t blockEnd = Min(blockStart + BlockSize, Line.size());
+                for (size_t i = blockStart; i < blockEnd; ++i) {
+                    mask |= ui32(Line[i] == Delimiter) << (i - blockStart);
+                }
+                return mask;
+            }
+
+            size_t NextDelimiter() {
+                while (Mask == 0) {
+                    BlockStart += BlockSize;
+                    if (BlockStart >= Line.size()) {
+                        return Line.size();
+                    }
+                    Mask = LoadMask(BlockStart);
+                }
+                const size_t position = BlockStart + CountTrailingZeroBits(Mask);
+                Mask &= Mask - 1;
+                return position;
+            }
+
+        private:
+            TStringBuf Line;
+            char Delimiter;
+            size_t BlockStart;
+            ui32 Mask;
+            size_t TokenBegin;
+            size_t TokenEnd;
+        };
+    }
+
     TCBDsvDataLoader::TCBDsvDataLoader(TDatasetLoaderPullArgs&& args)
         : TCBDsvDataLoader(
             TLineDataLoaderPushArgs {
-                GetLineDataReader(args.PoolPath, args.CommonArgs.PoolFormat),
+                GetLineDataReader(
+                    args.PoolPath,
+                    args.CommonArgs.PoolFormat,
+                    args.CommonArgs.LocalExecutor
+                ),
                 std::move(args.CommonArgs)
             }
         )
@@ -149,102 +227,108 @@ namespace NCB {
             size_t tokenIdx = 0;
             try {
                 const bool floatFeaturesOnly = catFeatures.empty() && textFeatures.empty();
-                auto splitter = NCsvFormat::CsvSplitter(line, FieldDelimiter, floatFeaturesOnly ? '\0' : CsvSplitterQuote);
-                do {
-                    TStringBuf token = splitter.Consume();
-                    CB_ENSURE(
-                        tokenIdx < columnsDescription.size(),
-                        "wrong column count: found more than " << columnsDescription.ysize() << " values"
-                    );
-                    try {
-                        switch (columnsDescription[tokenIdx].Type) {
-                            case EColumn::Categ: {
-                                if (!FeatureIgnored[featureId]) {
-                                    const ui32 catFeatureIdx = featuresLayout.GetInternalFeatureIdx(featureId);
-                                    catFeatures[catFeatureIdx] = visitor->GetCatFeatureValue(lineIdx, featureId, token);
+                auto processTokens = [&](auto&& splitter) {
+                    do {
+                        TStringBuf token = splitter.Consume();
+                        CB_ENSURE(
+                            tokenIdx < columnsDescription.size(),
+                            "wrong column count: found more than " << columnsDescription.ysize() << " values"
+                        );
+                        try {
+                            switch (columnsDescription[tokenIdx].Type) {
+                                case EColumn::Categ: {
+                                    if (!FeatureIgnored[featureId]) {
+                                        const ui32 catFeatureIdx = featuresLayout.GetInternalFeatureIdx(featureId);
+                                        catFeatures[catFeatureIdx] = visitor->GetCatFeatureValue(lineIdx, featureId, token);
+                                    }
+                                    ++featureId;
+                                    break;
                                 }
-                                ++featureId;
-                                break;
-                            }
-                            case EColumn::Num: {
-                                if (!FeatureIgnored[featureId]) {
-                                    if (!TryParseFloatFeatureValue(
-                                            token,
-                                            &floatFeatures[featuresLayout.GetInternalFeatureIdx(featureId)]
-                                         ))
-                                    {
-                                        CB_ENSURE(
-                                            false,
-                                            "Factor " << featureId << " cannot be parsed as float."
-                                            " Try correcting column description file."
-                                        );
+                                case EColumn::Num: {
+                                    if (!FeatureIgnored[featureId]) {
+                                        if (!TryParseFloatFeatureValue(
+                                                token,
+                                                &floatFeatures[featuresLayout.GetInternalFeatureIdx(featureId)]
+                                             ))
+                                        {
+                                            CB_ENSURE(
+                                                false,
+                                                "Factor " << featureId << " cannot be parsed as float."
+                                                " Try correcting column description file."
+                                            );
+                                        }
                                     }
+                                    ++featureId;
+                                    break;
                                 }
-                                ++featureId;
-                                break;
-                            }
-                            case EColumn::Text: {
-                                if (!FeatureIgnored[featureId]) {
-                                    const ui32 textFeatureIdx = featuresLayout.GetInternalFeatureIdx(featureId);
-                                    textFeatures[textFeatureIdx] = TString(token);
+                                case EColumn::Text: {
+                                    if (!FeatureIgnored[featureId]) {
+                                        const ui32 textFeatureIdx = featuresLayout.GetInternalFeatureIdx(featureId);
+                                        textFeatures[textFeatureIdx] = TString(token);
+                                    }
+                                    ++featureId;
+                                    break;
                                 }
-                                ++featureId;
-                                break;
-                            }
-                            case EColumn::Label: {
-                                CB_ENSURE(token.length() != 0, "empty values not supported for Label");
-                                visitor->AddTarget(targetId, lineIdx, TString(token));
-                                ++targetId;
-                            break;
-                            }
-                            case EColumn::Weight: {
-                                CB_ENSURE(token.length() != 0, "empty values not supported for weight");
-                                visitor->AddWeight(lineIdx, FromString<float>(token));
+                                case EColumn::Label: {
+                                    CB_ENSURE(token.length() != 0, "empty values not supported for Label");
+                                    visitor->AddTarget(targetId, lineIdx, TString(token));
+                                    ++targetId;
                                 break;
+                                }
+                                case EColumn::Weight: {
+                                    CB_ENSURE(token.length() != 0, "empty values not supported for weight");
+                                    visitor->AddWeight(lineIdx, FromString<float>(token));
+                                    break;
+                                }
+                                case EColumn::Auxiliary: {
+                                    break;
+                                }
+                                case EColumn::GroupId: {
+                                    CB_ENSURE(token.length() != 0, "empty values not supported for GroupId");
+                                    visitor->AddGroupId(lineIdx, CalcGroupIdFor(token));
+                                    break;
+                                }
+                                case EColumn::GroupWeight: {
+                                    CB_ENSURE(token.length() != 0, "empty values not supported for GroupWeight");
+                                    visitor->AddGroupWeight(lineIdx, FromString<float>(token));
+                                    break;
+                                }
+                                case EColumn::SubgroupId: {
+                                    CB_ENSURE(token.length() != 0, "empty values not supported for SubgroupId");
+                                    visitor->AddSubgroupId(lineIdx, CalcSubgroupIdFor(token));
+                                    break;
+                                }
+                                case EColumn::Baseline: {
+                                    CB_ENSURE(token.length() != 0, "empty values not supported for Baseline");
+                                    visitor->AddBaseline(lineIdx, baselineIdx, FromString<float>(token));
+                                    ++baselineIdx;
+                                    break;
+                                }
+                                case EColumn::SampleId: {
+                                    break;
+                                }
+                                case EColumn::Timestamp: {
+                                    CB_ENSURE(token.length() != 0, "empty values not supported for Timestamp");
+                                    visitor->AddTimestamp(lineIdx, FromString<ui64>(token));
+                                    break;
+                                }
+                                default: {
+                                    CB_ENSURE(false, "wrong column type");
+                                }
                             }
-                            case EColumn::Auxiliary: {
-                                break;
-                            }
-                            case EColumn::GroupId: {
-                                CB_ENSURE(token.length() != 0, "empty values not supported for GroupId");
-                                visitor->AddGroupId(lineIdx, CalcGroupIdFor(token));
-                                break;
-                            }
-                            case EColumn::GroupWeight: {
-                                CB_ENSURE(token.length() != 0, "empty values not supported for GroupWeight");
-                                visitor->AddGroupWeight(lineIdx, FromString<float>(token));
-                                break;
-                            }
-                            case EColumn::SubgroupId: {
-                                CB_ENSURE(token.length() != 0, "empty values not supported for SubgroupId");
-                                visitor->AddSubgroupId(lineIdx, CalcSubgroupIdFor(token));
-                                break;
-                            }
-                            case EColumn::Baseline: {
-                                CB_ENSURE(token.length() != 0, "empty values not supported for Baseline");
-                                visitor->AddBaseline(lineIdx, baselineIdx, FromString<float>(token));
-                                ++baselineIdx;
-                                break;
-                            }
-                            case EColumn::SampleId: {
-                                break;
-                            }
-                            case EColumn::Timestamp: {
-                                CB_ENSURE(token.length() != 0, "empty values not supported for Timestamp");
-                                visitor->AddTimestamp(lineIdx, FromString<ui64>(token));
-                                break;
-                            }
-                            default: {
-                                CB_ENSURE(false, "wrong column type");
-                            }
+                        } catch (yexception& e) {
+                            throw TCatBoostException() << "Column " << tokenIdx << " (type "
+                                << columnsDescription[tokenIdx].Type << ", value = \"" << token
+                                << "\"): " << e.what();
                         }
-                    } catch (yexception& e) {
-                        throw TCatBoostException() << "Column " << tokenIdx << " (type "
-                            << columnsDescription[tokenIdx].Type << ", value = \"" << token
-                            << "\"): " << e.what();
-                    }
-                    ++tokenIdx;
-                } while (splitter.Step());
+                        ++tokenIdx;
+                    } while (splitter.Step());
+                };
+                if (floatFeaturesOnly) {
+                    processTokens(TDelimiterSplitter(line, FieldDelimiter));
+                } else {
+                    processTokens(NCsvFormat::CsvSplitter(line, FieldDelimiter, CsvSplitterQuote));
+                }
                 CB_ENSURE(
                     tokenIdx == columnsDescription.size(),
                     "wrong column count: expected " << columnsDescription.ysize() << ", found " << tokenIdx
@@ -0,0 +1,435 @@
+#include "columnar_binary_loader.h"
+
+#include "baseline.h"
+#include "data_provider.h"
+
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/maybe_owning_array_holder.h>
+#include <catboost/libs/helpers/polymorphic_type_containers.h>
+#include <catboost/private/libs/data_util/exists_checker.h>
+#include <catboost/private/libs/labels/helpers.h>
+
+#include <library/cpp/object_factory/object_factory.h>
+
+#include <util/generic/cast.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ylimits.h>
+#include <util/stream/file.h>
+#include <util/stream/output.h>
+#include <util/system/align.h>
+#include <util/system/unaligned_mem.h>
+
+#include <type_traits>
+
+
+namespace NCB {
+
+    static const TStringBuf ColumnarBinaryPoolMagic = TStringBuf("CatboostColumnarPool\0", 21);
+    static constexpr ui32 ColumnarBinaryPoolVersion = 1;
+    static constexpr size_t ColumnarBinaryPoolDataAlignment = 16;
+
+    static size_t GetValueSize(EColumnarValueType valueType) {
+        switch (valueType) {
+            case EColumnarValueType::Float32:
+                return sizeof(float);
+            case EColumnarValueType::UInt64:
+                return sizeof(ui64);
+        }
+        CB_ENSURE(false, "Unknown columnar binary pool value type " << (ui32)valueType);
+    }
+
+    static TStringBuf GetValueTypeName(EColumnarValueType valueType) {
+        switch (valueType) {
+            case EColumnarValueType::Float32:
+                return TStringBuf("Float32");
+            case EColumnarValueType::UInt64:
+                return TStringBuf("UInt64");
+        }
+        return TStringBuf("Unknown");
+    }
+
+    template <class T>
+    static void WriteValue(T value, IOutputStream* output) {
+        output->Write(&value, sizeof(value));
+    }
+
+    void SaveColumnarBinaryPool(
+        ui64 objectCount,
+        TConstArrayRef<TColumnarBinaryColumn> columns,
+        IOutputStream* output
+    ) {
+        output->Write(ColumnarBinaryPoolMagic.data(), ColumnarBinaryPoolMagic.size());
+        WriteValue<ui32>(ColumnarBinaryPoolVersion, output);
+        WriteValue<ui32>(SafeIntegerCast<ui32>(columns.size()), output);
+        WriteValue<ui64>(objectCount, output);
+        size_t offset = ColumnarBinaryPoolMagic.size() + 2 * sizeof(ui32) + sizeof(ui64);
+        for (const auto& column : columns) {
+            CB_ENSURE(
+                column.Data.size() == objectCount * GetValueSize(column.ValueType),
+                "Column \"" << column.Name << "\" data size is inconsistent with object count");
+            WriteValue<ui32>((ui32)column.ValueType, output);
+            WriteValue<ui32>(SafeIntegerCast<ui32>(column.Name.size()), output);
+            output->Write(column.Name.data(), column.Name.size());
+            offset += 2 * sizeof(ui32) + column.Name.size();
+        }
+
+        const char padding[ColumnarBinaryPoolDataAlignment] = {};
+        for (const auto& column : columns) {
+            const size_t paddingSize = AlignUp(offset, ColumnarBinaryPoolDataAlignment) - offset;
+            output->Write(padding, paddingSize);
+            output->Write(column.Data.data(), column.Data.size());
+            offset += paddingSize + column.Data.size();
+        }
+    }
+
+
+    template <class T>
+    static TConstArrayRef<ui8> AsBytes(TConstArrayRef<T> values) {
+        return TConstArrayRef<ui8>(reinterpret_cast<const ui8*>(values.data()), values.size() * sizeof(T));
+    }
+
+    void SaveRawDataProviderAsColumnarBinaryPool(
+        const TDataProvider& dataProvider,
+        const TString& poolPath,
+        const TString& cdPath,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        const auto* rawObjectsData = dynamic_cast<const TRawObjectsDataProvider*>(dataProvider.ObjectsData.Get());
+        CB_ENSURE(rawObjectsData, "Only datasets with raw features can be saved in the columnar binary format");
+        CB_ENSURE(
+            dataProvider.RawTargetData.GetPairs().empty(),
+            "Datasets with pairs cannot be saved in the columnar binary format");
+
+        const ui32 objectCount = dataProvider.GetObjectCount();
+        const auto& featuresLayout = *dataProvider.MetaInfo.FeaturesLayout;
+        const auto featuresMetaInfo = featuresLayout.GetExternalFeaturesMetaInfo();
+
+        TVector<TColumnarBinaryColumn> columns;
+        TVector<EColumn> columnTypes;
+        auto addColumn = [&] (EColumn columnType, TString name, EColumnarValueType valueType, TConstArrayRef<ui8> data) {
+            columns.push_back(TColumnarBinaryColumn{std::move(name), valueType, data});
+            columnTypes.push_back(columnType);
+        };
+
+        // column data must outlive SaveColumnarBinaryPool call
+        TVector<TVector<float>> targetData;
+        TVector<ui64> subgroupIdsData;
+        TVector<TMaybeOwningArrayHolder<float>> featuresData;
+
+        const auto targetType = dataProvider.RawTargetData.GetTargetType();
+        CB_ENSURE(
+            (targetType == ERawTargetType::None) || (targetType == ERawTargetType::Float),
+            "Datasets with string targets cannot be saved in the columnar binary format");
+        if (targetType == ERawTargetType::Float) {
+            targetData.resize(dataProvider.RawTargetData.GetTargetDimension());
+            TVector<TArrayRef<float>> targetRefs;
+            for (auto& target : targetData) {
+                target.yresize(objectCount);
+                targetRefs.push_back(target);
+            }
+            dataProvider.RawTargetData.GetNumericTarget(targetRefs);
+            for (const auto& target : targetData) {
+                addColumn(EColumn::Label, "", EColumnarValueType::Float32, AsBytes<float>(target));
+            }
+        }
+
+        const auto& weights = dataProvider.RawTargetData.GetWeights();
+        if (!weights.IsTrivial()) {
+            addColumn(EColumn::Weight, "", EColumnarValueType::Float32, AsBytes<float>(weights.GetNonTrivialData()));
+        }
+        const auto& groupWeights = dataProvider.RawTargetData.GetGroupWeights();
+        if (!groupWeights.IsTrivial()) {
+            addColumn(
+                EColumn::GroupWeight,
+                "",
+                EColumnarValueType::Float32,
+                AsBytes<float>(groupWeights.GetNonTrivialData()));
+        }
+        if (const auto baseline = dataProvider.RawTargetData.GetBaseline()) {
+            for (const auto& baselineForDimension : *baseline) {
+                addColumn(EColumn::Baseline, "", EColumnarValueType::Float32, AsBytes<float>(baselineForDimension));
+            }
+        }
+
+        if (const auto groupIds = rawObjectsData->GetGroupIds()) {
+            addColumn(EColumn::GroupId, "", EColumnarValueType::UInt64, AsBytes<TGroupId>(*groupIds));
+        }
+        if (const auto subgroupIds = rawObjectsData->GetSubgroupIds()) {
+            subgroupIdsData.assign(subgroupIds->begin(), subgroupIds->end());
+            addColumn(EColumn::SubgroupId, "", EColumnarValueType::UInt64, AsBytes<ui64>(subgroupIdsData));
+        }
+        if (const auto timestamps = rawObjectsData->GetTimestamp()) {
+            addColumn(EColumn::Timestamp, "", EColumnarValueType::UInt64, AsBytes<ui64>(*timestamps));
+        }
+
+        for (auto externalFeatureIdx : xrange(featuresMetaInfo.size())) {
+            const auto& featureMetaInfo = featuresMetaInfo[externalFeatureIdx];
+            CB_ENSURE(
+                featureMetaInfo.Type == EFeatureType::Float,
+                "Feature #" << externalFeatureIdx << " has type " << featureMetaInfo.Type
+                << " that is not supported in columnar binary pools");
+            const auto floatFeatureIdx = featuresLayout.GetInternalFeatureIdx(externalFeatureIdx);
+            const auto feature = rawObjectsData->GetFloatFeature(floatFeatureIdx);
+            CB_ENSURE(
+                feature && featureMetaInfo.IsAvailable,
+                "Feature #" << externalFeatureIdx << " is not available and cannot be saved");
+            featuresData.push_back((*feature)->ExtractValues(localExecutor));
+            addColumn(
+                EColumn::Num,
+                featureMetaInfo.Name,
+                EColumnarValueType::Float32,
+                AsBytes<float>(*featuresData.back()));
+        }
+
+        {
+            TOFStream output(poolPath);
+            SaveColumnarBinaryPool(objectCount, columns, &output);
+            output.Finish();
+        }
+        {
+            TOFStream cdOutput(cdPath);
+            for (auto columnIdx : xrange(columnTypes.size())) {
+                cdOutput << columnIdx << '\t' << columnTypes[columnIdx];
+                if (!columns[columnIdx].Name.empty()) {
+                    cdOutput << '\t' << columns[columnIdx].Name;
+                }
+                cdOutput << '\n';
+            }
+            cdOutput.Finish();
+        }
+    }
+
+
+    TColumnarBinaryDataLoader::TColumnarBinaryDataLoader(TDatasetLoaderPullArgs&& args)
+        : Args(std::move(args.CommonArgs))
+        , Blob(TBlob::FromFile(args.PoolPath.Path))
+        , BlobHolder(MakeIntrusive<TBlobHolder>(Blob))
+        , ObjectCount(0) // inited later
+    {
+        CB_ENSURE(!Args.PairsFilePath.Inited() || CheckExists(Args.PairsFilePath),
+                  "TColumnarBinaryDataLoader:PairsFilePath does not exist");
+        CB_ENSURE(!Args.GroupWeightsFilePath.Inited() || CheckExists(Args.GroupWeightsFilePath),
+                  "TColumnarBinaryDataLoader:GroupWeightsFilePath does not exist");
+        CB_ENSURE(!Args.BaselineFilePath.Inited() || CheckExists(Args.BaselineFilePath),
+                  "TColumnarBinaryDataLoader:BaselineFilePath does not exist");
+        CB_ENSURE(!Args.TimestampsFilePath.Inited() || CheckExists(Args.TimestampsFilePath),
+                  "TColumnarBinaryDataLoader:TimestampsFilePath does not exist");
+        CB_ENSURE(!Args.FeatureNamesPath.Inited() || CheckExists(Args.FeatureNamesPath),
+                  "TColumnarBinaryDataLoader:FeatureNamesPath does not exist");
+
+        const ui8* const data = Blob.AsUnsignedCharPtr();
+        const size_t dataSize = Blob.Size();
+        size_t offset = 0;
+        auto readValue = [&] (auto* value) {
+            CB_ENSURE(offset + sizeof(*value) <= dataSize, "Columnar binary pool header is truncated");
+            *value = ReadUnaligned<std::remove_pointer_t<decltype(value)>>(data + offset);
+            offset += sizeof(*value);
+        };
+
+        CB_ENSURE(
+            (dataSize >= ColumnarBinaryPoolMagic.size())
+            && (TStringBuf((const char*)data, ColumnarBinaryPoolMagic.size()) == ColumnarBinaryPoolMagic),
+            "File " << args.PoolPath.Path << " is not a columnar binary pool");
+        offset += ColumnarBinaryPoolMagic.size();
+
+        ui32 version = 0;
+        readValue(&version);
+        CB_ENSURE(
+            version == ColumnarBinaryPoolVersion,
+            "Unsupported columnar binary pool version " << version);
+
+        ui32 columnCount = 0;
+        readValue(&columnCount);
+        ui64 poolObjectCount = 0;
+        readValue(&poolObjectCount);
+        CB_ENSURE(poolObjectCount > 0, "Pool is empty");
+        CB_ENSURE(
+            poolObjectCount <= (ui64)Max<ui32>(),
+            "CatBoost does not support datasets with more than " << Max<ui32>() << " objects");
+
+        const auto& range = Args.DatasetSubset.Range;
+        const ui32 subsetBegin = range.Begin;
+        const ui32 subsetEnd = Min<ui64>(poolObjectCount, range.End);
+        CB_ENSURE(subsetBegin < subsetEnd, "Load subset is outside of the pool objects");
+        ObjectCount = subsetEnd - subsetBegin;
+
+        TVector<EColumnarValueType> valueTypes;
+        TVector<TString> headerColumns;
+        for (auto columnIdx : xrange(columnCount)) {
+            ui32 valueType = 0;
+            readValue(&valueType);
+            valueTypes.push_back(static_cast<EColumnarValueType>(valueType));
+            GetValueSize(valueTypes.back()); // check that value type is valid
+
+            ui32 nameSize = 0;
+            readValue(&nameSize);
+            CB_ENSURE(
+                offset + nameSize <= dataSize,
+                "Columnar binary pool header is truncated at column " << columnIdx);
+            headerColumns.push_back(TString((const char*)data + offset, nameSize));
+            offset += nameSize;
+        }
+
+        for (auto columnIdx : xrange(columnCount)) {
+            offset = AlignUp(offset, ColumnarBinaryPoolDataAlignment);
+            const size_t valueSize = GetValueSize(valueTypes[columnIdx]);
+            const size_t columnSize = poolObjectCount * valueSize;
+            CB_ENSURE(
+                offset + columnSize <= dataSize,
+                "Columnar binary pool data is truncated at column " << columnIdx);
+            Columns.push_back(TColumnData{valueTypes[columnIdx], data + offset + subsetBegin * valueSize});
+            offset += columnSize;
+        }
+
+        auto columnsDescription = TDataColumnsMetaInfo{Args.CdProvider->GetColumnsDescription(columnCount)};
+        const auto targetCount = columnsDescription.CountColumns(EColumn::Label);
+
+        const TVector<TString> featureNames = GetFeatureNames(
+            columnsDescription,
+            headerColumns,
+            Args.FeatureNamesPath
+        );
+
+        const TBaselineReader baselineReader(Args.BaselineFilePath, ClassLabelsToStrings(Args.ClassLabels));
+
+        DataMetaInfo = TDataMetaInfo(
+            std::move(columnsDescription),
+            targetCount ? ERawTargetType::Float : ERawTargetType::None,
+            Args.GroupWeightsFilePath.Inited(),
+            Args.TimestampsFilePath.Inited(),
+            Args.PairsFilePath.Inited(),
+            baselineReader.GetBaselineCount(),
+            &featureNames,
+            Args.ClassLabels
+        );
+
+        ProcessIgnoredFeaturesList(
+            Args.IgnoredFeatures,
+            /*allFeaturesIgnoredMessage*/ Nothing(),
+            &DataMetaInfo,
+            &FeatureIgnored
+        );
+    }
+
+    template <class T>
+    TConstArrayRef<T> TColumnarBinaryDataLoader::GetColumnValues(
+        ui32 columnIdx,
+        EColumnarValueType expectedValueType
+    ) const {
+        const auto& column = Columns[columnIdx];
+        CB_ENSURE(
+            column.ValueType == expectedValueType,
+            "Column " << columnIdx << " (type " << DataMetaInfo.ColumnsInfo->Columns[columnIdx].Type
+            << ") must have value type " << GetValueTypeName(expectedValueType) << " in columnar binary pool");
+        return TConstArrayRef<T>(reinterpret_cast<const T*>(column.Data), ObjectCount);
+    }
+
+    void TColumnarBinaryDataLoader::Do(IRawFeaturesOrderDataVisitor* visitor) {
+        visitor->Start(DataMetaInfo, ObjectCount, Args.ObjectsOrder, {BlobHolder});
+
+        const auto& columnsDescription = DataMetaInfo.ColumnsInfo->Columns;
+
+        ui32 featureId = 0;
+        ui32 targetId = 0;
+        ui32 baselineIdx = 0;
+        for (auto columnIdx : xrange(columnsDescription.size())) {
+            switch (columnsDescription[columnIdx].Type) {
+                case EColumn::Num: {
+                    if (Args.DatasetSubset.HasFeatures && !FeatureIgnored[featureId]) {
+                        const auto values = GetColumnValues<float>(columnIdx, EColumnarValueType::Float32);
+                        visitor->AddFloatFeature(
+                            featureId,
+                            MakeIntrusive<TTypeCastArrayHolder<float, float>>(
+                                TMaybeOwningConstArrayHolder<float>::CreateOwning(values, BlobHolder)
+                            )
+                        );
+                    }
+                    ++featureId;
+                    break;
+                }
+                case EColumn::Label: {
+                    const auto values = GetColumnValues<float>(columnIdx, EColumnarValueType::Float32);
+                    visitor->AddTarget(
+                        targetId,
+                        MakeIntrusive<TTypeCastArrayHolder<float, float>>(
+                            TMaybeOwningConstArrayHolder<float>::CreateOwning(values, BlobHolder)
+                        )
+                    );
+                    ++targetId;
+                    break;
+                }
+                case EColumn::Weight: {
+                    visitor->AddWeights(GetColumnValues<float>(columnIdx, EColumnarValueType::Float32));
+                    break;
+                }
+                case EColumn::GroupWeight: {
+                    visitor->AddGroupWeights(GetColumnValues<float>(columnIdx, EColumnarValueType::Float32));
+                    break;
+                }
+                case EColumn::Baseline: {
+                    visitor->AddBaseline(
+                        baselineIdx,
+                        GetColumnValues<float>(columnIdx, EColumnarValueType::Float32)
+                    );
+                    ++baselineIdx;
+                    break;
+                }
+                case EColumn::GroupId: {
+                    const auto values = GetColumnValues<ui64>(columnIdx, EColumnarValueType::UInt64);
+                    for (auto objectIdx : xrange(ObjectCount)) {
+                        visitor->AddGroupId(objectIdx, values[objectIdx]);
+                    }
+                    break;
+                }
+                case EColumn::SubgroupId: {
+                    const auto values = GetColumnValues<ui64>(columnIdx, EColumnarValueType::UInt64);
+                    for (auto objectIdx : xrange(ObjectCount)) {
+                        visitor->AddSubgroupId(objectIdx, (TSubgroupId)values[objectIdx]);
+                    }
+                    break;
+                }
+                case EColumn::Timestamp: {
+                    const auto values = GetColumnValues<ui64>(columnIdx, EColumnarValueType::UInt64);
+                    for (auto objectIdx : xrange(ObjectCount)) {
+                        visitor->AddTimestamp(objectIdx, values[objectIdx]);
+                    }
+                    break;
+                }
+                case EColumn::Auxiliary:
+                case EColumn::SampleId: {
+                    // column data is not accessed
+                    break;
+                }
+                case EColumn::Categ:
+                case EColumn::Text:
+                case EColumn::Sparse:
+                case EColumn::Prediction: {
+                    CB_ENSURE(
+                        false,
+                        "Column " << columnIdx << " has type " << columnsDescription[columnIdx].Type
+                        << " that is not supported in columnar binary pools"
+                    );
+                }
+            }
+        }
+
+        SetGroupWeights(Args.GroupWeightsFilePath, ObjectCount, Args.DatasetSubset, visitor);
+        SetPairs(Args.PairsFilePath, ObjectCount, Args.DatasetSubset, Args.LocalExecutor, visitor);
+        SetBaseline(
+            Args.BaselineFilePath,
+            ObjectCount,
+            Args.DatasetSubset,
+            ClassLabelsToStrings(Args.ClassLabels),
+            visitor
+        );
+        SetTimestamps(Args.TimestampsFilePath, ObjectCount, Args.DatasetSubset, visitor);
+
+        visitor->Finish();
+    }
+
+    namespace {
+        TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSColumnarBinaryExistsCheckerReg("cbcolumnar");
+        TDatasetLoaderFactory::TRegistrator<TColumnarBinaryDataLoader> ColumnarBinaryDataLoaderReg("cbcolumnar");
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "loader.h"
+
+#include <catboost/libs/helpers/resource_holder.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/memory/blob.h>
+#include <util/stream/fwd.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    /* Columnar binary pool format (scheme "cbcolumnar"), all numbers are little-endian:
+     *
+     *  | Magic "CatboostColumnarPool" (with terminating zero) | 4-byte Version | 4-byte ColumnCount |
+     *  | 8-byte ObjectCount |
+     *  | ColumnCount x (4-byte ValueType | 4-byte NameSize | Name) |
+     *  | ColumnCount x (padding for 16-byte alignment | ObjectCount values of ValueType) |
+     *
+     * Column types are specified by the columns description as for DSV, column names are used like DSV
+     * header. The file is memory-mapped and float columns are passed to the data provider without
+     * copying, so only the data of columns used by the columns description is read.
+     */
+    enum class EColumnarValueType : ui32 {
+        Float32 = 0, // for Num, Label, Baseline, Weight and GroupWeight columns
+        UInt64 = 1   // for GroupId, SubgroupId and Timestamp columns
+    };
+
+    struct TColumnarBinaryColumn {
+        TString Name;
+        EColumnarValueType ValueType = EColumnarValueType::Float32;
+        TConstArrayRef<ui8> Data; // ObjectCount values of ValueType
+    };
+
+    void SaveColumnarBinaryPool(
+        ui64 objectCount,
+        TConstArrayRef<TColumnarBinaryColumn> columns,
+        IOutputStream* output
+    );
+
+    class TDataProvider;
+
+    /* Saves a dataset with raw float features to poolPath in the columnar binary format and its columns
+     * description to cdPath, so it can be loaded back as "cbcolumnar://<poolPath>" with this cd.
+     * Loaded datasets memory-map the file, so many processes can share one page-cached copy of it.
+     * Categorical and text features, string targets and pairs are not supported by the format.
+     */
+    void SaveRawDataProviderAsColumnarBinaryPool(
+        const TDataProvider& dataProvider,
+        const TString& poolPath,
+        const TString& cdPath,
+        NPar::TLocalExecutor* localExecutor
+    );
+
+
+    class TColumnarBinaryDataLoader : public IRawFeaturesOrderDatasetLoader {
+    public:
+        explicit TColumnarBinaryDataLoader(TDatasetLoaderPullArgs&& args);
+
+        void Do(IRawFeaturesOrderDataVisitor* visitor) override;
+
+    private:
+        struct TColumnData {
+            EColumnarValueType ValueType;
+            const ui8* Data; // points to the value of the first object in the loaded subset
+        };
+
+        template <class T>
+        TConstArrayRef<T> GetColumnValues(ui32 columnIdx, EColumnarValueType expectedValueType) const;
+
+    private:
+        TDatasetLoaderCommonArgs Args;
+        TBlob Blob;
+        TIntrusivePtr<IResourceHolder> BlobHolder;
+        ui32 ObjectCount; // in the loaded subset
+        TVector<TColumnData> Columns;
+        TDataMetaInfo DataMetaInfo;
+        TVector<bool> FeatureIgnored;
+    };
+
+}
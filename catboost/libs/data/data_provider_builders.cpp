@@ -147,6 +147,12 @@ namespace NCB {
         }
 
         void StartNextBlock(ui32 blockSize) override {
+            if (Cursor != NotSet) {
+                // move sparse data of the previous block to per-feature storage to limit memory usage
+                FloatFeaturesStorage.FinishBlock();
+                CatFeaturesStorage.FinishBlock();
+                TextFeaturesStorage.FinishBlock();
+            }
             Cursor = NextCursor;
             NextCursor = Cursor + blockSize;
         }
@@ -608,6 +614,11 @@ namespace NCB {
 
             std::array<TSparsePart, CB_THREAD_LIMIT> SparseDataParts; // [threadId]
 
+            /* accumulated from SparseDataParts after each block if !DataCanBeReusedForNextBlock
+             * so per-thread parts contain only the data of the current block
+             */
+            TVector<TSparseDataForBuider> SparseDataForBuilders; // [perTypeFeatureIdx]
+
             // [perTypeFeaturesIdx] + extra element for adding new features
             TVector<TSetCallback> PerFeatureCallbacks;
 
@@ -677,25 +688,108 @@ namespace NCB {
             }
 
 
+            /* Parts are processed in parallel by feature ranges: first entries of each part are grouped
+             * by feature range, then data for each range is appended to SparseDataForBuilders
+             */
+            void MoveSparsePartsToPerFeatureData() {
+                TVector<ui32> partFeatureCounts(SparseDataParts.size(), 0);
+                LocalExecutor->ExecRangeWithThrow(
+                    [&] (int partIdx) {
+                        for (const auto& index2d : SparseDataParts[partIdx].Indices) {
+                            partFeatureCounts[partIdx] = Max(partFeatureCounts[partIdx], index2d.PerTypeFeatureIdx + 1);
+                        }
+                    },
+                    0,
+                    SafeIntegerCast<int>(SparseDataParts.size()),
+                    NPar::TLocalExecutor::WAIT_COMPLETE
+                );
+                const size_t featureCount = Max<size_t>(
+                    SparseDataForBuilders.size(),
+                    PerFeatureData.size(),
+                    size_t(*MaxElement(partFeatureCounts.begin(), partFeatureCounts.end()))
+                );
+                if (!featureCount) {
+                    return;
+                }
+                SparseDataForBuilders.resize(featureCount);
+
+                const size_t rangeCount = Min<size_t>(featureCount, LocalExecutor->GetThreadCount() + 1);
+                auto getRangeIdx = [=] (ui32 perTypeFeatureIdx) {
+                    return (ui64(perTypeFeatureIdx) * rangeCount) / featureCount;
+                };
+
+                // [partIdx][rangeIdx] -> indices in part
+                TVector<TVector<TVector<ui32>>> partRangeEntries(SparseDataParts.size());
+                LocalExecutor->ExecRangeWithThrow(
+                    [&] (int partIdx) {
+                        const auto& indices = SparseDataParts[partIdx].Indices;
+                        if (indices.empty()) {
+                            return;
+                        }
+                        auto& rangeEntries = partRangeEntries[partIdx];
+                        rangeEntries.resize(rangeCount);
+                        for (auto i : xrange(SafeIntegerCast<ui32>(indices.size()))) {
+                            rangeEntries[getRangeIdx(indices[i].PerTypeFeatureIdx)].push_back(i);
+                        }
+                    },
+                    0,
+                    SafeIntegerCast<int>(SparseDataParts.size()),
+                    NPar::TLocalExecutor::WAIT_COMPLETE
+                );
+
+                LocalExecutor->ExecRangeWithThrow(
+                    [&] (int rangeIdx) {
+                        for (auto partIdx : xrange(SparseDataParts.size())) {
+                            if (partRangeEntries[partIdx].empty()) {
+                                continue;
+                            }
+                            auto& sparseDataPart = SparseDataParts[partIdx];
+                            for (auto i : partRangeEntries[partIdx][rangeIdx]) {
+                                const auto index2d = sparseDataPart.Indices[i];
+                                auto& dataForBuilder = SparseDataForBuilders[index2d.PerTypeFeatureIdx];
+                                dataForBuilder.ObjectIndices.push_back(index2d.ObjectIdx);
+                                dataForBuilder.Values.push_back(std::move(sparseDataPart.Values[i]));
+                            }
+                        }
+                    },
+                    0,
+                    SafeIntegerCast<int>(rangeCount),
+                    NPar::TLocalExecutor::WAIT_COMPLETE
+                );
+
+                for (auto& sparseDataPart : SparseDataParts) {
+                    sparseDataPart.Indices.clear();
+                    sparseDataPart.Values.clear();
+                }
+            }
+
             TVector<TMaybe<TConstPolymorphicValuesSparseArray<T, ui32>>> CreateSparseArrays(
                 ui32 objectCount,
                 ESparseArrayIndexingType sparseArrayIndexingType,
                 NPar::TLocalExecutor* localExecutor
             ) {
-                TVector<TSparseDataForBuider> sparseDataForBuilders(PerFeatureData.size()); // [perTypeFeatureIdx]
-
-                for (auto& sparseDataPart : SparseDataParts) {
-                    for (auto i : xrange(sparseDataPart.Indices.size())) {
-                        auto index2d = sparseDataPart.Indices[i];
-                        if (index2d.PerTypeFeatureIdx >= sparseDataForBuilders.size()) {
-                            // add previously unknown features
-                            sparseDataForBuilders.resize(index2d.PerTypeFeatureIdx + 1);
+                TVector<TSparseDataForBuider> sparseDataForBuilders; // [perTypeFeatureIdx]
+
+                if (DataCanBeReusedForNextBlock) {
+                    sparseDataForBuilders.resize(PerFeatureData.size());
+                    for (auto& sparseDataPart : SparseDataParts) {
+                        for (auto i : xrange(sparseDataPart.Indices.size())) {
+                            auto index2d = sparseDataPart.Indices[i];
+                            if (index2d.PerTypeFeatureIdx >= sparseDataForBuilders.size()) {
+                                // add previously unknown features
+                                sparseDataForBuilders.resize(index2d.PerTypeFeatureIdx + 1);
+                            }
+                            auto& dataForBuilder = sparseDataForBuilders[index2d.PerTypeFeatureIdx];
+                            dataForBuilder.ObjectIndices.push_back(index2d.ObjectIdx);
+                            dataForBuilder.Values.push_back(std::move(sparseDataPart.Values[i]));
                         }
-                        auto& dataForBuilder = sparseDataForBuilders[index2d.PerTypeFeatureIdx];
-                        dataForBuilder.ObjectIndices.push_back(index2d.ObjectIdx);
-                        dataForBuilder.Values.push_back(std::move(sparseDataPart.Values[i]));
                     }
-                    if (!DataCanBeReusedForNextBlock) {
+                } else {
+                    MoveSparsePartsToPerFeatureData();
+                    sparseDataForBuilders = std::move(SparseDataForBuilders);
+                    SparseDataForBuilders.clear();
+                    sparseDataForBuilders.resize(Max(sparseDataForBuilders.size(), PerFeatureData.size()));
+                    for (auto& sparseDataPart : SparseDataParts) {
                         sparseDataPart = TSparsePart();
                     }
                 }
@@ -807,6 +901,14 @@ namespace NCB {
                 if (HasSparseData) {
                     PrepareForInitializationSparseParts(prevObjectCount, prevTailSize);
                 }
+                SparseDataForBuilders.clear();
+            }
+
+            // called when all data for the previous block has been set
+            void FinishBlock() {
+                if (HasSparseData && !DataCanBeReusedForNextBlock) {
+                    MoveSparsePartsToPerFeatureData();
+                }
             }
 
             void Set(TFeatureIdx<FeatureType> perTypeFeatureIdx, ui32 objectIdx, T value) {
@@ -1462,7 +1564,7 @@ namespace NCB {
                 GetInternalFeatureIdx<EFeatureType::Float>(flatFeatureIdx),
                 objectOffset,
                 bitsPerDocumentFeature,
-                *featuresPart,
+                featuresPart,
                 LocalExecutor
             );
         }
@@ -1477,7 +1579,7 @@ namespace NCB {
                 GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx),
                 objectOffset,
                 bitsPerDocumentFeature,
-                *featuresPart,
+                featuresPart,
                 LocalExecutor
             );
         }
@@ -1830,6 +1932,11 @@ namespace NCB {
              */
             TVector<TIntrusivePtr<TVectorHolder<ui64>>> DenseDataStorage; // [perTypeFeatureIdx]
 
+            /* if not null - feature data is referenced from external storage (a mapped pool file for example)
+             * without copying, DenseDstView points to it
+             */
+            TVector<TIntrusivePtr<IResourceHolder>> ExternalDataHolders; // [perTypeFeatureIdx]
+
             // view into storage for faster access
             TVector<TArrayRef<ui64>> DenseDstView; // [perTypeFeatureIdx]
 
@@ -1850,6 +1957,8 @@ namespace NCB {
             // copy from Data.MetaInfo.FeaturesLayout for fast access
             TVector<bool> IsAvailable; // [perTypeFeatureIdx]
 
+            ui32 ObjectCount = 0;
+
         public:
             void PrepareForInitialization(
                 const TFeaturesLayout& featuresLayout,
@@ -1859,7 +1968,9 @@ namespace NCB {
                 TConstArrayRef<TMaybe<TPackedBinaryIndex>> flatFeatureIndexToPackedBinaryIndex
             ) {
                 const size_t perTypeFeatureCount = (size_t)featuresLayout.GetFeatureCount(FeatureType);
+                ObjectCount = objectCount;
                 DenseDataStorage.resize(perTypeFeatureCount);
+                ExternalDataHolders.assign(perTypeFeatureCount, nullptr);
                 DenseDstView.resize(perTypeFeatureCount);
                 IndexHelpers.resize(perTypeFeatureCount, TIndexHelper<ui64>(8));
                 FeatureIdxToPackedBinaryIndex.resize(perTypeFeatureCount);
@@ -1930,13 +2041,15 @@ namespace NCB {
                 TFeatureIdx<FeatureType> perTypeFeatureIdx,
                 ui32 objectOffset,
                 ui8 bitsPerDocumentFeature,
-                TConstArrayRef<ui8> featuresPart,
+                const TMaybeOwningConstArrayHolder<ui8>& featuresPartHolder,
                 NPar::TLocalExecutor* localExecutor
             ) {
                 if (!IsAvailable[*perTypeFeatureIdx]) {
                     return;
                 }
 
+                const TConstArrayRef<ui8> featuresPart = *featuresPartHolder;
+
                 if (FeatureIdxToPackedBinaryIndex[*perTypeFeatureIdx]) {
                     auto packedBinaryIndex = *FeatureIdxToPackedBinaryIndex[*perTypeFeatureIdx];
                     auto dstSlice = DstBinaryView[packedBinaryIndex.PackIdx].Slice(
@@ -1959,6 +2072,27 @@ namespace NCB {
 
                     const auto bytesPerDocument = bitsPerDocumentFeature / (sizeof(ui8) * CHAR_BIT);
 
+                    CB_ENSURE_INTERNAL(
+                        !ExternalDataHolders[*perTypeFeatureIdx],
+                        "Feature #" << *perTypeFeatureIdx << " data has already been set for all objects");
+
+                    /* data for all objects that will stay available (holder is owning) is referenced directly,
+                     * without copying
+                     */
+                    if ((objectOffset == 0) &&
+                        featuresPartHolder.GetResourceHolder() &&
+                        (featuresPart.size() == (size_t)ObjectCount * bytesPerDocument) &&
+                        !(reinterpret_cast<uintptr_t>(featuresPart.data()) % alignof(ui64)))
+                    {
+                        ExternalDataHolders[*perTypeFeatureIdx] = featuresPartHolder.GetResourceHolder();
+                        DenseDataStorage[*perTypeFeatureIdx] = nullptr;
+                        DenseDstView[*perTypeFeatureIdx] = TArrayRef<ui64>(
+                            const_cast<ui64*>(reinterpret_cast<const ui64*>(featuresPart.data())),
+                            IndexHelpers[*perTypeFeatureIdx].CompressedSize(ObjectCount)
+                        );
+                        return;
+                    }
+
                     const auto dstCapacityInBytes =
                         DenseDstView[*perTypeFeatureIdx].size() *
                         sizeof(decltype(*DenseDstView[*perTypeFeatureIdx].data()));
@@ -2024,7 +2158,9 @@ namespace NCB {
                                         IndexHelpers[perTypeFeatureIdx].GetBitsPerKey(),
                                         TMaybeOwningArrayHolder<ui64>::CreateOwning(
                                             DenseDstView[perTypeFeatureIdx],
-                                            DenseDataStorage[perTypeFeatureIdx]
+                                            ExternalDataHolders[perTypeFeatureIdx]
+                                                ? ExternalDataHolders[perTypeFeatureIdx]
+                                                : TIntrusivePtr<IResourceHolder>(DenseDataStorage[perTypeFeatureIdx])
                                         )
                                     ),
                                     subsetIndexing
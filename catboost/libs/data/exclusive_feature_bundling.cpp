@@ -92,6 +92,9 @@ namespace NCB {
         return intersectionCount;
     }
 
+    // features with fewer non default blocks are checked against candidate bundles sequentially
+    constexpr size_t MinMaskBlocksForParallelConflictCounting = 256;
+
     static TVector<TExclusiveFeaturesBundle> CreateExclusiveFeatureBundlesImpl(
         ui32 objectCount,
         const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
@@ -113,6 +116,8 @@ namespace NCB {
 
         TFastRng64 rng(0);
 
+        TVector<ui32> intersectionCounts; // buffer for parallel conflicts counting
+
         for (auto flatFeatureIdx : flatFeatureIndicesToCalc) {
             const auto featureMetaInfo = featuresLayout.GetExternalFeaturesMetaInfo()[flatFeatureIdx];
 
@@ -157,19 +162,19 @@ namespace NCB {
                 return true;
             };
 
-            auto tryAddToBundle = [&] (ui32 bundleIdx) -> bool {
-                auto& bundle = bundles[bundleIdx];
-                auto& bundleForMerging = bundlesForMerging[bundleIdx];
-
-                auto maxRemaininingIntersectionCount
-                    = maxObjectIntersection - bundleForMerging.IntersectionCount;
+            auto getMaxRemainingIntersectionCount = [&] (ui32 bundleIdx) -> ui32 {
+                return maxObjectIntersection - bundlesForMerging[bundleIdx].IntersectionCount;
+            };
 
-                ui32 intersectionCount = CalcIntersectionCount(
-                    bundleForMerging.UsedObjects,
+            auto calcIntersectionCount = [&] (ui32 bundleIdx) -> ui32 {
+                return CalcIntersectionCount(
+                    bundlesForMerging[bundleIdx].UsedObjects,
                     featureNonDefaultMasks,
-                    maxRemaininingIntersectionCount);
+                    getMaxRemainingIntersectionCount(bundleIdx));
+            };
 
-                if (intersectionCount <= maxRemaininingIntersectionCount) {
+            auto tryAddToBundleWithIntersectionCount = [&] (ui32 bundleIdx, ui32 intersectionCount) -> bool {
+                if (intersectionCount <= getMaxRemainingIntersectionCount(bundleIdx)) {
                      AddFeatureToBundle(
                         quantizedFeaturesInfo,
                         flatFeatureIdx,
@@ -177,8 +182,8 @@ namespace NCB {
                         featureNonDefaultCount,
                         binCountInBundleNeeded,
                         intersectionCount,
-                        &bundle,
-                        &bundleForMerging
+                        &bundles[bundleIdx],
+                        &bundlesForMerging[bundleIdx]
                     );
                     flatFeatureIdxToBundleIdx[flatFeatureIdx] = bundleIdx;
                     return true;
@@ -186,6 +191,10 @@ namespace NCB {
                 return false;
             };
 
+            auto tryAddToBundle = [&] (ui32 bundleIdx) -> bool {
+                return tryAddToBundleWithIntersectionCount(bundleIdx, calcIntersectionCount(bundleIdx));
+            };
+
 
             THashSet<ui32> checkedBundlesForNeighbors;
 
@@ -227,9 +236,40 @@ namespace NCB {
                 bundlesToCheck.resize(maxBundlesToCheck);
             }
 
-            for (auto bundleIdx : bundlesToCheck) {
-                if (tryAddToBundle(bundleIdx)) {
-                    break;
+            if (featureNonDefaultMasks.size() < MinMaskBlocksForParallelConflictCounting) {
+                for (auto bundleIdx : bundlesToCheck) {
+                    if (tryAddToBundle(bundleIdx)) {
+                        break;
+                    }
+                }
+            } else {
+                /* Conflicts with candidate bundles are counted in parallel by chunks of bundles.
+                 * Bundles are not modified within a chunk, so the first suitable bundle in
+                 * bundlesToCheck order is selected - the same as with sequential counting.
+                 */
+                const size_t chunkSize = SafeIntegerCast<size_t>(localExecutor->GetThreadCount() + 1);
+                for (size_t chunkStart = 0;
+                     (chunkStart < bundlesToCheck.size()) && !flatFeatureIdxToBundleIdx[flatFeatureIdx];
+                     chunkStart += chunkSize)
+                {
+                    const size_t chunkEnd = Min(chunkStart + chunkSize, bundlesToCheck.size());
+                    intersectionCounts.yresize(chunkEnd - chunkStart);
+                    NPar::ParallelFor(
+                        *localExecutor,
+                        0,
+                        SafeIntegerCast<ui32>(chunkEnd - chunkStart),
+                        [&] (ui32 i) {
+                            intersectionCounts[i] = calcIntersectionCount(bundlesToCheck[chunkStart + i]);
+                        }
+                    );
+                    for (auto i : xrange(chunkStart, chunkEnd)) {
+                        if (tryAddToBundleWithIntersectionCount(
+                                bundlesToCheck[i],
+                                intersectionCounts[i - chunkStart]))
+                        {
+                            break;
+                        }
+                    }
                 }
             }
 
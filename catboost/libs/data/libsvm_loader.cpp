@@ -64,7 +64,11 @@ namespace NCB {
     TLibSvmDataLoader::TLibSvmDataLoader(TDatasetLoaderPullArgs&& args)
         : TLibSvmDataLoader(
             TLineDataLoaderPushArgs {
-                GetLineDataReader(args.PoolPath, args.CommonArgs.PoolFormat),
+                GetLineDataReader(
+                    args.PoolPath,
+                    args.CommonArgs.PoolFormat,
+                    args.CommonArgs.LocalExecutor
+                ),
                 std::move(args.CommonArgs)
             }
         )
@@ -174,15 +178,20 @@ namespace NCB {
 
             TConstArrayRef<TFeatureMetaInfo> featuresMetaInfo = featuresLayout.GetExternalFeaturesMetaInfo();
 
+            /* reserve by the number of features in the line, not in the layout:
+             * rows are sparse and the number of features can be huge
+             */
+            const size_t lineFeatureCount = Count(line, ':');
+
             TVector<ui32> floatFeatureIndices;
-            floatFeatureIndices.reserve(featuresLayout.GetFloatFeatureCount());
+            floatFeatureIndices.reserve(lineFeatureCount);
             TVector<float> floatFeatureValues;
-            floatFeatureValues.reserve(featuresLayout.GetFloatFeatureCount());
+            floatFeatureValues.reserve(lineFeatureCount);
 
             TVector<ui32> catFeatureIndices;
-            catFeatureIndices.reserve(featuresLayout.GetCatFeatureCount());
+            catFeatureIndices.reserve(lineFeatureCount);
             TVector<ui32> catFeatureValues;
-            catFeatureValues.reserve(featuresLayout.GetCatFeatureCount());
+            catFeatureValues.reserve(lineFeatureCount);
 
             try {
                 auto lineSplitter = StringSplitter(line).Split(' ');
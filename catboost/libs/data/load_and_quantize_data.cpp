@@ -22,6 +22,7 @@
 
 #include <library/cpp/threading/local_executor/local_executor.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/vector.h>
 #include <util/generic/xrange.h>
 #include <util/generic/ylimits.h>
@@ -66,6 +67,7 @@ namespace {
             TMaybe<TString> inputBordersPath,
             TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
             THolder<IDataProviderBuilder> builder,
+            bool needAllGroupIds, // group ids for all objects are required only for data from external sources
             TRestorableFastRng64* rand,
             NPar::TLocalExecutor* localExecutor)
             : LocalExecutor(localExecutor)
@@ -74,8 +76,8 @@ namespace {
             , QuantizedFeaturesInfo(std::move(quantizedFeaturesInfo))
             , DataBuilder(std::move(builder))
             , DataVisitor(dynamic_cast<NCB::IRawObjectsOrderDataVisitor*>(DataBuilder.Get()))
+            , NeedAllGroupIds(needAllGroupIds)
             , Rand(rand)
-            , SampleInvertedSubset(TFullSubset<ui32>(0))
         {
             CB_ENSURE_INTERNAL(DataBuilder != nullptr, "no builder provided");
             CB_ENSURE_INTERNAL(
@@ -111,29 +113,36 @@ namespace {
                 &QuantizationOptions,
                 &QuantizedFeaturesInfo);
 
-            SampleSubset = MakeIncrementalIndexing(
-                GetArraySubsetForBuildBorders(
-                    ObjectCount,
-                    QuantizedFeaturesInfo->GetFloatFeatureBinarization(Max<ui32>()).BorderSelectionType,
-                    objectsOrder == EObjectsOrder::RandomShuffled,
-                    QuantizationOptions.MaxSubsetSizeForBuildBordersAlgorithms,
-                    Rand),
-                LocalExecutor);
-            SampleInvertedSubset = GetInvertedIndexing(SampleSubset, ObjectCount, LocalExecutor);
-            IsFullSubset = SampleSubset.IsFullSubset();
+            // if all borders are already known (e.g. from input borders) keep the sample minimal
+            TArraySubsetIndexing<ui32> sampleSubset = NeedToCalcBorders()
+                ? MakeIncrementalIndexing(
+                    GetArraySubsetForBuildBorders(
+                        ObjectCount,
+                        QuantizedFeaturesInfo->GetFloatFeatureBinarization(Max<ui32>()).BorderSelectionType,
+                        objectsOrder == EObjectsOrder::RandomShuffled,
+                        QuantizationOptions.MaxSubsetSizeForBuildBordersAlgorithms,
+                        Rand),
+                    LocalExecutor)
+                : TArraySubsetIndexing<ui32>(TFullSubset<ui32>(1));
+            IsFullSubset = (sampleSubset.Size() == ObjectCount);
             if (!IsFullSubset) {
-                auto* indexedSubset = ::GetIf<TInvertedIndexedSubset<ui32>>(&SampleInvertedSubset);
-                CB_ENSURE_INTERNAL(
-                    indexedSubset != nullptr,
-                    "inverted subset should be either indexed or full");
-                GlobalIdxToSampleIdx = indexedSubset->GetMapping();
-            }
-            SampleCount = SampleSubset.Size();
+                /* only sorted sample indices are stored (instead of an inverted index for all objects),
+                 * mapping for the current block is built in StartNextBlock
+                 */
+                SampleIndices.reserve(sampleSubset.Size());
+                sampleSubset.ForEach(
+                    [&] (ui32 sampleIdx, ui32 srcIdx) {
+                        Y_ASSERT(sampleIdx == SampleIndices.size());
+                        SampleIndices.push_back(srcIdx);
+                    });
+            }
+            SampleCount = sampleSubset.Size();
+            NextSampleIdx = 0;
 
             Cursor = NotSet;
             NextCursor = 0;
 
-            NCB::PrepareForInitialization(metaInfo.HasGroupId, ObjectCount, 0, &AllGroupIds);
+            NCB::PrepareForInitialization(metaInfo.HasGroupId && NeedAllGroupIds, ObjectCount, 0, &AllGroupIds);
 
             DataVisitor->Start(
                 inBlock,
@@ -149,20 +158,43 @@ namespace {
         void StartNextBlock(ui32 blockSize) override {
             Cursor = NextCursor;
             NextCursor = Cursor + blockSize;
+
+            if (!IsFullSubset) {
+                BlockSampleIndices.yresize(blockSize);
+                Fill(BlockSampleIndices.begin(), BlockSampleIndices.end(), NotSet);
+                for (; (NextSampleIdx < SampleIndices.size()) && (SampleIndices[NextSampleIdx] < NextCursor);
+                     ++NextSampleIdx)
+                {
+                    BlockSampleIndices[SampleIndices[NextSampleIdx] - Cursor] = NextSampleIdx;
+                }
+            }
         }
 
     private:
+        bool NeedToCalcBorders() const {
+            bool needToCalcBorders = false;
+            QuantizedFeaturesInfo->GetFeaturesLayout()->IterateOverAvailableFeatures<EFeatureType::Float>(
+                [&] (TFloatFeatureIdx floatFeatureIdx) {
+                    if (!QuantizedFeaturesInfo->HasBorders(floatFeatureIdx)) {
+                        needToCalcBorders = true;
+                    }
+                }
+            );
+            return needToCalcBorders;
+        }
+
         ui32 GetSampleIdx(ui32 localObjectIdx) const {
-            const ui32 globalObjectIdx = Cursor + localObjectIdx;
             if (IsFullSubset) {
-                return globalObjectIdx;
+                return Cursor + localObjectIdx;
             }
-            return GlobalIdxToSampleIdx[globalObjectIdx];
+            return BlockSampleIndices[localObjectIdx];
         }
 
     public:
         void AddGroupId(ui32 localObjectIdx, TGroupId value) override {
-            (*AllGroupIds)[Cursor + localObjectIdx] = value;
+            if (AllGroupIds) {
+                (*AllGroupIds)[Cursor + localObjectIdx] = value;
+            }
 
             const ui32 sampleIdx = GetSampleIdx(localObjectIdx);
             if (sampleIdx == NotSet) {
@@ -426,6 +458,7 @@ namespace {
 
         THolder<IDataProviderBuilder> DataBuilder;
         IRawObjectsOrderDataVisitor* DataVisitor;
+        bool NeedAllGroupIds;
         TRestorableFastRng64* Rand;
 
         ui32 ObjectCount;
@@ -436,11 +469,11 @@ namespace {
         ui32 Cursor;
         ui32 NextCursor;
 
-        TArraySubsetIndexing<ui32> SampleSubset;
-        TArraySubsetInvertedIndexing<ui32> SampleInvertedSubset;
         bool IsFullSubset;
-        // mapping available only when SampleSubset is not full
-        TConstArrayRef<ui32> GlobalIdxToSampleIdx;
+        // available only when sample is not full
+        TVector<ui32> SampleIndices; // sorted src indices of sampled objects
+        ui32 NextSampleIdx; // first sample index not in already started blocks
+        TVector<ui32> BlockSampleIndices; // [localObjectIdx] -> sampleIdx or NotSet for the current block
 
         // group ids for all objects, required for GetGroupIds and data from external sources
         TMaybeData<TVector<TGroupId>> AllGroupIds;
@@ -841,6 +874,7 @@ TDataProviderPtr NCB::ReadAndQuantizeDataset(
             TDataProviderBuilderOptions{},
             loadSubset,
             localExecutor),
+        /*needAllGroupIds*/ groupWeightsFilePath.Inited() || timestampsFilePath.Inited(),
         &rand,
         localExecutor);
     datasetLoader->DoIfCompatible(&firstPassVisitor);
@@ -1,3 +1,4 @@
+#include "async_row_processor.h"
 #include "baseline.h"
 #include "loader.h"
 
@@ -14,6 +15,7 @@
 #include <util/string/split.h>
 #include <util/system/types.h>
 
+#include <cfloat>
 #include <limits>
 #include <utility>
 
@@ -56,63 +58,108 @@ namespace NCB {
     }
 
 
-    static TVector<TPair> ReadPairs(const TPathWithScheme& filePath, ui64 docCount, TDatasetSubset loadSubset) {
-        THolder<ILineDataReader> reader = GetLineDataReader(filePath);
-
-        TVector<TPair> pairs;
-        TString line;
-        for (size_t lineNumber = 0; reader->ReadLine(&line); lineNumber++) {
-            TVector<TString> tokens = StringSplitter(line).Split('\t');
+    // returns false if the line does not contain a pair from loadSubset
+    static bool ParsePairsLine(
+        TStringBuf line,
+        size_t lineNumber,
+        ui64 docCount,
+        TDatasetSubset loadSubset,
+        TPair* pair
+    ) {
+        try {
+            TVector<TStringBuf> tokens = StringSplitter(line).Split('\t');
             if (tokens.empty()) {
-                continue;
+                return false;
             }
-            try {
-                CB_ENSURE(tokens.ysize() == 2 || tokens.ysize() == 3,
-                    "Each line should have two or three columns. This line has " << tokens.size()
-                );
-                TPair pair;
+            CB_ENSURE(tokens.ysize() == 2 || tokens.ysize() == 3,
+                "Each line should have two or three columns. This line has " << tokens.size()
+            );
 
-                size_t tokenIdx = 0;
-                auto parseIdFunc = [&](TStringBuf description, ui32* id) {
+            size_t tokenIdx = 0;
+            auto parseIdFunc = [&](TStringBuf description, ui32* id) {
+                CB_ENSURE(
+                    TryFromString(tokens[tokenIdx], *id),
+                    "Invalid " << description << " index: cannot parse as nonnegative index ("
+                    << tokens[tokenIdx] << ')'
+                );
+                *id -= loadSubset.Range.Begin;
+                if (*id < loadSubset.GetSize()) {
                     CB_ENSURE(
-                        TryFromString(tokens[tokenIdx], *id),
-                        "Invalid " << description << " index: cannot parse as nonnegative index ("
-                        << tokens[tokenIdx] << ')'
+                        *id < docCount,
+                        "Invalid " << description << " index (" << *id << "): not less than number of samples"
+                        " (" << docCount << ')'
                     );
-                    *id -= loadSubset.Range.Begin;
-                    if (*id < loadSubset.GetSize()) {
-                        CB_ENSURE(
-                            *id < docCount,
-                            "Invalid " << description << " index (" << *id << "): not less than number of samples"
-                            " (" << docCount << ')'
-                        );
-                    }
-                    ++tokenIdx;
-                };
-                parseIdFunc(AsStringBuf("Winner"), &pair.WinnerId);
-                parseIdFunc(AsStringBuf("Loser"), &pair.LoserId);
+                }
+                ++tokenIdx;
+            };
+            parseIdFunc(AsStringBuf("Winner"), &pair->WinnerId);
+            parseIdFunc(AsStringBuf("Loser"), &pair->LoserId);
 
-                pair.Weight = 1.0f;
-                if (tokens.ysize() == 3) {
-                    CB_ENSURE(
-                        TryFromString(tokens[2], pair.Weight),
-                        "Invalid weight: cannot parse as float (" << tokens[2] << ')'
+            pair->Weight = 1.0f;
+            if (tokens.ysize() == 3) {
+                CB_ENSURE(
+                    TryFromString(tokens[2], pair->Weight),
+                    "Invalid weight: cannot parse as float (" << tokens[2] << ')'
+                );
+            }
+            if (pair->WinnerId < loadSubset.GetSize() && pair->LoserId < loadSubset.GetSize()) {
+                return true;
+            }
+            CB_ENSURE(
+                pair->WinnerId >= loadSubset.GetSize() && pair->LoserId >= loadSubset.GetSize(),
+                "Load subset " << loadSubset.Range << " must contain loser "
+                << pair->LoserId + loadSubset.Range.Begin << " and winner " << pair->WinnerId + loadSubset.Range.Begin
+            );
+            return false;
+        } catch (const TCatBoostException& e) {
+            throw TCatBoostException() << "Incorrect file with pairs. Invalid line number #" << lineNumber
+                << ": " << e.what();
+        }
+    }
+
+    static TVector<TPair> ReadPairs(
+        const TPathWithScheme& filePath,
+        ui64 docCount,
+        TDatasetSubset loadSubset,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        constexpr size_t BlockSize = 1 << 16;
+
+        THolder<ILineDataReader> reader = GetLineDataReader(filePath);
+        auto readFunc = [&reader] (TString* line) {
+            return reader->ReadLine(line);
+        };
+
+        // lines are read in the background and parsed in parallel block by block
+        TAsyncRowProcessor<TString> rowProcessor(localExecutor, BlockSize, /*readAheadBlockCount*/ 2);
+        rowProcessor.ReadBlockAsync(readFunc);
+
+        TVector<TPair> pairs;
+        TVector<TPair> blockPairs;
+        TVector<ui8> isBlockPairInSubset; // not TVector<bool> because it is written concurrently
+        while (rowProcessor.ReadBlock(readFunc)) {
+            const size_t blockSize = rowProcessor.GetParseBufferSize();
+            const size_t blockStartLineNumber = rowProcessor.GetLinesProcessed();
+            blockPairs.yresize(blockSize);
+            isBlockPairInSubset.assign(blockSize, 0);
+            rowProcessor.ProcessBlock(
+                [&] (const TString& line, int lineIdx) {
+                    isBlockPairInSubset[lineIdx] = ParsePairsLine(
+                        line,
+                        blockStartLineNumber + lineIdx,
+                        docCount,
+                        loadSubset,
+                        &blockPairs[lineIdx]
                     );
                 }
-                if (pair.WinnerId < loadSubset.GetSize() && pair.LoserId < loadSubset.GetSize()) {
-                    pairs.push_back(std::move(pair));
-                } else {
-                    CB_ENSURE(
-                        pair.WinnerId >= loadSubset.GetSize() && pair.LoserId >= loadSubset.GetSize(),
-                        "Load subset " << loadSubset.Range << " must contain loser "
-                        << pair.LoserId + loadSubset.Range.Begin << " and winner " << pair.WinnerId + loadSubset.Range.Begin
-                    );
+            );
+            for (auto lineIdx : xrange(blockSize)) {
+                if (isBlockPairInSubset[lineIdx]) {
+                    pairs.push_back(blockPairs[lineIdx]);
                 }
-            } catch (const TCatBoostException& e) {
-                throw TCatBoostException() << "Incorrect file with pairs. Invalid line number #" << lineNumber
-                    << ": " << e.what();
             }
         }
+        rowProcessor.FinishAsyncProcessing();
 
         return pairs;
     }
@@ -269,10 +316,16 @@ namespace NCB {
 
 
 
-    void SetPairs(const TPathWithScheme& pairsPath, ui32 objectCount, TDatasetSubset loadSubset, IDatasetVisitor* visitor) {
+    void SetPairs(
+        const TPathWithScheme& pairsPath,
+        ui32 objectCount,
+        TDatasetSubset loadSubset,
+        NPar::TLocalExecutor* localExecutor,
+        IDatasetVisitor* visitor
+    ) {
         DumpMemUsage("After data read");
         if (pairsPath.Inited()) {
-            visitor->SetPairs(ReadPairs(pairsPath, objectCount, loadSubset));
+            visitor->SetPairs(ReadPairs(pairsPath, objectCount, loadSubset, localExecutor));
         }
     }
 
@@ -456,8 +509,64 @@ namespace NCB {
         }
     }
 
+    /* Exact parsing of plain decimals "[-]digits[.digits]" that are the vast majority of dsv values.
+     * Integers up to 2^53 are exact in double, so conversion to float rounds once, other values are parsed
+     * by Clinger's fast path: mantissa up to 2^24 and power of 10 up to 10^10 are exact in float, so one
+     * correctly rounded division gives the correctly rounded result.
+     * Returns false if value is not parsed, caller should fall back to the general parser.
+     */
+    static bool TryParsePlainDecimal(TStringBuf stringValue, float* value) {
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+        static constexpr float exactPowersOf10[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+        const char* ptr = stringValue.begin();
+        const char* const end = stringValue.end();
+        const bool negative = (ptr != end && *ptr == '-');
+        if (negative) {
+            ++ptr;
+        }
+        ui64 mantissa = 0;
+        int digitCount = 0;
+        const auto consumeDigits = [&] () {
+            const char* digitsStart = ptr;
+            for (; ptr != end && *ptr >= '0' && *ptr <= '9'; ++ptr) {
+                mantissa = mantissa * 10 + (*ptr - '0');
+                ++digitCount;
+            }
+            return int(ptr - digitsStart);
+        };
+        if (consumeDigits() == 0) {
+            return false;
+        }
+        int fractionDigitCount = 0;
+        if (ptr != end && *ptr == '.') {
+            ++ptr;
+            fractionDigitCount = consumeDigits();
+            if (fractionDigitCount == 0) {
+                return false;
+            }
+        }
+        if (ptr != end || digitCount > 19) { // 19 digits never overflow ui64
+            return false;
+        }
+        if (fractionDigitCount == 0 && mantissa <= (1ull << 53)) {
+            *value = static_cast<float>(static_cast<double>(mantissa));
+        } else if (mantissa <= (1ull << 24) && fractionDigitCount < (int)Y_ARRAY_SIZE(exactPowersOf10)) {
+            *value = static_cast<float>(mantissa) / exactPowersOf10[fractionDigitCount];
+        } else {
+            return false;
+        }
+        if (negative) {
+            *value = -*value;
+        }
+        return true;
+#else
+        Y_UNUSED(stringValue, value);
+        return false;
+#endif
+    }
+
     bool TryParseFloatFeatureValue(TStringBuf stringValue, float* value) {
-        if (!TryFromString<float>(stringValue, *value)) {
+        if (!TryParsePlainDecimal(stringValue, value) && !TryFromString<float>(stringValue, *value)) {
             if (IsMissingValue(stringValue)) {
                 *value = std::numeric_limits<float>::quiet_NaN();
             } else {
@@ -108,7 +108,13 @@ namespace NCB {
 
     struct IRawFeaturesOrderDatasetLoader : public IDatasetLoader {
         virtual EDatasetVisitorType GetVisitorType() const override {
-            return EDatasetVisitorType::RawObjectsOrder;
+            return EDatasetVisitorType::RawFeaturesOrder;
+        }
+
+        void DoIfCompatible(IDatasetVisitor* visitor) override {
+            auto compatibleVisitor = dynamic_cast<IRawFeaturesOrderDataVisitor*>(visitor);
+            CB_ENSURE_INTERNAL(compatibleVisitor, "visitor is incompatible with dataset loader");
+            Do(compatibleVisitor);
         }
 
         // Process all data
@@ -165,7 +171,13 @@ namespace NCB {
      * Indices of objects passed to visitor methods are indices from the beginning of the subset (not indices in the whole dataset).
      * objectCount parameter represents the number of objects in the subset.
      */
-    void SetPairs(const TPathWithScheme& pairsPath, ui32 objectCount, TDatasetSubset loadSubset, IDatasetVisitor* visitor);
+    void SetPairs(
+        const TPathWithScheme& pairsPath,
+        ui32 objectCount,
+        TDatasetSubset loadSubset,
+        NPar::TLocalExecutor* localExecutor, // pairs file lines are parsed in parallel
+        IDatasetVisitor* visitor
+    );
     void SetGroupWeights(
         const TPathWithScheme& groupWeightsPath,
         ui32 objectCount,
@@ -217,8 +229,8 @@ namespace NCB {
     public:
         explicit TAsyncProcDataLoaderBase(TDatasetLoaderCommonArgs&& args)
             : Args(std::move(args))
-            , AsyncRowProcessor(Args.LocalExecutor, Args.BlockSize)
-            , AsyncBaselineRowProcessor(Args.LocalExecutor, Args.BlockSize)
+            , AsyncRowProcessor(Args.LocalExecutor, Args.BlockSize, /*readAheadBlockCount*/ 2)
+            , AsyncBaselineRowProcessor(Args.LocalExecutor, Args.BlockSize, /*readAheadBlockCount*/ 2)
         {}
 
     protected:
@@ -267,7 +279,7 @@ namespace NCB {
             if (!inBlock) {
                 const ui32 objectCount = GetObjectCountSynchronized();
                 SetGroupWeights(Args.GroupWeightsFilePath, objectCount, Args.DatasetSubset, visitor);
-                SetPairs(Args.PairsFilePath, objectCount, Args.DatasetSubset, visitor);
+                SetPairs(Args.PairsFilePath, objectCount, Args.DatasetSubset, Args.LocalExecutor, visitor);
                 SetTimestamps(Args.TimestampsFilePath, objectCount, Args.DatasetSubset, visitor);
             }
             visitor->Finish();
@@ -12,11 +12,13 @@
 #include <catboost/libs/helpers/double_array_iterator.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/mem_usage.h>
+#include <catboost/libs/helpers/parallel_sort/parallel_sort.h>
 #include <catboost/libs/helpers/parallel_tasks.h>
 #include <catboost/libs/helpers/sample.h>
 #include <catboost/libs/helpers/resource_constrained_executor.h>
 #include <catboost/libs/logging/logging.h>
 #include <catboost/private/libs/labels/label_converter.h>
+#include <catboost/private/libs/options/enum_helpers.h>
 #include <catboost/private/libs/options/plain_options_helper.h>
 #include <catboost/private/libs/options/system_options.h>
 #include <catboost/private/libs/text_processing/text_column_builder.h>
@@ -156,6 +158,10 @@ namespace NCB {
     }
 
 
+    // smaller samples are sorted faster than parallel sort tasks are scheduled
+    constexpr size_t MIN_SAMPLE_SIZE_FOR_PARALLEL_SORT = 50000;
+
+
     static ui64 EstimateMemUsageForFloatFeature(
         const TFloatValuesHolder& srcFeature,
         const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
@@ -206,6 +212,9 @@ namespace NCB {
             }
 
             result += sizeof(float) * nonDefaultSampleSize; // for copying to srcFeatureValuesForBuildBorders
+            if (nonDefaultSampleSize >= MIN_SAMPLE_SIZE_FOR_PARALLEL_SORT) {
+                result += sizeof(float) * nonDefaultSampleSize; // for ParallelRadixSort buffer
+            }
 
             const auto& floatFeatureBinarizationSettings
                 = quantizedFeaturesInfo.GetFloatFeatureBinarization(srcFeature.GetId());
@@ -238,6 +247,7 @@ namespace NCB {
         const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
         const TMaybe<TVector<float>>& initialBorders,
         TMaybe<float> quantizedDefaultBinFraction,
+        NPar::TLocalExecutor* localExecutor,
         ENanMode* nanMode,
         NSplitSelection::TQuantization* quantization
     ) {
@@ -328,6 +338,21 @@ namespace NCB {
         }
 
         if (nonNanValuesBorderCount > 0) {
+            /* Sorting is the most expensive part of BestSplit for big samples. Features are processed
+             * in parallel by TResourceConstrainedExecutor but a few big features become stragglers,
+             * so sort them here using executor threads that are idle by that time.
+             */
+            if ((featureValues.Values.size() >= MIN_SAMPLE_SIZE_FOR_PARALLEL_SORT)
+                && (localExecutor->GetThreadCount() > 0))
+            {
+                ParallelRadixSort(
+                    [] (float value) { return value; },
+                    &featureValues.Values,
+                    localExecutor
+                );
+                featureValues.ValuesSorted = true;
+            }
+
             *quantization = NSplitSelection::BestSplit(
                 std::move(featureValues),
                 /*featureValuesMayContainNans*/ false,
@@ -1792,6 +1817,7 @@ namespace NCB {
                 *quantizedFeaturesInfo,
                 initialBordersForFeature,
                 options.DefaultValueFractionToEnableSparseStorage,
+                localExecutor,
                 &nanMode,
                 &calculatedQuantization
             );
@@ -1914,7 +1940,8 @@ namespace NCB {
                 /*mapMostFrequentValueTo0*/ bundleExclusiveFeatures,
                 srcDefaultValue,
                 options.DefaultValueFractionToEnableSparseStorage,
-                quantizeDataAtFirstPass ? TMaybe<TArrayRef<ui32>*>(&quantizedDataValue) : Nothing()
+                quantizeDataAtFirstPass ? TMaybe<TArrayRef<ui32>*>(&quantizedDataValue) : Nothing(),
+                localExecutor
             );
         };
 
@@ -2600,17 +2627,21 @@ namespace NCB {
             quantizationOptions->ExclusiveFeaturesBundlingOptions.MaxConflictFraction
                 = params.ObliviousTreeOptions->SparseFeaturesConflictFraction.Get();
 
-            /* TODO(akhropov): Enable when sparse column scoring is supported
-
-            float defaultValueFractionToEnableSparseStorage
-                = params.DataProcessingOptions->DevDefaultValueFractionToEnableSparseStorage.Get();
-            if (defaultValueFractionToEnableSparseStorage > 0.0f) {
-                quantizationOptions.DefaultValueFractionToEnableSparseStorage
-                    = defaultValueFractionToEnableSparseStorage;
-                quantizationOptions.SparseArrayIndexingType
+            /* sparse columns are scored only for symmetric trees without leafwise and pairwise scoring,
+             * sparse storage is used only if requested explicitly because it changes borders selection
+             */
+            const auto& sparseStorageOption = params.DataProcessingOptions->DevDefaultValueFractionToEnableSparseStorage;
+            const bool useSparseStorage = sparseStorageOption.IsSet()
+                && (sparseStorageOption.Get() > 0.0f)
+                && (params.ObliviousTreeOptions->GrowPolicy == EGrowPolicy::SymmetricTree)
+                && !params.DataProcessingOptions->DevLeafwiseScoring.Get()
+                && !IsPairwiseScoring(params.LossFunctionDescription->GetLossFunction());
+
+            if (useSparseStorage) {
+                quantizationOptions->DefaultValueFractionToEnableSparseStorage = sparseStorageOption.Get();
+                quantizationOptions->SparseArrayIndexingType
                     = params.DataProcessingOptions->DevSparseArrayIndexingType.Get();
             }
-            */
         } else {
             Y_ASSERT(params.GetTaskType() == ETaskType::GPU);
 
@@ -0,0 +1,56 @@
+#include <catboost/libs/data/async_row_processor.h>
+
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(AsyncRowProcessor) {
+    Y_UNIT_TEST(TestReadAhead) {
+        for (auto threadCount : {0, 1, 3}) {
+            NPar::TLocalExecutor localExecutor;
+            localExecutor.RunAdditionalThreads(threadCount);
+
+            for (auto readAheadBlockCount : {1, 2, 4}) {
+                for (auto lineCount : {0, 1, 7, 21, 50}) {
+                    const int blockSize = 7;
+
+                    int nextLine = 0;
+                    auto readFunc = [&nextLine, lineCount] (int* line) {
+                        if (nextLine == lineCount) {
+                            return false;
+                        }
+                        *line = nextLine++;
+                        return true;
+                    };
+
+                    TVector<int> processedLines;
+                    {
+                        TAsyncRowProcessor<int> processor(&localExecutor, blockSize, readAheadBlockCount);
+                        processor.ReadBlockAsync(readFunc);
+                        while (processor.ReadBlock(readFunc)) {
+                            const size_t blockOffset = processedLines.size();
+                            processedLines.resize(blockOffset + processor.GetParseBufferSize());
+                            processor.ProcessBlock([&] (int line, int lineIdx) {
+                                processedLines[blockOffset + lineIdx] = line;
+                            });
+                        }
+                        UNIT_ASSERT_VALUES_EQUAL(processor.GetLinesProcessed(), (size_t)lineCount);
+                    }
+
+                    TVector<int> expectedLines(lineCount);
+                    for (auto i : xrange(lineCount)) {
+                        expectedLines[i] = i;
+                    }
+                    UNIT_ASSERT_VALUES_EQUAL(processedLines, expectedLines);
+                }
+            }
+        }
+    }
+}
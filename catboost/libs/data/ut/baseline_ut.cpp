@@ -0,0 +1,62 @@
+#include <catboost/libs/data/baseline.h>
+
+#include <library/cpp/json/json_value.h>
+
+#include <util/generic/xrange.h>
+#include <util/stream/file.h>
+#include <util/system/mktemp.h>
+#include <util/system/tempfile.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(Baseline) {
+    Y_UNIT_TEST(TestBinaryBaselineReadWrite) {
+        const TVector<TVector<double>> baseline = {
+            {0.1, -2.0, 3.5, 0.0},
+            {1.0, 0.25, -0.75, 12.0},
+            {-5.5, 7.0, 0.125, 1.5}
+        };
+        const TVector<TString> classNames = {"a", "b", "c"};
+
+        TTempFile baselineFile(MakeTempName());
+        {
+            TOFStream out(baselineFile.Name());
+            SaveBinaryBaseline(baseline, classNames, &out);
+        }
+
+        const TPathWithScheme baselinePath(TString::Join(BinaryBaselineScheme, "://", baselineFile.Name()));
+
+        TVector<NJson::TJsonValue> classLabels;
+        UpdateClassLabelsFromBaselineFile(baselinePath, &classLabels);
+        UNIT_ASSERT_VALUES_EQUAL(classLabels.size(), classNames.size());
+
+        TBaselineReader reader(baselinePath, classNames);
+        UNIT_ASSERT(reader.Inited());
+        UNIT_ASSERT_VALUES_EQUAL(*reader.GetBaselineCount(), 3);
+
+        TVector<TVector<float>> readBaseline(3);
+        TString line;
+        for (ui32 lineIdx = 0; reader.ReadLine(&line); ++lineIdx) {
+            reader.Parse(
+                [&] (ui32 baselineIdx, float value) {
+                    readBaseline[baselineIdx].push_back(value);
+                },
+                line,
+                lineIdx
+            );
+        }
+
+        for (auto baselineIdx : xrange(baseline.size())) {
+            UNIT_ASSERT_VALUES_EQUAL(readBaseline[baselineIdx].size(), baseline[baselineIdx].size());
+            for (auto objectIdx : xrange(baseline[baselineIdx].size())) {
+                UNIT_ASSERT_VALUES_EQUAL(readBaseline[baselineIdx][objectIdx], (float)baseline[baselineIdx][objectIdx]);
+            }
+        }
+
+        UNIT_ASSERT_EXCEPTION(TBaselineReader(baselinePath, {"a", "b", "d"}), TCatBoostException);
+    }
+}
@@ -0,0 +1,75 @@
+#include <catboost/libs/data/cat_feature_perfect_hash_helper.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/generic/hash.h>
+#include <util/generic/map.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ylimits.h>
+#include <util/random/fast.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(CatFeaturesPerfectHashHelper) {
+    Y_UNIT_TEST(TestBinsInFirstOccurrenceOrder) {
+        // big enough to be processed by several blocks
+        const ui32 objectCount = 300000;
+
+        TFastRng<ui64> rng(0);
+        TVector<ui32> hashedCatValues;
+        for (auto i : xrange(objectCount)) {
+            Y_UNUSED(i);
+            // Max<ui32>() is checked because it is a special value for the implementation
+            hashedCatValues.push_back(rng.Uniform(20) ? ui32(rng.Uniform(50000)) * 85229 : Max<ui32>());
+        }
+
+        THashMap<ui32, ui32> expectedBins;
+        TMap<ui32, TValueWithCount> expectedMap;
+        TVector<ui32> expectedDstBins;
+        for (auto hashedCatValue : hashedCatValues) {
+            auto it = expectedBins.find(hashedCatValue);
+            if (it == expectedBins.end()) {
+                it = expectedBins.emplace(hashedCatValue, (ui32)expectedBins.size()).first;
+            }
+            expectedDstBins.push_back(it->second);
+            auto& valueWithCount = expectedMap[hashedCatValue];
+            valueWithCount.Value = it->second;
+            ++valueWithCount.Count;
+        }
+
+        auto hashedArrayNonOwningHolder = TMaybeOwningConstArrayHolder<ui32>::CreateNonOwning(hashedCatValues);
+        NCB::TArraySubsetIndexing<ui32> subsetIndexing(NCB::TFullSubset<ui32>{objectCount});
+        TTypeCastArraySubset<ui32, ui32> arraySubset(hashedArrayNonOwningHolder, &subsetIndexing);
+
+        TFeaturesLayout featuresLayout(ui32(1), TVector<ui32>{0}, TVector<ui32>{}, TVector<TString>{});
+        auto quantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
+            featuresLayout,
+            TConstArrayRef<ui32>(),
+            NCatboostOptions::TBinarizationOptions()
+        );
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        TVector<ui32> dstBins(objectCount);
+        TArrayRef<ui32> dstBinsRef = dstBins;
+
+        TCatFeaturesPerfectHashHelper catFeaturesPerfectHashHelper(quantizedFeaturesInfo);
+        catFeaturesPerfectHashHelper.UpdatePerfectHashAndMaybeQuantize(
+            TCatFeatureIdx(0),
+            arraySubset,
+            /*mapMostFrequentValueTo0*/ false,
+            /*hashedCatDefaultValue*/ Nothing(),
+            /*quantizedDefaultBinFraction*/ Nothing(),
+            &dstBinsRef,
+            &localExecutor
+        );
+
+        const auto& perfectHash = quantizedFeaturesInfo->GetCategoricalFeaturesPerfectHash(TCatFeatureIdx(0));
+        UNIT_ASSERT(!perfectHash.DefaultMap);
+        UNIT_ASSERT_EQUAL(perfectHash.Map, expectedMap);
+        UNIT_ASSERT_EQUAL(dstBins, expectedDstBins);
+    }
+}
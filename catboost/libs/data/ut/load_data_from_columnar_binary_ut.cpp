@@ -0,0 +1,172 @@
+#include <catboost/libs/data/ut/lib/for_loader.h>
+
+#include <catboost/libs/data/columnar_binary_loader.h>
+#include <catboost/libs/data/load_data.h>
+
+#include <util/generic/string.h>
+#include <util/generic/xrange.h>
+#include <util/stream/str.h>
+#include <util/system/tempfile.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+
+using namespace NCB;
+using namespace NCB::NDataNewUT;
+
+
+template <class T>
+static TConstArrayRef<ui8> AsBytes(const TVector<T>& values) {
+    return TConstArrayRef<ui8>(reinterpret_cast<const ui8*>(values.data()), values.size() * sizeof(T));
+}
+
+
+Y_UNIT_TEST_SUITE(LoadDataFromColumnarBinary) {
+    Y_UNIT_TEST(ReadDataset) {
+        const TVector<float> target = {0.0f, 1.0f, 0.0f};
+        const TVector<ui64> auxiliary = {7, 8, 9};
+        const TVector<float> weights = {0.5f, 1.0f, 2.0f};
+        const TVector<float> feat0 = {0.1f, 0.97f, 0.13f};
+        const TVector<float> feat1 = {0.2f, 0.82f, 0.22f};
+
+        TString poolData;
+        {
+            TStringOutput output(poolData);
+            SaveColumnarBinaryPool(
+                /*objectCount*/ 3,
+                {
+                    TColumnarBinaryColumn{"Target", EColumnarValueType::Float32, AsBytes(target)},
+                    TColumnarBinaryColumn{"Aux", EColumnarValueType::UInt64, AsBytes(auxiliary)},
+                    TColumnarBinaryColumn{"Weight", EColumnarValueType::Float32, AsBytes(weights)},
+                    TColumnarBinaryColumn{"Feat0", EColumnarValueType::Float32, AsBytes(feat0)},
+                    TColumnarBinaryColumn{"Feat1", EColumnarValueType::Float32, AsBytes(feat1)}
+                },
+                &output
+            );
+        }
+
+        TReadDatasetTestCase testCase;
+        TSrcData srcData;
+        srcData.Scheme = "cbcolumnar";
+        srcData.CdFileData = AsStringBuf(
+            "0\tTarget\n"
+            "1\tAuxiliary\n"
+            "2\tWeight\n"
+        );
+        srcData.DatasetFileData = poolData;
+        testCase.SrcData = std::move(srcData);
+
+
+        TExpectedRawData expectedData;
+
+        TDataColumnsMetaInfo dataColumnsMetaInfo;
+        dataColumnsMetaInfo.Columns = {
+            {EColumn::Label, ""},
+            {EColumn::Auxiliary, ""},
+            {EColumn::Weight, ""},
+            {EColumn::Num, ""},
+            {EColumn::Num, ""}
+        };
+
+        TVector<TString> featureId = {"Feat0", "Feat1"};
+
+        expectedData.MetaInfo = TDataMetaInfo(std::move(dataColumnsMetaInfo), ERawTargetType::Float, false, false, false, /* additionalBaselineCount */ Nothing(), &featureId);
+        expectedData.Objects.FloatFeatures = {feat0, feat1};
+
+        expectedData.ObjectsGrouping = TObjectsGrouping(3);
+        expectedData.Target.TargetType = ERawTargetType::Float;
+        TVector<TVector<TString>> rawTarget{{"0", "1", "0"}};
+        expectedData.Target.Target.assign(rawTarget.begin(), rawTarget.end());
+        expectedData.Target.Weights = TWeights<float>(TVector<float>(weights));
+        expectedData.Target.GroupWeights = TWeights<float>(3);
+
+        testCase.ExpectedData = std::move(expectedData);
+
+        TestReadDataset(testCase);
+    }
+
+    Y_UNIT_TEST(SaveRawDataProviderAndReadBack) {
+        TSrcData srcData;
+        srcData.CdFileData = AsStringBuf(
+            "0\tTarget\n"
+            "1\tWeight\n"
+        );
+        srcData.DatasetFileData = AsStringBuf(
+            "0\t0.5\t0.1\t0.2\n"
+            "1\t1.0\t0.97\t0.82\n"
+            "0\t2.0\t0.13\t0.22\n"
+        );
+
+        TReadDatasetMainParams readDatasetMainParams;
+        TVector<THolder<TTempFile>> srcDataFiles;
+        SaveSrcData(srcData, &readDatasetMainParams, &srcDataFiles);
+
+        NPar::TLocalExecutor localExecutor;
+
+        auto readDataset = [&] (
+            const TPathWithScheme& poolPath,
+            const NCatboostOptions::TColumnarPoolFormatParams& columnarPoolFormatParams
+        ) {
+            return ReadDataset(
+                /*taskType*/Nothing(),
+                poolPath,
+                TPathWithScheme(),
+                TPathWithScheme(),
+                TPathWithScheme(),
+                TPathWithScheme(),
+                TPathWithScheme(),
+                columnarPoolFormatParams,
+                /*ignoredFeatures*/ {},
+                EObjectsOrder::Undefined,
+                TDatasetSubset::MakeColumns(),
+                /*classLabels*/ Nothing(),
+                &localExecutor
+            );
+        };
+
+        TDataProviderPtr srcDataProvider = readDataset(
+            readDatasetMainParams.PoolPath,
+            readDatasetMainParams.ColumnarPoolFormatParams
+        );
+
+        TTempFile poolFile(MakeTempName());
+        TTempFile cdFile(MakeTempName());
+        SaveRawDataProviderAsColumnarBinaryPool(*srcDataProvider, poolFile.Name(), cdFile.Name(), &localExecutor);
+
+        NCatboostOptions::TColumnarPoolFormatParams columnarPoolFormatParams;
+        columnarPoolFormatParams.CdFilePath = TPathWithScheme(cdFile.Name(), "file");
+        TDataProviderPtr loadedDataProvider = readDataset(
+            TPathWithScheme(poolFile.Name(), "cbcolumnar"),
+            columnarPoolFormatParams
+        );
+
+        auto getTarget = [] (const TDataProvider& dataProvider) {
+            TVector<float> target(dataProvider.GetObjectCount());
+            TArrayRef<float> targetRef = target;
+            dataProvider.RawTargetData.GetNumericTarget(MakeArrayRef(&targetRef, 1));
+            return target;
+        };
+        auto getFloatFeature = [&] (const TDataProvider& dataProvider, ui32 featureIdx) {
+            const auto* rawObjectsData = dynamic_cast<const TRawObjectsDataProvider*>(
+                dataProvider.ObjectsData.Get()
+            );
+            UNIT_ASSERT(rawObjectsData);
+            return (*rawObjectsData->GetFloatFeature(featureIdx))->ExtractValues(&localExecutor);
+        };
+
+        UNIT_ASSERT_VALUES_EQUAL(loadedDataProvider->GetObjectCount(), 3);
+        UNIT_ASSERT_VALUES_EQUAL(getTarget(*loadedDataProvider), getTarget(*srcDataProvider));
+        UNIT_ASSERT_EQUAL(
+            loadedDataProvider->RawTargetData.GetWeights(),
+            srcDataProvider->RawTargetData.GetWeights()
+        );
+        for (auto featureIdx : xrange(2)) {
+            auto loadedValues = getFloatFeature(*loadedDataProvider, featureIdx);
+            auto srcValues = getFloatFeature(*srcDataProvider, featureIdx);
+            UNIT_ASSERT_VALUES_EQUAL(
+                TVector<float>(loadedValues.begin(), loadedValues.end()),
+                TVector<float>(srcValues.begin(), srcValues.end())
+            );
+        }
+    }
+}
@@ -879,7 +879,8 @@ Y_UNIT_TEST_SUITE(TQuantizedObjectsData) {
                             /*mapMostFrequentValueTo0*/ false,
                             /*hashedCatDefaultValue*/ Nothing(),
                             /*quantizedDefaultBinFraction*/ Nothing(),
-                            /*dstBins*/ Nothing()
+                            /*dstBins*/ Nothing(),
+                            &NPar::LocalExecutor()
                         );
 
                         ui32 bitsPerKey =
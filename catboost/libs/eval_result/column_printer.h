@@ -33,6 +33,10 @@ namespace NCB {
         virtual TString GetAfterColumnDelimiter() const {
             return "\t";
         }
+        // false if values have to be output sequentially (e.g. they are read from the pool file)
+        virtual bool CanOutputValuesInParallel() const {
+            return true;
+        }
         virtual ~IColumnPrinter() = default;
     };
 
@@ -138,6 +142,10 @@ namespace NCB {
             PrinterPtr->OutputColumnByIndex(outStream, DocIdOffset + docIndex, ColumnId);
         }
 
+        bool CanOutputValuesInParallel() const override {
+            return false;
+        }
+
         void OutputHeader(IOutputStream* outStream) override {
             *outStream << ColumnName;
         }
@@ -224,6 +232,10 @@ namespace NCB {
             PrinterPtr->OutputColumnByType(outStream, DocIdOffset + docIndex, ColumnType);
         }
 
+        bool CanOutputValuesInParallel() const override {
+            return false;
+        }
+
     private:
         TIntrusivePtr<IPoolColumnsPrinter> PrinterPtr;
         EColumn ColumnType;
@@ -255,6 +267,10 @@ namespace NCB {
             }
         }
 
+        bool CanOutputValuesInParallel() const override {
+            return NeedToGenerate;
+        }
+
     private:
         TIntrusivePtr<IPoolColumnsPrinter> PrinterPtr;
         bool NeedToGenerate;
@@ -5,9 +5,12 @@
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/logging/logging.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/hash_set.h>
+#include <util/generic/xrange.h>
 #include <util/stream/fwd.h>
 #include <util/string/builder.h>
+#include <util/stream/str.h>
 #include <util/string/cast.h>
 
 
@@ -319,15 +322,53 @@ namespace NCB {
             }
             *outputStream << Endl;
         }
-        for (ui32 docId = 0; docId < pool.ObjectsGrouping->GetObjectCount(); ++docId) {
-            TString delimiter = "";
-            for (auto& printer : columnPrinter) {
-                *outputStream << delimiter;
-                printer->OutputValue(outputStream, docId);
-                delimiter = printer->GetAfterColumnDelimiter();
+        OutputRows(columnPrinter, pool.ObjectsGrouping->GetObjectCount(), executor, outputStream);
+    }
+
+    static void OutputRows(
+        const TVector<THolder<IColumnPrinter>>& columnPrinter,
+        ui32 docCount,
+        NPar::TLocalExecutor* const executor,
+        IOutputStream* outputStream
+    ) {
+        TVector<TString> delimiters(columnPrinter.size());
+        for (auto idx : xrange<size_t>(1, columnPrinter.size())) {
+            delimiters[idx] = columnPrinter[idx - 1]->GetAfterColumnDelimiter();
+        }
+        const auto outputRows = [&] (ui32 begin, ui32 end, IOutputStream* out) {
+            for (ui32 docId = begin; docId < end; ++docId) {
+                for (auto idx : xrange(columnPrinter.size())) {
+                    *out << delimiters[idx];
+                    columnPrinter[idx]->OutputValue(out, docId);
+                }
+                *out << '\n';
+            }
+        };
+
+        const bool canOutputInParallel = AllOf(
+            columnPrinter,
+            [] (const auto& printer) { return printer->CanOutputValuesInParallel(); }
+        );
+        const ui32 blockSize = 4096;
+        const ui32 blockCount = executor->GetThreadCount() + 1;
+        if (!canOutputInParallel || blockCount == 1 || docCount <= blockSize) {
+            outputRows(0, docCount, outputStream);
+        } else {
+            // rows are formatted into per-block buffers in parallel, buffers are written in order
+            TVector<TStringStream> blockOutputs(blockCount);
+            for (ui32 chunkBegin = 0; chunkBegin < docCount; chunkBegin += blockSize * blockCount) {
+                NPar::ParallelFor(*executor, 0, blockCount, [&] (ui32 blockIdx) {
+                    const ui32 begin = Min(chunkBegin + blockIdx * blockSize, docCount);
+                    const ui32 end = Min(begin + blockSize, docCount);
+                    blockOutputs[blockIdx].Clear();
+                    outputRows(begin, end, &blockOutputs[blockIdx]);
+                });
+                for (const auto& blockOutput : blockOutputs) {
+                    outputStream->Write(blockOutput.Data(), blockOutput.Size());
+                }
             }
-            *outputStream << Endl;
         }
+        outputStream->Flush();
     }
 
     void OutputEvalResultToFile(
@@ -220,13 +220,15 @@ static TVector<std::pair<double, TFeature>> CalcFeatureEffectAverageChange(
         }
         effect = CalcEffect(
             trees,
-            mxTreeWeightsPresentation
+            mxTreeWeightsPresentation,
+            localExecutor
         );
     } else {
         effect = CalcEffectForNonObliviousModel(
             model,
             featureToIdx,
-            weights
+            weights,
+            localExecutor
         );
     }
 
@@ -323,6 +325,15 @@ static TVector<std::pair<double, TFeature>> CalcFeatureEffectLossChange(
     THolder<IMetric> metric = std::move(CreateMetricFromDescription(metricDescription, approxDimension)[0]);
     CB_ENSURE(metric->IsAdditiveMetric(), "LossFunctionChange support only additive metric");
 
+    const auto target = targetData->GetOneDimensionalTarget().GetOrElse(TConstArrayRef<float>());
+    const auto weights = GetWeights(*targetData);
+
+    // features are evaluated in parallel, each feature block removes its features' SHAP values from
+    // a private copy of approx and evaluates the metric in its own thread
+    NPar::TLocalExecutor::TExecRangeParams featureBlockParams(0, featuresCount);
+    featureBlockParams.SetBlockCount(Min(featuresCount, localExecutor->GetThreadCount() + 1));
+    TVector<TVector<TVector<double>>> featureBlocksApprox(featureBlockParams.GetBlockCount(), approx);
+
     TProfileInfo profile(documentCount);
     TImportanceLogger importanceLogger(documentCount, "Process documents", "Started LossFunctionChange calculation", 1);
     for (ui32 queryBegin = 0; queryBegin < blockCount; queryBegin += blockSize) {
@@ -349,7 +360,7 @@ static TVector<std::pair<double, TFeature>> CalcFeatureEffectLossChange(
             );
         }
         scores.back().Add(
-            metric->Eval(approx, targetData->GetOneDimensionalTarget().GetOrElse(TConstArrayRef<float>()), GetWeights(*targetData), queriesInfo, queryBegin, queryEnd, *localExecutor)
+            metric->Eval(approx, target, weights, queriesInfo, queryBegin, queryEnd, *localExecutor)
         );
         TVector<TVector<TVector<double>>> shapValues;
         CalcShapValuesInternalForFeature(
@@ -364,24 +375,32 @@ static TVector<std::pair<double, TFeature>> CalcFeatureEffectLossChange(
             localExecutor,
             calcType);
 
-        for (int featureIdx = 0; featureIdx < featuresCount; ++featureIdx) {
-            NPar::TLocalExecutor::TExecRangeParams blockParams(begin, end);
-            blockParams.SetBlockCountToThreadCount();
-            localExecutor->ExecRange([&](ui32 docIdx) {
-                for (int dimensionIdx = 0; dimensionIdx < approxDimension; ++dimensionIdx) {
-                    approx[dimensionIdx][docIdx] -= shapValues[docIdx - begin][featureIdx][dimensionIdx];
-                }
-            }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
-            scores[featureIdx].Add(
-                    metric->Eval(approx, targetData->GetOneDimensionalTarget().GetOrElse(TConstArrayRef<float>()), GetWeights(*targetData), queriesInfo, queryBegin, queryEnd,
-                                 *localExecutor)
-            );
-            localExecutor->ExecRange([&](ui32 docIdx) {
-                for (int dimensionIdx = 0; dimensionIdx < approxDimension; ++dimensionIdx) {
-                    approx[dimensionIdx][docIdx] += shapValues[docIdx - begin][featureIdx][dimensionIdx];
+        localExecutor->ExecRangeWithThrow(
+            [&] (int featureBlockIdx) {
+                auto& featureBlockApprox = featureBlocksApprox[featureBlockIdx];
+                NPar::TLocalExecutor sequentialExecutor;
+                const int featureBlockBegin = featureBlockIdx * featureBlockParams.GetBlockSize();
+                const int featureBlockEnd = Min(featureBlockBegin + featureBlockParams.GetBlockSize(), featuresCount);
+                for (int featureIdx : xrange(featureBlockBegin, featureBlockEnd)) {
+                    for (int dimensionIdx = 0; dimensionIdx < approxDimension; ++dimensionIdx) {
+                        for (ui32 docIdx : xrange(begin, end)) {
+                            featureBlockApprox[dimensionIdx][docIdx] -= shapValues[docIdx - begin][featureIdx][dimensionIdx];
+                        }
+                    }
+                    scores[featureIdx].Add(
+                        metric->Eval(featureBlockApprox, target, weights, queriesInfo, queryBegin, queryEnd, sequentialExecutor)
+                    );
+                    for (int dimensionIdx = 0; dimensionIdx < approxDimension; ++dimensionIdx) {
+                        Copy(
+                            approx[dimensionIdx].begin() + begin,
+                            approx[dimensionIdx].begin() + end,
+                            featureBlockApprox[dimensionIdx].begin() + begin);
+                    }
                 }
-            }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
-        }
+            },
+            0,
+            featureBlockParams.GetBlockCount(),
+            NPar::TLocalExecutor::WAIT_COMPLETE);
         if (needYetiRankPairs) {
             for (ui32 queryIndex = queryBegin; queryIndex < queryEnd; ++queryIndex) {
                 queriesInfo[queryIndex].Competitors.clear();
@@ -544,7 +563,10 @@ TVector<double> CalcRegularFeatureEffect(
     return effect;
 }
 
-TVector<TInternalFeatureInteraction> CalcInternalFeatureInteraction(const TFullModel& model) {
+TVector<TInternalFeatureInteraction> CalcInternalFeatureInteraction(
+    const TFullModel& model,
+    NPar::TLocalExecutor* localExecutor)
+{
     if (model.GetTreeCount() == 0) {
         return TVector<TInternalFeatureInteraction>();
     }
@@ -557,11 +579,12 @@ TVector<TInternalFeatureInteraction> CalcInternalFeatureInteraction(const TFullM
 
     if(model.IsOblivious()) {
         TVector<TMxTree> trees = BuildTrees(featureToIdx, model);
-        pairwiseEffect = CalcMostInteractingFeatures(trees);
+        pairwiseEffect = CalcMostInteractingFeatures(trees, localExecutor);
     } else {
         pairwiseEffect = CalcMostInteractingFeatures(
             model,
-            featureToIdx
+            featureToIdx,
+            localExecutor
         );
     }
 
@@ -666,7 +689,7 @@ static TVector<TVector<double>> CalcFstr(
     return result;
 }
 
-TVector<TVector<double>> CalcInteraction(const TFullModel& model) {
+TVector<TVector<double>> CalcInteraction(const TFullModel& model, NPar::TLocalExecutor* localExecutor) {
     const TFeaturesLayout layout(
         TVector<TFloatFeature>(
             model.ModelTrees->GetFloatFeatures().begin(),
@@ -678,7 +701,7 @@ TVector<TVector<double>> CalcInteraction(const TFullModel& model) {
         )
     );
 
-    TVector<TInternalFeatureInteraction> internalInteraction = CalcInternalFeatureInteraction(model);
+    TVector<TInternalFeatureInteraction> internalInteraction = CalcInternalFeatureInteraction(model, localExecutor);
     TVector<TFeatureInteraction> interaction = CalcFeatureInteraction(internalInteraction, layout);
     TVector<TVector<double>> result;
     for (const auto& value : interaction){
@@ -734,11 +757,15 @@ TVector<TVector<double>> GetFeatureImportances(
 
             return CalcFstr(model, dataset, fstrType, &localExecutor, calcType);
         }
-        case EFstrType::Interaction:
+        case EFstrType::Interaction: {
             if (dataset) {
                 CATBOOST_NOTICE_LOG << "Dataset is provided, but not used, because importance values are cached in the model." << Endl;
             }
-            return CalcInteraction(model);
+            NPar::TLocalExecutor localExecutor;
+            localExecutor.RunAdditionalThreads(threadCount - 1);
+
+            return CalcInteraction(model, &localExecutor);
+        }
         case EFstrType::ShapValues: {
             CB_ENSURE(dataset, "Dataset is not provided");
 
@@ -787,6 +814,34 @@ TVector<TVector<TVector<double>>> GetFeatureImportancesMulti(
                                calcType, modelOutputType);
 }
 
+void GetFeatureImportancesMulti(
+    const EFstrType fstrType,
+    const TFullModel& model,
+    const TDataProviderPtr dataset,
+    const TDataProviderPtr referenceDataset, // can be nullptr
+    int threadCount,
+    EPreCalcShapValues mode,
+    TArrayRef<double> result,
+    int logPeriod,
+    ECalcTypeShapValues calcType,
+    EExplainableModelOutput modelOutputType
+) {
+    TSetLoggingVerboseOrSilent inThisScope(logPeriod);
+    CB_ENSURE(model.GetTreeCount(), "Model is not trained");
+
+    CB_ENSURE(fstrType == EFstrType::ShapValues,
+            "Only shap values can provide multi approxes.");
+
+    CB_ENSURE(dataset, "Dataset is not provided");
+    CheckModelAndDatasetCompatibility(model, *dataset->ObjectsData.Get());
+
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(threadCount - 1);
+
+    CalcShapValuesMulti(model, *dataset, referenceDataset, /*fixedFeatureParams*/ Nothing(), logPeriod, mode, &localExecutor,
+                        result, calcType, modelOutputType);
+}
+
 TVector<TVector<TVector<TVector<double>>>> CalcShapFeatureInteractionMulti(
     const EFstrType fstrType,
     const TFullModel& model,
@@ -809,6 +864,48 @@ TVector<TVector<TVector<TVector<double>>>> CalcShapFeatureInteractionMulti(
     return CalcShapInteractionValuesMulti(model, *dataset, pairOfFeatures, logPeriod, mode, &localExecutor, calcType);
 }
 
+std::pair<TVector<std::pair<int, int>>, TVector<TVector<TVector<TVector<TVector<double>>>>>>
+CalcShapFeatureInteractionForTopPairs(
+    const TFullModel& model,
+    const NCB::TDataProviderPtr dataset,
+    size_t topPairsCount,
+    int threadCount,
+    EPreCalcShapValues mode,
+    int logPeriod,
+    ECalcTypeShapValues calcType
+) {
+    ValidateFeatureInteractionParams(EFstrType::ShapInteractionValues, model, dataset, calcType);
+    CB_ENSURE(topPairsCount > 0, "Number of feature pairs should be positive");
+
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(threadCount - 1);
+
+    // sorted by decreasing score
+    const TVector<TVector<double>> interaction = CalcInteraction(model, &localExecutor);
+    TVector<std::pair<int, int>> pairsOfFeatures;
+    for (const auto& value : interaction) {
+        if (pairsOfFeatures.size() == topPairsCount) {
+            break;
+        }
+        pairsOfFeatures.emplace_back(static_cast<int>(value[0]), static_cast<int>(value[1]));
+    }
+    const int flatFeatureCount = SafeIntegerCast<int>(dataset->MetaInfo.GetFeatureCount());
+    for (const auto& pairOfFeatures : pairsOfFeatures) {
+        ValidateFeaturePair(flatFeatureCount, pairOfFeatures);
+    }
+
+    auto shapInteractionValues = CalcShapInteractionValuesForPairs(
+        model,
+        *dataset,
+        pairsOfFeatures,
+        logPeriod,
+        mode,
+        &localExecutor,
+        calcType
+    );
+    return {std::move(pairsOfFeatures), std::move(shapInteractionValues)};
+}
+
 TVector<TString> GetMaybeGeneratedModelFeatureIds(const TFullModel& model, const TDataProviderPtr dataset) {
     const NCB::TFeaturesLayout modelFeaturesLayout(
         TVector<TFloatFeature>(
@@ -12,6 +12,7 @@
 #include <library/cpp/threading/local_executor/local_executor.h>
 
 #include <util/digest/multi.h>
+#include <util/generic/array_ref.h>
 #include <util/system/yassert.h>
 
 #include <utility>
@@ -89,12 +90,14 @@ TVector<double> CalcRegularFeatureEffect(
     ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular
 );
 
-TVector<TInternalFeatureInteraction> CalcInternalFeatureInteraction(const TFullModel& model);
+TVector<TInternalFeatureInteraction> CalcInternalFeatureInteraction(
+    const TFullModel& model,
+    NPar::TLocalExecutor* localExecutor);
 TVector<TFeatureInteraction> CalcFeatureInteraction(
     const TVector<TInternalFeatureInteraction>& internalFeatureInteraction,
     const NCB::TFeaturesLayout& layout);
 
-TVector<TVector<double>> CalcInteraction(const TFullModel& model);
+TVector<TVector<double>> CalcInteraction(const TFullModel& model, NPar::TLocalExecutor* localExecutor);
 TVector<TVector<double>> GetFeatureImportances(
     const EFstrType type,
     const TFullModel& model,
@@ -119,6 +122,20 @@ TVector<TVector<TVector<double>>> GetFeatureImportancesMulti(
     EExplainableModelOutput modelOutputType = EExplainableModelOutput::Raw
 );
 
+// writes ShapValues to a contiguous buffer, see CalcShapValuesMulti for the layout
+void GetFeatureImportancesMulti(
+    const EFstrType type,
+    const TFullModel& model,
+    const NCB::TDataProviderPtr dataset,
+    const NCB::TDataProviderPtr referenceDataset, // can be nullptr
+    int threadCount,
+    EPreCalcShapValues mode,
+    TArrayRef<double> result,
+    int logPeriod = 0,
+    ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular,
+    EExplainableModelOutput modelOutputType = EExplainableModelOutput::Raw
+);
+
 TVector<TVector<TVector<TVector<double>>>> CalcShapFeatureInteractionMulti(
     const EFstrType fstrType,
     const TFullModel& model,
@@ -130,6 +147,19 @@ TVector<TVector<TVector<TVector<double>>>> CalcShapFeatureInteractionMulti(
     ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular
 );
 
+// ShapInteractionValues only for the topPairsCount most interacting feature pairs by CalcInteraction,
+// returned: pairs of flat feature indices and for each pair values as for CalcShapFeatureInteractionMulti with this pair
+std::pair<TVector<std::pair<int, int>>, TVector<TVector<TVector<TVector<TVector<double>>>>>>
+CalcShapFeatureInteractionForTopPairs(
+    const TFullModel& model,
+    const NCB::TDataProviderPtr dataset,
+    size_t topPairsCount,
+    int threadCount,
+    EPreCalcShapValues mode,
+    int logPeriod = 0,
+    ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular
+);
+
 /*
  * model is the primary source of featureIds,
  * if model does not contain featureIds data then try to get this data from pool (if provided (non nullptr))
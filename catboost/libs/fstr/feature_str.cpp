@@ -63,6 +63,16 @@ int GetMaxSrcFeature(const TVector<TMxTree>& trees) {
     return res;
 }
 
+TVector<double> SumTreeBlocks(const TVector<TVector<double>>& blockAccumulators, int featureCount) {
+    TVector<double> res(featureCount, 0);
+    for (const auto& blockRes : blockAccumulators) {
+        for (int featureIdx = 0; featureIdx < featureCount; ++featureIdx) {
+            res[featureIdx] += blockRes[featureIdx];
+        }
+    }
+    return res;
+}
+
 void ConvertToPercents(TVector<double>& res) {
     double total = Accumulate(res.begin(), res.end(), 0.0);
     for (auto& x : res) {
@@ -146,22 +156,40 @@ TVector<double> CalculateEffectToInfoRate(const TVector<double>& effect,
     return featuresEfficiency;
 }
 
+using TPairInteractions = THashMap<std::pair<int, int>, double>;
+
+static TPairInteractions SumPairInteractionBlocks(TVector<TPairInteractions>&& blockSumInteractions) {
+    if (blockSumInteractions.empty()) {
+        return {};
+    }
+    TPairInteractions sumInteractions = std::move(blockSumInteractions[0]);
+    for (auto blockIdx : xrange<size_t>(1, blockSumInteractions.size())) {
+        for (const auto& pairInteraction : blockSumInteractions[blockIdx]) {
+            sumInteractions[pairInteraction.first] += pairInteraction.second;
+        }
+        TPairInteractions().swap(blockSumInteractions[blockIdx]);
+    }
+    return sumInteractions;
+}
+
 static TVector<TFeaturePairInteractionInfo> PostProcessSumInteractions(
-    THashMap<std::pair<int, int>, double>& sumInteractions,
+    const TPairInteractions& sumInteractions,
     int featureCount,
     int topPairsCount) {
 
     TVector<TFeaturePairInteractionInfo> pairsInfo;
 
     if (topPairsCount == EXISTING_PAIRS_COUNT) {
+        pairsInfo.reserve(sumInteractions.size());
         for (const auto& pairInteraction : sumInteractions) {
-            pairsInfo.push_back(TFeaturePairInteractionInfo(sumInteractions[pairInteraction.first],
+            pairsInfo.push_back(TFeaturePairInteractionInfo(pairInteraction.second,
                                                             pairInteraction.first.first, pairInteraction.first.second));
         }
     } else {
         for (int firstIdx = 0; firstIdx < featureCount; ++firstIdx) {
             for (int secondIdx = firstIdx + 1; secondIdx < featureCount; ++secondIdx) {
-                pairsInfo.push_back(TFeaturePairInteractionInfo(sumInteractions[std::make_pair(firstIdx, secondIdx)],
+                const auto pairInteraction = sumInteractions.find(std::make_pair(firstIdx, secondIdx));
+                pairsInfo.push_back(TFeaturePairInteractionInfo(pairInteraction == sumInteractions.end() ? 0.0 : pairInteraction->second,
                                                                                    firstIdx, secondIdx));
             }
         }
@@ -176,12 +204,12 @@ static TVector<TFeaturePairInteractionInfo> PostProcessSumInteractions(
 }
 
 TVector<TFeaturePairInteractionInfo> CalcMostInteractingFeatures(const TVector<TMxTree>& trees,
+                                                                 NPar::TLocalExecutor* localExecutor,
                                                                  int topPairsCount) {
     int featureCount = GetMaxSrcFeature(trees) + 1;
-    THashMap<std::pair<int, int>, double> sumInteractions;
 
-    for (int i = 0; i < trees.ysize(); ++i) {
-        const TMxTree& tree = trees[i];
+    const auto processTree = [&] (int treeIdx, TPairInteractions* blockSumInteractions) {
+        const TMxTree& tree = trees[treeIdx];
         for (int firstIdx = 0; firstIdx < tree.SrcFeatures.ysize() - 1; ++firstIdx) {
             for (int secondIdx = firstIdx + 1; secondIdx < tree.SrcFeatures.ysize(); ++secondIdx) {
                 int n1 = 1 << firstIdx;
@@ -203,10 +231,12 @@ TVector<TFeaturePairInteractionInfo> CalcMostInteractingFeatures(const TVector<T
                 if (srcFeature1 == srcFeature2) {
                     continue;
                 }
-                sumInteractions[std::make_pair(srcFeature1, srcFeature2)] += fabs(delta);
+                (*blockSumInteractions)[std::make_pair(srcFeature1, srcFeature2)] += fabs(delta);
             }
         }
-    }
+    };
+    const TPairInteractions sumInteractions = SumPairInteractionBlocks(
+        ProcessTreesInBlocks(trees.ysize(), TPairInteractions(), processTree, localExecutor));
     return PostProcessSumInteractions(sumInteractions, featureCount, topPairsCount);
 }
 
@@ -260,25 +290,26 @@ static void DFS(const TFullModel& model, const THashMap<TFeature, int, TFeatureH
 
 TVector<TFeaturePairInteractionInfo> CalcMostInteractingFeatures(const TFullModel& model,
                                                                  const THashMap<TFeature, int, TFeatureHash>& featureToIdx,
+                                                                 NPar::TLocalExecutor* localExecutor,
                                                                  int topPairsCount) {
 
     CB_ENSURE_INTERNAL(!model.IsOblivious(),
         "CalcEffectForNonObliviousModel function got oblivious model, convert model to non oblivious");
 
-    THashMap<std::pair<int, int>, double> sumInteractions;
     const int featureCount = featureToIdx.size();
 
-    for (size_t treeIdx = 0; treeIdx < model.GetTreeCount(); ++treeIdx) {
-
+    const auto processTree = [&] (int treeIdx, TPairInteractions* blockSumInteractions) {
         const int treeIdxsStart = model.ModelTrees->GetTreeStartOffsets()[treeIdx];
 
         TVector<std::pair<int, int>> path;
         THashMap<std::pair<int, int>, double> treeSumInteractions;
         DFS(model, featureToIdx, treeIdxsStart, &path, &treeSumInteractions);
         for (const auto& pairInteraction : treeSumInteractions) {
-            sumInteractions[pairInteraction.first] += fabs(pairInteraction.second);
+            (*blockSumInteractions)[pairInteraction.first] += fabs(pairInteraction.second);
         }
-    }
+    };
+    const TPairInteractions sumInteractions = SumPairInteractionBlocks(
+        ProcessTreesInBlocks(model.GetTreeCount(), TPairInteractions(), processTree, localExecutor));
 
     return PostProcessSumInteractions(sumInteractions, featureCount, topPairsCount);
 }
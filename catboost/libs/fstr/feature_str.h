@@ -3,6 +3,8 @@
 #include <catboost/libs/model/model.h>
 #include <catboost/private/libs/algo/tree_print.h>
 
+#include <library/cpp/threading/local_executor/local_executor.h>
+
 #include <util/generic/vector.h>
 #include <util/generic/ymath.h>
 #include <util/system/types.h>
@@ -82,6 +84,43 @@ TFeature GetFeature(const TModelSplit& split);
 
 int GetMaxSrcFeature(const TVector<TMxTree>& trees);
 
+// the number of tree blocks doesn't depend on the thread count so that sums over trees are reproducible
+constexpr int FSTR_MAX_TREE_BLOCK_COUNT = 64;
+
+/*
+ * Calls processTree(treeIdx, &blockAccumulator) for trees [0, treeCount) in parallel,
+ * trees of one block are processed in order into the block's accumulator (initialized by emptyAccumulator)
+ */
+template <class TAccumulator, class TProcessTree>
+TVector<TAccumulator> ProcessTreesInBlocks(
+    int treeCount,
+    const TAccumulator& emptyAccumulator,
+    const TProcessTree& processTree,
+    NPar::TLocalExecutor* localExecutor) {
+
+    if (treeCount == 0) {
+        return {};
+    }
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, treeCount);
+    blockParams.SetBlockCount(Min(treeCount, FSTR_MAX_TREE_BLOCK_COUNT));
+    TVector<TAccumulator> blockAccumulators(blockParams.GetBlockCount(), emptyAccumulator);
+    localExecutor->ExecRangeWithThrow(
+        [&] (int blockIdx) {
+            const int blockBegin = blockIdx * blockParams.GetBlockSize();
+            const int blockEnd = Min(blockBegin + blockParams.GetBlockSize(), treeCount);
+            for (int treeIdx = blockBegin; treeIdx < blockEnd; ++treeIdx) {
+                processTree(treeIdx, &blockAccumulators[blockIdx]);
+            }
+        },
+        0,
+        blockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+    return blockAccumulators;
+}
+
+// sums per block accumulators of ProcessTreesInBlocks in block order
+TVector<double> SumTreeBlocks(const TVector<TVector<double>>& blockAccumulators, int featureCount);
+
 void ConvertToPercents(TVector<double>& res);
 
 TVector<double> CalcFeaturesInfo(
@@ -117,11 +156,13 @@ public:
 const int EXISTING_PAIRS_COUNT = -1;
 
 TVector<TFeaturePairInteractionInfo> CalcMostInteractingFeatures(const TVector<TMxTree>& trees,
+                                                                 NPar::TLocalExecutor* localExecutor,
                                                                  int topPairsCount = EXISTING_PAIRS_COUNT);
 
 
 TVector<TFeaturePairInteractionInfo> CalcMostInteractingFeatures(const TFullModel& model,
                                                                  const THashMap<TFeature, int, TFeatureHash>& featureToIdx,
+                                                                 NPar::TLocalExecutor* localExecutor,
                                                                  int topPairsCount = EXISTING_PAIRS_COUNT);
 
 
@@ -133,7 +174,8 @@ template <class T>
 TVector<double> CalcEffectForNonObliviousModel(
     const TFullModel& model,
     const THashMap<TFeature, int, TFeatureHash>& featureToIdx,
-    TConstArrayRef<T> weightedDocCountInLeaf) {
+    TConstArrayRef<T> weightedDocCountInLeaf,
+    NPar::TLocalExecutor* localExecutor) {
 
     CB_ENSURE_INTERNAL(!model.IsOblivious(), "CalcEffectForNonObliviousModel function got oblivious model");
 
@@ -141,9 +183,9 @@ TVector<double> CalcEffectForNonObliviousModel(
     const auto leafValues = model.ModelTrees->GetLeafValues();
     const int approxDimension = model.ModelTrees->GetDimensionsCount();
     const int featureCount = featureToIdx.size();
-    TVector<double> res(featureCount, 0);
 
-    for (size_t treeIdx = 0; treeIdx < model.GetTreeCount(); ++treeIdx) {
+    const auto processTree = [&] (int treeIdx, TVector<double>* blockRes) {
+        auto& res = *blockRes;
         TVector<TTriangleNodes> nodesStack;
 
         const int treeIdxsStart = model.ModelTrees->GetTreeStartOffsets()[treeIdx];
@@ -210,7 +252,10 @@ TVector<double> CalcEffectForNonObliviousModel(
             }
             nodeIdxToInfo[parentNodeIdx] = TNodeInfo{parentAvrg, sumCount};
         }
-    }
+    };
+    TVector<double> res = SumTreeBlocks(
+        ProcessTreesInBlocks(model.GetTreeCount(), TVector<double>(featureCount, 0), processTree, localExecutor),
+        featureCount);
     ConvertToPercents(res);
     return res;
 }
@@ -218,12 +263,13 @@ TVector<double> CalcEffectForNonObliviousModel(
 template <typename T>
 TVector<double> CalcEffect(
     const TVector<TMxTree>& trees,
-    const TVector<TConstArrayRef<T>>& weightedDocCountInLeaf) {
+    const TVector<TConstArrayRef<T>>& weightedDocCountInLeaf,
+    NPar::TLocalExecutor* localExecutor) {
 
     int featureCount = GetMaxSrcFeature(trees) + 1;
-    TVector<double> res(featureCount, 0);
 
-    for (int treeIdx = 0; treeIdx < trees.ysize(); treeIdx++) {
+    const auto processTree = [&] (int treeIdx, TVector<double>* blockRes) {
+        auto& res = *blockRes;
         const auto& tree = trees[treeIdx];
         for (int feature = 0; feature < tree.SrcFeatures.ysize(); feature++) {
             int srcIdx = tree.SrcFeatures[feature];
@@ -250,7 +296,10 @@ TVector<double> CalcEffect(
                 }
             }
         }
-    }
+    };
+    TVector<double> res = SumTreeBlocks(
+        ProcessTreesInBlocks(trees.ysize(), TVector<double>(featureCount, 0), processTree, localExecutor),
+        featureCount);
     ConvertToPercents(res);
     return res;
 }
@@ -258,7 +307,8 @@ TVector<double> CalcEffect(
 template <typename T>
 TVector<double> CalcEffect(
     const TVector<TMxTree>& trees,
-    const TVector<TVector<T>>& weightedDocCountInLeaf) {
+    const TVector<TVector<T>>& weightedDocCountInLeaf,
+    NPar::TLocalExecutor* localExecutor) {
 
     TVector<TConstArrayRef<T>> weightInLeafArrRef;
     for (const auto& treeWeights: weightedDocCountInLeaf) {
@@ -266,5 +316,5 @@ TVector<double> CalcEffect(
             treeWeights.begin(),
             treeWeights.size()));
     }
-    return CalcEffect(trees, weightInLeafArrRef);
+    return CalcEffect(trees, weightInLeafArrRef, localExecutor);
 }
@@ -219,6 +219,30 @@ void AddValuesToShapValuesByAllReferences(
     }
 }
 
+void AddValuesToShapValuesSumByReferences(
+    const TVector<TVector<TVector<double>>>& shapValueByDepthForLeaf,
+    const TVector<TVector<ui32>>& referenceIndicesByLeaf,
+    const TVector<int>& binFeatureCombinationClassByDepth,
+    TVector<TVector<double>>* shapValuesInternalSumByReferences
+) {
+    for (size_t leafIdx = 0; leafIdx < referenceIndicesByLeaf.size(); ++leafIdx) {
+        const double referenceCountInLeaf = referenceIndicesByLeaf[leafIdx].size();
+        if (referenceCountInLeaf == 0) {
+            continue;
+        }
+        const auto& shapValueByDepth = shapValueByDepthForLeaf[leafIdx];
+        for (size_t dimension = 0; dimension < shapValueByDepth.size(); ++dimension) {
+            TConstArrayRef<double> shapValueByDepthRef = MakeConstArrayRef(shapValueByDepth[dimension]);
+            TArrayRef<double> shapValuesSumRef = MakeArrayRef((*shapValuesInternalSumByReferences)[dimension]);
+            for (int depth = 0; depth < (int)shapValueByDepthRef.size() - 1; ++depth) {
+                shapValuesSumRef[binFeatureCombinationClassByDepth[depth]] += referenceCountInLeaf * shapValueByDepthRef[depth];
+            }
+            // add mean values
+            shapValuesSumRef.back() += referenceCountInLeaf * shapValueByDepthRef.back();
+        }
+    }
+}
+
 static inline ui64 GetBinomialCoeffient(ui64 n, ui64 k) { 
     ui64 binomialCoefficient = 1; 
     if (k > n - k) {
@@ -264,6 +288,9 @@ void CalcObliviousShapValuesByDepthForLeaf(
     const size_t classCount = combinationClassFeatures.size();
     for (size_t idx = 0; idx < leafCount; ++idx) {
         const size_t leafIdx = isCalcForAllLeafes ? idx : referenceLeafIndices[idx];
+        if (!isCalcForAllLeafes && !shapValueByDepthBetweenLeaves->at(leafIdx).empty()) {
+            continue; // several references in this leaf
+        }
         TVector<TVector<double>> shapValueInternalBetweenLeaves(depthOfTree + 1, TVector<double>(approxDimension, 0.0));
         TInternalIndependentTreeShapCalcer calcerIntenalShaps{
             forest,
@@ -487,6 +514,33 @@ void PostProcessingIndependent(
     }
 }
 
+void PostProcessingIndependentRawSum(
+    const TVector<TVector<double>>& shapValuesInternalSumByReferences,
+    const TVector<TVector<int>>& combinationClassFeatures,
+    size_t approxDimension,
+    size_t flatFeatureCount,
+    size_t referenceCount,
+    bool calcInternalValues,
+    double bias,
+    TVector<TVector<double>>* shapValues
+) {
+    const size_t featureCount = calcInternalValues ? combinationClassFeatures.size() : flatFeatureCount;
+    for (size_t dimension = 0; dimension < approxDimension; ++dimension) {
+        const TVector<double> shapValuesSum = calcInternalValues ?
+            shapValuesInternalSumByReferences[dimension] :
+            GetUnpackedShapValues(
+                shapValuesInternalSumByReferences[dimension],
+                combinationClassFeatures,
+                flatFeatureCount
+            );
+        TArrayRef<double> shapValuesRef = MakeArrayRef((*shapValues)[dimension]);
+        for (size_t featureIdx = 0; featureIdx < featureCount; ++featureIdx) {
+            shapValuesRef[featureIdx] += shapValuesSum[featureIdx] / referenceCount;
+        }
+        shapValuesRef[featureCount] += shapValuesSum.back() / referenceCount + bias;
+    }
+}
+
 static TVector<TVector<double>> CalcWeightsForIndependentTreeShap(const TFullModel& model) {
     const TModelTrees& forest = *model.ModelTrees;
     const auto treeSizes = forest.GetTreeSizes();
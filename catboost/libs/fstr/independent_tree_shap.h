@@ -18,6 +18,26 @@ void PostProcessingIndependent(
     TVector<TVector<double>>* shapValues  
 );
 
+// for Raw model output SHAP values are linear in the values for each reference,
+// so only their sum over all references is accumulated: [dim][classIdx], the last value is the mean value
+void PostProcessingIndependentRawSum(
+    const TVector<TVector<double>>& shapValuesInternalSumByReferences,
+    const TVector<TVector<int>>& combinationClassFeatures,
+    size_t approxDimension,
+    size_t flatFeatureCount,
+    size_t referenceCount,
+    bool calcInternalValues,
+    double bias,
+    TVector<TVector<double>>* shapValues
+);
+
+void AddValuesToShapValuesSumByReferences(
+    const TVector<TVector<TVector<double>>>& shapValueByDepthForLeaf,
+    const TVector<TVector<ui32>>& referenceIndicesByLeaf,
+    const TVector<int>& binFeatureCombinationClassByDepth,
+    TVector<TVector<double>>* shapValuesInternalSumByReferences
+);
+
 void AddValuesToShapValuesByAllReferences(
     const TVector<TVector<TVector<double>>>& shapValueByDepthForLeaf,
     const TVector<NCB::NModelEvaluation::TCalcerIndexType>& referenceLeafIndices,
@@ -140,6 +140,7 @@ inline void CalcAndOutputFstr(const TFullModel& model,
 
 inline void CalcAndOutputInteraction(
     const TFullModel& model,
+    NPar::TLocalExecutor* localExecutor,
     const TString* regularFstrPath,
     const TString* internalFstrPath)
 {
@@ -154,7 +155,7 @@ inline void CalcAndOutputInteraction(
         )
     );
 
-    TVector<TInternalFeatureInteraction> internalInteraction = CalcInternalFeatureInteraction(model);
+    TVector<TInternalFeatureInteraction> internalInteraction = CalcInternalFeatureInteraction(model, localExecutor);
     if (internalFstrPath != nullptr) {
         OutputInteraction(layout, internalInteraction, *internalFstrPath);
     }
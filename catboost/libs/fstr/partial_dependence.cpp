@@ -89,27 +89,38 @@ TVector<TVector<TFloatFeatureBucketRange>> CalculateBucketRangesAndWeightsOblivi
             }
         }
 
-        for (size_t leafIdx = 0; leafIdx < 1 << treeDepth; ++leafIdx) {
-            for (int mask = 0; mask < 1 << depthsToExplore.size(); ++mask) {
-                TVector<TFloatFeatureBucketRange> featureRanges = defaultRanges;
-
-                int newLeafIdx = leafIdx;
-                for (size_t splitIdx = 0; splitIdx < splitsToExplore.size(); ++splitIdx) {
-                    int depth = depthsToExplore[splitIdx];
-                    int decision = (mask >> splitIdx) & 1;
-                    newLeafIdx = (newLeafIdx & ~(1UL << depth)) | (decision << depth);
-                    const auto& split = binSplits[splitsToExplore[splitIdx]];
-                    for (auto& range: featureRanges) {
-                        if (range.FeatureIdx == split.FloatFeature.FloatFeature) {
-                            int borderIdx = borderIdxForSplit[splitsToExplore[splitIdx]];
-                            range.Update(borderIdx, decision);
-                        }
+        // ranges of a leaf depend only on its bits at depthsToExplore, so they are computed once per mask
+        TVector<TVector<TFloatFeatureBucketRange>> featureRangesByMask(1 << depthsToExplore.size(), defaultRanges);
+        size_t exploredBits = 0;
+        for (size_t splitIdx = 0; splitIdx < splitsToExplore.size(); ++splitIdx) {
+            exploredBits |= 1UL << depthsToExplore[splitIdx];
+        }
+        for (int mask = 0; mask < 1 << depthsToExplore.size(); ++mask) {
+            for (size_t splitIdx = 0; splitIdx < splitsToExplore.size(); ++splitIdx) {
+                int decision = (mask >> splitIdx) & 1;
+                const auto& split = binSplits[splitsToExplore[splitIdx]];
+                for (auto& range: featureRangesByMask[mask]) {
+                    if (range.FeatureIdx == split.FloatFeature.FloatFeature) {
+                        int borderIdx = borderIdxForSplit[splitsToExplore[splitIdx]];
+                        range.Update(borderIdx, decision);
                     }
                 }
-                leafBucketRanges[offset + newLeafIdx] = featureRanges;
-                (*leafWeightsNew)[offset + leafIdx] += leafWeights[offset + newLeafIdx];
             }
         }
+
+        // new weight of a leaf is the total weight of the leaves which differ from it only at depthsToExplore
+        TVector<double> weightByUnexploredBits(1 << treeDepth, 0.0);
+        for (size_t leafIdx = 0; leafIdx < 1 << treeDepth; ++leafIdx) {
+            weightByUnexploredBits[leafIdx & ~exploredBits] += leafWeights[offset + leafIdx];
+        }
+        for (size_t leafIdx = 0; leafIdx < 1 << treeDepth; ++leafIdx) {
+            int mask = 0;
+            for (size_t splitIdx = 0; splitIdx < splitsToExplore.size(); ++splitIdx) {
+                mask |= ((leafIdx >> depthsToExplore[splitIdx]) & 1) << splitIdx;
+            }
+            leafBucketRanges[offset + leafIdx] = featureRangesByMask[mask];
+            (*leafWeightsNew)[offset + leafIdx] += weightByUnexploredBits[leafIdx & ~exploredBits];
+        }
     }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
 
     return leafBucketRanges;
@@ -460,6 +460,8 @@ template <typename TStorageType>
 static void CalcShapInteraction(
     const TFullModel& model,
     const TDataProvider& dataset,
+    const TVector<TIntrusivePtr<NModelEvaluation::IQuantizedData>>& binarizedFeatures,
+    const TVector<TVector<NModelEvaluation::TCalcerIndexType>>& indexes,
     const TMaybe<std::pair<int, int>>& pairOfFeatures,
     int logPeriod,
     NPar::TLocalExecutor* localExecutor,
@@ -467,15 +469,6 @@ static void CalcShapInteraction(
     TInteractionValuesFull* shapInteractionValues,
     ECalcTypeShapValues calcType
 ) {
-    CheckNonZeroApproxForZeroWeightLeaf(model);
-    TVector<TIntrusivePtr<NModelEvaluation::IQuantizedData>> binarizedFeatures;
-    TVector<TVector<NModelEvaluation::TCalcerIndexType>> indexes;
-    CalcLeafIndices(
-        model,
-        dataset,
-        &binarizedFeatures,
-        &indexes
-    );
     TVector<size_t> classIndicesFirst;
     TVector<size_t> classIndicesSecond;
     ContructClassIndices(
@@ -554,6 +547,35 @@ static inline void SetSymmetricValues(TInteractionValuesFull* shapInteractionVal
     }
 }
 
+static void CalcShapInteractionForPair(
+    const TFullModel& model,
+    const TDataProvider& dataset,
+    const TVector<TIntrusivePtr<NModelEvaluation::IQuantizedData>>& binarizedFeatures,
+    const TVector<TVector<NModelEvaluation::TCalcerIndexType>>& indexes,
+    std::pair<int, int> pairOfFeatures,
+    int logPeriod,
+    NPar::TLocalExecutor* localExecutor,
+    TShapPreparedTrees* preparedTrees,
+    TInteractionValuesFull* shapInteractionValues,
+    ECalcTypeShapValues calcType
+) {
+    CalcShapInteraction<TInteractionValuesSubset>(
+        model,
+        dataset,
+        binarizedFeatures,
+        indexes,
+        pairOfFeatures,
+        logPeriod,
+        localExecutor,
+        preparedTrees,
+        shapInteractionValues,
+        calcType
+    );
+    if (pairOfFeatures.first != pairOfFeatures.second) {
+        SetSymmetricValues(shapInteractionValues);
+    }
+}
+
 TInteractionValuesFull CalcShapInteractionValuesMulti(
     const TFullModel& model,
     const TDataProvider& dataset,
@@ -572,25 +594,35 @@ TInteractionValuesFull CalcShapInteractionValuesMulti(
         /*calcInternalValues*/ true,
         calcType
     );
+    CheckNonZeroApproxForZeroWeightLeaf(model);
+    TVector<TIntrusivePtr<NModelEvaluation::IQuantizedData>> binarizedFeatures;
+    TVector<TVector<NModelEvaluation::TCalcerIndexType>> indexes;
+    CalcLeafIndices(
+        model,
+        dataset,
+        &binarizedFeatures,
+        &indexes
+    );
     TInteractionValuesFull shapInteractionValues;
     if (pairOfFeatures.Defined()) {
-        CalcShapInteraction<TInteractionValuesSubset>(
+        CalcShapInteractionForPair(
             model,
             dataset,
-            pairOfFeatures,
+            binarizedFeatures,
+            indexes,
+            *pairOfFeatures,
             logPeriod,
             localExecutor,
             &preparedTrees,
             &shapInteractionValues,
             calcType
         );
-        if (pairOfFeatures->first != pairOfFeatures->second) {
-            SetSymmetricValues(&shapInteractionValues);
-        }
     } else {
         CalcShapInteraction<TInteractionValuesFull>(
             model,
             dataset,
+            binarizedFeatures,
+            indexes,
             pairOfFeatures,
             logPeriod,
             localExecutor,
@@ -601,3 +633,51 @@ TInteractionValuesFull CalcShapInteractionValuesMulti(
     }
     return shapInteractionValues;
 }
+
+TVector<TInteractionValuesFull> CalcShapInteractionValuesForPairs(
+    const TFullModel& model,
+    const TDataProvider& dataset,
+    TConstArrayRef<std::pair<int, int>> pairsOfFeatures,
+    int logPeriod,
+    EPreCalcShapValues mode,
+    NPar::TLocalExecutor* localExecutor,
+    ECalcTypeShapValues calcType
+) {
+    TShapPreparedTrees preparedTrees = PrepareTrees(
+        model,
+        &dataset,
+        /*referenceDataset*/ nullptr,
+        mode,
+        localExecutor,
+        /*calcInternalValues*/ true,
+        calcType
+    );
+    CheckNonZeroApproxForZeroWeightLeaf(model);
+    TVector<TIntrusivePtr<NModelEvaluation::IQuantizedData>> binarizedFeatures;
+    TVector<TVector<NModelEvaluation::TCalcerIndexType>> indexes;
+    CalcLeafIndices(
+        model,
+        dataset,
+        &binarizedFeatures,
+        &indexes
+    );
+    // CalcShapInteraction filters CombinationClassFeatures by the pair, so it is restored for each pair
+    const TVector<TVector<int>> combinationClassFeatures = preparedTrees.CombinationClassFeatures;
+    TVector<TInteractionValuesFull> shapInteractionValues(pairsOfFeatures.size());
+    for (auto pairIdx : xrange(pairsOfFeatures.size())) {
+        preparedTrees.CombinationClassFeatures = combinationClassFeatures;
+        CalcShapInteractionForPair(
+            model,
+            dataset,
+            binarizedFeatures,
+            indexes,
+            pairsOfFeatures[pairIdx],
+            logPeriod,
+            localExecutor,
+            &preparedTrees,
+            &shapInteractionValues[pairIdx],
+            calcType
+        );
+    }
+    return shapInteractionValues;
+}
@@ -6,6 +6,8 @@
 
 #include <library/cpp/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
+
 
 void ValidateFeaturePair(int flatFeatureCount, std::pair<int, int> featurePair);
 void ValidateFeatureInteractionParams(
@@ -25,3 +27,16 @@ TVector<TVector<TVector<TVector<double>>>> CalcShapInteractionValuesMulti(
     NPar::TLocalExecutor* localExecutor,
     ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular
 );
+
+// returned: ShapInteractionValues[pairIdx][featureIdx1][featureIdx2][dim][documentIdx],
+// values for each pair are the same as returned by CalcShapInteractionValuesMulti for this pair,
+// trees and leaf indices are prepared once for all pairs
+TVector<TVector<TVector<TVector<TVector<double>>>>> CalcShapInteractionValuesForPairs(
+    const TFullModel& model,
+    const NCB::TDataProvider& dataset,
+    TConstArrayRef<std::pair<int, int>> pairsOfFeatures,
+    int logPeriod,
+    EPreCalcShapValues mode,
+    NPar::TLocalExecutor* localExecutor,
+    ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular
+);
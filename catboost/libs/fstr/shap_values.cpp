@@ -876,7 +876,13 @@ void CalcShapValuesForDocumentMulti(
     const bool isIndependent = (calcType == ECalcTypeShapValues::Independent);
     const auto& independentTreeShapParams = preparedTrees.IndependentTreeShapParams;
     TVector<TVector<TVector<double>>> shapValuesForAllReferences;
-    if (isIndependent) {
+    // for Raw output only the sum over references is needed, references in the same leaf are added at once
+    const bool isIndependentRawSum = isIndependent && (independentTreeShapParams->ModelOutputType == EExplainableModelOutput::Raw);
+    TVector<TVector<double>> shapValuesSumByReferences;
+    if (isIndependentRawSum) {
+        const size_t classCount = preparedTrees.CombinationClassFeatures.size();
+        shapValuesSumByReferences.assign(approxDimension, TVector<double>(classCount + 1, 0.0));
+    } else if (isIndependent) {
         const size_t referenceCount = independentTreeShapParams->ReferenceLeafIndicesForAllTrees[0].size();
         const size_t classCount = preparedTrees.CombinationClassFeatures.size();
         shapValuesForAllReferences.resize(referenceCount);
@@ -884,19 +890,37 @@ void CalcShapValuesForDocumentMulti(
             shapValuesForAllReferences[referenceIdx].assign(approxDimension, TVector<double>(classCount + 1, 0.0));
         }
     }
+    const auto addIndependentValues = [&] (
+        size_t treeIdx,
+        const TVector<TVector<TVector<double>>>& shapValueByDepthBetweenLeaves
+    ) {
+        const auto& binFeatureCombinationClassByDepth =
+            GetBinFeatureCombinationClassByDepth(forest, binFeatureCombinationClass, treeIdx);
+        if (isIndependentRawSum) {
+            AddValuesToShapValuesSumByReferences(
+                shapValueByDepthBetweenLeaves,
+                independentTreeShapParams->ReferenceIndicesForAllTrees[treeIdx],
+                binFeatureCombinationClassByDepth,
+                &shapValuesSumByReferences
+            );
+        } else {
+            AddValuesToShapValuesByAllReferences(
+                shapValueByDepthBetweenLeaves,
+                independentTreeShapParams->ReferenceLeafIndicesForAllTrees[treeIdx],
+                binFeatureCombinationClassByDepth,
+                &shapValuesForAllReferences
+            );
+        }
+    };
     const size_t treeCount = model.GetTreeCount();
     for (size_t treeIdx = 0; treeIdx < treeCount; ++treeIdx) {
         const size_t leafCount = (size_t(1) << forest.GetTreeSizes()[treeIdx]);
         if (preparedTrees.CalcShapValuesByLeafForAllTrees && model.IsOblivious()) {
             if (isIndependent) {
-                const auto& binFeatureCombinationClassByDepth =
-                    GetBinFeatureCombinationClassByDepth(forest, binFeatureCombinationClass, treeIdx);
                 Y_ASSERT(docIndices[treeIdx] < independentTreeShapParams->ShapValueByDepthBetweenLeavesForAllTrees[treeIdx].size());
-                AddValuesToShapValuesByAllReferences(
-                    independentTreeShapParams->ShapValueByDepthBetweenLeavesForAllTrees[treeIdx][docIndices[treeIdx]],
-                    independentTreeShapParams->ReferenceLeafIndicesForAllTrees[treeIdx],
-                    binFeatureCombinationClassByDepth,
-                    &shapValuesForAllReferences
+                addIndependentValues(
+                    treeIdx,
+                    independentTreeShapParams->ShapValueByDepthBetweenLeavesForAllTrees[treeIdx][docIndices[treeIdx]]
                 );
             } else {
                 Y_ASSERT(docIndices[treeIdx] < preparedTrees.ShapValuesByLeafForAllTrees[treeIdx].size());
@@ -1006,14 +1030,7 @@ void CalcShapValuesForDocumentMulti(
                     break;
             }
             if (isIndependent) {
-                const auto& binFeatureCombinationClassByDepth =
-                    GetBinFeatureCombinationClassByDepth(forest, binFeatureCombinationClass, treeIdx);
-                AddValuesToShapValuesByAllReferences(
-                    shapValueByDepthBetweenLeaves,
-                    independentTreeShapParams->ReferenceLeafIndicesForAllTrees[treeIdx],
-                    binFeatureCombinationClassByDepth,
-                    &shapValuesForAllReferences
-                );
+                addIndependentValues(treeIdx, shapValueByDepthBetweenLeaves);
             } else {
                 AddValuesToShapValues(
                     shapValuesByLeaf,
@@ -1030,7 +1047,18 @@ void CalcShapValuesForDocumentMulti(
         }
     }
     const double bias = model.GetScaleAndBias().Bias;
-    if (isIndependent) {
+    if (isIndependentRawSum) {
+        PostProcessingIndependentRawSum(
+            shapValuesSumByReferences,
+            preparedTrees.CombinationClassFeatures,
+            approxDimension,
+            featuresCount,
+            independentTreeShapParams->ReferenceLeafIndicesForAllTrees[0].size(),
+            preparedTrees.CalcInternalValues,
+            bias,
+            shapValues
+        );
+    } else if (isIndependent) {
         Y_ASSERT(independentTreeShapParams);
         PostProcessingIndependent(
             *independentTreeShapParams,
@@ -1073,6 +1101,9 @@ void CalcShapValuesForDocumentMulti(
     );
 }
 
+// consumeShapValues(documentIdx, &shapValues) is called for each document of the block,
+// shapValues buffer is per-thread and can be reused or moved from by the consumer
+template <class TConsumeShapValues>
 static void CalcShapValuesForDocumentBlockMulti(
     const TFullModel& model,
     const IFeaturesBlockIterator& featuresBlockIterator,
@@ -1082,8 +1113,8 @@ static void CalcShapValuesForDocumentBlockMulti(
     size_t start,
     size_t end,
     NPar::TLocalExecutor* localExecutor,
-    TVector<TVector<TVector<double>>>* shapValuesForAllDocuments,
-    ECalcTypeShapValues calcType
+    ECalcTypeShapValues calcType,
+    TConsumeShapValues&& consumeShapValues
 ) {
     CheckNonZeroApproxForZeroWeightLeaf(model);
 
@@ -1094,27 +1125,28 @@ static void CalcShapValuesForDocumentBlockMulti(
     TVector<NModelEvaluation::TCalcerIndexType> indices(binarizedFeaturesForBlock->GetObjectsCount() * model.GetTreeCount());
     model.GetCurrentEvaluator()->CalcLeafIndexes(binarizedFeaturesForBlock.Get(), 0, model.GetTreeCount(), indices);
 
-    const int oldShapValuesSize = shapValuesForAllDocuments->size();
-    shapValuesForAllDocuments->resize(oldShapValuesSize + end - start);
-
     NPar::TLocalExecutor::TExecRangeParams blockParams(0, documentCount);
-    localExecutor->ExecRange([&] (size_t documentIdxInBlock) {
-        TVector<TVector<double>>& shapValues = (*shapValuesForAllDocuments)[oldShapValuesSize + documentIdxInBlock];
-
-        CalcShapValuesForDocumentMulti(
-            model,
-            preparedTrees,
-            binarizedFeaturesForBlock.Get(),
-            fixedFeatureParams,
-            flatFeatureCount,
-            MakeArrayRef(indices.data() + documentIdxInBlock * model.GetTreeCount(), model.GetTreeCount()),
-            documentIdxInBlock,
-            &shapValues,
-            calcType,
-            /*documentIdx*/ documentIdxInBlock + start
-        );
-
-    }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
+    blockParams.SetBlockCountToThreadCount();
+    localExecutor->ExecRange([&] (int blockId) {
+        TVector<TVector<double>> shapValues;
+        const size_t blockStart = blockId * blockParams.GetBlockSize();
+        const size_t blockEnd = Min<size_t>(blockStart + blockParams.GetBlockSize(), documentCount);
+        for (size_t documentIdxInBlock : xrange(blockStart, blockEnd)) {
+            CalcShapValuesForDocumentMulti(
+                model,
+                preparedTrees,
+                binarizedFeaturesForBlock.Get(),
+                fixedFeatureParams,
+                flatFeatureCount,
+                MakeArrayRef(indices.data() + documentIdxInBlock * model.GetTreeCount(), model.GetTreeCount()),
+                documentIdxInBlock,
+                &shapValues,
+                calcType,
+                /*documentIdx*/ documentIdxInBlock + start
+            );
+            consumeShapValues(documentIdxInBlock + start, &shapValues);
+        }
+    }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
 }
 
 static void CalcShapValuesByLeafForTreeBlock(
@@ -1381,14 +1413,16 @@ void CalcShapValuesInternalForFeature(
     }
 }
 
-static TVector<TVector<TVector<double>>> CalcShapValuesWithPreparedTrees(
+template <class TConsumeShapValues>
+static void CalcShapValuesWithPreparedTrees(
     const TFullModel& model,
     const TDataProvider& dataset,
     const TMaybe<TFixedFeatureParams>& fixedFeatureParams,
     int logPeriod,
     TShapPreparedTrees* preparedTrees,
     NPar::TLocalExecutor* localExecutor,
-    ECalcTypeShapValues calcType
+    ECalcTypeShapValues calcType,
+    TConsumeShapValues&& consumeShapValues
 ) {
     const size_t documentCount = dataset.ObjectsGrouping->GetObjectCount();
     const size_t documentBlockSize = CB_THREAD_LIMIT; // least necessary for threading
@@ -1397,9 +1431,6 @@ static TVector<TVector<TVector<double>>> CalcShapValuesWithPreparedTrees(
 
     TImportanceLogger documentsLogger(documentCount, "documents processed", "Processing documents...", logPeriod);
 
-    TVector<TVector<TVector<double>>> shapValues;
-    shapValues.reserve(documentCount);
-
     TProfileInfo processDocumentsProfile(documentCount);
 
     THolder<IFeaturesBlockIterator> featuresBlockIterator
@@ -1421,15 +1452,38 @@ static TVector<TVector<TVector<double>>> CalcShapValuesWithPreparedTrees(
             start,
             end,
             localExecutor,
-            &shapValues,
-            calcType
+            calcType,
+            consumeShapValues
         );
 
         processDocumentsProfile.FinishIterationBlock(end - start);
         auto profileResults = processDocumentsProfile.GetProfileResults();
         documentsLogger.Log(profileResults);
     }
+}
 
+static TVector<TVector<TVector<double>>> CalcShapValuesWithPreparedTrees(
+    const TFullModel& model,
+    const TDataProvider& dataset,
+    const TMaybe<TFixedFeatureParams>& fixedFeatureParams,
+    int logPeriod,
+    TShapPreparedTrees* preparedTrees,
+    NPar::TLocalExecutor* localExecutor,
+    ECalcTypeShapValues calcType
+) {
+    TVector<TVector<TVector<double>>> shapValues(dataset.ObjectsGrouping->GetObjectCount());
+    CalcShapValuesWithPreparedTrees(
+        model,
+        dataset,
+        fixedFeatureParams,
+        logPeriod,
+        preparedTrees,
+        localExecutor,
+        calcType,
+        [&] (size_t documentIdx, TVector<TVector<double>>* documentShapValues) {
+            shapValues[documentIdx] = std::move(*documentShapValues);
+        }
+    );
     return shapValues;
 }
 
@@ -1475,6 +1529,63 @@ TVector<TVector<TVector<double>>> CalcShapValuesMulti(
     );
 }
 
+void CalcShapValuesMulti(
+    const TFullModel& model,
+    const TDataProvider& dataset,
+    const TDataProviderPtr referenceDataset,
+    const TMaybe<TFixedFeatureParams>& fixedFeatureParams,
+    int logPeriod,
+    EPreCalcShapValues mode,
+    NPar::TLocalExecutor* localExecutor,
+    TArrayRef<double> shapValues,
+    ECalcTypeShapValues calcType,
+    EExplainableModelOutput modelOutputType
+) {
+    const size_t approxDimension = model.GetDimensionsCount();
+    const size_t documentStride = approxDimension * (dataset.MetaInfo.GetFeatureCount() + 1);
+    CB_ENSURE(
+        shapValues.size() == dataset.ObjectsGrouping->GetObjectCount() * documentStride,
+        "Shap values buffer size " << shapValues.size() << " does not match expected size "
+        << dataset.ObjectsGrouping->GetObjectCount() * documentStride
+    );
+
+    TShapPreparedTrees preparedTrees = PrepareTrees(
+        model,
+        &dataset,
+        referenceDataset,
+        mode,
+        localExecutor,
+        /*calcInternalValues*/ false,
+        calcType,
+        modelOutputType
+    );
+    CalcShapValuesByLeaf(
+        model,
+        fixedFeatureParams,
+        logPeriod,
+        preparedTrees.CalcInternalValues,
+        localExecutor,
+        &preparedTrees,
+        calcType
+    );
+
+    CalcShapValuesWithPreparedTrees(
+        model,
+        dataset,
+        fixedFeatureParams,
+        logPeriod,
+        &preparedTrees,
+        localExecutor,
+        calcType,
+        [&] (size_t documentIdx, TVector<TVector<double>>* documentShapValues) {
+            double* dst = shapValues.data() + documentIdx * documentStride;
+            for (const auto& dimensionShapValues : *documentShapValues) {
+                dst = Copy(dimensionShapValues.begin(), dimensionShapValues.end(), dst);
+            }
+        }
+    );
+}
+
 TVector<TVector<double>> CalcShapValues(
     const TFullModel& model,
     const TDataProvider& dataset,
@@ -1575,7 +1686,7 @@ TVector<TVector<TVector<double>>> CalcShapValueWithQuantizedData(
     return swapedShapValues;
 }
 
-static void OutputShapValuesMulti(const TVector<TVector<TVector<double>>>& shapValues, TFileOutput& out) {
+static void OutputShapValuesMulti(const TVector<TVector<TVector<double>>>& shapValues, IOutputStream& out) {
     for (const auto& shapValuesForDocument : shapValues) {
         for (const auto& shapValuesForClass : shapValuesForDocument) {
             int valuesCount = shapValuesForClass.size();
@@ -1586,34 +1697,15 @@ static void OutputShapValuesMulti(const TVector<TVector<TVector<double>>>& shapV
     }
 }
 
-void CalcAndOutputShapValues(
+static void CalcAndOutputShapValuesWithPreparedTrees(
     const TFullModel& model,
+    const TShapPreparedTrees& preparedTrees,
     const TDataProvider& dataset,
-    const TString& outputPath,
     int logPeriod,
-    EPreCalcShapValues mode,
     NPar::TLocalExecutor* localExecutor,
-    ECalcTypeShapValues calcType
+    ECalcTypeShapValues calcType,
+    IOutputStream* out
 ) {
-    TShapPreparedTrees preparedTrees = PrepareTrees(
-        model,
-        &dataset,
-        /*referenceDataset*/ nullptr,
-        mode,
-        localExecutor,
-        /*calcInternalValues*/ false,
-        calcType
-    );
-    CalcShapValuesByLeaf(
-        model,
-        /*fixedFeatureParams*/ Nothing(),
-        logPeriod,
-        preparedTrees.CalcInternalValues,
-        localExecutor,
-        &preparedTrees,
-        calcType
-    );
-
     CB_ENSURE_SCALE_IDENTITY(model.GetScaleAndBias(), "SHAP values");
     const int flatFeatureCount = SafeIntegerCast<int>(dataset.MetaInfo.GetFeatureCount());
 
@@ -1627,13 +1719,11 @@ void CalcAndOutputShapValues(
     THolder<IFeaturesBlockIterator> featuresBlockIterator
         = CreateFeaturesBlockIterator(model, *dataset.ObjectsData, 0, documentCount);
 
-    TFileOutput out(outputPath);
     for (size_t start = 0; start < documentCount; start += documentBlockSize) {
         size_t end = Min(start + documentBlockSize, documentCount);
         processDocumentsProfile.StartIterationBlock();
 
-        TVector<TVector<TVector<double>>> shapValuesForBlock;
-        shapValuesForBlock.reserve(end - start);
+        TVector<TVector<TVector<double>>> shapValuesForBlock(end - start);
 
         featuresBlockIterator->NextBlock(end - start);
 
@@ -1646,11 +1736,13 @@ void CalcAndOutputShapValues(
             start,
             end,
             localExecutor,
-            &shapValuesForBlock,
-            calcType
+            calcType,
+            [&] (size_t documentIdx, TVector<TVector<double>>* documentShapValues) {
+                shapValuesForBlock[documentIdx - start] = std::move(*documentShapValues);
+            }
         );
 
-        OutputShapValuesMulti(shapValuesForBlock, out);
+        OutputShapValuesMulti(shapValuesForBlock, *out);
 
         processDocumentsProfile.FinishIterationBlock(end - start);
         auto profileResults = processDocumentsProfile.GetProfileResults();
@@ -1658,3 +1750,90 @@ void CalcAndOutputShapValues(
     }
 }
 
+void CalcAndOutputShapValues(
+    const TFullModel& model,
+    const TDataProvider& dataset,
+    const TString& outputPath,
+    int logPeriod,
+    EPreCalcShapValues mode,
+    NPar::TLocalExecutor* localExecutor,
+    ECalcTypeShapValues calcType
+) {
+    TShapPreparedTrees preparedTrees = PrepareTrees(
+        model,
+        &dataset,
+        /*referenceDataset*/ nullptr,
+        mode,
+        localExecutor,
+        /*calcInternalValues*/ false,
+        calcType
+    );
+    CalcShapValuesByLeaf(
+        model,
+        /*fixedFeatureParams*/ Nothing(),
+        logPeriod,
+        preparedTrees.CalcInternalValues,
+        localExecutor,
+        &preparedTrees,
+        calcType
+    );
+
+    TFileOutput out(outputPath);
+    CalcAndOutputShapValuesWithPreparedTrees(model, preparedTrees, dataset, logPeriod, localExecutor, calcType, &out);
+}
+
+TShapPreparedTrees PrepareTreesForShapValuesOutputInBlocks(
+    const TFullModel& model,
+    int logPeriod,
+    EPreCalcShapValues mode,
+    NPar::TLocalExecutor* localExecutor,
+    ECalcTypeShapValues calcType
+) {
+    CB_ENSURE(
+        !model.ModelTrees->GetLeafWeights().empty(),
+        "SHAP values can be output in blocks only for models with leaf weights"
+    );
+    CB_ENSURE(
+        calcType != ECalcTypeShapValues::Independent,
+        "SHAP values can not be output in blocks for Independent calculation type"
+    );
+    TShapPreparedTrees preparedTrees = PrepareTrees(
+        model,
+        /*dataset*/ nullptr,
+        /*referenceDataset*/ nullptr,
+        mode,
+        localExecutor,
+        /*calcInternalValues*/ false,
+        calcType
+    );
+    CalcShapValuesByLeaf(
+        model,
+        /*fixedFeatureParams*/ Nothing(),
+        logPeriod,
+        preparedTrees.CalcInternalValues,
+        localExecutor,
+        &preparedTrees,
+        calcType
+    );
+    return preparedTrees;
+}
+
+void CalcAndOutputShapValuesForBlock(
+    const TFullModel& model,
+    const TShapPreparedTrees& preparedTrees,
+    const TDataProvider& datasetBlock,
+    NPar::TLocalExecutor* localExecutor,
+    ECalcTypeShapValues calcType,
+    IOutputStream* out
+) {
+    CalcAndOutputShapValuesWithPreparedTrees(
+        model,
+        preparedTrees,
+        datasetBlock,
+        /*logPeriod*/ 0,
+        localExecutor,
+        calcType,
+        out
+    );
+}
+
@@ -7,6 +7,7 @@
 #include <catboost/private/libs/options/enums.h>
 #include <library/cpp/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/vector.h>
 #include <util/stream/input.h>
 #include <util/stream/output.h>
@@ -92,6 +93,22 @@ TVector<TVector<TVector<double>>> CalcShapValuesMulti(
     EExplainableModelOutput modelOutputType = EExplainableModelOutput::Raw
 );
 
+// writes ShapValues[documentIdx][dimension][feature] to a contiguous row-major buffer of size
+// documentCount * dimensionCount * (featureCount + 1), feature stride is 1,
+// dimension stride is (featureCount + 1), document stride is dimensionCount * (featureCount + 1)
+void CalcShapValuesMulti(
+    const TFullModel& model,
+    const NCB::TDataProvider& dataset,
+    const NCB::TDataProviderPtr referenceDataset, // can be nullptr if using Independent Tree SHAP algorithm
+    const TMaybe<TFixedFeatureParams>& fixedFeatureParams,
+    int logPeriod,
+    EPreCalcShapValues mode,
+    NPar::TLocalExecutor* localExecutor,
+    TArrayRef<double> shapValues,
+    ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular,
+    EExplainableModelOutput modelOutputType = EExplainableModelOutput::Raw
+);
+
 // returned: ShapValues[documentIdx][feature]
 TVector<TVector<double>> CalcShapValues(
     const TFullModel& model,
@@ -129,6 +146,25 @@ void CalcAndOutputShapValues(
     ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular
 );
 
+// for pools that are read in blocks: trees are prepared once without a dataset, so the model must have
+// leaf weights, then each block is output in the same format as CalcAndOutputShapValues
+TShapPreparedTrees PrepareTreesForShapValuesOutputInBlocks(
+    const TFullModel& model,
+    int logPeriod,
+    EPreCalcShapValues mode,
+    NPar::TLocalExecutor* localExecutor,
+    ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular
+);
+
+void CalcAndOutputShapValuesForBlock(
+    const TFullModel& model,
+    const TShapPreparedTrees& preparedTrees,
+    const NCB::TDataProvider& datasetBlock,
+    NPar::TLocalExecutor* localExecutor,
+    ECalcTypeShapValues calcType,
+    IOutputStream* out
+);
+
 void CalcShapValuesInternalForFeature(
     const TShapPreparedTrees& preparedTrees,
     const TFullModel& model,
@@ -0,0 +1,93 @@
+#include "adaptive_block_size.h"
+
+#include "exception.h"
+
+#include <catboost/libs/logging/logging.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/utility.h>
+#include <util/string/builder.h>
+#include <util/system/guard.h>
+
+
+namespace NCB {
+
+    TAdaptiveBlockSize::TAdaptiveBlockSize(
+        TStringBuf name,
+        int defaultBlockSize,
+        int minObjectCount,
+        int callsPerCandidate)
+        : Name(name)
+        , DefaultBlockSize(defaultBlockSize)
+        , MinObjectCount(minObjectCount)
+        , CallsPerCandidate(callsPerCandidate)
+    {
+        CB_ENSURE_INTERNAL(defaultBlockSize > 0, "TAdaptiveBlockSize: defaultBlockSize must be positive");
+        CB_ENSURE_INTERNAL(callsPerCandidate > 0, "TAdaptiveBlockSize: callsPerCandidate must be positive");
+
+        // default first so that calls made before the end of warm-up are not slower than before
+        for (double factor : {1.0, 0.25, 0.5, 2.0, 4.0}) {
+            const int blockSize = Max(1, int(defaultBlockSize * factor));
+            if (!FindIfPtr(Candidates, [=] (const TCandidate& candidate) { return candidate.BlockSize == blockSize; })) {
+                Candidates.push_back(TCandidate{blockSize, 0, 0.0, 0.0});
+            }
+        }
+    }
+
+    TAdaptiveBlockSize::TTimedCall TAdaptiveBlockSize::StartCall(int objectCount) {
+        if (objectCount < MinObjectCount) {
+            return TTimedCall(this, DefaultBlockSize, objectCount, /*isMeasured*/ false);
+        }
+        with_lock (Mutex) {
+            if (SelectedBlockSize) {
+                return TTimedCall(this, SelectedBlockSize, objectCount, /*isMeasured*/ false);
+            }
+            return TTimedCall(this, Candidates[CurrentCandidateIdx].BlockSize, objectCount, /*isMeasured*/ true);
+        }
+    }
+
+    void TAdaptiveBlockSize::AddMeasurement(int blockSize, int objectCount, double seconds) {
+        with_lock (Mutex) {
+            if (SelectedBlockSize) {
+                return;
+            }
+            if (!IsWarmedUp) {
+                IsWarmedUp = true;
+                return;
+            }
+            auto& candidate = Candidates[CurrentCandidateIdx];
+            if (candidate.BlockSize != blockSize) { // concurrent call started with the previous candidate
+                return;
+            }
+            candidate.Seconds += seconds;
+            candidate.ObjectCount += objectCount;
+            if (++candidate.CallCount < CallsPerCandidate) {
+                return;
+            }
+            if (++CurrentCandidateIdx < Candidates.size()) {
+                return;
+            }
+
+            const auto best = MinElementBy(Candidates, [] (const TCandidate& candidate) {
+                return candidate.Seconds / candidate.ObjectCount;
+            });
+            SelectedBlockSize = best->BlockSize;
+
+            TStringBuilder timesDescription;
+            for (const auto& candidate : Candidates) {
+                timesDescription << ' ' << candidate.BlockSize << ':'
+                    << 1e9 * candidate.Seconds / candidate.ObjectCount;
+            }
+            CATBOOST_DEBUG_LOG << "Adaptive block size for " << Name << ": " << SelectedBlockSize
+                << " (default " << DefaultBlockSize << ", ns per object by block size:" << timesDescription << ")"
+                << Endl;
+        }
+    }
+
+    int TAdaptiveBlockSize::GetSelectedBlockSize() const {
+        with_lock (Mutex) {
+            return SelectedBlockSize;
+        }
+    }
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <util/datetime/base.h>
+#include <util/generic/noncopyable.h>
+#include <util/generic/string.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/vector.h>
+#include <util/system/mutex.h>
+
+#include <exception>
+
+
+namespace NCB {
+
+    /* Block size of a parallel loop chosen at runtime.
+     * During the first calls candidate block sizes around defaultBlockSize are tried in turn and the one with
+     * the least time per object is used for the rest of the process lifetime. The choice is written to the debug log.
+     *
+     * Use it only for loops with results that do not depend on block boundaries (elementwise updates),
+     * otherwise training would not be reproducible.
+     * Thread-safe, intended to be a static variable at the call site.
+     */
+    class TAdaptiveBlockSize {
+    public:
+        class TTimedCall : public TNonCopyable {
+        public:
+            TTimedCall(TAdaptiveBlockSize* owner, int blockSize, int objectCount, bool isMeasured)
+                : Owner(owner)
+                , BlockSize(blockSize)
+                , ObjectCount(objectCount)
+                , IsMeasured(isMeasured)
+                , StartTime(isMeasured ? TInstant::Now() : TInstant::Zero())
+            {}
+
+            // the time is measured only if the loop has not thrown
+            ~TTimedCall() {
+                if (IsMeasured && !std::uncaught_exceptions()) {
+                    Owner->AddMeasurement(BlockSize, ObjectCount, (TInstant::Now() - StartTime).SecondsFloat());
+                }
+            }
+
+            int GetBlockSize() const {
+                return BlockSize;
+            }
+
+        private:
+            TAdaptiveBlockSize* Owner;
+            int BlockSize;
+            int ObjectCount;
+            bool IsMeasured;
+            TInstant StartTime;
+        };
+
+    public:
+        // loops over less than minObjectCount objects always use defaultBlockSize and are not measured
+        TAdaptiveBlockSize(
+            TStringBuf name,
+            int defaultBlockSize,
+            int minObjectCount = 10000,
+            int callsPerCandidate = 3);
+
+        // time of the loop is measured until TTimedCall is destroyed
+        TTimedCall StartCall(int objectCount);
+
+        void AddMeasurement(int blockSize, int objectCount, double seconds);
+
+        int GetDefaultBlockSize() const {
+            return DefaultBlockSize;
+        }
+
+        // 0 if candidates are still being measured
+        int GetSelectedBlockSize() const;
+
+    private:
+        struct TCandidate {
+            int BlockSize = 0;
+            int CallCount = 0;
+            double Seconds = 0;
+            double ObjectCount = 0;
+        };
+
+    private:
+        TString Name;
+        int DefaultBlockSize;
+        int MinObjectCount;
+        int CallsPerCandidate;
+
+        mutable TMutex Mutex;
+        bool IsWarmedUp = false; // the first measured call is skipped
+        size_t CurrentCandidateIdx = 0;
+        TVector<TCandidate> Candidates;
+        int SelectedBlockSize = 0;
+    };
+
+}
@@ -1014,6 +1014,46 @@ namespace NCB {
         return !rhs.Find([&](TSize idx, T element) { return !EqualWithNans(element, lhs[idx]); });
     }
 
+    namespace NPrivate {
+        // in elements, enough to hide memory latency for random access by TIndexedSubset
+        constexpr size_t GATHER_PREFETCH_DISTANCE = 16;
+
+        /* copies a block in the format of TArraySubsetIndexing::ForEachBlockwiseInSubRange:
+         * if srcIndices is nullptr [srcBegin, srcEnd) is copied to dst starting from dstBegin,
+         * otherwise dst[i] = src[srcIndices[i]] for i in [srcBegin, srcEnd)
+         */
+        template <class TDst, class TSrcArrayLike, class TSize>
+        inline void GatherBlock(
+            const TSrcArrayLike& srcArrayLike,
+            TSize srcBegin,
+            TSize srcEnd,
+            TSize dstBegin,
+            const TSize* srcIndices,
+            TDst* dst
+        ) {
+            if (!srcIndices) {
+                TDst* dstIt = dst + dstBegin;
+                for (TSize srcIdx = srcBegin; srcIdx < srcEnd; ++srcIdx, ++dstIt) {
+                    *dstIt = srcArrayLike[srcIdx];
+                }
+                return;
+            }
+
+            TSize dstIdx = srcBegin;
+            if constexpr (std::is_lvalue_reference_v<decltype(srcArrayLike[srcIndices[0]])>) {
+                const TSize prefetchEnd
+                    = (srcEnd - srcBegin > GATHER_PREFETCH_DISTANCE) ? (srcEnd - GATHER_PREFETCH_DISTANCE) : srcBegin;
+                for (; dstIdx < prefetchEnd; ++dstIdx) {
+                    Y_PREFETCH_READ(&srcArrayLike[srcIndices[dstIdx + GATHER_PREFETCH_DISTANCE]], 3);
+                    dst[dstIdx] = srcArrayLike[srcIndices[dstIdx]];
+                }
+            }
+            for (; dstIdx < srcEnd; ++dstIdx) {
+                dst[dstIdx] = srcArrayLike[srcIndices[dstIdx]];
+            }
+        }
+    }
+
     template <class TDst, class TSrcArrayLike, class TSize=size_t>
     inline TVector<TDst> GetSubset(
         const TSrcArrayLike& srcArrayLike,
@@ -1024,16 +1064,21 @@ namespace NCB {
         TVector<TDst> dst;
         dst.yresize(subsetIndexing.Size());
 
-        TArraySubset<const TSrcArrayLike, TSize> arraySubset(&srcArrayLike, &subsetIndexing);
+        auto gatherBlock = [&srcArrayLike, dstData = dst.data()] (
+            TSize srcBegin,
+            TSize srcEnd,
+            TSize dstBegin,
+            const TSize* srcIndices
+        ) {
+            NPrivate::GatherBlock(srcArrayLike, srcBegin, srcEnd, dstBegin, srcIndices, dstData);
+        };
+
         if (localExecutor.Defined()) {
-            arraySubset.ParallelForEach(
-                [&dst](TSize idx, TDst srcElement) { dst[idx] = srcElement; },
-                *localExecutor,
-                approximateBlockSize
-            );
+            subsetIndexing.ParallelForEachBlockwise(gatherBlock, *localExecutor, approximateBlockSize);
         } else {
-            arraySubset.ForEach(
-                [&dst](TSize idx, TDst srcElement) { dst[idx] = srcElement; }
+            subsetIndexing.ForEachBlockwiseInSubRange(
+                NCB::TIndexRange<TSize>(subsetIndexing.GetParallelizableUnitsCount()),
+                gatherBlock
             );
         }
 
@@ -114,6 +114,26 @@ public:
         return IndexHelper.Extract<T>(*Storage, index);
     }
 
+    // unpacks values [offset, offset + dst.size()) word by word, without per-element division
+    template <class T>
+    void Unpack(ui64 offset, TArrayRef<T> dst) const {
+        Y_ASSERT(offset + dst.size() <= Size);
+        Y_ASSERT(sizeof(T) * CHAR_BIT >= GetBitsPerKey());
+        const ui32 bitsPerKey = GetBitsPerKey();
+        const ui64 entriesPerWord = IndexHelper.GetEntriesPerType();
+        const ui64 mask = IndexHelper.Mask();
+        const ui64* words = (*Storage).data() + offset / entriesPerWord;
+        ui64 entryIdx = offset % entriesPerWord;
+        for (size_t i = 0; i < dst.size(); ++words, entryIdx = 0) {
+            ui64 word = *words >> (entryIdx * bitsPerKey);
+            const size_t wordEnd = Min<size_t>(dst.size(), i + entriesPerWord - entryIdx);
+            for (; i < wordEnd; ++i) {
+                dst[i] = static_cast<T>(word & mask);
+                word >>= bitsPerKey;
+            }
+        }
+    }
+
     // comparison is strict by default, useful for unit tests
     bool operator==(const TCompressedArray& rhs) const {
         return EqualTo(rhs, /*strict*/ true);
@@ -251,11 +271,8 @@ public:
 
     TConstArrayRef<T> NextExact(size_t exactBlockSize) override {
         UncompressedBuffer.yresize(exactBlockSize);
-        const ui64 blockEnd = Index + exactBlockSize;
-        for (auto i : xrange(Index, blockEnd)) {
-            UncompressedBuffer[i - Index] = CompressedArray.operator[]<T>(i);
-        }
-        Index = blockEnd;
+        CompressedArray.Unpack<T>(Index, UncompressedBuffer);
+        Index += exactBlockSize;
         return UncompressedBuffer;
     }
 
@@ -23,4 +23,26 @@ namespace NCB {
         return totalMemorySize - currentProcessRSS;
     }
 
+    void TMemoryUsageReport::Add(TStringBuf subsystem, ui64 bytes) {
+        SubsystemUsages.emplace_back(TString(subsystem), bytes);
+    }
+
+    ui64 TMemoryUsageReport::GetTotal() const {
+        ui64 total = 0;
+        for (const auto& subsystemUsage : SubsystemUsages) {
+            total += subsystemUsage.second;
+        }
+        return total;
+    }
+
+    void TMemoryUsageReport::Dump(const TString& msg) const {
+        CATBOOST_DEBUG_LOG << "Mem usage: " << msg
+            << ": RSS " << HumanReadableSize(NMemInfo::GetMemInfo().RSS, SF_BYTES)
+            << ", accounted " << HumanReadableSize(GetTotal(), SF_BYTES) << Endl;
+        for (const auto& [subsystem, bytes] : SubsystemUsages) {
+            CATBOOST_DEBUG_LOG << "Mem usage: " << msg << ": " << subsystem << " "
+                << HumanReadableSize(bytes, SF_BYTES) << Endl;
+        }
+    }
+
 }
@@ -2,9 +2,14 @@
 
 #include <catboost/libs/logging/logging.h>
 
+#include <util/generic/strbuf.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
 #include <util/system/mem_info.h>
 #include <util/system/types.h>
 
+#include <utility>
+
 
 inline void DumpMemUsage(const TString& msg) {
     CATBOOST_DEBUG_LOG << "Mem usage: " << msg << ": " << NMemInfo::GetMemInfo().RSS << Endl;
@@ -20,5 +25,21 @@ namespace NCB {
      */
     ui64 GetMonopolisticFreeCpuRam();
 
+    /* CPU RAM used by subsystems (data, fold buffers, caches, model) for diagnostics.
+     * Sizes are computed by subsystems from their containers capacities, so they are approximate and
+     * do not include allocator overhead.
+     */
+    class TMemoryUsageReport {
+    public:
+        void Add(TStringBuf subsystem, ui64 bytes);
+        ui64 GetTotal() const;
+
+        // output usage of each subsystem and process RSS to debug log
+        void Dump(const TString& msg) const;
+
+    private:
+        TVector<std::pair<TString, ui64>> SubsystemUsages;
+    };
+
 }
 
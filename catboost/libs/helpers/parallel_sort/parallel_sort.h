@@ -3,8 +3,12 @@
 #include <library/cpp/threading/local_executor/local_executor.h>
 
 #include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
 #include <util/generic/vector.h>
 
+#include <type_traits>
+#include <utility>
+
 namespace NCB {
 
     struct TMergeData {
@@ -151,4 +155,139 @@ namespace NCB {
             startPositions = newStartPositions;
         }
     }
+
+    namespace NPrivate {
+        // maps an arithmetic key to an unsigned integer with the same order
+        template <class TKey>
+        inline auto ToRadixSortKey(TKey key) {
+            static_assert(std::is_arithmetic<TKey>::value, "Radix sort key must be arithmetic");
+            if constexpr (std::is_floating_point<TKey>::value) {
+                using TBits = std::conditional_t<sizeof(TKey) == sizeof(ui32), ui32, ui64>;
+                static_assert(sizeof(TKey) == sizeof(TBits), "Unsupported floating point key size");
+                if (key == 0) {
+                    key = 0; // -0.0 and +0.0 must get the same key as they are equal for comparisons
+                }
+                const TBits bits = BitCast<TBits>(key);
+                constexpr TBits signBit = TBits(1) << (sizeof(TBits) * 8 - 1);
+                return (bits & signBit) ? TBits(~bits) : TBits(bits | signBit);
+            } else if constexpr (std::is_signed<TKey>::value) {
+                using TBits = std::make_unsigned_t<TKey>;
+                return TBits(TBits(key) ^ (TBits(1) << (sizeof(TBits) * 8 - 1)));
+            } else {
+                return key;
+            }
+        }
+    }
+
+    constexpr ui32 MIN_SIZE_FOR_PARALLEL_RADIX_SORT = 4096;
+
+    /* Stable LSD radix sort of elements by an arithmetic key returned by getKey(element).
+     * Ascending order of keys is the same as for operator<, except that NaN keys are placed
+     * at the beginning or at the end depending on their sign bit.
+     * Passes over key bytes that are the same for all elements are skipped.
+     */
+    template <class TElement, typename TGetKey>
+    inline void ParallelRadixSort(
+        TGetKey getKey,
+        TVector<TElement>* elements,
+        NPar::TLocalExecutor* localExecutor,
+        TVector<TElement>* buf = nullptr
+    ) {
+        constexpr ui32 RADIX_BITS = 8;
+        constexpr ui32 BUCKET_COUNT = 1 << RADIX_BITS;
+
+        const ui32 size = elements->size();
+        if (size <= 1u) {
+            return;
+        }
+        const auto getSortKey = [&getKey] (const TElement& element) {
+            return NPrivate::ToRadixSortKey(getKey(element));
+        };
+        using TSortKey = decltype(getSortKey(std::declval<const TElement&>()));
+
+        if (size < MIN_SIZE_FOR_PARALLEL_RADIX_SORT) {
+            StableSort(
+                elements->begin(),
+                elements->end(),
+                [&] (const TElement& lhs, const TElement& rhs) { return getSortKey(lhs) < getSortKey(rhs); }
+            );
+            return;
+        }
+
+        TVector<TElement> newBuf;
+        if (buf == nullptr) {
+            buf = &newBuf;
+        }
+        buf->yresize(size);
+
+        const ui32 blockCount = Min((ui32)localExecutor->GetThreadCount() + 1, size);
+        TVector<ui32> blockSizes;
+        EquallyDivide(size, blockCount, &blockSizes);
+        TVector<ui32> blockStarts(blockCount + 1, 0);
+        for (ui32 i = 0; i < blockCount; ++i) {
+            blockStarts[i + 1] = blockStarts[i] + blockSizes[i];
+        }
+
+        // [blockId * BUCKET_COUNT + bucket], counts at first and then output positions
+        TVector<ui32> positions(blockCount * BUCKET_COUNT);
+        TVector<TElement>* src = elements;
+        TVector<TElement>* dst = buf;
+        for (ui32 shift = 0; shift < sizeof(TSortKey) * 8; shift += RADIX_BITS) {
+            const auto getBucket = [&getSortKey, shift] (const TElement& element) {
+                return ui32((getSortKey(element) >> shift) & (BUCKET_COUNT - 1));
+            };
+            NPar::ParallelFor(
+                *localExecutor,
+                0,
+                blockCount,
+                [&](int blockId) {
+                    ui32* counts = positions.data() + blockId * BUCKET_COUNT;
+                    Fill(counts, counts + BUCKET_COUNT, 0u);
+                    for (ui32 i = blockStarts[blockId]; i < blockStarts[blockId + 1]; ++i) {
+                        ++counts[getBucket((*src)[i])];
+                    }
+                }
+            );
+            bool allInOneBucket = false;
+            ui32 position = 0;
+            for (ui32 bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+                const ui32 bucketStart = position;
+                for (ui32 blockId = 0; blockId < blockCount; ++blockId) {
+                    const ui32 count = positions[blockId * BUCKET_COUNT + bucket];
+                    positions[blockId * BUCKET_COUNT + bucket] = position;
+                    position += count;
+                }
+                allInOneBucket |= (position - bucketStart == size);
+            }
+            if (allInOneBucket) {
+                continue;
+            }
+            NPar::ParallelFor(
+                *localExecutor,
+                0,
+                blockCount,
+                [&](int blockId) {
+                    ui32* blockPositions = positions.data() + blockId * BUCKET_COUNT;
+                    for (ui32 i = blockStarts[blockId]; i < blockStarts[blockId + 1]; ++i) {
+                        (*dst)[blockPositions[getBucket((*src)[i])]++] = (*src)[i];
+                    }
+                }
+            );
+            std::swap(src, dst);
+        }
+        if (src != elements) {
+            NPar::ParallelFor(
+                *localExecutor,
+                0,
+                blockCount,
+                [&](int blockId) {
+                    std::copy(
+                        src->begin() + blockStarts[blockId],
+                        src->begin() + blockStarts[blockId + 1],
+                        elements->begin() + blockStarts[blockId]
+                    );
+                }
+            );
+        }
+    }
 }
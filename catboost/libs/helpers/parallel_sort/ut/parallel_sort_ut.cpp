@@ -164,4 +164,47 @@ Y_UNIT_TEST_SUITE(ParallelSortTests) {
             UNIT_ASSERT_GE(currentVector[i + 1], currentVector[i]);
         }
     }
+
+    Y_UNIT_TEST(ParallelRadixSortFloatTest) {
+        TRandom rnd(239);
+        for (size_t size : {size_t(0), size_t(1), size_t(100), size_t(1e6 + 239)}) {
+            TVector<float> values(size);
+            for (auto& value : values) {
+                value = (float(rnd.NextUniform()) - 0.5f) * 1e6f;
+            }
+            if (size > 2) {
+                values[0] = -0.0f;
+                values[1] = 0.0f;
+            }
+            TVector<float> expectedValues = values;
+            Sort(expectedValues.begin(), expectedValues.end());
+
+            NPar::TLocalExecutor localExecutor;
+            localExecutor.RunAdditionalThreads(7);
+            NCB::ParallelRadixSort([] (float value) { return value; }, &values, &localExecutor);
+            for (size_t i = 0; i < size; ++i) {
+                UNIT_ASSERT_VALUES_EQUAL(values[i], expectedValues[i]);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(ParallelRadixSortIsStableTest) {
+        TRandom rnd(239);
+        size_t size = (size_t)(1e5 + 239);
+        TVector<std::pair<i32, ui32>> elements(size);
+        for (size_t i = 0; i < size; ++i) {
+            elements[i] = {i32(rnd(1000)) - 500, ui32(i)};
+        }
+        TVector<std::pair<i32, ui32>> expectedElements = elements;
+        Sort(expectedElements.begin(), expectedElements.end());
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(31);
+        NCB::ParallelRadixSort(
+            [] (const std::pair<i32, ui32>& element) { return element.first; },
+            &elements,
+            &localExecutor
+        );
+        UNIT_ASSERT_EQUAL(elements, expectedElements);
+    }
 }
@@ -2,6 +2,7 @@
 
 #include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
+#include <util/generic/bitops.h>
 #include <util/generic/vector.h>
 #include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
@@ -15,19 +16,39 @@ namespace {
     };
 }
 
-static double CalcSampleQuantileBinarySearch(
+static double CalcSortedQuantile(
+    TArrayRef<TValueWithWeight> elements,
+    double collectedWeight,
+    double needWeight
+) {
+    Sort(elements, [](const TValueWithWeight& elem1, const TValueWithWeight& elem2) {
+        return elem1.Value < elem2.Value;
+    });
+    for (const auto& element : elements) {
+        collectedWeight += element.Weight;
+        if (collectedWeight >= needWeight - DBL_EPSILON) {
+            return element.Value;
+        }
+    }
+    return elements.back().Value;
+}
+
+/*
+ * Weighted introselect: expected linear time, falls back to sorting of the remaining elements
+ * if partitions are too unbalanced.
+ */
+static double CalcSampleQuantileSelect(
     TConstArrayRef<float> sampleRef,
     TConstArrayRef<float> weightsRef,
     const double alpha
 ) {
-    constexpr int BINARY_SEARCH_ITERATIONS = 100;
+    constexpr size_t SORT_SIZE_THRESHOLD = 32;
 
     const double totalWeight = Accumulate(weightsRef, 0.0);
     const double needWeight = totalWeight * alpha;
-
-    const auto minMaxSamples = MinMaxElement(sampleRef.begin(), sampleRef.end());
-    double lQ = *minMaxSamples.first - DBL_EPSILON;
-    double rQ = *minMaxSamples.second;
+    if (needWeight - DBL_EPSILON <= 0) {
+        return *MinElement(sampleRef.begin(), sampleRef.end());
+    }
 
     const size_t sampleSize = sampleRef.size();
     TVector<TValueWithWeight> elements;
@@ -35,45 +56,56 @@ static double CalcSampleQuantileBinarySearch(
     for (auto i : xrange(sampleSize)) {
         elements[i] = {sampleRef[i], weightsRef[i]};
     }
+
     /*
      * We will support the following invariant:
-     * total weight of elements with sample values <= lQ is strictly less than needWeight
-     * total weight of elements with sample values <= rQ is greater or equal than needWeight
-     * elements with indices < l are less or equal than q
-     * elements with indices > r are greater than q
+     * total weight of elements before l (all of them less than elements in [l, r)) is collectedLeftWeight,
+     * it is strictly less than needWeight
+     * elements after r are greater than elements in [l, r)
      */
-    int l = 0, r = sampleSize;
+    size_t l = 0, r = sampleSize;
     double collectedLeftWeight = 0;
-    for (auto it : xrange(BINARY_SEARCH_ITERATIONS)) {
-        Y_UNUSED(it);
-        const double q = (lQ + rQ) / 2;
-        auto partitionIt = std::partition(
-            elements.begin() + l,
-            elements.begin() + r,
-            [q](const TValueWithWeight& element) {
-                return element.Value <= q;
-            }
-        );
-        const double partitionLeftWeight = Accumulate(
-            elements.begin() + l,
-            partitionIt,
-            0.0,
-            [](double sum, const TValueWithWeight& element) {
-                return sum + element.Weight;
-            }
-        );
-        const int partitionPoint = partitionIt - elements.begin();
+    int iterationsLeft = 2 * (MostSignificantBit(sampleSize) + 1);
+    while (r - l > SORT_SIZE_THRESHOLD && iterationsLeft-- > 0) {
+        const auto begin = elements.begin() + l;
+        const auto end = elements.begin() + r;
+        float pivotCandidates[] = {begin->Value, (begin + (r - l) / 2)->Value, (end - 1)->Value};
+        std::sort(pivotCandidates, pivotCandidates + 3);
+        const float pivot = pivotCandidates[1];
 
-        if (collectedLeftWeight + partitionLeftWeight < needWeight - DBL_EPSILON) {
-            l = partitionPoint;
-            lQ = q;
-            collectedLeftWeight += partitionLeftWeight;
-        } else {
-            r = partitionPoint;
-            rQ = q;
+        const auto lessEnd = std::partition(begin, end, [pivot](const TValueWithWeight& element) {
+            return element.Value < pivot;
+        });
+        const auto equalEnd = std::partition(lessEnd, end, [pivot](const TValueWithWeight& element) {
+            return element.Value == pivot;
+        });
+        const auto sumWeights = [](double sum, const TValueWithWeight& element) {
+            return sum + element.Weight;
+        };
+        const double lessWeight = Accumulate(begin, lessEnd, 0.0, sumWeights);
+        if (collectedLeftWeight + lessWeight >= needWeight - DBL_EPSILON) {
+            r = lessEnd - elements.begin();
+            continue;
         }
+        const double equalWeight = Accumulate(lessEnd, equalEnd, 0.0, sumWeights);
+        if (collectedLeftWeight + lessWeight + equalWeight >= needWeight - DBL_EPSILON) {
+            return pivot;
+        }
+        collectedLeftWeight += lessWeight + equalWeight;
+        l = equalEnd - elements.begin();
+    }
+    if (l == r) { // only possible because of rounding in weights accumulation
+        const auto lessValue = [](const TValueWithWeight& elem1, const TValueWithWeight& elem2) {
+            return elem1.Value < elem2.Value;
+        };
+        return (r < sampleSize)
+            ? MinElement(elements.begin() + r, elements.end(), lessValue)->Value
+            : MaxElement(elements.begin(), elements.end(), lessValue)->Value;
     }
-    return rQ;
+    return CalcSortedQuantile(
+        TArrayRef<TValueWithWeight>(elements.data() + l, elements.data() + r),
+        collectedLeftWeight,
+        needWeight);
 }
 
 static double CalcSampleQuantileLinearSearch(
@@ -87,19 +119,8 @@ static double CalcSampleQuantileLinearSearch(
     for (auto i : xrange(sampleSize)) {
         elements[i] = {sampleRef[i], weightsRef[i]};
     }
-    Sort(elements, [](const TValueWithWeight& elem1, const TValueWithWeight& elem2) {
-        return elem1.Value < elem2.Value;
-    });
     const double totalWeight = Accumulate(weightsRef, 0.0);
-    const double needWeight = totalWeight * alpha;
-    double sumWeight = 0;
-    for (const auto& element : elements) {
-        sumWeight += element.Weight;
-        if (sumWeight >= needWeight - DBL_EPSILON) {
-            return element.Value;
-        }
-    }
-    return elements.back().Value;
+    return CalcSortedQuantile(elements, /*collectedWeight*/ 0.0, totalWeight * alpha);
 }
 
 double CalcSampleQuantile(
@@ -122,5 +143,5 @@ double CalcSampleQuantile(
     Y_ASSERT(sampleRef.size() == weightsRef.size());
     return sampleRef.size() < 100
         ? CalcSampleQuantileLinearSearch(sampleRef, weightsRef, alpha)
-        : CalcSampleQuantileBinarySearch(sampleRef, weightsRef, alpha);
+        : CalcSampleQuantileSelect(sampleRef, weightsRef, alpha);
 }
@@ -2,6 +2,7 @@
 
 #include <util/generic/ptr.h>
 #include <util/generic/vector.h>
+#include <util/memory/blob.h>
 
 
 namespace NCB {
@@ -21,5 +22,15 @@ namespace NCB {
         {}
     };
 
+    // keeps blob data (memory mapping for a file for example) alive
+    struct TBlobHolder : public IResourceHolder {
+        TBlob Blob;
+
+    public:
+        explicit TBlobHolder(const TBlob& blob)
+            : Blob(blob)
+        {}
+    };
+
 }
 
@@ -0,0 +1,51 @@
+#include <catboost/libs/helpers/adaptive_block_size.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(TAdaptiveBlockSizeTest) {
+    Y_UNIT_TEST(TestSelection) {
+        TAdaptiveBlockSize adaptiveBlockSize("Test", /*defaultBlockSize*/ 1000, /*minObjectCount*/ 100, /*callsPerCandidate*/ 2);
+        UNIT_ASSERT_VALUES_EQUAL(adaptiveBlockSize.GetSelectedBlockSize(), 0);
+
+        // warm-up call is not taken into account
+        adaptiveBlockSize.AddMeasurement(1000, 10000, 100.0);
+
+        // candidates are measured in order: default, then from the smallest to the largest
+        for (int blockSize : {1000, 250, 500, 2000, 4000}) {
+            UNIT_ASSERT_VALUES_EQUAL(adaptiveBlockSize.GetSelectedBlockSize(), 0);
+            const double seconds = (blockSize == 2000) ? 1.0 : 2.0;
+            adaptiveBlockSize.AddMeasurement(blockSize, 10000, seconds);
+            adaptiveBlockSize.AddMeasurement(blockSize, 20000, 2 * seconds);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(adaptiveBlockSize.GetSelectedBlockSize(), 2000);
+
+        {
+            const auto timedCall = adaptiveBlockSize.StartCall(10000);
+            UNIT_ASSERT_VALUES_EQUAL(timedCall.GetBlockSize(), 2000);
+        }
+        {
+            const auto timedCall = adaptiveBlockSize.StartCall(50);
+            UNIT_ASSERT_VALUES_EQUAL(timedCall.GetBlockSize(), 1000);
+        }
+    }
+
+    Y_UNIT_TEST(TestSmallLoopsAreNotMeasured) {
+        TAdaptiveBlockSize adaptiveBlockSize("Test", /*defaultBlockSize*/ 1000, /*minObjectCount*/ 100, /*callsPerCandidate*/ 1);
+        for (auto i = 0; i < 100; ++i) {
+            const auto timedCall = adaptiveBlockSize.StartCall(99);
+            UNIT_ASSERT_VALUES_EQUAL(timedCall.GetBlockSize(), 1000);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(adaptiveBlockSize.GetSelectedBlockSize(), 0);
+
+        // one warm-up call and one call for each of 5 candidates
+        for (auto i = 0; i < 6; ++i) {
+            const auto timedCall = adaptiveBlockSize.StartCall(100);
+            Y_UNUSED(timedCall);
+        }
+        UNIT_ASSERT_VALUES_UNEQUAL(adaptiveBlockSize.GetSelectedBlockSize(), 0);
+    }
+}
@@ -330,6 +330,23 @@ Y_UNIT_TEST_SUITE(TArraySubset) {
         TestGetSubset(v, arraySubsetIndexing, expectedSubset);
     }
 
+    Y_UNIT_TEST(TestGetSubsetOfLargeIndexedSubset) {
+        TVector<int> v(1000);
+        Iota(v.begin(), v.end(), 0);
+
+        NCB::TIndexedSubset<size_t> indices;
+        TVector<int> expectedSubset;
+        for (size_t i : xrange(v.size())) {
+            const size_t srcIdx = (i * 317) % v.size();
+            indices.push_back(srcIdx);
+            expectedSubset.push_back(v[srcIdx]);
+        }
+
+        NCB::TArraySubsetIndexing<size_t> arraySubsetIndexing(std::move(indices));
+
+        TestGetSubset(v, arraySubsetIndexing, expectedSubset);
+    }
+
     Y_UNIT_TEST(TestGetConsecutiveSubsetBegin) {
         UNIT_ASSERT_VALUES_EQUAL(
             NCB::TArraySubsetIndexing<size_t>( NCB::TFullSubset<size_t>(0) ).GetConsecutiveSubsetBegin(),
@@ -85,6 +85,23 @@ Y_UNIT_TEST_SUITE(Compression) {
         }
     };
 
+    Y_UNIT_TEST(Unpack) {
+        for (auto bitsPerKey : {1, 2, 3, 4, 7, 8, 12, 16, 32}) {
+            const TVector<ui32> generatedData = GenerateRandomVector<ui32>(316, bitsPerKey);
+            const TCompressedArray compressedArray = CreateCompressedArray<ui32>(generatedData, bitsPerKey);
+            for (auto offset : {0, 1, 63, 100}) {
+                for (auto count : {0, 1, 5, 200}) {
+                    TVector<ui32> unpacked(count);
+                    compressedArray.Unpack<ui32>(offset, unpacked);
+                    UNIT_ASSERT_VALUES_EQUAL(
+                        unpacked,
+                        TVector<ui32>(generatedData.begin() + offset, generatedData.begin() + offset + count)
+                    );
+                }
+            }
+        }
+    }
+
     Y_UNIT_TEST(EqualityComparison) {
         TestEqualityComparisonOnGenerated<ui8>();
         TestEqualityComparisonOnGenerated<ui16>();
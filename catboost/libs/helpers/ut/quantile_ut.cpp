@@ -3,9 +3,11 @@
 #include <catboost/libs/helpers/quantile.h>
 #include <catboost/private/libs/options/restrictions.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/fwd.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
 
 #include <cfloat>
 
@@ -201,4 +203,32 @@ Y_UNIT_TEST_SUITE(TCalcQuantile) {
         TVector<float> sample =    {0,     1,      2,      3,      4,      5,      6,      7};
         UNIT_ASSERT_DOUBLES_EQUAL(CalcSampleQuantile(sample, weightsHasWeights, 0.52), 4 , 1e-6);
     }
+
+    Y_UNIT_TEST(TCalcQuantileLargeSampleWithRepeatsAndWeights) {
+        const size_t sampleSize = 1000;
+        TVector<float> sample(sampleSize);
+        TVector<float> weights(sampleSize);
+        for (auto i : xrange(sampleSize)) {
+            sample[i] = static_cast<float>((i * 7919) % 97);
+            weights[i] = 0.5f + static_cast<float>((i * 31) % 5);
+        }
+
+        TVector<size_t> order(sampleSize);
+        Iota(order.begin(), order.end(), 0);
+        StableSortBy(order, [&] (size_t idx) { return sample[idx]; });
+        const double totalWeight = Accumulate(weights, 0.0);
+
+        for (double alpha : {0.01, 0.1, 0.25, 0.5, 0.77, 0.9, 0.999, 1.0}) {
+            double sumWeight = 0;
+            float expected = sample[order.back()];
+            for (auto idx : order) {
+                sumWeight += weights[idx];
+                if (sumWeight >= totalWeight * alpha - DBL_EPSILON) {
+                    expected = sample[idx];
+                    break;
+                }
+            }
+            UNIT_ASSERT_DOUBLES_EQUAL(CalcSampleQuantile(sample, weights, alpha), expected, 1e-6);
+        }
+    }
 }
@@ -131,6 +131,7 @@ void AddFileLoggers(
     if (detailedProfile) {
         logger->AddProfileBackend(TIntrusivePtr<ILoggingBackend>(new TProfileLoggingBackend(profileLogFile)));
         logger->AddProfileBackend(TIntrusivePtr<ILoggingBackend>(new TJsonProfileLoggingBackend(profileLogFile + ".json")));
+        logger->AddProfileBackend(TIntrusivePtr<ILoggingBackend>(new TTraceProfileLoggingBackend(profileLogFile + ".trace.json")));
     }
     TString parametersToken = metaJson["parameters"].GetString();
     logger->AddBackend(parametersToken, jsonLoggingBackend);
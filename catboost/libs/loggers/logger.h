@@ -9,6 +9,7 @@
 #include <util/stream/format.h>
 #include <util/generic/hash.h>
 #include <util/generic/ymath.h>
+#include <util/string/builder.h>
 
 
 class IMetricEvalResult {
@@ -289,6 +290,49 @@ private:
     TMap<TString, double> OperationToTimeInAllIterations;
 };
 
+// Chrome trace event format, can be opened in chrome://tracing or Perfetto,
+// each iteration is a span containing spans of its profiled operations
+class TTraceProfileLoggingBackend : public ILoggingBackend {
+public:
+    explicit TTraceProfileLoggingBackend(const TString& fileName)
+        : File(new TOFStream(fileName))
+    {
+        *File << "{\"traceEvents\":[";
+    }
+
+    void OutputProfile(const TProfileResults& profileResults) {
+        WriteEvent(TStringBuilder() << "Iteration " << profileResults.PassedIterations - 1, PassedTime, profileResults.CurrentTime);
+        for (const auto& span : profileResults.OperationSpans) {
+            WriteEvent(span.Name, PassedTime + span.StartTime, span.Duration);
+        }
+        PassedTime += profileResults.CurrentTime;
+    }
+
+    void Flush(const int ) {
+    }
+
+    ~TTraceProfileLoggingBackend() {
+        *File << "\n]}" << Endl;
+    }
+
+private:
+    void WriteEvent(const TString& name, double startTime, double duration) {
+        NJson::TJsonValue event;
+        event["name"] = name;
+        event["ph"] = "X";
+        event["ts"] = startTime * 1e6;
+        event["dur"] = duration * 1e6;
+        event["pid"] = 0;
+        event["tid"] = 0;
+        *File << (IsFirstEvent ? "\n" : ",\n") << event.GetStringRobust();
+        IsFirstEvent = false;
+    }
+
+    THolder<TOFStream> File;
+    double PassedTime = 0;
+    bool IsFirstEvent = true;
+};
+
 
 class TErrorFileLoggingBackend : public ILoggingBackend {
 public:
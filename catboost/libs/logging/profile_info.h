@@ -4,10 +4,19 @@
 
 #include <util/ysaveload.h>
 #include <util/generic/map.h>
+#include <util/generic/vector.h>
 #include <util/stream/file.h>
 #include <util/stream/format.h>
 #include <util/system/hp_timer.h>
 
+// operations of an iteration block in the order they were added,
+// StartTime is relative to the start of the iteration block
+struct TProfileSpan {
+    TString Name;
+    double StartTime;
+    double Duration;
+};
+
 struct TProfileResults {
     TProfileResults(
         double passedTime,
@@ -16,7 +25,8 @@ struct TProfileResults {
         double currentTime = 0,
         int passedIterations = 0,
         TMap<TString, double> operationToTime = {},
-        TMap<TString, double> operationToTimeInAllIterations = {}
+        TMap<TString, double> operationToTimeInAllIterations = {},
+        TVector<TProfileSpan> operationSpans = {}
     )
         : PassedTime(passedTime)
         , RemainingTime(remainingTime)
@@ -25,6 +35,7 @@ struct TProfileResults {
         , PassedIterations(passedIterations)
         , OperationToTime(operationToTime)
         , OperationToTimeInAllIterations(operationToTimeInAllIterations)
+        , OperationSpans(std::move(operationSpans))
     {
     }
 
@@ -35,6 +46,7 @@ struct TProfileResults {
     int PassedIterations;
     TMap<TString, double> OperationToTime;
     TMap<TString, double> OperationToTimeInAllIterations;
+    TVector<TProfileSpan> OperationSpans;
 };
 
 struct TProfileInfoData {
@@ -90,6 +102,7 @@ public:
         CurrentTime = 0;
         Timer.Reset();
         OperationToTime.clear();
+        OperationSpans.clear();
     }
 
     void StartNextIteration() {
@@ -98,6 +111,7 @@ public:
 
     void AddOperation(const TString& operation) {
         double passedTime = Timer.PassedReset();
+        OperationSpans.push_back({operation, CurrentTime, passedTime});
         CurrentTime += passedTime;
         OperationToTime[operation] += passedTime; // operations can be repeated in one iteration
     }
@@ -136,7 +150,8 @@ public:
             CurrentTime,
             ProfileData.PassedIterations,
             OperationToTime,
-            ProfileData.OperationToTimeInAllIterations
+            ProfileData.OperationToTimeInAllIterations,
+            OperationSpans
         };
     }
 
@@ -144,6 +159,7 @@ private:
     static constexpr int MAX_TIME_RATIO = 100;
     TProfileInfoData ProfileData;
     TMap<TString, double> OperationToTime;
+    TVector<TProfileSpan> OperationSpans;
     THPTimer Timer;
     int InitIterations;
     bool IsIterationGood;
@@ -62,10 +62,6 @@ static double SortAndCountInversions(
     return leftCount + rightCount + mergeCount;
 }
 
-static bool CompareSamplesByPrediction(const TSample& left, const TSample& right) {
-    return std::tie(left.Prediction, left.Target) < std::tie(right.Prediction, right.Target);
-}
-
 static bool CompareSamplesByTarget(const TSample& left, const TSample& right) {
     return left.Target < right.Target;
 }
@@ -172,7 +168,9 @@ static double ParallelSortAndCountInversions(
 double CalcAUC(TVector<TSample>* samples, NPar::TLocalExecutor* localExecutor, double* outWeightSum, double* outPairWeightSum) {
     TVector<TSample> aux(samples->begin(), samples->end());
 
-    NCB::ParallelMergeSort(CompareSamplesByPrediction, samples, localExecutor, &aux);
+    // radix sort is stable, so sorting by Target and then by Prediction orders by (Prediction, Target)
+    NCB::ParallelRadixSort([] (const TSample& sample) { return sample.Target; }, samples, localExecutor, &aux);
+    NCB::ParallelRadixSort([] (const TSample& sample) { return sample.Prediction; }, samples, localExecutor, &aux);
 
     double deltaSum = 0;
     double accumulatedEqualPredictionsWeight = 0;
@@ -249,7 +247,12 @@ double CalcBinClassAuc(
         needSwap = true;
     }
     TVector<TBinClassSample> buf(positiveSamples->begin(), positiveSamples->end());
-    NCB::ParallelMergeSort(CompareBinClassSamplesByPrediction, positiveSamples, localExecutor, &buf);
+    NCB::ParallelRadixSort(
+        [] (const TBinClassSample& sample) { return sample.Prediction; },
+        positiveSamples,
+        localExecutor,
+        &buf
+    );
     TVector<ui32> equalPredictionPositions(positiveSamples->size());
     for (ui32 i = positiveSamples->size(); i > 0; --i) {
         equalPredictionPositions[i - 1] = i;
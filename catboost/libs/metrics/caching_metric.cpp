@@ -1057,7 +1057,6 @@ TVector<TMetricHolder> EvalErrorsWithCaching(
     };
 
     TVector<TMetricHolder> errors;
-    errors.reserve(metrics.size());
 
     NPar::TLocalExecutor::TExecRangeParams objectwiseBlockParams(0, objectCount);
     if (!target.empty()) {
@@ -1074,47 +1073,79 @@ TVector<TMetricHolder> EvalErrorsWithCaching(
     TCache nonAdditiveCache;
     TVector<TCache> objectwiseAdditiveCache(objectwiseBlockParams.GetBlockCount());
     TVector<TCache> querywiseAdditiveCache(querywiseBlockParams.GetBlockCount());
-    TVector<TMetricHolder> objectwiseBlockResults(objectwiseBlockParams.GetBlockCount());
-    TVector<TMetricHolder> querywiseBlockResults(querywiseBlockParams.GetBlockCount());
 
+    // additive metrics are evaluated in one parallel pass over blocks, so a block is scanned by all of them
+    // while it is in cache and caching metrics share the block cache (e.g. the confusion matrix)
+    TVector<size_t> objectwiseFusedMetrics;
+    TVector<size_t> querywiseFusedMetrics;
+    errors.resize(metrics.size());
     for (auto i : xrange(metrics.size())) {
         auto metric = metrics[i];
         auto cachingMetric = dynamic_cast<const TCachingMetric*>(metrics[i]);
         auto multiMetric = dynamic_cast<const TMultiRegressionMetric*>(metrics[i]);
+        auto additiveMetric = dynamic_cast<const TAdditiveMetric*>(metrics[i]);
         Y_ASSERT(cachingMetric == nullptr || multiMetric == nullptr);
 
         const bool isObjectwise = metric->GetErrorType() == EErrorType::PerObjectError;
         if (cachingMetric && metric->IsAdditiveMetric()) {
-            const auto blockSize = isObjectwise ? objectwiseBlockParams.GetBlockSize() : querywiseBlockParams.GetBlockSize();
-            const auto blockCount = isObjectwise ? objectwiseBlockParams.GetBlockCount() : querywiseBlockParams.GetBlockCount();
-
-            auto &results = isObjectwise ? objectwiseBlockResults : querywiseBlockResults;
-            auto &cache = isObjectwise ? objectwiseAdditiveCache : querywiseAdditiveCache;
-            const auto end = isObjectwise ? objectCount : queryCount;
-
-            NPar::ParallelFor(*localExecutor, 0, blockCount, [&](auto blockId) {
-                const auto from = blockId * blockSize;
-                const auto to = Min<int>((blockId + 1) * blockSize, end);
-                results[blockId] = calcCaching(cachingMetric, from, to, &cache[blockId]);
-            });
-
-            TMetricHolder error;
-            for (const auto &blockResult : results) {
-                error.Add(blockResult);
-            }
-            errors.push_back(error);
+            (isObjectwise ? objectwiseFusedMetrics : querywiseFusedMetrics).push_back(i);
+        } else if (additiveMetric && isObjectwise && !target.empty() && objectCount > 0) {
+            // same blocks as ParallelEvalMetric would use, so the sums do not change
+            objectwiseFusedMetrics.push_back(i);
         } else {
             const auto end = isObjectwise ? objectCount : queryCount;
             if (cachingMetric) {
-                errors.push_back(calcCaching(cachingMetric, 0, end, &nonAdditiveCache));
+                errors[i] = calcCaching(cachingMetric, 0, end, &nonAdditiveCache);
             } else if (multiMetric) {
-                errors.push_back(calcMultiRegression(multiMetric, 0, end));
+                errors[i] = calcMultiRegression(multiMetric, 0, end);
             } else {
-                errors.push_back(calcNonCaching(metric, 0, end));
+                errors[i] = calcNonCaching(metric, 0, end);
             }
         }
     }
 
+    const auto calcFused = [&](
+        TConstArrayRef<size_t> metricIndices,
+        const NPar::TLocalExecutor::TExecRangeParams& blockParams,
+        int end,
+        TVector<TCache>* cache
+    ) {
+        if (metricIndices.empty()) {
+            return;
+        }
+        for (auto i : metricIndices) {
+            CB_ENSURE(!metrics[i]->NeedTarget() || target.size() == 1, "Metric [" + metrics[i]->GetDescription() + "] requires "
+                      << (target.size() > 1 ? "one-dimensional" : "") <<  "target");
+        }
+        const auto blockSize = blockParams.GetBlockSize();
+        const auto blockCount = blockParams.GetBlockCount();
+        TVector<TVector<TMetricHolder>> results(blockCount, TVector<TMetricHolder>(metricIndices.size()));
+        NPar::ParallelFor(*localExecutor, 0, blockCount, [&](auto blockId) {
+            const auto from = blockId * blockSize;
+            const auto to = Min<int>((blockId + 1) * blockSize, end);
+            for (auto k : xrange(metricIndices.size())) {
+                const auto metric = metrics[metricIndices[k]];
+                if (const auto cachingMetric = dynamic_cast<const TCachingMetric*>(metric)) {
+                    results[blockId][k] = calcCaching(cachingMetric, from, to, &(*cache)[blockId]);
+                } else {
+                    results[blockId][k] = dynamic_cast<const TAdditiveMetric*>(metric)->EvalBlock(
+                        To2DConstArrayRef<double>(approx), To2DConstArrayRef<double>(approxDelta), isExpApprox,
+                        metric->NeedTarget() ? target[0] : TConstArrayRef<float>(), weight, queriesInfo, from, to
+                    );
+                }
+            }
+        });
+        for (auto k : xrange(metricIndices.size())) {
+            TMetricHolder error;
+            for (const auto& blockResults : results) {
+                error.Add(blockResults[k]);
+            }
+            errors[metricIndices[k]] = error;
+        }
+    };
+    calcFused(objectwiseFusedMetrics, objectwiseBlockParams, objectCount, &objectwiseAdditiveCache);
+    calcFused(querywiseFusedMetrics, querywiseBlockParams, queryCount, &querywiseAdditiveCache);
+
     return errors;
 }
 
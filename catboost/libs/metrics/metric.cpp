@@ -17,6 +17,7 @@
 
 #include <catboost/libs/helpers/dispatch_generic_lambda.h>
 #include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/parallel_sort/parallel_sort.h>
 #include <catboost/libs/helpers/short_vector_ops.h>
 #include <catboost/libs/helpers/vector_helpers.h>
 #include <catboost/libs/logging/logging.h>
@@ -128,56 +129,6 @@ namespace {
         }
     };
 
-    struct TAdditiveMetric: public TMetric {
-        explicit TAdditiveMetric(ELossFunction lossFunction, const TLossParams& descriptionParams)
-            : TMetric(lossFunction, descriptionParams) {}
-        TMetricHolder Eval(
-            const TVector<TVector<double>>& approx,
-            TConstArrayRef<float> target,
-            TConstArrayRef<float> weight,
-            TConstArrayRef<TQueryInfo> queriesInfo,
-            int begin,
-            int end,
-            NPar::TLocalExecutor& executor
-        ) const final {
-            return Eval(To2DConstArrayRef<double>(approx), /*approxDelta*/{}, /*isExpApprox*/false, target, weight, queriesInfo, begin, end, executor);
-        }
-
-        TMetricHolder Eval(
-            const TConstArrayRef<TConstArrayRef<double>> approx,
-            const TConstArrayRef<TConstArrayRef<double>> approxDelta,
-            bool isExpApprox,
-            TConstArrayRef<float> target,
-            TConstArrayRef<float> weight,
-            TConstArrayRef<TQueryInfo> queriesInfo,
-            int begin,
-            int end,
-            NPar::TLocalExecutor& executor
-        ) const final {
-            const auto evalMetric = [&](int from, int to) {
-                return EvalSingleThread(
-                    approx, approxDelta, isExpApprox, target, UseWeights.IsIgnored() || UseWeights ? weight : TVector<float>{}, queriesInfo, from, to
-                );
-            };
-
-            return ParallelEvalMetric(evalMetric, GetMinBlockSize(end - begin), begin, end, executor);
-        }
-
-        virtual TMetricHolder EvalSingleThread(
-            const TConstArrayRef<TConstArrayRef<double>> approx,
-            const TConstArrayRef<TConstArrayRef<double>> approxDelta,
-            bool isExpApprox,
-            TConstArrayRef<float> target,
-            TConstArrayRef<float> weight,
-            TConstArrayRef<TQueryInfo> queriesInfo,
-            int begin,
-            int end
-        ) const = 0;
-        bool IsAdditiveMetric() const final {
-            return true;
-        }
-    };
-
     struct TNonAdditiveMetric: public TMetric {
         explicit TNonAdditiveMetric(ELossFunction lossFunction, const TLossParams& descriptionParams)
             : TMetric(lossFunction, descriptionParams) {}
@@ -2540,6 +2491,34 @@ namespace {
         EAucType Type;
         TMaybe<TVector<TVector<double>>> MisclassCostMatrix = Nothing();
     };
+
+    /* Approximate classic AUC: positive and negative weights are accumulated in BinCount
+     * equal-width bins of predicted probability, so stats of different blocks could be summed.
+     * Only pairs with both objects in the same bin are affected, they are counted as ties.
+     */
+    struct THistogramAUCMetric final: public TAdditiveMetric {
+        explicit THistogramAUCMetric(const TLossParams& params, ui32 binCount)
+            : TAdditiveMetric(ELossFunction::AUC, params)
+            , BinCount(binCount) {
+            UseWeights.SetDefaultValue(false);
+        }
+
+        TMetricHolder EvalSingleThread(
+            const TConstArrayRef<TConstArrayRef<double>> approx,
+            const TConstArrayRef<TConstArrayRef<double>> approxDelta,
+            bool isExpApprox,
+            TConstArrayRef<float> target,
+            TConstArrayRef<float> weight,
+            TConstArrayRef<TQueryInfo> queriesInfo,
+            int begin,
+            int end
+        ) const override;
+        double GetFinalError(const TMetricHolder& error) const override;
+        void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
+
+    private:
+        const ui32 BinCount;
+    };
 }
 
 TVector<THolder<IMetric>> TAUCMetric::Create(const TMetricConfig& config) {
@@ -2556,8 +2535,17 @@ TVector<THolder<IMetric>> TAUCMetric::Create(const TMetricConfig& config) {
                       "AUC type \"" << aucType << "\" isn't a multiclass AUC type");
         }
     }
+    if (config.GetParamsMap().contains("histogram_bins")) {
+        CB_ENSURE(aucType == EAucType::Classic, "AUC parameter histogram_bins is supported only for Classic AUC");
+    }
     switch (aucType) {
         case EAucType::Classic: {
+            config.validParams->insert("histogram_bins");
+            if (config.GetParamsMap().contains("histogram_bins")) {
+                const ui32 binCount = FromString<ui32>(config.GetParamsMap().at("histogram_bins"));
+                CB_ENSURE(binCount > 0, "AUC parameter histogram_bins should be positive");
+                return AsVector(MakeHolder<THistogramAUCMetric>(config.params, binCount));
+            }
             return AsVector(MakeHolder<TAUCMetric>(config.params, EAucType::Classic));
             break;
         }
@@ -2721,6 +2709,55 @@ void TAUCMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
     *valueType = EMetricBestValue::Max;
 }
 
+TMetricHolder THistogramAUCMetric::EvalSingleThread(
+    const TConstArrayRef<TConstArrayRef<double>> approx,
+    const TConstArrayRef<TConstArrayRef<double>> approxDelta,
+    bool isExpApprox,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weight,
+    TConstArrayRef<TQueryInfo> /*queriesInfo*/,
+    int begin,
+    int end
+) const {
+    Y_ASSERT(!isExpApprox);
+    Y_ASSERT(approx.size() == 1);
+    Y_ASSERT(approx[0].size() == target.size());
+
+    // [bin] positive weight, then [bin] negative weight
+    TMetricHolder error(2 * BinCount);
+    for (int i : xrange(begin, end)) {
+        const double currentApprox = approx[0][i] + (approxDelta.empty() ? 0.0 : approxDelta[0][i]);
+        const double probability = 1.0 / (1.0 + exp(-currentApprox));
+        const ui32 bin = Min<ui32>(BinCount - 1, static_cast<ui32>(probability * BinCount));
+        const float currentTarget = target[i];
+        CB_ENSURE(0 <= currentTarget && currentTarget <= 1, "All target values should be in the segment [0, 1], for Ranking AUC please use type=Ranking.");
+        const double w = weight.empty() ? 1.0 : weight[i];
+        error.Stats[bin] += currentTarget * w;
+        error.Stats[BinCount + bin] += (1 - currentTarget) * w;
+    }
+    return error;
+}
+
+double THistogramAUCMetric::GetFinalError(const TMetricHolder& error) const {
+    Y_ASSERT(error.Stats.size() == 2 * BinCount);
+    double positiveWeight = 0;
+    double negativeWeight = 0;
+    double correctPairWeight = 0;
+    for (ui32 bin : xrange(BinCount)) {
+        const double binPositiveWeight = error.Stats[bin];
+        const double binNegativeWeight = error.Stats[BinCount + bin];
+        correctPairWeight += binPositiveWeight * (negativeWeight + 0.5 * binNegativeWeight);
+        positiveWeight += binPositiveWeight;
+        negativeWeight += binNegativeWeight;
+    }
+    const double pairWeight = positiveWeight * negativeWeight;
+    return pairWeight > 0 ? correctPairWeight / pairWeight : 0;
+}
+
+void THistogramAUCMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
+    *valueType = EMetricBestValue::Max;
+}
+
 /* Normalized Gini metric */
 
 namespace {
@@ -3603,7 +3640,7 @@ TMetricHolder TPRAUCMetric::Eval(
     TConstArrayRef<TQueryInfo> /*queriesInfo*/,
     int begin,
     int end,
-    NPar::TLocalExecutor& /*executor*/
+    NPar::TLocalExecutor& executor
 ) const {
     Y_ASSERT(!isExpApprox);
     Y_ASSERT((approx.size() > 1) == IsMultiClass);
@@ -3635,7 +3672,11 @@ TMetricHolder TPRAUCMetric::Eval(
         sortedSamples.push_back({realApprox(i), target[i], realWeight(i)});
     }
 
-    std::sort(sortedSamples.begin(), sortedSamples.end(), [](const Sample& l, const Sample& r) {return l.approx < r.approx;});
+    NCB::ParallelRadixSort(
+        [](const Sample& sample) { return sample.approx; },
+        &sortedSamples,
+        &executor
+    );
 
     int curNegCount = 0;
     double curTp = 0;
@@ -266,6 +266,70 @@ static inline TMetricHolder ParallelEvalMetric(TEvalFunction eval, int minBlockS
 
 }
 
+struct TAdditiveMetric: public TMetric {
+    explicit TAdditiveMetric(ELossFunction lossFunction, const TLossParams& descriptionParams)
+        : TMetric(lossFunction, descriptionParams) {}
+    TMetricHolder Eval(
+        const TVector<TVector<double>>& approx,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        int begin,
+        int end,
+        NPar::TLocalExecutor& executor
+    ) const final {
+        return Eval(To2DConstArrayRef<double>(approx), /*approxDelta*/{}, /*isExpApprox*/false, target, weight, queriesInfo, begin, end, executor);
+    }
+
+    TMetricHolder Eval(
+        const TConstArrayRef<TConstArrayRef<double>> approx,
+        const TConstArrayRef<TConstArrayRef<double>> approxDelta,
+        bool isExpApprox,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        int begin,
+        int end,
+        NPar::TLocalExecutor& executor
+    ) const final {
+        const auto evalMetric = [&](int from, int to) {
+            return EvalBlock(approx, approxDelta, isExpApprox, target, weight, queriesInfo, from, to);
+        };
+
+        return ParallelEvalMetric(evalMetric, GetMinBlockSize(end - begin), begin, end, executor);
+    }
+
+    // evaluates [begin, end) in the calling thread, lets several metrics share one parallel pass over blocks
+    TMetricHolder EvalBlock(
+        const TConstArrayRef<TConstArrayRef<double>> approx,
+        const TConstArrayRef<TConstArrayRef<double>> approxDelta,
+        bool isExpApprox,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        int begin,
+        int end
+    ) const {
+        return EvalSingleThread(
+            approx, approxDelta, isExpApprox, target, UseWeights.IsIgnored() || UseWeights ? weight : TVector<float>{}, queriesInfo, begin, end
+        );
+    }
+
+    virtual TMetricHolder EvalSingleThread(
+        const TConstArrayRef<TConstArrayRef<double>> approx,
+        const TConstArrayRef<TConstArrayRef<double>> approxDelta,
+        bool isExpApprox,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        int begin,
+        int end
+    ) const = 0;
+    bool IsAdditiveMetric() const final {
+        return true;
+    }
+};
+
 THolder<IMetric> MakeCtrFactorMetric(const TLossParams& params);
 
 THolder<IMetric> MakeBinClassAucMetric(const TLossParams& params);
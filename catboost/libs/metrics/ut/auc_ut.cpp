@@ -1,4 +1,5 @@
 #include <catboost/libs/metrics/auc.h>
+#include <catboost/libs/metrics/metric.h>
 #include <catboost/libs/metrics/metric_holder.h>
 #include <catboost/libs/helpers/cpu_random.h>
 
@@ -474,4 +475,38 @@ Y_UNIT_TEST_SUITE(AUCMetricTests) {
         TestBinClassAucRandom(2000, 1000, false, EPS);
         TestBinClassAucRandom(2000, 2000, false, EPS);
     }
+
+    Y_UNIT_TEST(HistogramAucTest) {
+        TRandom rnd(239);
+        const ui32 size = 600;
+        TVector<TVector<double>> approx(1);
+        TVector<float> target;
+        TVector<float> weight;
+        for (ui32 i = 0; i < size; ++i) {
+            approx[0].push_back(-3.0 + 0.01 * i);
+            target.push_back(rnd(3) == 0 ? 1 : 0);
+            weight.push_back(1);
+        }
+        Shuffle(approx[0].begin(), approx[0].end(), rnd);
+
+        NPar::TLocalExecutor executor;
+        const auto exactMetric = std::move(CreateMetric(ELossFunction::AUC, TLossParams(), /*approxDimension=*/1)[0]);
+        const double exactAuc = exactMetric->GetFinalError(exactMetric->Eval(approx, target, weight, {}, 0, size, executor));
+
+        const auto params = TLossParams::FromVector({{"histogram_bins", "100000"}});
+        const auto metric = std::move(CreateMetric(ELossFunction::AUC, params, /*approxDimension=*/1)[0]);
+        UNIT_ASSERT(metric->IsAdditiveMetric());
+
+        const TMetricHolder score = metric->Eval(approx, target, weight, {}, 0, size, executor);
+        UNIT_ASSERT_DOUBLES_EQUAL(metric->GetFinalError(score), exactAuc, 1e-6);
+
+        TMetricHolder mergedScore = metric->Eval(approx, target, weight, {}, 0, size / 3, executor);
+        mergedScore.Add(metric->Eval(approx, target, weight, {}, size / 3, size, executor));
+        UNIT_ASSERT_DOUBLES_EQUAL(metric->GetFinalError(mergedScore), metric->GetFinalError(score), 1e-9);
+
+        const auto coarseParams = TLossParams::FromVector({{"histogram_bins", "1"}});
+        const auto coarseMetric = std::move(CreateMetric(ELossFunction::AUC, coarseParams, /*approxDimension=*/1)[0]);
+        const double coarseAuc = coarseMetric->GetFinalError(coarseMetric->Eval(approx, target, weight, {}, 0, size, executor));
+        UNIT_ASSERT_DOUBLES_EQUAL(coarseAuc, 0.5, 1e-9);
+    }
 }
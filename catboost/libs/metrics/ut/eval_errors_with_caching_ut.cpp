@@ -0,0 +1,38 @@
+#include <library/cpp/testing/unittest/registar.h>
+#include <catboost/libs/metrics/caching_metric.h>
+#include <catboost/libs/metrics/metric.h>
+#include <catboost/libs/metrics/metric_holder.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+Y_UNIT_TEST_SUITE(EvalErrorsWithCachingTest) {
+Y_UNIT_TEST(FusedPassMatchesSeparateEval) {
+    const int objectCount = 50000;
+    TFastRng64 rng(0);
+    TVector<TVector<double>> approx(1, TVector<double>(objectCount));
+    TVector<float> target(objectCount);
+    TVector<float> weight(objectCount);
+    for (auto i : xrange(objectCount)) {
+        approx[0][i] = rng.GenRandReal1() * 4 - 2;
+        target[i] = rng.GenRandReal1() < 0.5 ? 0 : 1;
+        weight[i] = rng.GenRandReal1();
+    }
+
+    NPar::TLocalExecutor executor;
+    executor.RunAdditionalThreads(3);
+
+    const auto metrics = CreateMetricsFromDescription({"RMSE", "MAE", "Logloss", "Accuracy", "Precision", "Recall"}, 1);
+    TVector<const IMetric*> metricPtrs;
+    for (const auto& metric : metrics) {
+        metricPtrs.push_back(metric.Get());
+    }
+    const auto errors = EvalErrorsWithCaching(approx, /*approxDelta*/{}, /*isExpApprox*/false, target, weight, {}, metricPtrs, &executor);
+
+    UNIT_ASSERT_VALUES_EQUAL(errors.size(), metrics.size());
+    for (auto i : xrange(metrics.size())) {
+        const TMetricHolder separate = metrics[i]->Eval(approx, target, weight, {}, 0, objectCount, executor);
+        UNIT_ASSERT_DOUBLES_EQUAL(metrics[i]->GetFinalError(errors[i]), metrics[i]->GetFinalError(separate), 1e-9);
+    }
+}
+}
@@ -0,0 +1,112 @@
+#include "ensemble_evaluator.h"
+
+#include "evaluator.h"
+
+#include <catboost/libs/cat_feature/cat_feature.h>
+#include <catboost/libs/model/eval_processing.h>
+
+#include <util/generic/xrange.h>
+
+namespace NCB::NModelEvaluation {
+
+    TModelEnsembleEvaluator::TModelEnsembleEvaluator(
+        TConstArrayRef<const TFullModel*> models,
+        ECtrTableMergePolicy ctrMergePolicy
+    ) {
+        CB_ENSURE(!models.empty(), "empty model vector unexpected");
+        ModelTreeOffsets.push_back(0);
+        for (const auto* model : models) {
+            Y_ASSERT(model != nullptr);
+            ModelTreeOffsets.push_back(ModelTreeOffsets.back() + model->GetTreeCount());
+            ModelBiases.push_back(model->GetScaleAndBias().Bias);
+        }
+        MergedModel = SumModels(
+            TVector<const TFullModel*>(models.begin(), models.end()),
+            TVector<double>(models.size(), 1.0),
+            ctrMergePolicy
+        );
+        CB_ENSURE_INTERNAL(
+            MergedModel.GetTreeCount() == ModelTreeOffsets.back(),
+            "Merged model tree count mismatch"
+        );
+    }
+
+    void TModelEnsembleEvaluator::CalcFlat(
+        TConstArrayRef<TConstArrayRef<float>> features,
+        TArrayRef<TArrayRef<double>> results,
+        EPredictionType predictionType,
+        const TFeatureLayout* featureInfo
+    ) const {
+        CB_ENSURE(
+            results.size() == GetModelCount(),
+            "Results count " << results.size() << " doesn't match model count " << GetModelCount()
+        );
+        const TModelTrees& trees = *MergedModel.ModelTrees;
+        const size_t docCount = features.size();
+        const size_t dimension = trees.GetDimensionsCount();
+        const size_t expectedFlatVecSize = trees.GetFlatFeatureVectorExpectedSize();
+        for (const auto& flatFeaturesVec : features) {
+            CB_ENSURE(
+                flatFeaturesVec.size() >= expectedFlatVecSize,
+                "insufficient flat features vector size: " << flatFeaturesVec.size() << " expected: " << expectedFlatVecSize
+            );
+        }
+        if (docCount == 0) {
+            return;
+        }
+        const size_t blockSize = Min(GetDefaultEvaluationBlockSize(trees), docCount);
+        auto calcTrees = GetCalcTreesFunction(trees, blockSize);
+        TVector<TEvalResultProcessor> resultProcessors;
+        resultProcessors.reserve(results.size());
+        for (auto modelIdx : xrange(results.size())) {
+            resultProcessors.emplace_back(
+                docCount,
+                results[modelIdx],
+                predictionType,
+                TScaleAndBias{1.0, ModelBiases[modelIdx]},
+                dimension,
+                blockSize
+            );
+        }
+        TEvaluationScratch* scratch = GetThreadLocalEvaluationScratch();
+        const auto indexesVec = TEvaluationScratch::GetBuffer(&scratch->Indexes, blockSize);
+        ui32 blockId = 0;
+        ProcessDocsInBlocks(
+            trees,
+            MergedModel.CtrProvider,
+            TIntrusivePtr<TTextProcessingCollection>(),
+            [&features](TFeaturePosition position, size_t index) -> float {
+                return features[index][position.FlatIndex];
+            },
+            [&features](TFeaturePosition position, size_t index) -> int {
+                return ConvertFloatCatFeatureToIntHash(features[index][position.FlatIndex]);
+            },
+            [](TFeaturePosition position, size_t index) -> TStringBuf {
+                Y_UNUSED(position, index);
+                CB_ENSURE(false, "Text features are not supported by ensemble evaluator");
+            },
+            docCount,
+            blockSize,
+            [&] (size_t docCountInBlock, const TCPUEvaluatorQuantizedData* quantizedData) {
+                for (auto modelIdx : xrange(resultProcessors.size())) {
+                    auto& resultProcessor = resultProcessors[modelIdx];
+                    auto blockResultsView = resultProcessor.GetViewForRawEvaluation(blockId);
+                    Fill(blockResultsView.begin(), blockResultsView.begin() + docCountInBlock * dimension, 0.0);
+                    calcTrees(
+                        trees,
+                        quantizedData,
+                        docCountInBlock,
+                        docCount == 1 ? nullptr : indexesVec.data(),
+                        ModelTreeOffsets[modelIdx],
+                        ModelTreeOffsets[modelIdx + 1],
+                        blockResultsView.data()
+                    );
+                    resultProcessor.PostprocessBlock(blockId, /*startTree*/ 0);
+                }
+                ++blockId;
+            },
+            featureInfo,
+            scratch
+        );
+    }
+}
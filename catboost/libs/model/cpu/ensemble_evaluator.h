@@ -0,0 +1,48 @@
+#pragma once
+
+#include <catboost/libs/model/model.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+
+namespace NCB::NModelEvaluation {
+
+    /**
+     * Evaluates several models on the same objects with a single quantization pass per block.
+     * Models are merged into one ensemble with unified feature borders and CTR tables (see SumModels), each
+     *  block of objects is binarized once and then every model is evaluated on its own range of merged trees.
+     * Only oblivious models without text features and with the same dimensions count are supported.
+     */
+    class TModelEnsembleEvaluator {
+    public:
+        explicit TModelEnsembleEvaluator(
+            TConstArrayRef<const TFullModel*> models,
+            ECtrTableMergePolicy ctrMergePolicy = ECtrTableMergePolicy::IntersectingCountersAverage);
+
+        size_t GetModelCount() const {
+            return ModelTreeOffsets.size() - 1;
+        }
+
+        size_t GetDimensionsCount() const {
+            return MergedModel.GetDimensionsCount();
+        }
+
+        /**
+         * @param features flat feature vectors of objects
+         * @param[out] results results[modelIdx] holds predictions of model modelIdx, layout: [docId][dimension]
+         */
+        void CalcFlat(
+            TConstArrayRef<TConstArrayRef<float>> features,
+            TArrayRef<TArrayRef<double>> results,
+            EPredictionType predictionType = EPredictionType::RawFormulaVal,
+            const TFeatureLayout* featureInfo = nullptr
+        ) const;
+
+    private:
+        TFullModel MergedModel;
+        // trees of model modelIdx are [ModelTreeOffsets[modelIdx], ModelTreeOffsets[modelIdx + 1]) in MergedModel
+        TVector<size_t> ModelTreeOffsets;
+        // scales are folded into merged leaf values
+        TVector<double> ModelBiases;
+    };
+}
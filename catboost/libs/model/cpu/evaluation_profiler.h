@@ -0,0 +1,70 @@
+#pragma once
+
+#include <catboost/libs/model/evaluation_interface.h>
+
+#include <util/system/types.h>
+
+#include <atomic>
+#include <chrono>
+
+namespace NCB::NModelEvaluation {
+
+    /**
+     * Thread safe accumulator of evaluation phases statistics, one instance may be shared by concurrent calls
+     */
+    class TEvaluationProfiler {
+    public:
+        enum EPhase {
+            Binarization,
+            Ctrs,
+            TextFeatures,
+            Trees,
+            PhaseCount
+        };
+
+        using TClock = std::chrono::steady_clock;
+
+    public:
+        static TClock::time_point Now() {
+            return TClock::now();
+        }
+
+        static ui64 NanosecondsSince(TClock::time_point start) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(TClock::now() - start).count();
+        }
+
+        void Add(EPhase phase, ui64 nanoseconds, ui64 docCount, ui64 treeCount = 0) {
+            auto& counters = Counters[phase];
+            counters.Nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+            counters.DocCount.fetch_add(docCount, std::memory_order_relaxed);
+            counters.TreeCount.fetch_add(treeCount, std::memory_order_relaxed);
+        }
+
+        TEvaluationProfile GetProfile() const {
+            TEvaluationProfile profile;
+            profile.Binarization = Counters[Binarization].Get();
+            profile.Ctrs = Counters[Ctrs].Get();
+            profile.TextFeatures = Counters[TextFeatures].Get();
+            profile.Trees = Counters[Trees].Get();
+            return profile;
+        }
+
+    private:
+        struct TPhaseCounters {
+            std::atomic<ui64> Nanoseconds = 0;
+            std::atomic<ui64> DocCount = 0;
+            std::atomic<ui64> TreeCount = 0;
+
+            TEvaluationPhaseStats Get() const {
+                TEvaluationPhaseStats stats;
+                stats.Nanoseconds = Nanoseconds.load(std::memory_order_relaxed);
+                stats.DocCount = DocCount.load(std::memory_order_relaxed);
+                stats.TreeCount = TreeCount.load(std::memory_order_relaxed);
+                return stats;
+            }
+        };
+
+    private:
+        TPhaseCounters Counters[PhaseCount];
+    };
+}
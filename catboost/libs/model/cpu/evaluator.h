@@ -9,6 +9,7 @@
 #include <util/system/platform.h>
 #include <util/system/types.h>
 #include <util/system/yassert.h>
+#include <util/thread/singleton.h>
 
 #include <algorithm>
 #include <functional>
@@ -29,10 +30,90 @@ namespace NCB::NModelEvaluation {
         double* __restrict results)>;
 
 
+    /**
+     * @param useSharedSplits evaluate each unique split of oblivious model once per block instead of once per tree,
+     *  pays off for large ensembles where the same splits are used by many trees
+     */
     TTreeCalcFunction GetCalcTreesFunction(
         const TModelTrees& trees,
         size_t docCountInBlock,
-        bool calcIndexesOnly = false);
+        bool calcIndexesOnly = false,
+        bool useSharedSplits = false);
+
+    /**
+     * Leaf values of oblivious single dimension model are taken from floatLeafValues (same layout as
+     *  TModelTrees::GetLeafValues) and are summed in float within each block, results stay double.
+     * floatLeafValues should outlive the returned function.
+     * @return empty function if model or block size are not supported in this mode
+     */
+    TTreeCalcFunction GetCalcTreesFloatLeavesFunction(
+        const TModelTrees& trees,
+        size_t docCountInBlock,
+        TConstArrayRef<float> floatLeafValues);
+
+    /**
+     * Upper bound of absolute difference between predictions with float and double leaf values. Float rounding
+     *  of leaf values and float summation over treeCount trees is bounded by
+     *  gamma(treeCount) * sum of per-tree maximal absolute leaf values, gamma(n) = n * u / (1 - n * u), u = 2^-24.
+     */
+    double GetFloatLeafValuesErrorBound(const TModelTrees& trees);
+
+    //! Count of consecutive trees sharing one scale in TQuantizedLeafValues, int32 block sums can't overflow
+    constexpr size_t QUANTIZED_LEAVES_TREE_RANGE_SIZE = 1024;
+
+    /**
+     * Leaf values of oblivious single dimension model stored as i16 (same layout as TModelTrees::GetLeafValues,
+     *  padded with one zero for vector gathers), leaf value is Values[i] * TreeRangeScales[treeId / QUANTIZED_LEAVES_TREE_RANGE_SIZE].
+     */
+    struct TQuantizedLeafValues {
+        TVector<i16> Values;
+        TVector<double> TreeRangeScales;
+        //! Upper bound of absolute difference between predictions with quantized and double leaf values
+        double ErrorBound = 0;
+    };
+
+    /**
+     * Quantizes leaf values of oblivious single dimension model.
+     * Throws if error bound of predictions exceeds maxAbsoluteError.
+     */
+    TQuantizedLeafValues QuantizeLeafValues(const TModelTrees& trees, double maxAbsoluteError);
+
+    /**
+     * Leaf values are taken from quantizedLeafValues and are summed in int32 within each block and tree range,
+     *  results stay double. quantizedLeafValues should outlive the returned function.
+     * @return empty function if model or block size are not supported in this mode
+     */
+    TTreeCalcFunction GetCalcTreesQuantizedLeavesFunction(
+        const TModelTrees& trees,
+        size_t docCountInBlock,
+        const TQuantizedLeafValues& quantizedLeafValues);
+
+    /**
+     * Reusable buffers for blocked evaluation. Buffers never shrink, so steady-state evaluation of similar
+     *  batches does no heap allocations.
+     */
+    class TEvaluationScratch {
+    public:
+        template <typename T>
+        static TArrayRef<T> GetBuffer(TVector<T>* holder, size_t size) {
+            if (holder->size() < size) {
+                holder->yresize(size);
+            }
+            return TArrayRef<T>(holder->data(), size);
+        }
+
+    public:
+        TVector<ui8> BinFeatures;
+        TVector<ui32> TransposedHash;
+        TVector<float> Ctrs;
+        TVector<float> EstimatedFeatures;
+        TVector<TCalcerIndexType> Indexes; // not used by ProcessDocsInBlocks, left for callers
+        TVector<ui8> SplitConditions; // used by tree calcers
+    };
+
+    inline TEvaluationScratch* GetThreadLocalEvaluationScratch() {
+        return FastTlsSingleton<TEvaluationScratch>();
+    }
 
     template <class X>
     inline X* GetAligned(X* val) {
@@ -54,7 +135,9 @@ namespace NCB::NModelEvaluation {
         size_t docCount,
         size_t blockSize,
         TFunctor callback,
-        const NCB::NModelEvaluation::TFeatureLayout* featureInfo
+        const NCB::NModelEvaluation::TFeatureLayout* featureInfo,
+        TEvaluationScratch* scratch = nullptr,
+        TEvaluationProfiler* profiler = nullptr
     ) {
         ProcessDocsInBlocks(
             trees,
@@ -72,7 +155,9 @@ namespace NCB::NModelEvaluation {
             docCount,
             blockSize,
             callback,
-            featureInfo
+            featureInfo,
+            scratch,
+            profiler
         );
     }
 
@@ -92,8 +177,14 @@ namespace NCB::NModelEvaluation {
         size_t docCount,
         size_t blockSize,
         TFunctor callback,
-        const NCB::NModelEvaluation::TFeatureLayout* featureInfo
+        const NCB::NModelEvaluation::TFeatureLayout* featureInfo,
+        TEvaluationScratch* scratch = nullptr,
+        TEvaluationProfiler* profiler = nullptr
     ) {
+        TEvaluationScratch localScratch;
+        if (!scratch) {
+            scratch = &localScratch;
+        }
         const size_t binSlots = blockSize * trees.GetEffectiveBinaryFeaturesBucketsCount();
 
         TCPUEvaluatorQuantizedData quantizedData;
@@ -101,17 +192,21 @@ namespace NCB::NModelEvaluation {
             quantizedData.QuantizedData = NCB::TMaybeOwningArrayHolder<ui8>::CreateNonOwning(
                 MakeArrayRef(GetAligned((ui8*)(alloca(binSlots + 0x20))), binSlots));
         } else {
-            TVector<ui8> binFeaturesHolder;
-            binFeaturesHolder.yresize(binSlots);
-            quantizedData.QuantizedData = NCB::TMaybeOwningArrayHolder<ui8>::CreateOwning(std::move(binFeaturesHolder));
+            quantizedData.QuantizedData = NCB::TMaybeOwningArrayHolder<ui8>::CreateNonOwning(
+                TEvaluationScratch::GetBuffer(&scratch->BinFeatures, binSlots));
         }
 
-        TVector<ui32> transposedHash(blockSize * trees.GetUsedCatFeaturesCount());
-        TVector<float> ctrs(trees.GetUsedModelCtrs().size() * blockSize);
-        TVector<float> estimatedFeatures;
+        // all buffers are fully overwritten by BinarizeFeatures for each block
+        const auto transposedHash = TEvaluationScratch::GetBuffer(
+            &scratch->TransposedHash,
+            blockSize * trees.GetUsedCatFeaturesCount());
+        const auto ctrs = TEvaluationScratch::GetBuffer(&scratch->Ctrs, trees.GetUsedModelCtrs().size() * blockSize);
+        TArrayRef<float> estimatedFeatures;
         if (textProcessingCollection) {
             // TODO(d-kruchinin): replace to GetUsedEstimatedFeatures.size() after creation TrimFeatures
-            estimatedFeatures = TVector<float>(textProcessingCollection->TotalNumberOfOutputFeatures() * blockSize);
+            estimatedFeatures = TEvaluationScratch::GetBuffer(
+                &scratch->EstimatedFeatures,
+                textProcessingCollection->TotalNumberOfOutputFeatures() * blockSize);
         }
 
         for (size_t blockStart = 0; blockStart < docCount; blockStart += blockSize) {
@@ -129,7 +224,8 @@ namespace NCB::NModelEvaluation {
                 transposedHash,
                 ctrs,
                 estimatedFeatures,
-                featureInfo
+                featureInfo,
+                profiler
             );
             callback(docCountInBlock, &quantizedData);
         }
@@ -162,7 +258,8 @@ namespace NCB::NModelEvaluation {
         size_t treeStart,
         size_t treeEnd,
         TArrayRef<TCalcerIndexType> treeLeafIndexes,
-        const NCB::NModelEvaluation::TFeatureLayout* featureInfo
+        const NCB::NModelEvaluation::TFeatureLayout* featureInfo,
+        size_t maxBlockSize = FORMULA_EVALUATION_BLOCK_SIZE
     ) {
         Y_ASSERT(treeEnd >= treeStart);
         const size_t treeCount = treeEnd - treeStart;
@@ -175,10 +272,11 @@ namespace NCB::NModelEvaluation {
             "Leaf indexes calculation is not implemented for models with text features"
         );
         std::fill(treeLeafIndexes.begin(), treeLeafIndexes.end(), 0);
-        const size_t blockSize = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount);
+        const size_t blockSize = Min(maxBlockSize, docCount);
         TCalcerIndexType* indexesWritePtr = treeLeafIndexes.data();
 
         auto calcTrees = GetCalcTreesFunction(trees, blockSize, true);
+        TEvaluationScratch* scratch = GetThreadLocalEvaluationScratch();
 
         if (docCount == 1) {
             ProcessDocsInBlocks(
@@ -194,12 +292,14 @@ namespace NCB::NModelEvaluation {
                         nullptr
                     );
                 },
-                featureInfo
+                featureInfo,
+                scratch
             );
             return;
         }
-        TVector<TCalcerIndexType> tmpLeafIndexHolder(blockSize * treeCount);
-        TCalcerIndexType* transposedLeafIndexesPtr = tmpLeafIndexHolder.data();
+        TCalcerIndexType* transposedLeafIndexesPtr = TEvaluationScratch::GetBuffer(
+            &scratch->Indexes,
+            blockSize * treeCount).data();
         ProcessDocsInBlocks(
             trees,
             ctrProvider,
@@ -226,7 +326,8 @@ namespace NCB::NModelEvaluation {
                 );
                 indexesWritePtr += indexCountInBlock;
             },
-            featureInfo
+            featureInfo,
+            scratch
         );
     }
 }
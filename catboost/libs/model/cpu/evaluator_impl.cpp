@@ -3,12 +3,37 @@
 #include <library/cpp/sse/sse.h>
 
 #include <util/generic/algorithm.h>
+#include <util/generic/bitops.h>
+#include <util/generic/ymath.h>
 #include <util/stream/format.h>
 #include <util/system/compiler.h>
+#include <util/system/cpu_id.h>
 
+#include <cmath>
 #include <cstring>
+#include <limits>
 
 namespace NCB::NModelEvaluation {
+#if defined(_sse3_) && (defined(_x86_64_) || defined(_i386_))
+    #define CB_EVALUATOR_AVX2_DISPATCH
+    void CalcIndexesAvx2(
+        bool needXorMask,
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        ui8* __restrict indexesVec,
+        const TRepackedBin* __restrict treeSplitsCurPtr,
+        int curTreeSize);
+    void AddFloatLeafValuesAvx2(
+        size_t docCountInBlock,
+        const float* __restrict treeLeafPtr,
+        const ui8* __restrict indexesPtr,
+        float* __restrict writePtr);
+    void AddQuantizedLeafValuesAvx2(
+        size_t docCountInBlock,
+        const i16* __restrict treeLeafPtr,
+        const ui8* __restrict indexesPtr,
+        i32* __restrict writePtr);
+#endif
 
     constexpr size_t SSE_BLOCK_SIZE = 16;
     static_assert(SSE_BLOCK_SIZE * 8 == FORMULA_EVALUATION_BLOCK_SIZE);
@@ -145,6 +170,23 @@ namespace NCB::NModelEvaluation {
         }
     }
 
+    template <bool NeedXorMask, size_t SSEBlockCount, bool UseAvx2>
+    Y_FORCE_INLINE void CalcIndexesSimd(
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        ui8* __restrict indexesVec,
+        const TRepackedBin* __restrict treeSplitsCurPtr,
+        const int curTreeSize) {
+    #ifdef CB_EVALUATOR_AVX2_DISPATCH
+        if constexpr (UseAvx2) {
+            CalcIndexesAvx2(NeedXorMask, binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+        } else
+    #endif
+        {
+            CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+        }
+    }
+
     #endif
 
     template <typename TIndexType>
@@ -239,6 +281,20 @@ namespace NCB::NModelEvaluation {
     }
     #endif
 
+    template <typename TIndexType>
+    Y_FORCE_INLINE void CalculateFloatLeafValues(const size_t docCountInBlock, const float* __restrict treeLeafPtr, const TIndexType* __restrict indexesPtr, float* __restrict writePtr) {
+        for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+            writePtr[docId] += treeLeafPtr[indexesPtr[docId]];
+        }
+    }
+
+    template <typename TIndexType>
+    Y_FORCE_INLINE void CalculateQuantizedLeafValues(const size_t docCountInBlock, const i16* __restrict treeLeafPtr, const TIndexType* __restrict indexesPtr, i32* __restrict writePtr) {
+        for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+            writePtr[docId] += treeLeafPtr[indexesPtr[docId]];
+        }
+    }
+
     template <typename TIndexType>
     Y_FORCE_INLINE void CalculateLeafValuesMulti(const size_t docCountInBlock, const double* __restrict leafPtr, const TIndexType* __restrict indexesVec, const int approxDimension, double* __restrict writePtr) {
         for (size_t docId = 0; docId < docCountInBlock; ++docId) {
@@ -250,7 +306,7 @@ namespace NCB::NModelEvaluation {
         }
     }
 
-    template <bool IsSingleClassModel, bool NeedXorMask, int SSEBlockCount, bool CalcLeafIndexesOnly = false>
+    template <bool IsSingleClassModel, bool NeedXorMask, int SSEBlockCount, bool CalcLeafIndexesOnly = false, bool UseAvx2 = false, bool UseSharedSplits = false>
     Y_FORCE_INLINE void CalcTreesBlockedImpl(
         const TModelTrees& trees,
         const ui8* __restrict binFeatures,
@@ -260,7 +316,8 @@ namespace NCB::NModelEvaluation {
         const size_t treeEnd,
         double* __restrict resultsPtr) {
         const TRepackedBin* treeSplitsCurPtr =
-            trees.GetRepackedBins().data() + trees.GetTreeStartOffsets()[treeStart];
+            (UseSharedSplits ? trees.GetSharedSplitTreeBins() : trees.GetRepackedBins()).data()
+            + trees.GetTreeStartOffsets()[treeStart];
 
         ui8* __restrict indexesVec = (ui8*)indexesVecUI32;
         const auto treeLeafPtr = trees.GetLeafValues().data();
@@ -287,17 +344,17 @@ namespace NCB::NModelEvaluation {
             auto treeEnd4 = treeStart + (((treeEnd - treeStart) | 0x3) ^ 0x3);
             for (size_t treeId = treeStart; treeId < treeEnd4; treeId += 4) {
                 memset(indexesVec, 0, sizeof(ui32) * docCountInBlock);
-                CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 0,
-                                                           treeSplitsCurPtr, trees.GetTreeSizes()[treeId]);
+                CalcIndexesSimd<NeedXorMask, SSEBlockCount, UseAvx2>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 0,
+                                                                     treeSplitsCurPtr, trees.GetTreeSizes()[treeId]);
                 treeSplitsCurPtr += trees.GetTreeSizes()[treeId];
-                CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 1,
-                                                           treeSplitsCurPtr, trees.GetTreeSizes()[treeId + 1]);
+                CalcIndexesSimd<NeedXorMask, SSEBlockCount, UseAvx2>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 1,
+                                                                     treeSplitsCurPtr, trees.GetTreeSizes()[treeId + 1]);
                 treeSplitsCurPtr += trees.GetTreeSizes()[treeId + 1];
-                CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 2,
-                                                           treeSplitsCurPtr, trees.GetTreeSizes()[treeId + 2]);
+                CalcIndexesSimd<NeedXorMask, SSEBlockCount, UseAvx2>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 2,
+                                                                     treeSplitsCurPtr, trees.GetTreeSizes()[treeId + 2]);
                 treeSplitsCurPtr += trees.GetTreeSizes()[treeId + 2];
-                CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 3,
-                                                           treeSplitsCurPtr, trees.GetTreeSizes()[treeId + 3]);
+                CalcIndexesSimd<NeedXorMask, SSEBlockCount, UseAvx2>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 3,
+                                                                     treeSplitsCurPtr, trees.GetTreeSizes()[treeId + 3]);
                 treeSplitsCurPtr += trees.GetTreeSizes()[treeId + 3];
 
                 CalculateLeafValues4<SSEBlockCount>(
@@ -324,8 +381,8 @@ namespace NCB::NModelEvaluation {
             memset(indexesVec, 0, sizeof(ui32) * docCountInBlock);
 #ifdef _sse3_
             if (!CalcLeafIndexesOnly && curTreeSize <= 8) {
-                CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr,
-                                                           curTreeSize);
+                CalcIndexesSimd<NeedXorMask, SSEBlockCount, UseAvx2>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr,
+                                                                     curTreeSize);
                 if (IsSingleClassModel) { // single class model
                     CalculateLeafValues(docCountInBlock, treeLeafPtr + firstLeafOffsetsPtr[treeId], indexesVec, resultsPtr);
                 } else { // multiclass model
@@ -355,51 +412,50 @@ namespace NCB::NModelEvaluation {
         }
     }
 
-    template <bool IsSingleClassModel, bool NeedXorMask, bool CalcLeafIndexesOnly = false>
-    Y_FORCE_INLINE void CalcTreesBlocked(
+    template <bool IsSingleClassModel, bool NeedXorMask, bool CalcLeafIndexesOnly, bool UseAvx2, bool UseSharedSplits>
+    Y_FORCE_INLINE void CalcTreesBlockedOnBins(
         const TModelTrees& trees,
-        const TCPUEvaluatorQuantizedData* quantizedData,
+        const ui8* __restrict binFeatures,
         size_t docCountInBlock,
         TCalcerIndexType* __restrict indexesVec,
         size_t treeStart,
         size_t treeEnd,
         double* __restrict resultsPtr) {
-        const ui8* __restrict binFeatures = quantizedData->QuantizedData.data();
         switch (docCountInBlock / SSE_BLOCK_SIZE) {
             case 0:
-                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 0, CalcLeafIndexesOnly>(
+                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 0, CalcLeafIndexesOnly, UseAvx2, UseSharedSplits>(
                     trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
                 break;
             case 1:
-                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 1, CalcLeafIndexesOnly>(
+                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 1, CalcLeafIndexesOnly, UseAvx2, UseSharedSplits>(
                     trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
                 break;
             case 2:
-                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 2, CalcLeafIndexesOnly>(
+                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 2, CalcLeafIndexesOnly, UseAvx2, UseSharedSplits>(
                     trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
                 break;
             case 3:
-                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 3, CalcLeafIndexesOnly>(
+                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 3, CalcLeafIndexesOnly, UseAvx2, UseSharedSplits>(
                     trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
                 break;
             case 4:
-                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 4, CalcLeafIndexesOnly>(
+                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 4, CalcLeafIndexesOnly, UseAvx2, UseSharedSplits>(
                     trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
                 break;
             case 5:
-                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 5, CalcLeafIndexesOnly>(
+                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 5, CalcLeafIndexesOnly, UseAvx2, UseSharedSplits>(
                     trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
                 break;
             case 6:
-                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 6, CalcLeafIndexesOnly>(
+                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 6, CalcLeafIndexesOnly, UseAvx2, UseSharedSplits>(
                     trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
                 break;
             case 7:
-                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 7, CalcLeafIndexesOnly>(
+                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 7, CalcLeafIndexesOnly, UseAvx2, UseSharedSplits>(
                     trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
                 break;
             case 8:
-                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 8, CalcLeafIndexesOnly>(
+                CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 8, CalcLeafIndexesOnly, UseAvx2, UseSharedSplits>(
                     trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
                 break;
             default:
@@ -407,6 +463,270 @@ namespace NCB::NModelEvaluation {
         }
     }
 
+    template <bool IsSingleClassModel, bool NeedXorMask, bool CalcLeafIndexesOnly = false, bool UseAvx2 = false>
+    Y_FORCE_INLINE void CalcTreesBlocked(
+        const TModelTrees& trees,
+        const TCPUEvaluatorQuantizedData* quantizedData,
+        size_t docCountInBlock,
+        TCalcerIndexType* __restrict indexesVec,
+        size_t treeStart,
+        size_t treeEnd,
+        double* __restrict resultsPtr) {
+        CalcTreesBlockedOnBins<IsSingleClassModel, NeedXorMask, CalcLeafIndexesOnly, UseAvx2, false>(
+            trees,
+            quantizedData->QuantizedData.data(),
+            docCountInBlock,
+            indexesVec,
+            treeStart,
+            treeEnd,
+            resultsPtr);
+    }
+
+    template <bool NeedXorMask, int SSEBlockCount, bool UseAvx2>
+    void CalcTreesBlockedFloatLeavesImpl(
+        const TModelTrees& trees,
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        TCalcerIndexType* __restrict indexesVecUI32,
+        size_t treeStart,
+        size_t treeEnd,
+        const float* __restrict floatLeafValues,
+        double* __restrict resultsPtr) {
+        Y_ASSERT(docCountInBlock <= FORMULA_EVALUATION_BLOCK_SIZE);
+        const TRepackedBin* treeSplitsCurPtr = trees.GetRepackedBins().data() + trees.GetTreeStartOffsets()[treeStart];
+        ui8* __restrict indexesVec = (ui8*)indexesVecUI32;
+        auto firstLeafOffsetsPtr = trees.GetFirstLeafOffsets().data();
+        alignas(32) float blockResults[FORMULA_EVALUATION_BLOCK_SIZE] = {};
+        for (size_t treeId = treeStart; treeId < treeEnd; ++treeId) {
+            const auto curTreeSize = trees.GetTreeSizes()[treeId];
+            const float* treeLeafPtr = floatLeafValues + firstLeafOffsetsPtr[treeId];
+            memset(indexesVec, 0, sizeof(ui32) * docCountInBlock);
+#ifdef _sse3_
+            if (curTreeSize <= 8) {
+                CalcIndexesSimd<NeedXorMask, SSEBlockCount, UseAvx2>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr,
+                                                                     curTreeSize);
+    #ifdef CB_EVALUATOR_AVX2_DISPATCH
+                if constexpr (UseAvx2) {
+                    AddFloatLeafValuesAvx2(docCountInBlock, treeLeafPtr, indexesVec, blockResults);
+                } else
+    #endif
+                {
+                    CalculateFloatLeafValues(docCountInBlock, treeLeafPtr, indexesVec, blockResults);
+                }
+            } else {
+#else
+            {
+#endif
+                CalcIndexesBasic<NeedXorMask, 0>(binFeatures, docCountInBlock, indexesVecUI32, treeSplitsCurPtr,
+                                                 curTreeSize);
+                CalculateFloatLeafValues(docCountInBlock, treeLeafPtr, indexesVecUI32, blockResults);
+            }
+            treeSplitsCurPtr += curTreeSize;
+        }
+        for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+            resultsPtr[docId] += blockResults[docId];
+        }
+    }
+
+    template <bool NeedXorMask, bool UseAvx2>
+    void CalcTreesBlockedFloatLeaves(
+        const TModelTrees& trees,
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        TCalcerIndexType* __restrict indexesVec,
+        size_t treeStart,
+        size_t treeEnd,
+        const float* __restrict floatLeafValues,
+        double* __restrict resultsPtr) {
+        switch (docCountInBlock / SSE_BLOCK_SIZE) {
+            case 0:
+                CalcTreesBlockedFloatLeavesImpl<NeedXorMask, 0, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, floatLeafValues, resultsPtr);
+                break;
+            case 1:
+                CalcTreesBlockedFloatLeavesImpl<NeedXorMask, 1, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, floatLeafValues, resultsPtr);
+                break;
+            case 2:
+                CalcTreesBlockedFloatLeavesImpl<NeedXorMask, 2, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, floatLeafValues, resultsPtr);
+                break;
+            case 3:
+                CalcTreesBlockedFloatLeavesImpl<NeedXorMask, 3, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, floatLeafValues, resultsPtr);
+                break;
+            case 4:
+                CalcTreesBlockedFloatLeavesImpl<NeedXorMask, 4, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, floatLeafValues, resultsPtr);
+                break;
+            case 5:
+                CalcTreesBlockedFloatLeavesImpl<NeedXorMask, 5, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, floatLeafValues, resultsPtr);
+                break;
+            case 6:
+                CalcTreesBlockedFloatLeavesImpl<NeedXorMask, 6, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, floatLeafValues, resultsPtr);
+                break;
+            case 7:
+                CalcTreesBlockedFloatLeavesImpl<NeedXorMask, 7, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, floatLeafValues, resultsPtr);
+                break;
+            case 8:
+                CalcTreesBlockedFloatLeavesImpl<NeedXorMask, 8, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, floatLeafValues, resultsPtr);
+                break;
+            default:
+                Y_UNREACHABLE();
+        }
+    }
+
+    template <bool NeedXorMask, int SSEBlockCount, bool UseAvx2>
+    void CalcTreesBlockedQuantizedLeavesImpl(
+        const TModelTrees& trees,
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        TCalcerIndexType* __restrict indexesVecUI32,
+        size_t treeStart,
+        size_t treeEnd,
+        const TQuantizedLeafValues* quantizedLeafValues,
+        double* __restrict resultsPtr) {
+        Y_ASSERT(docCountInBlock <= FORMULA_EVALUATION_BLOCK_SIZE);
+        const TRepackedBin* treeSplitsCurPtr = trees.GetRepackedBins().data() + trees.GetTreeStartOffsets()[treeStart];
+        ui8* __restrict indexesVec = (ui8*)indexesVecUI32;
+        auto firstLeafOffsetsPtr = trees.GetFirstLeafOffsets().data();
+        const i16* leafValues = quantizedLeafValues->Values.data();
+        alignas(32) i32 blockSums[FORMULA_EVALUATION_BLOCK_SIZE];
+        for (size_t treeId = treeStart; treeId < treeEnd;) {
+            const size_t treeRangeIdx = treeId / QUANTIZED_LEAVES_TREE_RANGE_SIZE;
+            const size_t treeRangeEnd = Min(treeEnd, (treeRangeIdx + 1) * QUANTIZED_LEAVES_TREE_RANGE_SIZE);
+            memset(blockSums, 0, sizeof(i32) * docCountInBlock);
+            for (; treeId < treeRangeEnd; ++treeId) {
+                const auto curTreeSize = trees.GetTreeSizes()[treeId];
+                const i16* treeLeafPtr = leafValues + firstLeafOffsetsPtr[treeId];
+                memset(indexesVec, 0, sizeof(ui32) * docCountInBlock);
+#ifdef _sse3_
+                if (curTreeSize <= 8) {
+                    CalcIndexesSimd<NeedXorMask, SSEBlockCount, UseAvx2>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr,
+                                                                         curTreeSize);
+    #ifdef CB_EVALUATOR_AVX2_DISPATCH
+                    if constexpr (UseAvx2) {
+                        AddQuantizedLeafValuesAvx2(docCountInBlock, treeLeafPtr, indexesVec, blockSums);
+                    } else
+    #endif
+                    {
+                        CalculateQuantizedLeafValues(docCountInBlock, treeLeafPtr, indexesVec, blockSums);
+                    }
+                } else {
+#else
+                {
+#endif
+                    CalcIndexesBasic<NeedXorMask, 0>(binFeatures, docCountInBlock, indexesVecUI32, treeSplitsCurPtr,
+                                                     curTreeSize);
+                    CalculateQuantizedLeafValues(docCountInBlock, treeLeafPtr, indexesVecUI32, blockSums);
+                }
+                treeSplitsCurPtr += curTreeSize;
+            }
+            const double scale = quantizedLeafValues->TreeRangeScales[treeRangeIdx];
+            for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                resultsPtr[docId] += scale * blockSums[docId];
+            }
+        }
+    }
+
+    template <bool NeedXorMask, bool UseAvx2>
+    void CalcTreesBlockedQuantizedLeaves(
+        const TModelTrees& trees,
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        TCalcerIndexType* __restrict indexesVec,
+        size_t treeStart,
+        size_t treeEnd,
+        const TQuantizedLeafValues* quantizedLeafValues,
+        double* __restrict resultsPtr) {
+        switch (docCountInBlock / SSE_BLOCK_SIZE) {
+            case 0:
+                CalcTreesBlockedQuantizedLeavesImpl<NeedXorMask, 0, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, quantizedLeafValues, resultsPtr);
+                break;
+            case 1:
+                CalcTreesBlockedQuantizedLeavesImpl<NeedXorMask, 1, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, quantizedLeafValues, resultsPtr);
+                break;
+            case 2:
+                CalcTreesBlockedQuantizedLeavesImpl<NeedXorMask, 2, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, quantizedLeafValues, resultsPtr);
+                break;
+            case 3:
+                CalcTreesBlockedQuantizedLeavesImpl<NeedXorMask, 3, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, quantizedLeafValues, resultsPtr);
+                break;
+            case 4:
+                CalcTreesBlockedQuantizedLeavesImpl<NeedXorMask, 4, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, quantizedLeafValues, resultsPtr);
+                break;
+            case 5:
+                CalcTreesBlockedQuantizedLeavesImpl<NeedXorMask, 5, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, quantizedLeafValues, resultsPtr);
+                break;
+            case 6:
+                CalcTreesBlockedQuantizedLeavesImpl<NeedXorMask, 6, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, quantizedLeafValues, resultsPtr);
+                break;
+            case 7:
+                CalcTreesBlockedQuantizedLeavesImpl<NeedXorMask, 7, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, quantizedLeafValues, resultsPtr);
+                break;
+            case 8:
+                CalcTreesBlockedQuantizedLeavesImpl<NeedXorMask, 8, UseAvx2>(
+                    trees, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, quantizedLeafValues, resultsPtr);
+                break;
+            default:
+                Y_UNREACHABLE();
+        }
+    }
+
+    /**
+     * Evaluates every unique split of the model once per block, split conditions are laid out as 0/1 byte features,
+     *  then trees are evaluated on them with SharedSplitTreeBins (FeatureIndex is the unique split index).
+     */
+    template <bool IsSingleClassModel, bool NeedXorMask, bool CalcLeafIndexesOnly = false, bool UseAvx2 = false>
+    void CalcTreesBlockedSharedSplits(
+        const TModelTrees& trees,
+        const TCPUEvaluatorQuantizedData* quantizedData,
+        size_t docCountInBlock,
+        TCalcerIndexType* __restrict indexesVec,
+        size_t treeStart,
+        size_t treeEnd,
+        double* __restrict resultsPtr) {
+        const ui8* __restrict binFeatures = quantizedData->QuantizedData.data();
+        const auto& uniqueBins = trees.GetUniqueRepackedBins();
+        ui8* __restrict splitConditions = TEvaluationScratch::GetBuffer(
+            &GetThreadLocalEvaluationScratch()->SplitConditions,
+            uniqueBins.size() * docCountInBlock).data();
+        for (size_t uniqueBinIdx = 0; uniqueBinIdx < uniqueBins.size(); ++uniqueBinIdx) {
+            const TRepackedBin bin = uniqueBins[uniqueBinIdx];
+            const ui8* __restrict binFeaturePtr = binFeatures + bin.FeatureIndex * docCountInBlock;
+            ui8* __restrict conditionsPtr = splitConditions + uniqueBinIdx * docCountInBlock;
+            if (NeedXorMask) {
+                for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                    conditionsPtr[docId] = (binFeaturePtr[docId] ^ bin.XorMask) >= bin.SplitIdx;
+                }
+            } else {
+                for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                    conditionsPtr[docId] = binFeaturePtr[docId] >= bin.SplitIdx;
+                }
+            }
+        }
+        CalcTreesBlockedOnBins<IsSingleClassModel, false, CalcLeafIndexesOnly, UseAvx2, true>(
+            trees,
+            splitConditions,
+            docCountInBlock,
+            indexesVec,
+            treeStart,
+            treeEnd,
+            resultsPtr);
+    }
+
     template <bool IsSingleClassModel, bool NeedXorMask, bool calcIndexesOnly = false>
     inline void CalcTreesSingleDocImpl(
         const TModelTrees& trees,
@@ -692,6 +1012,64 @@ namespace NCB::NModelEvaluation {
 #endif
 
 
+    template <bool IsSingleClassModel, bool NeedXorMask, bool CalcLeafIndexesOnly = false>
+    inline void CalcNonSymmetricTreesBitvector(
+        const TModelTrees& trees,
+        const TCPUEvaluatorQuantizedData* quantizedData,
+        size_t docCountInBlock,
+        TCalcerIndexType* __restrict indexesVec,
+        size_t treeStart,
+        size_t treeEnd,
+        double* __restrict resultsPtr
+    ) {
+        const ui8* __restrict binFeatures = quantizedData->QuantizedData.data();
+        const TNonSymmetricTreeBitvectorNode* __restrict bitvectorNodes = trees.GetBitvectorNodes().data();
+        const auto& treeNodeOffsets = trees.GetBitvectorTreeNodeOffsets();
+        const auto& treeLeafOffsets = trees.GetBitvectorTreeLeafOffsets();
+        const ui32* __restrict leafValueIndexes = trees.GetBitvectorLeafValueIndexes().data();
+        const double* __restrict leafValuesPtr = trees.GetLeafValues().data();
+        const auto approxDimension = trees.GetDimensionsCount();
+        ui64 leafMasks[FORMULA_EVALUATION_BLOCK_SIZE];
+        Y_ASSERT(docCountInBlock <= FORMULA_EVALUATION_BLOCK_SIZE);
+        for (size_t treeId = treeStart; treeId < treeEnd; ++treeId) {
+            std::fill(leafMasks, leafMasks + docCountInBlock, Max<ui64>());
+            for (ui32 nodeIdx = treeNodeOffsets[treeId]; nodeIdx < treeNodeOffsets[treeId + 1]; ++nodeIdx) {
+                const TNonSymmetricTreeBitvectorNode& node = bitvectorNodes[nodeIdx];
+                const ui8* __restrict binFeaturePtr = binFeatures + node.Split.FeatureIndex * docCountInBlock;
+                const ui8 xorMask = node.Split.XorMask;
+                const ui8 borderVal = node.Split.SplitIdx;
+                const ui64 leftMask = node.LeftMask;
+                const ui64 rightMask = node.RightMask;
+                for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                    const ui8 featureValue = NeedXorMask ? (binFeaturePtr[docId] ^ xorMask) : binFeaturePtr[docId];
+                    leafMasks[docId] &= (featureValue >= borderVal) ? rightMask : leftMask;
+                }
+            }
+            const ui32* __restrict treeLeafValueIndexes = leafValueIndexes + treeLeafOffsets[treeId];
+            if constexpr (CalcLeafIndexesOnly) {
+                const auto firstLeafOffset = trees.GetFirstLeafOffsets()[treeId];
+                for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                    Y_ASSERT(leafMasks[docId] != 0 && (leafMasks[docId] & (leafMasks[docId] - 1)) == 0);
+                    const ui32 valueIdx = treeLeafValueIndexes[CountTrailingZeroBits(leafMasks[docId])];
+                    indexesVec[docId] = (valueIdx - firstLeafOffset) / approxDimension;
+                }
+                indexesVec += docCountInBlock;
+            } else if constexpr (IsSingleClassModel) {
+                for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                    resultsPtr[docId] += leafValuesPtr[treeLeafValueIndexes[CountTrailingZeroBits(leafMasks[docId])]];
+                }
+            } else {
+                auto resultWritePtr = resultsPtr;
+                for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                    const ui32 firstValueIdx = treeLeafValueIndexes[CountTrailingZeroBits(leafMasks[docId])];
+                    for (int classId = 0; classId < (int)approxDimension; ++classId, ++resultWritePtr) {
+                        *resultWritePtr += leafValuesPtr[firstValueIdx + classId];
+                    }
+                }
+            }
+        }
+    }
+
     template <bool IsSingleClassModel, bool NeedXorMask, bool CalcIndexesOnly>
     inline void CalcNonSymmetricTreesSingle(
         const TModelTrees& trees,
@@ -760,6 +1138,27 @@ namespace NCB::NModelEvaluation {
         }
     };
 
+    template <bool IsSingleClassModel, bool NeedXorMask>
+    struct CalcTreeAvx2FunctionInstantiationGetter {
+        TTreeCalcFunction operator()() const {
+            return CalcTreesBlocked<IsSingleClassModel, NeedXorMask, false, true>;
+        }
+    };
+
+    template <bool IsSingleClassModel, bool NeedXorMask, bool CalcLeafIndexesOnly>
+    struct CalcTreeBitvectorFunctionInstantiationGetter {
+        TTreeCalcFunction operator()() const {
+            return CalcNonSymmetricTreesBitvector<IsSingleClassModel, NeedXorMask, CalcLeafIndexesOnly>;
+        }
+    };
+
+    template <bool IsSingleClassModel, bool NeedXorMask, bool CalcLeafIndexesOnly, bool UseAvx2>
+    struct CalcTreeSharedSplitsFunctionInstantiationGetter {
+        TTreeCalcFunction operator()() const {
+            return CalcTreesBlockedSharedSplits<IsSingleClassModel, NeedXorMask, CalcLeafIndexesOnly, UseAvx2>;
+        }
+    };
+
     template <template <bool...> class TFunctor, bool... params>
     struct FunctorTemplateParamsSubstitutor {
         static auto Call() {
@@ -776,15 +1175,164 @@ namespace NCB::NModelEvaluation {
         }
     };
 
+    double GetFloatLeafValuesErrorBound(const TModelTrees& trees) {
+        const size_t treeCount = trees.GetTreeCount();
+        const double unitRoundoff = std::numeric_limits<float>::epsilon() / 2;
+        CB_ENSURE(treeCount * unitRoundoff < 1.0, "Too many trees for float leaf values error bound");
+        double maxLeafMagnitudeSum = 0;
+        const auto& leafValues = trees.GetLeafValues();
+        const auto& firstLeafOffsets = trees.GetFirstLeafOffsets();
+        for (size_t treeId = 0; treeId < treeCount; ++treeId) {
+            const size_t leafEnd = treeId + 1 < treeCount ? firstLeafOffsets[treeId + 1] : leafValues.size();
+            double maxLeafMagnitude = 0;
+            for (size_t leafId = firstLeafOffsets[treeId]; leafId < leafEnd; ++leafId) {
+                maxLeafMagnitude = Max(maxLeafMagnitude, Abs(leafValues[leafId]));
+            }
+            maxLeafMagnitudeSum += maxLeafMagnitude;
+        }
+        const double gamma = treeCount * unitRoundoff / (1.0 - treeCount * unitRoundoff);
+        return gamma * maxLeafMagnitudeSum * Abs(trees.GetScaleAndBias().Scale);
+    }
+
+    TTreeCalcFunction GetCalcTreesFloatLeavesFunction(
+        const TModelTrees& trees,
+        size_t docCountInBlock,
+        TConstArrayRef<float> floatLeafValues
+    ) {
+        if (!trees.IsOblivious() || trees.GetDimensionsCount() != 1 || docCountInBlock == 1
+            || floatLeafValues.size() != trees.GetLeafValues().size())
+        {
+            return {};
+        }
+        using TFloatLeavesCalcer = void (*)(
+            const TModelTrees&, const ui8*, size_t, TCalcerIndexType*, size_t, size_t, const float*, double*);
+        const bool needXorMask = !trees.GetOneHotFeatures().empty();
+        bool useAvx2 = false;
+#ifdef CB_EVALUATOR_AVX2_DISPATCH
+        useAvx2 = NX86::CachedHaveAVX2();
+#endif
+        TFloatLeavesCalcer calcer = nullptr;
+        if (needXorMask) {
+            calcer = useAvx2 ? CalcTreesBlockedFloatLeaves<true, true> : CalcTreesBlockedFloatLeaves<true, false>;
+        } else {
+            calcer = useAvx2 ? CalcTreesBlockedFloatLeaves<false, true> : CalcTreesBlockedFloatLeaves<false, false>;
+        }
+        const float* leafValuesPtr = floatLeafValues.data();
+        return [calcer, leafValuesPtr] (
+            const TModelTrees& modelTrees,
+            const TCPUEvaluatorQuantizedData* quantizedData,
+            size_t blockDocCount,
+            TCalcerIndexType* __restrict indexesVec,
+            size_t treeStart,
+            size_t treeEnd,
+            double* __restrict results
+        ) {
+            calcer(modelTrees, quantizedData->QuantizedData.data(), blockDocCount, indexesVec, treeStart, treeEnd, leafValuesPtr, results);
+        };
+    }
+
+    TQuantizedLeafValues QuantizeLeafValues(const TModelTrees& trees, double maxAbsoluteError) {
+        CB_ENSURE(
+            trees.IsOblivious() && trees.GetDimensionsCount() == 1,
+            "Quantized leaf values are supported only for oblivious single dimension models"
+        );
+        const size_t treeCount = trees.GetTreeCount();
+        const auto& leafValues = trees.GetLeafValues();
+        const auto& firstLeafOffsets = trees.GetFirstLeafOffsets();
+        TQuantizedLeafValues result;
+        result.Values.yresize(leafValues.size() + 1);
+        result.Values.back() = 0;
+        result.TreeRangeScales.resize(CeilDiv(treeCount, QUANTIZED_LEAVES_TREE_RANGE_SIZE));
+        double errorBound = 0;
+        for (size_t treeRangeIdx = 0; treeRangeIdx < result.TreeRangeScales.size(); ++treeRangeIdx) {
+            const size_t treeRangeStart = treeRangeIdx * QUANTIZED_LEAVES_TREE_RANGE_SIZE;
+            const size_t treeRangeEnd = Min(treeCount, treeRangeStart + QUANTIZED_LEAVES_TREE_RANGE_SIZE);
+            const size_t leafStart = firstLeafOffsets[treeRangeStart];
+            const size_t leafEnd = treeRangeEnd < treeCount ? firstLeafOffsets[treeRangeEnd] : leafValues.size();
+            double maxLeafMagnitude = 0;
+            for (size_t leafId = leafStart; leafId < leafEnd; ++leafId) {
+                maxLeafMagnitude = Max(maxLeafMagnitude, Abs(leafValues[leafId]));
+            }
+            const double scale = maxLeafMagnitude > 0 ? maxLeafMagnitude / Max<i16>() : 1.0;
+            result.TreeRangeScales[treeRangeIdx] = scale;
+            for (size_t leafId = leafStart; leafId < leafEnd; ++leafId) {
+                const long quantizedValue = std::lround(leafValues[leafId] / scale);
+                result.Values[leafId] = ClampVal<long>(quantizedValue, -Max<i16>(), Max<i16>());
+            }
+            // rounding error of a leaf is at most scale / 2, every tree of the range adds one leaf
+            errorBound += (treeRangeEnd - treeRangeStart) * scale / 2;
+        }
+        result.ErrorBound = errorBound * Abs(trees.GetScaleAndBias().Scale);
+        CB_ENSURE(
+            result.ErrorBound <= maxAbsoluteError,
+            "Quantized leaf values error bound " << result.ErrorBound << " exceeds max absolute error " << maxAbsoluteError
+        );
+        return result;
+    }
+
+    TTreeCalcFunction GetCalcTreesQuantizedLeavesFunction(
+        const TModelTrees& trees,
+        size_t docCountInBlock,
+        const TQuantizedLeafValues& quantizedLeafValues
+    ) {
+        if (!trees.IsOblivious() || trees.GetDimensionsCount() != 1 || docCountInBlock == 1
+            || quantizedLeafValues.Values.size() != trees.GetLeafValues().size() + 1)
+        {
+            return {};
+        }
+        using TQuantizedLeavesCalcer = void (*)(
+            const TModelTrees&, const ui8*, size_t, TCalcerIndexType*, size_t, size_t, const TQuantizedLeafValues*, double*);
+        const bool needXorMask = !trees.GetOneHotFeatures().empty();
+        bool useAvx2 = false;
+#ifdef CB_EVALUATOR_AVX2_DISPATCH
+        useAvx2 = NX86::CachedHaveAVX2();
+#endif
+        TQuantizedLeavesCalcer calcer = nullptr;
+        if (needXorMask) {
+            calcer = useAvx2 ? CalcTreesBlockedQuantizedLeaves<true, true> : CalcTreesBlockedQuantizedLeaves<true, false>;
+        } else {
+            calcer = useAvx2 ? CalcTreesBlockedQuantizedLeaves<false, true> : CalcTreesBlockedQuantizedLeaves<false, false>;
+        }
+        const TQuantizedLeafValues* quantizedLeafValuesPtr = &quantizedLeafValues;
+        return [calcer, quantizedLeafValuesPtr] (
+            const TModelTrees& modelTrees,
+            const TCPUEvaluatorQuantizedData* quantizedData,
+            size_t blockDocCount,
+            TCalcerIndexType* __restrict indexesVec,
+            size_t treeStart,
+            size_t treeEnd,
+            double* __restrict results
+        ) {
+            calcer(modelTrees, quantizedData->QuantizedData.data(), blockDocCount, indexesVec, treeStart, treeEnd, quantizedLeafValuesPtr, results);
+        };
+    }
+
     TTreeCalcFunction GetCalcTreesFunction(
         const TModelTrees& trees,
         size_t docCountInBlock,
-        bool calcIndexesOnly
+        bool calcIndexesOnly,
+        bool useSharedSplits
     ) {
         const bool areTreesOblivious = trees.IsOblivious();
         const bool isSingleDoc = (docCountInBlock == 1);
         const bool isSingleClassModel = (trees.GetDimensionsCount() == 1);
         const bool needXorMask = !trees.GetOneHotFeatures().empty();
+        bool useAvx2 = false;
+#ifdef CB_EVALUATOR_AVX2_DISPATCH
+        useAvx2 = !calcIndexesOnly && NX86::CachedHaveAVX2();
+#endif
+        if (useSharedSplits && areTreesOblivious && !isSingleDoc && !trees.GetSharedSplitTreeBins().empty()) {
+            return FunctorTemplateParamsSubstitutor<CalcTreeSharedSplitsFunctionInstantiationGetter>::Call(
+                isSingleClassModel, needXorMask, calcIndexesOnly, useAvx2);
+        }
+        if (!areTreesOblivious && !isSingleDoc && trees.HasBitvectorLayout()) {
+            return FunctorTemplateParamsSubstitutor<CalcTreeBitvectorFunctionInstantiationGetter>::Call(
+                isSingleClassModel, needXorMask, calcIndexesOnly);
+        }
+        if (areTreesOblivious && !isSingleDoc && useAvx2) {
+            return FunctorTemplateParamsSubstitutor<CalcTreeAvx2FunctionInstantiationGetter>::Call(
+                isSingleClassModel, needXorMask);
+        }
         return FunctorTemplateParamsSubstitutor<CalcTreeFunctionInstantiationGetter>::Call(
             areTreesOblivious, isSingleDoc, isSingleClassModel, needXorMask, calcIndexesOnly);
     }
@@ -0,0 +1,114 @@
+#include <catboost/libs/model/model.h>
+
+#include <util/system/compiler.h>
+
+#include <immintrin.h>
+
+namespace NCB::NModelEvaluation {
+
+    constexpr size_t AVX2_BLOCK_SIZE = 32;
+
+    template <bool NeedXorMask>
+    Y_FORCE_INLINE static void CalcIndexesAvx2Impl(
+            const ui8* __restrict binFeatures,
+            size_t docCountInBlock,
+            ui8* __restrict indexesVec,
+            const TRepackedBin* __restrict treeSplitsCurPtr,
+            int curTreeSize) {
+    #define _mm256_cmpge_epu8(a, b) _mm256_cmpeq_epi8(_mm256_max_epu8((a), (b)), (a))
+    #define LOAD_AND_UPDATE_32_DOC_BINS(reg, binFeaturesPtr32) \
+            { \
+                __m256i val = _mm256_loadu_si256((const __m256i*)(binFeaturesPtr32)); \
+                if (NeedXorMask) { \
+                    val = _mm256_xor_si256(val, xorMaskVec); \
+                } \
+                reg = _mm256_or_si256(reg, _mm256_and_si256(_mm256_cmpge_epu8(val, borderValVec), mask)); \
+            }
+        const size_t avxBlockCount = docCountInBlock / AVX2_BLOCK_SIZE;
+        for (size_t regId = 0; regId < avxBlockCount; regId += 2) {
+            __m256i v0 = _mm256_setzero_si256();
+            __m256i v1 = _mm256_setzero_si256();
+            __m256i mask = _mm256_set1_epi8(0x01);
+            for (int depth = 0; depth < curTreeSize; ++depth) {
+                const ui8* __restrict binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + AVX2_BLOCK_SIZE * regId;
+                const __m256i borderValVec = _mm256_set1_epi8(treeSplitsCurPtr[depth].SplitIdx);
+                const __m256i xorMaskVec = _mm256_set1_epi8(treeSplitsCurPtr[depth].XorMask);
+                Y_UNUSED(xorMaskVec);
+                LOAD_AND_UPDATE_32_DOC_BINS(v0, binFeaturePtr);
+                if (regId + 1 < avxBlockCount) {
+                    LOAD_AND_UPDATE_32_DOC_BINS(v1, binFeaturePtr + AVX2_BLOCK_SIZE);
+                }
+                mask = _mm256_add_epi8(mask, mask);
+            }
+            _mm256_storeu_si256((__m256i*)(indexesVec + AVX2_BLOCK_SIZE * regId), v0);
+            if (regId + 1 < avxBlockCount) {
+                _mm256_storeu_si256((__m256i*)(indexesVec + AVX2_BLOCK_SIZE * regId + AVX2_BLOCK_SIZE), v1);
+            }
+        }
+    #undef _mm256_cmpge_epu8
+    #undef LOAD_AND_UPDATE_32_DOC_BINS
+        for (size_t docId = avxBlockCount * AVX2_BLOCK_SIZE; docId < docCountInBlock; ++docId) {
+            ui8 index = 0;
+            for (int depth = 0; depth < curTreeSize; ++depth) {
+                ui8 featureValue = binFeatures[treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + docId];
+                if (NeedXorMask) {
+                    featureValue ^= treeSplitsCurPtr[depth].XorMask;
+                }
+                index |= (featureValue >= treeSplitsCurPtr[depth].SplitIdx) << depth;
+            }
+            indexesVec[docId] = index;
+        }
+    }
+
+    // Writes (not ORs) ui8 leaf indexes for all docCountInBlock documents, so curTreeSize must be <= 8
+    void CalcIndexesAvx2(
+            bool needXorMask,
+            const ui8* __restrict binFeatures,
+            size_t docCountInBlock,
+            ui8* __restrict indexesVec,
+            const TRepackedBin* __restrict treeSplitsCurPtr,
+            int curTreeSize) {
+        if (needXorMask) {
+            CalcIndexesAvx2Impl<true>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+        } else {
+            CalcIndexesAvx2Impl<false>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+        }
+    }
+
+    // Adds treeLeafPtr[indexesPtr[i]] to writePtr[i] for all docCountInBlock documents
+    void AddFloatLeafValuesAvx2(
+            size_t docCountInBlock,
+            const float* __restrict treeLeafPtr,
+            const ui8* __restrict indexesPtr,
+            float* __restrict writePtr) {
+        size_t docId = 0;
+        for (; docId + 8 <= docCountInBlock; docId += 8) {
+            const __m256i indexes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(indexesPtr + docId)));
+            const __m256 leafValues = _mm256_i32gather_ps(treeLeafPtr, indexes, sizeof(float));
+            _mm256_storeu_ps(writePtr + docId, _mm256_add_ps(_mm256_loadu_ps(writePtr + docId), leafValues));
+        }
+        for (; docId < docCountInBlock; ++docId) {
+            writePtr[docId] += treeLeafPtr[indexesPtr[docId]];
+        }
+    }
+
+    // Adds treeLeafPtr[indexesPtr[i]] to writePtr[i] for all docCountInBlock documents, treeLeafPtr should be
+    //  readable one element past the last leaf
+    void AddQuantizedLeafValuesAvx2(
+            size_t docCountInBlock,
+            const i16* __restrict treeLeafPtr,
+            const ui8* __restrict indexesPtr,
+            i32* __restrict writePtr) {
+        size_t docId = 0;
+        for (; docId + 8 <= docCountInBlock; docId += 8) {
+            const __m256i indexes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(indexesPtr + docId)));
+            // gather 32 bits at 2 byte stride, then sign-extend the low 16 bits
+            const __m256i gathered = _mm256_i32gather_epi32((const int*)treeLeafPtr, indexes, sizeof(i16));
+            const __m256i leafValues = _mm256_srai_epi32(_mm256_slli_epi32(gathered, 16), 16);
+            _mm256_storeu_si256((__m256i*)(writePtr + docId), _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(writePtr + docId)), leafValues));
+        }
+        for (; docId < docCountInBlock; ++docId) {
+            writePtr[docId] += treeLeafPtr[indexesPtr[docId]];
+        }
+    }
+}
@@ -2,6 +2,9 @@
 #include <catboost/libs/model/model.h>
 
 #include "evaluator.h"
+#include "prediction_cache.h"
+
+#include <util/string/cast.h>
 
 namespace NCB::NModelEvaluation {
     namespace NDetail {
@@ -18,16 +21,32 @@ namespace NCB::NModelEvaluation {
             size_t treeEnd,
             EPredictionType predictionType,
             TArrayRef<double> results,
-            const NCB::NModelEvaluation::TFeatureLayout* featureInfo = nullptr
+            const NCB::NModelEvaluation::TFeatureLayout* featureInfo = nullptr,
+            size_t maxBlockSize = FORMULA_EVALUATION_BLOCK_SIZE,
+            bool useSharedSplits = false,
+            TConstArrayRef<float> floatLeafValues = {},
+            TPredictionCache* predictionCache = nullptr,
+            const TQuantizedLeafValues* quantizedLeafValues = nullptr,
+            TEvaluationProfiler* profiler = nullptr
         ) {
-            const size_t blockSize = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount);
-            auto calcTrees = GetCalcTreesFunction(trees, blockSize);
+            const size_t blockSize = Min(maxBlockSize, docCount);
+            TTreeCalcFunction calcTrees;
+            if (quantizedLeafValues) {
+                calcTrees = GetCalcTreesQuantizedLeavesFunction(trees, blockSize, *quantizedLeafValues);
+            }
+            if (!calcTrees && !floatLeafValues.empty()) {
+                calcTrees = GetCalcTreesFloatLeavesFunction(trees, blockSize, floatLeafValues);
+            }
+            if (!calcTrees) {
+                calcTrees = GetCalcTreesFunction(trees, blockSize, /*calcIndexesOnly*/ false, useSharedSplits);
+            }
             if (trees.GetTreeCount() == 0) {
                 Fill(results.begin(), results.end(), trees.GetScaleAndBias().Bias);
                 return;
             }
             Fill(results.begin(), results.end(), 0.0);
-            TVector<TCalcerIndexType> indexesVec(blockSize);
+            TEvaluationScratch* scratch = GetThreadLocalEvaluationScratch();
+            const auto indexesVec = TEvaluationScratch::GetBuffer(&scratch->Indexes, blockSize);
             TEvalResultProcessor resultProcessor(
                 docCount,
                 results,
@@ -37,6 +56,7 @@ namespace NCB::NModelEvaluation {
                 blockSize
             );
             ui32 blockId = 0;
+            TVector<TString> cacheKeys;
             ProcessDocsInBlocks(
                 trees,
                 ctrProvider,
@@ -48,28 +68,182 @@ namespace NCB::NModelEvaluation {
                 blockSize,
                 [&] (size_t docCountInBlock, const TCPUEvaluatorQuantizedData* quantizedData) {
                     auto blockResultsView = resultProcessor.GetViewForRawEvaluation(blockId);
-                    calcTrees(
-                        trees,
-                        quantizedData,
+                    const auto blockRawResults = blockResultsView.Slice(0, docCountInBlock * trees.GetDimensionsCount());
+                    const bool isCached = predictionCache && predictionCache->FindBlock(
+                        quantizedData->QuantizedData.data(),
+                        trees.GetEffectiveBinaryFeaturesBucketsCount(),
                         docCountInBlock,
-                        docCount == 1 ? nullptr : indexesVec.data(),
                         treeStart,
                         treeEnd,
-                        blockResultsView.data()
+                        &cacheKeys,
+                        blockRawResults
                     );
+                    if (!isCached) {
+                        const auto treesStart = profiler ? TEvaluationProfiler::Now() : TEvaluationProfiler::TClock::time_point();
+                        calcTrees(
+                            trees,
+                            quantizedData,
+                            docCountInBlock,
+                            docCount == 1 ? nullptr : indexesVec.data(),
+                            treeStart,
+                            treeEnd,
+                            blockResultsView.data()
+                        );
+                        if (profiler) {
+                            profiler->Add(
+                                TEvaluationProfiler::Trees,
+                                TEvaluationProfiler::NanosecondsSince(treesStart),
+                                docCountInBlock,
+                                treeEnd - treeStart
+                            );
+                        }
+                        if (predictionCache) {
+                            predictionCache->InsertBlock(cacheKeys, blockRawResults);
+                        }
+                    }
                     resultProcessor.PostprocessBlock(blockId, treeStart);
                     ++blockId;
                 },
-                featureInfo
+                featureInfo,
+                scratch,
+                profiler
             );
         }
 
+        template <typename TFloatFeatureAccessor, typename TCatFeatureAccessor, typename TTextFeatureAccessor>
+        inline void CalcWithEarlyExitGeneric(
+            const TModelTrees& trees,
+            const TIntrusivePtr<ICtrProvider>& ctrProvider,
+            const TIntrusivePtr<TTextProcessingCollection>& textProcessingCollection,
+            TFloatFeatureAccessor floatFeatureAccessor,
+            TCatFeatureAccessor catFeaturesAccessor,
+            TTextFeatureAccessor textFeatureAccessor,
+            size_t docCount,
+            double threshold,
+            size_t treeChunkSize,
+            TArrayRef<double> results,
+            const NCB::NModelEvaluation::TFeatureLayout* featureInfo,
+            size_t maxBlockSize
+        ) {
+            CB_ENSURE(trees.GetDimensionsCount() == 1, "Early exit evaluation is supported only for single dimension models");
+            CB_ENSURE(treeChunkSize > 0, "Tree chunk size should be positive");
+            CB_ENSURE(results.size() == docCount, "Results size " << results.size() << " doesn't match doc count " << docCount);
+            const auto scaleAndBias = trees.GetScaleAndBias();
+            const size_t treeCount = trees.GetTreeCount();
+            if (treeCount == 0) {
+                Fill(results.begin(), results.end(), scaleAndBias.Bias);
+                return;
+            }
+            const size_t blockSize = Min(maxBlockSize, docCount);
+            auto calcTrees = GetCalcTreesFunction(trees, blockSize);
+            TEvaluationScratch* scratch = GetThreadLocalEvaluationScratch();
+            const auto indexesVec = TEvaluationScratch::GetBuffer(&scratch->Indexes, blockSize);
+            const auto& remainingMinSums = trees.GetRemainingTreesMinLeafSums();
+            const auto& remainingMaxSums = trees.GetRemainingTreesMaxLeafSums();
+            CB_ENSURE(
+                remainingMinSums.size() == treeCount + 1 && remainingMaxSums.size() == treeCount + 1,
+                "Model has no leaf value bounds required for early exit evaluation"
+            );
+            const size_t bucketCount = trees.GetEffectiveBinaryFeaturesBucketsCount();
+            TVector<ui8> activeBins;
+            TVector<size_t> activeDocs;
+            TVector<double> activeSums;
+            size_t blockStart = 0;
+            ProcessDocsInBlocks(
+                trees,
+                ctrProvider,
+                textProcessingCollection,
+                floatFeatureAccessor,
+                catFeaturesAccessor,
+                textFeatureAccessor,
+                docCount,
+                blockSize,
+                [&] (size_t docCountInBlock, const TCPUEvaluatorQuantizedData* quantizedData) {
+                    const ui8* blockBins = quantizedData->QuantizedData.data();
+                    activeBins.assign(blockBins, blockBins + bucketCount * docCountInBlock);
+                    activeDocs.resize(docCountInBlock);
+                    Iota(activeDocs.begin(), activeDocs.end(), blockStart);
+                    activeSums.assign(docCountInBlock, 0.0);
+                    size_t activeCount = docCountInBlock;
+                    for (size_t chunkStart = 0; chunkStart < treeCount && activeCount > 0; chunkStart += treeChunkSize) {
+                        const size_t chunkEnd = Min(treeCount, chunkStart + treeChunkSize);
+                        TCPUEvaluatorQuantizedData activeData;
+                        activeData.ObjectsCount = activeCount;
+                        activeData.BlocksCount = 1;
+                        activeData.BlockStride = bucketCount * activeCount;
+                        activeData.QuantizedData = TMaybeOwningArrayHolder<ui8>::CreateNonOwning(
+                            MakeArrayRef(activeBins.data(), bucketCount * activeCount));
+                        calcTrees(
+                            trees,
+                            &activeData,
+                            activeCount,
+                            docCount == 1 ? nullptr : indexesVec.data(),
+                            chunkStart,
+                            chunkEnd,
+                            activeSums.data()
+                        );
+                        size_t keptCount = 0;
+                        for (size_t activeIdx = 0; activeIdx < activeCount; ++activeIdx) {
+                            const double lhs = scaleAndBias.Scale * (activeSums[activeIdx] + remainingMinSums[chunkEnd]) + scaleAndBias.Bias;
+                            const double rhs = scaleAndBias.Scale * (activeSums[activeIdx] + remainingMaxSums[chunkEnd]) + scaleAndBias.Bias;
+                            const double lowerBound = Min(lhs, rhs);
+                            const double upperBound = Max(lhs, rhs);
+                            if (lowerBound > threshold) {
+                                results[activeDocs[activeIdx]] = lowerBound;
+                            } else if (upperBound <= threshold) {
+                                results[activeDocs[activeIdx]] = upperBound;
+                            } else {
+                                // compaction is safe in place: destination index never exceeds source index
+                                for (size_t bucketIdx = 0; bucketIdx < bucketCount; ++bucketIdx) {
+                                    activeBins[bucketIdx * activeCount + keptCount] = activeBins[bucketIdx * activeCount + activeIdx];
+                                }
+                                activeDocs[keptCount] = activeDocs[activeIdx];
+                                activeSums[keptCount] = activeSums[activeIdx];
+                                ++keptCount;
+                            }
+                        }
+                        if (keptCount != activeCount) {
+                            for (size_t bucketIdx = 1; bucketIdx < bucketCount; ++bucketIdx) {
+                                memmove(
+                                    activeBins.data() + bucketIdx * keptCount,
+                                    activeBins.data() + bucketIdx * activeCount,
+                                    keptCount
+                                );
+                            }
+                        }
+                        activeCount = keptCount;
+                    }
+                    blockStart += docCountInBlock;
+                },
+                featureInfo,
+                scratch
+            );
+        }
+
+        static size_t ParseEvaluationBlockSize(const TStringBuf value) {
+            size_t blockSize = 0;
+            CB_ENSURE(
+                TryFromString<size_t>(value, blockSize) && blockSize > 0 && blockSize <= FORMULA_EVALUATION_BLOCK_SIZE,
+                "Evaluation block size should be an integer in [1, " << FORMULA_EVALUATION_BLOCK_SIZE << "], got: " << value
+            );
+            return blockSize;
+        }
+
+        static size_t GetEvaluationBlockSize(const TFullModel& fullModel) {
+            const auto calibratedBlockSize = fullModel.ModelInfo.FindPtr(EVALUATION_BLOCK_SIZE_MODEL_INFO_KEY);
+            if (calibratedBlockSize) {
+                return ParseEvaluationBlockSize(*calibratedBlockSize);
+            }
+            return GetDefaultEvaluationBlockSize(*fullModel.ModelTrees);
+        }
+
         class TCpuEvaluator final : public IModelEvaluator {
         public:
             explicit TCpuEvaluator(const TFullModel& fullModel)
                 : ModelTrees(fullModel.ModelTrees)
                 , CtrProvider(fullModel.CtrProvider)
                 , TextProcessingCollection(fullModel.TextProcessingCollection)
+                , BlockSize(GetEvaluationBlockSize(fullModel))
             {}
 
             void SetPredictionType(EPredictionType type) override {
@@ -89,7 +263,14 @@ namespace NCB::NModelEvaluation {
             }
 
             TModelEvaluatorPtr Clone() const override {
-                return new TCpuEvaluator(*this);
+                auto clone = MakeIntrusive<TCpuEvaluator>(*this);
+                if (PredictionCache) {
+                    clone->PredictionCache = MakeAtomicShared<TPredictionCache>(PredictionCache->GetCapacity());
+                }
+                if (Profiler) {
+                    clone->Profiler = MakeAtomicShared<TEvaluationProfiler>();
+                }
+                return clone;
             }
 
             i32 GetApproxDimension() const override {
@@ -97,8 +278,42 @@ namespace NCB::NModelEvaluation {
             }
 
             void SetProperty(const TStringBuf propName, const TStringBuf propValue) override {
-                CB_ENSURE(false, "CPU evaluator don't have any properties. Got: " << propName);
-                Y_UNUSED(propValue);
+                if (propName == "BlockSize") {
+                    BlockSize = ParseEvaluationBlockSize(propValue);
+                } else if (propName == "SharedSplits") {
+                    UseSharedSplits = FromString<bool>(propValue);
+                } else if (propName == "FloatLeafValues") {
+                    SetFloatLeafValues(FromString<bool>(propValue));
+                } else if (propName == "QuantizedLeafValues") {
+                    SetQuantizedLeafValues(propValue);
+                } else if (propName == "EnableProfiling") {
+                    Profiler.Reset(FromString<bool>(propValue) ? new TEvaluationProfiler() : nullptr);
+                    return;
+                } else if (propName == "PredictionCacheSize") {
+                    const size_t cacheSize = FromString<size_t>(propValue);
+                    PredictionCache.Reset(cacheSize ? new TPredictionCache(cacheSize) : nullptr);
+                    return;
+                } else {
+                    CB_ENSURE(false, "CPU evaluator don't have property " << propName);
+                }
+                if (PredictionCache) {
+                    PredictionCache->Clear(); // cached values may depend on evaluation options
+                }
+            }
+
+            TEvaluationProfile GetProfile() const override {
+                return Profiler ? Profiler->GetProfile() : TEvaluationProfile();
+            }
+
+            TMaybe<TString> GetProperty(const TStringBuf propName) const override {
+                if (propName == "PredictionCacheHits") {
+                    return ToString(PredictionCache ? PredictionCache->GetHitCount() : 0);
+                } else if (propName == "PredictionCacheMisses") {
+                    return ToString(PredictionCache ? PredictionCache->GetMissCount() : 0);
+                } else if (propName == "QuantizedLeafValuesErrorBound" && QuantizedLeafValues) {
+                    return ToString(QuantizedLeafValues->ErrorBound);
+                }
+                return Nothing();
             }
 
             void CalcFlatTransposed(
@@ -159,7 +374,13 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
-                    featureInfo
+                    featureInfo,
+                    BlockSize,
+                    UseSharedSplits,
+                    FloatLeafValues,
+                    PredictionCache.Get(),
+                    QuantizedLeafValues.Get(),
+                    Profiler.Get()
                 );
             }
 
@@ -203,7 +424,13 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
-                    featureInfo
+                    featureInfo,
+                    BlockSize,
+                    UseSharedSplits,
+                    FloatLeafValues,
+                    PredictionCache.Get(),
+                    QuantizedLeafValues.Get(),
+                    Profiler.Get()
                 );
             }
 
@@ -237,7 +464,13 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
-                    featureInfo
+                    featureInfo,
+                    BlockSize,
+                    UseSharedSplits,
+                    FloatLeafValues,
+                    PredictionCache.Get(),
+                    QuantizedLeafValues.Get(),
+                    Profiler.Get()
                 );
             }
 
@@ -264,6 +497,87 @@ namespace NCB::NModelEvaluation {
                 );
             }
 
+            void CalcColumnar(
+                TConstArrayRef<TFeatureColumn<float>> floatColumns,
+                TConstArrayRef<TFeatureColumn<int>> catColumns,
+                size_t docCount,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo
+            ) const override {
+                CB_ENSURE(
+                    ModelTrees->GetTextFeatures().empty(),
+                    "Model contains text features but they aren't provided"
+                );
+                if (!featureInfo) {
+                    featureInfo = ExtFeatureLayout.Get();
+                }
+                ValidateColumnarFeatures(ModelTrees->GetFloatFeatures(), floatColumns, featureInfo, "Float");
+                ValidateColumnarFeatures(ModelTrees->GetCatFeatures(), catColumns, featureInfo, "Categorical");
+                CalcGeneric(
+                    *ModelTrees,
+                    CtrProvider,
+                    TextProcessingCollection,
+                    [floatColumns](TFeaturePosition position, size_t index) -> float {
+                        return floatColumns[position.Index][index];
+                    },
+                    [catColumns](TFeaturePosition position, size_t index) -> int {
+                        return catColumns[position.Index][index];
+                    },
+                    TCpuEvaluator::TextFeatureAccessorStub,
+                    docCount,
+                    treeStart,
+                    treeEnd,
+                    PredictionType,
+                    results,
+                    featureInfo,
+                    BlockSize,
+                    UseSharedSplits,
+                    FloatLeafValues,
+                    PredictionCache.Get(),
+                    QuantizedLeafValues.Get(),
+                    Profiler.Get()
+                );
+            }
+
+            void CalcWithEarlyExit(
+                TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+                TConstArrayRef<TConstArrayRef<int>> catFeatures,
+                double threshold,
+                size_t treeChunkSize,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo
+            ) const override {
+                CB_ENSURE(
+                    ModelTrees->GetTextFeatures().empty(),
+                    "Model contains text features but they aren't provided"
+                );
+                if (!featureInfo) {
+                    featureInfo = ExtFeatureLayout.Get();
+                }
+                ValidateInputFeatures<TConstArrayRef<TStringBuf>>(floatFeatures, catFeatures, {}, featureInfo);
+                const size_t docCount = Max(catFeatures.size(), floatFeatures.size());
+                CalcWithEarlyExitGeneric(
+                    *ModelTrees,
+                    CtrProvider,
+                    TextProcessingCollection,
+                    [&floatFeatures](TFeaturePosition position, size_t index) -> float {
+                        return floatFeatures[index][position.Index];
+                    },
+                    [&catFeatures](TFeaturePosition position, size_t index) -> int {
+                        return catFeatures[index][position.Index];
+                    },
+                    TCpuEvaluator::TextFeatureAccessorStub,
+                    docCount,
+                    threshold,
+                    treeChunkSize,
+                    results,
+                    featureInfo,
+                    BlockSize
+                );
+            }
+
             void Calc(
                 TConstArrayRef<TConstArrayRef<float>> floatFeatures,
                 TConstArrayRef<TConstArrayRef<int>> catFeatures,
@@ -296,7 +610,13 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
-                    featureInfo
+                    featureInfo,
+                    BlockSize,
+                    UseSharedSplits,
+                    FloatLeafValues,
+                    PredictionCache.Get(),
+                    QuantizedLeafValues.Get(),
+                    Profiler.Get()
                 );
             }
 
@@ -355,7 +675,13 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
-                    featureInfo
+                    featureInfo,
+                    BlockSize,
+                    UseSharedSplits,
+                    FloatLeafValues,
+                    PredictionCache.Get(),
+                    QuantizedLeafValues.Get(),
+                    Profiler.Get()
                 );
             }
 
@@ -384,7 +710,8 @@ namespace NCB::NModelEvaluation {
                     treeStart,
                     treeEnd,
                     indexes,
-                    featureInfo
+                    featureInfo,
+                    BlockSize
                 );
             }
 
@@ -415,7 +742,8 @@ namespace NCB::NModelEvaluation {
                     treeStart,
                     treeEnd,
                     indexes,
-                    featureInfo
+                    featureInfo,
+                    BlockSize
                 );
             }
             void Calc(
@@ -439,7 +767,8 @@ namespace NCB::NModelEvaluation {
                 auto calcFunction = GetCalcTreesFunction(
                     *ModelTrees,
                     subBlockSize,
-                    false
+                    false,
+                    UseSharedSplits
                 );
                 CB_ENSURE(results.size() == ModelTrees->GetDimensionsCount() * cpuQuantizedFeatures->ObjectsCount);
                 TVector<TCalcerIndexType> indexesVec(subBlockSize);
@@ -479,7 +808,8 @@ namespace NCB::NModelEvaluation {
                 auto calcFunction = GetCalcTreesFunction(
                     *ModelTrees,
                     Min<size_t>(FORMULA_EVALUATION_BLOCK_SIZE, cpuQuantizedFeatures->ObjectsCount),
-                    /*calcIndexesOnly*/ true
+                    /*calcIndexesOnly*/ true,
+                    UseSharedSplits
                 );
                 size_t treeCount = treeEnd - treeStart;
                 CB_ENSURE(indexes.size() == treeCount * cpuQuantizedFeatures->ObjectsCount);
@@ -510,6 +840,25 @@ namespace NCB::NModelEvaluation {
             }
 
         private:
+            template <typename TFeature, typename TValue>
+            static void ValidateColumnarFeatures(
+                TConstArrayRef<TFeature> features,
+                TConstArrayRef<TFeatureColumn<TValue>> columns,
+                const TFeatureLayout* featureInfo,
+                TStringBuf featureType
+            ) {
+                for (const auto& feature : features) {
+                    if (!feature.UsedInModel()) {
+                        continue;
+                    }
+                    const TFeaturePosition position = featureInfo ? featureInfo->GetRemappedPosition(feature) : feature.Position;
+                    CB_ENSURE(
+                        static_cast<size_t>(position.Index) < columns.size() && columns[position.Index].Data,
+                        featureType << " feature column " << position.Index << " is used by model but not provided"
+                    );
+                }
+            }
+
             template <typename TCatFeatureContainer = TConstArrayRef<int>>
             void ValidateInputFeatures(
                 TConstArrayRef<TConstArrayRef<float>> floatFeatures,
@@ -579,6 +928,28 @@ namespace NCB::NModelEvaluation {
                 }
             }
 
+            void SetFloatLeafValues(bool enable) {
+                FloatLeafValues.clear();
+                if (!enable) {
+                    return;
+                }
+                CB_ENSURE(
+                    ModelTrees->IsOblivious() && ModelTrees->GetDimensionsCount() == 1,
+                    "Float leaf values are supported only for oblivious single dimension models"
+                );
+                const auto& leafValues = ModelTrees->GetLeafValues();
+                FloatLeafValues.assign(leafValues.begin(), leafValues.end());
+            }
+
+            // propValue is max absolute prediction error allowed, empty value disables quantized leaf values
+            void SetQuantizedLeafValues(TStringBuf propValue) {
+                QuantizedLeafValues.Clear();
+                if (propValue.empty()) {
+                    return;
+                }
+                QuantizedLeafValues = QuantizeLeafValues(*ModelTrees, FromString<double>(propValue));
+            }
+
             static TStringBuf TextFeatureAccessorStub(TFeaturePosition position, size_t index) {
                 Y_UNUSED(position, index);
                 CB_ENSURE(false, "This type of apply interface is not implemented with text features yet");
@@ -589,6 +960,16 @@ namespace NCB::NModelEvaluation {
             const TIntrusivePtr<TTextProcessingCollection> TextProcessingCollection;
             EPredictionType PredictionType = EPredictionType::RawFormulaVal;
             TMaybe<TFeatureLayout> ExtFeatureLayout;
+            size_t BlockSize = FORMULA_EVALUATION_BLOCK_SIZE;
+            bool UseSharedSplits = false;
+            //! Float copy of leaf values, nonempty if FloatLeafValues property is set
+            TVector<float> FloatLeafValues;
+            //! i16 leaf values with per tree range scales, set if QuantizedLeafValues property is set
+            TMaybe<TQuantizedLeafValues> QuantizedLeafValues;
+            //! Raw predictions cache, nonempty if PredictionCacheSize property is set. Clone gets an empty cache
+            TAtomicSharedPtr<TPredictionCache> PredictionCache;
+            //! Phase statistics of all calls, set if EnableProfiling property is set. Clone gets empty statistics
+            TAtomicSharedPtr<TEvaluationProfiler> Profiler;
         };
     }
 
@@ -0,0 +1,81 @@
+#include "prediction_cache.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/algorithm.h>
+#include <util/system/guard.h>
+
+#include <cstring>
+
+namespace NCB::NModelEvaluation {
+
+    TPredictionCache::TPredictionCache(size_t capacity)
+        : Capacity(capacity)
+    {
+        CB_ENSURE(capacity > 0, "Prediction cache capacity should be positive");
+    }
+
+    bool TPredictionCache::FindBlock(
+        const ui8* binFeatures,
+        size_t bucketCount,
+        size_t docCountInBlock,
+        size_t treeStart,
+        size_t treeEnd,
+        TVector<TString>* keys,
+        TArrayRef<double> blockResults
+    ) {
+        const size_t dimension = blockResults.size() / docCountInBlock;
+        const ui64 treeRange[2] = {treeStart, treeEnd};
+        keys->resize(docCountInBlock);
+        for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+            TString& key = (*keys)[docId];
+            key.ReserveAndResize(sizeof(treeRange) + bucketCount);
+            char* keyPtr = key.begin();
+            memcpy(keyPtr, treeRange, sizeof(treeRange));
+            keyPtr += sizeof(treeRange);
+            for (size_t bucketIdx = 0; bucketIdx < bucketCount; ++bucketIdx) {
+                keyPtr[bucketIdx] = binFeatures[bucketIdx * docCountInBlock + docId];
+            }
+        }
+        with_lock(Lock) {
+            for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                const auto entryPtr = Index.FindPtr((*keys)[docId]);
+                if (!entryPtr) {
+                    AtomicAdd(MissCount, docCountInBlock);
+                    return false;
+                }
+                Entries.splice(Entries.begin(), Entries, *entryPtr);
+                Copy((*entryPtr)->Value.begin(), (*entryPtr)->Value.end(), blockResults.begin() + docId * dimension);
+            }
+        }
+        AtomicAdd(HitCount, docCountInBlock);
+        return true;
+    }
+
+    void TPredictionCache::InsertBlock(TConstArrayRef<TString> keys, TConstArrayRef<double> blockResults) {
+        const size_t dimension = blockResults.size() / keys.size();
+        with_lock(Lock) {
+            for (size_t docId = 0; docId < keys.size(); ++docId) {
+                const auto docResults = blockResults.Slice(docId * dimension, dimension);
+                if (const auto entryPtr = Index.FindPtr(keys[docId])) {
+                    (*entryPtr)->Value.assign(docResults.begin(), docResults.end());
+                    Entries.splice(Entries.begin(), Entries, *entryPtr);
+                    continue;
+                }
+                if (Entries.size() == Capacity) {
+                    Index.erase(Entries.back().Key);
+                    Entries.pop_back();
+                }
+                Entries.push_front(TEntry{keys[docId], TVector<double>(docResults.begin(), docResults.end())});
+                Index[Entries.front().Key] = Entries.begin();
+            }
+        }
+    }
+
+    void TPredictionCache::Clear() {
+        with_lock(Lock) {
+            Index.clear();
+            Entries.clear();
+        }
+    }
+}
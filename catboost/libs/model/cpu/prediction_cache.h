@@ -0,0 +1,72 @@
+#pragma once
+
+#include <util/generic/array_ref.h>
+#include <util/generic/hash.h>
+#include <util/generic/list.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/system/atomic.h>
+#include <util/system/spinlock.h>
+#include <util/system/types.h>
+
+namespace NCB::NModelEvaluation {
+
+    /**
+     * LRU cache of raw (before scale, bias and prediction type postprocessing) predictions of single objects.
+     * Key is the quantized binary features vector of an object produced by BinarizeFeatures together with
+     *  evaluated tree range, so objects with different raw features that fall into the same bins share an entry.
+     * Thread-safe.
+     */
+    class TPredictionCache {
+    public:
+        explicit TPredictionCache(size_t capacity);
+
+        /**
+         * @param binFeatures quantized block, layout: [bucketIdx][docId]
+         * @param[out] keys object keys, to be passed to InsertBlock if the block is not found
+         * @param[out] blockResults raw predictions, layout: [docId][dimension], filled only if all block objects
+         *  are in cache
+         * @return true if all block objects are in cache
+         */
+        bool FindBlock(
+            const ui8* binFeatures,
+            size_t bucketCount,
+            size_t docCountInBlock,
+            size_t treeStart,
+            size_t treeEnd,
+            TVector<TString>* keys,
+            TArrayRef<double> blockResults);
+
+        void InsertBlock(TConstArrayRef<TString> keys, TConstArrayRef<double> blockResults);
+
+        void Clear();
+
+        size_t GetCapacity() const {
+            return Capacity;
+        }
+
+        //! Number of objects served from cache
+        ui64 GetHitCount() const {
+            return AtomicGet(HitCount);
+        }
+
+        //! Number of objects that were evaluated because their block was not found in cache
+        ui64 GetMissCount() const {
+            return AtomicGet(MissCount);
+        }
+
+    private:
+        struct TEntry {
+            TString Key;
+            TVector<double> Value;
+        };
+
+    private:
+        const size_t Capacity;
+        TAdaptiveLock Lock;
+        TList<TEntry> Entries; // most recently used first
+        THashMap<TStringBuf, TList<TEntry>::iterator> Index; // keys reference TEntry::Key
+        TAtomic HitCount = 0;
+        TAtomic MissCount = 0;
+    };
+}
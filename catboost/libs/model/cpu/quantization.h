@@ -1,5 +1,7 @@
 #pragma once
 
+#include "evaluation_profiler.h"
+
 #include <catboost/libs/model/model.h>
 
 #include <catboost/libs/helpers/exception.h>
@@ -14,6 +16,26 @@
 
 namespace NCB::NModelEvaluation {
     constexpr size_t FORMULA_EVALUATION_BLOCK_SIZE = 128;
+    constexpr size_t MIN_FORMULA_EVALUATION_BLOCK_SIZE = 16;
+
+    // Budget for one quantized block, binary features of all documents in block should fit into L1 cache
+    constexpr size_t EVALUATION_BLOCK_CACHE_BUDGET = 32 * 1024;
+
+    //! Model metadata key with evaluation block size selected by TFullModel::CalibrateEvaluationBlockSize
+    constexpr TStringBuf EVALUATION_BLOCK_SIZE_MODEL_INFO_KEY = "cpu_evaluation_block_size";
+
+    /**
+     * Heuristic evaluation block size for model: largest power of two not greater than
+     * FORMULA_EVALUATION_BLOCK_SIZE such that quantized block fits into EVALUATION_BLOCK_CACHE_BUDGET
+     */
+    inline size_t GetDefaultEvaluationBlockSize(const TModelTrees& trees) {
+        const size_t bytesPerDocument = Max<size_t>(trees.GetEffectiveBinaryFeaturesBucketsCount(), 1);
+        size_t blockSize = FORMULA_EVALUATION_BLOCK_SIZE;
+        while (blockSize > MIN_FORMULA_EVALUATION_BLOCK_SIZE && blockSize * bytesPerDocument > EVALUATION_BLOCK_CACHE_BUDGET) {
+            blockSize /= 2;
+        }
+        return blockSize;
+    }
 
     class TCPUEvaluatorQuantizedData final : public IQuantizedData {
     public:
@@ -275,8 +297,12 @@ namespace NCB::NModelEvaluation {
         TArrayRef<ui32> transposedHash,
         TArrayRef<float> ctrs,
         TArrayRef<float> estimatedFeatures,
-        const TFeatureLayout* featureInfo = nullptr
+        const TFeatureLayout* featureInfo = nullptr,
+        TEvaluationProfiler* profiler = nullptr
     ) {
+        const auto binarizationStart = profiler ? TEvaluationProfiler::Now() : TEvaluationProfiler::TClock::time_point();
+        ui64 textFeaturesNanoseconds = 0;
+        ui64 ctrsNanoseconds = 0;
         const auto fullDocCount = end - start;
         auto result = *(cpuEvaluatorQuantizedData->QuantizedData);
         auto expectedQuantizedFeaturesLen = trees.GetEffectiveBinaryFeaturesBucketsCount() * fullDocCount;
@@ -287,6 +313,27 @@ namespace NCB::NModelEvaluation {
         cpuEvaluatorQuantizedData->ObjectsCount = fullDocCount;
         ui8* resultPtr = result.data();
         std::fill(result.begin(), result.begin() + expectedQuantizedFeaturesLen, 0);
+
+        // text feature positions are the same for all blocks, collect them once
+        TVector<ui32> textFeatureIds;
+        TVector<int> textFeatureIdToFlatIndex;
+        if (trees.GetUsedTextFeaturesCount() > 0 && trees.GetUsedEstimatedFeaturesCount() > 0) {
+            for (const auto& textFeature : trees.GetTextFeatures()) {
+                if (!textFeature.UsedInModel()) {
+                    continue;
+                }
+                TFeaturePosition position = textFeature.Position;
+                if (featureInfo) {
+                    position = featureInfo->GetRemappedPosition(textFeature);
+                }
+                textFeatureIds.push_back(position.Index);
+                if (textFeatureIdToFlatIndex.size() <= static_cast<size_t>(position.Index)) {
+                    textFeatureIdToFlatIndex.resize(position.Index + 1, -1);
+                }
+                textFeatureIdToFlatIndex[position.Index] = position.FlatIndex;
+            }
+        }
+
         for (; start < end; start += FORMULA_EVALUATION_BLOCK_SIZE) {
             ui8* resultPtrForBlockStart = resultPtr;
             ++cpuEvaluatorQuantizedData->BlocksCount;
@@ -343,31 +390,14 @@ namespace NCB::NModelEvaluation {
                     "Fail to apply with text features: TextProcessingCollection must present in FullModel"
                 );
 
-                TVector<TStringBuf> texts;
-                texts.yresize(docCount);
-
+                const auto textFeaturesStart = profiler ? TEvaluationProfiler::Now() : TEvaluationProfiler::TClock::time_point();
                 {
-                    TVector<ui32> textFeatureIds;
-                    THashMap<ui32, ui32> textFeatureIdToFlatIndex;
-                    // TODO(d-kruchinin) Check out how index recalculation affects the speed
-                    for (const auto& textFeature : trees.GetTextFeatures()) {
-                        if (!textFeature.UsedInModel()) {
-                            continue;
-                        }
-                        TFeaturePosition position = textFeature.Position;
-                        if (featureInfo) {
-                            position = featureInfo->GetRemappedPosition(textFeature);
-                        }
-                        textFeatureIds.push_back(position.Index);
-                        textFeatureIdToFlatIndex[position.Index] = position.FlatIndex;
-                    }
-
                     textProcessingCollection->CalcFeatures(
                         [start, &textFeatureAccessor, &textFeatureIdToFlatIndex](ui32 textFeatureId, ui32 docId) {
                             return textFeatureAccessor(
                                 TFeaturePosition{
                                     SafeIntegerCast<int>(textFeatureId),
-                                    SafeIntegerCast<int>(textFeatureIdToFlatIndex[textFeatureId])
+                                    textFeatureIdToFlatIndex[textFeatureId]
                                 },
                                 start + docId
                             );
@@ -396,6 +426,9 @@ namespace NCB::NModelEvaluation {
                         resultPtr
                     );
                 }
+                if (profiler) {
+                    textFeaturesNanoseconds += TEvaluationProfiler::NanosecondsSince(textFeaturesStart);
+                }
             }
             if (trees.GetUsedCatFeaturesCount() != 0) {
                 THashMap<int, int> catFeaturePackedIndexes;
@@ -425,6 +458,7 @@ namespace NCB::NModelEvaluation {
                     resultPtr
                 );
                 if (!trees.GetUsedModelCtrs().empty()) {
+                    const auto ctrsStart = profiler ? TEvaluationProfiler::Now() : TEvaluationProfiler::TClock::time_point();
                     ctrProvider->CalcCtrs(
                         trees.GetUsedModelCtrs(),
                         TConstArrayRef<ui8>(resultPtrForBlockStart, docCount * trees.GetEffectiveBinaryFeaturesBucketsCount()),
@@ -432,6 +466,9 @@ namespace NCB::NModelEvaluation {
                         docCount,
                         ctrs
                     );
+                    if (profiler) {
+                        ctrsNanoseconds += TEvaluationProfiler::NanosecondsSince(ctrsStart);
+                    }
                 }
                 size_t ctrFloatsPosition = 0;
                 for (const auto& ctr : trees.GetCtrFeatures()) {
@@ -448,6 +485,20 @@ namespace NCB::NModelEvaluation {
                 }
             }
         }
+        if (profiler) {
+            const ui64 totalNanoseconds = TEvaluationProfiler::NanosecondsSince(binarizationStart);
+            if (trees.GetUsedTextFeaturesCount() > 0 && trees.GetUsedEstimatedFeaturesCount() > 0) {
+                profiler->Add(TEvaluationProfiler::TextFeatures, textFeaturesNanoseconds, fullDocCount);
+            }
+            if (trees.GetUsedCatFeaturesCount() != 0 && !trees.GetUsedModelCtrs().empty()) {
+                profiler->Add(TEvaluationProfiler::Ctrs, ctrsNanoseconds, fullDocCount);
+            }
+            profiler->Add(
+                TEvaluationProfiler::Binarization,
+                totalNanoseconds - Min(totalNanoseconds, textFeaturesNanoseconds + ctrsNanoseconds),
+                fullDocCount
+            );
+        }
     }
 
 /**
@@ -488,4 +539,53 @@ namespace NCB::NModelEvaluation {
             ++cpuEvaluatorQuantizedData->BlocksCount;
         }
     }
+
+    /**
+     * Fill evaluator quantized data with float feature bins computed outside of the model, f.e. by a feature
+     *  service using TFloatFeature::Borders. binAccessor(position, docId) should return the count of feature
+     *  borders that are less than the feature value, that is the bin BinarizeFeatures would compute; larger
+     *  values are treated as the last bin. Only models with float features alone are supported.
+     */
+    template <typename TBinAccessor>
+    inline void AssignFloatFeatureBins(
+        const TModelTrees& trees,
+        TBinAccessor binAccessor,
+        size_t start,
+        size_t end,
+        TCPUEvaluatorQuantizedData* cpuEvaluatorQuantizedData
+    ) {
+        CB_ENSURE(
+            trees.GetUsedCatFeaturesCount() == 0 && trees.GetUsedTextFeaturesCount() == 0,
+            "Quantized input is supported only for models with float features alone"
+        );
+        ui8* resultPtr = cpuEvaluatorQuantizedData->QuantizedData.data();
+        const size_t requiredSize = trees.GetEffectiveBinaryFeaturesBucketsCount() * (end - start);
+        CB_ENSURE(
+            cpuEvaluatorQuantizedData->QuantizedData.GetSize() >= requiredSize,
+            "No enough space to store quantized data for evaluator"
+        );
+        cpuEvaluatorQuantizedData->BlockStride =
+            trees.GetEffectiveBinaryFeaturesBucketsCount() * FORMULA_EVALUATION_BLOCK_SIZE;
+        cpuEvaluatorQuantizedData->BlocksCount = 0;
+        cpuEvaluatorQuantizedData->ObjectsCount = end - start;
+        for (; start < end; start += FORMULA_EVALUATION_BLOCK_SIZE) {
+            const size_t blockEnd = Min(start + FORMULA_EVALUATION_BLOCK_SIZE, end);
+            for (const auto& floatFeature : trees.GetFloatFeatures()) {
+                if (!floatFeature.UsedInModel()) {
+                    continue;
+                }
+                // features with more than MAX_VALUES_PER_BIN borders take several buckets, see BinarizeFloats
+                const size_t borderCount = floatFeature.Borders.size();
+                for (size_t bucketStart = 0; bucketStart < borderCount; bucketStart += MAX_VALUES_PER_BIN) {
+                    const size_t bucketSize = Min<size_t>(MAX_VALUES_PER_BIN, borderCount - bucketStart);
+                    for (size_t docId = start; docId < blockEnd; ++docId) {
+                        const size_t bin = binAccessor(floatFeature.Position, docId);
+                        *resultPtr = static_cast<ui8>(bin > bucketStart ? Min(bin - bucketStart, bucketSize) : 0);
+                        ++resultPtr;
+                    }
+                }
+            }
+            ++cpuEvaluatorQuantizedData->BlocksCount;
+        }
+    }
 }
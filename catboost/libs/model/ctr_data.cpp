@@ -2,7 +2,11 @@
 
 #include <catboost/libs/helpers/exception.h>
 
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/cast.h>
 #include <util/generic/set.h>
+#include <util/stream/mem.h>
 
 
 void TCtrData::Save(IOutputStream* s) const {
@@ -23,9 +27,36 @@ void TCtrData::Load(IInputStream* s) {
     const size_t cnt = ::LoadSize(s);
     LearnCtrs.reserve(cnt);
 
+    // read serialized tables sequentially, parse them in parallel
+    TVector<TVector<ui8>> serializedTables(cnt);
+    for (auto& serializedTable : serializedTables) {
+        serializedTable.yresize(::LoadSize(s));
+        s->LoadOrFail(serializedTable.data(), serializedTable.size());
+    }
+    TVector<TCtrValueTable> tables(cnt);
+    NPar::LocalExecutor().ExecRangeWithThrow(
+        [&] (int tableIdx) {
+            auto& serializedTable = serializedTables[tableIdx];
+            tables[tableIdx].LoadShared(serializedTable.data(), serializedTable.size());
+            TVector<ui8>().swap(serializedTable);
+        },
+        0,
+        SafeIntegerCast<int>(cnt),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    for (auto& table : tables) {
+        TModelCtrBase ctrBase = table.ModelCtrBase;
+        LearnCtrs[ctrBase] = std::move(table);
+    }
+}
+
+void TCtrData::LoadNonOwning(TMemoryInput* s) {
+    const size_t cnt = ::LoadSize(s);
+    LearnCtrs.reserve(cnt);
+
     for (size_t i = 0; i != cnt; ++i) {
         TCtrValueTable table;
-        table.Load(s);
+        table.LoadThin(s);
         TModelCtrBase ctrBase = table.ModelCtrBase;
         LearnCtrs[ctrBase] = std::move(table);
     }
@@ -27,6 +27,9 @@ public:
     void Save(IOutputStream* s) const;
 
     void Load(IInputStream* s);
+
+    //! Load tables referencing data in s buffer, see TCtrValueTable::LoadThin
+    void LoadNonOwning(TMemoryInput* s);
 };
 
 class TCtrDataStreamWriter {
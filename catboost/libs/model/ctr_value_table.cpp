@@ -1,13 +1,20 @@
 #include "ctr_value_table.h"
 
 #include "flatbuffers_serializer_helper.h"
+#include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/model/flatbuffers/ctr_data.fbs.h>
 
+#include <util/digest/city.h>
 #include <util/generic/fwd.h>
+#include <util/generic/hash.h>
 #include <util/generic/ptr.h>
+#include <util/generic/singleton.h>
+#include <util/generic/ymath.h>
 #include <util/stream/input.h>
+#include <util/stream/mem.h>
 #include <util/stream/output.h>
 #include <util/system/compiler.h>
+#include <util/system/spinlock.h>
 #include <util/ysaveload.h>
 
 
@@ -15,8 +22,8 @@ void TCtrValueTable::Save(IOutputStream* s) const {
     using namespace flatbuffers;
     using namespace NCatBoostFbs;
     TModelPartsCachingSerializer serializer;
-    if (HoldsAlternative<TSolidTable>(Impl)) {
-        auto& solid = Get<TSolidTable>(Impl);
+    if (const TSolidTable* solidPtr = GetSolidTable()) {
+        auto& solid = *solidPtr;
         auto indexHashOffset = serializer.FlatbufBuilder.CreateVector((const ui8*) solid.IndexBuckets.data(),
                                                 sizeof(NCatboost::TBucket) * solid.IndexBuckets.size());
         auto ctrBlob = serializer.FlatbufBuilder.CreateVector(solid.CTRBlob);
@@ -46,11 +53,73 @@ void TCtrValueTable::Save(IOutputStream* s) const {
     s->Write(serializer.FlatbufBuilder.GetBufferPointer(), serializer.FlatbufBuilder.GetSize());
 }
 
+namespace {
+    /**
+     * Process-wide registry of loaded solid tables keyed by hash of their serialized data. Holds weak
+     *  references only, so table data is freed together with the last model using it.
+     */
+    template <class TTable>
+    class TSharedTablesCache {
+    public:
+        std::shared_ptr<const TTable> GetOrAdd(ui64 contentHash, TTable&& table) {
+            with_lock(Lock) {
+                auto& cachedTable = Tables[contentHash];
+                auto existingTable = cachedTable.lock();
+                if (existingTable && *existingTable == table) {
+                    return existingTable;
+                }
+                auto newTable = std::make_shared<const TTable>(std::move(table));
+                if (!existingTable) {
+                    cachedTable = newTable;
+                    MaybeDropExpired();
+                }
+                return newTable;
+            }
+        }
+
+    private:
+        void MaybeDropExpired() {
+            if (Tables.size() < 2 * SizeAfterCleanup) {
+                return;
+            }
+            for (auto it = Tables.begin(); it != Tables.end();) {
+                if (it->second.expired()) {
+                    Tables.erase(it++);
+                } else {
+                    ++it;
+                }
+            }
+            SizeAfterCleanup = Max<size_t>(Tables.size(), MinSizeForCleanup);
+        }
+
+    private:
+        static constexpr size_t MinSizeForCleanup = 64;
+
+        TAdaptiveLock Lock;
+        THashMap<ui64, std::weak_ptr<const TTable>> Tables;
+        size_t SizeAfterCleanup = MinSizeForCleanup;
+    };
+}
+
+std::shared_ptr<const TCtrValueTable::TSolidTable> TCtrValueTable::ShareSolidTable(
+    ui64 contentHash,
+    TSolidTable&& table
+) {
+    return Singleton<TSharedTablesCache<TSolidTable>>()->GetOrAdd(contentHash, std::move(table));
+}
+
 void TCtrValueTable::Load(IInputStream* s) {
     const ui32 size = LoadSize(s);
     TArrayHolder<ui8> arrayHolder = new ui8[size];
     s->LoadOrFail(arrayHolder.Get(), size);
-    LoadSolid(arrayHolder.Get(), size);
+    LoadShared(arrayHolder.Get(), size);
+}
+
+void TCtrValueTable::LoadShared(const void* buf, size_t length) {
+    LoadSolid(const_cast<void*>(buf), length);
+    const ui64 contentHash = CityHash64(reinterpret_cast<const char*>(buf), length);
+    auto sharedTable = ShareSolidTable(contentHash, std::move(Get<TSolidTable>(Impl)));
+    Impl = TSharedTable{std::move(sharedTable)};
 }
 
 void TCtrValueTable::LoadSolid(void* buf, size_t length) {
@@ -68,3 +137,26 @@ void TCtrValueTable::LoadSolid(void* buf, size_t length) {
     solid.CTRBlob.assign(ctrValueTable->CTRBlob()->data(),
                          ctrValueTable->CTRBlob()->data() + ctrValueTable->CTRBlob()->size());
 }
+
+void TCtrValueTable::LoadThin(TMemoryInput* in) {
+    const ui32 size = LoadSize(in);
+    CB_ENSURE(in->Avail() >= size, "Unexpected end of CTR value table data");
+    const ui8* buf = reinterpret_cast<const ui8*>(in->Buf());
+    in->Skip(size);
+    auto ctrValueTable = flatbuffers::GetRoot<NCatBoostFbs::TCtrValueTable>(buf);
+    const ui8* indexHashData = ctrValueTable->IndexHashRaw()->data();
+    if (reinterpret_cast<uintptr_t>(indexHashData) % alignof(NCatboost::TBucket) != 0) {
+        LoadSolid(const_cast<ui8*>(buf), size);
+        return;
+    }
+    Impl = TThinTable();
+    auto& thin = Get<TThinTable>(Impl);
+    ModelCtrBase.FBDeserialize(ctrValueTable->ModelCtrBase());
+    CounterDenominator = ctrValueTable->CounterDenominator();
+    TargetClassesCount = ctrValueTable->TargetClassesCount();
+    thin.IndexBuckets = MakeArrayRef(
+        reinterpret_cast<const NCatboost::TBucket*>(indexHashData),
+        ctrValueTable->IndexHashRaw()->size() / sizeof(NCatboost::TBucket)
+    );
+    thin.CTRBlob = MakeArrayRef(ctrValueTable->CTRBlob()->data(), ctrValueTable->CTRBlob()->size());
+}
@@ -11,6 +11,7 @@
 #include <util/system/types.h>
 
 #include <algorithm>
+#include <memory>
 #include <tuple>
 
 
@@ -38,6 +39,15 @@ class TCtrValueTable {
             table->CTRBlob.assign(CTRBlob.begin(), CTRBlob.end());
         }
     };
+    //! Solid table data shared by all equal tables loaded in the process, see TCtrValueTable::Load
+    struct TSharedTable {
+        std::shared_ptr<const TSolidTable> Table;
+
+    public:
+        bool operator==(const TSharedTable& other) const {
+            return *Table == *other.Table;
+        }
+    };
 public:
 
     TCtrValueTable()
@@ -52,8 +62,8 @@ public:
 
     template <typename T>
     TConstArrayRef<T> GetTypedArrayRefForBlobData() const {
-        if (HoldsAlternative<TSolidTable>(Impl)) {
-            auto& solid = Get<TSolidTable>(Impl);
+        if (const TSolidTable* solidPtr = GetSolidTable()) {
+            auto& solid = *solidPtr;
             return MakeArrayRef(
                 reinterpret_cast<const T*>(solid.CTRBlob.data()),
                 solid.CTRBlob.size() / sizeof(T)
@@ -79,9 +89,8 @@ public:
     }
 
     NCatboost::TDenseIndexHashView GetIndexHashViewer() const {
-        if (HoldsAlternative<TSolidTable>(Impl)) {
-            auto& solid = Get<TSolidTable>(Impl);
-            return NCatboost::TDenseIndexHashView(solid.IndexBuckets);
+        if (const TSolidTable* solidPtr = GetSolidTable()) {
+            return NCatboost::TDenseIndexHashView(solidPtr->IndexBuckets);
         } else {
             auto& thin = Get<TThinTable>(Impl);
             return NCatboost::TDenseIndexHashView(thin.IndexBuckets);
@@ -96,14 +105,41 @@ public:
     }
     void Save(IOutputStream* s) const;
 
+    /**
+     * Load table data, index and CTR blob are shared with equal tables already loaded in the process,
+     *  f.e. by other models trained on the same categorical features
+     */
     void Load(IInputStream* s);
 
+    //! Same as Load for a single serialized table in buf, data is copied from buf
+    void LoadShared(const void* buf, size_t length);
+
     void LoadSolid(void* buf, size_t length);
 
+    /**
+     * Load table without copying index and CTR blob data, table keeps references into in buffer,
+     *  so it should outlive this object
+     */
+    void LoadThin(TMemoryInput* in);
+
 public:
     TModelCtrBase ModelCtrBase;
     int CounterDenominator = 0;
     int TargetClassesCount = 0;
 private:
-    TVariant<TSolidTable, TThinTable> Impl;
+    //! Solid or shared table data, nullptr for thin tables
+    const TSolidTable* GetSolidTable() const {
+        if (HoldsAlternative<TSolidTable>(Impl)) {
+            return &Get<TSolidTable>(Impl);
+        }
+        if (HoldsAlternative<TSharedTable>(Impl)) {
+            return Get<TSharedTable>(Impl).Table.get();
+        }
+        return nullptr;
+    }
+
+    static std::shared_ptr<const TSolidTable> ShareSolidTable(ui64 contentHash, TSolidTable&& table);
+
+private:
+    TVariant<TSolidTable, TThinTable, TSharedTable> Impl;
 };
@@ -1,24 +1,41 @@
+#include <catboost/libs/cat_feature/cat_feature.h>
 #include <catboost/libs/model/evaluation_interface.h>
 #include <catboost/libs/model/model.h>
 #include <catboost/libs/model/cpu/evaluator.h>
 
 #include <catboost/libs/model/cuda/evaluator.cuh>
 
+#include <library/cpp/threading/future/future.h>
+
 #include <util/generic/ymath.h>
 #include <util/string/cast.h>
+#include <util/system/atomic.h>
+#include <util/system/guard.h>
 #include <util/system/hp_timer.h>
+#include <util/system/mutex.h>
 
 namespace NCB::NModelEvaluation {
     namespace NDetail {
+        constexpr size_t DEFAULT_ASYNC_STREAM_COUNT = 4;
+
         class TGpuEvaluator final : public IModelEvaluator {
         public:
             TGpuEvaluator(const TGpuEvaluator& other) = default;
 
             explicit TGpuEvaluator(const TFullModel& model)
                 : ModelTrees(model.ModelTrees)
+                , CtrProvider(model.CtrProvider)
+                , UseHostQuantization(model.HasCategoricalFeatures())
             {
-                CB_ENSURE(!model.HasCategoricalFeatures(), "Model contains categorical features, gpu evaluation impossible");
                 CB_ENSURE(model.IsOblivious(), "Model is not oblivious, gpu evaluation impossible");
+                CB_ENSURE(
+                    ModelTrees->GetUsedTextFeaturesCount() == 0,
+                    "Model contains text features, gpu evaluation impossible"
+                );
+                CB_ENSURE(
+                    ModelTrees->GetUsedModelCtrs().empty() || model.HasValidCtrProvider(),
+                    "Model has CTR features but no valid CTR provider, gpu evaluation impossible"
+                );
                 TVector<TGPURepackedBin> gpuBins;
                 for (const TRepackedBin& cpuRepackedBin : ModelTrees->GetRepackedBins()) {
                     gpuBins.emplace_back(TGPURepackedBin{ static_cast<ui32>(cpuRepackedBin.FeatureIndex * WarpSize), cpuRepackedBin.SplitIdx, cpuRepackedBin.XorMask });
@@ -34,7 +51,9 @@ namespace NCB::NModelEvaluation {
                     if (!floatFeature.UsedInModel()) {
                         continue;
                     }
-                    CB_ENSURE(floatFeature.Borders.size() > 0 && floatFeature.Borders.size() < MAX_VALUES_PER_BIN);
+                    CB_ENSURE(
+                        UseHostQuantization || (floatFeature.Borders.size() > 0 && floatFeature.Borders.size() < MAX_VALUES_PER_BIN)
+                    );
                     floatFeatureForBucketIdx[currentBinarizedBucket] = floatFeature.Position.Index;
                     bordersCount[currentBinarizedBucket] = floatFeature.Borders.size();
                     bordersOffsets[currentBinarizedBucket] = flatBordersVec.size();
@@ -42,6 +61,7 @@ namespace NCB::NModelEvaluation {
                     ++currentBinarizedBucket;
                 }
                 Ctx.GPUModelData.FloatFeatureForBucketIdx = TCudaVec<ui32>(floatFeatureForBucketIdx, EMemoryType::Device);
+                Ctx.GPUModelData.BucketsCount = ModelTrees->GetEffectiveBinaryFeaturesBucketsCount();
                 Ctx.GPUModelData.TreeSplits = TCudaVec<TGPURepackedBin>(gpuBins, EMemoryType::Device);
                 Ctx.GPUModelData.BordersOffsets = TCudaVec<ui32>(bordersOffsets, EMemoryType::Device);
                 Ctx.GPUModelData.BordersCount = TCudaVec<ui32>(bordersCount, EMemoryType::Device);
@@ -63,6 +83,7 @@ namespace NCB::NModelEvaluation {
                     EMemoryType::Device
                 );
                 Ctx.Stream = TCudaStream::NewStream();
+                InitAsyncSlots(DEFAULT_ASYNC_STREAM_COUNT);
             }
 
             void SetPredictionType(EPredictionType type) override {
@@ -70,8 +91,14 @@ namespace NCB::NModelEvaluation {
             }
 
             void SetProperty(const TStringBuf propName, const TStringBuf propValue) override {
-                {
-                    Y_UNUSED(propValue);
+                if (propName == "AsyncStreamCount") {
+                    size_t streamCount = 0;
+                    CB_ENSURE(
+                        TryFromString<size_t>(propValue, streamCount),
+                        "Can't parse AsyncStreamCount value " << propValue
+                    );
+                    InitAsyncSlots(streamCount);
+                } else {
                     CB_ENSURE(false, "GPU evaluator don't have property " << propName);
                 }
             }
@@ -129,6 +156,21 @@ namespace NCB::NModelEvaluation {
                 }
 
                 CB_ENSURE(docCount.Defined(), "couldn't determine document count, something went wrong");
+                if (UseHostQuantization) {
+                    CalcHostQuantized(
+                        [&transposedFeatures](TFeaturePosition position, size_t index) -> float {
+                            return transposedFeatures[position.FlatIndex][index];
+                        },
+                        [&transposedFeatures](TFeaturePosition position, size_t index) -> int {
+                            return ConvertFloatCatFeatureToIntHash(transposedFeatures[position.FlatIndex][index]);
+                        },
+                        *docCount,
+                        treeStart,
+                        treeEnd,
+                        results
+                    );
+                    return;
+                }
                 const size_t stride = CeilDiv<size_t>(*docCount, 32) * 32;
                 Ctx.EvalDataCache.PrepareCopyBufs(
                     ModelTrees->GetMinimalSufficientFloatFeaturesVectorSize() * stride,
@@ -157,25 +199,23 @@ namespace NCB::NModelEvaluation {
                 TArrayRef<double> results,
                 const TFeatureLayout* featureLayout
             ) const override {
-                CB_ENSURE(featureLayout == nullptr, "feature layout currenlty not supported");
-                if (!featureLayout) {
-                    featureLayout = ExtFeatureLayout.Get();
-                }
-                auto expectedFlatVecSize = ModelTrees->GetFlatFeatureVectorExpectedSize();
-                if (featureLayout && featureLayout->FlatIndexes) {
-                    CB_ENSURE(
-                        featureLayout->FlatIndexes->size() >= expectedFlatVecSize,
-                        "Feature layout FlatIndexes expected to be at least " << expectedFlatVecSize << " long"
-                    );
-                    expectedFlatVecSize = *MaxElement(featureLayout->FlatIndexes->begin(), featureLayout->FlatIndexes->end());
-                }
-                for (const auto& flatFeaturesVec : features) {
-                    CB_ENSURE(
-                        flatFeaturesVec.size() >= expectedFlatVecSize,
-                        "insufficient flat features vector size: " << flatFeaturesVec.size() << " expected: " << expectedFlatVecSize
+                const size_t expectedFlatVecSize = GetValidatedFlatFeatureVectorSize(features, featureLayout);
+                const size_t docCount = features.size();
+                if (UseHostQuantization) {
+                    CalcHostQuantized(
+                        [&features](TFeaturePosition position, size_t index) -> float {
+                            return features[index][position.FlatIndex];
+                        },
+                        [&features](TFeaturePosition position, size_t index) -> int {
+                            return ConvertFloatCatFeatureToIntHash(features[index][position.FlatIndex]);
+                        },
+                        docCount,
+                        treeStart,
+                        treeEnd,
+                        results
                     );
+                    return;
                 }
-                const size_t docCount = features.size();
                 const size_t stride = CeilDiv<size_t>(expectedFlatVecSize, 32) * 32;
 
                 TGPUDataInput dataInput;
@@ -193,6 +233,79 @@ namespace NCB::NModelEvaluation {
                 Ctx.EvalData(dataInput, treeStart, treeEnd, results, PredictionType);
             }
 
+            NThreading::TFuture<void> CalcFlatAsync(
+                TConstArrayRef<TConstArrayRef<float>> features,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureLayout
+            ) const override {
+                const size_t expectedFlatVecSize = GetValidatedFlatFeatureVectorSize(features, featureLayout);
+                const size_t docCount = features.size();
+                CB_ENSURE(
+                    results.size() == docCount,
+                    "Results size " << results.size() << " doesn't match doc count " << docCount
+                );
+                if (docCount == 0) {
+                    return NThreading::MakeFuture();
+                }
+                const size_t stride = CeilDiv<size_t>(expectedFlatVecSize, 32) * 32;
+                TAsyncEvaluationSlot& slot = *AsyncSlots[AtomicGetAndIncrement(NextAsyncSlot) % AsyncSlots.size()];
+                TGuard<TMutex> guard(slot.Lock);
+                // pinned buffers of the slot are reused, so previous batch enqueued to it should be finished
+                slot.LastEvaluation.GetValueSync();
+                slot.DataCache.PrepareCopyBufs(docCount * stride, docCount);
+                slot.DataCache.PrepareResultsHostBuf(docCount);
+                if (UseHostQuantization) {
+                    QuantizeOnHost(
+                        [&features](TFeaturePosition position, size_t index) -> float {
+                            return features[index][position.FlatIndex];
+                        },
+                        [&features](TFeaturePosition position, size_t index) -> int {
+                            return ConvertFloatCatFeatureToIntHash(features[index][position.FlatIndex]);
+                        },
+                        docCount,
+                        slot.Stream,
+                        &slot.DataCache,
+                        &slot.QuantizedData
+                    );
+                } else {
+                    auto copyBufRef = slot.DataCache.CopyDataBufHost.AsArrayRef();
+                    for (size_t docId = 0; docId < docCount; ++docId) {
+                        memcpy(&copyBufRef[docId * stride], features[docId].data(), sizeof(float) * expectedFlatVecSize);
+                    }
+                    MemoryCopyAsync<float>(copyBufRef, slot.DataCache.CopyDataBufDevice.AsArrayRef(), slot.Stream);
+
+                    TGPUDataInput dataInput;
+                    dataInput.FloatFeatureLayout = TGPUDataInput::EFeatureLayout::RowFirst;
+                    dataInput.ObjectCount = docCount;
+                    dataInput.FloatFeatureCount = expectedFlatVecSize;
+                    dataInput.Stride = stride;
+                    dataInput.FlatFloatsVector = slot.DataCache.CopyDataBufDevice.AsArrayRef();
+                    slot.QuantizedData.SetDimensions(Ctx.GPUModelData.BucketsCount, docCount);
+                    Ctx.QuantizeData(dataInput, &slot.QuantizedData, slot.Stream);
+                }
+                const auto hostResults = slot.DataCache.ResultsHostBuf.AsArrayRef().Slice(0, docCount);
+                Ctx.EvalQuantizedData(
+                    &slot.QuantizedData,
+                    treeStart,
+                    treeEnd,
+                    hostResults,
+                    PredictionType,
+                    slot.Stream,
+                    &slot.DataCache
+                );
+
+                auto completion = MakeHolder<TAsyncEvaluationCompletion>();
+                completion->HostResults = hostResults;
+                completion->Results = results;
+                auto evaluation = completion->Promise.GetFuture();
+                CUDA_SAFE_CALL(cudaLaunchHostFunc(slot.Stream, &TGpuEvaluator::CompleteAsyncEvaluation, completion.Get()));
+                Y_UNUSED(completion.Release());
+                slot.LastEvaluation = evaluation;
+                return evaluation;
+            }
+
             void CalcFlatSingle(
                 TConstArrayRef<float> features,
                 size_t treeStart,
@@ -212,11 +325,24 @@ namespace NCB::NModelEvaluation {
                 const TFeatureLayout* featureLayout
             ) const override {
                 ValidateInputFeatures(floatFeatures, catFeatures);
-                CB_ENSURE(
-                    catFeatures.empty(),
-                    "Cat features are not supported on GPU, should be empty"
+                if (!UseHostQuantization) {
+                    // float-only model: float features indexes are the same as flat ones
+                    CalcFlat(floatFeatures, treeStart, treeEnd, results, featureLayout);
+                    return;
+                }
+                CB_ENSURE(featureLayout == nullptr, "feature layout currenlty not supported");
+                CalcHostQuantized(
+                    [&floatFeatures](TFeaturePosition position, size_t index) -> float {
+                        return floatFeatures[index][position.Index];
+                    },
+                    [&catFeatures](TFeaturePosition position, size_t index) -> int {
+                        return catFeatures[index][position.Index];
+                    },
+                    Max(floatFeatures.size(), catFeatures.size()),
+                    treeStart,
+                    treeEnd,
+                    results
                 );
-                CalcFlat(floatFeatures, treeStart, treeEnd, results, featureLayout);
             }
 
             void Calc(
@@ -228,11 +354,24 @@ namespace NCB::NModelEvaluation {
                 const TFeatureLayout* featureLayout
             ) const override {
                 ValidateInputFeatures(floatFeatures, catFeatures);
-                CB_ENSURE(
-                    catFeatures.empty(),
-                    "Cat features are not supported on GPU, should be empty"
+                if (!UseHostQuantization) {
+                    // float-only model: float features indexes are the same as flat ones
+                    CalcFlat(floatFeatures, treeStart, treeEnd, results, featureLayout);
+                    return;
+                }
+                CB_ENSURE(featureLayout == nullptr, "feature layout currenlty not supported");
+                CalcHostQuantized(
+                    [&floatFeatures](TFeaturePosition position, size_t index) -> float {
+                        return floatFeatures[index][position.Index];
+                    },
+                    [&catFeatures](TFeaturePosition position, size_t index) -> int {
+                        return CalcCatFeatureHash(catFeatures[index][position.Index]);
+                    },
+                    Max(floatFeatures.size(), catFeatures.size()),
+                    treeStart,
+                    treeEnd,
+                    results
                 );
-                CalcFlat(floatFeatures, treeStart, treeEnd, results, featureLayout);
             }
 
             void Calc(
@@ -249,7 +388,7 @@ namespace NCB::NModelEvaluation {
                     textFeatures.empty(),
                     "Text features are not supported in GPU calc, should be empty"
                 );
-                CalcFlat(floatFeatures, treeStart, treeEnd, results, featureInfo);
+                Calc(floatFeatures, catFeatures, treeStart, treeEnd, results, featureInfo);
             }
 
             void Calc(
@@ -307,6 +446,139 @@ namespace NCB::NModelEvaluation {
                 ythrow yexception() << "Unimplemented on GPU";
             }
         private:
+            struct TAsyncEvaluationSlot : public TThrRefBase {
+                TCudaStream Stream = TCudaStream::NewStream();
+                TEvaluationDataCache DataCache;
+                TCudaQuantizedData QuantizedData;
+                NThreading::TFuture<void> LastEvaluation = NThreading::MakeFuture();
+                TMutex Lock;
+            };
+
+            struct TAsyncEvaluationCompletion {
+                NThreading::TPromise<void> Promise = NThreading::NewPromise();
+                TArrayRef<double> HostResults;
+                TArrayRef<double> Results;
+            };
+
+            // runs on CUDA callback thread after all work enqueued to the slot stream is finished, must not call CUDA API
+            static void CUDART_CB CompleteAsyncEvaluation(void* userData) {
+                THolder<TAsyncEvaluationCompletion> completion(static_cast<TAsyncEvaluationCompletion*>(userData));
+                Copy(completion->HostResults.begin(), completion->HostResults.end(), completion->Results.begin());
+                completion->Promise.SetValue();
+            }
+
+            /**
+             * Quantize objects on host with CPU binarization (including categorical features hashing and CTR
+             *  lookups) and enqueue the copy of quantized data to device
+             */
+            template <typename TFloatFeatureAccessor, typename TCatFeatureAccessor>
+            void QuantizeOnHost(
+                TFloatFeatureAccessor floatFeatureAccessor,
+                TCatFeatureAccessor catFeatureAccessor,
+                size_t docCount,
+                const TCudaStream& stream,
+                TEvaluationDataCache* dataCache,
+                TCudaQuantizedData* quantizedData
+            ) const {
+                const size_t bucketsCount = Ctx.GPUModelData.BucketsCount;
+                const size_t groupSize = WarpSize * ObjectsPerThread;
+                const size_t quantizedSize = bucketsCount * WarpSize * CeilDiv(docCount, groupSize);
+                dataCache->PrepareQuantizedDataHostBuf(bucketsCount, docCount);
+                ui8* hostQuantizedData = reinterpret_cast<ui8*>(dataCache->QuantizedDataHostBuf.Get());
+                size_t groupIdx = 0;
+                ProcessDocsInBlocks(
+                    *ModelTrees,
+                    CtrProvider,
+                    TIntrusivePtr<TTextProcessingCollection>(),
+                    floatFeatureAccessor,
+                    catFeatureAccessor,
+                    [](TFeaturePosition position, size_t index) -> TStringBuf {
+                        Y_UNUSED(position, index);
+                        CB_ENSURE(false, "Text features are not supported on GPU");
+                    },
+                    docCount,
+                    groupSize,
+                    [&] (size_t docCountInBlock, const TCPUEvaluatorQuantizedData* cpuQuantizedData) {
+                        // cpu layout is [bucketIdx][docId], gpu group layout is [bucketIdx][docId % WarpSize][docId / WarpSize]
+                        const ui8* bins = cpuQuantizedData->QuantizedData.data();
+                        ui8* groupData = hostQuantizedData + sizeof(TCudaQuantizationBucket) * bucketsCount * WarpSize * groupIdx;
+                        for (size_t bucketIdx = 0; bucketIdx < bucketsCount; ++bucketIdx) {
+                            ui8* bucketData = groupData + sizeof(TCudaQuantizationBucket) * WarpSize * bucketIdx;
+                            for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                                bucketData[sizeof(TCudaQuantizationBucket) * (docId % WarpSize) + docId / WarpSize] =
+                                    bins[bucketIdx * docCountInBlock + docId];
+                            }
+                        }
+                        ++groupIdx;
+                    },
+                    /*featureInfo*/ nullptr
+                );
+                quantizedData->SetDimensions(bucketsCount, docCount);
+                MemoryCopyAsync<TCudaQuantizationBucket>(
+                    dataCache->QuantizedDataHostBuf.Slice(0, quantizedSize),
+                    quantizedData->BinarizedFeaturesBuffer.Slice(0, quantizedSize),
+                    stream
+                );
+            }
+
+            template <typename TFloatFeatureAccessor, typename TCatFeatureAccessor>
+            void CalcHostQuantized(
+                TFloatFeatureAccessor floatFeatureAccessor,
+                TCatFeatureAccessor catFeatureAccessor,
+                size_t docCount,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results
+            ) const {
+                if (docCount == 0) {
+                    return;
+                }
+                TCudaQuantizedData quantizedData;
+                QuantizeOnHost(
+                    floatFeatureAccessor,
+                    catFeatureAccessor,
+                    docCount,
+                    Ctx.Stream,
+                    &Ctx.EvalDataCache,
+                    &quantizedData
+                );
+                Ctx.EvalDataCache.PrepareCopyBufs(0, docCount);
+                Ctx.EvalQuantizedData(&quantizedData, treeStart, treeEnd, results, PredictionType);
+            }
+
+            void InitAsyncSlots(size_t slotCount) {
+                CB_ENSURE(slotCount > 0, "Async stream count should be positive");
+                AsyncSlots.clear();
+                for (size_t slotIdx = 0; slotIdx < slotCount; ++slotIdx) {
+                    AsyncSlots.push_back(MakeIntrusive<TAsyncEvaluationSlot>());
+                }
+            }
+
+            size_t GetValidatedFlatFeatureVectorSize(
+                TConstArrayRef<TConstArrayRef<float>> features,
+                const TFeatureLayout* featureLayout
+            ) const {
+                CB_ENSURE(featureLayout == nullptr, "feature layout currenlty not supported");
+                if (!featureLayout) {
+                    featureLayout = ExtFeatureLayout.Get();
+                }
+                size_t expectedFlatVecSize = ModelTrees->GetFlatFeatureVectorExpectedSize();
+                if (featureLayout && featureLayout->FlatIndexes) {
+                    CB_ENSURE(
+                        featureLayout->FlatIndexes->size() >= expectedFlatVecSize,
+                        "Feature layout FlatIndexes expected to be at least " << expectedFlatVecSize << " long"
+                    );
+                    expectedFlatVecSize = *MaxElement(featureLayout->FlatIndexes->begin(), featureLayout->FlatIndexes->end());
+                }
+                for (const auto& flatFeaturesVec : features) {
+                    CB_ENSURE(
+                        flatFeaturesVec.size() >= expectedFlatVecSize,
+                        "insufficient flat features vector size: " << flatFeaturesVec.size() << " expected: " << expectedFlatVecSize
+                    );
+                }
+                return expectedFlatVecSize;
+            }
+
             template <typename TCatFeatureContainer = TConstArrayRef<int>>
             void ValidateInputFeatures(
                 TConstArrayRef<TConstArrayRef<float>> floatFeatures,
@@ -342,8 +614,14 @@ namespace NCB::NModelEvaluation {
         private:
             EPredictionType PredictionType = EPredictionType::RawFormulaVal;
             TCOWTreeWrapper ModelTrees;
+            TIntrusivePtr<ICtrProvider> CtrProvider;
+            // models with categorical features are quantized on host and evaluated on device
+            bool UseHostQuantization = false;
             TMaybe<TFeatureLayout> ExtFeatureLayout;
             TGPUCatboostEvaluationContext Ctx;
+            // ring of streams with own buffers for CalcFlatAsync, shared between clones
+            TVector<TIntrusivePtr<TAsyncEvaluationSlot>> AsyncSlots;
+            mutable TAtomic NextAsyncSlot = 0;
         };
     }
 
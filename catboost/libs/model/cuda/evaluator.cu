@@ -42,7 +42,6 @@ struct TFeatureAccessor {
     }
 };
 
-constexpr ui32 ObjectsPerThread = 4;
 constexpr ui32 TreeSubBlockWidth = 8;
 constexpr ui32 ExtTreeBlockWidth = 128;
 constexpr ui32 QuantizationDocBlockSize = 256;
@@ -78,6 +77,19 @@ void TEvaluationDataCache::PrepareCopyBufs(size_t bufSize, size_t objectsCount)
     }
 }
 
+void TEvaluationDataCache::PrepareResultsHostBuf(size_t objectsCount) {
+    if (ResultsHostBuf.Size() < objectsCount) {
+        ResultsHostBuf = TCudaVec<double>(AlignBy<2048>(objectsCount), EMemoryType::Host);
+    }
+}
+
+void TEvaluationDataCache::PrepareQuantizedDataHostBuf(size_t bucketsCount, size_t objectsCount) {
+    const size_t bufSize = bucketsCount * WarpSize * NKernel::CeilDivide<size_t>(objectsCount, WarpSize * ObjectsPerThread);
+    if (QuantizedDataHostBuf.Size() < bufSize) {
+        QuantizedDataHostBuf = TCudaVec<TCudaQuantizationBucket>(AlignBy<2048>(bufSize), EMemoryType::Host);
+    }
+}
+
 template<typename TFloatFeatureAccessor>
 __launch_bounds__(QuantizationDocBlockSize, 1)
 __global__ void Binarize(
@@ -286,30 +298,42 @@ void TGPUCatboostEvaluationContext::EvalQuantizedData(
     TArrayRef<double> result,
     NCB::NModelEvaluation::EPredictionType predictionType
     ) const {
+    EvalQuantizedData(data, treeStart, treeEnd, result, predictionType, Stream, &EvalDataCache);
+}
+
+void TGPUCatboostEvaluationContext::EvalQuantizedData(
+    const TCudaQuantizedData* data,
+    size_t treeStart,
+    size_t treeEnd,
+    TArrayRef<double> result,
+    NCB::NModelEvaluation::EPredictionType predictionType,
+    const TCudaStream& stream,
+    TEvaluationDataCache* dataCache
+    ) const {
     const dim3 treeCalcDimBlock(EvalDocBlockSize, TreeSubBlockWidth);
     const dim3 treeCalcDimGrid(
         NKernel::CeilDivide<unsigned int>(GPUModelData.TreeSizes.Size(), TreeSubBlockWidth * ExtTreeBlockWidth),
         NKernel::CeilDivide<unsigned int>(data->GetObjectsCount(), EvalDocBlockSize * ObjectsPerThread)
     );
-    ClearMemoryAsync(EvalDataCache.ResultsFloatBuf.AsArrayRef(), Stream);
-    EvalObliviousTrees<<<treeCalcDimGrid, treeCalcDimBlock, 0, Stream>>> (
+    ClearMemoryAsync(dataCache->ResultsFloatBuf.AsArrayRef(), stream);
+    EvalObliviousTrees<<<treeCalcDimGrid, treeCalcDimBlock, 0, stream>>> (
         data->BinarizedFeaturesBuffer.Get(),
         GPUModelData.TreeSizes.Get(),
         GPUModelData.TreeSizes.Size(),
         GPUModelData.TreeStartOffsets.Get(),
         GPUModelData.TreeSplits.Get(),
         GPUModelData.TreeFirstLeafOffsets.Get(),
-        GPUModelData.FloatFeatureForBucketIdx.Size(),
+        GPUModelData.BucketsCount,
         GPUModelData.ModelLeafs.Get(),
         data->GetObjectsCount(),
-        EvalDataCache.ResultsFloatBuf.Get()
+        dataCache->ResultsFloatBuf.Get()
     );
     switch (predictionType) {
     case NCB::NModelEvaluation::EPredictionType::RawFormulaVal:
-        ProcessResults<NCB::NModelEvaluation::EPredictionType::RawFormulaVal, true><<<1, 256, 0, Stream>>> (
-            EvalDataCache.ResultsFloatBuf.Get(),
+        ProcessResults<NCB::NModelEvaluation::EPredictionType::RawFormulaVal, true><<<1, 256, 0, stream>>> (
+            dataCache->ResultsFloatBuf.Get(),
             data->GetObjectsCount(),
-            EvalDataCache.ResultsDoubleBuf.Get(),
+            dataCache->ResultsDoubleBuf.Get(),
             1
         );
         break;
@@ -317,26 +341,34 @@ void TGPUCatboostEvaluationContext::EvalQuantizedData(
         ythrow yexception() << "Unimplemented on GPU";
         break;
     case NCB::NModelEvaluation::EPredictionType::Probability:
-        ProcessResults<NCB::NModelEvaluation::EPredictionType::Probability, true><<<1, 256, 0, Stream>>> (
-            EvalDataCache.ResultsFloatBuf.Get(),
+        ProcessResults<NCB::NModelEvaluation::EPredictionType::Probability, true><<<1, 256, 0, stream>>> (
+            dataCache->ResultsFloatBuf.Get(),
             data->GetObjectsCount(),
-            EvalDataCache.ResultsDoubleBuf.Get(),
+            dataCache->ResultsDoubleBuf.Get(),
             1
         );
         break;
     case NCB::NModelEvaluation::EPredictionType::Class:
-        ProcessResults<NCB::NModelEvaluation::EPredictionType::Class, true><<<1, 256, 0, Stream>>> (
-            EvalDataCache.ResultsFloatBuf.Get(),
+        ProcessResults<NCB::NModelEvaluation::EPredictionType::Class, true><<<1, 256, 0, stream>>> (
+            dataCache->ResultsFloatBuf.Get(),
             data->GetObjectsCount(),
-            EvalDataCache.ResultsDoubleBuf.Get(),
+            dataCache->ResultsDoubleBuf.Get(),
             1
         );
         break;
     }
-    MemoryCopyAsync<double>(EvalDataCache.ResultsDoubleBuf.Slice(0, data->GetObjectsCount()), result, Stream);
+    MemoryCopyAsync<double>(dataCache->ResultsDoubleBuf.Slice(0, data->GetObjectsCount()), result, stream);
 }
 
 void TGPUCatboostEvaluationContext::QuantizeData(const TGPUDataInput& dataInput, TCudaQuantizedData* quantizedData) const{
+    QuantizeData(dataInput, quantizedData, Stream);
+}
+
+void TGPUCatboostEvaluationContext::QuantizeData(
+    const TGPUDataInput& dataInput,
+    TCudaQuantizedData* quantizedData,
+    const TCudaStream& stream
+) const {
     const dim3 quantizationDimBlock(QuantizationDocBlockSize, 1);
     const dim3 quantizationDimGrid(
         NKernel::CeilDivide<unsigned int>(dataInput.ObjectCount, QuantizationDocBlockSize * ObjectsPerThread),
@@ -348,13 +380,13 @@ void TGPUCatboostEvaluationContext::QuantizeData(const TGPUDataInput& dataInput,
         floatFeatureAccessor.Stride = dataInput.Stride;
         floatFeatureAccessor.ObjectCount = dataInput.ObjectCount;
         floatFeatureAccessor.FeaturesPtr = dataInput.FlatFloatsVector.data();
-        Binarize<<<quantizationDimGrid, quantizationDimBlock, 0, Stream>>> (
+        Binarize<<<quantizationDimGrid, quantizationDimBlock, 0, stream>>> (
             floatFeatureAccessor,
             GPUModelData.FlatBordersVector.Get(),
             GPUModelData.BordersOffsets.Get(),
             GPUModelData.BordersCount.Get(),
             GPUModelData.FloatFeatureForBucketIdx.Get(),
-            GPUModelData.FloatFeatureForBucketIdx.Size(),
+            GPUModelData.BucketsCount,
             quantizedData->BinarizedFeaturesBuffer.Get()
         );
     } else {
@@ -363,13 +395,13 @@ void TGPUCatboostEvaluationContext::QuantizeData(const TGPUDataInput& dataInput,
         floatFeatureAccessor.ObjectCount = dataInput.ObjectCount;
         floatFeatureAccessor.Stride = dataInput.Stride;
         floatFeatureAccessor.FeaturesPtr = dataInput.FlatFloatsVector.data();
-        Binarize<<<quantizationDimGrid, quantizationDimBlock, 0, Stream>>> (
+        Binarize<<<quantizationDimGrid, quantizationDimBlock, 0, stream>>> (
             floatFeatureAccessor,
             GPUModelData.FlatBordersVector.Get(),
             GPUModelData.BordersOffsets.Get(),
             GPUModelData.BordersCount.Get(),
             GPUModelData.FloatFeatureForBucketIdx.Get(),
-            GPUModelData.FloatFeatureForBucketIdx.Size(),
+            GPUModelData.BucketsCount,
             quantizedData->BinarizedFeaturesBuffer.Get()
         );
     }
@@ -382,7 +414,7 @@ void TGPUCatboostEvaluationContext::EvalData(
     TArrayRef<double> result,
     NCB::NModelEvaluation::EPredictionType predictionType) const {
     TCudaQuantizedData quantizedData;
-    quantizedData.SetDimensions(GPUModelData.FloatFeatureForBucketIdx.Size(), dataInput.ObjectCount);
+    quantizedData.SetDimensions(GPUModelData.BucketsCount, dataInput.ObjectCount);
     QuantizeData(dataInput, &quantizedData);
     EvalQuantizedData(&quantizedData, treeStart, treeEnd, result, predictionType);
 }
@@ -7,6 +7,8 @@
 
 
 constexpr ui32 WarpSize = 32;
+// each TCudaQuantizationBucket holds one bucket of ObjectsPerThread objects strided by WarpSize
+constexpr ui32 ObjectsPerThread = 4;
 
 struct TGPURepackedBin {
     ui32 FeatureIdx = 0;
@@ -30,6 +32,8 @@ struct TGPUModelData : public TThrRefBase {
     TCudaVec<TCudaEvaluatorLeafType> ModelLeafs;
     TCudaVec<ui32> FloatFeatureForBucketIdx;
     TVector<bool> UsedInModel;
+    // effective binary features buckets count, equals used float features count for float-only models
+    ui32 BucketsCount = 0;
 };
 
 struct TGPUDataInput {
@@ -66,8 +70,14 @@ public:
     TCudaVec<float> CopyDataBufDevice;
     TCudaVec<float> ResultsFloatBuf;
     TCudaVec<double> ResultsDoubleBuf;
+    // pinned host buffer for asynchronous device to host results copy
+    TCudaVec<double> ResultsHostBuf;
+    // pinned host buffer for quantized data computed on host, layout matches TCudaQuantizedData
+    TCudaVec<TCudaQuantizationBucket> QuantizedDataHostBuf;
 public:
     void PrepareCopyBufs(size_t bufSize, size_t objectsCount);
+    void PrepareResultsHostBuf(size_t objectsCount);
+    void PrepareQuantizedDataHostBuf(size_t bucketsCount, size_t objectsCount);
 };
 
 class TGPUCatboostEvaluationContext {
@@ -83,6 +93,19 @@ public:
         size_t treeEnd,
         TArrayRef<double> result,
         NCB::NModelEvaluation::EPredictionType predictionType) const;
+    // same as above but enqueue all work to stream using dataCache buffers, result should be device or pinned memory
+    void QuantizeData(
+        const TGPUDataInput& dataInput,
+        TCudaQuantizedData* quantizedData,
+        const TCudaStream& stream) const;
+    void EvalQuantizedData(
+        const TCudaQuantizedData* data,
+        size_t treeStart,
+        size_t treeEnd,
+        TArrayRef<double> result,
+        NCB::NModelEvaluation::EPredictionType predictionType,
+        const TCudaStream& stream,
+        TEvaluationDataCache* dataCache) const;
     void EvalData(
         const TGPUDataInput& dataInput,
         size_t treeStart,
@@ -5,10 +5,14 @@
 #include "features.h"
 
 #include <library/cpp/object_factory/object_factory.h>
+#include <library/cpp/threading/future/future.h>
 
 #include <util/generic/array_ref.h>
 #include <util/generic/maybe.h>
 #include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/system/compiler.h>
 
 namespace NCB {  // split due to CUDA-compiler inability to parse nested namespace definitions
     namespace NModelEvaluation {
@@ -53,6 +57,38 @@ namespace NCB {  // split due to CUDA-compiler inability to parse nested namespa
             }
         };
 
+        //! Cumulative statistics of one evaluation phase
+        struct TEvaluationPhaseStats {
+            ui64 Nanoseconds = 0;
+            ui64 DocCount = 0;
+            ui64 TreeCount = 0;  // trees evaluated per document, summed over blocks, only for Trees phase
+        };
+
+        /**
+         * Evaluation time split into phases, collected when evaluator profiling is enabled.
+         * Binarization covers float, one hot and CTR values quantization, Ctrs covers CTR table lookups,
+         *  TextFeatures covers text feature estimation and Trees covers tree traversal.
+         */
+        struct TEvaluationProfile {
+            TEvaluationPhaseStats Binarization;
+            TEvaluationPhaseStats Ctrs;
+            TEvaluationPhaseStats TextFeatures;
+            TEvaluationPhaseStats Trees;
+        };
+
+        /**
+         * Feature values column, value for object objectIdx is Data[objectIdx * Stride]
+         */
+        template <typename T>
+        struct TFeatureColumn {
+            const T* Data = nullptr;
+            size_t Stride = 1;
+
+            Y_FORCE_INLINE T operator[](size_t objectIdx) const {
+                return Data[objectIdx * Stride];
+            }
+        };
+
         class IModelEvaluator {
         public:
             virtual ~IModelEvaluator() = default;
@@ -69,6 +105,20 @@ namespace NCB {  // split due to CUDA-compiler inability to parse nested namespa
 
             virtual void SetProperty(const TStringBuf propName, const TStringBuf propValue) = 0;
 
+            //! Evaluator statistics and settings, Nothing() if evaluator doesn't have such property
+            virtual TMaybe<TString> GetProperty(const TStringBuf propName) const {
+                Y_UNUSED(propName);
+                return Nothing();
+            }
+
+            /**
+             * Statistics collected since profiling was enabled with SetProperty("EnableProfiling", "true"),
+             *  all zeros if profiling is disabled or not supported by evaluator
+             */
+            virtual TEvaluationProfile GetProfile() const {
+                return {};
+            }
+
             // TODO(kirillovs): maybe write special class for results (on gpu it'll hold floats in possibly managed memory)
             TVector<double> CreateVectorForPredictions(size_t docCount) const {
                 switch (GetPredictionType())
@@ -117,6 +167,22 @@ namespace NCB {  // split due to CUDA-compiler inability to parse nested namespa
                 const TFeatureLayout* featureInfo = nullptr
             ) const = 0;
 
+            /**
+             * Asynchronous version of CalcFlat. Features are consumed before return, results must stay alive
+             *  until the returned future is ready. Input validation errors are thrown synchronously.
+             * Default implementation evaluates synchronously and returns a ready future.
+             */
+            virtual NThreading::TFuture<void> CalcFlatAsync(
+                TConstArrayRef<TConstArrayRef<float>> features,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo = nullptr
+            ) const {
+                CalcFlat(features, treeStart, treeEnd, results, featureInfo);
+                return NThreading::MakeFuture();
+            }
+
             void CalcFlat(
                 TConstArrayRef<TConstArrayRef<float>> features,
                 TArrayRef<double> results,
@@ -159,6 +225,71 @@ namespace NCB {  // split due to CUDA-compiler inability to parse nested namespa
                 const TFeatureLayout* featureInfo = nullptr
             ) const = 0;
 
+            /**
+             * Evaluate raw formula values of single dimension model for objects classified by
+             *  `rawFormulaVal > threshold`. Trees are evaluated in chunks of treeChunkSize trees, after each chunk
+             *  objects whose prediction can't cross threshold with the remaining trees are dropped from evaluation.
+             * For dropped objects results hold the bound of possible full prediction nearest to threshold, so
+             *  `results[i] > threshold` is the same for all objects as with full evaluation.
+             * Default implementation evaluates all trees.
+             */
+            virtual void CalcWithEarlyExit(
+                TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+                TConstArrayRef<TConstArrayRef<int>> catFeatures,
+                double threshold,
+                size_t treeChunkSize,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo = nullptr
+            ) const {
+                Y_UNUSED(threshold, treeChunkSize);
+                Calc(floatFeatures, catFeatures, 0, GetTreeCount(), results, featureInfo);
+            }
+
+            /**
+             * Evaluate on columnar data without transposing it to per object vectors.
+             * @param floatColumns columns indexed by float feature index
+             * @param catColumns columns of hashed categorical feature values indexed by categorical feature index
+             * Columns of features not used by the model may have null Data.
+             * Default implementation gathers columns to per object vectors.
+             */
+            virtual void CalcColumnar(
+                TConstArrayRef<TFeatureColumn<float>> floatColumns,
+                TConstArrayRef<TFeatureColumn<int>> catColumns,
+                size_t docCount,
+                size_t treeStart,
+                size_t treeEnd,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo = nullptr
+            ) const {
+                TVector<float> floatValues(docCount * floatColumns.size(), 0.0f);
+                TVector<int> catValues(docCount * catColumns.size(), 0);
+                for (size_t featureIdx = 0; featureIdx < floatColumns.size(); ++featureIdx) {
+                    if (floatColumns[featureIdx].Data) {
+                        for (size_t docId = 0; docId < docCount; ++docId) {
+                            floatValues[docId * floatColumns.size() + featureIdx] = floatColumns[featureIdx][docId];
+                        }
+                    }
+                }
+                for (size_t featureIdx = 0; featureIdx < catColumns.size(); ++featureIdx) {
+                    if (catColumns[featureIdx].Data) {
+                        for (size_t docId = 0; docId < docCount; ++docId) {
+                            catValues[docId * catColumns.size() + featureIdx] = catColumns[featureIdx][docId];
+                        }
+                    }
+                }
+                TVector<TConstArrayRef<float>> floatFeatures;
+                TVector<TConstArrayRef<int>> catFeatures;
+                for (size_t docId = 0; docId < docCount; ++docId) {
+                    if (!floatColumns.empty()) {
+                        floatFeatures.emplace_back(floatValues.data() + docId * floatColumns.size(), floatColumns.size());
+                    }
+                    if (!catColumns.empty()) {
+                        catFeatures.emplace_back(catValues.data() + docId * catColumns.size(), catColumns.size());
+                    }
+                }
+                Calc(floatFeatures, catFeatures, treeStart, treeEnd, results, featureInfo);
+            }
+
             virtual void Calc(
                 TConstArrayRef<TConstArrayRef<float>> floatFeatures,
                 TConstArrayRef<TConstArrayRef<TStringBuf>> catFeatures,
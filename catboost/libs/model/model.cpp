@@ -5,6 +5,8 @@
 #include "model_build_helper.h"
 #include "static_ctr_provider.h"
 
+#include "cpu/quantization.h"
+
 #include <catboost/libs/model/flatbuffers/model.fbs.h>
 
 #include <catboost/libs/cat_feature/cat_feature.h>
@@ -19,17 +21,24 @@
 #include <library/cpp/json/json_reader.h>
 #include <library/cpp/dbg_output/dump.h>
 #include <library/cpp/dbg_output/auto.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
 
+#include <util/datetime/base.h>
 #include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
 #include <util/generic/fwd.h>
 #include <util/generic/guid.h>
+#include <util/generic/map.h>
 #include <util/generic/variant.h>
 #include <util/generic/xrange.h>
 #include <util/generic/ylimits.h>
 #include <util/generic/ymath.h>
+#include <util/memory/blob.h>
 #include <util/string/builder.h>
+#include <util/stream/mem.h>
 #include <util/stream/str.h>
+#include <util/system/fs.h>
+#include <util/system/info.h>
 
 
 static const char MODEL_FILE_DESCRIPTOR_CHARS[4] = {'C', 'B', 'M', '1'};
@@ -71,6 +80,13 @@ TFullModel ReadModel(const void* binaryBuffer, size_t binaryBufferSize, EModelTy
     return modelLoader->ReadModel(binaryBuffer, binaryBufferSize);
 }
 
+TFullModel ReadModelMmap(const TString& modelFile) {
+    CB_ENSURE(NFs::Exists(modelFile), "Model file doesn't exist: " << modelFile);
+    TFullModel model;
+    model.InitNonOwning(TBlob::FromFile(modelFile));
+    return model;
+}
+
 TString SerializeModel(const TFullModel& model) {
     TStringStream ss;
     OutputModel(model, &ss);
@@ -152,14 +168,25 @@ void TModelTrees::TruncateTrees(size_t begin, size_t end) {
     CB_ENSURE(end <= TreeSplits.size(), "end tree index should be not greater than tree count.");
     auto savedScaleAndBias = GetScaleAndBias();
     TObliviousTreeBuilder builder(FloatFeatures, CatFeatures, TextFeatures, ApproxDimension);
-    const auto& leafOffsets = RuntimeData->TreeFirstLeafOffsets;
+    const auto& leafOffsets = GetRuntimeData().TreeFirstLeafOffsets;
+    if (begin < end) {
+        const size_t leafValuesBegin = leafOffsets[begin];
+        const size_t leafValuesEnd = (end < TreeSizes.size()) ? leafOffsets[end] : LeafValues.size();
+        builder.Reserve(
+            end - begin,
+            (end < TreeSizes.size() ? TreeStartOffsets[end] : TreeSplits.size()) - TreeStartOffsets[begin],
+            leafValuesEnd - leafValuesBegin,
+            LeafWeights.empty() ? 0 : (leafValuesEnd - leafValuesBegin) / ApproxDimension
+        );
+    }
+    TVector<TModelSplit> modelSplits;
     for (size_t treeIdx = begin; treeIdx < end; ++treeIdx) {
-        TVector<TModelSplit> modelSplits;
+        modelSplits.clear();
         for (int splitIdx = TreeStartOffsets[treeIdx];
              splitIdx < TreeStartOffsets[treeIdx] + TreeSizes[treeIdx];
              ++splitIdx)
         {
-            modelSplits.push_back(RuntimeData->BinFeatures[TreeSplits[splitIdx]]);
+            modelSplits.push_back(GetRuntimeData().BinFeatures[TreeSplits[splitIdx]]);
         }
         TConstArrayRef<double> leafValuesRef(
             LeafValues.begin() + leafOffsets[treeIdx],
@@ -178,6 +205,62 @@ void TModelTrees::TruncateTrees(size_t begin, size_t end) {
     this->SetScaleAndBias(savedScaleAndBias);
 }
 
+void TModelTrees::CompactTrees() {
+    CB_ENSURE(IsOblivious(), "Compaction supports only symmetric trees");
+    auto savedScaleAndBias = GetScaleAndBias();
+    const auto& leafOffsets = GetRuntimeData().TreeFirstLeafOffsets;
+
+    // trees with the same split sequence are merged into the first of them, leaf weights of merged trees are
+    // the same partition of learn objects, so the first tree weights are kept
+    TMap<TVector<int>, size_t> splitsToCompactedTreeIdx;
+    TVector<size_t> compactedTreeIds;
+    TVector<TVector<double>> compactedLeafValues;
+    for (size_t treeIdx = 0; treeIdx < TreeSizes.size(); ++treeIdx) {
+        TVector<int> treeSplits(
+            TreeSplits.begin() + TreeStartOffsets[treeIdx],
+            TreeSplits.begin() + TreeStartOffsets[treeIdx] + TreeSizes[treeIdx]
+        );
+        const auto leafValuesBegin = LeafValues.begin() + leafOffsets[treeIdx];
+        const auto leafValuesEnd = leafValuesBegin + ApproxDimension * (1u << TreeSizes[treeIdx]);
+        const auto [it, inserted] = splitsToCompactedTreeIdx.emplace(std::move(treeSplits), compactedTreeIds.size());
+        if (inserted) {
+            compactedTreeIds.push_back(treeIdx);
+            compactedLeafValues.emplace_back(leafValuesBegin, leafValuesEnd);
+        } else {
+            auto& treeLeafValues = compactedLeafValues[it->second];
+            for (size_t i = 0; i < treeLeafValues.size(); ++i) {
+                treeLeafValues[i] += leafValuesBegin[i];
+            }
+        }
+    }
+    if (compactedTreeIds.size() == TreeSizes.size()) {
+        return;
+    }
+
+    // rebuilding from model splits also drops feature borders not referenced by any tree
+    TObliviousTreeBuilder builder(FloatFeatures, CatFeatures, TextFeatures, ApproxDimension);
+    for (size_t compactedTreeIdx = 0; compactedTreeIdx < compactedTreeIds.size(); ++compactedTreeIdx) {
+        const size_t treeIdx = compactedTreeIds[compactedTreeIdx];
+        TVector<TModelSplit> modelSplits;
+        for (int splitIdx = TreeStartOffsets[treeIdx];
+             splitIdx < TreeStartOffsets[treeIdx] + TreeSizes[treeIdx];
+             ++splitIdx)
+        {
+            modelSplits.push_back(GetRuntimeData().BinFeatures[TreeSplits[splitIdx]]);
+        }
+        builder.AddTree(
+            modelSplits,
+            compactedLeafValues[compactedTreeIdx],
+            LeafWeights.empty() ? TConstArrayRef<double>() : TConstArrayRef<double>(
+                LeafWeights.begin() + leafOffsets[treeIdx] / ApproxDimension,
+                LeafWeights.begin() + leafOffsets[treeIdx] / ApproxDimension + (1ull << TreeSizes[treeIdx])
+            )
+        );
+    }
+    builder.Build(this);
+    this->SetScaleAndBias(savedScaleAndBias);
+}
+
 flatbuffers::Offset<NCatBoostFbs::TModelTrees>
 TModelTrees::FBSerialize(TModelPartsCachingSerializer& serializer) const {
     std::vector<flatbuffers::Offset<NCatBoostFbs::TCatFeature>> catFeaturesOffsets;
@@ -233,6 +316,86 @@ TModelTrees::FBSerialize(TModelPartsCachingSerializer& serializer) const {
     );
 }
 
+namespace {
+    class TBitvectorLayoutBuilder {
+    public:
+        TBitvectorLayoutBuilder(
+            TConstArrayRef<TNonSymmetricTreeStepNode> stepNodes,
+            TConstArrayRef<ui32> nodeIdToLeafId,
+            TConstArrayRef<TRepackedBin> repackedBins,
+            TModelTrees::TRuntimeData* runtimeData
+        )
+            : StepNodes(stepNodes)
+            , NodeIdToLeafId(nodeIdToLeafId)
+            , RepackedBins(repackedBins)
+            , RuntimeData(runtimeData)
+        {}
+
+        void AddTree(ui32 treeStartNodeId) {
+            RuntimeData->BitvectorTreeNodeOffsets.push_back(RuntimeData->BitvectorNodes.size());
+            RuntimeData->BitvectorTreeLeafOffsets.push_back(RuntimeData->BitvectorLeafValueIndexes.size());
+            AddSubtree(treeStartNodeId);
+        }
+
+        void Finish() {
+            RuntimeData->BitvectorTreeNodeOffsets.push_back(RuntimeData->BitvectorNodes.size());
+            RuntimeData->BitvectorTreeLeafOffsets.push_back(RuntimeData->BitvectorLeafValueIndexes.size());
+        }
+
+    private:
+        using TLeafRange = std::pair<ui32, ui32>;
+
+        static ui64 GetRangeMask(TLeafRange range) {
+            const ui64 endMask = range.second == TNonSymmetricTreeBitvectorNode::MaxLeafCount
+                ? Max<ui64>()
+                : (1ull << range.second) - 1;
+            return endMask & ~((1ull << range.first) - 1);
+        }
+
+        TLeafRange AddLeaf(ui32 nodeId) {
+            const ui32 leafIdx = RuntimeData->BitvectorLeafValueIndexes.size() - RuntimeData->BitvectorTreeLeafOffsets.back();
+            Y_ASSERT(leafIdx < TNonSymmetricTreeBitvectorNode::MaxLeafCount);
+            RuntimeData->BitvectorLeafValueIndexes.push_back(NodeIdToLeafId[nodeId]);
+            return {leafIdx, leafIdx + 1};
+        }
+
+        TLeafRange AddSubtree(ui32 nodeId) {
+            const auto& stepNode = StepNodes[nodeId];
+            if (stepNode.LeftSubtreeDiff == 0 && stepNode.RightSubtreeDiff == 0) {
+                return AddLeaf(nodeId);
+            }
+            const size_t bitvectorNodeIdx = RuntimeData->BitvectorNodes.size();
+            RuntimeData->BitvectorNodes.emplace_back();
+            RuntimeData->BitvectorNodes.back().Split = RepackedBins[nodeId];
+            const TLeafRange leftLeaves = stepNode.LeftSubtreeDiff == 0
+                ? AddLeaf(nodeId)
+                : AddSubtree(nodeId + stepNode.LeftSubtreeDiff);
+            const TLeafRange rightLeaves = stepNode.RightSubtreeDiff == 0
+                ? AddLeaf(nodeId)
+                : AddSubtree(nodeId + stepNode.RightSubtreeDiff);
+            auto& bitvectorNode = RuntimeData->BitvectorNodes[bitvectorNodeIdx];
+            bitvectorNode.LeftMask = ~GetRangeMask(rightLeaves);
+            bitvectorNode.RightMask = ~GetRangeMask(leftLeaves);
+            return {leftLeaves.first, rightLeaves.second};
+        }
+
+    private:
+        TConstArrayRef<TNonSymmetricTreeStepNode> StepNodes;
+        TConstArrayRef<ui32> NodeIdToLeafId;
+        TConstArrayRef<TRepackedBin> RepackedBins;
+        TModelTrees::TRuntimeData* RuntimeData;
+    };
+}
+
+void TModelTrees::InitRuntimeDataLazily() const {
+    static TAdaptiveLock lazyInitLock;
+    with_lock(lazyInitLock) {
+        if (!AtomicGet(RuntimeDataReady)) {
+            UpdateRuntimeData();
+        }
+    }
+}
+
 void TModelTrees::UpdateRuntimeData() const {
     struct TFeatureSplitId {
         ui32 FeatureIdx = 0;
@@ -243,10 +406,13 @@ void TModelTrees::UpdateRuntimeData() const {
     auto& ref = RuntimeData.GetRef();
 
     ref.TreeFirstLeafOffsets.resize(TreeSizes.size());
+    TVector<ui32> treeLeafCounts(TreeSizes.size());
+    ui32 maxTreeLeafCount = 0;
     if (IsOblivious()) {
         size_t currentOffset = 0;
         for (size_t i = 0; i < TreeSizes.size(); ++i) {
             ref.TreeFirstLeafOffsets[i] = currentOffset;
+            treeLeafCounts[i] = 1u << TreeSizes[i];
             currentOffset += (1 << TreeSizes[i]) * ApproxDimension;
         }
     } else {
@@ -273,6 +439,8 @@ void TModelTrees::UpdateRuntimeData() const {
             Y_ASSERT(valueNodeCount > 0);
             Y_ASSERT(maxLeafValueIndex == minLeafValueIndex + (valueNodeCount - 1) * ApproxDimension);
             ref.TreeFirstLeafOffsets[treeId] = minLeafValueIndex;
+            treeLeafCounts[treeId] = valueNodeCount;
+            maxTreeLeafCount = Max(maxTreeLeafCount, valueNodeCount);
         }
     }
 
@@ -379,6 +547,67 @@ void TModelTrees::UpdateRuntimeData() const {
         }
         ref.RepackedBins.push_back(rb);
     }
+
+    if (IsOblivious()) {
+        const auto binsLess = [] (const TRepackedBin& lhs, const TRepackedBin& rhs) {
+            return std::tie(lhs.FeatureIndex, lhs.XorMask, lhs.SplitIdx)
+                < std::tie(rhs.FeatureIndex, rhs.XorMask, rhs.SplitIdx);
+        };
+        TVector<TRepackedBin> uniqueBins = ref.RepackedBins;
+        Sort(uniqueBins, binsLess);
+        uniqueBins.erase(
+            std::unique(
+                uniqueBins.begin(),
+                uniqueBins.end(),
+                [&binsLess] (const TRepackedBin& lhs, const TRepackedBin& rhs) {
+                    return !binsLess(lhs, rhs) && !binsLess(rhs, lhs);
+                }
+            ),
+            uniqueBins.end()
+        );
+        if (uniqueBins.size() <= (size_t)Max<ui16>() + 1) {
+            ref.SharedSplitTreeBins.reserve(ref.RepackedBins.size());
+            for (const auto& bin : ref.RepackedBins) {
+                TRepackedBin& sharedBin = ref.SharedSplitTreeBins.emplace_back();
+                sharedBin.FeatureIndex = LowerBound(uniqueBins.begin(), uniqueBins.end(), bin, binsLess) - uniqueBins.begin();
+                sharedBin.SplitIdx = 1;
+            }
+            ref.UniqueRepackedBins = std::move(uniqueBins);
+        }
+    }
+
+    const bool hasAllLeafValues = AllOf(
+        xrange(TreeSizes.size()),
+        [&] (size_t treeId) { return ref.TreeFirstLeafOffsets[treeId] + treeLeafCounts[treeId] <= LeafValues.size(); }
+    );
+    if (ApproxDimension == 1 && hasAllLeafValues) {
+        const size_t treeCount = TreeSizes.size();
+        ref.RemainingTreesMinLeafSums.assign(treeCount + 1, 0.0);
+        ref.RemainingTreesMaxLeafSums.assign(treeCount + 1, 0.0);
+        for (size_t treeId = treeCount; treeId-- > 0;) {
+            const auto treeLeafValues = MakeArrayRef(
+                LeafValues.data() + ref.TreeFirstLeafOffsets[treeId],
+                treeLeafCounts[treeId]
+            );
+            const auto minMaxLeaf = MinMaxElement(treeLeafValues.begin(), treeLeafValues.end());
+            ref.RemainingTreesMinLeafSums[treeId] = ref.RemainingTreesMinLeafSums[treeId + 1] + *minMaxLeaf.first;
+            ref.RemainingTreesMaxLeafSums[treeId] = ref.RemainingTreesMaxLeafSums[treeId + 1] + *minMaxLeaf.second;
+        }
+    }
+
+    if (!IsOblivious() && maxTreeLeafCount <= TNonSymmetricTreeBitvectorNode::MaxLeafCount) {
+        TBitvectorLayoutBuilder bitvectorLayoutBuilder(
+            NonSymmetricStepNodes,
+            NonSymmetricNodeIdToLeafId,
+            ref.RepackedBins,
+            &ref
+        );
+        for (const auto treeStartOffset : TreeStartOffsets) {
+            bitvectorLayoutBuilder.AddTree(treeStartOffset);
+        }
+        bitvectorLayoutBuilder.Finish();
+    }
+    AtomicSet(RuntimeDataReady, 1);
 }
 
 void TModelTrees::DropUnusedFeatures() {
@@ -453,6 +682,7 @@ void TModelTrees::SetScaleAndBias(const TScaleAndBias& scaleAndBias) {
 }
 
 void TModelTrees::FBDeserialize(const NCatBoostFbs::TModelTrees* fbObj) {
+    ResetRuntimeData();
     ApproxDimension = fbObj->ApproxDimension();
     if (fbObj->TreeSplits()) {
         TreeSplits.assign(fbObj->TreeSplits()->begin(), fbObj->TreeSplits()->end());
@@ -516,6 +746,91 @@ void TFullModel::CalcFlat(
     GetCurrentEvaluator()->CalcFlat(features, treeStart, treeEnd, results, featureInfo);
 }
 
+// minimal work per executor block to make scheduling overhead negligible
+static constexpr size_t MIN_PARALLEL_CALC_DOC_COUNT = 1024;
+static constexpr size_t MIN_PARALLEL_CALC_TREE_COUNT = 256;
+
+void TFullModel::CalcFlatParallel(
+    TConstArrayRef<TConstArrayRef<float>> features,
+    size_t treeStart,
+    size_t treeEnd,
+    TArrayRef<double> results,
+    NPar::TLocalExecutor* executor,
+    const TFeatureLayout* featureInfo) const {
+    const auto evaluator = GetCurrentEvaluator();
+    const size_t threadCount = executor ? executor->GetThreadCount() + 1 : 1; // one for current thread
+    const size_t docCount = features.size();
+    const size_t treeCount = treeEnd > treeStart ? treeEnd - treeStart : 0;
+    const size_t approxDimension = evaluator->GetApproxDimension();
+    CB_ENSURE(
+        results.size() == docCount * approxDimension,
+        "Results size " << results.size() << " doesn't match " << docCount << " objects of dimension " << approxDimension
+    );
+
+    const size_t docBlockCount = Min(threadCount, CeilDiv(docCount, MIN_PARALLEL_CALC_DOC_COUNT));
+    const size_t treeBlockCount = Min(threadCount, CeilDiv(treeCount, MIN_PARALLEL_CALC_TREE_COUNT));
+    if (docBlockCount > 1) {
+        NPar::TLocalExecutor::TExecRangeParams blockParams(0, SafeIntegerCast<int>(docCount));
+        blockParams.SetBlockCount(docBlockCount);
+        executor->ExecRangeWithThrow(
+            [&](int blockId) {
+                const size_t blockFirstId = blockParams.FirstId + blockId * blockParams.GetBlockSize();
+                const size_t blockLastId = Min<size_t>(blockParams.LastId, blockFirstId + blockParams.GetBlockSize());
+                evaluator->CalcFlat(
+                    features.Slice(blockFirstId, blockLastId - blockFirstId),
+                    treeStart,
+                    treeEnd,
+                    results.Slice(blockFirstId * approxDimension, (blockLastId - blockFirstId) * approxDimension),
+                    featureInfo
+                );
+            },
+            0,
+            blockParams.GetBlockCount(),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+        return;
+    }
+    if (treeBlockCount <= 1 || evaluator->GetPredictionType() != EPredictionType::RawFormulaVal) {
+        evaluator->CalcFlat(features, treeStart, treeEnd, results, featureInfo);
+        return;
+    }
+    // Bias is applied only for range starting at treeStart == 0, so partial sums add up to full prediction
+    NPar::TLocalExecutor::TExecRangeParams blockParams(SafeIntegerCast<int>(treeStart), SafeIntegerCast<int>(treeEnd));
+    blockParams.SetBlockCount(treeBlockCount);
+    TVector<TVector<double>> partialResults(blockParams.GetBlockCount());
+    executor->ExecRangeWithThrow(
+        [&](int blockId) {
+            const size_t blockFirstId = blockParams.FirstId + blockId * blockParams.GetBlockSize();
+            const size_t blockLastId = Min<size_t>(blockParams.LastId, blockFirstId + blockParams.GetBlockSize());
+            auto& blockResults = partialResults[blockId];
+            blockResults.yresize(results.size());
+            evaluator->CalcFlat(features, blockFirstId, blockLastId, blockResults, featureInfo);
+        },
+        0,
+        blockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+    Copy(partialResults[0].begin(), partialResults[0].end(), results.begin());
+    for (size_t blockId = 1; blockId < partialResults.size(); ++blockId) {
+        for (size_t idx = 0; idx < results.size(); ++idx) {
+            results[idx] += partialResults[blockId][idx];
+        }
+    }
+}
+
+void TFullModel::CalcFlatParallel(
+    TConstArrayRef<TConstArrayRef<float>> features,
+    size_t treeStart,
+    size_t treeEnd,
+    TArrayRef<double> results,
+    int threadCount,
+    const TFeatureLayout* featureInfo) const {
+    CB_ENSURE(threadCount > 0, "Thread count should be positive, got " << threadCount);
+    NPar::TLocalExecutor executor;
+    executor.RunAdditionalThreads(threadCount - 1);
+    CalcFlatParallel(features, treeStart, treeEnd, results, &executor, featureInfo);
+}
+
 void TFullModel::CalcFlatSingle(
     TConstArrayRef<float> features,
     size_t treeStart,
@@ -593,6 +908,45 @@ void TFullModel::CalcLeafIndexes(
     GetCurrentEvaluator()->CalcLeafIndexes(floatFeatures, catFeatures, treeStart, treeEnd, indexes, featureInfo);
 }
 
+size_t TFullModel::CalibrateEvaluationBlockSize(
+    TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+    TConstArrayRef<TConstArrayRef<int>> catFeatures,
+    size_t iterationCount
+) {
+    CB_ENSURE(
+        FormulaEvaluatorType == EFormulaEvaluatorType::CPU,
+        "Evaluation block size calibration is supported only for CPU evaluator"
+    );
+    CB_ENSURE(iterationCount > 0, "Calibration iteration count should be positive");
+    const size_t docCount = Max(floatFeatures.size(), catFeatures.size());
+    CB_ENSURE(docCount > 0, "Calibration sample should not be empty");
+
+    auto evaluator = NCB::NModelEvaluation::CreateEvaluator(EFormulaEvaluatorType::CPU, *this);
+    TVector<double> results(docCount * GetDimensionsCount());
+    size_t bestBlockSize = NCB::NModelEvaluation::FORMULA_EVALUATION_BLOCK_SIZE;
+    TDuration bestTime = TDuration::Max();
+    for (size_t blockSize = NCB::NModelEvaluation::MIN_FORMULA_EVALUATION_BLOCK_SIZE;
+         blockSize <= NCB::NModelEvaluation::FORMULA_EVALUATION_BLOCK_SIZE;
+         blockSize *= 2)
+    {
+        evaluator->SetProperty("BlockSize", ToString(blockSize));
+        for (size_t iteration = 0; iteration < iterationCount; ++iteration) {
+            const TInstant startTime = TInstant::Now();
+            evaluator->Calc(floatFeatures, catFeatures, 0, GetTreeCount(), results);
+            const TDuration elapsedTime = TInstant::Now() - startTime;
+            if (elapsedTime < bestTime) {
+                bestTime = elapsedTime;
+                bestBlockSize = blockSize;
+            }
+        }
+    }
+    CATBOOST_DEBUG_LOG << "Selected evaluation block size " << bestBlockSize << " (" << bestTime << ")" << Endl;
+    ModelInfo[TString(NCB::NModelEvaluation::EVALUATION_BLOCK_SIZE_MODEL_INFO_KEY)] = ToString(bestBlockSize);
+    with_lock(CurrentEvaluatorLock) {
+        Evaluator.Reset();
+    }
+    return bestBlockSize;
+}
 
 void TFullModel::Save(IOutputStream* s) const {
     using namespace flatbuffers;
@@ -640,32 +994,25 @@ void TFullModel::Save(IOutputStream* s) const {
     }
 }
 
-void TFullModel::Load(IInputStream* s) {
+static TVector<TString> DeserializeModelCore(const ui8* coreBuffer, size_t coreSize, TFullModel* model) {
     using namespace flatbuffers;
     using namespace NCatBoostFbs;
-    ui32 fileDescriptor;
-    ::Load(s, fileDescriptor);
-    CB_ENSURE(fileDescriptor == GetModelFormatDescriptor(), "Incorrect model file descriptor");
-    auto coreSize = ::LoadSize(s);
-    TArrayHolder<ui8> arrayHolder = new ui8[coreSize];
-    s->LoadOrFail(arrayHolder.Get(), coreSize);
-
     {
-        flatbuffers::Verifier verifier(arrayHolder.Get(), coreSize);
+        flatbuffers::Verifier verifier(coreBuffer, coreSize);
         CB_ENSURE(VerifyTModelCoreBuffer(verifier), "Flatbuffers model verification failed");
     }
-    auto fbModelCore = GetTModelCore(arrayHolder.Get());
+    auto fbModelCore = GetTModelCore(coreBuffer);
     CB_ENSURE(
         fbModelCore->FormatVersion() && fbModelCore->FormatVersion()->str() == CURRENT_CORE_FORMAT_STRING,
         "Unsupported model format: " << fbModelCore->FormatVersion()->str()
     );
     if (fbModelCore->ModelTrees()) {
-        ModelTrees.GetMutable()->FBDeserialize(fbModelCore->ModelTrees());
+        model->ModelTrees.GetMutable()->FBDeserialize(fbModelCore->ModelTrees());
     }
-    ModelInfo.clear();
+    model->ModelInfo.clear();
     if (fbModelCore->InfoMap()) {
         for (auto keyVal : *fbModelCore->InfoMap()) {
-            ModelInfo[keyVal->Key()->str()] = keyVal->Value()->str();
+            model->ModelInfo[keyVal->Key()->str()] = keyVal->Value()->str();
         }
     }
     TVector<TString> modelParts;
@@ -674,26 +1021,92 @@ void TFullModel::Load(IInputStream* s) {
             modelParts.emplace_back(part->str());
         }
     }
-    if (!modelParts.empty()) {
-        for (const auto& modelPartId : modelParts) {
-            if (modelPartId == TStaticCtrProvider::ModelPartId()) {
-                CtrProvider = new TStaticCtrProvider;
-                CtrProvider->Load(s);
-            } else if (modelPartId == NCB::TTextProcessingCollection::GetStringIdentifier()) {
-                TextProcessingCollection = new NCB::TTextProcessingCollection();
-                TextProcessingCollection->Load(s);
-            } else {
-                CB_ENSURE(
-                    false,
-                    "Got unknown partId = " << modelPartId << " via deserialization"
-                        << "only static ctr and text processing collection model parts are supported"
-                );
-            }
+    return modelParts;
+}
+
+static void CheckModelPartId(const TString& modelPartId) {
+    CB_ENSURE(
+        modelPartId == TStaticCtrProvider::ModelPartId()
+            || modelPartId == NCB::TTextProcessingCollection::GetStringIdentifier(),
+        "Got unknown partId = " << modelPartId << " via deserialization"
+            << "only static ctr and text processing collection model parts are supported"
+    );
+}
+
+void TFullModel::Load(IInputStream* s) {
+    ui32 fileDescriptor;
+    ::Load(s, fileDescriptor);
+    CB_ENSURE(fileDescriptor == GetModelFormatDescriptor(), "Incorrect model file descriptor");
+    auto coreSize = ::LoadSize(s);
+    TArrayHolder<ui8> arrayHolder = new ui8[coreSize];
+    s->LoadOrFail(arrayHolder.Get(), coreSize);
+
+    const TVector<TString> modelParts = DeserializeModelCore(arrayHolder.Get(), coreSize, this);
+    for (const auto& modelPartId : modelParts) {
+        CheckModelPartId(modelPartId);
+        if (modelPartId == TStaticCtrProvider::ModelPartId()) {
+            CtrProvider = new TStaticCtrProvider;
+            CtrProvider->Load(s);
+        } else {
+            TextProcessingCollection = new NCB::TTextProcessingCollection();
+            TextProcessingCollection->Load(s);
         }
     }
     UpdateDynamicData();
 }
 
+void TFullModel::InitNonOwning(const void* binaryBuffer, size_t binarySize) {
+    TMemoryInput in(binaryBuffer, binarySize);
+    ui32 fileDescriptor;
+    ::Load(&in, fileDescriptor);
+    CB_ENSURE(fileDescriptor == GetModelFormatDescriptor(), "Incorrect model file descriptor");
+    auto coreSize = ::LoadSize(&in);
+    CB_ENSURE(in.Avail() >= coreSize, "Unexpected end of model data");
+    const ui8* coreBuffer = reinterpret_cast<const ui8*>(in.Buf());
+    in.Skip(coreSize);
+
+    const TVector<TString> modelParts = DeserializeModelCore(coreBuffer, coreSize, this);
+    for (const auto& modelPartId : modelParts) {
+        CheckModelPartId(modelPartId);
+        if (modelPartId == TStaticCtrProvider::ModelPartId()) {
+            auto ctrProvider = MakeIntrusive<TStaticCtrProvider>();
+            ctrProvider->LoadNonOwning(&in);
+            CtrProvider = ctrProvider;
+        } else {
+            TextProcessingCollection = new NCB::TTextProcessingCollection();
+            TextProcessingCollection->Load(&in);
+        }
+    }
+    // tree runtime data is computed on first access, see TModelTrees::GetRuntimeData
+    if (CtrProvider) {
+        CtrProvider->SetupBinFeatureIndexes(
+            ModelTrees->GetFloatFeatures(),
+            ModelTrees->GetOneHotFeatures(),
+            ModelTrees->GetCatFeatures());
+    }
+    with_lock(CurrentEvaluatorLock) {
+        Evaluator.Reset();
+    }
+}
+
+void TFullModel::InitNonOwning(TBlob modelData) {
+    InitNonOwning(modelData.Data(), modelData.Size());
+    NonOwningModelData = std::move(modelData);
+}
+
+void TFullModel::WarmUp() const {
+    Y_UNUSED(ModelTrees->GetUsedFloatFeaturesCount());
+    Y_UNUSED(GetCurrentEvaluator());
+
+    const char* data = NonOwningModelData.AsCharPtr();
+    const size_t size = NonOwningModelData.Size();
+    const size_t pageSize = NSystemInfo::GetPageSize();
+    volatile ui8 checksum = 0;
+    for (size_t offset = 0; offset < size; offset += pageSize) {
+        checksum = checksum ^ static_cast<ui8>(data[offset]);
+    }
+}
+
 void TFullModel::UpdateDynamicData() {
     ModelTrees->UpdateRuntimeData();
     if (CtrProvider) {
@@ -918,8 +1331,11 @@ static void StreamModelTreesWithoutScaleAndBiasToBuilder(
 {
     const auto& binFeatures = trees.GetBinFeatures();
     const auto& leafOffsets = trees.GetFirstLeafOffsets();
+    // reused between trees to avoid allocations per tree
+    TVector<TModelSplit> modelSplits;
+    TVector<double> leafValues;
     for (size_t treeIdx = 0; treeIdx < trees.GetTreeSizes().size(); ++treeIdx) {
-        TVector<TModelSplit> modelSplits;
+        modelSplits.clear();
         for (int splitIdx = trees.GetTreeStartOffsets()[treeIdx];
              splitIdx < trees.GetTreeStartOffsets()[treeIdx] + trees.GetTreeSizes()[treeIdx];
              ++splitIdx)
@@ -942,7 +1358,7 @@ static void StreamModelTreesWithoutScaleAndBiasToBuilder(
                 )
             );
         } else {
-            TVector<double> leafValues(
+            leafValues.assign(
                 trees.GetLeafValues().begin() + leafOffsets[treeIdx],
                 trees.GetLeafValues().begin() + leafOffsets[treeIdx]
                     + trees.GetDimensionsCount() * (1ull << trees.GetTreeSizes()[treeIdx])
@@ -1119,6 +1535,20 @@ TFullModel SumModels(
         Visit(merger, flatFeature.FeatureVariant);
     }
     TObliviousTreeBuilder builder(merger.MergedFloatFeatures, merger.MergedCatFeatures, {}, approxDimension);
+    size_t totalTreeCount = 0;
+    size_t totalSplitCount = 0;
+    size_t totalLeafValueCount = 0;
+    for (const auto& model : modelVector) {
+        totalTreeCount += model->GetTreeCount();
+        totalSplitCount += model->ModelTrees->GetTreeSplits().size();
+        totalLeafValueCount += model->ModelTrees->GetLeafValues().size();
+    }
+    builder.Reserve(
+        totalTreeCount,
+        totalSplitCount,
+        totalLeafValueCount,
+        allModelsHaveLeafWeights ? totalLeafValueCount / approxDimension : 0
+    );
     double totalBias = 0;
     for (const auto modelId : xrange(modelVector.size())) {
         TScaleAndBias normer = modelVector[modelId]->GetScaleAndBias();
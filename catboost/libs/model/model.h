@@ -23,8 +23,10 @@
 #include <util/generic/string.h>
 #include <util/generic/utility.h>
 #include <util/generic/vector.h>
+#include <util/memory/blob.h>
 #include <util/stream/fwd.h>
 #include <util/stream/mem.h>
+#include <util/system/atomic.h>
 #include <util/system/spinlock.h>
 #include <util/system/types.h>
 #include <util/system/yassert.h>
@@ -34,6 +36,10 @@
 
 class TModelPartsCachingSerializer;
 
+namespace NPar {
+    class TLocalExecutor;
+}
+
 /*!
     \brief Oblivious tree model structure
 
@@ -85,6 +91,21 @@ struct TNonSymmetricTreeStepNode {
     }
 };
 
+/**
+ * Split node of non-symmetric tree in bitvector (QuickScorer-like) layout. Each tree leaf is a bit in ui64 mask,
+ *  leaves are enumerated from left to right. Evaluation starts with all bits set and for every split node ANDs
+ *  mask with LeftMask or RightMask depending on condition value, the only bit left is the reached leaf.
+ */
+struct TNonSymmetricTreeBitvectorNode {
+    static constexpr ui32 MaxLeafCount = 64;
+
+    TRepackedBin Split;
+    //! Leaves reachable when doc goes to the left subtree (all leaves of the right subtree are cleared)
+    ui64 LeftMask = 0;
+    //! Leaves reachable when doc goes to the right subtree (all leaves of the left subtree are cleared)
+    ui64 RightMask = 0;
+};
+
 struct TModelTrees {
 public:
     /**
@@ -124,6 +145,32 @@ public:
 
         //! Offset of first tree leaf in flat tree leafs array
         TVector<size_t> TreeFirstLeafOffsets;
+
+        /**
+         * Bitvector layout of non-symmetric trees, empty for oblivious models and for models with a tree that
+         *  has more than TNonSymmetricTreeBitvectorNode::MaxLeafCount leaves.
+         * Split nodes of tree i are [BitvectorTreeNodeOffsets[i], BitvectorTreeNodeOffsets[i + 1]),
+         *  leaf value indexes of its leaves (in bit order) start at BitvectorTreeLeafOffsets[i].
+         */
+        TVector<TNonSymmetricTreeBitvectorNode> BitvectorNodes;
+        TVector<ui32> BitvectorTreeNodeOffsets;
+        TVector<ui32> BitvectorTreeLeafOffsets;
+        TVector<ui32> BitvectorLeafValueIndexes;
+
+        /**
+         * For single dimension models: sums of minimal and maximal leaf values of trees [i, treeCount), size is
+         *  treeCount + 1. Bound the contribution of remaining trees in early exit evaluation.
+         */
+        TVector<double> RemainingTreesMinLeafSums;
+        TVector<double> RemainingTreesMaxLeafSums;
+
+        /**
+         * Deduplicated splits of oblivious trees sorted by (FeatureIndex, XorMask, SplitIdx) and tree splits
+         *  referring to them: SharedSplitTreeBins[i].FeatureIndex is the index of RepackedBins[i] in UniqueRepackedBins.
+         * Empty for non-symmetric models and for models with more than 65536 unique splits.
+         */
+        TVector<TRepackedBin> UniqueRepackedBins;
+        TVector<TRepackedBin> SharedSplitTreeBins;
     };
 
 public:
@@ -372,6 +419,12 @@ public:
      */
     void TruncateTrees(size_t begin, size_t end);
 
+    /**
+     * Merge oblivious trees with the same split sequence into one tree with summed leaf values and drop
+     *  feature borders that are not used by any split.
+     */
+    void CompactTrees();
+
     /**
      * Drop unused float and categorical features from model
      */
@@ -383,36 +436,75 @@ public:
      * Should be called after any modifications.
      */
     void UpdateRuntimeData() const;
+
+    /**
+     * Internal usage only. Drops RuntimeData, it will be recomputed on first access.
+     */
+    void ResetRuntimeData() const {
+        AtomicSet(RuntimeDataReady, 0);
+        RuntimeData.Clear();
+    }
     /**
      * List of all CTRs in model
      * @return
      */
     const TVector<TModelCtr>& GetUsedModelCtrs() const {
-        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
-        return RuntimeData->UsedModelCtrs;
+        return GetRuntimeData().UsedModelCtrs;
     }
     /**
      * List all binary features corresponding to binary feature indexes in trees
      * @return
      */
     const TVector<TModelSplit>& GetBinFeatures() const {
-        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
-        return RuntimeData->BinFeatures;
+        return GetRuntimeData().BinFeatures;
     }
 
     const TVector<TRepackedBin>& GetRepackedBins() const {
-        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
-        return RuntimeData->RepackedBins;
+        return GetRuntimeData().RepackedBins;
     }
 
     const TVector<size_t>& GetFirstLeafOffsets() const {
-        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
-        return RuntimeData->TreeFirstLeafOffsets;
+        return GetRuntimeData().TreeFirstLeafOffsets;
+    }
+
+    bool HasBitvectorLayout() const {
+        return !GetRuntimeData().BitvectorTreeNodeOffsets.empty();
+    }
+
+    const TVector<TRepackedBin>& GetUniqueRepackedBins() const {
+        return GetRuntimeData().UniqueRepackedBins;
+    }
+
+    const TVector<TRepackedBin>& GetSharedSplitTreeBins() const {
+        return GetRuntimeData().SharedSplitTreeBins;
+    }
+
+    const TVector<double>& GetRemainingTreesMinLeafSums() const {
+        return GetRuntimeData().RemainingTreesMinLeafSums;
+    }
+
+    const TVector<double>& GetRemainingTreesMaxLeafSums() const {
+        return GetRuntimeData().RemainingTreesMaxLeafSums;
+    }
+
+    const TVector<TNonSymmetricTreeBitvectorNode>& GetBitvectorNodes() const {
+        return GetRuntimeData().BitvectorNodes;
+    }
+
+    const TVector<ui32>& GetBitvectorTreeNodeOffsets() const {
+        return GetRuntimeData().BitvectorTreeNodeOffsets;
+    }
+
+    const TVector<ui32>& GetBitvectorTreeLeafOffsets() const {
+        return GetRuntimeData().BitvectorTreeLeafOffsets;
+    }
+
+    const TVector<ui32>& GetBitvectorLeafValueIndexes() const {
+        return GetRuntimeData().BitvectorLeafValueIndexes;
     }
 
     const double* GetFirstLeafPtrForTree(size_t treeIdx) const {
-        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
-        return &LeafValues[RuntimeData->TreeFirstLeafOffsets[treeIdx]];
+        return &LeafValues[GetRuntimeData().TreeFirstLeafOffsets[treeIdx]];
     }
     /**
      * List all unique CTR bases (feature combination + ctr type) in model
@@ -435,13 +527,11 @@ public:
     }
 
     size_t GetMinimalSufficientFloatFeaturesVectorSize() const {
-        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
-        return RuntimeData->MinimalSufficientFloatFeaturesVectorSize;
+        return GetRuntimeData().MinimalSufficientFloatFeaturesVectorSize;
     }
 
     size_t GetUsedFloatFeaturesCount() const {
-        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
-        return RuntimeData->UsedFloatFeaturesCount;
+        return GetRuntimeData().UsedFloatFeaturesCount;
     }
 
     size_t GetNumCatFeatures() const {
@@ -453,28 +543,23 @@ public:
     }
 
     size_t GetMinimalSufficientCatFeaturesVectorSize() const {
-        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
-        return RuntimeData->MinimalSufficientCatFeaturesVectorSize;
+        return GetRuntimeData().MinimalSufficientCatFeaturesVectorSize;
     }
 
     size_t GetUsedCatFeaturesCount() const {
-        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
-        return RuntimeData->UsedCatFeaturesCount;
+        return GetRuntimeData().UsedCatFeaturesCount;
     }
 
     size_t GetUsedTextFeaturesCount() const {
-        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
-        return RuntimeData->UsedTextFeaturesCount;
+        return GetRuntimeData().UsedTextFeaturesCount;
     }
 
     size_t GetMinimalSufficientTextFeaturesVectorSize() const {
-        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
-        return RuntimeData->MinimalSufficientTextFeaturesVectorSize;
+        return GetRuntimeData().MinimalSufficientTextFeaturesVectorSize;
     }
 
     size_t GetUsedEstimatedFeaturesCount() const {
-        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
-        return RuntimeData->UsedEstimatedFeaturesCount;
+        return GetRuntimeData().UsedEstimatedFeaturesCount;
     }
 
     size_t GetBinaryFeaturesFullCount() const {
@@ -482,8 +567,7 @@ public:
     }
 
     ui32 GetEffectiveBinaryFeaturesBucketsCount() const {
-        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
-        return RuntimeData->EffectiveBinFeaturesBucketCount;
+        return GetRuntimeData().EffectiveBinFeaturesBucketCount;
     }
 
     size_t GetFlatFeatureVectorExpectedSize() const {
@@ -502,6 +586,20 @@ public:
 
     void SetScaleAndBias(const TScaleAndBias&);
 
+private:
+    /**
+     * Runtime data is computed on first access if UpdateRuntimeData wasn't called explicitly, f.e. for models
+     *  initialized with TFullModel::InitNonOwning
+     */
+    const TRuntimeData& GetRuntimeData() const {
+        if (Y_UNLIKELY(!AtomicGet(RuntimeDataReady))) {
+            InitRuntimeDataLazily();
+        }
+        return *RuntimeData;
+    }
+
+    void InitRuntimeDataLazily() const;
+
 private:
     //! Number of classes in model, in most cases equals to 1.
     int ApproxDimension = 1;
@@ -560,6 +658,7 @@ private:
     TScaleAndBias ScaleAndBias;
 
     mutable TMaybe<TRuntimeData> RuntimeData;
+    mutable TAtomic RuntimeDataReady = 0;
 };
 
 class TCOWTreeWrapper {
@@ -606,6 +705,8 @@ private:
     EFormulaEvaluatorType FormulaEvaluatorType = EFormulaEvaluatorType::CPU;
     TAdaptiveLock CurrentEvaluatorLock;
     mutable NCB::NModelEvaluation::TModelEvaluatorPtr Evaluator;
+    //! Keeps memory referenced by CTR tables alive for models initialized with InitNonOwning(TBlob)
+    TBlob NonOwningModelData;
 public:
     void SetEvaluatorType(EFormulaEvaluatorType evaluatorType) {
         with_lock(CurrentEvaluatorLock) {
@@ -616,6 +717,12 @@ public:
         }
     }
 
+    EFormulaEvaluatorType GetEvaluatorType() const {
+        with_lock(CurrentEvaluatorLock) {
+            return FormulaEvaluatorType;
+        }
+    }
+
     NCB::NModelEvaluation::TConstModelEvaluatorPtr GetCurrentEvaluator() const {
         with_lock(CurrentEvaluatorLock) {
             if (!Evaluator) {
@@ -642,6 +749,7 @@ public:
                 DoSwap(CtrProvider, other.CtrProvider);
                 DoSwap(FormulaEvaluatorType, other.FormulaEvaluatorType);
                 DoSwap(Evaluator, other.Evaluator);
+                DoSwap(NonOwningModelData, other.NonOwningModelData);
             }
         }
         DoSwap(TextProcessingCollection, other.TextProcessingCollection);
@@ -691,6 +799,18 @@ public:
         UpdateDynamicData();
     }
 
+    /**
+     * Merge trees with the same split sequence by summing their leaf values and drop unused borders.
+     * Predictions are unchanged up to floating point summation order.
+     */
+    void CompactTrees() {
+        ModelTrees.GetMutable()->CompactTrees();
+        if (CtrProvider) {
+            CtrProvider->DropUnusedTables(ModelTrees->GetUsedModelCtrBases());
+        }
+        UpdateDynamicData();
+    }
+
     /**
      * @return Minimal float features vector length sufficient for this model
      */
@@ -757,6 +877,24 @@ public:
      */
     void Load(IInputStream* s);
 
+    /**
+     * Initialize model from serialized binary model without copying CTR tables, they keep references into
+     *  binaryBuffer, so it should outlive the model. Tree runtime data is computed on first use.
+     * @param binaryBuffer serialized model, as written by Save
+     * @param binarySize
+     */
+    void InitNonOwning(const void* binaryBuffer, size_t binarySize);
+
+    //! Same as above, model holds modelData
+    void InitNonOwning(TBlob modelData);
+
+    /**
+     * Prepare model for serving: compute tree runtime data, create the current evaluator and read through
+     *  memory referenced by a non-owning model, so that first predictions don't pay for lazy initialization
+     *  and page faults.
+     */
+    void WarmUp() const;
+
     //! Check if TFullModel instance has valid CTR provider.
     // If no ctr features present it will return true
     bool HasValidCtrProvider() const {
@@ -823,6 +961,31 @@ public:
         const TFeatureLayout* featureInfo = nullptr
     ) const;
 
+    /**
+     * Same as CalcFlat, but splits work between executor threads and the current thread. Large batches are split
+     *  by objects, small batches of RawFormulaVal predictions for huge models are split by tree ranges and
+     *  partial sums are added up at the end.
+     * @param[in] executor if nullptr, evaluation runs in the current thread
+     */
+    void CalcFlatParallel(
+        TConstArrayRef<TConstArrayRef<float>> features,
+        size_t treeStart,
+        size_t treeEnd,
+        TArrayRef<double> results,
+        NPar::TLocalExecutor* executor,
+        const TFeatureLayout* featureInfo = nullptr
+    ) const;
+
+    //! Same as above, but runs on temporary executor with threadCount threads
+    void CalcFlatParallel(
+        TConstArrayRef<TConstArrayRef<float>> features,
+        size_t treeStart,
+        size_t treeEnd,
+        TArrayRef<double> results,
+        int threadCount,
+        const TFeatureLayout* featureInfo = nullptr
+    ) const;
+
     /**
      * Call CalcFlat on all model trees
      * @param features
@@ -938,6 +1101,44 @@ public:
         Calc(floatFeaturesArray, catFeaturesArray, result, featureInfo);
     }
 
+    /**
+     * Evaluate raw formula predictions on columnar data. Uses model trees from interval [treeStart, treeEnd)
+     * @param floatColumns float feature columns, indexed by float feature index
+     * @param catColumns hashed categorical feature columns, indexed by categorical feature index
+     * @param docCount
+     * @param treeStart
+     * @param treeEnd
+     * @param results indexation is [objectIndex * ApproxDimension + classId]
+     */
+    void CalcColumnar(
+        TConstArrayRef<NCB::NModelEvaluation::TFeatureColumn<float>> floatColumns,
+        TConstArrayRef<NCB::NModelEvaluation::TFeatureColumn<int>> catColumns,
+        size_t docCount,
+        size_t treeStart,
+        size_t treeEnd,
+        TArrayRef<double> results,
+        const TFeatureLayout* featureInfo = nullptr
+    ) const {
+        GetCurrentEvaluator()->CalcColumnar(floatColumns, catColumns, docCount, treeStart, treeEnd, results, featureInfo);
+    }
+
+    /**
+     * Evaluate raw formula predictions on columnar data. Uses all model trees
+     * @param floatColumns float feature columns, indexed by float feature index
+     * @param catColumns hashed categorical feature columns, indexed by categorical feature index
+     * @param docCount
+     * @param results indexation is [objectIndex * ApproxDimension + classId]
+     */
+    void CalcColumnar(
+        TConstArrayRef<NCB::NModelEvaluation::TFeatureColumn<float>> floatColumns,
+        TConstArrayRef<NCB::NModelEvaluation::TFeatureColumn<int>> catColumns,
+        size_t docCount,
+        TArrayRef<double> results,
+        const TFeatureLayout* featureInfo = nullptr
+    ) const {
+        CalcColumnar(floatColumns, catColumns, docCount, 0, GetTreeCount(), results, featureInfo);
+    }
+
     /**
      * Evaluate raw formula predictions for objects. Uses model trees from interval [treeStart, treeEnd)
      * @param floatFeatures
@@ -1085,6 +1286,19 @@ public:
         CalcLeafIndexes(floatFeatures, catFeatures, 0, GetTreeCount(), indexes, featureInfo);
     }
 
+    /**
+     * Benchmark CPU evaluation with several block sizes on the sample and store the fastest one in model metadata,
+     *  so it is used by evaluators created for this model (and its saved copies) afterwards.
+     * @param floatFeatures sample float features, should be representative for production objects
+     * @param catFeatures sample hashed cat feature values
+     * @param iterationCount number of measurements for each block size (the best one is taken)
+     * @return selected block size
+     */
+    size_t CalibrateEvaluationBlockSize(
+        TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+        TConstArrayRef<TConstArrayRef<int>> catFeatures,
+        size_t iterationCount = 3);
+
     /**
      * Get the name of optimized objective used to train the model.
      * @return the name, or empty string if the model does not have this information
@@ -1125,6 +1339,13 @@ TFullModel ReadModel(
     size_t binaryBufferSize,
     EModelType format = EModelType::CatboostBinary);
 
+/**
+ * Load CatboostBinary model from memory-mapped file, CTR tables are not copied from the mapping.
+ * @param modelFile
+ * @return
+ */
+TFullModel ReadModelMmap(const TString& modelFile);
+
 /**
  * Serialize model to string
  * @param model
@@ -144,23 +144,34 @@ void TObliviousTreeBuilder::AddTree(const TVector<TModelSplit>& modelSplits,
         CB_ENSURE((1ull << modelSplits.size()) == treeLeafWeights.size());
         LeafWeights.insert(LeafWeights.end(), treeLeafWeights.begin(), treeLeafWeights.end());
     }
-    Trees.emplace_back(modelSplits);
+    TreeSplits.insert(TreeSplits.end(), modelSplits.begin(), modelSplits.end());
+    TreeSizes.push_back(modelSplits.ysize());
+}
+
+void TObliviousTreeBuilder::Reserve(
+    size_t treeCount,
+    size_t splitCount,
+    size_t leafValueCount,
+    size_t leafWeightCount
+) {
+    TreeSizes.reserve(treeCount);
+    TreeSplits.reserve(splitCount);
+    LeafValues.reserve(leafValueCount);
+    LeafWeights.reserve(leafWeightCount);
 }
 
 void TObliviousTreeBuilder::Build(TModelTrees* result) {
     *result = TModelTrees{};
     TSet<TModelSplit> modelSplitSet;
-    for (const auto& tree : Trees) {
-        for (const auto& split : tree) {
-            modelSplitSet.insert(split);
-            if (split.Type == ESplitType::OnlineCtr) {
-                auto& proj = split.OnlineCtr.Ctr.Base.Projection;
-                for (const auto& binF : proj.BinFeatures) {
-                    modelSplitSet.insert(TModelSplit(binF));
-                }
-                for (const auto& oheFeature : proj.OneHotFeatures) {
-                    modelSplitSet.insert(TModelSplit(oheFeature));
-                }
+    for (const auto& split : TreeSplits) {
+        modelSplitSet.insert(split);
+        if (split.Type == ESplitType::OnlineCtr) {
+            auto& proj = split.OnlineCtr.Ctr.Base.Projection;
+            for (const auto& binF : proj.BinFeatures) {
+                modelSplitSet.insert(TModelSplit(binF));
+            }
+            for (const auto& oheFeature : proj.OneHotFeatures) {
+                modelSplitSet.insert(TModelSplit(oheFeature));
             }
         }
     }
@@ -168,12 +179,13 @@ void TObliviousTreeBuilder::Build(TModelTrees* result) {
     ProcessSplitsSet(modelSplitSet, result);
     result->SetLeafValues(std::move(LeafValues));
     result->SetLeafWeights(std::move(LeafWeights));
-    for (const auto& treeStruct : Trees) {
-        for (const auto& split : treeStruct) {
-            result->AddTreeSplit(BinFeatureIndexes.at(split));
-        }
-        result->AddTreeSize(treeStruct.ysize());
+    for (const auto& split : TreeSplits) {
+        result->AddTreeSplit(BinFeatureIndexes.at(split));
+    }
+    for (auto treeSize : TreeSizes) {
+        result->AddTreeSize(treeSize);
     }
+    TVector<TModelSplit>().swap(TreeSplits);
     result->UpdateRuntimeData();
 }
 
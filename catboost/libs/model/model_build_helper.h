@@ -46,9 +46,12 @@ public:
 
         AddTree(modelSplits, treeLeafValues, TVector<double>());
     }
+    // avoids reallocations (and peak memory of that) when the total size of added trees is known in advance
+    void Reserve(size_t treeCount, size_t splitCount, size_t leafValueCount, size_t leafWeightCount);
     void Build(TModelTrees* result);
 private:
-    TVector<TVector<TModelSplit>> Trees;
+    TVector<TModelSplit> TreeSplits; // splits of all trees, one after another
+    TVector<int> TreeSizes;
     TVector<double> LeafValues;
     TVector<double> LeafWeights;
 };
@@ -5,6 +5,7 @@
 #include <catboost/libs/model/ctr_helpers.h>
 #include <catboost/libs/model/static_ctr_provider.h>
 
+#include <library/cpp/json/json_reader.h>
 #include <library/cpp/resource/resource.h>
 
 #include <util/generic/map.h>
@@ -12,10 +13,24 @@
 #include <util/string/builder.h>
 #include <util/string/cast.h>
 #include <util/stream/input.h>
+#include <util/stream/str.h>
 
 namespace NCB {
     using namespace NCatboostModelExportHelpers;
 
+    void TCatboostModelToCppConverter::ParseUserParameters(const TString& userParametersJson) {
+        if (userParametersJson.empty()) {
+            return;
+        }
+        NJson::TJsonValue userParameters;
+        TStringInput is(userParametersJson);
+        CB_ENSURE(NJson::ReadJsonTree(&is, &userParameters), "can't parse JSON user params for exporting the model to C++");
+        for (const auto& [key, value] : userParameters.GetMapSafe()) {
+            CB_ENSURE(key == "specialized_evaluation", "Unknown JSON user param for exporting the model to C++: " << key);
+            SpecializedEvaluation = value.GetBooleanSafe();
+        }
+    }
+
     /*
      * Tiny code for case when cat features not present
      */
@@ -93,7 +108,11 @@ namespace NCB {
         Out << '\n';
     }
 
-    void TCatboostModelToCppConverter::WriteHeader(bool forCatFeatures) {
+    void TCatboostModelToCppConverter::WriteHeader(bool forCatFeatures, bool forSpecializedEvaluation) {
+        if (forSpecializedEvaluation) {
+            Out << "#include <algorithm>" << '\n';
+            Out << "#include <cstddef>" << '\n';
+        }
         if (forCatFeatures) {
            Out << "#include <cassert>" << '\n';
         }
@@ -105,6 +124,183 @@ namespace NCB {
         Out << '\n';
     }
 
+    /*
+     * Code specialized on tree depths for batch evaluation, used when cat features not present
+     * and "specialized_evaluation" user param is set.
+     * All tables are constexpr, trees are grouped by depth so that per-group loops have compile time
+     * trip counts, and documents are processed in blocks with branchless inner loops over documents
+     * that compilers vectorize without any target specific intrinsics.
+     */
+
+    static constexpr ui32 SpecializedApplicatorBlockSize = 128;
+
+    // depth -> ids of trees of that depth, in model order
+    static TMap<int, TVector<size_t>> GroupTreesByDepth(const TFullModel& model) {
+        TMap<int, TVector<size_t>> treesByDepth;
+        const auto treeSizes = model.ModelTrees->GetTreeSizes();
+        for (size_t treeId = 0; treeId < treeSizes.size(); ++treeId) {
+            treesByDepth[treeSizes[treeId]].push_back(treeId);
+        }
+        return treesByDepth;
+    }
+
+    void TCatboostModelToCppConverter::WriteSpecializedModel(const TFullModel& model) {
+        CB_ENSURE(!model.HasCategoricalFeatures(), "Specialized export of model with categorical features to cpp is not supported.");
+        CB_ENSURE(model.ModelTrees->GetDimensionsCount() == 1, "Export of MultiClassification model to cpp is not supported.");
+        CB_ENSURE(model.IsOblivious(), "Specialized export of non symmetric trees to cpp is not supported.");
+
+        const auto& trees = *model.ModelTrees;
+        const int binaryFeatureCount = GetBinaryFeatureCount(model);
+        const auto treeSplits = trees.GetTreeSplits();
+        const auto treeStartOffsets = trees.GetTreeStartOffsets();
+        const auto leafValues = trees.GetLeafValues();
+        const auto& firstLeafOffsets = trees.GetFirstLeafOffsets();
+
+        TIndent indent(0);
+        Out << "/* Model data */" << '\n';
+        Out << indent++ << "namespace CatboostModelSpecialized {" << '\n';
+        Out << indent << "constexpr unsigned int BlockSize = " << SpecializedApplicatorBlockSize << ";" << '\n';
+        Out << indent << "constexpr unsigned int FloatFeatureCount = " << model.GetNumFloatFeatures() << ";" << '\n';
+        Out << indent << "constexpr unsigned int BinaryFeatureCount = " << binaryFeatureCount << ";" << '\n';
+        // array sizes are kept positive for models without features or splits
+        Out << indent << "constexpr unsigned int BorderCounts[" << Max<size_t>(trees.GetNumFloatFeatures(), 1) << "] = {" << OutputBorderCounts(model) << "};" << '\n';
+        Out << indent << "constexpr float Borders[" << Max(binaryFeatureCount, 1) << "] = {" << OutputBorders(model, true) << "};" << '\n';
+
+        double constantTreesValue = 0.0;
+        Out << '\n';
+        Out << indent << "/* Trees grouped by depth, splits and leaf values of every group are laid out tree by tree */" << '\n';
+        for (const auto& [depth, treeIds] : GroupTreesByDepth(model)) {
+            if (depth == 0) {
+                for (size_t treeId : treeIds) {
+                    constantTreesValue += leafValues[firstLeafOffsets[treeId]];
+                }
+                continue;
+            }
+            Out << indent << "constexpr unsigned int TreeSplitsDepth" << depth << "[" << treeIds.size() * depth << "] = {";
+            TSequenceCommaSeparator comma(treeIds.size() * depth, AddSpaceAfterComma);
+            for (size_t treeId : treeIds) {
+                for (int level = 0; level < depth; ++level) {
+                    Out << treeSplits[treeStartOffsets[treeId] + level] << comma;
+                }
+            }
+            Out << "};" << '\n';
+
+            const size_t treeLeafCount = 1uLL << depth;
+            Out << indent++ << "constexpr double LeafValuesDepth" << depth << "[" << treeIds.size() * treeLeafCount << "] = {";
+            TSequenceCommaSeparator commaOuter(treeIds.size());
+            for (size_t treeId : treeIds) {
+                const double* treeLeafValues = leafValues.data() + firstLeafOffsets[treeId];
+                Out << '\n' << indent;
+                Out << OutputArrayInitializer([treeLeafValues] (size_t i) { return FloatToString(treeLeafValues[i], PREC_NDIGITS, 16); }, treeLeafCount);
+                Out << commaOuter;
+            }
+            Out << '\n' << --indent << "};" << '\n';
+        }
+        Out << '\n';
+        Out << indent << "/* Sum of leaf values of trees without splits */" << '\n';
+        Out << indent << "constexpr double ConstantTreesValue = " << FloatToString(constantTreesValue, PREC_NDIGITS, 16) << ";" << '\n';
+        Out << indent << "constexpr double Scale = " << model.GetScaleAndBias().Scale << ";" << '\n';
+        Out << indent << "constexpr double Bias = " << model.GetScaleAndBias().Bias << ";" << '\n';
+        Out << --indent << "}" << '\n';
+        Out << '\n';
+    }
+
+    void TCatboostModelToCppConverter::WriteSpecializedApplicator(const TFullModel& model) {
+        Out << "/* Model applicator */" << '\n';
+        Out << "namespace CatboostModelSpecialized {" << '\n';
+        Out << "    /* Adds values of GroupTreeCount trees of depth Depth to results of docCount documents of a block */" << '\n';
+        Out << "    template <unsigned int Depth, unsigned int GroupTreeCount>" << '\n';
+        Out << "    inline void AddTrees(" << '\n';
+        Out << "        const unsigned char* binaryFeatures," << '\n';
+        Out << "        unsigned int binaryFeatureStride," << '\n';
+        Out << "        unsigned int docCount," << '\n';
+        Out << "        const unsigned int* treeSplits," << '\n';
+        Out << "        const double* leafValues," << '\n';
+        Out << "        double* results" << '\n';
+        Out << "    ) {" << '\n';
+        Out << "        unsigned int indexes[BlockSize];" << '\n';
+        Out << "        for (unsigned int treeId = 0; treeId < GroupTreeCount; ++treeId) {" << '\n';
+        Out << "            for (unsigned int docId = 0; docId < docCount; ++docId) {" << '\n';
+        Out << "                indexes[docId] = 0;" << '\n';
+        Out << "            }" << '\n';
+        Out << "            for (unsigned int depth = 0; depth < Depth; ++depth) {" << '\n';
+        Out << "                const unsigned char* splitBins = binaryFeatures + treeSplits[depth] * binaryFeatureStride;" << '\n';
+        Out << "                for (unsigned int docId = 0; docId < docCount; ++docId) {" << '\n';
+        Out << "                    indexes[docId] |= (unsigned int)splitBins[docId] << depth;" << '\n';
+        Out << "                }" << '\n';
+        Out << "            }" << '\n';
+        Out << "            for (unsigned int docId = 0; docId < docCount; ++docId) {" << '\n';
+        Out << "                results[docId] += leafValues[indexes[docId]];" << '\n';
+        Out << "            }" << '\n';
+        Out << "            treeSplits += Depth;" << '\n';
+        Out << "            leafValues += (1u << Depth);" << '\n';
+        Out << "        }" << '\n';
+        Out << "    }" << '\n';
+        Out << "}" << '\n';
+        Out << '\n';
+        Out << "/* Evaluates docCount documents, features of document i start at features[i * featureStride] */" << '\n';
+        Out << "void ApplyCatboostModelBatch(" << '\n';
+        Out << "    const float* features," << '\n';
+        Out << "    size_t docCount," << '\n';
+        Out << "    size_t featureStride," << '\n';
+        Out << "    double* results" << '\n';
+        Out << ") {" << '\n';
+        Out << "    using namespace CatboostModelSpecialized;" << '\n';
+        Out << "    const unsigned int binaryFeatureStride = (unsigned int)std::min<size_t>(docCount, BlockSize);" << '\n';
+        Out << "    std::vector<unsigned char> binaryFeatures(std::max(BinaryFeatureCount, 1u) * binaryFeatureStride);" << '\n';
+        Out << "    for (size_t blockStart = 0; blockStart < docCount; blockStart += BlockSize) {" << '\n';
+        Out << "        const unsigned int blockDocCount = (unsigned int)std::min<size_t>(docCount - blockStart, BlockSize);" << '\n';
+        Out << "        const float* blockFeatures = features + blockStart * featureStride;" << '\n';
+        Out << "        double* blockResults = results + blockStart;" << '\n';
+        Out << '\n';
+        Out << "        /* Binarise features */" << '\n';
+        Out << "        unsigned int binFeatureIndex = 0;" << '\n';
+        Out << "        for (unsigned int i = 0; i < FloatFeatureCount; ++i) {" << '\n';
+        Out << "            for (unsigned int j = 0; j < BorderCounts[i]; ++j) {" << '\n';
+        Out << "                unsigned char* bins = binaryFeatures.data() + binFeatureIndex * binaryFeatureStride;" << '\n';
+        Out << "                const float border = Borders[binFeatureIndex];" << '\n';
+        Out << "                for (unsigned int docId = 0; docId < blockDocCount; ++docId) {" << '\n';
+        Out << "                    bins[docId] = (unsigned char)(blockFeatures[docId * featureStride + i] > border);" << '\n';
+        Out << "                }" << '\n';
+        Out << "                ++binFeatureIndex;" << '\n';
+        Out << "            }" << '\n';
+        Out << "        }" << '\n';
+        Out << '\n';
+        Out << "        /* Extract and sum values from trees */" << '\n';
+        Out << "        for (unsigned int docId = 0; docId < blockDocCount; ++docId) {" << '\n';
+        Out << "            blockResults[docId] = ConstantTreesValue;" << '\n';
+        Out << "        }" << '\n';
+        for (const auto& [depth, treeIds] : GroupTreesByDepth(model)) {
+            if (depth == 0) {
+                continue;
+            }
+            Out << "        AddTrees<" << depth << ", " << treeIds.size() << ">(binaryFeatures.data(), binaryFeatureStride, blockDocCount, "
+                << "TreeSplitsDepth" << depth << ", LeafValuesDepth" << depth << ", blockResults);" << '\n';
+        }
+        Out << "        for (unsigned int docId = 0; docId < blockDocCount; ++docId) {" << '\n';
+        Out << "            blockResults[docId] = Scale * blockResults[docId] + Bias;" << '\n';
+        Out << "        }" << '\n';
+        Out << "    }" << '\n';
+        Out << "}" << '\n';
+        Out << '\n';
+        Out << "double ApplyCatboostModel(" << '\n';
+        Out << "    const std::vector<float>& features" << '\n';
+        Out << ") {" << '\n';
+        Out << "    double result = 0.0;" << '\n';
+        Out << "    ApplyCatboostModelBatch(features.data(), 1, features.size(), &result);" << '\n';
+        Out << "    return result;" << '\n';
+        Out << "}" << '\n';
+
+        // Also emit the API with catFeatures, for uniformity
+        Out << '\n';
+        Out << "double ApplyCatboostModel(" << '\n';
+        Out << "    const std::vector<float>& floatFeatures," << '\n';
+        Out << "    const std::vector<std::string>&" << '\n';
+        Out << ") {" << '\n';
+        Out << "    return ApplyCatboostModel(floatFeatures);" << '\n';
+        Out << "}" << '\n';
+    }
+
     /*
      * Full model code with complete support of cat features
      */
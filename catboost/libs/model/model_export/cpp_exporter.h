@@ -11,12 +11,13 @@ namespace NCB {
     class TCatboostModelToCppConverter: public ICatboostModelExporter {
     private:
         TOFStream Out;
+        bool SpecializedEvaluation = false;
 
     public:
         TCatboostModelToCppConverter(const TString& modelFile, bool addFileFormatExtension, const TString& userParametersJson)
             : Out(modelFile + (addFileFormatExtension ? ".cpp" : ""))
         {
-            CB_ENSURE(userParametersJson.empty(), "JSON user params for exporting the model to C++ are not supported");
+            ParseUserParameters(userParametersJson);
         };
 
         void Write(const TFullModel& model, const THashMap<ui32, TString>* catFeaturesHashToString = nullptr) override {
@@ -27,6 +28,10 @@ namespace NCB {
                 WriteHeader(/*forCatFeatures*/true);
                 WriteModelCatFeatures(model, catFeaturesHashToString);
                 WriteApplicatorCatFeatures();
+            } else if (SpecializedEvaluation) {
+                WriteHeader(/*forCatFeatures*/false, /*forSpecializedEvaluation*/true);
+                WriteSpecializedModel(model);
+                WriteSpecializedApplicator(model);
             } else {
                 WriteHeader(/*forCatFeatures*/false);
                 WriteModel(model);
@@ -35,9 +40,12 @@ namespace NCB {
         }
 
     private:
+        void ParseUserParameters(const TString& userParametersJson);
         void WriteApplicator();
         void WriteModel(const TFullModel& model);
-        void WriteHeader(bool forCatFeatures);
+        void WriteHeader(bool forCatFeatures, bool forSpecializedEvaluation = false);
+        void WriteSpecializedModel(const TFullModel& model);
+        void WriteSpecializedApplicator(const TFullModel& model);
         void WriteCTRStructs();
         void WriteModelCatFeatures(const TFullModel& model, const THashMap<ui32, TString>* catFeaturesHashToString);
         void WriteApplicatorCatFeatures();
@@ -8,6 +8,7 @@
 #include <library/cpp/json/json_reader.h>
 #include <library/cpp/json/json_writer.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/set.h>
 #include <util/string/builder.h>
 #include <util/string/cast.h>
@@ -32,13 +33,17 @@ static void FromJson(const TJsonValue& value, TString* result) {
     *result = value.GetString();
 }
 
-static void WriteJsonWithCatBoostPrecision(const TJsonValue& value, bool formatOutput, IOutputStream* out) {
+static TJsonWriterConfig GetCatBoostJsonWriterConfig(bool formatOutput) {
     TJsonWriterConfig config;
     config.FormatOutput = formatOutput;
     config.FloatNDigits = 9;
     config.DoubleNDigits = 17;
     config.SortKeys = true;
-    WriteJson(out, &value, config);
+    return config;
+}
+
+static void WriteJsonWithCatBoostPrecision(const TJsonValue& value, bool formatOutput, IOutputStream* out) {
+    WriteJson(out, &value, GetCatBoostJsonWriterConfig(formatOutput));
 }
 
 static TString WriteJsonWithCatBoostPrecision(const TJsonValue& value, bool formatOutput) {
@@ -346,10 +351,11 @@ static void GetFeaturesInfo(const TJsonValue& jsonValue, TModelTrees* modelTrees
     }
 }
 
-static TJsonValue GetObliviousModelTreesJson(const TModelTrees& modelTrees) {
+// onTree is called with json of each tree in order
+template <class TOnTreeJson>
+static void ForEachObliviousTreeJson(const TModelTrees& modelTrees, TOnTreeJson&& onTree) {
     int leafValuesOffset = 0;
     int leafWeightsOffset = 0;
-    TJsonValue jsonValue;
     const auto& binFeatures = modelTrees.GetBinFeatures();
     for (int treeIdx = 0; treeIdx < modelTrees.GetTreeSizes().ysize(); ++treeIdx) {
         TJsonValue tree;
@@ -377,8 +383,15 @@ static TJsonValue GetObliviousModelTreesJson(const TModelTrees& modelTrees) {
             tree["splits"].AppendValue(ToJson(binFeatures[modelTrees.GetTreeSplits()[idx]]));
             tree["splits"].Back().InsertValue("split_index", modelTrees.GetTreeSplits()[idx]);
         }
-        jsonValue.AppendValue(tree);
+        onTree(std::move(tree));
     }
+}
+
+static TJsonValue GetObliviousModelTreesJson(const TModelTrees& modelTrees) {
+    TJsonValue jsonValue;
+    ForEachObliviousTreeJson(modelTrees, [&] (TJsonValue&& tree) {
+        jsonValue.AppendValue(std::move(tree));
+    });
     return jsonValue;
 }
 
@@ -411,11 +424,18 @@ static TJsonValue BuildTreeJson(const TModelTrees& modelTrees, ui32 nodeIdx) {
     return tree;
 }
 
-static TJsonValue GetNonSymmetricModelTreesJson(const TModelTrees& modelTrees) {
-    TJsonValue jsonValue(JSON_ARRAY);
+template <class TOnTreeJson>
+static void ForEachNonSymmetricTreeJson(const TModelTrees& modelTrees, TOnTreeJson&& onTree) {
     for (int treeIdx = 0; treeIdx < modelTrees.GetTreeSizes().ysize(); ++treeIdx) {
-        jsonValue.AppendValue(BuildTreeJson(modelTrees, modelTrees.GetTreeStartOffsets()[treeIdx]));
+        onTree(BuildTreeJson(modelTrees, modelTrees.GetTreeStartOffsets()[treeIdx]));
     }
+}
+
+static TJsonValue GetNonSymmetricModelTreesJson(const TModelTrees& modelTrees) {
+    TJsonValue jsonValue(JSON_ARRAY);
+    ForEachNonSymmetricTreeJson(modelTrees, [&] (TJsonValue&& tree) {
+        jsonValue.AppendValue(std::move(tree));
+    });
     return jsonValue;
 }
 
@@ -484,60 +504,91 @@ static void GetNonSymmetricModelTrees(const TJsonValue& jsonValue, TModelTrees*
     modelTrees->SetNonSymmetricNodeIdToLeafId(std::move(nodeIdToLeafId));
 }
 
-static NJson::TJsonValue ConvertCtrsToJson(const TStaticCtrProvider* ctrProvider, const TVector<TModelCtr>& neededCtrs) {
-    NJson::TJsonValue jsonValue;
-    if (neededCtrs.empty()) {
-        return jsonValue;
+static NJson::TJsonValue CtrTableToJson(const TCtrValueTable& learnCtr, ECtrType ctrType) {
+    NJson::TJsonValue hashValue;
+    auto hashIndexResolver = learnCtr.GetIndexHashViewer();
+    TSet<ui64> hashIndexes;
+    for (const auto& bucket: hashIndexResolver.GetBuckets()) {
+        auto value = bucket.IndexValue;
+        if (value == NCatboost::TDenseIndexHashView::NotFoundIndex) {
+            continue;
+        }
+        if (hashIndexes.find(bucket.Hash) != hashIndexes.end()) {
+            continue;
+        } else {
+            hashIndexes.insert(bucket.Hash);
+        }
+        hashValue.AppendValue(ToString(bucket.Hash));
+        if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
+            if (value != NCatboost::TDenseIndexHashView::NotFoundIndex) {
+                auto ctrMean = learnCtr.GetTypedArrayRefForBlobData<TCtrMeanHistory>();
+                const TCtrMeanHistory& ctrMeanHistory = ctrMean[value];
+                hashValue.AppendValue(ctrMeanHistory.Sum);
+                hashValue.AppendValue(ctrMeanHistory.Count);
+            }
+        } else  if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
+            TConstArrayRef<int> ctrTotal = learnCtr.GetTypedArrayRefForBlobData<int>();
+            hashValue.AppendValue(ctrTotal[value]);
+        } else {
+            auto ctrIntArray = learnCtr.GetTypedArrayRefForBlobData<int>();
+            const int targetClassesCount = learnCtr.TargetClassesCount;
+            auto ctrHistory = MakeArrayRef(ctrIntArray.data() + value * targetClassesCount, targetClassesCount);
+            for (int classId = 0; classId < targetClassesCount; ++classId) {
+                hashValue.AppendValue(ctrHistory[classId]);
+            }
+        }
     }
+    NJson::TJsonValue hash;
+    hash["hash_stride"] =  hashValue.GetArray().ysize() / hashIndexes.size();
+    hash["hash_map"] = std::move(hashValue);
+    hash["counter_denominator"] = learnCtr.CounterDenominator;
+    return hash;
+}
+
+struct TCtrTableRef {
+    TString Key;
+    const TCtrValueTable* Table;
+    ECtrType CtrType;
+};
+
+// tables are ordered by their keys in ctr_data, as they are written by json writer with keys sorting
+static TVector<TCtrTableRef> GetCtrTables(const TStaticCtrProvider* ctrProvider, const TVector<TModelCtr>& neededCtrs) {
+    TVector<TCtrTableRef> tables;
     auto compressedModelCtrs = NCB::CompressModelCtrs(neededCtrs);
     for (size_t idx = 0; idx < compressedModelCtrs.size(); ++idx) {
         auto& proj = *compressedModelCtrs[idx].Projection;
         for (const auto& ctr: compressedModelCtrs[idx].ModelCtrs) {
-            NJson::TJsonValue hashValue;
-            auto& learnCtr = ctrProvider->CtrData.LearnCtrs.at(ctr->Base);
-            auto hashIndexResolver = learnCtr.GetIndexHashViewer();
-            const ECtrType ctrType = ctr->Base.CtrType;
-            TSet<ui64> hashIndexes;
-            for (const auto& bucket: hashIndexResolver.GetBuckets()) {
-                auto value = bucket.IndexValue;
-                if (value == NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                    continue;
-                }
-                if (hashIndexes.find(bucket.Hash) != hashIndexes.end()) {
-                    continue;
-                } else {
-                    hashIndexes.insert(bucket.Hash);
-                }
-                hashValue.AppendValue(ToString(bucket.Hash));
-                if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
-                    if (value != NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                        auto ctrMean = learnCtr.GetTypedArrayRefForBlobData<TCtrMeanHistory>();
-                        const TCtrMeanHistory& ctrMeanHistory = ctrMean[value];
-                        hashValue.AppendValue(ctrMeanHistory.Sum);
-                        hashValue.AppendValue(ctrMeanHistory.Count);
-                    }
-                } else  if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
-                    TConstArrayRef<int> ctrTotal = learnCtr.GetTypedArrayRefForBlobData<int>();
-                    hashValue.AppendValue(ctrTotal[value]);
-                } else {
-                    auto ctrIntArray = learnCtr.GetTypedArrayRefForBlobData<int>();
-                    const int targetClassesCount = learnCtr.TargetClassesCount;
-                    auto ctrHistory = MakeArrayRef(ctrIntArray.data() + value * targetClassesCount, targetClassesCount);
-                    for (int classId = 0; classId < targetClassesCount; ++classId) {
-                        hashValue.AppendValue(ctrHistory[classId]);
-                    }
-                }
-            }
-            NJson::TJsonValue hash;
-            hash["hash_map"] = hashValue;
-            hash["hash_stride"] =  hashValue.GetArray().ysize() / hashIndexes.size();
-            hash["counter_denominator"] = learnCtr.CounterDenominator;
             TModelCtrBase modelCtrBase;
             modelCtrBase.Projection = proj;
-            modelCtrBase.CtrType = ctrType;
-            jsonValue.InsertValue(ModelCtrBaseToStr(modelCtrBase), hash);
+            modelCtrBase.CtrType = ctr->Base.CtrType;
+            tables.push_back(
+                TCtrTableRef{
+                    ModelCtrBaseToStr(modelCtrBase),
+                    &ctrProvider->CtrData.LearnCtrs.at(ctr->Base),
+                    ctr->Base.CtrType
+                }
+            );
+        }
+    }
+    StableSortBy(tables, [] (const TCtrTableRef& table) { return table.Key; });
+
+    TVector<TCtrTableRef> uniqueTables;
+    for (auto& table : tables) {
+        if (!uniqueTables.empty() && (uniqueTables.back().Key == table.Key)) {
+            // the last table with the same key is kept as with TJsonValue::InsertValue
+            uniqueTables.back() = std::move(table);
+        } else {
+            uniqueTables.push_back(std::move(table));
         }
     }
+    return uniqueTables;
+}
+
+static NJson::TJsonValue ConvertCtrsToJson(const TStaticCtrProvider* ctrProvider, const TVector<TModelCtr>& neededCtrs) {
+    NJson::TJsonValue jsonValue;
+    for (const auto& table : GetCtrTables(ctrProvider, neededCtrs)) {
+        jsonValue.InsertValue(table.Key, CtrTableToJson(*table.Table, table.CtrType));
+    }
     return jsonValue;
 }
 
@@ -548,8 +599,7 @@ static TJsonValue GetScaleAndBiasJson(const TFullModel& model) {
     return jsonValue;
 }
 
-TJsonValue ConvertModelToJson(const TFullModel& model, const TVector<TString>* featureId, const THashMap<ui32, TString>* catFeaturesHashToString) {
-    TJsonValue jsonModel;
+static TJsonValue GetModelInfoJson(const TFullModel& model) {
     TJsonValue modelInfo;
     for (const auto& key_value : model.ModelInfo) {
         if (key_value.first.EndsWith("params")) {
@@ -563,7 +613,12 @@ TJsonValue ConvertModelToJson(const TFullModel& model, const TVector<TString>* f
             modelInfo.InsertValue(key_value.first, key_value.second);
         }
     }
-    jsonModel.InsertValue("model_info", modelInfo);
+    return modelInfo;
+}
+
+TJsonValue ConvertModelToJson(const TFullModel& model, const TVector<TString>* featureId, const THashMap<ui32, TString>* catFeaturesHashToString) {
+    TJsonValue jsonModel;
+    jsonModel.InsertValue("model_info", GetModelInfoJson(model));
     if (model.IsOblivious()) {
         jsonModel.InsertValue("oblivious_trees", GetModelTreesJson(*model.ModelTrees));
     } else {
@@ -655,8 +710,47 @@ void ConvertJsonToCatboostModel(const TJsonValue& jsonModel, TFullModel* fullMod
     fullModel->UpdateDynamicData();
 }
 
+/* Writes the same json as ConvertModelToJson but without building it in memory as a whole:
+ * trees and ctr tables are converted and written one by one.
+ * Top level keys are written in sorted order as json writer with keys sorting does.
+ */
 void OutputModelJson(const TFullModel& model, const TString& outputPath, const TVector<TString>* featureId, const THashMap<ui32, TString>* catFeaturesHashToString) {
     TOFStream out(outputPath);
-    auto jsonModel = ConvertModelToJson(model, featureId, catFeaturesHashToString);
-    WriteJsonWithCatBoostPrecision(jsonModel, true, &out);
+    TJsonWriter writer(&out, GetCatBoostJsonWriterConfig(/*formatOutput*/ true), /*DontFlushInDestructor*/ true);
+    writer.OpenMap();
+
+    const TStaticCtrProvider* ctrProvider = dynamic_cast<TStaticCtrProvider*>(model.CtrProvider.Get());
+    if (ctrProvider) {
+        const auto& usedModelCtrs = model.ModelTrees->GetUsedModelCtrs();
+        if (usedModelCtrs.empty()) {
+            writer.WriteNull("ctr_data");
+        } else {
+            writer.OpenMap("ctr_data");
+            for (const auto& table : GetCtrTables(ctrProvider, usedModelCtrs)) {
+                writer.Write(table.Key, CtrTableToJson(*table.Table, table.CtrType));
+            }
+            writer.CloseMap();
+        }
+    }
+    writer.Write("features_info", GetFeaturesInfoJson(*model.ModelTrees, featureId, catFeaturesHashToString));
+    writer.Write("model_info", GetModelInfoJson(model));
+
+    const auto writeTree = [&] (TJsonValue&& tree) {
+        writer.Write(tree);
+    };
+    if (!model.IsOblivious()) {
+        writer.OpenArray("trees");
+        ForEachNonSymmetricTreeJson(*model.ModelTrees, writeTree);
+        writer.CloseArray();
+    } else if (model.GetTreeCount() == 0) {
+        writer.WriteNull("oblivious_trees"); // as an empty array is not created in GetObliviousModelTreesJson
+    } else {
+        writer.OpenArray("oblivious_trees");
+        ForEachObliviousTreeJson(*model.ModelTrees, writeTree);
+        writer.CloseArray();
+    }
+
+    writer.Write("scale_and_bias", GetScaleAndBiasJson(model));
+    writer.CloseMap();
+    writer.Flush();
 }
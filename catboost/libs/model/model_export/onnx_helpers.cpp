@@ -267,8 +267,8 @@ struct TTreesAttributes {
     onnx::AttributeProto* base_values;  // can be nullptr if model has no bias.
     onnx::AttributeProto* nodes_falsenodeids;
     onnx::AttributeProto* nodes_featureids;
-    onnx::AttributeProto* nodes_hitrates;
-    onnx::AttributeProto* nodes_missing_value_tracks_true;
+    onnx::AttributeProto* nodes_hitrates;  // can be nullptr, not used
+    onnx::AttributeProto* nodes_missing_value_tracks_true;  // can be nullptr if there are no nan as true splits
     onnx::AttributeProto* nodes_modes;
     onnx::AttributeProto* nodes_nodeids;
     onnx::AttributeProto* nodes_treeids;
@@ -279,6 +279,7 @@ public:
     TTreesAttributes(
         bool isClassifierModel,
         bool hasBias,
+        bool hasNanAsTrueSplits,
         google::protobuf::RepeatedPtrField<onnx::AttributeProto>* treesNodeAttributes) {
 
 #define GET_ATTR(attr, attr_type_suffix) \
@@ -310,11 +311,17 @@ public:
 
         if (hasBias) {
             GET_ATTR(base_values, FLOATS);
+        } else {
+            base_values = nullptr;
         }
         GET_ATTR(nodes_falsenodeids, INTS);
         GET_ATTR(nodes_featureids, INTS);
-        GET_ATTR(nodes_hitrates, FLOATS);
-        GET_ATTR(nodes_missing_value_tracks_true, INTS);
+        nodes_hitrates = nullptr; // optional, all nodes have the default hit rate
+        if (hasNanAsTrueSplits) {
+            GET_ATTR(nodes_missing_value_tracks_true, INTS);
+        } else {
+            nodes_missing_value_tracks_true = nullptr;
+        }
         GET_ATTR(nodes_modes, STRINGS);
         GET_ATTR(nodes_nodeids, INTS);
         GET_ATTR(nodes_treeids, INTS);
@@ -344,6 +351,8 @@ public:
             class_weights = nullptr;
         }
         base_values = nullptr;
+        nodes_hitrates = nullptr;
+        nodes_missing_value_tracks_true = nullptr;
 
         for (auto& attribute : attributes) {
             if (isClassifierModel) {
@@ -374,107 +383,172 @@ public:
 };
 
 
-static void AddTree(
+static void AddLeaf(
     const TModelTrees& trees,
     i64 treeIdx,
+    i64 nodeIdx,
+    const double* leafValue,
     bool isClassifierModel,
     TTreesAttributes* treesAttributes) {
 
-    i64 nodeIdx = 0;
+    treesAttributes->nodes_treeids->add_ints(treeIdx);
+    treesAttributes->nodes_nodeids->add_ints(nodeIdx);
 
-    // Process splits
-    for (auto depth : xrange(trees.GetTreeSizes()[treeIdx])) {
-        const auto& split = trees.GetBinFeatures()[
-            trees.GetTreeSplits()[trees.GetTreeStartOffsets()[treeIdx] + (trees.GetTreeSizes()[treeIdx] - 1 - depth)]];
+    treesAttributes->nodes_modes->add_strings(TModeNode::LEAF);
 
-        int splitFlatFeatureIdx = 0;
-        TString nodeMode;
-        i64 missingValueTracksTrue = 0;
-        float splitValue = 0.0f;
+    // add dummy values because nodes_* must have equal length
+    treesAttributes->nodes_featureids->add_ints(0);
+    treesAttributes->nodes_values->add_floats(0.0f);
+    treesAttributes->nodes_falsenodeids->add_ints(0);
+    treesAttributes->nodes_truenodeids->add_ints(0);
+    if (treesAttributes->nodes_missing_value_tracks_true) {
+        treesAttributes->nodes_missing_value_tracks_true->add_ints(0);
+    }
 
-        if (split.Type == ESplitType::FloatFeature) {
-            const auto& floatFeature = trees.GetFloatFeatures()[split.FloatFeature.FloatFeature];
-            splitFlatFeatureIdx = floatFeature.Position.FlatIndex;
-            nodeMode = TModeNode::BRANCH_GT;
-            if (floatFeature.NanValueTreatment == TFloatFeature::ENanValueTreatment::AsTrue) {
-                missingValueTracksTrue = 1;
+    if (isClassifierModel) {
+        if (trees.GetDimensionsCount() > 1) {
+            for (auto approxIdx : xrange(trees.GetDimensionsCount())) {
+                treesAttributes->class_treeids->add_ints(treeIdx);
+                treesAttributes->class_nodeids->add_ints(nodeIdx);
+
+                treesAttributes->class_ids->add_ints(approxIdx);
+                treesAttributes->class_weights->add_floats((float)leafValue[approxIdx]);
             }
-            splitValue = split.FloatFeature.Split;
         } else {
-            CB_ENSURE_INTERNAL(
-                false,
-                "Categorical features splits are unsupported in ONNX-ML format export for now"
-            );
+            treesAttributes->class_treeids->add_ints(treeIdx);
+            treesAttributes->class_nodeids->add_ints(nodeIdx);
+            treesAttributes->class_ids->add_ints(0);
+            treesAttributes->class_weights->add_floats(-(float)*leafValue);
+
+            treesAttributes->class_treeids->add_ints(treeIdx);
+            treesAttributes->class_nodeids->add_ints(nodeIdx);
+            treesAttributes->class_ids->add_ints(1);
+            treesAttributes->class_weights->add_floats((float)*leafValue);
         }
+    } else {
+        Y_ASSERT(trees.GetDimensionsCount() == 1);
 
-        i64 endNodeIdx = 2*nodeIdx + 1;
-        for (; nodeIdx < endNodeIdx; ++nodeIdx) {
-            treesAttributes->nodes_treeids->add_ints(treeIdx);
-            treesAttributes->nodes_nodeids->add_ints(nodeIdx);
+        treesAttributes->target_treeids->add_ints(treeIdx);
+        treesAttributes->target_nodeids->add_ints(nodeIdx);
 
-            treesAttributes->nodes_modes->add_strings(nodeMode);
+        treesAttributes->target_ids->add_ints(0);
+        treesAttributes->target_weights->add_floats((float)*leafValue);
+    }
+}
 
-            treesAttributes->nodes_featureids->add_ints((i64)splitFlatFeatureIdx);
-            treesAttributes->nodes_values->add_floats(splitValue);
-            treesAttributes->nodes_falsenodeids->add_ints(2*nodeIdx + 1);
-            treesAttributes->nodes_truenodeids->add_ints(2*nodeIdx + 2);
-            treesAttributes->nodes_missing_value_tracks_true->add_ints(missingValueTracksTrue);
-            treesAttributes->nodes_hitrates->add_floats(1.0f);
+// leaves [leafBegin, leafEnd) have the same values in float precision used by ONNX
+static bool HasSameLeafValues(
+    const double* leafValues,
+    size_t approxDimension,
+    size_t leafBegin,
+    size_t leafEnd) {
+
+    for (auto leafIdx : xrange(leafBegin + 1, leafEnd)) {
+        for (auto approxIdx : xrange(approxDimension)) {
+            if ((float)leafValues[leafIdx * approxDimension + approxIdx]
+                != (float)leafValues[leafBegin * approxDimension + approxIdx])
+            {
+                return false;
+            }
         }
     }
+    return true;
+}
 
-    // Process leafs
-    const double* leafValue = trees.GetLeafValues().begin() + trees.GetFirstLeafOffsets()[treeIdx];
-
-    for (i64 endNodeIdx = 2*nodeIdx + 1; nodeIdx < endNodeIdx; ++nodeIdx) {
-        treesAttributes->nodes_treeids->add_ints(treeIdx);
-        treesAttributes->nodes_nodeids->add_ints(nodeIdx);
+/* Adds the subtree of an oblivious tree node at the given depth, leafBegin is the index of its first leaf.
+ * Subtrees with the same values in all leaves (e.g. leaves that no learn object reached) are exported
+ * as a single leaf, so the exported model has no split conditions that can't change the result.
+ * Returns the node id of the exported subtree root.
+ */
+static i64 AddSubtree(
+    const TModelTrees& trees,
+    i64 treeIdx,
+    size_t depth,
+    size_t leafBegin,
+    bool isClassifierModel,
+    i64* nextNodeIdx,
+    TTreesAttributes* treesAttributes) {
 
-        treesAttributes->nodes_modes->add_strings(TModeNode::LEAF);
+    const size_t treeDepth = trees.GetTreeSizes()[treeIdx];
+    const size_t approxDimension = trees.GetDimensionsCount();
+    const double* leafValues = trees.GetLeafValues().begin() + trees.GetFirstLeafOffsets()[treeIdx];
+    const size_t leafEnd = leafBegin + (size_t(1) << (treeDepth - depth));
 
-        // add dummy values because nodes_* must have equal length
-        treesAttributes->nodes_featureids->add_ints(0);
-        treesAttributes->nodes_values->add_floats(0.0f);
-        treesAttributes->nodes_falsenodeids->add_ints(0);
-        treesAttributes->nodes_truenodeids->add_ints(0);
-        treesAttributes->nodes_missing_value_tracks_true->add_ints(0);
-        treesAttributes->nodes_hitrates->add_floats(1.0f);
+    const i64 nodeIdx = (*nextNodeIdx)++;
+    if (HasSameLeafValues(leafValues, approxDimension, leafBegin, leafEnd)) {
+        AddLeaf(trees, treeIdx, nodeIdx, leafValues + leafBegin * approxDimension, isClassifierModel, treesAttributes);
+        return nodeIdx;
+    }
 
+    const auto& split = trees.GetBinFeatures()[
+        trees.GetTreeSplits()[trees.GetTreeStartOffsets()[treeIdx] + (treeDepth - 1 - depth)]];
+
+    CB_ENSURE_INTERNAL(
+        split.Type == ESplitType::FloatFeature,
+        "Categorical features splits are unsupported in ONNX-ML format export for now"
+    );
+    const auto& floatFeature = trees.GetFloatFeatures()[split.FloatFeature.FloatFeature];
+
+    const int nodeAttributesIdx = treesAttributes->nodes_nodeids->ints_size();
+    treesAttributes->nodes_treeids->add_ints(treeIdx);
+    treesAttributes->nodes_nodeids->add_ints(nodeIdx);
+
+    treesAttributes->nodes_modes->add_strings(TModeNode::BRANCH_GT);
+
+    treesAttributes->nodes_featureids->add_ints((i64)floatFeature.Position.FlatIndex);
+    treesAttributes->nodes_values->add_floats(split.FloatFeature.Split);
+    // child node ids are set after the children are added
+    treesAttributes->nodes_falsenodeids->add_ints(0);
+    treesAttributes->nodes_truenodeids->add_ints(0);
+    if (treesAttributes->nodes_missing_value_tracks_true) {
+        treesAttributes->nodes_missing_value_tracks_true->add_ints(
+            floatFeature.NanValueTreatment == TFloatFeature::ENanValueTreatment::AsTrue ? 1 : 0
+        );
+    }
 
-        if (isClassifierModel) {
-            if (trees.GetDimensionsCount() > 1) {
-                for (auto approxIdx : xrange(trees.GetDimensionsCount())) {
-                    treesAttributes->class_treeids->add_ints(treeIdx);
-                    treesAttributes->class_nodeids->add_ints(nodeIdx);
-
-                    treesAttributes->class_ids->add_ints(approxIdx);
-                    treesAttributes->class_weights->add_floats((float)*leafValue);
-                    ++leafValue;
-                }
-            } else {
-                treesAttributes->class_treeids->add_ints(treeIdx);
-                treesAttributes->class_nodeids->add_ints(nodeIdx);
-                treesAttributes->class_ids->add_ints(0);
-                treesAttributes->class_weights->add_floats(-(float)*leafValue);
+    const size_t childLeafCount = (leafEnd - leafBegin) / 2;
+    const i64 falseNodeIdx = AddSubtree(
+        trees,
+        treeIdx,
+        depth + 1,
+        leafBegin,
+        isClassifierModel,
+        nextNodeIdx,
+        treesAttributes);
+    const i64 trueNodeIdx = AddSubtree(
+        trees,
+        treeIdx,
+        depth + 1,
+        leafBegin + childLeafCount,
+        isClassifierModel,
+        nextNodeIdx,
+        treesAttributes);
+    treesAttributes->nodes_falsenodeids->set_ints(nodeAttributesIdx, falseNodeIdx);
+    treesAttributes->nodes_truenodeids->set_ints(nodeAttributesIdx, trueNodeIdx);
+
+    return nodeIdx;
+}
 
-                treesAttributes->class_treeids->add_ints(treeIdx);
-                treesAttributes->class_nodeids->add_ints(nodeIdx);
-                treesAttributes->class_ids->add_ints(1);
-                treesAttributes->class_weights->add_floats((float)*leafValue);
 
-                ++leafValue;
-            }
-        } else {
-            Y_ASSERT(trees.GetDimensionsCount() == 1);
+static void AddTree(
+    const TModelTrees& trees,
+    i64 treeIdx,
+    bool isClassifierModel,
+    TTreesAttributes* treesAttributes) {
 
-            treesAttributes->target_treeids->add_ints(treeIdx);
-            treesAttributes->target_nodeids->add_ints(nodeIdx);
+    i64 nextNodeIdx = 0;
+    AddSubtree(trees, treeIdx, /*depth*/ 0, /*leafBegin*/ 0, isClassifierModel, &nextNodeIdx, treesAttributes);
+}
 
-            treesAttributes->target_ids->add_ints(0);
-            treesAttributes->target_weights->add_floats((float)*leafValue);
-            ++leafValue;
+static bool HasNanAsTrueSplits(const TModelTrees& trees) {
+    for (const auto& floatFeature : trees.GetFloatFeatures()) {
+        if (floatFeature.UsedInModel()
+            && (floatFeature.NanValueTreatment == TFloatFeature::ENanValueTreatment::AsTrue))
+        {
+            return true;
         }
     }
+    return false;
 }
 
 
@@ -561,7 +635,11 @@ void NCB::NOnnx::ConvertTreeToOnnxGraph(
 
     const float bias = float(model.GetScaleAndBias().Bias);
 
-    TTreesAttributes treesAttributes(isClassifierModel, bias != 0, treesNode->mutable_attribute());
+    TTreesAttributes treesAttributes(
+        isClassifierModel,
+        bias != 0,
+        HasNanAsTrueSplits(trees),
+        treesNode->mutable_attribute());
 
     if (bias != 0) {
         if (isClassifierModel && (trees.GetDimensionsCount() == 1)) {
@@ -633,7 +711,9 @@ static void PrepareTrees(
             split.FloatFeature.Split = treesAttributes.nodes_values->floats(idx);
 
             //update floatFeatures
-            if (treesAttributes.nodes_missing_value_tracks_true->ints(idx) == 1) {
+            if (treesAttributes.nodes_missing_value_tracks_true
+                && (treesAttributes.nodes_missing_value_tracks_true->ints(idx) == 1))
+            {
                 (*floatFeatures)[split.FloatFeature.FloatFeature].NanValueTreatment =
                 ENanValueTreatment::AsTrue;
             }
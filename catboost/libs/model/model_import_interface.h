@@ -6,9 +6,8 @@
 
 #include <library/cpp/object_factory/object_factory.h>
 
-#include <util/generic/buffer.h>
-#include <util/stream/buffer.h>
 #include <util/stream/file.h>
+#include <util/stream/mem.h>
 #include <util/system/fs.h>
 
 namespace NCB {
@@ -21,9 +20,8 @@ namespace NCB {
             return ReadModel(&f);
         }
         virtual TFullModel ReadModel(const void* data, size_t dataSize) const {
-            TBuffer buf((char*)data, dataSize);
-            TBufferInput bs(buf);
-            return ReadModel(&bs);
+            TMemoryInput in(data, dataSize);
+            return ReadModel(&in);
         }
         virtual ~IModelLoader() = default;
     protected:
@@ -0,0 +1,24 @@
+#include "model_registry.h"
+
+#include <util/generic/utility.h>
+
+
+TModelRegistry::TModelRegistry(TFullModel&& model) {
+    SetModel(std::move(model));
+}
+
+TModelRegistry::TModelPtr TModelRegistry::GetModel() const {
+    with_lock(ModelLock) {
+        return Model;
+    }
+}
+
+TModelRegistry::TModelPtr TModelRegistry::SetModel(TFullModel&& model) {
+    TModelPtr modelToPublish = MakeAtomicShared<TFullModel>(std::move(model));
+    modelToPublish->WarmUp();
+
+    with_lock(ModelLock) {
+        DoSwap(Model, modelToPublish);
+    }
+    return modelToPublish;
+}
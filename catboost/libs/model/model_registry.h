@@ -0,0 +1,37 @@
+#pragma once
+
+#include "model.h"
+
+#include <util/generic/noncopyable.h>
+#include <util/generic/ptr.h>
+#include <util/system/spinlock.h>
+
+
+/**
+ * \brief Holder of the currently served model that can be replaced under live traffic.
+ *
+ * Readers take a snapshot with GetModel() and keep it for the duration of their Calc calls. SetModel warms
+ *  the new model up before publishing it. The previous model is destroyed when the last snapshot that
+ *  references it is released, so in-flight predictions are never interrupted.
+ */
+class TModelRegistry : public TNonCopyable {
+public:
+    using TModelPtr = TAtomicSharedPtr<const TFullModel>;
+
+public:
+    TModelRegistry() = default;
+    explicit TModelRegistry(TFullModel&& model);
+
+    //! Current model snapshot, empty if no model was set yet
+    TModelPtr GetModel() const;
+
+    /**
+     * Warm up model and make it current.
+     * @return previous model snapshot
+     */
+    TModelPtr SetModel(TFullModel&& model);
+
+private:
+    mutable TAdaptiveLock ModelLock;
+    TModelPtr Model;
+};
@@ -1,7 +1,9 @@
 #include <catboost/libs/model/ut/lib/model_test_helpers.h>
 
 #include <catboost/libs/data/data_provider_builders.h>
+#include <catboost/libs/model/cpu/ensemble_evaluator.h>
 #include <catboost/libs/model/cpu/evaluator.h>
+#include <catboost/libs/model/cpu/quantization.h>
 #include <catboost/libs/model/model.h>
 #include <catboost/libs/train_lib/train_model.h>
 #include <catboost/private/libs/text_features/ut/lib/text_features_data.h>
@@ -75,6 +77,7 @@ Y_UNIT_TEST_SUITE(TObliviousTreeModel) {
         auto model = SimpleFloatModel();
         CheckFlatCalcResult(model, xrange<double>(8), xrange<ui32>(8));
         model.ModelTrees.GetMutable()->ConvertObliviousToAsymmetric();
+        UNIT_ASSERT(model.ModelTrees->HasBitvectorLayout());
         CheckFlatCalcResult(model, xrange<double>(8), xrange<ui32>(8));
     }
 
@@ -105,6 +108,18 @@ Y_UNIT_TEST_SUITE(TObliviousTreeModel) {
         CheckFlatCalcResult(model, expectedPredicts, expectedLeafIndexes);
     }
 
+    Y_UNIT_TEST(TestCompactTrees) {
+        auto model = SimpleFloatModel(2);
+        model.CompactTrees();
+        UNIT_ASSERT_VALUES_EQUAL(model.GetTreeCount(), 1);
+        UNIT_ASSERT_VALUES_EQUAL(model.ModelTrees->GetFloatFeatures()[0].Borders.size(), 1);
+        TVector<double> expectedPredicts;
+        for (ui32 sampleId = 0; sampleId < 8; ++sampleId) {
+            expectedPredicts.push_back(11.0 * sampleId);
+        }
+        CheckFlatCalcResult(model, expectedPredicts, xrange<ui32>(8));
+    }
+
     Y_UNIT_TEST(TestFlatCalcOnDeepTree) {
         const size_t treeDepth = 9;
         auto model = SimpleDeepTreeModel(treeDepth);
@@ -125,9 +140,272 @@ Y_UNIT_TEST_SUITE(TObliviousTreeModel) {
         const auto features = GetFeatureRef(data);
         CheckFlatCalcResult(model, expectedPredicts, expectedLeafIndexes, features);
         model.ModelTrees.GetMutable()->ConvertObliviousToAsymmetric();
+        UNIT_ASSERT(!model.ModelTrees->HasBitvectorLayout());
         CheckFlatCalcResult(model, expectedPredicts, expectedLeafIndexes, features);
     }
 
+    Y_UNIT_TEST(TestEvaluationBlockSizeCalibration) {
+        auto model = SimpleFloatModel(2);
+        TVector<ui32> expectedLeafIndexes;
+        TVector<double> expectedPredicts;
+        for (ui32 sampleId = 0; sampleId < 8; ++sampleId) {
+            expectedLeafIndexes.push_back(sampleId);
+            expectedLeafIndexes.push_back(sampleId);
+            expectedPredicts.push_back(11.0 * sampleId);
+        }
+        const size_t blockSize = model.CalibrateEvaluationBlockSize(FLOAT_FEATURES, {});
+        UNIT_ASSERT(blockSize >= MIN_FORMULA_EVALUATION_BLOCK_SIZE && blockSize <= FORMULA_EVALUATION_BLOCK_SIZE);
+        UNIT_ASSERT_VALUES_EQUAL(
+            model.ModelInfo.at(TString(EVALUATION_BLOCK_SIZE_MODEL_INFO_KEY)),
+            ToString(blockSize)
+        );
+        CheckFlatCalcResult(model, expectedPredicts, expectedLeafIndexes);
+
+        auto evaluator = CreateEvaluator(EFormulaEvaluatorType::CPU, model);
+        UNIT_ASSERT_EXCEPTION(evaluator->SetProperty("BlockSize", "0"), TCatBoostException);
+        UNIT_ASSERT_EXCEPTION(evaluator->SetProperty("BlockSize", "1000"), TCatBoostException);
+        UNIT_ASSERT_NO_EXCEPTION(evaluator->SetProperty("BlockSize", "3"));
+        TVector<double> predicts(FLOAT_FEATURES.size());
+        evaluator->CalcFlat(FLOAT_FEATURES, predicts);
+        UNIT_ASSERT_EQUAL(expectedPredicts, predicts);
+    }
+
+    Y_UNIT_TEST(TestSharedSplitsEvaluation) {
+        auto model = SimpleFloatModel(2);
+        UNIT_ASSERT_VALUES_EQUAL(model.ModelTrees->GetUniqueRepackedBins().size(), 3);
+        UNIT_ASSERT_VALUES_EQUAL(model.ModelTrees->GetSharedSplitTreeBins().size(), 6);
+        TVector<double> expectedPredicts;
+        for (ui32 sampleId = 0; sampleId < 8; ++sampleId) {
+            expectedPredicts.push_back(11.0 * sampleId);
+        }
+        auto evaluator = CreateEvaluator(EFormulaEvaluatorType::CPU, model);
+        UNIT_ASSERT_NO_EXCEPTION(evaluator->SetProperty("SharedSplits", "true"));
+        TVector<double> predicts(FLOAT_FEATURES.size());
+        evaluator->CalcFlat(FLOAT_FEATURES, predicts);
+        UNIT_ASSERT_EQUAL(expectedPredicts, predicts);
+    }
+
+    Y_UNIT_TEST(TestFloatLeafValuesEvaluation) {
+        auto model = SimpleFloatModel(3);
+        model.SetScaleAndBias({0.1, 0.5});
+        TVector<double> expectedPredicts(FLOAT_FEATURES.size());
+        model.CalcFlat(FLOAT_FEATURES, expectedPredicts);
+
+        auto evaluator = CreateEvaluator(EFormulaEvaluatorType::CPU, model);
+        UNIT_ASSERT_NO_EXCEPTION(evaluator->SetProperty("FloatLeafValues", "true"));
+        TVector<double> predicts(FLOAT_FEATURES.size());
+        evaluator->CalcFlat(FLOAT_FEATURES, predicts);
+        const double errorBound = GetFloatLeafValuesErrorBound(*model.ModelTrees);
+        UNIT_ASSERT(errorBound > 0);
+        for (size_t docId = 0; docId < predicts.size(); ++docId) {
+            UNIT_ASSERT_DOUBLES_EQUAL(expectedPredicts[docId], predicts[docId], errorBound);
+        }
+
+        auto multiValModel = MultiValueFloatModel();
+        auto multiValEvaluator = CreateEvaluator(EFormulaEvaluatorType::CPU, multiValModel);
+        UNIT_ASSERT_EXCEPTION(multiValEvaluator->SetProperty("FloatLeafValues", "true"), TCatBoostException);
+    }
+
+    Y_UNIT_TEST(TestEvaluationProfiling) {
+        auto model = SimpleFloatModel(2);
+        auto evaluator = CreateEvaluator(EFormulaEvaluatorType::CPU, model);
+        TVector<double> predicts(FLOAT_FEATURES.size());
+        evaluator->CalcFlat(FLOAT_FEATURES, predicts);
+        UNIT_ASSERT_VALUES_EQUAL(evaluator->GetProfile().Trees.DocCount, 0);
+
+        evaluator->SetProperty("EnableProfiling", "true");
+        evaluator->CalcFlat(FLOAT_FEATURES, predicts);
+        evaluator->CalcFlat(FLOAT_FEATURES, predicts);
+        const auto profile = evaluator->GetProfile();
+        UNIT_ASSERT_VALUES_EQUAL(profile.Binarization.DocCount, 2 * FLOAT_FEATURES.size());
+        UNIT_ASSERT_VALUES_EQUAL(profile.Trees.DocCount, 2 * FLOAT_FEATURES.size());
+        UNIT_ASSERT_VALUES_EQUAL(profile.Trees.TreeCount, 2 * model.GetTreeCount());
+        UNIT_ASSERT_VALUES_EQUAL(profile.Ctrs.DocCount, 0);
+        UNIT_ASSERT_VALUES_EQUAL(profile.TextFeatures.DocCount, 0);
+
+        evaluator->SetProperty("EnableProfiling", "false");
+        UNIT_ASSERT_VALUES_EQUAL(evaluator->GetProfile().Trees.DocCount, 0);
+    }
+
+    Y_UNIT_TEST(TestQuantizedLeafValuesEvaluation) {
+        auto model = SimpleFloatModel(3);
+        model.SetScaleAndBias({0.1, 0.5});
+        TVector<double> expectedPredicts(FLOAT_FEATURES.size());
+        model.CalcFlat(FLOAT_FEATURES, expectedPredicts);
+
+        auto evaluator = CreateEvaluator(EFormulaEvaluatorType::CPU, model);
+        UNIT_ASSERT_EXCEPTION(evaluator->SetProperty("QuantizedLeafValues", "1e-9"), TCatBoostException);
+        UNIT_ASSERT_NO_EXCEPTION(evaluator->SetProperty("QuantizedLeafValues", "0.01"));
+        const double errorBound = FromString<double>(*evaluator->GetProperty("QuantizedLeafValuesErrorBound"));
+        UNIT_ASSERT(errorBound > 0 && errorBound <= 0.01);
+        TVector<double> predicts(FLOAT_FEATURES.size());
+        evaluator->CalcFlat(FLOAT_FEATURES, predicts);
+        for (size_t docId = 0; docId < predicts.size(); ++docId) {
+            UNIT_ASSERT_DOUBLES_EQUAL(expectedPredicts[docId], predicts[docId], errorBound);
+        }
+
+        UNIT_ASSERT_NO_EXCEPTION(evaluator->SetProperty("QuantizedLeafValues", ""));
+        evaluator->CalcFlat(FLOAT_FEATURES, predicts);
+        UNIT_ASSERT_EQUAL(expectedPredicts, predicts);
+    }
+
+    Y_UNIT_TEST(TestPredictionCache) {
+        auto model = SimpleFloatModel(2);
+        TVector<double> expectedPredicts;
+        for (ui32 sampleId = 0; sampleId < 8; ++sampleId) {
+            expectedPredicts.push_back(11.0 * sampleId);
+        }
+        auto evaluator = CreateEvaluator(EFormulaEvaluatorType::CPU, model);
+        UNIT_ASSERT_NO_EXCEPTION(evaluator->SetProperty("PredictionCacheSize", "16"));
+        TVector<double> predicts(FLOAT_FEATURES.size());
+        evaluator->CalcFlat(FLOAT_FEATURES, predicts);
+        UNIT_ASSERT_EQUAL(expectedPredicts, predicts);
+        UNIT_ASSERT_VALUES_EQUAL(*evaluator->GetProperty("PredictionCacheHits"), "0");
+        UNIT_ASSERT_VALUES_EQUAL(*evaluator->GetProperty("PredictionCacheMisses"), "8");
+
+        // same bins for slightly different float values
+        TVector<TVector<float>> data = DATA;
+        data[1][0] = 3.1f;
+        predicts.assign(FLOAT_FEATURES.size(), 0.0);
+        evaluator->CalcFlat(GetFeatureRef(data), predicts);
+        UNIT_ASSERT_EQUAL(expectedPredicts, predicts);
+        UNIT_ASSERT_VALUES_EQUAL(*evaluator->GetProperty("PredictionCacheHits"), "8");
+        UNIT_ASSERT_VALUES_EQUAL(*evaluator->GetProperty("PredictionCacheMisses"), "8");
+        UNIT_ASSERT(!evaluator->GetProperty("UnknownProperty").Defined());
+    }
+
+    Y_UNIT_TEST(TestCalcWithEarlyExit) {
+        auto model = SimpleFloatModel(2);
+        auto evaluator = CreateEvaluator(EFormulaEvaluatorType::CPU, model);
+        for (double threshold : {-1.0, 40.0, 77.0, 100.0}) {
+            TVector<double> predicts(FLOAT_FEATURES.size());
+            evaluator->CalcWithEarlyExit(FLOAT_FEATURES, {}, threshold, /*treeChunkSize*/ 1, predicts);
+            for (ui32 sampleId = 0; sampleId < 8; ++sampleId) {
+                UNIT_ASSERT_VALUES_EQUAL(predicts[sampleId] > threshold, 11.0 * sampleId > threshold);
+            }
+        }
+        TVector<double> predicts(FLOAT_FEATURES.size());
+        evaluator->CalcWithEarlyExit(FLOAT_FEATURES, {}, 40.0, /*treeChunkSize*/ 2, predicts);
+        for (ui32 sampleId = 0; sampleId < 8; ++sampleId) {
+            UNIT_ASSERT_DOUBLES_EQUAL(predicts[sampleId], 11.0 * sampleId, 1e-9);
+        }
+        UNIT_ASSERT_EXCEPTION(
+            evaluator->CalcWithEarlyExit(FLOAT_FEATURES, {}, 40.0, /*treeChunkSize*/ 0, predicts),
+            TCatBoostException);
+
+        auto multiValModel = MultiValueFloatModel();
+        auto multiValEvaluator = CreateEvaluator(EFormulaEvaluatorType::CPU, multiValModel);
+        UNIT_ASSERT_EXCEPTION(
+            multiValEvaluator->CalcWithEarlyExit(FLOAT_FEATURES, {}, 0.0, 1, predicts),
+            TCatBoostException);
+    }
+
+    Y_UNIT_TEST(TestCalcColumnar) {
+        auto model = SimpleFloatModel(2);
+        TVector<float> rowMajorData;
+        for (const auto& row : DATA) {
+            rowMajorData.insert(rowMajorData.end(), row.begin(), row.end());
+        }
+        // columns over row-major data are strided by feature count
+        TVector<TFeatureColumn<float>> floatColumns(3);
+        for (size_t featureIdx = 0; featureIdx < floatColumns.size(); ++featureIdx) {
+            floatColumns[featureIdx].Data = rowMajorData.data() + featureIdx;
+            floatColumns[featureIdx].Stride = 3;
+        }
+        TVector<double> expectedPredicts;
+        for (ui32 sampleId = 0; sampleId < 8; ++sampleId) {
+            expectedPredicts.push_back(11.0 * sampleId);
+        }
+        TVector<double> predicts(DATA.size());
+        model.CalcColumnar(floatColumns, {}, DATA.size(), predicts);
+        UNIT_ASSERT_EQUAL(expectedPredicts, predicts);
+
+        floatColumns[0].Data = nullptr;
+        UNIT_ASSERT_EXCEPTION(model.CalcColumnar(floatColumns, {}, DATA.size(), predicts), TCatBoostException);
+    }
+
+    Y_UNIT_TEST(TestCalcOnQuantizedFloatFeatures) {
+        auto model = SimpleFloatModel(2);
+        const auto& floatFeatures = model.ModelTrees->GetFloatFeatures();
+        TVector<TVector<size_t>> bins(DATA.size(), TVector<size_t>(floatFeatures.size()));
+        for (size_t docId = 0; docId < DATA.size(); ++docId) {
+            for (const auto& floatFeature : floatFeatures) {
+                const float value = DATA[docId][floatFeature.Position.Index];
+                bins[docId][floatFeature.Position.Index] = CountIf(
+                    floatFeature.Borders,
+                    [value] (float border) { return value > border; });
+            }
+        }
+        TCPUEvaluatorQuantizedData quantizedData;
+        quantizedData.QuantizedData = TMaybeOwningArrayHolder<ui8>::CreateOwning(
+            TVector<ui8>(model.ModelTrees->GetEffectiveBinaryFeaturesBucketsCount() * DATA.size()));
+        AssignFloatFeatureBins(
+            *model.ModelTrees,
+            [&bins] (TFeaturePosition position, size_t docId) -> size_t {
+                return bins[docId][position.Index];
+            },
+            0,
+            DATA.size(),
+            &quantizedData);
+
+        TVector<double> expectedPredicts(DATA.size());
+        model.CalcFlat(GetFeatureRef(DATA), expectedPredicts);
+        TVector<double> predicts(DATA.size());
+        model.GetCurrentEvaluator()->Calc(&quantizedData, 0, model.GetTreeCount(), predicts);
+        UNIT_ASSERT_EQUAL(expectedPredicts, predicts);
+    }
+
+    Y_UNIT_TEST(TestModelEnsembleEvaluator) {
+        auto model1 = TrainFloatCatboostModel();
+        auto model2 = model1.CopyTreeRange(0, model1.GetTreeCount() / 2);
+        model2.SetScaleAndBias({0.5, 0.25});
+        const TVector<TVector<float>> data = {{0.1f, 0.2f, 0.3f}, {0.9f, 0.5f, 0.1f}, {3.f, 1.f, 1.f}};
+        const auto features = GetFeatureRef(data);
+        const TVector<const TFullModel*> models = {&model1, &model2};
+        TModelEnsembleEvaluator ensembleEvaluator(models);
+        UNIT_ASSERT_VALUES_EQUAL(ensembleEvaluator.GetModelCount(), models.size());
+        TVector<TVector<double>> predicts(models.size(), TVector<double>(features.size()));
+        TVector<TArrayRef<double>> predictRefs(predicts.begin(), predicts.end());
+        ensembleEvaluator.CalcFlat(features, predictRefs);
+        for (size_t modelIdx = 0; modelIdx < models.size(); ++modelIdx) {
+            TVector<double> expectedPredicts(features.size());
+            models[modelIdx]->CalcFlat(features, expectedPredicts);
+            for (size_t docId = 0; docId < features.size(); ++docId) {
+                UNIT_ASSERT_DOUBLES_EQUAL(expectedPredicts[docId], predicts[modelIdx][docId], 1e-9);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestCalcFlatParallel) {
+        {
+            auto model = SimpleFloatModel(2);
+            TVector<TConstArrayRef<float>> features;
+            TVector<double> expectedPredicts;
+            for (size_t repeat = 0; repeat < 1000; ++repeat) {
+                for (ui32 sampleId = 0; sampleId < 8; ++sampleId) {
+                    features.push_back(FLOAT_FEATURES[sampleId]);
+                    expectedPredicts.push_back(11.0 * sampleId);
+                }
+            }
+            TVector<double> predicts(features.size());
+            model.CalcFlatParallel(features, 0, model.GetTreeCount(), predicts, 4);
+            UNIT_ASSERT_EQUAL(expectedPredicts, predicts);
+        }
+        {
+            auto model = TrainFloatCatboostModel(/*iterations*/ 300);
+            model.SetScaleAndBias({0.5, 0.25});
+            const TVector<TVector<float>> data = {{0.1f, 0.2f, 0.3f}, {0.9f, 0.5f, 0.1f}};
+            const auto features = GetFeatureRef(data);
+            TVector<double> expectedPredicts(features.size());
+            model.CalcFlat(features, expectedPredicts);
+            TVector<double> predicts(features.size());
+            model.CalcFlatParallel(features, 0, model.GetTreeCount(), predicts, 4);
+            for (size_t docId = 0; docId < predicts.size(); ++docId) {
+                UNIT_ASSERT_DOUBLES_EQUAL(expectedPredicts[docId], predicts[docId], 1e-9);
+            }
+        }
+    }
+
     Y_UNIT_TEST(TestFlatCalcMultiVal) {
         auto model = MultiValueFloatModel();
         TVector<TConstArrayRef<float>> features(FLOAT_FEATURES.begin(), FLOAT_FEATURES.begin() + 4);
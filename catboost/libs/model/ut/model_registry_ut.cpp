@@ -0,0 +1,29 @@
+#include <catboost/libs/model/ut/lib/model_test_helpers.h>
+
+#include <catboost/libs/model/model_registry.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+
+Y_UNIT_TEST_SUITE(TModelRegistry) {
+    Y_UNIT_TEST(TestSetModelKeepsSnapshotsAlive) {
+        TModelRegistry registry;
+        UNIT_ASSERT(!registry.GetModel());
+
+        const TFullModel firstModel = SimpleFloatModel(1);
+        const TFullModel secondModel = SimpleFloatModel(2);
+
+        UNIT_ASSERT(!registry.SetModel(TFullModel(firstModel)));
+        auto firstSnapshot = registry.GetModel();
+        UNIT_ASSERT(firstSnapshot);
+        UNIT_ASSERT_EQUAL(*firstSnapshot, firstModel);
+
+        auto replaced = registry.SetModel(TFullModel(secondModel));
+        UNIT_ASSERT_EQUAL(replaced.Get(), firstSnapshot.Get());
+        replaced.Reset();
+
+        UNIT_ASSERT_EQUAL(*registry.GetModel(), secondModel);
+        UNIT_ASSERT_EQUAL(*firstSnapshot, firstModel);
+        UNIT_ASSERT_EQUAL(firstSnapshot.RefCount(), 1);
+    }
+}
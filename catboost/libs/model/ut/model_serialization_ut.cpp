@@ -2,6 +2,7 @@
 #include <catboost/libs/model/features.h>
 #include <catboost/libs/model/model.h>
 #include <catboost/libs/model/model_build_helper.h>
+#include <catboost/libs/model/static_ctr_provider.h>
 #include <catboost/libs/model/model_export/json_model_helpers.h>
 #include <catboost/libs/model/model_export/model_exporter.h>
 #include <catboost/libs/train_lib/train_model.h>
@@ -12,6 +13,8 @@
 
 #include <library/cpp/testing/unittest/registar.h>
 
+#include <util/stream/file.h>
+
 using namespace std;
 using namespace NCB;
 
@@ -39,6 +42,43 @@ Y_UNIT_TEST_SUITE(TModelSerialization) {
         DoSerializeDeserialize(trainedModel);
     }
 
+    Y_UNIT_TEST(TestInitNonOwning) {
+        TFullModel trainedModel = TrainCatOnlyModel();
+        const TString serializedModel = SerializeModel(trainedModel);
+        TFullModel nonOwningModel;
+        nonOwningModel.InitNonOwning(serializedModel.data(), serializedModel.size());
+        UNIT_ASSERT_EQUAL(trainedModel, nonOwningModel);
+        UNIT_ASSERT(nonOwningModel.HasValidCtrProvider());
+
+        TOFStream("model.bin").Write(serializedModel);
+        TFullModel mmappedModel = ReadModelMmap("model.bin");
+        UNIT_ASSERT_EQUAL(trainedModel, mmappedModel);
+        UNIT_ASSERT_VALUES_EQUAL(SerializeModel(mmappedModel), serializedModel);
+    }
+
+    Y_UNIT_TEST(TestEqualCtrTablesAreShared) {
+        TFullModel trainedModel = TrainCatOnlyModel();
+        const TString serializedModel = SerializeModel(trainedModel);
+        TFullModel firstModel = DeserializeModel(serializedModel);
+        TFullModel secondModel = DeserializeModel(serializedModel);
+        UNIT_ASSERT_EQUAL(trainedModel, secondModel);
+
+        const auto& firstCtrs = dynamic_cast<const TStaticCtrProvider&>(*firstModel.CtrProvider).CtrData.LearnCtrs;
+        const auto& secondCtrs = dynamic_cast<const TStaticCtrProvider&>(*secondModel.CtrProvider).CtrData.LearnCtrs;
+        UNIT_ASSERT(!firstCtrs.empty());
+        UNIT_ASSERT_VALUES_EQUAL(firstCtrs.size(), secondCtrs.size());
+        for (const auto& [ctrBase, table] : firstCtrs) {
+            const auto& secondTable = secondCtrs.at(ctrBase);
+            UNIT_ASSERT_EQUAL(table, secondTable);
+            UNIT_ASSERT_EQUAL(
+                table.GetTypedArrayRefForBlobData<ui8>().data(),
+                secondTable.GetTypedArrayRefForBlobData<ui8>().data());
+            UNIT_ASSERT_EQUAL(
+                table.GetIndexHashViewer().GetBuckets().data(),
+                secondTable.GetIndexHashViewer().GetBuckets().data());
+        }
+    }
+
     Y_UNIT_TEST(TestSerializeDeserializeCoreML) {
         TFullModel trainedModel = TrainFloatCatboostModel();
         TStringStream strStream;
@@ -259,4 +299,22 @@ Y_UNIT_TEST_SUITE(TModelSerialization) {
             ])";
         assert(jsonTreesStr == RemoveWhitespacesAndNewLines(expectedJsonTrees));
     }
+
+    Y_UNIT_TEST(TestStreamingJsonOutputIsTheSameAsJsonTree) {
+        NJson::TJsonWriterConfig config;
+        config.FormatOutput = true;
+        config.FloatNDigits = 9;
+        config.DoubleNDigits = 17;
+        config.SortKeys = true;
+
+        for (const auto& model : {TrainCatOnlyModel(), SimpleAsymmetricModel(), MultiValueFloatModel()}) {
+            OutputModelJson(model, "streaming_model.json", nullptr, nullptr);
+
+            TStringStream expectedJson;
+            const auto jsonTree = ConvertModelToJson(model, nullptr, nullptr);
+            NJson::WriteJson(&expectedJson, &jsonTree, config);
+
+            UNIT_ASSERT_VALUES_EQUAL(TIFStream("streaming_model.json").ReadAll(), expectedJson.Str());
+        }
+    }
 }
@@ -1,8 +1,11 @@
 #include "c_api.h"
 
 #include <catboost/libs/cat_feature/cat_feature.h>
+#include <catboost/libs/model/cpu/quantization.h>
 #include <catboost/libs/model/model.h>
+#include <catboost/libs/model/model_registry.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/singleton.h>
 #include <util/stream/file.h>
 #include <util/string/builder.h>
@@ -14,6 +17,52 @@ struct TErrorMessageHolder {
     TString Message;
 };
 
+struct TPredictionContext {
+    TPredictionContext(const TFullModel& model, size_t maxBatchSize)
+        : Evaluator(model.GetCurrentEvaluator())
+        , MaxBatchSize(maxBatchSize)
+        , CatFeaturesCount(model.GetNumCatFeatures())
+        , FloatFeaturesViews(maxBatchSize)
+        , CatFeaturesViews(maxBatchSize)
+        , HashedCatFeatures(maxBatchSize * CatFeaturesCount)
+    {
+    }
+
+    NCB::NModelEvaluation::TConstModelEvaluatorPtr Evaluator;
+    size_t MaxBatchSize = 0;
+    size_t CatFeaturesCount = 0;
+    TVector<TConstArrayRef<float>> FloatFeaturesViews;
+    TVector<TConstArrayRef<int>> CatFeaturesViews;
+    TVector<int> HashedCatFeatures;
+};
+
+//! Positions of categorical features used in model among first catFeaturesSize values
+static TVector<size_t> GetUsedCatFeaturePositions(const TFullModel& model, size_t catFeaturesSize) {
+    TVector<size_t> positions;
+    for (const auto& catFeature : model.ModelTrees->GetCatFeatures()) {
+        const size_t position = catFeature.Position.Index;
+        if (catFeature.UsedInModel() && position < catFeaturesSize) {
+            positions.push_back(position);
+        }
+    }
+    return positions;
+}
+
+//! Hash only values the model uses, hashes of the other values are left as is
+static void HashCatFeatures(
+    const char* const* catFeatures,
+    TConstArrayRef<size_t> usedCatFeatures,
+    int* hashes
+) {
+    for (size_t position : usedCatFeatures) {
+        hashes[position] = CalcCatFeatureHashInt(catFeatures[position]);
+    }
+}
+
+#define PREDICTION_CONTEXT_PTR(x) ((TPredictionContext*)(x))
+#define MODEL_REGISTRY_PTR(x) ((TModelRegistry*)(x))
+#define MODEL_SNAPSHOT_PTR(x) ((TModelRegistry::TModelPtr*)(x))
+
 extern "C" {
 CATBOOST_API ModelCalcerHandle* ModelCalcerCreate() {
     try {
@@ -94,15 +143,20 @@ CATBOOST_API bool CalcModelPrediction(
         const char*** catFeatures, size_t catFeaturesSize,
         double* result, size_t resultSize) {
     try {
+        const TFullModel& model = *FULL_MODEL_PTR(modelHandle);
+        const TVector<size_t> usedCatFeatures = GetUsedCatFeaturePositions(model, catFeaturesSize);
         TVector<TConstArrayRef<float>> floatFeaturesVec(docCount);
-        TVector<TVector<TStringBuf>> catFeaturesVec(docCount, TVector<TStringBuf>(catFeaturesSize));
+        TVector<int> hashedCatFeatures(docCount * catFeaturesSize);
+        TVector<TConstArrayRef<int>> catFeaturesVec(catFeaturesSize > 0 ? docCount : 0);
         for (size_t i = 0; i < docCount; ++i) {
             floatFeaturesVec[i] = TConstArrayRef<float>(floatFeatures[i], floatFeaturesSize);
-            for (size_t catFeatureIdx = 0; catFeatureIdx < catFeaturesSize; ++catFeatureIdx) {
-                catFeaturesVec[i][catFeatureIdx] = catFeatures[i][catFeatureIdx];
+            if (catFeaturesSize > 0) {
+                int* docHashes = hashedCatFeatures.data() + i * catFeaturesSize;
+                HashCatFeatures(catFeatures[i], usedCatFeatures, docHashes);
+                catFeaturesVec[i] = TConstArrayRef<int>(docHashes, catFeaturesSize);
             }
         }
-        FULL_MODEL_PTR(modelHandle)->Calc(floatFeaturesVec, catFeaturesVec, TArrayRef<double>(result, resultSize));
+        model.Calc(floatFeaturesVec, catFeaturesVec, TArrayRef<double>(result, resultSize));
     } catch (...) {
         Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
@@ -144,13 +198,13 @@ CATBOOST_API bool CalcModelPredictionSingle(
         const char** catFeatures, size_t catFeaturesSize,
         double* result, size_t resultSize) {
     try {
-        TVector<TConstArrayRef<float>> floatFeaturesVec(1);
-        TVector<TVector<TStringBuf>> catFeaturesVec(1, TVector<TStringBuf>(catFeaturesSize));
-        floatFeaturesVec[0] = TConstArrayRef<float>(floatFeatures, floatFeaturesSize);
-        for (size_t catFeatureIdx = 0; catFeatureIdx < catFeaturesSize; ++catFeatureIdx) {
-            catFeaturesVec[0][catFeatureIdx] = catFeatures[catFeatureIdx];
-        }
-        FULL_MODEL_PTR(modelHandle)->Calc(floatFeaturesVec, catFeaturesVec, TArrayRef<double>(result, resultSize));
+        const TFullModel& model = *FULL_MODEL_PTR(modelHandle);
+        TVector<int> hashedCatFeatures(catFeaturesSize);
+        HashCatFeatures(catFeatures, GetUsedCatFeaturePositions(model, catFeaturesSize), hashedCatFeatures.data());
+        model.Calc(
+            TConstArrayRef<float>(floatFeatures, floatFeaturesSize),
+            hashedCatFeatures,
+            TArrayRef<double>(result, resultSize));
     } catch (...) {
         Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
@@ -177,6 +231,240 @@ CATBOOST_API bool CalcModelPredictionWithHashedCatFeatures(ModelCalcerHandle* mo
     return true;
 }
 
+template <typename T>
+static TVector<NCB::NModelEvaluation::TFeatureColumn<T>> MakeFeatureColumns(
+    const T** columns,
+    const size_t* strides,
+    size_t featuresSize
+) {
+    TVector<NCB::NModelEvaluation::TFeatureColumn<T>> result(featuresSize);
+    for (size_t featureIdx = 0; featureIdx < featuresSize; ++featureIdx) {
+        result[featureIdx].Data = columns[featureIdx];
+        result[featureIdx].Stride = strides ? strides[featureIdx] : 1;
+    }
+    return result;
+}
+
+CATBOOST_API bool CalcModelPredictionColumnar(
+        ModelCalcerHandle* modelHandle,
+        size_t docCount,
+        const float** floatColumns, const size_t* floatColumnStrides, size_t floatFeaturesSize,
+        const int** catColumns, const size_t* catColumnStrides, size_t catFeaturesSize,
+        double* result, size_t resultSize) {
+    try {
+        FULL_MODEL_PTR(modelHandle)->CalcColumnar(
+            MakeFeatureColumns(floatColumns, floatColumnStrides, floatFeaturesSize),
+            MakeFeatureColumns(catColumns, catColumnStrides, catFeaturesSize),
+            docCount,
+            TArrayRef<double>(result, resultSize)
+        );
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
+template <typename T>
+static TVector<NCB::NModelEvaluation::TFeatureColumn<T>> MakeRowMajorFeatureColumns(
+    const T* features,
+    size_t rowStride,
+    size_t featuresSize
+) {
+    TVector<NCB::NModelEvaluation::TFeatureColumn<T>> result(featuresSize);
+    for (size_t featureIdx = 0; featureIdx < featuresSize; ++featureIdx) {
+        result[featureIdx].Data = features + featureIdx;
+        result[featureIdx].Stride = rowStride;
+    }
+    return result;
+}
+
+CATBOOST_API bool CalcModelPredictionRowMajor(
+        ModelCalcerHandle* modelHandle,
+        size_t docCount,
+        const float* floatFeatures, size_t floatFeaturesStride, size_t floatFeaturesSize,
+        const int* catFeatures, size_t catFeaturesStride, size_t catFeaturesSize,
+        double* result, size_t resultSize) {
+    try {
+        CB_ENSURE(floatFeaturesSize <= floatFeaturesStride, "float features row stride is less than float feature count");
+        CB_ENSURE(catFeaturesSize <= catFeaturesStride, "categorical features row stride is less than categorical feature count");
+        // row-major matrices are columns with row stride, so no per-object arrays are created
+        FULL_MODEL_PTR(modelHandle)->CalcColumnar(
+            MakeRowMajorFeatureColumns(floatFeatures, floatFeaturesStride, floatFeaturesSize),
+            MakeRowMajorFeatureColumns(catFeatures, catFeaturesStride, catFeaturesSize),
+            docCount,
+            TArrayRef<double>(result, resultSize)
+        );
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
+CATBOOST_API bool CalcModelPredictionQuantized(
+        ModelCalcerHandle* modelHandle,
+        size_t docCount,
+        const unsigned short** floatBins, size_t floatFeaturesSize,
+        double* result, size_t resultSize) {
+    try {
+        const TFullModel& model = *FULL_MODEL_PTR(modelHandle);
+        CB_ENSURE(
+            model.GetEvaluatorType() == EFormulaEvaluatorType::CPU,
+            "Quantized input is supported only for CPU evaluation"
+        );
+        CB_ENSURE(
+            floatFeaturesSize >= model.ModelTrees->GetMinimalSufficientFloatFeaturesVectorSize(),
+            "Float feature count " << floatFeaturesSize << " is less than model needs: "
+            << model.ModelTrees->GetMinimalSufficientFloatFeaturesVectorSize()
+        );
+        CB_ENSURE(
+            resultSize == docCount * model.GetDimensionsCount(),
+            "Result size should be equal to " << docCount * model.GetDimensionsCount()
+        );
+        if (docCount == 0) {
+            return true;
+        }
+        NCB::NModelEvaluation::TCPUEvaluatorQuantizedData quantizedData;
+        quantizedData.QuantizedData = NCB::TMaybeOwningArrayHolder<ui8>::CreateOwning(
+            TVector<ui8>(model.ModelTrees->GetEffectiveBinaryFeaturesBucketsCount() * docCount));
+        NCB::NModelEvaluation::AssignFloatFeatureBins(
+            *model.ModelTrees,
+            [floatBins] (TFeaturePosition position, size_t docId) -> size_t {
+                return floatBins[docId][position.Index];
+            },
+            0,
+            docCount,
+            &quantizedData
+        );
+        model.GetCurrentEvaluator()->Calc(
+            &quantizedData,
+            0,
+            model.GetTreeCount(),
+            TArrayRef<double>(result, resultSize)
+        );
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
+CATBOOST_API PredictionContextHandle* ModelCalcerCreatePredictionContext(
+        ModelCalcerHandle* modelHandle,
+        size_t maxBatchSize) {
+    try {
+        return new TPredictionContext(*FULL_MODEL_PTR(modelHandle), maxBatchSize);
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+    }
+    return nullptr;
+}
+
+CATBOOST_API void ModelCalcerDeletePredictionContext(PredictionContextHandle* contextHandle) {
+    if (contextHandle != nullptr) {
+        delete PREDICTION_CONTEXT_PTR(contextHandle);
+    }
+}
+
+CATBOOST_API bool CalcModelPredictionWithContext(
+        PredictionContextHandle* contextHandle,
+        size_t docCount,
+        const float** floatFeatures, size_t floatFeaturesSize,
+        const char*** catFeatures, size_t catFeaturesSize,
+        double* result, size_t resultSize) {
+    try {
+        TPredictionContext& context = *PREDICTION_CONTEXT_PTR(contextHandle);
+        CB_ENSURE(
+            docCount <= context.MaxBatchSize,
+            "Object count " << docCount << " exceeds prediction context batch size " << context.MaxBatchSize
+        );
+        CB_ENSURE(
+            catFeaturesSize <= context.CatFeaturesCount,
+            "Categorical feature count " << catFeaturesSize << " exceeds model categorical feature count "
+            << context.CatFeaturesCount
+        );
+        for (size_t i = 0; i < docCount; ++i) {
+            context.FloatFeaturesViews[i] = TConstArrayRef<float>(floatFeatures[i], floatFeaturesSize);
+            int* docHashes = context.HashedCatFeatures.data() + i * context.CatFeaturesCount;
+            for (size_t catFeatureIdx = 0; catFeatureIdx < catFeaturesSize; ++catFeatureIdx) {
+                docHashes[catFeatureIdx] = CalcCatFeatureHash(catFeatures[i][catFeatureIdx]);
+            }
+            context.CatFeaturesViews[i] = TConstArrayRef<int>(docHashes, catFeaturesSize);
+        }
+        context.Evaluator->Calc(
+            TConstArrayRef<TConstArrayRef<float>>(context.FloatFeaturesViews.data(), docCount),
+            TConstArrayRef<TConstArrayRef<int>>(context.CatFeaturesViews.data(), catFeaturesSize > 0 ? docCount : 0),
+            0,
+            context.Evaluator->GetTreeCount(),
+            TArrayRef<double>(result, resultSize)
+        );
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
+CATBOOST_API ModelRegistryHandle* ModelRegistryCreate() {
+    try {
+        return new TModelRegistry;
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+    }
+    return nullptr;
+}
+
+CATBOOST_API void ModelRegistryDelete(ModelRegistryHandle* registryHandle) {
+    if (registryHandle != nullptr) {
+        delete MODEL_REGISTRY_PTR(registryHandle);
+    }
+}
+
+CATBOOST_API bool ModelRegistryLoadModelFromFile(ModelRegistryHandle* registryHandle, const char* filename) {
+    try {
+        MODEL_REGISTRY_PTR(registryHandle)->SetModel(ReadModel(filename));
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
+CATBOOST_API bool ModelRegistryLoadModelFromBuffer(
+        ModelRegistryHandle* registryHandle,
+        const void* binaryBuffer,
+        size_t binaryBufferSize) {
+    try {
+        MODEL_REGISTRY_PTR(registryHandle)->SetModel(ReadModel(binaryBuffer, binaryBufferSize));
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
+CATBOOST_API ModelSnapshotHandle* ModelRegistryAcquireModel(ModelRegistryHandle* registryHandle) {
+    try {
+        auto model = MODEL_REGISTRY_PTR(registryHandle)->GetModel();
+        CB_ENSURE(model, "Model registry has no model");
+        return new TModelRegistry::TModelPtr(std::move(model));
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+    }
+    return nullptr;
+}
+
+CATBOOST_API void ModelRegistryReleaseModel(ModelSnapshotHandle* snapshotHandle) {
+    if (snapshotHandle != nullptr) {
+        delete MODEL_SNAPSHOT_PTR(snapshotHandle);
+    }
+}
+
+CATBOOST_API ModelCalcerHandle* ModelSnapshotGetCalcer(ModelSnapshotHandle* snapshotHandle) {
+    return const_cast<TFullModel*>(MODEL_SNAPSHOT_PTR(snapshotHandle)->Get());
+}
+
 CATBOOST_API int GetStringCatFeatureHash(const char* data, size_t size) {
     return CalcCatFeatureHash(TStringBuf(data, size));
 }
@@ -195,6 +483,38 @@ CATBOOST_API size_t GetCatFeaturesCount(ModelCalcerHandle* modelHandle) {
     return FULL_MODEL_PTR(modelHandle)->GetNumCatFeatures();
 }
 
+static const TFloatFeature* FindFloatFeature(const TFullModel& model, size_t floatFeatureIdx) {
+    for (const auto& floatFeature : model.ModelTrees->GetFloatFeatures()) {
+        if (static_cast<size_t>(floatFeature.Position.Index) == floatFeatureIdx) {
+            return &floatFeature;
+        }
+    }
+    return nullptr;
+}
+
+CATBOOST_API size_t GetFloatFeatureBordersCount(ModelCalcerHandle* modelHandle, size_t floatFeatureIdx) {
+    const TFloatFeature* floatFeature = FindFloatFeature(*FULL_MODEL_PTR(modelHandle), floatFeatureIdx);
+    return floatFeature ? floatFeature->Borders.size() : 0;
+}
+
+CATBOOST_API bool GetFloatFeatureBorders(
+        ModelCalcerHandle* modelHandle,
+        size_t floatFeatureIdx,
+        float* borders, size_t bordersSize) {
+    try {
+        const TFloatFeature* floatFeature = FindFloatFeature(*FULL_MODEL_PTR(modelHandle), floatFeatureIdx);
+        const size_t bordersCount = floatFeature ? floatFeature->Borders.size() : 0;
+        CB_ENSURE(bordersSize == bordersCount, "Borders size should be equal to " << bordersCount);
+        if (bordersCount > 0) {
+            Copy(floatFeature->Borders.begin(), floatFeature->Borders.end(), borders);
+        }
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
 CATBOOST_API size_t GetTreeCount(ModelCalcerHandle* modelHandle) {
     return FULL_MODEL_PTR(modelHandle)->GetTreeCount();
 }
@@ -171,6 +171,179 @@ CATBOOST_API bool CalcModelPredictionWithHashedCatFeatures(
     const int** catFeatures, size_t catFeaturesSize,
     double* result, size_t resultSize);
 
+/**
+ * Calculate raw model predictions on columnar float features and hashed categorical feature values
+ * without transposing them to per object arrays
+ * @param calcer model handle
+ * @param docCount object count
+ * @param floatColumns array of float feature column pointers (first dimension is feature index).
+ * Pointers for features not used by model may be NULL
+ * @param floatColumnStrides array of distances in elements between values of consecutive objects in each
+ * float column, if NULL all float columns are contiguous
+ * @param floatFeaturesSize float feature count
+ * @param catColumns array of hashed categorical feature column pointers (first dimension is feature index).
+ * Pointers for features not used by model may be NULL
+ * @param catColumnStrides array of distances in elements between values of consecutive objects in each
+ * categorical column, if NULL all categorical columns are contiguous
+ * @param catFeaturesSize categorical feature count
+ * @param result pointer to user allocated results vector
+ * @param resultSize result size should be equal to modelApproxDimension * docCount
+ * (e.g. for non multiclass models should be equal to docCount)
+ * @return false if error occured
+ */
+CATBOOST_API bool CalcModelPredictionColumnar(
+    ModelCalcerHandle* modelHandle,
+    size_t docCount,
+    const float** floatColumns, const size_t* floatColumnStrides, size_t floatFeaturesSize,
+    const int** catColumns, const size_t* catColumnStrides, size_t catFeaturesSize,
+    double* result, size_t resultSize);
+
+/**
+ * Calculate raw model predictions on row-major matrices of float features and hashed categorical feature values
+ * stored in single contiguous buffers, no per object pointer arrays are needed
+ * @param calcer model handle
+ * @param docCount object count
+ * @param floatFeatures float features matrix, value of feature j for object i is floatFeatures[i * floatFeaturesStride + j]
+ * @param floatFeaturesStride distance in elements between rows of float features matrix
+ * @param floatFeaturesSize float feature count
+ * @param catFeatures hashed categorical features matrix (see GetStringCatFeatureHash),
+ * value of feature j for object i is catFeatures[i * catFeaturesStride + j], may be NULL if catFeaturesSize is 0
+ * @param catFeaturesStride distance in elements between rows of categorical features matrix
+ * @param catFeaturesSize categorical feature count
+ * @param result pointer to user allocated results vector
+ * @param resultSize result size should be equal to modelApproxDimension * docCount
+ * (e.g. for non multiclass models should be equal to docCount)
+ * @return false if error occured
+ */
+CATBOOST_API bool CalcModelPredictionRowMajor(
+    ModelCalcerHandle* modelHandle,
+    size_t docCount,
+    const float* floatFeatures, size_t floatFeaturesStride, size_t floatFeaturesSize,
+    const int* catFeatures, size_t catFeaturesStride, size_t catFeaturesSize,
+    double* result, size_t resultSize);
+
+/**
+ * Calculate raw model predictions on float features quantized with model borders (see GetFloatFeatureBorders).
+ * Supported only for CPU evaluation of models without categorical and text features.
+ * @param calcer model handle
+ * @param docCount object count
+ * @param floatBins array of array of bins (first dimension is object index, second is feature index),
+ * bin is the count of feature borders less than the feature value
+ * @param floatFeaturesSize float feature count
+ * @param result pointer to user allocated results vector
+ * @param resultSize result size should be equal to modelApproxDimension * docCount
+ * (e.g. for non multiclass models should be equal to docCount)
+ * @return false if error occured
+ */
+CATBOOST_API bool CalcModelPredictionQuantized(
+    ModelCalcerHandle* modelHandle,
+    size_t docCount,
+    const unsigned short** floatBins, size_t floatFeaturesSize,
+    double* result, size_t resultSize);
+
+typedef void PredictionContextHandle;
+
+/**
+ * Create prediction context holding preallocated buffers for batches of up to maxBatchSize objects,
+ * evaluation with context doesn't allocate memory.
+ * Context captures current model evaluator, so it should be created after model is loaded and evaluator
+ * type is chosen (see EnableGPUEvaluation). Context must not be used concurrently from several threads.
+ * @param calcer model handle, should outlive the context
+ * @param maxBatchSize maximum object count for CalcModelPredictionWithContext calls
+ * @return context handle or NULL if error occured
+ */
+CATBOOST_API PredictionContextHandle* ModelCalcerCreatePredictionContext(
+    ModelCalcerHandle* modelHandle,
+    size_t maxBatchSize);
+
+/**
+ * Delete prediction context handle
+ * @param context
+ */
+CATBOOST_API void ModelCalcerDeletePredictionContext(PredictionContextHandle* contextHandle);
+
+/**
+ * Calculate raw model predictions on float features and string categorical feature values using
+ * preallocated context buffers
+ * @param context prediction context handle
+ * @param docCount object count, should not exceed context maxBatchSize
+ * @param floatFeatures array of array of float (first dimension is object index, second is feature index)
+ * @param floatFeaturesSize float feature count
+ * @param catFeatures array of array of char* categorical value pointers.
+ * String pointer should point to zero terminated string.
+ * @param catFeaturesSize categorical feature count
+ * @param result pointer to user allocated results vector
+ * @param resultSize result size should be equal to modelApproxDimension * docCount
+ * (e.g. for non multiclass models should be equal to docCount)
+ * @return false if error occured
+ */
+CATBOOST_API bool CalcModelPredictionWithContext(
+    PredictionContextHandle* contextHandle,
+    size_t docCount,
+    const float** floatFeatures, size_t floatFeaturesSize,
+    const char*** catFeatures, size_t catFeaturesSize,
+    double* result, size_t resultSize);
+
+typedef void ModelRegistryHandle;
+typedef void ModelSnapshotHandle;
+
+/**
+ * Create empty model registry. Registry allows replacing the served model while predictions are running:
+ * a new model is warmed up before it becomes current, and a replaced model is freed after all snapshots
+ * acquired for it are released.
+ * @return registry handle or NULL if error occured
+ */
+CATBOOST_API ModelRegistryHandle* ModelRegistryCreate();
+
+/**
+ * Delete model registry handle. Acquired snapshots stay valid until released.
+ * @param registryHandle
+ */
+CATBOOST_API void ModelRegistryDelete(ModelRegistryHandle* registryHandle);
+
+/**
+ * Load model from file and make it current in registry
+ * @param registryHandle
+ * @param filename
+ * @return false if error occured, current model is not changed in this case
+ */
+CATBOOST_API bool ModelRegistryLoadModelFromFile(ModelRegistryHandle* registryHandle, const char* filename);
+
+/**
+ * Load model from memory buffer and make it current in registry
+ * @param registryHandle
+ * @param binaryBuffer pointer to a memory buffer where model file is mapped
+ * @param binaryBufferSize size of the buffer in bytes
+ * @return false if error occured, current model is not changed in this case
+ */
+CATBOOST_API bool ModelRegistryLoadModelFromBuffer(
+    ModelRegistryHandle* registryHandle,
+    const void* binaryBuffer,
+    size_t binaryBufferSize);
+
+/**
+ * Acquire snapshot of the current registry model. Snapshot keeps the model alive even if it is replaced
+ * in registry, so it should be held for the duration of prediction calls and released afterwards.
+ * @param registryHandle
+ * @return snapshot handle or NULL if error occured or registry has no model
+ */
+CATBOOST_API ModelSnapshotHandle* ModelRegistryAcquireModel(ModelRegistryHandle* registryHandle);
+
+/**
+ * Release model snapshot
+ * @param snapshotHandle
+ */
+CATBOOST_API void ModelRegistryReleaseModel(ModelSnapshotHandle* snapshotHandle);
+
+/**
+ * Get model handle of snapshot for use in CalcModelPrediction* and model info functions.
+ * Model handle is valid until snapshot is released and must not be passed to Load* functions,
+ * EnableGPUEvaluation or ModelCalcerDelete.
+ * @param snapshotHandle
+ * @return model handle
+ */
+CATBOOST_API ModelCalcerHandle* ModelSnapshotGetCalcer(ModelSnapshotHandle* snapshotHandle);
+
 /**
  * Get hash for given string value
  * @param data we don't expect data to be zero terminated, so pass correct size
@@ -200,6 +373,26 @@ CATBOOST_API size_t GetFloatFeaturesCount(ModelCalcerHandle* modelHandle);
  */
 CATBOOST_API size_t GetCatFeaturesCount(ModelCalcerHandle* modelHandle);
 
+/**
+ * Get number of borders of float feature in model, 0 if feature is not used in model
+ * @param calcer model handle
+ * @param floatFeatureIdx float feature index
+ */
+CATBOOST_API size_t GetFloatFeatureBordersCount(ModelCalcerHandle* modelHandle, size_t floatFeatureIdx);
+
+/**
+ * Copy sorted float feature borders used by model, f.e. to quantize features for CalcModelPredictionQuantized
+ * @param calcer model handle
+ * @param floatFeatureIdx float feature index
+ * @param borders pointer to user allocated borders vector
+ * @param bordersSize should be equal to GetFloatFeatureBordersCount result
+ * @return false if error occured
+ */
+CATBOOST_API bool GetFloatFeatureBorders(
+    ModelCalcerHandle* modelHandle,
+    size_t floatFeatureIdx,
+    float* borders, size_t bordersSize);
+
 /**
  * Get number of trees in model
  * @param calcer model handle
@@ -2,6 +2,8 @@
 
 #include <catboost/libs/helpers/set.h>
 
+#include <util/generic/cast.h>
+
 #include <util/generic/xrange.h>
 
 namespace NMonoForest {
@@ -10,6 +12,27 @@ namespace NMonoForest {
         int Sign = 1;
     };
 
+    static void AddMonomStat(
+        const TMonomStructure& structure,
+        const TMonomStat& stat,
+        THashMap<TMonomStructure, TMonomStat>* monomsEnsemble
+    ) {
+        auto& dst = (*monomsEnsemble)[structure];
+        if (dst.Weight < 0) {
+            dst.Weight = stat.Weight;
+        } else {
+            CB_ENSURE(dst.Weight == stat.Weight,
+                      "error: monom weight depends on dataset only: " << stat.Weight << " ≠ "
+                                                                      << dst.Weight);
+        }
+        if (dst.Value.size() < stat.Value.size()) {
+            dst.Value.resize(stat.Value.size());
+        }
+        for (auto k : xrange(stat.Value.size())) {
+            dst.Value[k] += stat.Value[k];
+        }
+    }
+
     static inline TVector<TPathBit> LeafToPolynoms(const int path, int maxDepth) {
         TVector<TPathBit> pathBits = {{}};
         for (int depth = 0; depth < maxDepth; ++depth) {
@@ -104,6 +127,9 @@ namespace NMonoForest {
                     monomWeight += tree.GetWeights()[leaf];
                 }
             }
+            if (monomWeight < MinMonomWeight) {
+                continue;
+            }
 
             auto& dst = monomsEnsemble[monomStructure];
 
@@ -124,20 +150,7 @@ namespace NMonoForest {
         }
 
         for (const auto& [structure, stat] : monomsEnsemble) {
-            auto& dst = MonomsEnsemble[structure];
-            if (dst.Weight < 0) {
-                dst.Weight = stat.Weight;
-            } else {
-                CB_ENSURE(dst.Weight == stat.Weight,
-                          "error: monom weight depends on dataset only: " << stat.Weight << " ≠ "
-                                                                          << dst.Weight);
-            }
-            if (dst.Value.size() < tree.OutputDim()) {
-                dst.Value.resize(tree.OutputDim());
-            }
-            for (ui32 k = 0; k < tree.OutputDim(); ++k) {
-                dst.Value[k] += stat.Value[k];
-            }
+            AddMonomStat(structure, stat, &MonomsEnsemble);
         }
     }
 
@@ -188,10 +201,55 @@ namespace NMonoForest {
         tree.VisitLeavesAndWeights(visitor);
     }
 
+    void TPolynomBuilder::Merge(TPolynomBuilder&& other) {
+        if (MonomsEnsemble.empty()) {
+            MonomsEnsemble = std::move(other.MonomsEnsemble);
+            return;
+        }
+        for (const auto& [structure, stat] : other.MonomsEnsemble) {
+            AddMonomStat(structure, stat, &MonomsEnsemble);
+        }
+        other.MonomsEnsemble.clear();
+    }
+
     TPolynom TPolynomBuilder::Build() {
         return {MonomsEnsemble};
     }
 
+    TPolynom BuildPolynom(
+        const TAdditiveModel<TObliviousTree>& additiveModel,
+        double minMonomWeight,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        const int treeCount = SafeIntegerCast<int>(additiveModel.Size());
+        if (treeCount == 0) {
+            return {};
+        }
+
+        NPar::TLocalExecutor::TExecRangeParams blockParams(0, treeCount);
+        blockParams.SetBlockCount(localExecutor->GetThreadCount() + 1);
+
+        TVector<TPolynomBuilder> blockBuilders(blockParams.GetBlockCount(), TPolynomBuilder(minMonomWeight));
+        localExecutor->ExecRangeWithThrow(
+            [&] (int blockIdx) {
+                NPar::TLocalExecutor::BlockedLoopBody(
+                    blockParams,
+                    [&] (int treeIdx) {
+                        blockBuilders[blockIdx].AddTree(additiveModel.GetWeakModel(treeIdx));
+                    }
+                )(blockIdx);
+            },
+            0,
+            blockParams.GetBlockCount(),
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+
+        // merge in the order of blocks so that the result does not depend on the thread scheduling
+        for (auto blockIdx : xrange<size_t>(1, blockBuilders.size())) {
+            blockBuilders[0].Merge(std::move(blockBuilders[blockIdx]));
+        }
+        return blockBuilders[0].Build();
+    }
+
     static inline void AddMonomToTree(const TMonom& monom, const TObliviousTreeStructure& treeStructure, TArrayRef<double> leafValues) {
         const auto outDim = monom.Stat.Value.size();
         const auto& monomSplits = monom.Structure.Splits;
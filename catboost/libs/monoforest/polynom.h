@@ -4,6 +4,9 @@
 #include "monom.h"
 #include "oblivious_tree.h"
 #include "non_symmetric_tree.h"
+
+#include <library/cpp/threading/local_executor/local_executor.h>
+
 #include <util/generic/hash.h>
 
 namespace NMonoForest {
@@ -20,14 +23,34 @@ namespace NMonoForest {
 
     class TPolynomBuilder {
     public:
+        /* Monoms of oblivious trees with weight (the total weight of leaves where the monom is not zero)
+         * less than minMonomWeight are skipped. Monom weights depend only on the data the model was trained on,
+         * so a monom is skipped for all trees.
+         */
+        explicit TPolynomBuilder(double minMonomWeight = 0)
+            : MinMonomWeight(minMonomWeight)
+        {
+        }
+
         void AddTree(const TObliviousTree& tree);
         void AddTree(const TNonSymmetricTree& tree);
+
+        // adds monoms of the other builder, e.g. built for another part of trees
+        void Merge(TPolynomBuilder&& other);
+
         TPolynom Build();
 
     private:
+        double MinMonomWeight;
         THashMap<TMonomStructure, TMonomStat> MonomsEnsemble;
     };
 
+    // trees are split into blocks that are converted in parallel and then merged
+    TPolynom BuildPolynom(
+        const TAdditiveModel<TObliviousTree>& additiveModel,
+        double minMonomWeight,
+        NPar::TLocalExecutor* localExecutor);
+
     template <typename TWeakModel>
     class IPolynomToAdditiveModelConverter {
     public:
@@ -0,0 +1,210 @@
+/* Benchmarks for CPU training and applying hot paths on reproducible synthetic data.
+ *
+ * Training benchmarks cover CalcStatsAndScores, BuildIndices and UpdateApproxDeltas, and
+ * ComputeOnlineCTRs when categorical features are present.
+ *
+ * Run with '--format json' to get machine-readable results for comparison between releases.
+ */
+
+#include <catboost/libs/data/data_provider.h>
+#include <catboost/libs/data/data_provider_builders.h>
+#include <catboost/libs/data/quantization.h>
+#include <catboost/libs/fstr/shap_values.h>
+#include <catboost/libs/model/model.h>
+#include <catboost/libs/train_lib/train_model.h>
+
+#include <library/cpp/json/json_value.h>
+#include <library/cpp/testing/benchmark/bench.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/string/cast.h>
+
+using namespace NCB;
+
+
+static const ui32 ObjectCount = 100000;
+static const ui32 FloatFeatureCount = 20;
+static const ui32 CatFeatureCount = 4;
+static const ui32 CatFeatureUniqueValuesCount = 1000;
+static const ui32 ThreadCount = 8;
+static const int Seed = 42;
+
+
+static TDataProviderPtr GenerateDataset(ui32 objectCount, ui32 floatFeatureCount, ui32 catFeatureCount) {
+    TFastRng64 rng(Seed);
+
+    return CreateDataProvider(
+        [&] (IRawFeaturesOrderDataVisitor* visitor) {
+            TVector<ui32> catFeatureIndices;
+            for (auto i : xrange(catFeatureCount)) {
+                catFeatureIndices.push_back(floatFeatureCount + i);
+            }
+
+            TDataMetaInfo metaInfo;
+            metaInfo.TargetType = ERawTargetType::Float;
+            metaInfo.TargetCount = 1;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                floatFeatureCount + catFeatureCount,
+                catFeatureIndices,
+                TVector<ui32>{},
+                TVector<TString>{});
+
+            visitor->Start(metaInfo, objectCount, EObjectsOrder::Undefined, {});
+
+            TVector<float> target(objectCount, 0.0f);
+            for (auto featureIdx : xrange(floatFeatureCount)) {
+                TVector<float> values(objectCount);
+                for (auto objectIdx : xrange(objectCount)) {
+                    values[objectIdx] = rng.GenRandReal1();
+                    target[objectIdx] += values[objectIdx] * (featureIdx % 3);
+                }
+                visitor->AddFloatFeature(
+                    featureIdx,
+                    MakeIntrusive<TTypeCastArrayHolder<float, float>>(std::move(values))
+                );
+            }
+            for (auto catFeatureIdx : catFeatureIndices) {
+                TVector<TString> values(objectCount);
+                for (auto objectIdx : xrange(objectCount)) {
+                    const ui32 value = rng.Uniform(CatFeatureUniqueValuesCount);
+                    values[objectIdx] = ToString(value);
+                    target[objectIdx] += (value % 7) * 0.1f;
+                }
+                visitor->AddCatFeature(catFeatureIdx, TConstArrayRef<TString>(values));
+            }
+            for (auto& value : target) {
+                value += rng.GenRandReal1();
+            }
+            visitor->AddTarget(MakeIntrusive<TTypeCastArrayHolder<float, float>>(std::move(target)));
+
+            visitor->Finish();
+        }
+    );
+}
+
+static const TDataProviderPtr& GetFloatFeaturesDataset() {
+    static const TDataProviderPtr dataset = GenerateDataset(ObjectCount, FloatFeatureCount, 0);
+    return dataset;
+}
+
+static const TDataProviderPtr& GetCatFeaturesDataset() {
+    static const TDataProviderPtr dataset = GenerateDataset(ObjectCount, FloatFeatureCount, CatFeatureCount);
+    return dataset;
+}
+
+static NJson::TJsonValue GetTrainParams(int iterations) {
+    NJson::TJsonValue params;
+    params.InsertValue("iterations", iterations);
+    params.InsertValue("depth", 6);
+    params.InsertValue("random_seed", Seed);
+    params.InsertValue("thread_count", ThreadCount);
+    params.InsertValue("allow_writing_files", false);
+    params.InsertValue("logging_level", "Silent");
+    return params;
+}
+
+static TFullModel Train(TDataProviderPtr dataset, int iterations) {
+    TDataProviders dataProviders;
+    dataProviders.Learn = dataset;
+
+    TFullModel model;
+    TrainModel(
+        GetTrainParams(iterations),
+        /*quantizedFeaturesInfo*/ nullptr,
+        /*objectiveDescriptor*/ Nothing(),
+        /*evalMetricDescriptor*/ Nothing(),
+        std::move(dataProviders),
+        /*initModel*/ Nothing(),
+        /*initLearnProgress*/ nullptr,
+        /*outputModelPath*/ "",
+        &model,
+        /*evalResultPtrs*/ {}
+    );
+    return model;
+}
+
+static const TFullModel& GetFloatFeaturesModel() {
+    static const TFullModel model = Train(GetFloatFeaturesDataset(), 200);
+    return model;
+}
+
+static const TVector<TVector<float>>& GetFloatFeaturesRows() {
+    static const TVector<TVector<float>> rows = [] () {
+        TFastRng64 rng(Seed);
+        TVector<TVector<float>> rows(ObjectCount, TVector<float>(FloatFeatureCount));
+        for (auto& row : rows) {
+            for (auto& value : row) {
+                value = rng.GenRandReal1();
+            }
+        }
+        return rows;
+    }();
+    return rows;
+}
+
+
+Y_CPU_BENCHMARK(TrainFloatFeatures, iface) {
+    const auto& dataset = GetFloatFeaturesDataset();
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        auto model = Train(dataset, 20);
+        Y_DO_NOT_OPTIMIZE_AWAY(model);
+    }
+}
+
+Y_CPU_BENCHMARK(TrainCatFeatures, iface) {
+    const auto& dataset = GetCatFeaturesDataset();
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        auto model = Train(dataset, 20);
+        Y_DO_NOT_OPTIMIZE_AWAY(model);
+    }
+}
+
+Y_CPU_BENCHMARK(QuantizeFloatFeatures, iface) {
+    const auto& dataset = GetFloatFeaturesDataset();
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        auto quantizedObjectsData = ConstructQuantizedPoolFromRawPool(
+            dataset,
+            GetTrainParams(/*iterations*/ 1),
+            /*quantizedFeaturesInfo*/ nullptr
+        );
+        Y_DO_NOT_OPTIMIZE_AWAY(quantizedObjectsData);
+    }
+}
+
+Y_CPU_BENCHMARK(ModelCalcFloatFeatures, iface) {
+    const auto& model = GetFloatFeaturesModel();
+    const auto& rows = GetFloatFeaturesRows();
+    TVector<TConstArrayRef<float>> floatFeatures(rows.begin(), rows.end());
+    TVector<double> results(rows.size());
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        model.Calc(floatFeatures, {}, results);
+        Y_DO_NOT_OPTIMIZE_AWAY(results);
+    }
+}
+
+Y_CPU_BENCHMARK(ShapValuesFloatFeatures, iface) {
+    const auto& model = GetFloatFeaturesModel();
+    const auto& dataset = GetFloatFeaturesDataset();
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(ThreadCount - 1);
+    TVector<double> shapValues(
+        (size_t)dataset->GetObjectCount() * model.GetDimensionsCount() * (FloatFeatureCount + 1)
+    );
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        CalcShapValuesMulti(
+            model,
+            *dataset,
+            /*referenceDataset*/ nullptr,
+            /*fixedFeatureParams*/ Nothing(),
+            /*logPeriod*/ 0,
+            EPreCalcShapValues::Auto,
+            &localExecutor,
+            shapValues
+        );
+        Y_DO_NOT_OPTIMIZE_AWAY(shapValues);
+    }
+}
@@ -707,7 +707,9 @@ void CrossValidate(
          */
         TMaybe<ui32> batchEndIteration;
 
-        for (auto foldIdx : xrange(foldContexts.size())) {
+        TVector<double> foldBatchTimes(foldContexts.size()); // [foldIdx]
+
+        const auto trainFoldBatch = [&] (ui32 foldIdx) {
             THPTimer timer;
 
             TrainBatch(
@@ -727,10 +729,37 @@ void CrossValidate(
                 localExecutor,
                 &batchEndIteration);
 
-            Y_ASSERT(batchEndIteration); // should be inited right after the first iteration of the first fold
+            foldBatchTimes[foldIdx] = timer.Passed();
+        };
+
+        // the first fold defines the batch iterations upper bound, so it is always trained alone
+        trainFoldBatch(0);
+        Y_ASSERT(batchEndIteration); // should be inited right after the first iteration of the first fold
+
+        if (taskType == ETaskType::CPU) {
+            /* Small trees do not saturate all threads, so train the rest of the folds concurrently.
+             * Fold tasks and their inner parallel loops share localExecutor, so threads that have finished
+             * their fold pick up work from the others.
+             * Logging level is set here once so that concurrent TSetLogging scopes inside folds training
+             * don't change it.
+             */
+            TSetLoggingSilent silentMode;
+
+            TVector<std::function<void()>> tasks;
+            for (auto foldIdx : xrange<ui32>(1, foldContexts.size())) {
+                tasks.emplace_back([&, foldIdx] () { trainFoldBatch(foldIdx); });
+            }
+            ExecuteTasksInParallel(&tasks, localExecutor);
+        } else {
+            for (auto foldIdx : xrange<ui32>(1, foldContexts.size())) {
+                trainFoldBatch(foldIdx);
+            }
+        }
+
+        for (auto foldIdx : xrange(foldContexts.size())) {
             CATBOOST_INFO_LOG << "CrossValidation: Processed batch of iterations [" << batchStartIteration
                 << ',' << *batchEndIteration << ") for fold " << foldIdx << '/' << cvParams.FoldCount
-                << " in " << FloatToString(timer.Passed(), PREC_NDIGITS, 2) << " sec" << Endl;
+                << " in " << FloatToString(foldBatchTimes[foldIdx], PREC_NDIGITS, 2) << " sec" << Endl;
         }
 
         while (true) {
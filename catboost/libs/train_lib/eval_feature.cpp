@@ -32,6 +32,8 @@
 
 #include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
+#include <util/generic/map.h>
+#include <util/generic/mapfindptr.h>
 #include <util/generic/scope.h>
 #include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
@@ -555,11 +557,11 @@ TTrainingDataProviders MakeFeatureSubsetTrainingData(
 }
 
 
-static TVector<TTrainingDataProviders> UpdateIgnoredFeaturesInLearn(
+// sorted, so trainings on the same features can be detected by comparison
+static TVector<ui32> GetAdditionalIgnoredFeatures(
     const NCatboostOptions::TFeatureEvalOptions& options,
     ETrainingKind trainingKind,
-    ui32 testedFeatureSetIdx,
-    const TVector<TTrainingDataProviders>& foldsData
+    ui32 testedFeatureSetIdx
 ) {
     TVector<ui32> ignoredFeatures;
     const auto& testedFeatures = options.FeaturesToEvaluate.Get();
@@ -601,14 +603,21 @@ static TVector<TTrainingDataProviders> UpdateIgnoredFeaturesInLearn(
     } else {
         logMessage << ", testing";
     }
+    std::sort(ignoredFeatures.begin(), ignoredFeatures.end());
     if (ignoredFeatures.empty()) {
         logMessage << ", no additional ignored features";
     } else {
-        std::sort(ignoredFeatures.begin(), ignoredFeatures.end());
         logMessage << ", additional ignored features " << JoinRange(":", ignoredFeatures.begin(), ignoredFeatures.end());
     }
     CATBOOST_INFO_LOG << logMessage << Endl;
+    return ignoredFeatures;
+}
 
+
+static TVector<TTrainingDataProviders> UpdateIgnoredFeaturesInLearn(
+    const TVector<ui32>& ignoredFeatures,
+    const TVector<TTrainingDataProviders>& foldsData
+) {
     TVector<TTrainingDataProviders> result;
     result.reserve(foldsData.size());
 
@@ -1034,31 +1043,79 @@ static void EvaluateFeaturesImpl(
             callbacks->GetAbsoluteOffset());
         return;
     }
+    /* Same additional ignored features mean the same training data for all folds (e.g. testing model
+     * for one feature set and baseline for another one in OneVsOthers mode with two feature sets),
+     * so fold models are trained only once for them.
+     */
+    TMap<TVector<ui32>, std::pair<bool, ui32>> trainedFeatureSubsets; // ignored features -> (isTest, featureSetIdx)
+    const auto reuseFullModels = [&] (
+        bool isTest,
+        ui32 featureSetIdx,
+        std::pair<bool, ui32> trained) {
+
+        const auto [trainedIsTest, trainedFeatureSetIdx] = trained;
+        CATBOOST_NOTICE_LOG << "Reusing models of feature set " << trainedFeatureSetIdx
+            << (trainedIsTest ? ", testing" : ", baseline") << Endl;
+        const auto& trainedMetricsHistory = results->MetricsHistory[trainedIsTest][trainedFeatureSetIdx];
+        const auto& trainedFeatureStrengths = results->FeatureStrengths[trainedIsTest][trainedFeatureSetIdx];
+        const auto& trainedRegularFeatureStrengths = results->RegularFeatureStrengths[trainedIsTest][trainedFeatureSetIdx];
+        CB_ENSURE_INTERNAL(trainedMetricsHistory.size() >= foldCount, "No models to reuse");
+        for (auto foldIdx : xrange(foldCount)) {
+            ++trainingIdx;
+            if (callbacks->HaveEvalFeatureSummary(foldRangeBegin, featureSetIdx, isTest, offsetInRange + foldIdx)) {
+                continue;
+            }
+            // models for the current fold range are the last ones
+            const size_t trainedIdx = trainedMetricsHistory.size() - foldCount + foldIdx;
+            const auto metricsHistory = trainedMetricsHistory[trainedIdx];
+            results->MetricsHistory[isTest][featureSetIdx].emplace_back(metricsHistory);
+            results->AppendFeatureSetMetrics(isTest, featureSetIdx, metricsHistory);
+            if (trainedFeatureStrengths.size() == trainedMetricsHistory.size()) {
+                const auto featureStrengths = trainedFeatureStrengths[trainedIdx];
+                results->FeatureStrengths[isTest][featureSetIdx].emplace_back(featureStrengths);
+            }
+            if (trainedRegularFeatureStrengths.size() == trainedMetricsHistory.size()) {
+                const auto regularFeatureStrengths = trainedRegularFeatureStrengths[trainedIdx];
+                results->RegularFeatureStrengths[isTest][featureSetIdx].emplace_back(regularFeatureStrengths);
+            }
+        }
+    };
+
     const auto useCommonBaseline = featureEvalOptions.FeatureEvalMode != NCB::EFeatureEvalMode::OneVsOthers;
     for (ui32 featureSetIdx : xrange(featureEvalOptions.FeaturesToEvaluate->size())) {
         const auto haveBaseline = featureSetIdx > 0 && useCommonBaseline;
         if (!haveBaseline) {
-            auto newFoldsData = UpdateIgnoredFeaturesInLearn(
+            auto ignoredFeatures = GetAdditionalIgnoredFeatures(
                 featureEvalOptions,
                 ETrainingKind::Baseline,
-                featureSetIdx,
-                foldsData);
-            CB_ENSURE(
-                HaveFeaturesToEvaluate(newFoldsData),
-                "All features in baseline for feature set " << featureSetIdx << " are ignored or constant");
-            trainFullModels(/*isTest*/false, featureSetIdx, &newFoldsData);
+                featureSetIdx);
+            if (const auto trained = MapFindPtr(trainedFeatureSubsets, ignoredFeatures)) {
+                reuseFullModels(/*isTest*/false, featureSetIdx, *trained);
+            } else {
+                auto newFoldsData = UpdateIgnoredFeaturesInLearn(ignoredFeatures, foldsData);
+                CB_ENSURE(
+                    HaveFeaturesToEvaluate(newFoldsData),
+                    "All features in baseline for feature set " << featureSetIdx << " are ignored or constant");
+                trainFullModels(/*isTest*/false, featureSetIdx, &newFoldsData);
+                trainedFeatureSubsets.emplace(std::move(ignoredFeatures), std::make_pair(false, featureSetIdx));
+            }
         } else {
             results->BestMetrics[/*isTest*/0][featureSetIdx] = results->BestMetrics[/*isTest*/0][0];
             results->BestBaselineIterations[featureSetIdx] = results->BestBaselineIterations[0];
         }
 
-        auto newFoldsData = UpdateIgnoredFeaturesInLearn(
+        auto ignoredFeatures = GetAdditionalIgnoredFeatures(
             featureEvalOptions,
             ETrainingKind::Testing,
-            featureSetIdx,
-            foldsData);
+            featureSetIdx);
+        if (const auto trained = MapFindPtr(trainedFeatureSubsets, ignoredFeatures)) {
+            reuseFullModels(/*isTest*/true, featureSetIdx, *trained);
+            continue;
+        }
+        auto newFoldsData = UpdateIgnoredFeaturesInLearn(ignoredFeatures, foldsData);
         if (HaveFeaturesToEvaluate(newFoldsData)) {
             trainFullModels(/*isTest*/true, featureSetIdx, &newFoldsData);
+            trainedFeatureSubsets.emplace(std::move(ignoredFeatures), std::make_pair(true, featureSetIdx));
         } else {
             CATBOOST_WARNING_LOG << "Feature set " << featureSetIdx
                 << " consists of ignored or constant features; eval feature assumes baseline data = testing data for this feature set" << Endl;
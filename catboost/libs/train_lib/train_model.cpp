@@ -4,6 +4,7 @@
 #include "dir_helper.h"
 
 #include <catboost/private/libs/algo/approx_dimension.h>
+#include <catboost/private/libs/algo/approx_updater_helpers.h>
 #include <catboost/private/libs/algo/data.h>
 #include <catboost/private/libs/algo/full_model_saver.h>
 #include <catboost/private/libs/algo/helpers.h>
@@ -387,8 +388,10 @@ static void Train(
 
         profile.StartNextIteration();
 
-        if (timer.Passed() > ctx->OutputOptions.GetSnapshotSaveInterval()) {
+        // if the previous snapshot is still being written, the next one is postponed instead of waiting
+        if (timer.Passed() > ctx->OutputOptions.GetSnapshotSaveInterval() && !ctx->IsSnapshotWritingInProgress()) {
             profile.AddOperation("Save snapshot");
+            ApplyPendingTestApproxUpdates(data, ctx);
             ctx->SaveProgress(onSaveSnapshotCallback);
             timer.Reset();
         }
@@ -420,6 +423,10 @@ static void Train(
 
         profile.FinishIteration();
 
+        if (TCatBoostLogSettings::GetRef().Log.FastLogFilter(TLOG_DEBUG)) {
+            ctx->GetMemoryUsageReport().Dump("Iteration " + ToString(iter));
+        }
+
         TProfileResults profileResults = profile.GetProfileResults();
         ctx->LearnProgress->MetricsAndTimeHistory.TimeHistory.push_back(TTimeInfo(profileResults));
 
@@ -438,6 +445,9 @@ static void Train(
         );
 
         if (HasInvalidValues(ctx->LearnProgress->LeafValues.back())) {
+            if (ctx->PendingTestApproxTreeCount > 0) {
+                --ctx->PendingTestApproxTreeCount;
+            }
             ctx->LearnProgress->LeafValues.pop_back();
             ctx->LearnProgress->TreeStruct.pop_back();
             if (!ctx->LearnProgress->ModelShrinkHistory.empty()) {
@@ -451,7 +461,9 @@ static void Train(
         continueTraining = trainingCallbacks->IsContinueTraining(ctx->LearnProgress->MetricsAndTimeHistory);
     }
 
+    ApplyPendingTestApproxUpdates(data, ctx);
     ctx->SaveProgress(onSaveSnapshotCallback);
+    ctx->WaitForSnapshotWriting();
 
     if (hasTest) {
         (*testMultiApprox) = ctx->LearnProgress->TestApprox;
@@ -14,6 +14,7 @@
 #include <util/generic/array_ref.h>
 #include <util/generic/cast.h>
 #include <util/generic/utility.h>
+#include <util/generic/xrange.h>
 
 #include <cmath>
 
@@ -313,6 +314,47 @@ void TModelCalcerOnPool::ApplyModelMulti(
     flatApproxBuffer->clear();
 }
 
+void TModelCalcerOnPool::AddRawFormulaValsToApprox(
+    int begin,
+    int end,
+    size_t approxStartDocIdx,
+    TVector<double>* flatApproxBuffer,
+    TVector<TVector<double>>* approx)
+{
+    const ui32 docCount = ObjectsData->GetObjectCount();
+    const auto approxDimension = Model->GetDimensionsCount();
+    CB_ENSURE_INTERNAL(approx->size() == approxDimension, "Approx has a wrong dimension");
+    for (const auto& approxProjection : *approx) {
+        CB_ENSURE_INTERNAL(approxProjection.size() >= approxStartDocIdx + docCount, "Approx is too small");
+    }
+    if (docCount == 0) {
+        return;
+    }
+    TVector<double>& approxFlat = *flatApproxBuffer;
+    approxFlat.yresize(static_cast<unsigned long>(docCount * approxDimension));
+
+    FixupTreeEnd(Model->GetTreeCount(), begin, &end);
+
+    Executor->ExecRangeWithThrow(
+        [&, this](int blockId) {
+            const int blockFirstId = BlockParams.FirstId + blockId * BlockParams.GetBlockSize();
+            const int blockLastId = Min(BlockParams.LastId, blockFirstId + BlockParams.GetBlockSize());
+            TArrayRef<double> resultRef(
+                approxFlat.data() + blockFirstId * approxDimension,
+                (blockLastId - blockFirstId) * approxDimension);
+            ModelEvaluator->Calc(QuantizedDataForThreads[blockId].Get(), begin, end, resultRef);
+            for (auto dim : xrange(approxDimension)) {
+                double* approxProjection = (*approx)[dim].data() + approxStartDocIdx;
+                for (int doc = blockFirstId; doc < blockLastId; ++doc) {
+                    approxProjection[doc] += approxFlat[approxDimension * doc + dim];
+                }
+            }
+        },
+        0,
+        BlockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
 TModelCalcerOnPool::TModelCalcerOnPool(
     const TFullModel& model,
     TObjectsDataProviderPtr objectsData,
@@ -71,6 +71,16 @@ public:
         TVector<double>* flatApproxBuffer,
         TVector<TVector<double>>* approx);
 
+    /* adds raw formula values of trees [begin, end) to (*approx)[dim][approxStartDocIdx + doc]
+     * so that staged evaluation can keep running approximations and evaluate each tree once
+     */
+    void AddRawFormulaValsToApprox(
+        int begin,
+        int end,
+        size_t approxStartDocIdx,
+        TVector<double>* flatApproxBuffer,
+        TVector<TVector<double>>* approx);
+
 private:
     const TFullModel* Model;
     NCB::NModelEvaluation::TConstModelEvaluatorPtr ModelEvaluator;
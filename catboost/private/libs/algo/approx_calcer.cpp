@@ -12,6 +12,7 @@
 #include "yetirank_helpers.h"
 
 #include <catboost/libs/data/data_provider.h>
+#include <catboost/libs/helpers/adaptive_block_size.h>
 #include <catboost/libs/helpers/vector_helpers.h>
 #include <catboost/libs/helpers/parallel_tasks.h>
 #include <catboost/libs/helpers/quantile.h>
@@ -34,6 +35,7 @@
 #include <library/cpp/threading/local_executor/local_executor.h>
 
 #include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
 #include <util/generic/ymath.h>
 
 template <bool StoreExpApprox, int VectorWidth>
@@ -89,8 +91,11 @@ void UpdateApproxDeltas(
     const TIndexType* indicesData = indices.data();
     const double* leafDeltasData = leafDeltas->data();
 
+    static NCB::TAdaptiveBlockSize adaptiveBlockSize("UpdateApproxDeltas", /*defaultBlockSize*/ 1000);
+    const auto timedCall = adaptiveBlockSize.StartCall(docCount);
+
     NPar::TLocalExecutor::TExecRangeParams blockParams(0, docCount);
-    blockParams.SetBlockSize(AdjustBlockSize(docCount, /*regularBlockSize*/1000));
+    blockParams.SetBlockSize(AdjustBlockSize(docCount, timedCall.GetBlockSize()));
 
     const auto getUpdateApproxBlockLambda = [&](auto boolConst) -> std::function<void(int)> {
         return [=](int blockIdx) {
@@ -120,8 +125,11 @@ static void CalcApproxDers(
     int sampleFinish,
     TArrayRef<TDers> approxDers,
     TLearnContext* ctx) {
+    static NCB::TAdaptiveBlockSize adaptiveBlockSize("CalcApproxDers", APPROX_BLOCK_SIZE);
+    const auto timedCall = adaptiveBlockSize.StartCall(sampleFinish - sampleStart);
+
     NPar::TLocalExecutor::TExecRangeParams blockParams(sampleStart, sampleFinish);
-    blockParams.SetBlockSize(AdjustBlockSize(sampleFinish - sampleStart, APPROX_BLOCK_SIZE));
+    blockParams.SetBlockSize(AdjustBlockSize(sampleFinish - sampleStart, timedCall.GetBlockSize()));
     ctx->LocalExecutor->ExecRangeWithThrow(
         [&](int blockId) {
             const int blockOffset = sampleStart + blockId * blockParams.GetBlockSize();
@@ -559,21 +567,37 @@ static void CalcExactLeafDeltas(
     TConstArrayRef<double> approxes,
     TConstArrayRef<float> targets,
     TConstArrayRef<float> weights,
+    NPar::TLocalExecutor* localExecutor,
     TVector<double>* leafDeltas) {
+    TVector<size_t> leafSizes(leafCount, 0);
+    for (size_t i = 0; i < sampleCount; i++) {
+        Y_ASSERT(indices[i] < leafCount);
+        ++leafSizes[indices[i]];
+    }
     TVector<TVector<float>> leafSamples(leafCount);
     TVector<TVector<float>> leafWeights(leafCount);
+    for (size_t leaf = 0; leaf < leafCount; ++leaf) {
+        leafSamples[leaf].reserve(leafSizes[leaf]);
+        leafWeights[leaf].reserve(weights.empty() ? 0 : leafSizes[leaf]);
+    }
 
     for (size_t i = 0; i < sampleCount; i++) {
-        Y_ASSERT(indices[i] < leafSamples.size());
-        leafSamples[indices[i]].emplace_back(targets[i] - approxes[i]);
-        leafWeights[indices[i]].emplace_back(weights[i]);
+        leafSamples[indices[i]].push_back(targets[i] - approxes[i]);
+        if (!weights.empty()) {
+            leafWeights[indices[i]].push_back(weights[i]);
+        }
     }
 
     Y_ASSERT(leafCount == leafDeltas->size());
-    for (size_t i = 0; i < leafCount; i++) {
-        double& leafDelta = (*leafDeltas)[i];
-        leafDelta = *NCB::CalcOptimumConstApprox(lossDescription, leafSamples[i], leafWeights[i]);
-    }
+    // leaves are independent, so quantiles for them are selected in parallel
+    NPar::ParallelFor(
+        *localExecutor,
+        0,
+        SafeIntegerCast<ui32>(leafCount),
+        [&] (ui32 leaf) {
+            (*leafDeltas)[leaf]
+                = *NCB::CalcOptimumConstApprox(lossDescription, leafSamples[leaf], leafWeights[leaf]);
+        });
 }
 
 static void CalcApproxDeltaSimple(
@@ -617,6 +641,7 @@ static void CalcApproxDeltaSimple(
                 bt.Approx[0],
                 fold.LearnTarget[0],
                 MakeConstArrayRef(fold.SampleWeights),
+                ctx->LocalExecutor,
                 &(*leafDeltas)[0]);
             return;
         }
@@ -812,6 +837,7 @@ static void CalcLeafValuesSimple(
                 bt.Approx[0],
                 fold.LearnTarget[0],
                 MakeConstArrayRef(fold.SampleWeights),
+                ctx->LocalExecutor,
                 &(*leafDeltas)[0]);
             return;
         }
@@ -954,11 +980,12 @@ void CalcLeafValues(
     const IDerCalcer& error,
     const TFold& fold,
     const TVariant<TSplitTree, TNonSymmetricTreeStructure>& tree,
+    EBuildIndicesDataParts indicesDataParts,
     TLearnContext* ctx,
     TVector<TVector<double>>* leafDeltas,
     TVector<TIndexType>* indices) {
 
-    *indices = BuildIndices(fold, tree, data, EBuildIndicesDataParts::All, ctx->LocalExecutor);
+    *indices = BuildIndices(fold, tree, data, indicesDataParts, ctx->LocalExecutor);
     const int approxDimension = ctx->LearnProgress->AveragingFold.GetApproxDimension();
     Y_VERIFY(fold.GetLearnSampleCount() == data.Learn->GetObjectCount());
     const int leafCount = GetLeafCount(tree);
@@ -985,12 +1012,19 @@ void CalcApproxForLeafStruct(
     TLearnContext* ctx,
     TVector<TVector<TVector<double>>>* approxesDelta // [bodyTailId][approxDim][docIdxInPermuted]
 ) {
-    const TVector<TIndexType> indices = BuildIndices(
-        fold,
-        tree,
-        data,
-        EBuildIndicesDataParts::LearnOnly,
-        ctx->LocalExecutor);
+    // indices for the fold of the tree search are already built in GreedyTensorSearch
+    const bool useTreeSearchIndices
+        = (&fold == ctx->TreeSearchIndicesFold) && HoldsAlternative<TSplitTree>(tree);
+    TVector<TIndexType> builtIndices;
+    if (!useTreeSearchIndices) {
+        builtIndices = BuildIndices(
+            fold,
+            tree,
+            data,
+            EBuildIndicesDataParts::LearnOnly,
+            ctx->LocalExecutor);
+    }
+    const TVector<TIndexType>& indices = useTreeSearchIndices ? ctx->TreeSearchIndices : builtIndices;
     const int approxDimension = ctx->LearnProgress->ApproxDimension;
     const int leafCount = GetLeafCount(tree);
     const auto treeMonotoneConstraints = GetTreeMonotoneConstraints(
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "fold.h"
+#include "index_calcer.h"
 
 #include <catboost/private/libs/algo_helpers/online_predictor.h>
 #include <catboost/private/libs/options/enum_helpers.h>
@@ -63,6 +64,7 @@ void CalcLeafValues(
     const IDerCalcer& error,
     const TFold& fold,
     const TVariant<TSplitTree, TNonSymmetricTreeStructure>& tree,
+    EBuildIndicesDataParts indicesDataParts,
     TLearnContext* ctx,
     TVector<TVector<double>>* leafDeltas,
     TVector<TIndexType>* indices
@@ -1,5 +1,6 @@
 #include "approx_updater_helpers.h"
 
+#include "index_calcer.h"
 #include "learn_context.h"
 
 #include <util/generic/cast.h>
@@ -86,3 +87,30 @@ void UpdateAvrgApprox(
         ::UpdateAvrgApprox<false>(learnSampleCount, indices, treeDelta, testData, learnProgress, localExecutor);
     }
 }
+
+void ApplyPendingTestApproxUpdates(const TTrainingDataProviders& data, TLearnContext* ctx) {
+    if (ctx->PendingTestApproxTreeCount == 0) {
+        return;
+    }
+    TLearnProgress* learnProgress = ctx->LearnProgress.Get();
+    const size_t treeCount = learnProgress->TreeStruct.size();
+    Y_ASSERT(ctx->PendingTestApproxTreeCount <= treeCount);
+    for (auto treeIdx : xrange(treeCount - ctx->PendingTestApproxTreeCount, treeCount)) {
+        const TVector<TIndexType> indices = BuildIndices(
+            learnProgress->AveragingFold,
+            learnProgress->TreeStruct[treeIdx],
+            data,
+            EBuildIndicesDataParts::TestOnly,
+            ctx->LocalExecutor);
+        // test approxes are not exponentiated, learn part is empty
+        UpdateAvrgApprox(
+            /*storeExpApprox*/ false,
+            /*learnSampleCount*/ 0,
+            indices,
+            learnProgress->LeafValues[treeIdx],
+            data.Test,
+            learnProgress,
+            ctx->LocalExecutor);
+    }
+    ctx->PendingTestApproxTreeCount = 0;
+}
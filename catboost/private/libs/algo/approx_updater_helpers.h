@@ -2,7 +2,9 @@
 
 #include "fold.h"
 
+#include <catboost/libs/helpers/adaptive_block_size.h>
 #include <catboost/private/libs/algo_helpers/approx_updater_helpers.h>
+#include <catboost/private/libs/algo_helpers/error_functions.h>
 
 #include <library/cpp/threading/local_executor/local_executor.h>
 
@@ -14,6 +16,7 @@
 #include <util/system/yassert.h>
 
 
+class TLearnContext;
 struct TLearnProgress;
 
 template <bool StoreExpApprox>
@@ -32,6 +35,61 @@ inline void UpdateBodyTailApprox(
     for (int bodyTailId = 0; bodyTailId < fold->BodyTailArr.ysize(); ++bodyTailId) {
         TFold::TBodyTail& bt = fold->BodyTailArr[bodyTailId];
         UpdateApprox(applyLearningRate, approxDelta[bodyTailId], &bt.Approx, localExecutor);
+        bt.AreWeightedDerivativesActual = false;
+    }
+}
+
+/* Same as UpdateBodyTailApprox, but also calculates WeightedDerivatives for the updated approxes
+ * in the same pass over blocks of objects, so CalcWeightedDerivatives can skip this fold.
+ * Only for one-dimensional per-object errors.
+ */
+template <bool StoreExpApprox>
+inline void UpdateBodyTailApproxAndDers(
+    const TVector<TVector<TVector<double>>>& approxDelta,
+    double learningRate,
+    const IDerCalcer& error,
+    NPar::TLocalExecutor* localExecutor,
+    TFold* fold
+) {
+    Y_ASSERT(error.GetErrorType() == EErrorType::PerObjectError);
+    const float* target = fold->LearnTarget[0].data();
+    const float* weight = fold->GetLearnWeights().data();
+    for (int bodyTailId = 0; bodyTailId < fold->BodyTailArr.ysize(); ++bodyTailId) {
+        TFold::TBodyTail& bt = fold->BodyTailArr[bodyTailId];
+        Y_ASSERT(bt.Approx.size() == 1);
+        const double* delta = approxDelta[bodyTailId][0].data();
+        double* approx = bt.Approx[0].data();
+        double* weightedDerivatives = bt.WeightedDerivatives[0].data();
+
+        const int tailFinish = bt.TailFinish;
+        static NCB::TAdaptiveBlockSize adaptiveBlockSize("UpdateBodyTailApproxAndDers", /*defaultBlockSize*/ 1000);
+        const auto timedCall = adaptiveBlockSize.StartCall(tailFinish);
+
+        NPar::TLocalExecutor::TExecRangeParams blockParams(0, tailFinish);
+        blockParams.SetBlockSize(timedCall.GetBlockSize());
+        localExecutor->ExecRangeWithThrow(
+            [=, &error](int blockId) {
+                const int blockOffset = blockId * blockParams.GetBlockSize();
+                const int blockSize = Min<int>(blockParams.GetBlockSize(), tailFinish - blockOffset);
+                for (int idx : xrange(blockOffset, blockOffset + blockSize)) {
+                    approx[idx] = UpdateApprox<StoreExpApprox>(
+                        approx[idx],
+                        ApplyLearningRate<StoreExpApprox>(delta[idx], learningRate)
+                    );
+                }
+                error.CalcFirstDerRange(
+                    blockOffset,
+                    blockSize,
+                    approx,
+                    nullptr, // no approx deltas
+                    target,
+                    weight,
+                    weightedDerivatives);
+            },
+            0,
+            blockParams.GetBlockCount(),
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+        bt.AreWeightedDerivativesActual = true;
     }
 }
 
@@ -44,3 +102,8 @@ void UpdateAvrgApprox(
     TLearnProgress* learnProgress,
     NPar::TLocalExecutor* localExecutor
 );
+
+/* Applies trees counted in ctx->PendingTestApproxTreeCount to LearnProgress->TestApprox,
+ * must be called before TestApprox is used
+ */
+void ApplyPendingTestApproxUpdates(const NCB::TTrainingDataProviders& data, TLearnContext* ctx);
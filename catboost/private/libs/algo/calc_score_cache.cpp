@@ -1,9 +1,12 @@
 #include "calc_score_cache.h"
 
+#include <catboost/libs/helpers/map_merge.h>
+#include <catboost/libs/helpers/parallel_tasks.h>
 #include <catboost/libs/helpers/restorable_rng.h>
 #include <catboost/private/libs/options/oblivious_tree_options.h>
 
 #include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
 #include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
 #include <util/system/guard.h>
@@ -16,34 +19,75 @@ bool IsSamplingPerTree(const NCatboostOptions::TObliviousTreeLearnerOptions& fit
     return fitParams.SamplingFrequency.Get() == ESamplingFrequency::PerTree;
 }
 
+ui32 GetMaxLeafCount(const NCatboostOptions::TObliviousTreeLearnerOptions& fitParams) {
+    if (fitParams.GrowPolicy == EGrowPolicy::Lossguide) {
+        return fitParams.MaxLeaves;
+    }
+    return 1u << fitParams.MaxDepth;
+}
+
 TVector<TBucketStats, TPoolAllocator>& TBucketStatsCache::GetStats(
     const TSplitEnsemble& splitEnsemble,
     int splitStatsCount,
     bool* areStatsDirty
 ) {
+    TShard& shard = GetShard(splitEnsemble);
     TVector<TBucketStats, TPoolAllocator>* splitStats;
-    with_lock(Lock) {
-        if (Stats.contains(splitEnsemble) && Stats[splitEnsemble] != nullptr) {
-            splitStats = Stats[splitEnsemble].Get();
+    with_lock(shard.Lock) {
+        auto& cachedStats = shard.Stats[splitEnsemble];
+        if (cachedStats != nullptr) {
+            splitStats = cachedStats.Get();
             Y_ASSERT(splitStats->ysize() >= splitStatsCount);
             *areStatsDirty = false;
         } else {
-            splitStats = new TVector<TBucketStats, TPoolAllocator>(MemoryPool.Get());
+            splitStats = new TVector<TBucketStats, TPoolAllocator>(shard.MemoryPool.Get());
             splitStats->yresize(MaxBodyTailCount * ApproxDimension * splitStatsCount);
-            Stats[splitEnsemble] = splitStats;
+            cachedStats.Reset(splitStats);
             *areStatsDirty = true;
         }
     }
     return *splitStats;
 }
 
+TVector<TBucketStats, TPoolAllocator>& TBucketStatsCache::GetLeafwiseStats(
+    const TSplitEnsemble& splitEnsemble,
+    int statsCount,
+    int leafCount,
+    TVector<ui64>** leafKeys
+) {
+    bool areStatsDirty;
+    auto& stats = GetStats(splitEnsemble, statsCount, &areStatsDirty);
+    TShard& shard = GetShard(splitEnsemble);
+    with_lock(shard.Lock) {
+        auto& keys = shard.LeafKeys[splitEnsemble];
+        if (areStatsDirty || keys.ysize() < leafCount) {
+            keys.assign(leafCount, 0);
+        }
+        *leafKeys = &keys;
+    }
+    return stats;
+}
+
 void TBucketStatsCache::GarbageCollect() {
-    if (MemoryPool->MemoryWaste() > InitialSize) { // limit memory overhead
-        Stats.clear();
-        MemoryPool->Clear();
+    for (auto& shard : Shards) {
+        if (shard.MemoryPool->MemoryWaste() > InitialSize) { // limit memory overhead
+            shard.LeafKeys.clear();
+            shard.Stats.clear();
+            shard.MemoryPool->Clear();
+        }
     }
 }
 
+ui64 TBucketStatsCache::GetMemoryUsage() const {
+    ui64 memoryUsage = 0;
+    for (const auto& shard : Shards) {
+        if (shard.MemoryPool) {
+            memoryUsage += shard.MemoryPool->MemoryAllocated() + shard.MemoryPool->MemoryWaste();
+        }
+    }
+    return memoryUsage;
+}
+
 TVector<TBucketStats> TBucketStatsCache::GetStatsInUse(int segmentCount,
     int segmentSize,
     int statsCount,
@@ -59,6 +103,24 @@ TVector<TBucketStats> TBucketStatsCache::GetStatsInUse(int segmentCount,
     return stats;
 }
 
+void TLeafSubsetKeys::Split(TIndexType leaf, TIndexType leftChild, TIndexType rightChild) {
+    const size_t size = Max(leftChild, rightChild) + 1;
+    if (Keys.size() < size) {
+        Keys.resize(size, 0);
+        ParentKeys.resize(size, 0);
+        ParentLeafs.resize(size, 0);
+        Siblings.resize(size, 0);
+    }
+    const ui64 parentKey = Keys[leaf];
+    for (auto child : {leftChild, rightChild}) {
+        Keys[child] = NextKey++;
+        ParentKeys[child] = parentKey;
+        ParentLeafs[child] = leaf;
+    }
+    Siblings[leftChild] = rightChild;
+    Siblings[rightChild] = leftChild;
+}
+
 void TCalcScoreFold::TVectorSlicing::Create(const NPar::TLocalExecutor::TExecRangeParams& docBlockParams) {
     Total = docBlockParams.LastId;
     Slices.yresize(docBlockParams.GetBlockCount());
@@ -251,6 +313,7 @@ void TCalcScoreFold::Create(
     int defaultCalcStatsObjBlockSize,
     float sampleRate
 ) {
+    SparseScoringData.Reset();
     BernoulliSampleRate = sampleRate;
     Y_ASSERT(BernoulliSampleRate > 0.0f && BernoulliSampleRate <= 1.0f);
     DocCount = folds[0].GetLearnSampleCount();
@@ -434,6 +497,7 @@ void TCalcScoreFold::SelectSmallestSplitSide(
     const TCalcScoreFold& fold,
     NPar::TLocalExecutor* localExecutor
 ) {
+    SparseScoringData.Reset();
     SetSmallestSideControl(curDepth, fold.DocCount, fold.Indices, localExecutor);
 
     TVectorSlicing srcBlocks;
@@ -644,6 +708,7 @@ void TCalcScoreFold::Sample(
     bool shouldSortByLeaf,
     ui32 leavesCount
 ) {
+    SparseScoringData.Reset();
     if (performRandomChoice) {
         SetSampledControl(indices.ysize(), samplingUnit, fold.LearnQueriesInfo, rand);
     } else {
@@ -712,6 +777,7 @@ void TCalcScoreFold::Sample(
 }
 
 void TCalcScoreFold::UpdateIndices(const TVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor) {
+    SparseScoringData.Reset();
     NPar::TLocalExecutor::TExecRangeParams blockParams(0, indices.ysize());
     blockParams.SetBlockSize(2000);
     const int blockCount = blockParams.GetBlockCount();
@@ -922,6 +988,7 @@ void TCalcScoreFold::UpdateIndicesInLeafwiseSortedFoldForSingleLeaf(
     const TVector<TIndexType>& indices,
     NPar::TLocalExecutor* localExecutor
 ) {
+    SparseScoringData.Reset();
     Y_ASSERT(GetBodyTailCount() == 1);
 
     LeavesCount++;
@@ -943,6 +1010,7 @@ void TCalcScoreFold::UpdateIndicesInLeafwiseSortedFold(
     const TVector<TIndexType>& indices,
     NPar::TLocalExecutor* localExecutor
 ) {
+    SparseScoringData.Reset();
     Y_ASSERT(GetBodyTailCount() == 1);
     Y_ASSERT(childs.size() == 2 * leafs.size());
 
@@ -982,6 +1050,7 @@ void TCalcScoreFold::UpdateIndicesInLeafwiseSortedFold(
 
 // for symmetric
 void TCalcScoreFold::UpdateIndicesInLeafwiseSortedFold(const TVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor) {
+    SparseScoringData.Reset();
     TVector<TIndexType> leafs(LeavesCount);
     TVector<TIndexType> childs(2 * LeavesCount);
     for (auto idx : xrange(LeavesCount)) {
@@ -1017,6 +1086,97 @@ const NCB::IIndexRangesGenerator<int>& TCalcScoreFold::GetCalcStatsIndexRanges()
     return *CalcStatsIndexRanges;
 }
 
+const TCalcScoreFold::TSparseScoringData& TCalcScoreFold::GetSparseScoringData(
+    const NCB::TFeaturesArraySubsetIndexing& featuresArraySubsetIndexing,
+    int leafCount,
+    bool isPlainMode,
+    NPar::TLocalExecutor* localExecutor
+) const {
+    with_lock(SparseScoringDataLock) {
+        if (SparseScoringData
+            && (SparseScoringData->FeaturesArraySubsetIndexing == &featuresArraySubsetIndexing)
+            && (SparseScoringData->LeafCount == leafCount)
+            && (SparseScoringData->IsPlainMode == isPlainMode))
+        {
+            return *SparseScoringData;
+        }
+
+        auto sparseScoringData = MakeHolder<TSparseScoringData>();
+        sparseScoringData->FeaturesArraySubsetIndexing = &featuresArraySubsetIndexing;
+        sparseScoringData->LeafCount = leafCount;
+        sparseScoringData->IsPlainMode = isPlainMode;
+
+        // fold contains indices in features buckets arrays, sparse columns are indexed by objects
+        const TMaybe<ui32> consecutiveSubsetBegin = featuresArraySubsetIndexing.GetConsecutiveSubsetBegin();
+        TVector<ui32> srcToObjectIndices;
+        if (!consecutiveSubsetBegin) {
+            ui32 srcSize = 0;
+            featuresArraySubsetIndexing.ForEach(
+                [&] (ui32 /*idx*/, ui32 srcIdx) { srcSize = Max(srcSize, srcIdx + 1); }
+            );
+            srcToObjectIndices.yresize(srcSize);
+            featuresArraySubsetIndexing.ParallelForEach(
+                [&] (ui32 idx, ui32 srcIdx) { srcToObjectIndices[srcIdx] = idx; },
+                localExecutor
+            );
+        }
+
+        const auto& featuresSubset = LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>();
+
+        TVector<ui32>& foldPositions = sparseScoringData->FoldPositions;
+        foldPositions.yresize(featuresArraySubsetIndexing.Size());
+        ParallelFill(
+            TSparseScoringData::InvalidFoldPosition,
+            /*blockSize*/ Nothing(),
+            localExecutor,
+            MakeArrayRef(foldPositions)
+        );
+        NPar::ParallelFor(
+            *localExecutor,
+            0,
+            SafeIntegerCast<ui32>(DocCount),
+            [&] (ui32 doc) {
+                const ui32 srcIdx = featuresSubset[doc];
+                const ui32 objectIdx = consecutiveSubsetBegin ?
+                    (srcIdx - *consecutiveSubsetBegin) : srcToObjectIndices[srcIdx];
+                foldPositions[objectIdx] = doc;
+            }
+        );
+
+        const int bodyTailCount = GetBodyTailCount();
+        const int approxDimension = GetApproxDimension();
+        const int leafStatsCount = bodyTailCount * approxDimension * leafCount;
+        NCB::MapMerge(
+            localExecutor,
+            TSimpleIndexRangesGenerator<int>(TIndexRange<int>(DocCount), DefaultCalcStatsObjBlockSize),
+            /*mapFunc*/[&] (NCB::TIndexRange<int> docIndexRange, TVector<TBucketStats>* leafStats) {
+                leafStats->assign(leafStatsCount, TBucketStats{0, 0, 0, 0});
+                for (int bodyTailIdx : xrange(bodyTailCount)) {
+                    for (int dim : xrange(approxDimension)) {
+                        TBucketStats* leafStatsSubset
+                            = leafStats->data() + (bodyTailIdx * approxDimension + dim) * leafCount;
+                        for (int doc : docIndexRange.Iter()) {
+                            AddDocStats(bodyTailIdx, dim, isPlainMode, doc, &leafStatsSubset[Indices[doc]]);
+                        }
+                    }
+                }
+            },
+            /*mergeFunc*/[&] (TVector<TBucketStats>* leafStats, TVector<TBucketStats>&& addVector) {
+                for (const auto& addItem : addVector) {
+                    for (auto i : xrange(leafStatsCount)) {
+                        (*leafStats)[i].Add(addItem[i]);
+                    }
+                }
+            },
+            &sparseScoringData->LeafStats
+        );
+
+        SparseScoringData = std::move(sparseScoringData);
+        return *SparseScoringData;
+    }
+    Y_UNREACHABLE();
+}
+
 void TCalcScoreFold::SetSmallestSideControl(
     int curDepth,
     int docCount,
@@ -1250,3 +1410,92 @@ void TStats3D::Add(const TStats3D& stats3D) {
         Stats[statIdx].Add(stats3D.Stats[statIdx]);
     }
 }
+
+int TStats3D::operator&(IBinSaver& binSaver) {
+    bool hasOrderedSums = false;
+
+    /* Deep tree levels have a lot of empty buckets, for such stats only nonempty ones are saved
+     * together with their indices
+     */
+    bool isSparse = false;
+    ui32 statCount = 0;
+    TVector<ui32> nonEmptyStatIndices;
+
+    if (!binSaver.IsReading()) {
+        hasOrderedSums = AnyOf(
+            Stats,
+            [] (const TBucketStats& stats) { return (stats.SumDelta != 0) || (stats.Count != 0); }
+        );
+        statCount = SafeIntegerCast<ui32>(Stats.size());
+        for (auto statIdx : xrange(statCount)) {
+            const auto& stats = Stats[statIdx];
+            if ((stats.SumWeightedDelta != 0) || (stats.SumWeight != 0)
+                || (stats.SumDelta != 0) || (stats.Count != 0))
+            {
+                nonEmptyStatIndices.push_back(statIdx);
+            }
+        }
+        const size_t statSize = (hasOrderedSums ? 4 : 2) * sizeof(double);
+        isSparse = nonEmptyStatIndices.size() * (statSize + sizeof(ui32)) < statCount * statSize;
+    }
+    binSaver.AddMulti(hasOrderedSums, isSparse, BucketCount, MaxLeafCount, SplitEnsembleSpec);
+
+    if (isSparse) {
+        binSaver.AddMulti(statCount, nonEmptyStatIndices);
+    } else if (hasOrderedSums) {
+        binSaver.AddMulti(Stats);
+        return 0;
+    }
+
+    // [statIdx][SumWeightedDelta, SumWeight(, SumDelta, Count)], for nonempty stats only if isSparse
+    const size_t sumCount = hasOrderedSums ? 4 : 2;
+    TVector<double> sums;
+    if (!binSaver.IsReading()) {
+        auto addSums = [&] (const TBucketStats& stats) {
+            sums.push_back(stats.SumWeightedDelta);
+            sums.push_back(stats.SumWeight);
+            if (hasOrderedSums) {
+                sums.push_back(stats.SumDelta);
+                sums.push_back(stats.Count);
+            }
+        };
+        if (isSparse) {
+            sums.reserve(sumCount * nonEmptyStatIndices.size());
+            for (auto statIdx : nonEmptyStatIndices) {
+                addSums(Stats[statIdx]);
+            }
+        } else {
+            sums.reserve(sumCount * Stats.size());
+            for (const auto& stats : Stats) {
+                addSums(stats);
+            }
+        }
+    }
+    binSaver.AddMulti(sums);
+    if (binSaver.IsReading()) {
+        auto getStats = [&] (size_t sumsIdx) {
+            const double* statSums = sums.data() + sumCount * sumsIdx;
+            return hasOrderedSums ?
+                TBucketStats{statSums[0], statSums[1], statSums[2], statSums[3]} :
+                TBucketStats{statSums[0], statSums[1], 0, 0};
+        };
+        if (isSparse) {
+            CB_ENSURE_INTERNAL(
+                sums.size() == sumCount * nonEmptyStatIndices.size(),
+                "Sparse stats data size mismatch"
+            );
+            Stats.yresize(statCount);
+            Fill(Stats.begin(), Stats.end(), TBucketStats{0, 0, 0, 0});
+            for (auto i : xrange(nonEmptyStatIndices.size())) {
+                CB_ENSURE_INTERNAL(nonEmptyStatIndices[i] < statCount, "Sparse stats index is out of range");
+                Stats[nonEmptyStatIndices[i]] = getStats(i);
+            }
+        } else {
+            Stats.yresize(sums.size() / sumCount);
+            for (auto statIdx : xrange(Stats.size())) {
+                Stats[statIdx] = getStats(statIdx);
+            }
+        }
+    }
+    return 0;
+}
@@ -16,6 +16,8 @@
 #include <util/system/info.h>
 #include <util/system/spinlock.h>
 
+#include <array>
+
 
 struct TRestorableFastRng64;
 
@@ -26,6 +28,9 @@ namespace NCatboostOptions {
 
 bool IsSamplingPerTree(const NCatboostOptions::TObliviousTreeLearnerOptions& fitParams);
 
+// max leaf index + 1 for trees grown with fitParams
+ui32 GetMaxLeafCount(const NCatboostOptions::TObliviousTreeLearnerOptions& fitParams);
+
 
 /* both TArrayRef and TVector variants are needed because of no automatic 2-hop casting
  * TUnsizedVector -> TVector -> TArrayRef
@@ -120,23 +125,37 @@ inline static int CountNonCtrBuckets(
     return nonCtrBucketCount;
 }
 
+// Stats are split to shards by split ensemble, each shard has its own lock and memory pool,
+// so threads calculating stats for different candidates don't contend for a single lock.
 class TBucketStatsCache {
 public:
     inline void Create(const TVector<TFold>& folds, int bucketCount, int depth) {
         ApproxDimension = folds[0].GetApproxDimension();
         MaxBodyTailCount = GetMaxBodyTailCount(folds);
         InitialSize = sizeof(TBucketStats) * bucketCount * (1ULL << depth) * ApproxDimension * MaxBodyTailCount;
-        if (InitialSize == 0) {
-            InitialSize = NSystemInfo::GetPageSize();
+        InitialSize = Max<size_t>(InitialSize / ShardCount, NSystemInfo::GetPageSize());
+        for (auto& shard : Shards) {
+            shard.Stats.clear();
+            shard.MemoryPool = new TMemoryPool(InitialSize);
         }
-        MemoryPool = new TMemoryPool(InitialSize);
     }
     TVector<TBucketStats, TPoolAllocator>& GetStats(
         const TSplitEnsemble& splitEnsemble,
         int statsCount,
         bool* areStatsDirty
     );
+    /* for non-symmetric trees: stats of each leaf are stored in the same layout as for symmetric tree levels,
+     * leafKeys get the keys of leaf documents subsets the stats were calculated for (see TLeafSubsetKeys)
+     */
+    TVector<TBucketStats, TPoolAllocator>& GetLeafwiseStats(
+        const TSplitEnsemble& splitEnsemble,
+        int statsCount,
+        int leafCount,
+        TVector<ui64>** leafKeys
+    );
     void GarbageCollect();
+    // memory allocated for cached stats
+    ui64 GetMemoryUsage() const;
     static TVector<TBucketStats> GetStatsInUse(
         int segmentCount,
         int segmentSize,
@@ -144,17 +163,73 @@ public:
         const TVector<TBucketStats, TPoolAllocator>& cachedStats
     );
 
-public:
-    THashMap<TSplitEnsemble, THolder<TVector<TBucketStats, TPoolAllocator>>> Stats;
+    // not thread-safe
+    void Erase(const TSplitEnsemble& splitEnsemble) {
+        auto& shard = GetShard(splitEnsemble);
+        shard.Stats.erase(splitEnsemble);
+        shard.LeafKeys.erase(splitEnsemble);
+    }
+
+    // not thread-safe, predicate must accept (const TSplitEnsemble&) param
+    template <class TPredicate>
+    void EraseIf(TPredicate&& predicate) {
+        for (auto& shard : Shards) {
+            for (auto it = shard.Stats.begin(); it != shard.Stats.end();) {
+                if (predicate(it->first)) {
+                    shard.LeafKeys.erase(it->first);
+                    shard.Stats.erase(it++);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr size_t ShardCount = 64;
+
+    struct TShard {
+        THashMap<TSplitEnsemble, THolder<TVector<TBucketStats, TPoolAllocator>>> Stats;
+        THashMap<TSplitEnsemble, TVector<ui64>> LeafKeys; // only for non-symmetric trees
+        THolder<TMemoryPool> MemoryPool;
+        TAdaptiveLock Lock;
+    };
+
+private:
+    TShard& GetShard(const TSplitEnsemble& splitEnsemble) {
+        return Shards[THash<TSplitEnsemble>()(splitEnsemble) % ShardCount];
+    }
 
 private:
-    THolder<TMemoryPool> MemoryPool;
-    TAdaptiveLock Lock;
-    size_t InitialSize = 0;
+    std::array<TShard, ShardCount> Shards;
+    size_t InitialSize = 0; // per shard
     int MaxBodyTailCount = 0;
     int ApproxDimension = 0;
 };
 
+/* Keys of documents subsets of leaves of the non-symmetric tree being grown.
+ * A split leaf passes its index to the left child, so until the children stats are calculated
+ * the parent stats remain in the cache at (ParentLeafs[leaf], ParentKeys[leaf]) and the stats of
+ * both children can be obtained by scanning only the smaller one.
+ * Keys are unique during the training, so stats cached for previous trees never match; 0 is never used.
+ */
+struct TLeafSubsetKeys {
+    TVector<ui64> Keys; // [leaf]
+    TVector<ui64> ParentKeys; // [leaf], 0 for the root
+    TVector<TIndexType> ParentLeafs; // [leaf]
+    TVector<TIndexType> Siblings; // [leaf]
+    ui64 NextKey = 1;
+
+    void StartTree() {
+        Keys.assign(1, NextKey++);
+        ParentKeys.assign(1, 0);
+        ParentLeafs.assign(1, 0);
+        Siblings.assign(1, 0);
+    }
+
+    void Split(TIndexType leaf, TIndexType leftChild, TIndexType rightChild);
+};
+
 class TCalcScoreFold {
 public:
     template <typename TDataType>
@@ -283,6 +358,50 @@ public:
         return LearnPermutationOfflineEstimatedFeaturesSubset.Get<NCB::TIndexedSubset<ui32>>();
     }
 
+    // data for scoring of sparse features that processes only their non-default values
+    struct TSparseScoringData {
+        // fold position of each object, InvalidFoldPosition if it is not in the fold
+        TVector<ui32> FoldPositions;
+
+        // stats of all fold objects in each leaf, [bodyTail][dim][leaf]
+        TVector<TBucketStats> LeafStats;
+
+        const NCB::TFeaturesArraySubsetIndexing* FeaturesArraySubsetIndexing = nullptr;
+        int LeafCount = 0;
+        bool IsPlainMode = false;
+
+    public:
+        static constexpr ui32 InvalidFoldPosition = Max<ui32>();
+    };
+
+    /* thread-safe, built on the first call after each change of the fold,
+     * calls for the same fold state must have the same params
+     */
+    const TSparseScoringData& GetSparseScoringData(
+        const NCB::TFeaturesArraySubsetIndexing& featuresArraySubsetIndexing, // of learn objects data
+        int leafCount,
+        bool isPlainMode,
+        NPar::TLocalExecutor* localExecutor
+    ) const;
+
+    // add contribution of the object at fold position doc to stats as symmetric trees scoring does
+    inline void AddDocStats(int bodyTailIdx, int dim, bool isPlainMode, int doc, TBucketStats* stats) const {
+        const TBodyTail& bt = BodyTailArr[bodyTailIdx];
+        if (doc >= bt.TailFinish) {
+            return;
+        }
+        const bool hasPairwiseWeights = !bt.PairwiseWeights.empty();
+        if (isPlainMode || (doc >= bt.BodyFinish)) {
+            stats->SumWeightedDelta += bt.SampleWeightedDerivatives[dim][doc];
+            stats->SumWeight += hasPairwiseWeights ? bt.SamplePairwiseWeights[doc] : SampleWeights[doc];
+        } else {
+            const float* weightsData = hasPairwiseWeights ?
+                GetDataPtr(bt.PairwiseWeights) : GetDataPtr(LearnWeights);
+            stats->SumDelta += bt.WeightedDerivatives[dim][doc];
+            stats->Count += weightsData ? weightsData[doc] : 1.0f;
+        }
+    }
+
 private:
     using TSlice = TVectorSlicing::TSlice;
 
@@ -408,6 +527,10 @@ private:
     int DefaultCalcStatsObjBlockSize;
 
     THolder<NCB::IIndexRangesGenerator<int>> CalcStatsIndexRanges;
+
+    // reset by all methods that change the fold
+    mutable TAdaptiveLock SparseScoringDataLock;
+    mutable THolder<TSparseScoringData> SparseScoringData;
 };
 
 
@@ -419,7 +542,8 @@ struct TStats3D {
     TSplitEnsembleSpec SplitEnsembleSpec;
 
 public:
-    SAVELOAD(Stats, BucketCount, MaxLeafCount, SplitEnsembleSpec);
+    // in plain mode only SumWeightedDelta and SumWeight sums are nonzero and only they are saved
+    int operator&(IBinSaver& binSaver);
 
     void Add(const TStats3D& stats3D);
 };
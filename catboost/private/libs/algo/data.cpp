@@ -227,7 +227,8 @@ namespace NCB {
                     outputPairsInfo.FakeObjectsGrouping,
                     Nothing(),
                     TWeights(outputPairsInfo.PermutationForGrouping.size()),
-                    TConstArrayRef<TPair>(outputPairsInfo.PairsInPermutedDataset)
+                    TConstArrayRef<TPair>(outputPairsInfo.PairsInPermutedDataset),
+                    localExecutor
                 )
             );
         }
@@ -11,6 +11,7 @@
 
 #include <library/cpp/threading/local_executor/local_executor.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
 
 
@@ -106,6 +107,7 @@ TFold TFold::BuildDynamicFold(
     TMaybe<double> startingApprox,
     const NCatboostOptions::TBinarizationOptions& onlineEstimatedFeaturesQuantizationOptions,
     TQuantizedFeaturesInfoPtr onlineEstimatedFeaturesQuantizedInfo,
+    const NCB::TEstimatedForCPUObjectsDataProviders* precalculatedOnlineEstimatedFeatures,
     TRestorableFastRng64* rand,
     NPar::TLocalExecutor* localExecutor
 ) {
@@ -203,6 +205,7 @@ TFold TFold::BuildDynamicFold(
     ff.InitOnlineEstimatedFeatures(
         onlineEstimatedFeaturesQuantizationOptions,
         std::move(onlineEstimatedFeaturesQuantizedInfo),
+        precalculatedOnlineEstimatedFeatures,
         data,
         localExecutor,
         rand
@@ -231,6 +234,7 @@ TFold TFold::BuildPlainFold(
     TMaybe<double> startingApprox,
     const NCatboostOptions::TBinarizationOptions& onlineEstimatedFeaturesQuantizationOptions,
     TQuantizedFeaturesInfoPtr onlineEstimatedFeaturesQuantizedInfo,
+    const NCB::TEstimatedForCPUObjectsDataProviders* precalculatedOnlineEstimatedFeatures,
     TRestorableFastRng64* rand,
     NPar::TLocalExecutor* localExecutor
 ) {
@@ -298,6 +302,7 @@ TFold TFold::BuildPlainFold(
     ff.InitOnlineEstimatedFeatures(
         onlineEstimatedFeaturesQuantizationOptions,
         std::move(onlineEstimatedFeaturesQuantizedInfo),
+        precalculatedOnlineEstimatedFeatures,
         data,
         localExecutor,
         rand
@@ -324,6 +329,75 @@ void TFold::DropEmptyCTRs() {
     }
 }
 
+void TFold::TrimOnlineCTR(size_t maxOnlineCTRFeatures, ui64 maxOnlineCTRMemory) {
+    ++CtrUseTime;
+    if (OnlineCTR.size() > maxOnlineCTRFeatures) {
+        OnlineCTR.clear();
+    }
+
+    ui64 memoryUsage = 0;
+    TVector<TOnlineCTR*> ctrs;
+    for (auto* ctrHash : {&OnlineSingleCtrs, &OnlineCTR}) {
+        for (auto& projCtr : *ctrHash) {
+            if (!projCtr.second.Feature.empty()) {
+                memoryUsage += projCtr.second.GetMemoryUsage();
+                ctrs.push_back(&projCtr.second);
+            }
+        }
+    }
+    if (memoryUsage <= maxOnlineCTRMemory) {
+        return;
+    }
+    StableSortBy(ctrs, [] (const TOnlineCTR* ctr) { return ctr->LastUseTime; });
+    for (auto* ctr : ctrs) {
+        if (memoryUsage <= maxOnlineCTRMemory) {
+            break;
+        }
+        memoryUsage -= ctr->GetMemoryUsage();
+        ctr->Feature.clear();
+        ctr->Feature.shrink_to_fit();
+    }
+}
+
+ui64 TFold::GetOnlineCtrMemoryUsage() const {
+    ui64 memoryUsage = 0;
+    for (const auto* ctrHash : {&OnlineSingleCtrs, &OnlineCTR}) {
+        for (const auto& projCtr : *ctrHash) {
+            memoryUsage += projCtr.second.GetMemoryUsage();
+        }
+    }
+    return memoryUsage;
+}
+
+template <class T>
+static ui64 GetCapacityInBytes(const TVector<T>& vector) {
+    return vector.capacity() * sizeof(T);
+}
+
+template <class T>
+static ui64 GetCapacityInBytes(const TVector<TVector<T>>& vectors) {
+    ui64 memoryUsage = 0;
+    for (const auto& vector : vectors) {
+        memoryUsage += GetCapacityInBytes(vector);
+    }
+    return memoryUsage;
+}
+
+ui64 TFold::GetBuffersMemoryUsage() const {
+    ui64 memoryUsage = GetCapacityInBytes(LearnTarget)
+        + GetCapacityInBytes(SampleWeights)
+        + GetCapacityInBytes(LearnTargetClass)
+        + GetCapacityInBytes(LearnWeights);
+    for (const auto& bodyTail : BodyTailArr) {
+        memoryUsage += GetCapacityInBytes(bodyTail.Approx)
+            + GetCapacityInBytes(bodyTail.WeightedDerivatives)
+            + GetCapacityInBytes(bodyTail.SampleWeightedDerivatives)
+            + GetCapacityInBytes(bodyTail.PairwiseWeights)
+            + GetCapacityInBytes(bodyTail.SamplePairwiseWeights);
+    }
+    return memoryUsage;
+}
+
 void TFold::AssignTarget(
     TMaybeData<TConstArrayRef<TConstArrayRef<float>>> target,
     const TVector<TTargetClassifier>& targetClassifiers,
@@ -375,16 +449,23 @@ void TFold::LoadApproxes(IInputStream* s) {
     BodyTailArr.resize(bodyTailCount);
     for (ui64 i = 0; i < bodyTailCount; ++i) {
         ::Load(s, BodyTailArr[i].Approx);
+        BodyTailArr[i].AreWeightedDerivativesActual = false;
     }
 }
 
 void TFold::InitOnlineEstimatedFeatures(
     const NCatboostOptions::TBinarizationOptions& quantizationOptions,
     TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
+    const NCB::TEstimatedForCPUObjectsDataProviders* precalculatedOnlineEstimatedFeatures,
     const NCB::TTrainingDataProviders& data,
     NPar::TLocalExecutor* localExecutor,
     TRestorableFastRng64* rand
 ) {
+    if (precalculatedOnlineEstimatedFeatures) {
+        // estimated features data is not modified during training so it can be shared
+        OnlineEstimatedFeatures = *precalculatedOnlineEstimatedFeatures;
+        return;
+    }
     OnlineEstimatedFeatures = CreateEstimatedFeaturesData(
         quantizationOptions,
         /*maxSubsetSizeForBuildBordersAlgorithms*/ 100000,
@@ -64,6 +64,9 @@ public:
         const int BodyFinish;
         const int TailFinish;
         const double BodySumWeight;
+
+        // set when WeightedDerivatives were calculated together with the last Approx update
+        bool AreWeightedDerivativesActual = false;
     };
 
 public:
@@ -117,12 +120,23 @@ public:
         return BodyTailArr[0].Approx.ysize();
     }
 
-    void TrimOnlineCTR(size_t maxOnlineCTRFeatures) {
-        if (OnlineCTR.size() > maxOnlineCTRFeatures) {
-            OnlineCTR.clear();
-        }
+    void MarkCtrUsed(const TProjection& proj) {
+        GetCtrRef(proj).LastUseTime = CtrUseTime;
     }
 
+    /* Starts new ctr use period.
+     * Drops all tree ctrs if there are more than maxOnlineCTRFeatures of them, then drops values of least recently
+     * used ctrs until the memory used by ctr values fits into maxOnlineCTRMemory,
+     * dropped values are recalculated when needed.
+     */
+    void TrimOnlineCTR(size_t maxOnlineCTRFeatures, ui64 maxOnlineCTRMemory);
+
+    // memory used by values of all online ctrs of the fold
+    ui64 GetOnlineCtrMemoryUsage() const;
+
+    // memory used by per-object buffers: approxes, derivatives, targets and weights
+    ui64 GetBuffersMemoryUsage() const;
+
     const TVector<float>& GetLearnWeights() const { return LearnWeights; }
 
     void SaveApproxes(IOutputStream* s) const;
@@ -140,6 +154,9 @@ public:
         TMaybe<double> startingApprox,
         const NCatboostOptions::TBinarizationOptions& onlineEstimatedFeaturesQuantizationOptions,
         NCB::TQuantizedFeaturesInfoPtr onlineEstimatedFeaturesQuantizedInfo, // can be nullptr
+
+        // can be nullptr, if defined - must be calculated for the same learn permutation, shared, not calculated
+        const NCB::TEstimatedForCPUObjectsDataProviders* precalculatedOnlineEstimatedFeatures,
         TRestorableFastRng64* rand,
         NPar::TLocalExecutor* localExecutor
     );
@@ -155,6 +172,9 @@ public:
         TMaybe<double> startingApprox,
         const NCatboostOptions::TBinarizationOptions& onlineEstimatedFeaturesQuantizationOptions,
         NCB::TQuantizedFeaturesInfoPtr onlineEstimatedFeaturesQuantizedInfo, // can be nullptr
+
+        // can be nullptr, if defined - must be calculated for the same learn permutation, shared, not calculated
+        const NCB::TEstimatedForCPUObjectsDataProviders* precalculatedOnlineEstimatedFeatures,
         TRestorableFastRng64* rand,
         NPar::TLocalExecutor* localExecutor
     );
@@ -182,6 +202,7 @@ private:
     void InitOnlineEstimatedFeatures(
         const NCatboostOptions::TBinarizationOptions& quantizationOptions,
         NCB::TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
+        const NCB::TEstimatedForCPUObjectsDataProviders* precalculatedOnlineEstimatedFeatures,
         const NCB::TTrainingDataProviders& data,
         NPar::TLocalExecutor* localExecutor,
         TRestorableFastRng64* rand
@@ -220,6 +241,7 @@ private:
 
     TOnlineCTRHash OnlineSingleCtrs;
     TOnlineCTRHash OnlineCTR;
+    ui64 CtrUseTime = 0;
 
     NCB::TEstimatedForCPUObjectsDataProviders OnlineEstimatedFeatures;
 };
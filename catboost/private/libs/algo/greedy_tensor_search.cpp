@@ -9,6 +9,7 @@
 #include "learn_context.h"
 #include "monotonic_constraint_utils.h"
 #include "nonsymmetric_index_calcer.h"
+#include "pairwise_scoring.h"
 #include "scoring.h"
 #include "split.h"
 #include "tensor_search_helpers.h"
@@ -23,6 +24,8 @@
 #include <catboost/libs/logging/profile_info.h>
 #include <catboost/private/libs/algo_helpers/langevin_utils.h>
 #include <catboost/private/libs/distributed/master.h>
+#include <catboost/private/libs/index_range/index_range.h>
+#include <catboost/private/libs/options/system_options.h>
 
 #include <library/cpp/fast_log/fast_log.h>
 
@@ -30,7 +33,9 @@
 #include <util/generic/queue.h>
 #include <util/generic/scope.h>
 #include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
 #include <util/string/builder.h>
+#include <util/system/info.h>
 #include <util/system/mem_info.h>
 
 
@@ -57,9 +62,18 @@ namespace {
     };
 }
 
-void TrimOnlineCTRcache(const TVector<TFold*>& folds) {
+static ui64 GetMaxOnlineCtrMemoryPerFold(const TLearnContext& ctx) {
+    // half of the available memory is shared between ctr values of all learn folds and the averaging fold
+    const ui64 usedRamLimit = Min<ui64>(
+        ParseMemorySizeDescription(ctx.Params.SystemOptions->CpuUsedRamLimit.Get()),
+        NSystemInfo::TotalMemorySize());
+    return usedRamLimit / 2 / (ctx.LearnProgress->Folds.size() + 1);
+}
+
+void TrimOnlineCTRcache(const TVector<TFold*>& folds, const TLearnContext& ctx) {
+    const ui64 maxOnlineCtrMemory = GetMaxOnlineCtrMemoryPerFold(ctx);
     for (auto& fold : folds) {
-        fold->TrimOnlineCTR(MAX_ONLINE_CTR_FEATURES);
+        fold->TrimOnlineCTR(MAX_ONLINE_CTR_FEATURES, maxOnlineCtrMemory);
     }
 }
 
@@ -380,7 +394,7 @@ static void SelectCandidatesAndCleanupStatsFromPrevTree(
         if (addCandSubListToResult) {
             updatedCandList.push_back(std::move(candSubList));
         } else if (ctx->UseTreeLevelCaching()) {
-            statsFromPrevTree->Stats.erase(splitEnsemble);
+            statsFromPrevTree->Erase(splitEnsemble);
         }
     }
 
@@ -439,7 +453,7 @@ static void DropStatsForProjection(
                 TSplitCandidate splitCandidate;
                 splitCandidate.Type = ESplitType::OnlineCtr;
                 splitCandidate.Ctr = TCtr(proj, ctrIdx, border, prior, ctrMeta.BorderCount);
-                statsFromPrevTree->Stats.erase(TSplitEnsemble(std::move(splitCandidate)));
+                statsFromPrevTree->Erase(TSplitEnsemble(std::move(splitCandidate)));
             }
         }
     }
@@ -471,7 +485,7 @@ static void AddSimpleCtrs(
                 return;
             }
             AddCtrsToCandList(*fold, *ctx, proj, candList);
-            fold->GetCtrRef(proj);
+            fold->MarkCtrUsed(proj);
         }
     );
 }
@@ -530,22 +544,17 @@ static void AddTreeCtrs(
                 addedProjHash.insert(proj);
 
                 AddCtrsToCandList(*fold, *ctx, proj, candList);
-                fold->GetCtrRef(proj);
+                fold->MarkCtrUsed(proj);
             }
         );
     }
     if (ctx->UseTreeLevelCaching()) {
-        THashSet<TSplitEnsemble> candidatesToErase;
-        for (auto& [splitEnsemble, value] : statsFromPrevTree->Stats) {
-            if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
-                if (!addedProjHash.contains(splitEnsemble.SplitCandidate.Ctr.Projection)) {
-                    candidatesToErase.insert(splitEnsemble);
-                }
+        statsFromPrevTree->EraseIf(
+            [&] (const TSplitEnsemble& splitEnsemble) {
+                return splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)
+                    && !addedProjHash.contains(splitEnsemble.SplitCandidate.Ctr.Projection);
             }
-        }
-        for (const auto& splitEnsemble : candidatesToErase) {
-            statsFromPrevTree->Stats.erase(splitEnsemble);
-        }
+        );
     }
 }
 
@@ -623,7 +632,13 @@ static void CalcBestScore(
     TFold* fold,
     TLearnContext* ctx) {
 
-    const TFlatPairsInfo pairs = UnpackPairsFromQueries(fold->LearnQueriesInfo);
+    TFlatPairsInfo pairs = UnpackPairsFromQueries(fold->LearnQueriesInfo);
+    if (!pairs.empty() && IsPairwiseScoring(ctx->Params.LossFunctionDescription->GetLossFunction())) {
+        SortPairsByLeaves(
+            MakeArrayRef(ctx->SampledDocs.Indices.data(), ctx->SampledDocs.GetDocCount()),
+            ctx->LocalExecutor,
+            &pairs);
+    }
     const auto& monotonicConstraints = ctx->Params.ObliviousTreeOptions->MonotoneConstraints.Get();
     const TVector<int> currTreeMonotonicConstraints = (
         monotonicConstraints.empty()
@@ -1043,6 +1058,7 @@ static void ProcessCtrSplit(
     ctx->LearnProgress->UsedCtrSplits.insert(std::make_pair(ctrType, ctr.Projection));
 
     const auto& proj = bestSplit.Ctr.Projection;
+    fold->MarkCtrUsed(proj);
     if (fold->GetCtrRef(proj).Feature.empty()) {
         ComputeOnlineCTRs(data, *fold, proj, ctx, &fold->GetCtrRef(proj));
         if (ctx->UseTreeLevelCaching()) {
@@ -1128,6 +1144,7 @@ static TSplitTree GreedyTensorSearchOblivious(
     const ui32 learnSampleCount = data.Learn->ObjectsData->GetObjectCount();
     const double scoreStDev = CalcScoreStDev(learnSampleCount, modelLength, *fold, ctx);
 
+    bool areIndicesForTree = true;
     for (ui32 curDepth = 0; curDepth < ctx->Params.ObliviousTreeOptions->MaxDepth; ++curDepth) {
         TVector<TCandidatesContext> candidatesContexts
             = SelectFeaturesForScoring(data, currentSplitTree, fold, ctx);
@@ -1172,6 +1189,7 @@ static TSplitTree GreedyTensorSearchOblivious(
             &ctx->LearnProgress->UsedFeaturesPerObject
         );
 
+        int redundantIdx = -1;
         if (ctx->Params.SystemOptions->IsSingleHost()) {
             SetPermutedIndices(
                 bestSplit,
@@ -1195,25 +1213,28 @@ static TSplitTree GreedyTensorSearchOblivious(
             }
         } else {
             Y_ASSERT(bestSplit.Type != ESplitType::OnlineCtr);
-            MapSetIndices(bestSplit, ctx);
+            // single round trip to workers: apply split to indices and poll empty leaves
+            redundantIdx = MapSetIndicesAndGetRedundantSplitIdx(bestSplit, ctx);
         }
         currentSplitTree.AddSplit(bestSplit);
         CATBOOST_INFO_LOG << BuildDescription(*ctx->Layout, bestSplit) << " score " << bestScore << "\n";
 
         profile.AddOperation(TStringBuilder() << "Select best split " << curDepth);
 
-        int redundantIdx = -1;
         if (ctx->Params.SystemOptions->IsSingleHost()) {
             redundantIdx = GetRedundantSplitIdx(GetIsLeafEmpty(curDepth + 1, *indices));
-        } else {
-            redundantIdx = MapGetRedundantSplitIdx(ctx);
         }
         if (redundantIdx != -1) {
             currentSplitTree.DeleteSplit(redundantIdx);
             CATBOOST_INFO_LOG << "  tensor " << redundantIdx << " is redundant, remove it and stop\n";
+            areIndicesForTree = false;
             break;
         }
     }
+    if (areIndicesForTree && ctx->Params.SystemOptions->IsSingleHost()) {
+        // indices were updated with each selected split, so they can be reused for this fold's approx update
+        ctx->TreeSearchIndicesFold = fold;
+    }
     return currentSplitTree;
 }
 
@@ -1222,17 +1243,58 @@ static void SplitDocsSubset(
     const TIndexedSubset<ui32>& subsetToSplit,
     TConstArrayRef<TIndexType> indices,
     TIndexType leftChildIdx,
+    NPar::TLocalExecutor* localExecutor,
     TIndexedSubset<ui32>* leftChildSubset,
     TIndexedSubset<ui32>* rightChildSubset) {
 
-    // TODO(ilyzhin) it can be parallel
-    for (auto doc : subsetToSplit) {
-        if (indices[doc] == leftChildIdx) {
-            leftChildSubset->push_back(doc);
-        } else{
-            rightChildSubset->push_back(doc);
-        }
+    // stable partition in parallel blocks: count left docs in each block, then scatter docs to block offsets
+    const size_t blockSize = Max<size_t>(CeilDiv<size_t>(subsetToSplit.size(), localExecutor->GetThreadCount() + 1), 1000);
+    const TSimpleIndexRangesGenerator<size_t> rangesGenerator(TIndexRange<size_t>(subsetToSplit.size()), blockSize);
+    const int blockCount = rangesGenerator.RangesCount();
+    TConstArrayRef<ui32> subsetToSplitRef(subsetToSplit);
+
+    TVector<size_t> leftDocsCount(blockCount);
+    localExecutor->ExecRange(
+        [&] (int blockId) {
+            size_t count = 0;
+            for (auto idx : rangesGenerator.GetRange(blockId).Iter()) {
+                count += (indices[subsetToSplitRef[idx]] == leftChildIdx);
+            }
+            leftDocsCount[blockId] = count;
+        },
+        0,
+        blockCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    TVector<size_t> leftDocsOffset(blockCount);
+    TVector<size_t> rightDocsOffset(blockCount);
+    size_t leftCount = 0;
+    for (auto blockId : xrange(blockCount)) {
+        leftDocsOffset[blockId] = leftCount;
+        rightDocsOffset[blockId] = rangesGenerator.GetRange(blockId).Begin - leftCount;
+        leftCount += leftDocsCount[blockId];
     }
+    leftChildSubset->yresize(leftCount);
+    rightChildSubset->yresize(subsetToSplit.size() - leftCount);
+
+    TArrayRef<ui32> leftChildSubsetRef(*leftChildSubset);
+    TArrayRef<ui32> rightChildSubsetRef(*rightChildSubset);
+    localExecutor->ExecRange(
+        [&] (int blockId) {
+            size_t leftOffset = leftDocsOffset[blockId];
+            size_t rightOffset = rightDocsOffset[blockId];
+            for (auto idx : rangesGenerator.GetRange(blockId).Iter()) {
+                const ui32 doc = subsetToSplitRef[idx];
+                if (indices[doc] == leftChildIdx) {
+                    leftChildSubsetRef[leftOffset++] = doc;
+                } else {
+                    rightChildSubsetRef[rightOffset++] = doc;
+                }
+            }
+        },
+        0,
+        blockCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE);
 }
 
 static TNonSymmetricTreeStructure GreedyTensorSearchLossguide(
@@ -1252,6 +1314,8 @@ static TNonSymmetricTreeStructure GreedyTensorSearchLossguide(
 
     const double scoreStDev = CalcScoreStDev(learnSampleCount, modelLength, *fold, ctx);
 
+    ctx->LeafSubsetKeys.StartTree();
+
     TPriorityQueue<TSplitLeafCandidate> queue;
     TVector<ui32> leafDepth(ctx->Params.ObliviousTreeOptions->MaxLeaves);
     const auto findBestCandidate = [&](TIndexType leaf) {
@@ -1320,6 +1384,7 @@ static TNonSymmetricTreeStructure GreedyTensorSearchLossguide(
         const auto& node = currentStructure.AddSplit(bestSplit, curSplitLeaf.Leaf);
         const TIndexType leftChildIdx = ~node.Left;
         const TIndexType rightChildIdx = ~node.Right;
+        ctx->LeafSubsetKeys.Split(splittedNodeIdx, leftChildIdx, rightChildIdx);
         UpdateIndices(
             node,
             data,
@@ -1331,7 +1396,13 @@ static TNonSymmetricTreeStructure GreedyTensorSearchLossguide(
 
         TIndexedSubset<ui32> leftChildSubset, rightChildSubset;
         Y_ASSERT(leftChildIdx == splittedNodeIdx);
-        SplitDocsSubset(subsetsForLeafs[splittedNodeIdx], indicesRef, leftChildIdx, &leftChildSubset, &rightChildSubset);
+        SplitDocsSubset(
+            subsetsForLeafs[splittedNodeIdx],
+            indicesRef,
+            leftChildIdx,
+            ctx->LocalExecutor,
+            &leftChildSubset,
+            &rightChildSubset);
         subsetsForLeafs[leftChildIdx] = std::move(leftChildSubset);
         subsetsForLeafs[rightChildIdx] = std::move(rightChildSubset);
 
@@ -1374,6 +1445,8 @@ static TNonSymmetricTreeStructure GreedyTensorSearchDepthwise(
 
     const bool isSamplingPerTree = IsSamplingPerTree(ctx->Params.ObliviousTreeOptions);
 
+    ctx->LeafSubsetKeys.StartTree();
+
     TVector<TIndexType> curLevelLeafs = {0};
     for (ui32 curDepth = 0; curDepth < ctx->Params.ObliviousTreeOptions->MaxDepth; ++curDepth) {
         TVector<TCandidatesContext> candidatesContexts = SelectFeaturesForScoring(data, {}, fold, ctx);
@@ -1424,6 +1497,7 @@ static TNonSymmetricTreeStructure GreedyTensorSearchDepthwise(
             const auto& node = currentStructure.AddSplit(bestSplit, leafToSplit);
             const TIndexType leftChildIdx = ~node.Left;
             const TIndexType rightChildIdx = ~node.Right;
+            ctx->LeafSubsetKeys.Split(leafToSplit, leftChildIdx, rightChildIdx);
             splittedLeafs.push_back(leafToSplit);
             nextLevelLeafs.push_back(leftChildIdx);
             nextLevelLeafs.push_back(rightChildIdx);
@@ -1439,7 +1513,13 @@ static TNonSymmetricTreeStructure GreedyTensorSearchDepthwise(
 
             TIndexedSubset<ui32> leftChildSubset, rightChildSubset;
             Y_ASSERT(leftChildIdx == leafToSplit);
-            SplitDocsSubset(subsetsForLeafs[leafToSplit], indicesRef, leftChildIdx, &leftChildSubset, &rightChildSubset);
+            SplitDocsSubset(
+                subsetsForLeafs[leafToSplit],
+                indicesRef,
+                leftChildIdx,
+                ctx->LocalExecutor,
+                &leftChildSubset,
+                &rightChildSubset);
             subsetsForLeafs[leftChildIdx] = std::move(leftChildSubset);
             subsetsForLeafs[rightChildIdx] = std::move(rightChildSubset);
         }
@@ -1469,10 +1549,12 @@ void GreedyTensorSearch(
     TLearnContext* ctx,
     TVariant<TSplitTree, TNonSymmetricTreeStructure>* resTreeStructure) {
 
-    TrimOnlineCTRcache({fold});
+    TrimOnlineCTRcache({fold}, *ctx);
 
     ui32 learnSampleCount = data.Learn->ObjectsData->GetObjectCount();
-    TVector<TIndexType> indices(learnSampleCount); // always for all documents
+    TVector<TIndexType>& indices = ctx->TreeSearchIndices; // always for all documents
+    indices.assign(learnSampleCount, 0);
+    ctx->TreeSearchIndicesFold = nullptr;
 
     if (!ctx->Params.SystemOptions->IsSingleHost()) {
         MapTensorSearchStart(ctx);
@@ -12,7 +12,7 @@ struct TSplitTree;
 struct TNonSymmetricTreeStructure;
 
 
-void TrimOnlineCTRcache(const TVector<TFold*>& folds);
+void TrimOnlineCTRcache(const TVector<TFold*>& folds, const TLearnContext& ctx);
 
 void GreedyTensorSearch(
     const NCB::TTrainingDataProviders& data,
@@ -1,5 +1,6 @@
 #include "helpers.h"
 
+#include "approx_updater_helpers.h"
 #include "learn_context.h"
 
 #include <catboost/libs/data/quantized_features_info.h>
@@ -215,6 +216,9 @@ void CalcErrors(
             TMaybe<int> trackerIdx = calcErrorTrackerMetric ? TMaybe<int>(0) : Nothing();
             TMaybe<int> filteredTrackerIdx;
             auto testMetrics = FilterTestMetrics(errors, calcAllMetrics, maybeTarget.Defined(), trackerIdx, &filteredTrackerIdx);
+            if (!testMetrics.empty()) {
+                ApplyPendingTestApproxUpdates(trainingDataProviders, ctx);
+            }
 
             auto errors = EvalErrorsWithCaching(
                 ctx->LearnProgress->TestApprox[testIdx],
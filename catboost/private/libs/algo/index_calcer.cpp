@@ -10,6 +10,7 @@
 
 #include <catboost/libs/cat_feature/cat_feature.h>
 #include <catboost/libs/data/model_dataset_compatibility.h>
+#include <catboost/libs/data/sparse_columns.h>
 #include <catboost/libs/helpers/dense_hash.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/model/cpu/evaluator.h>
@@ -133,6 +134,7 @@ inline void UpdateIndicesForSplit(
 template <typename TColumn, class TCmpOp>
 inline void ScheduleUpdateIndicesForSplit(
     const ui32* columnIndexingPtr, // can be nullptr
+    const TFeaturesArraySubsetIndexing& featuresArraySubsetIndexing,
     const TColumn& column,
     TCmpOp cmpOp,
     int level,
@@ -172,6 +174,52 @@ inline void ScheduleUpdateIndicesForSplit(
                         }
                     });
             });
+    } else if (const auto* sparseColumnData
+                   = dynamic_cast<const TSparseCompressedValuesHolderImpl<TColumn>*>(&column))
+    {
+        /* values are extracted only for the selected split, scoring uses non-default values only
+         * sparse columns are indexed by objects, so values are placed to features buckets arrays indices
+         * to be used with columnIndexingPtr like dense columns data
+         */
+        const auto& sparseArray = sparseColumnData->GetData();
+        const TVector<typename TColumn::TValueType> objectValues = sparseArray.ExtractValues();
+        ui32 srcSize = 0;
+        featuresArraySubsetIndexing.ForEach(
+            [&] (ui32 /*idx*/, ui32 srcIdx) { srcSize = Max(srcSize, srcIdx + 1); }
+        );
+        auto values = MakeAtomicShared<TVector<typename TColumn::TValueType>>(
+            srcSize,
+            sparseArray.GetDefaultValue()
+        );
+        featuresArraySubsetIndexing.ForEach(
+            [&] (ui32 idx, ui32 srcIdx) { (*values)[srcIdx] = objectValues[idx]; }
+        );
+
+        updateBlockCallbacks->push_back(
+            [columnIndexingPtr,
+             cmpOp,
+             level,
+             indices,
+             values]
+                (TIndexRange<ui32> indexRange) {
+
+                if (columnIndexingPtr) {
+                    UpdateIndicesForSplit(
+                        columnIndexingPtr,
+                        values->data(),
+                        indexRange,
+                        cmpOp,
+                        level,
+                        indices);
+                } else {
+                    UpdateIndicesForSplit(
+                        values->data(),
+                        indexRange,
+                        cmpOp,
+                        level,
+                        indices);
+                }
+            });
     } else {
         CB_ENSURE_INTERNAL(false, "UpdateIndicesForSplit: unsupported column type");
     }
@@ -185,6 +233,7 @@ void ScheduleUpdateIndicesForSplit(
     TMaybe<TFeaturesGroupIndex> maybeFeaturesGroupIndex,
     TConstArrayRef<TExclusiveFeaturesBundle> exclusiveFeaturesBundlesMetaData,
     const ui32* columnIndexing,  // can be nullptr
+    const TFeaturesArraySubsetIndexing& featuresArraySubsetIndexing,
     const TColumn& column,
     std::function<const IExclusiveFeatureBundleArray*(ui32)>&& getExclusiveFeaturesBundle,
     std::function<const IBinaryPacksArray*(ui32)>&& getBinaryFeaturesPack,
@@ -197,6 +246,7 @@ void ScheduleUpdateIndicesForSplit(
     auto scheduleUpdateIndicesForSplit = [&] (const auto& column, auto&& cmpOp) {
         ScheduleUpdateIndicesForSplit(
             columnIndexing,
+            featuresArraySubsetIndexing,
             column,
             std::move(cmpOp),
             level,
@@ -374,6 +424,7 @@ static void UpdateIndices(
                     maybeFeaturesGroupIndex,
                     objectsDataProvider->GetExclusiveFeatureBundlesMetaData(),
                     columnIndexing,
+                    objectsDataProvider->GetFeaturesArraySubsetIndexing(),
                     column,
                     [&] (ui32 bundleIdx) {
                         return &objectsDataProvider->GetExclusiveFeaturesBundle(bundleIdx);
@@ -0,0 +1,122 @@
+#include "init_model_approxes_cache.h"
+
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/logging/logging.h>
+
+#include <util/folder/path.h>
+#include <util/generic/algorithm.h>
+#include <util/stream/file.h>
+#include <util/system/fs.h>
+#include <util/system/guard.h>
+
+#include <algorithm>
+#include <iterator>
+
+
+using namespace NCB;
+
+
+static const TString CacheFileMagic = "CBInitModelApproxes";
+static constexpr ui32 CacheFileVersion = 1;
+
+
+TInitModelApproxesCache::TInitModelApproxesCache(const TString& path, ui32 modelCheckSum)
+    : Path(path)
+    , ModelCheckSum(modelCheckSum)
+{
+    if (Path && NFs::Exists(Path)) {
+        Load();
+    }
+}
+
+void TInitModelApproxesCache::Load() {
+    try {
+        TIFStream in(Path);
+        TString magic;
+        ui32 version;
+        ui32 modelCheckSum;
+        ::Load(&in, magic);
+        ::Load(&in, version);
+        CB_ENSURE(magic == CacheFileMagic && version == CacheFileVersion, "unsupported file format");
+        ::Load(&in, modelCheckSum);
+        if (modelCheckSum != ModelCheckSum) {
+            CATBOOST_INFO_LOG << "Init model approxes cache " << Path << " was created for another model, ignore it"
+                << Endl;
+            return;
+        }
+        ::Load(&in, Entries);
+    } catch (const std::exception& e) {
+        CATBOOST_WARNING_LOG << "Failed to load init model approxes cache " << Path << ": " << e.what() << Endl;
+        Entries.clear();
+    }
+}
+
+TVector<TVector<double>> TInitModelApproxesCache::GetOrCalc(
+    const TObjectsDataProvider& objectsData,
+    const TCalcApproxFunction& calcApprox,
+    NPar::TLocalExecutor* localExecutor
+) {
+    const auto* quantizedObjectsData = dynamic_cast<const TQuantizedObjectsDataProvider*>(&objectsData);
+    if (!Path || !quantizedObjectsData) {
+        return calcApprox(objectsData);
+    }
+
+    const ui32 featuresCheckSum = quantizedObjectsData->CalcFeaturesCheckSum(localExecutor);
+    const ui32 objectCount = objectsData.GetObjectCount();
+    const auto isSameDataset = [=] (const TEntry& entry) {
+        return (entry.FeaturesCheckSum == featuresCheckSum) && (entry.ObjectCount == objectCount);
+    };
+
+    with_lock (Lock) {
+        auto* entry = FindIfPtr(Entries, isSameDataset);
+        if (entry) {
+            CATBOOST_DEBUG_LOG << "Init model approxes for " << objectCount << " objects are loaded from cache\n";
+            entry->IsUsed = true;
+            return entry->Approx;
+        }
+    }
+
+    TEntry entry;
+    entry.FeaturesCheckSum = featuresCheckSum;
+    entry.ObjectCount = objectCount;
+    entry.Approx = calcApprox(objectsData);
+    entry.IsUsed = true;
+
+    with_lock (Lock) {
+        // the same dataset could have been passed as learn and eval data
+        if (!FindIfPtr(Entries, isSameDataset)) {
+            Entries.push_back(entry);
+            IsChanged = true;
+        }
+    }
+    return std::move(entry.Approx);
+}
+
+void TInitModelApproxesCache::SaveIfChanged() const {
+    if (!IsChanged) {
+        return;
+    }
+
+    TVector<TEntry> usedEntries;
+    std::copy_if(Entries.begin(), Entries.end(), std::back_inserter(usedEntries), [] (const TEntry& entry) {
+        return entry.IsUsed;
+    });
+
+    // the cache is optional, so failure to write it does not stop training
+    try {
+        // write to a temporary file first so that interrupted writing does not leave a broken cache
+        const TString tmpPath = Path + ".tmp";
+        {
+            TOFStream out(tmpPath);
+            ::Save(&out, CacheFileMagic);
+            ::Save(&out, CacheFileVersion);
+            ::Save(&out, ModelCheckSum);
+            ::Save(&out, usedEntries);
+            out.Finish();
+        }
+        TFsPath(tmpPath).ForceRenameTo(Path);
+        CATBOOST_DEBUG_LOG << "Init model approxes cache is saved to " << Path << Endl;
+    } catch (const std::exception& e) {
+        CATBOOST_WARNING_LOG << "Failed to save init model approxes cache " << Path << ": " << e.what() << Endl;
+    }
+}
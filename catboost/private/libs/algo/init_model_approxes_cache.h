@@ -0,0 +1,59 @@
+#pragma once
+
+#include <catboost/libs/data/objects.h>
+
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/system/spinlock.h>
+#include <util/system/types.h>
+#include <util/ysaveload.h>
+
+#include <functional>
+
+
+/* Approxes of the init model on datasets, stored in a file so that training continuation from the same model
+ * on the same quantized datasets does not apply the whole init model again.
+ * Entries are identified by the init model checksum and by features checksum and object count of datasets.
+ * Datasets that are not quantized are not cached.
+ */
+class TInitModelApproxesCache {
+public:
+    using TCalcApproxFunction = std::function<TVector<TVector<double>>(const NCB::TObjectsDataProvider&)>;
+
+public:
+    // empty path disables the cache
+    TInitModelApproxesCache(const TString& path, ui32 modelCheckSum);
+
+    // thread-safe
+    TVector<TVector<double>> GetOrCalc(
+        const NCB::TObjectsDataProvider& objectsData,
+        const TCalcApproxFunction& calcApprox,
+        NPar::TLocalExecutor* localExecutor);
+
+    // rewrites the file with entries used in this run if some approxes have been calculated
+    void SaveIfChanged() const;
+
+private:
+    struct TEntry {
+        ui32 FeaturesCheckSum = 0;
+        ui32 ObjectCount = 0;
+        TVector<TVector<double>> Approx;
+
+        bool IsUsed = false; // not serialized
+
+    public:
+        Y_SAVELOAD_DEFINE(FeaturesCheckSum, ObjectCount, Approx);
+    };
+
+private:
+    void Load();
+
+private:
+    TString Path;
+    ui32 ModelCheckSum;
+    bool IsChanged = false;
+    TVector<TEntry> Entries;
+    TAdaptiveLock Lock;
+};
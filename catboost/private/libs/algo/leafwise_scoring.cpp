@@ -341,8 +341,7 @@ static void CalcScoresForSubCandidate(
             updateSplitScoreClosure);
     };
 
-    // TODO(ilyzhin) make caching for nonsymmetric trees
-    if (!ctx->UseTreeLevelCaching() || ctx->Params.ObliviousTreeOptions->GrowPolicy != EGrowPolicy::SymmetricTree) {
+    if (!ctx->UseTreeLevelCaching()) {
         TVector<TBucketStats> stats;
         stats.yresize(bucketCount);
 
@@ -358,6 +357,76 @@ static void CalcScoresForSubCandidate(
                 calcScores(stats);
             }
         }
+    } else if (ctx->Params.ObliviousTreeOptions->GrowPolicy != EGrowPolicy::SymmetricTree) {
+        /* Stats of a split leaf are kept until the stats of its children are needed,
+         * then only the smaller child is scanned and the stats of the larger one are obtained by subtraction.
+         */
+        const auto& leafSubsetKeys = ctx->LeafSubsetKeys;
+        const int maxLeafCount = GetMaxLeafCount(ctx->Params.ObliviousTreeOptions);
+        TVector<ui64>* cachedLeafKeys;
+        TVector<TBucketStats, TPoolAllocator>& stats = ctx->PrevTreeLevelStats.GetLeafwiseStats(
+            candidateInfo.SplitEnsemble,
+            bucketCount * maxLeafCount,
+            maxLeafCount,
+            &cachedLeafKeys);
+
+        const auto getLeafStats = [&] (TIndexType leaf, int dim) {
+            return TArrayRef<TBucketStats>(
+                GetDataPtr(stats, bucketCount * (leaf * approxDimension + dim)),
+                bucketCount);
+        };
+
+        TVector<TBucketStats> smallChildStats;
+        for (auto leaf : leafs) {
+            const auto leafKey = leafSubsetKeys.Keys[leaf];
+            if ((*cachedLeafKeys)[leaf] != leafKey) {
+                const auto parentLeaf = leafSubsetKeys.ParentLeafs[leaf];
+                const auto parentKey = leafSubsetKeys.ParentKeys[leaf];
+                if ((parentKey != 0) && ((*cachedLeafKeys)[parentLeaf] == parentKey)) {
+                    const auto sibling = leafSubsetKeys.Siblings[leaf];
+                    const bool isLeafSmaller
+                        = fold.LeavesBounds[leaf].GetSize() < fold.LeavesBounds[sibling].GetSize();
+                    const auto smallChild = isLeafSmaller ? leaf : sibling;
+                    const auto largeChild = isLeafSmaller ? sibling : leaf;
+                    const auto smallChildBounds = fold.LeavesBounds[smallChild];
+
+                    if (!smallChildBounds.Empty()) {
+                        extractBucketIndex(smallChildBounds);
+                    }
+                    smallChildStats.yresize(bucketCount);
+                    for (int dim : xrange(approxDimension)) {
+                        calcStats(smallChildBounds, dim, smallChildStats);
+                        // parent stats share the storage with one of the children, so read them first
+                        const auto parentStats = getLeafStats(parentLeaf, dim);
+                        const auto smallChildStatsRef = getLeafStats(smallChild, dim);
+                        const auto largeChildStatsRef = getLeafStats(largeChild, dim);
+                        for (auto bucket : xrange(bucketCount)) {
+                            TBucketStats largeChildBucketStats = parentStats[bucket];
+                            largeChildBucketStats.Remove(smallChildStats[bucket]);
+                            largeChildStatsRef[bucket] = largeChildBucketStats;
+                            smallChildStatsRef[bucket] = smallChildStats[bucket];
+                        }
+                    }
+                    (*cachedLeafKeys)[sibling] = leafSubsetKeys.Keys[sibling];
+                } else {
+                    const auto leafBounds = fold.LeavesBounds[leaf];
+                    if (!leafBounds.Empty()) {
+                        extractBucketIndex(leafBounds);
+                    }
+                    for (int dim : xrange(approxDimension)) {
+                        calcStats(leafBounds, dim, getLeafStats(leaf, dim));
+                    }
+                }
+                (*cachedLeafKeys)[leaf] = leafKey;
+            }
+
+            if (fold.LeavesBounds[leaf].Empty()) {
+                continue;
+            }
+            for (int dim : xrange(approxDimension)) {
+                calcScores(getLeafStats(leaf, dim));
+            }
+        }
     } else { /* UseTreeLevelCaching */
         bool areStatsDirty;
         int maxStatsCount = bucketCount * (1 << ctx->Params.ObliviousTreeOptions->MaxDepth);
@@ -79,17 +79,37 @@ inline void CalcScoresForLeaf(
             break;
         case ESplitEnsembleType::BinarySplits:
         {
-            int binaryFeaturesCount = (int)GetValueBitCount(bucketCount - 1);
-            for (int binFeatureIdx = 0; binFeatureIdx < binaryFeaturesCount; ++binFeatureIdx) {
-                TBucketStats trueStats{0, 0, 0, 0};
-                TBucketStats falseStats{0, 0, 0, 0};
+            /* Stats for all binary features of the pack are computed in one pass over halves of the
+             * pack values histogram: the highest bit divides it into false and true halves, then halves
+             * are merged and the next bit is processed in the same way.
+             * So it takes O(bucketCount) operations instead of O(bucketCount * binaryFeaturesCount).
+             */
+            constexpr int maxBinaryFeaturesCount = sizeof(NCB::TBinaryFeaturesPack) * CHAR_BIT;
 
-                for (int bucketIdx = 0; bucketIdx < bucketCount; ++bucketIdx) {
-                    auto& dstStats = ((bucketIdx >> binFeatureIdx) & 1) ? trueStats : falseStats;
-                    dstStats.Add(getBucketStats(bucketIdx));
+            const int binaryFeaturesCount = (int)GetValueBitCount(bucketCount - 1);
+            Y_ASSERT(binaryFeaturesCount <= maxBinaryFeaturesCount);
+
+            TBucketStats packStats[1 << maxBinaryFeaturesCount];
+            for (int bucketIdx = 0; bucketIdx < bucketCount; ++bucketIdx) {
+                packStats[bucketIdx] = getBucketStats(bucketIdx);
+            }
+            Fill(packStats + bucketCount, packStats + (1 << binaryFeaturesCount), TBucketStats{0, 0, 0, 0});
+
+            TBucketStats trueStats[maxBinaryFeaturesCount];
+            TBucketStats falseStats[maxBinaryFeaturesCount];
+            for (int binFeatureIdx = binaryFeaturesCount - 1; binFeatureIdx >= 0; --binFeatureIdx) {
+                const int halfSize = 1 << binFeatureIdx;
+                trueStats[binFeatureIdx] = TBucketStats{0, 0, 0, 0};
+                falseStats[binFeatureIdx] = TBucketStats{0, 0, 0, 0};
+                for (int bucketIdx = 0; bucketIdx < halfSize; ++bucketIdx) {
+                    falseStats[binFeatureIdx].Add(packStats[bucketIdx]);
+                    trueStats[binFeatureIdx].Add(packStats[halfSize + bucketIdx]);
+                    packStats[bucketIdx].Add(packStats[halfSize + bucketIdx]);
                 }
+            }
 
-                updateSplitScore(trueStats, falseStats, binFeatureIdx);
+            for (int binFeatureIdx = 0; binFeatureIdx < binaryFeaturesCount; ++binFeatureIdx) {
+                updateSplitScore(trueStats[binFeatureIdx], falseStats[binFeatureIdx], binFeatureIdx);
             }
         }
             break;
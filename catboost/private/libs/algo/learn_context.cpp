@@ -6,6 +6,7 @@
 #include "calc_score_cache.h"
 
 #include "helpers.h"
+#include "init_model_approxes_cache.h"
 #include "online_ctr.h"
 
 #include <catboost/libs/helpers/checksum.h>
@@ -17,6 +18,7 @@
 #include <catboost/private/libs/distributed/master.h>
 #include <catboost/private/libs/index_range/index_range.h>
 #include <catboost/private/libs/options/defaults_helper.h>
+#include <catboost/private/libs/options/system_options.h>
 
 #include <library/cpp/digest/crc32c/crc32c.h>
 #include <library/cpp/digest/md5/md5.h>
@@ -28,8 +30,11 @@
 #include <util/generic/guid.h>
 #include <util/generic/xrange.h>
 #include <util/folder/path.h>
+#include <util/generic/buffer.h>
+#include <util/stream/buffer.h>
 #include <util/stream/file.h>
 #include <util/system/fs.h>
+#include <util/system/info.h>
 
 
 using namespace NCB;
@@ -348,6 +353,7 @@ TLearnContext::TLearnContext(
             params.ObliviousTreeOptions.Get(),
             initModel,
             initModelApplyCompatiblePools,
+            outputOptions.GetInitModelApproxesCachePath(),
             LocalExecutor
         );
     }
@@ -355,11 +361,16 @@ TLearnContext::TLearnContext(
     LearnProgress->EnableSaveLoadApprox = Params.SystemOptions->IsSingleHost();
 
     const ui32 maxBodyTailCount = Max(1, GetMaxBodyTailCount(LearnProgress->Folds));
-    UseTreeLevelCachingFlag = NeedToUseTreeLevelCaching(Params, maxBodyTailCount, LearnProgress->ApproxDimension);
+    UseTreeLevelCachingFlag = NeedToUseTreeLevelCaching(
+        Params,
+        maxBodyTailCount,
+        LearnProgress->ApproxDimension,
+        data);
 }
 
 
 TLearnContext::~TLearnContext() {
+    WaitForSnapshotWriting();
     if (Params.SystemOptions->IsMaster()) {
         FinalizeMaster(this);
     }
@@ -369,15 +380,45 @@ void TLearnContext::SaveProgress(std::function<void(IOutputStream*)> onSaveSnaps
     if (!OutputOptions.SaveSnapshot()) {
         return;
     }
-    const auto snapshotBackup = Files.SnapshotFile + ".bak";
-    TProgressHelper(ToString(ETaskType::CPU)).Write(
-        snapshotBackup,
-        [&](IOutputStream* out) {
-            onSaveSnapshot(out);
-            ::SaveMany(out, *LearnProgress, Profile.DumpProfileInfo());
+    TBuffer snapshot(LastSnapshotSize);
+    {
+        TBufferOutput out(snapshot);
+        onSaveSnapshot(&out);
+        ::SaveMany(&out, *LearnProgress, Profile.DumpProfileInfo());
+    }
+    LastSnapshotSize = snapshot.Size();
+
+    WaitForSnapshotWriting();
+    SnapshotWritingInProgress = true;
+    SnapshotWritingThread = SystemThreadFactory()->Run(
+        [snapshot = std::move(snapshot), snapshotFile = Files.SnapshotFile, inProgress = &SnapshotWritingInProgress] () {
+            const auto snapshotBackup = snapshotFile + ".bak";
+            TProgressHelper(ToString(ETaskType::CPU)).Write(
+                snapshotBackup,
+                [&](IOutputStream* out) {
+                    out->Write(snapshot.Data(), snapshot.Size());
+                }
+            );
+            try {
+                TFsPath(snapshotBackup).ForceRenameTo(snapshotFile);
+            } catch (...) {
+                CATBOOST_WARNING_LOG << "Can't save progress to file " << snapshotFile
+                    << ", got exception: " << CurrentExceptionMessage() << Endl;
+            }
+            *inProgress = false;
         }
     );
-    TFsPath(snapshotBackup).ForceRenameTo(Files.SnapshotFile);
+}
+
+bool TLearnContext::IsSnapshotWritingInProgress() const {
+    return SnapshotWritingInProgress;
+}
+
+void TLearnContext::WaitForSnapshotWriting() {
+    if (SnapshotWritingThread) {
+        SnapshotWritingThread->Join();
+        SnapshotWritingThread.Reset();
+    }
 }
 
 bool TLearnContext::TryLoadProgress(std::function<bool(IInputStream*)> onLoadSnapshot) {
@@ -454,6 +495,7 @@ TLearnProgress::TLearnProgress(
     const NCatboostOptions::TObliviousTreeLearnerOptions& trainOptions,
     TMaybe<TFullModel*> initModel,
     NCB::TDataProviders initModelApplyCompatiblePools,
+    const TString& initModelApproxesCachePath,
     NPar::TLocalExecutor* localExecutor)
     : StartingApprox(foldsCreationParams.StartingApprox)
     , FoldCreationParamsCheckSum(foldCreationParamsCheckSum)
@@ -504,6 +546,7 @@ TLearnProgress::TLearnProgress(
                     StartingApprox,
                     estimatedFeaturesQuantizationOptions,
                     onlineEstimatedQuantizedFeaturesInfo,
+                    /*precalculatedOnlineEstimatedFeatures*/ nullptr,
                     &Rand,
                     localExecutor
                 )
@@ -530,6 +573,7 @@ TLearnProgress::TLearnProgress(
                     StartingApprox,
                     estimatedFeaturesQuantizationOptions,
                     onlineEstimatedQuantizedFeaturesInfo,
+                    /*precalculatedOnlineEstimatedFeatures*/ nullptr,
                     &Rand,
                     localExecutor
                 )
@@ -544,6 +588,11 @@ TLearnProgress::TLearnProgress(
         }
     }
 
+    /* the first learning fold is never shuffled, so if averaging fold is not shuffled too
+     * they have the same (trivial) learn permutation and the same online estimated features
+     */
+    const bool isSameAsFirstLearningFoldPermutation = !Folds.empty() && !foldsCreationParams.IsAverageFoldPermuted;
+
     AveragingFold = TFold::BuildPlainFold(
         data,
         targetClassifiers,
@@ -555,6 +604,7 @@ TLearnProgress::TLearnProgress(
         StartingApprox,
         estimatedFeaturesQuantizationOptions,
         onlineEstimatedQuantizedFeaturesInfo,
+        isSameAsFirstLearningFoldPermutation ? &Folds[0].GetOnlineEstimatedFeatures() : nullptr,
         &Rand,
         localExecutor
     );
@@ -610,6 +660,7 @@ TLearnProgress::TLearnProgress(
             initModelApplyCompatiblePools,
             foldsCreationParams.IsOrderedBoosting,
             foldsCreationParams.StoreExpApproxes,
+            initModelApproxesCachePath,
             localExecutor
         );
     }
@@ -638,6 +689,7 @@ void TLearnProgress::SetSeparateInitModel(
     const TDataProviders& initModelApplyCompatiblePools,
     bool isOrderedBoosting,
     bool storeExpApproxes,
+    const TString& initModelApproxesCachePath,
     NPar::TLocalExecutor* localExecutor) {
 
     CATBOOST_DEBUG_LOG << "TLearnProgress::SetSeparateInitModel\n";
@@ -647,13 +699,21 @@ void TLearnProgress::SetSeparateInitModel(
 
     // Calc approxes
 
+    TInitModelApproxesCache approxesCache(initModelApproxesCachePath, SeparateInitModelCheckSum);
+
     auto calcApproxFunction = [&] (const TObjectsDataProvider& objectsData) -> TVector<TVector<double>> {
-        return ApplyModelMulti(
-            initModel,
+        return approxesCache.GetOrCalc(
             objectsData,
-            EPredictionType::RawFormulaVal,
-            0,
-            SafeIntegerCast<int>(initModel.GetTreeCount()),
+            [&] (const TObjectsDataProvider& datasetObjectsData) {
+                return ApplyModelMulti(
+                    initModel,
+                    datasetObjectsData,
+                    EPredictionType::RawFormulaVal,
+                    0,
+                    SafeIntegerCast<int>(initModel.GetTreeCount()),
+                    localExecutor
+                );
+            },
             localExecutor
         );
     };
@@ -708,6 +768,8 @@ void TLearnProgress::SetSeparateInitModel(
     }
 
     ExecuteTasksInParallel(&tasks, localExecutor);
+
+    approxesCache.SaveIfChanged();
 }
 
 void TLearnProgress::PrepareForContinuation() {
@@ -815,15 +877,79 @@ bool TLearnContext::GetHasWeights() const {
     return HasWeights;
 }
 
+NCB::TMemoryUsageReport TLearnContext::GetMemoryUsageReport() const {
+    const auto& folds = LearnProgress->Folds;
+    ui64 foldBuffersUsage = LearnProgress->AveragingFold.GetBuffersMemoryUsage();
+    ui64 onlineCtrUsage = LearnProgress->AveragingFold.GetOnlineCtrMemoryUsage();
+    for (const auto& fold : folds) {
+        foldBuffersUsage += fold.GetBuffersMemoryUsage();
+        onlineCtrUsage += fold.GetOnlineCtrMemoryUsage();
+    }
+
+    const auto getCapacityInBytes = [] (const TVector<TVector<double>>& approx) {
+        ui64 usage = 0;
+        for (const auto& dimApprox : approx) {
+            usage += dimApprox.capacity() * sizeof(double);
+        }
+        return usage;
+    };
+    ui64 approxUsage = getCapacityInBytes(LearnProgress->AvrgApprox) + getCapacityInBytes(LearnProgress->BestTestApprox);
+    for (const auto& testApprox : LearnProgress->TestApprox) {
+        approxUsage += getCapacityInBytes(testApprox);
+    }
+
+    ui64 modelUsage = 0;
+    for (const auto& treeLeafValues : LearnProgress->LeafValues) {
+        modelUsage += getCapacityInBytes(treeLeafValues);
+    }
+
+    NCB::TMemoryUsageReport report;
+    report.Add("fold buffers", foldBuffersUsage);
+    report.Add("approxes", approxUsage);
+    report.Add("online ctrs", onlineCtrUsage);
+    report.Add("bucket stats cache", PrevTreeLevelStats.GetMemoryUsage());
+    report.Add("model leaf values", modelUsage);
+    return report;
+}
+
 bool NeedToUseTreeLevelCaching(
     const NCatboostOptions::TCatBoostOptions& params,
     ui32 maxBodyTailCount,
-    ui32 approxDimension) {
+    ui32 approxDimension,
+    const NCB::TTrainingDataProviders& data) {
 
-    const ui32 maxLeafCount = 1 << params.ObliviousTreeOptions->MaxDepth;
     // TODO(nikitxskv): Pairwise scoring doesn't use statistics from previous tree level. Need to fix it.
-    return (
-        IsSamplingPerTree(params.ObliviousTreeOptions) &&
-        !IsPairwiseScoring(params.LossFunctionDescription->GetLossFunction()) &&
-        maxLeafCount * approxDimension * maxBodyTailCount < 64 * 1 * 10);
+    if (!IsSamplingPerTree(params.ObliviousTreeOptions) ||
+        IsPairwiseScoring(params.LossFunctionDescription->GetLossFunction()))
+    {
+        return false;
+    }
+
+    const ui64 maxLeafCount = GetMaxLeafCount(params.ObliviousTreeOptions);
+    const ui64 statsCountPerBucket = maxLeafCount * approxDimension * maxBodyTailCount;
+    if (statsCountPerBucket < 64 * 1 * 10) {
+        return true;
+    }
+
+    /* For deep trees stats of the larger split side are still cheaper to get by subtraction
+     * while the size of feature stats is less than the number of objects scanned instead,
+     * but the cache of stats for all features must fit in memory.
+     */
+    const auto& objectsData = *data.Learn->ObjectsData;
+    const auto& featuresLayout = *objectsData.GetFeaturesLayout();
+    const ui64 nonCtrBucketCount = CountNonCtrBuckets(
+        featuresLayout,
+        *objectsData.GetQuantizedFeaturesInfo(),
+        params.CatFeatureParams->OneHotMaxSize.Get());
+    const ui64 featureCount = Max<ui64>(
+        1,
+        featuresLayout.GetFloatFeatureCount() + featuresLayout.GetCatFeatureCount());
+
+    const ui64 statsCacheSize = sizeof(TBucketStats) * nonCtrBucketCount * statsCountPerBucket;
+    const ui64 statsCacheSizeLimit = Min<ui64>(
+        ParseMemorySizeDescription(params.SystemOptions->CpuUsedRamLimit.Get()),
+        NSystemInfo::TotalMemorySize()) / 4;
+
+    return (nonCtrBucketCount * maxLeafCount < featureCount * objectsData.GetObjectCount())
+        && (statsCacheSize <= statsCacheSizeLimit);
 }
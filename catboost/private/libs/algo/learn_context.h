@@ -9,6 +9,7 @@
 #include <catboost/private/libs/algo_helpers/custom_objective_descriptor.h>
 #include <catboost/libs/data/data_provider.h>
 #include <catboost/libs/data/features_layout.h>
+#include <catboost/libs/helpers/mem_usage.h>
 #include <catboost/libs/helpers/restorable_rng.h>
 #include <catboost/private/libs/labels/label_converter.h>
 #include <catboost/libs/loggers/catboost_logger_helpers.h>
@@ -24,6 +25,9 @@
 #include <util/generic/noncopyable.h>
 #include <util/generic/hash_set.h>
 #include <util/generic/ptr.h>
+#include <util/thread/factory.h>
+
+#include <atomic>
 
 
 namespace NPar {
@@ -132,6 +136,7 @@ public:
         const NCatboostOptions::TObliviousTreeLearnerOptions& trainOptions,
         TMaybe<TFullModel*> initModel,
         NCB::TDataProviders initModelApplyCompatiblePools,
+        const TString& initModelApproxesCachePath, // empty if init model approxes are not cached
         NPar::TLocalExecutor* localExecutor);
 
     // call after fold initizalization
@@ -140,6 +145,7 @@ public:
         const NCB::TDataProviders& initModelApplyCompatiblePools,
         bool isOrderedBoosting,
         bool storeExpApproxes,
+        const TString& initModelApproxesCachePath,
         NPar::TLocalExecutor* localExecutor);
 
     void PrepareForContinuation();
@@ -205,11 +211,19 @@ public:
 
     ~TLearnContext();
 
+    /* snapshot is serialized to memory synchronously and written to the file in background,
+     * so training continues while the file is written
+     */
     void SaveProgress(std::function<void(IOutputStream*)> onSaveSnapshot = [] (IOutputStream* /*snapshot*/) {});
+    void WaitForSnapshotWriting();
+    bool IsSnapshotWritingInProgress() const;
     bool TryLoadProgress(std::function<bool(IInputStream*)> onLoadSnapshot = [] (IInputStream* /*snapshot*/) { return true; });
     bool UseTreeLevelCaching() const;
     bool GetHasWeights() const;
 
+    // approximate memory used by folds, their online ctrs, stats cache and trained model
+    NCB::TMemoryUsageReport GetMemoryUsageReport() const;
+
 public:
     THolder<TLearnProgress> LearnProgress;
     NCatboostOptions::TOutputFilesOptions OutputOptions;
@@ -218,14 +232,29 @@ public:
     TCalcScoreFold SmallestSplitSideDocs;
     TCalcScoreFold SampledDocs;
     TBucketStatsCache PrevTreeLevelStats;
+    TLeafSubsetKeys LeafSubsetKeys; // for stats caching in non-symmetric trees
+
+    // leaf indices of learn objects in GreedyTensorSearch, kept to avoid reallocation for each tree
+    TVector<TIndexType> TreeSearchIndices;
+    // fold for which TreeSearchIndices match the symmetric tree found by the last GreedyTensorSearch, if any
+    const TFold* TreeSearchIndicesFold = nullptr;
+
+    /* number of last trees in LearnProgress->TreeStruct not yet applied to LearnProgress->TestApprox,
+     * test approxes are updated lazily only when they are needed (see ApplyPendingTestApproxUpdates)
+     */
+    size_t PendingTestApproxTreeCount = 0;
     TProfileInfo Profile;
 
 private:
     bool UseTreeLevelCachingFlag;
     bool HasWeights;
+    THolder<IThreadFactory::IThread> SnapshotWritingThread;
+    std::atomic<bool> SnapshotWritingInProgress = false;
+    size_t LastSnapshotSize = 0;
 };
 
 bool NeedToUseTreeLevelCaching(
     const NCatboostOptions::TCatBoostOptions& params,
     ui32 maxBodyTailCount,
-    ui32 approxDimension);
+    ui32 approxDimension,
+    const NCB::TTrainingDataProviders& data);
@@ -9,8 +9,10 @@
 #include <library/cpp/threading/local_executor/local_executor.h>
 
 #include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
 #include <util/generic/utility.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
 
 
@@ -34,38 +36,84 @@ static double CalculateLastIterMeanLeafValue(const TVector<TVector<TVector<doubl
     return sumOverLeaves / numLeaves;
 }
 
-static double CalculateMeanGradValue(const TVector<TConstArrayRef<double>>& derivatives, ui32 cnt, NPar::TLocalExecutor* localExecutor) {
-        NPar::TLocalExecutor::TExecRangeParams blockParams(0, cnt);
-        blockParams.SetBlockCount(CB_THREAD_LIMIT);
-        TVector<double> gradSumInBlock(blockParams.GetBlockCount(), 0.0);
-        localExecutor->ExecRange(
-            [&](ui32 blockId) {
-                const ui32 blockOffset = blockId * blockParams.GetBlockSize();
-                const ui32 blockSize = Min(
-                    static_cast<ui32>(blockParams.GetBlockSize()),
-                    cnt - blockOffset
-                );
-                const ui32 blockFinish = blockOffset + blockSize;
-                for (auto idx = blockOffset; idx < blockFinish; ++idx) {
-                    double grad2 = 0;
-                    for (auto dim : xrange(derivatives.size())) {
-                        const double der = derivatives[dim][idx];
-                        grad2 += der * der;
-                    }
-                    gradSumInBlock[blockId] += sqrt(grad2);
-                }
-            },
-            0,
-            blockParams.GetBlockCount(),
-            NPar::TLocalExecutor::WAIT_COMPLETE
-        );
+static TVector<TDerivativesSegment> GetDerivativesSegments(
+    ui32 sampleCount,
+    EBoostingType boostingType,
+    const TFold& fold) {
+
+    if (boostingType != EBoostingType::Ordered) {
+        return {{0, sampleCount, &fold.BodyTailArr[0].WeightedDerivatives}};
+    }
+    // tail derivatives of each body tail are used, so no copying is needed
+    TVector<TDerivativesSegment> segments;
+    segments.reserve(fold.BodyTailArr.size());
+    for (auto bodyTailId : xrange(fold.BodyTailArr.size())) {
+        const TFold::TBodyTail& bt = fold.BodyTailArr[bodyTailId];
+        const ui32 begin = (bodyTailId == 0) ? 0 : SafeIntegerCast<ui32>(bt.BodyFinish);
+        segments.push_back({begin, SafeIntegerCast<ui32>(bt.TailFinish), &bt.WeightedDerivatives});
+    }
+    return segments;
+}
+
+static void CalcGradientNorms(
+    TConstArrayRef<TDerivativesSegment> segments,
+    double lambda,
+    ui32 begin,
+    TArrayRef<double> norms) {
+
+    const ui32 end = begin + norms.size();
+    Fill(norms.begin(), norms.end(), lambda);
+    for (const auto& segment : segments) {
+        const ui32 segmentBegin = Max(begin, segment.Begin);
+        const ui32 segmentEnd = Min(end, segment.End);
+        if (segmentBegin >= segmentEnd) {
+            continue;
+        }
+        double* __restrict normsData = norms.data() + (segmentBegin - begin);
+        const ui32 count = segmentEnd - segmentBegin;
+        for (const auto& dimDerivatives : *segment.Derivatives) {
+            const double* __restrict derivativesData = dimDerivatives.data() + segmentBegin;
+            for (ui32 idx = 0; idx < count; ++idx) {
+                normsData[idx] += derivativesData[idx] * derivativesData[idx];
+            }
+        }
+    }
+    for (auto& value : norms) {
+        value = sqrt(value);
+    }
+}
+
+double TMvsSampler::CalculateMeanGradValue(
+    TConstArrayRef<TDerivativesSegment> segments,
+    NPar::TLocalExecutor* localExecutor) const {
+
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, SampleCount);
+    blockParams.SetBlockCount(CB_THREAD_LIMIT);
+    TVector<double> gradSumInBlock(blockParams.GetBlockCount(), 0.0);
+    localExecutor->ExecRange(
+        [&](ui32 blockId) {
+            const ui32 blockOffset = blockId * blockParams.GetBlockSize();
+            const ui32 blockFinish = Min(blockOffset + static_cast<ui32>(blockParams.GetBlockSize()), SampleCount);
+            TVector<double> gradNorms;
+            gradNorms.yresize(Min(BlockSize, blockFinish - blockOffset));
+            for (ui32 chunkOffset = blockOffset; chunkOffset < blockFinish; chunkOffset += BlockSize) {
+                const ui32 chunkSize = Min(BlockSize, blockFinish - chunkOffset);
+                TArrayRef<double> chunkNorms(gradNorms.data(), chunkSize);
+                CalcGradientNorms(segments, /*lambda*/ 0.0, chunkOffset, chunkNorms);
+                gradSumInBlock[blockId] += Accumulate(chunkNorms.begin(), chunkNorms.end(), 0.0);
+            }
+        },
+        0,
+        blockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
 
-        const double sumOfGradients = Accumulate(gradSumInBlock.begin(), gradSumInBlock.end(), 0.0);
-        return sumOfGradients / cnt;
+    const double sumOfGradients = Accumulate(gradSumInBlock.begin(), gradSumInBlock.end(), 0.0);
+    return sumOfGradients / SampleCount;
 }
 
 double TMvsSampler::GetLambda(
-    const TVector<TConstArrayRef<double>>& derivatives,
+    TConstArrayRef<TDerivativesSegment> segments,
     const TVector<TVector<TVector<double>>>& leafValues,
     NPar::TLocalExecutor* localExecutor) const {
 
@@ -74,7 +122,7 @@ double TMvsSampler::GetLambda(
     }
     const double mean = (!leafValues.empty())
         ? CalculateLastIterMeanLeafValue(leafValues)
-        : CalculateMeanGradValue(derivatives, SampleCount, localExecutor);
+        : CalculateMeanGradValue(segments, localExecutor);
     return mean * mean;
 }
 
@@ -127,47 +175,8 @@ void TMvsSampler::GenSampleWeights(
     if (SampleRate == 1.0f) {
         Fill(fold->SampleWeights.begin(), fold->SampleWeights.end(), 1.0f);
     } else {
-        const auto approxDimension = fold->GetApproxDimension();
-        TVector<TVector<double>> tailDerivatives;
-        TVector<TConstArrayRef<double>> derivatives(approxDimension);
-        for (auto dim : xrange(approxDimension)) {
-            derivatives[dim] = fold->BodyTailArr[0].WeightedDerivatives[dim];
-        }
-        if (boostingType == EBoostingType::Ordered) {
-            tailDerivatives.resize(approxDimension);
-            for (auto dim : xrange(approxDimension)) {
-                tailDerivatives[dim].yresize(SampleCount);
-            }
-            localExecutor->ExecRange(
-                [&](ui32 bodyTailId) {
-                    const TFold::TBodyTail& bt = fold->BodyTailArr[bodyTailId];
-                    for (auto dim : xrange(approxDimension)) {
-                        TConstArrayRef<double> bodyTailDerivatives = bt.WeightedDerivatives[dim];
-                        if (bodyTailId == 0) {
-                            Copy(
-                                bodyTailDerivatives.begin(),
-                                bodyTailDerivatives.begin() + bt.TailFinish,
-                                tailDerivatives[dim].begin()
-                            );
-                        } else {
-                            Copy(
-                                bodyTailDerivatives.begin() + bt.BodyFinish,
-                                bodyTailDerivatives.begin() + bt.TailFinish,
-                                tailDerivatives[dim].begin() + bt.BodyFinish
-                            );
-                        }
-                    }
-                },
-                0,
-                fold->BodyTailArr.size(),
-                NPar::TLocalExecutor::WAIT_COMPLETE
-            );
-            for (auto dim : xrange(approxDimension)) {
-                derivatives[dim] = tailDerivatives[dim];
-            }
-        }
-
-        double lambda = GetLambda(derivatives, leafValues, localExecutor);
+        const auto segments = GetDerivativesSegments(SampleCount, boostingType, *fold);
+        double lambda = GetLambda(segments, leafValues, localExecutor);
 
         NPar::TLocalExecutor::TExecRangeParams blockParams(0, SampleCount);
         blockParams.SetBlockSize(BlockSize);
@@ -181,38 +190,27 @@ void TMvsSampler::GenSampleWeights(
                     static_cast<ui32>(blockParams.GetBlockSize()),
                     SampleCount - blockOffset
                 );
-                const ui32 blockFinish = blockOffset + blockSize;
-
-                TVector<double> thresholdCandidates(blockSize, lambda);
-                for (auto dim : xrange(approxDimension)) {
-                    TConstArrayRef<double> derivativesRef(derivatives[dim].begin() + blockOffset, blockSize);
-                    for (auto idx : xrange(blockSize)) {
-                        const double der = derivativesRef[idx];
-                        thresholdCandidates[idx] += der * der;
-                    }
-                }
-                for (auto& value : thresholdCandidates) {
-                    value = sqrt(value);
-                }
+
+                // norms are calculated once and used both for the threshold and the probabilities
+                TVector<double> gradNorms;
+                gradNorms.yresize(blockSize);
+                CalcGradientNorms(segments, lambda, blockOffset, gradNorms);
+                TVector<double> thresholdCandidates(gradNorms.begin(), gradNorms.end());
                 double threshold = CalculateThreshold(
                     thresholdCandidates.begin(),
                     thresholdCandidates.end(),
                     0,
                     0,
                     SampleRate * blockSize);
-                for (ui32 i = blockOffset; i < blockFinish; ++i) {
-                    double grad2 = 0;
-                    for (auto dim : xrange(approxDimension)) {
-                        const double der = derivatives[dim][i];
-                        grad2 += der * der;
-                    }
-                    const double probability = GetSingleProbability(sqrt(grad2 + lambda), threshold);
+                TArrayRef<float> sampleWeights(fold->SampleWeights.data() + blockOffset, blockSize);
+                for (auto idx : xrange(blockSize)) {
+                    const double probability = GetSingleProbability(gradNorms[idx], threshold);
                     if (probability > std::numeric_limits<double>::epsilon()) {
                         const double weight = 1 / probability;
                         double r = prng.GenRandReal1();
-                        fold->SampleWeights[i] = weight * (r < probability);
+                        sampleWeights[idx] = weight * (r < probability);
                     } else {
-                        fold->SampleWeights[i] = 0;
+                        sampleWeights[idx] = 0;
                     }
                 }
             },
@@ -222,3 +220,56 @@ void TMvsSampler::GenSampleWeights(
         );
     }
 }
+
+void TGossSampler::GenSampleWeights(
+    EBoostingType boostingType,
+    TRestorableFastRng64* rand,
+    NPar::TLocalExecutor* localExecutor,
+    TFold* fold) const {
+
+    if (SampleRate == 1.0f) {
+        Fill(fold->SampleWeights.begin(), fold->SampleWeights.end(), 1.0f);
+        return;
+    }
+    const auto segments = GetDerivativesSegments(SampleCount, boostingType, *fold);
+    const double otherProbability = (SampleRate - TopRate) / (1.0 - TopRate);
+    const float otherWeight = otherProbability > 0 ? 1 / otherProbability : 0.0f;
+
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, SampleCount);
+    blockParams.SetBlockSize(BlockSize);
+    const ui64 randSeed = rand->GenRand();
+    localExecutor->ExecRange(
+        [&](ui32 blockId) {
+            TRestorableFastRng64 prng(randSeed + blockId);
+            prng.Advance(10); // reduce correlation between RNGs in different threads
+            const ui32 blockOffset = blockId * blockParams.GetBlockSize();
+            const ui32 blockSize = Min(
+                static_cast<ui32>(blockParams.GetBlockSize()),
+                SampleCount - blockOffset
+            );
+
+            TVector<double> gradNorms;
+            gradNorms.yresize(blockSize);
+            CalcGradientNorms(segments, /*lambda*/ 0.0, blockOffset, gradNorms);
+            const ui32 topCount = Min(blockSize, static_cast<ui32>(ceil(TopRate * blockSize)));
+            double threshold = std::numeric_limits<double>::infinity();
+            if (topCount > 0) {
+                TVector<double> thresholdCandidates(gradNorms.begin(), gradNorms.end());
+                const auto thresholdIt = thresholdCandidates.begin() + (blockSize - topCount);
+                NthElement(thresholdCandidates.begin(), thresholdIt, thresholdCandidates.end());
+                threshold = *thresholdIt;
+            }
+            TArrayRef<float> sampleWeights(fold->SampleWeights.data() + blockOffset, blockSize);
+            for (auto idx : xrange(blockSize)) {
+                if (gradNorms[idx] >= threshold) {
+                    sampleWeights[idx] = 1.0f;
+                } else {
+                    sampleWeights[idx] = prng.GenRandReal1() < otherProbability ? otherWeight : 0.0f;
+                }
+            }
+        },
+        0,
+        blockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+}
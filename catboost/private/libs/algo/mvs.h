@@ -16,6 +16,14 @@ namespace NPar {
 }
 
 
+// derivatives of objects [Begin, End) in the learn permutation order
+struct TDerivativesSegment {
+    ui32 Begin;
+    ui32 End;
+    const TVector<TVector<double>>* Derivatives;
+};
+
+
 class TMvsSampler {
 public:
     TMvsSampler(ui32 sampleCount, float sampleRate, const TMaybe<float>& lambda)
@@ -31,8 +39,11 @@ public:
         TFold* fold) const;
 
 private:
+    double CalculateMeanGradValue(
+        TConstArrayRef<TDerivativesSegment> segments,
+        NPar::TLocalExecutor* localExecutor) const;
     double GetLambda(
-        const TVector<TConstArrayRef<double>>& derivatives,
+        TConstArrayRef<TDerivativesSegment> segments,
         const TVector<TVector<TVector<double>>>& leafValues,
         NPar::TLocalExecutor* localExecutor) const;
     double CalculateThreshold(
@@ -48,3 +59,28 @@ private:
     const ui32 BlockSize = 8192;
     TMaybe<float> Lambda;
 };
+
+
+// Gradient-based One-Side Sampling: TopRate fraction of objects with the largest gradient norms is
+// taken with weight 1, the rest are taken with probability (SampleRate - TopRate) / (1 - TopRate)
+// and weight inverse to it. Like in MVS, objects are ranked within blocks of BlockSize objects.
+// Not taken objects get zero weight and are excluded from score calculation by TCalcScoreFold::Sample.
+class TGossSampler {
+public:
+    TGossSampler(ui32 sampleCount, float sampleRate, float topRate)
+        : SampleCount(sampleCount)
+        , SampleRate(sampleRate)
+        , TopRate(topRate)
+    {}
+    void GenSampleWeights(
+        EBoostingType boostingType,
+        TRestorableFastRng64* rand,
+        NPar::TLocalExecutor* localExecutor,
+        TFold* fold) const;
+
+private:
+    ui32 SampleCount;
+    float SampleRate;
+    float TopRate;
+    const ui32 BlockSize = 8192;
+};
@@ -16,7 +16,10 @@
 #include <library/cpp/threading/local_executor/local_executor.h>
 
 #include <util/generic/bitops.h>
+#include <util/generic/cast.h>
+#include <util/generic/map.h>
 #include <util/generic/utility.h>
+#include <util/generic/xrange.h>
 #include <util/system/mem_info.h>
 #include <util/thread/singleton.h>
 
@@ -37,16 +40,9 @@ struct TCtrCalcer {
         Fill(Storage.begin(), Storage.end(), 0);
         return (T*)Storage.data();
     }
-    static inline TArrayRef<TCtrMeanHistory> GetCtrMeanHistoryArr(size_t maxCount) {
-        return TArrayRef<TCtrMeanHistory>(
-            FastTlsSingleton<TCtrCalcer>()->Alloc<TCtrMeanHistory>(maxCount), maxCount);
-    }
     static inline TArrayRef<int> GetIntArr(size_t maxCount) {
         return TArrayRef<int>(FastTlsSingleton<TCtrCalcer>()->Alloc<int>(maxCount), maxCount);
     }
-    static inline int* GetCtrArrTotal(size_t maxCount) {
-        return FastTlsSingleton<TCtrCalcer>()->Alloc<int>(maxCount);
-    }
 
 private:
     TVector<char> Storage;
@@ -189,23 +185,77 @@ static void CalcOnlineCTRClasses(
     }
 }
 
+namespace {
+    // Per-value statistics of Borders ctrs for binary targets
+    struct TBinaryCtrStatsTraits {
+        using THistory = TCtrHistory;
+
+        void AddTarget(int targetClass, THistory* history) const {
+            ++history->N[targetClass];
+        }
+        void AddHistory(const THistory& other, THistory* history) const {
+            history->N[0] += other.N[0];
+            history->N[1] += other.N[1];
+        }
+        float GetGoodCount(const THistory& history) const {
+            return history.N[1];
+        }
+        int GetTotalCount(const THistory& history) const {
+            return history.N[0] + history.N[1];
+        }
+    };
+
+    struct TCtrMeanClassHistory {
+        int ClassSum;
+        int Count;
+    };
+
+    // Per-value statistics of BinarizedTargetMeanValue ctrs, target class sums are kept as integers
+    // to make block sums exact and independent of the block count
+    struct TMeanCtrStatsTraits {
+        using THistory = TCtrMeanClassHistory;
+
+        int TargetBorderCount = 1;
+
+    public:
+        void AddTarget(int targetClass, THistory* history) const {
+            history->ClassSum += targetClass;
+            ++history->Count;
+        }
+        void AddHistory(const THistory& other, THistory* history) const {
+            history->ClassSum += other.ClassSum;
+            history->Count += other.Count;
+        }
+        float GetGoodCount(const THistory& history) const {
+            return static_cast<float>(history.ClassSum) / TargetBorderCount;
+        }
+        int GetTotalCount(const THistory& history) const {
+            return history.Count;
+        }
+    };
+}
+
+template <class TStatsTraits>
 static void CalcStatsForEachBlock(
     const NPar::TLocalExecutor::TExecRangeParams& ctrParallelizationParams,
     TConstArrayRef<ui64> enumeratedCatFeatures,
     TConstArrayRef<int> permutedTargetClass,
+    const TStatsTraits& statsTraits,
     NPar::TLocalExecutor* localExecutor,
-    TArrayRef<TVector<TCtrHistory>> perBlockCtrs
+    TArrayRef<TVector<typename TStatsTraits::THistory>> perBlockCtrs
 ) {
+    using THistory = typename TStatsTraits::THistory;
+
     const int blockCount = ctrParallelizationParams.GetBlockCount();
     const int blockSize = ctrParallelizationParams.GetBlockSize();
     localExecutor->ExecRange(
         [&] (int blockIdx) {
             const int blockStart = blockSize * blockIdx;
             const int nextBlockStart = Min(blockStart + blockSize, ctrParallelizationParams.LastId);
-            TArrayRef<TCtrHistory> blockCtrsRef(perBlockCtrs[blockIdx]);
-            Fill(blockCtrsRef.begin(), blockCtrsRef.end(), TCtrHistory{0, 0});
+            TArrayRef<THistory> blockCtrsRef(perBlockCtrs[blockIdx]);
+            Fill(blockCtrsRef.begin(), blockCtrsRef.end(), THistory());
             for (int docIdx : xrange(blockStart, nextBlockStart)) {
-                ++blockCtrsRef[enumeratedCatFeatures[docIdx]].N[permutedTargetClass[docIdx]];
+                statsTraits.AddTarget(permutedTargetClass[docIdx], &blockCtrsRef[enumeratedCatFeatures[docIdx]]);
             }
         },
         0,
@@ -214,26 +264,30 @@ static void CalcStatsForEachBlock(
     );
 }
 
+// Replaces per-block stats with stats of all preceding blocks, ctrs get stats of all blocks
+template <class TStatsTraits>
 static void SumCtrsFromBlocks(
     const NPar::TLocalExecutor::TExecRangeParams& valueBlockParams,
+    const TStatsTraits& statsTraits,
     NPar::TLocalExecutor* localExecutor,
-    TArrayRef<TVector<TCtrHistory>> perBlockCtrs,
-    TArrayRef<TCtrHistory> ctrs
+    TArrayRef<TVector<typename TStatsTraits::THistory>> perBlockCtrs,
+    TArrayRef<typename TStatsTraits::THistory> ctrs
 ) {
+    using THistory = typename TStatsTraits::THistory;
+
     const int blockCount = valueBlockParams.GetBlockCount();
     const int blockSize = valueBlockParams.GetBlockSize();
     localExecutor->ExecRange(
         [&] (int blockIdx) {
             const int blockStart = blockIdx * blockSize;
             const int nextBlockStart = Min<int>(blockStart + blockSize, valueBlockParams.LastId);
-            Fill(ctrs.data() + blockStart, ctrs.data() + nextBlockStart, TCtrHistory{0, 0});
+            Fill(ctrs.data() + blockStart, ctrs.data() + nextBlockStart, THistory());
             for (auto& blockCtrs : perBlockCtrs) {
-                TArrayRef<TCtrHistory> blockCtrsRef(blockCtrs);
+                TArrayRef<THistory> blockCtrsRef(blockCtrs);
                 for (int idx : xrange(blockStart, nextBlockStart)) {
-                    const TCtrHistory ctrOffset = blockCtrsRef[idx];
+                    const THistory ctrOffset = blockCtrsRef[idx];
                     blockCtrsRef[idx] = ctrs[idx];
-                    ctrs[idx].N[0] += ctrOffset.N[0];
-                    ctrs[idx].N[1] += ctrOffset.N[1];
+                    statsTraits.AddHistory(ctrOffset, &ctrs[idx]);
                 }
             }
         },
@@ -243,61 +297,99 @@ static void SumCtrsFromBlocks(
     );
 }
 
+static void CalcQuantizedCtrsForDocs(
+    TConstArrayRef<float> goodCount,
+    TConstArrayRef<int> totalCount,
+    TConstArrayRef<float> priors,
+    TConstArrayRef<float> shifts,
+    TConstArrayRef<float> norms,
+    int ctrBorderCount,
+    TArray2D<TVector<ui8>>* feature,
+    int docOffset
+) {
+    // branch-free loops over contiguous arrays, so the compiler can vectorize them
+    const int docCount = goodCount.ysize();
+    for (int priorIdx : xrange(priors.ysize())) {
+        const float prior = priors[priorIdx];
+        const float shift = shifts[priorIdx];
+        const float norm = norms[priorIdx];
+        ui8* featureData = docOffset + (*feature)[0][priorIdx].data();
+        for (int docIdx = 0; docIdx < docCount; ++docIdx) {
+            featureData[docIdx] = CalcCTR(
+                goodCount[docIdx],
+                totalCount[docIdx],
+                prior,
+                shift,
+                norm,
+                ctrBorderCount);
+        }
+    }
+}
+
+/* Finalizes ctrs for docs in [docOffset, docOffset + ctrParallelizationParams.LastId)
+ * If permutedTargetClass is not empty perBlockCtrs must contain the stats of preceding blocks
+ * (see SumCtrsFromBlocks) and are updated with targets of the block's docs,
+ * otherwise perBlockCtrs[0] is used read-only for all blocks (as for test docs)
+ */
+template <class TStatsTraits>
 static void CalcQuantizedCtrs(
     const NPar::TLocalExecutor::TExecRangeParams& ctrParallelizationParams,
+    int docOffset,
     TConstArrayRef<ui64> enumeratedCatFeatures,
     TConstArrayRef<int> permutedTargetClass,
+    const TStatsTraits& statsTraits,
     TConstArrayRef<float> priors,
     TConstArrayRef<float> shifts,
     TConstArrayRef<float> norms,
     int ctrBorderCount,
     NPar::TLocalExecutor* localExecutor,
-    TArrayRef<TVector<TCtrHistory>> perBlockCtrs,
+    TArrayRef<TVector<typename TStatsTraits::THistory>> perBlockCtrs,
     TArray2D<TVector<ui8>>* feature
 ) {
+    using THistory = typename TStatsTraits::THistory;
+
     constexpr int BlockSize = 1000;
     TBlockedCalcer calcer(BlockSize);
 
+    const bool updateHistory = !permutedTargetClass.empty();
     const int blockCount = ctrParallelizationParams.GetBlockCount();
     const int blockSize = ctrParallelizationParams.GetBlockSize();
     const int docCount = ctrParallelizationParams.LastId;
     localExecutor->ExecRange(
         [&] (int blockIdx) {
-            const TArrayRef<TCtrHistory> ctrArrSimple(perBlockCtrs[blockIdx]);
-            auto totalCount = TCtrCalcer::GetIntArr(2 * BlockSize).data();
-            auto goodCount = totalCount + BlockSize;
+            const TArrayRef<THistory> ctrArr(perBlockCtrs[updateHistory ? blockIdx : 0]);
+            TVector<float> goodCount;
+            goodCount.yresize(BlockSize);
+            auto totalCount = TCtrCalcer::GetIntArr(BlockSize).data();
 
-            auto calcGoodCount = [&](int blockStart, int nextBlockStart, int docOffset) {
+            auto calcGoodCount = [&](int blockStart, int nextBlockStart, int blockDocOffset) {
                 for (int docIdx : xrange(blockStart, nextBlockStart)) {
-                    auto& elem = ctrArrSimple[enumeratedCatFeatures[docOffset + docIdx]].N;
-                    goodCount[docIdx - blockStart] = elem[1];
-                    totalCount[docIdx - blockStart] = elem[0] + elem[1];
-                    ++elem[permutedTargetClass[docOffset + docIdx]];
+                    auto& elem = ctrArr[enumeratedCatFeatures[blockDocOffset + docIdx]];
+                    goodCount[docIdx - blockStart] = statsTraits.GetGoodCount(elem);
+                    totalCount[docIdx - blockStart] = statsTraits.GetTotalCount(elem);
+                    if (updateHistory) {
+                        statsTraits.AddTarget(permutedTargetClass[blockDocOffset + docIdx], &elem);
+                    }
                 }
             };
 
-            auto calcCtrs = [&](int blockStart, int nextBlockStart, int docOffset) {
-                for (int priorIdx : xrange(priors.ysize())) {
-                    const float prior = priors[priorIdx];
-                    const float shift = shifts[priorIdx];
-                    const float norm = norms[priorIdx];
-                    ui8* featureData = docOffset + (*feature)[0][priorIdx].data();
-                    for (int docIdx : xrange(blockStart, nextBlockStart)) {
-                        featureData[docIdx] = CalcCTR(
-                            goodCount[docIdx - blockStart],
-                            totalCount[docIdx - blockStart],
-                            prior,
-                            shift,
-                            norm,
-                            ctrBorderCount);
-                    }
-                }
+            auto calcCtrs = [&](int blockStart, int nextBlockStart, int blockDocOffset) {
+                const int calcDocCount = nextBlockStart - blockStart;
+                CalcQuantizedCtrsForDocs(
+                    MakeArrayRef(goodCount.data(), calcDocCount),
+                    MakeArrayRef(totalCount, calcDocCount),
+                    priors,
+                    shifts,
+                    norms,
+                    ctrBorderCount,
+                    feature,
+                    blockDocOffset + blockStart);
             };
 
             calcer.Calc(
                 calcGoodCount,
                 calcCtrs,
-                blockSize * blockIdx,
+                docOffset + blockSize * blockIdx,
                 Min(blockSize, docCount - blockSize * blockIdx));
         },
         0,
@@ -306,31 +398,45 @@ static void CalcQuantizedCtrs(
     );
 }
 
-static void CalcOnlineCTRSimple(
+/* Block-parallel online ctr calculation:
+ * per-block stats for learn docs, prefix sums of them over blocks, and independent finalization of blocks;
+ * test docs use stats of the whole learn
+ */
+template <class TStatsTraits>
+static void CalcOnlineCTRByBlocks(
     const TVector<size_t>& testOffsets,
     const TVector<ui64>& enumeratedCatFeatures,
     size_t uniqueValuesCount,
     const TVector<int>& permutedTargetClass,
+    const TStatsTraits& statsTraits,
     const TVector<float>& priors,
     int ctrBorderCount,
     TArray2D<TVector<ui8>>* feature,
     NPar::TLocalExecutor* localExecutor) {
 
+    using THistory = typename TStatsTraits::THistory;
+
     const int learnSampleCount = testOffsets[0];
     NPar::TLocalExecutor::TExecRangeParams ctrParallelizationParams(0, learnSampleCount);
     ctrParallelizationParams.SetBlockCount(localExecutor->GetThreadCount() + 1);
 
     const int bigBlockCount = ctrParallelizationParams.GetBlockCount();
-    TVector<TVector<TCtrHistory>> perBlockCtrs;
+    TVector<TVector<THistory>> perBlockCtrs;
     ResizeRank2(bigBlockCount, uniqueValuesCount, perBlockCtrs);
-    CalcStatsForEachBlock(ctrParallelizationParams, enumeratedCatFeatures, permutedTargetClass, localExecutor, perBlockCtrs);
+    CalcStatsForEachBlock(
+        ctrParallelizationParams,
+        enumeratedCatFeatures,
+        permutedTargetClass,
+        statsTraits,
+        localExecutor,
+        MakeArrayRef(perBlockCtrs));
 
     NPar::TLocalExecutor::TExecRangeParams valueBlockParams(0, uniqueValuesCount);
     valueBlockParams.SetBlockSize(1 + 1000 / (localExecutor->GetThreadCount() + 1));
 
-    TVector<TCtrHistory> ctrsForTest;
-    ctrsForTest.yresize(uniqueValuesCount);
-    SumCtrsFromBlocks(valueBlockParams, localExecutor, perBlockCtrs, ctrsForTest);
+    TVector<TVector<THistory>> ctrsForTest(1);
+    ctrsForTest[0].yresize(uniqueValuesCount);
+    SumCtrsFromBlocks(valueBlockParams, statsTraits, localExecutor, MakeArrayRef(perBlockCtrs), MakeArrayRef(ctrsForTest[0]));
 
     TVector<float> shifts;
     TVector<float> norms;
@@ -338,54 +444,58 @@ static void CalcOnlineCTRSimple(
 
     CalcQuantizedCtrs(
         ctrParallelizationParams,
+        /*docOffset*/ 0,
         enumeratedCatFeatures,
         permutedTargetClass,
+        statsTraits,
         priors,
         shifts,
         norms,
         ctrBorderCount,
         localExecutor,
-        perBlockCtrs,
+        MakeArrayRef(perBlockCtrs),
         feature);
 
-    constexpr int BlockSize = 1000;
-    const TArrayRef<TCtrHistory> ctrArrSimple(ctrsForTest);
-    auto totalCount = TCtrCalcer::GetIntArr(2 * BlockSize).data();
-    auto goodCount = totalCount + BlockSize;
-
-    auto calcGoodCount = [&](int blockStart, int nextBlockStart, int docOffset) {
-        for (int docIdx : xrange(blockStart, nextBlockStart)) {
-            auto& elem = ctrArrSimple[enumeratedCatFeatures[docOffset + docIdx]].N;
-            goodCount[docIdx - blockStart] = elem[1];
-            totalCount[docIdx - blockStart] = elem[0] + elem[1];
-        }
-    };
-
-    auto calcCtrs = [&](int blockStart, int nextBlockStart, int docOffset) {
-        for (int priorIdx : xrange(priors.ysize())) {
-            const float prior = priors[priorIdx];
-            const float shift = shifts[priorIdx];
-            const float norm = norms[priorIdx];
-            ui8* featureData = docOffset + (*feature)[0][priorIdx].data();
-            for (int docIdx : xrange(blockStart, nextBlockStart)) {
-                featureData[docIdx] = CalcCTR(
-                    goodCount[docIdx - blockStart],
-                    totalCount[docIdx - blockStart],
-                    prior,
-                    shift,
-                    norm,
-                    ctrBorderCount);
-            }
-        }
-    };
+    const int testSampleCount = testOffsets.back() - learnSampleCount;
+    if (testSampleCount > 0) {
+        NPar::TLocalExecutor::TExecRangeParams testParallelizationParams(0, testSampleCount);
+        testParallelizationParams.SetBlockCount(localExecutor->GetThreadCount() + 1);
+        CalcQuantizedCtrs(
+            testParallelizationParams,
+            /*docOffset*/ learnSampleCount,
+            enumeratedCatFeatures,
+            /*permutedTargetClass*/ TConstArrayRef<int>(),
+            statsTraits,
+            priors,
+            shifts,
+            norms,
+            ctrBorderCount,
+            localExecutor,
+            MakeArrayRef(ctrsForTest),
+            feature);
+    }
+}
 
-    TBlockedCalcer calcer(BlockSize);
+static void CalcOnlineCTRSimple(
+    const TVector<size_t>& testOffsets,
+    const TVector<ui64>& enumeratedCatFeatures,
+    size_t uniqueValuesCount,
+    const TVector<int>& permutedTargetClass,
+    const TVector<float>& priors,
+    int ctrBorderCount,
+    TArray2D<TVector<ui8>>* feature,
+    NPar::TLocalExecutor* localExecutor) {
 
-    for (size_t docOffset = learnSampleCount, testIdx = 0; testIdx < testOffsets.size() - 1; ++testIdx) {
-        const size_t testSampleCount = testOffsets[testIdx + 1] - testOffsets[testIdx];
-        calcer.Calc(calcGoodCount, calcCtrs, docOffset, testSampleCount);
-        docOffset += testSampleCount;
-    }
+    CalcOnlineCTRByBlocks(
+        testOffsets,
+        enumeratedCatFeatures,
+        uniqueValuesCount,
+        permutedTargetClass,
+        TBinaryCtrStatsTraits(),
+        priors,
+        ctrBorderCount,
+        feature,
+        localExecutor);
 }
 
 static void CalcOnlineCTRMean(
@@ -396,54 +506,21 @@ static void CalcOnlineCTRMean(
     int targetBorderCount,
     const TVector<float>& priors,
     int ctrBorderCount,
-    TArray2D<TVector<ui8>>* feature) {
-
-    TVector<float> shift;
-    TVector<float> norm;
-    CalcNormalization(priors, &shift, &norm);
-
-    const int blockSize = 1000;
-    TVector<float> sum(blockSize);
-    TVector<int> count(blockSize);
-    auto ctrArrMean = TCtrCalcer::GetCtrMeanHistoryArr(leafCount);
-
-    auto calcCount = [&](int blockStart, int nextBlockStart, int docOffset) {
-        for (int docId = blockStart; docId < nextBlockStart; ++docId) {
-            TCtrMeanHistory& elem = ctrArrMean[enumeratedCatFeatures[docOffset + docId]];
-            sum[docId - blockStart] = elem.Sum;
-            count[docId - blockStart] = elem.Count;
-            if (docOffset == 0) {
-                elem.Add(static_cast<float>(permutedTargetClass[docId]) / targetBorderCount);
-            }
-        }
-    };
-
-    auto calcCTRs = [&](int blockStart, int nextBlockStart, int docOffset) {
-        for (int prior = 0; prior < priors.ysize(); ++prior) {
-            const float priorX = priors[prior];
-            const float shiftX = shift[prior];
-            const float normX = norm[prior];
-            ui8* featureData = docOffset + (*feature)[0][prior].data();
-            for (int docId = blockStart; docId < nextBlockStart; ++docId) {
-                featureData[docId] = CalcCTR(
-                    sum[docId - blockStart],
-                    count[docId - blockStart],
-                    priorX,
-                    shiftX,
-                    normX,
-                    ctrBorderCount);
-            }
-        }
-    };
+    TArray2D<TVector<ui8>>* feature,
+    NPar::TLocalExecutor* localExecutor) {
 
-    TBlockedCalcer calcer(blockSize);
-    const size_t learnSampleCount = testOffsets[0];
-    calcer.Calc(calcCount, calcCTRs, 0, learnSampleCount);
-    for (size_t docOffset = learnSampleCount, testIdx = 0; testIdx < testOffsets.size() - 1; ++testIdx) {
-        const size_t testSampleCount = testOffsets[testIdx + 1] - testOffsets[testIdx];
-        calcer.Calc(calcCount, calcCTRs, docOffset, testSampleCount);
-        docOffset += testSampleCount;
-    }
+    TMeanCtrStatsTraits statsTraits;
+    statsTraits.TargetBorderCount = targetBorderCount;
+    CalcOnlineCTRByBlocks(
+        testOffsets,
+        enumeratedCatFeatures,
+        leafCount,
+        permutedTargetClass,
+        statsTraits,
+        priors,
+        ctrBorderCount,
+        feature,
+        localExecutor);
 }
 
 static void CalcOnlineCTRCounter(
@@ -453,47 +530,42 @@ static void CalcOnlineCTRCounter(
     int denominator,
     const TVector<float>& priors,
     int ctrBorderCount,
-    TArray2D<TVector<ui8>>* feature) {
+    TArray2D<TVector<ui8>>* feature,
+    NPar::TLocalExecutor* localExecutor) {
 
-    TVector<float> shift;
-    TVector<float> norm;
-    CalcNormalization(priors, &shift, &norm);
+    TVector<float> shifts;
+    TVector<float> norms;
+    CalcNormalization(priors, &shifts, &norms);
 
-    const int blockSize = 1000;
-    auto ctrTotal = TCtrCalcer::GetCtrArrTotal(blockSize);
-    auto calcTotal = [&](int blockStart, int nextBlockStart, int docOffset) {
-        for (int docId = blockStart; docId < nextBlockStart; ++docId) {
-            const auto elemId = enumeratedCatFeatures[docOffset + docId];
-            ctrTotal[docId - blockStart] = counterCTRTotal[elemId];
-        }
-    };
+    // counter ctrs depend only on precomputed totals, so all docs (learn and test) are independent
+    const int docCount = testOffsets.back();
+    constexpr int BlockSize = 1000;
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, docCount);
+    blockParams.SetBlockSize(BlockSize);
 
-    auto calcCTRs = [&](int blockStart, int nextBlockStart, int docOffset) {
-        for (int prior = 0; prior < priors.ysize(); ++prior) {
-            const float priorX = priors[prior];
-            const float shiftX = shift[prior];
-            const float normX = norm[prior];
-            ui8* featureData = docOffset + (*feature)[0][prior].data();
-            for (int docId = blockStart; docId < nextBlockStart; ++docId) {
-                featureData[docId] = CalcCTR(
-                    ctrTotal[docId - blockStart],
-                    denominator,
-                    priorX,
-                    shiftX,
-                    normX,
-                    ctrBorderCount);
+    TVector<int> denominators(BlockSize, denominator);
+    localExecutor->ExecRange(
+        [&] (int blockIdx) {
+            const int blockStart = blockIdx * BlockSize;
+            const int blockDocCount = Min(BlockSize, docCount - blockStart);
+            TVector<float> ctrTotal;
+            ctrTotal.yresize(blockDocCount);
+            for (int docIdx : xrange(blockDocCount)) {
+                ctrTotal[docIdx] = counterCTRTotal[enumeratedCatFeatures[blockStart + docIdx]];
             }
-        }
-    };
-
-    TBlockedCalcer calcer(blockSize);
-    const size_t learnSampleCount = testOffsets[0];
-    calcer.Calc(calcTotal, calcCTRs, 0, learnSampleCount);
-    for (size_t docOffset = learnSampleCount, testIdx = 0; testIdx < testOffsets.size() - 1; ++testIdx) {
-        const size_t testSampleCount = testOffsets[testIdx + 1] - testOffsets[testIdx];
-        calcer.Calc(calcTotal, calcCTRs, docOffset, testSampleCount);
-        docOffset += testSampleCount;
-    }
+            CalcQuantizedCtrsForDocs(
+                ctrTotal,
+                MakeArrayRef(denominators.data(), blockDocCount),
+                priors,
+                shifts,
+                norms,
+                ctrBorderCount,
+                feature,
+                blockStart);
+        },
+        0,
+        blockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
 }
 
 static inline void CountOnlineCTRTotal(
@@ -695,7 +767,8 @@ void ComputeOnlineCTRs(
                     targetClassesCount - 1,
                     priors,
                     ctrBorderCount,
-                    &dst->Feature[ctrIdx]);
+                    &dst->Feature[ctrIdx],
+                    ctx->LocalExecutor);
 
             } else if (ctrType == ECtrType::Buckets ||
                     (ctrType == ECtrType::Borders && targetClassesCount > SIMPLE_CLASSES_COUNT)) {
@@ -719,7 +792,8 @@ void ComputeOnlineCTRs(
                     counterCTRDenominator,
                     priors,
                     ctrBorderCount,
-                    &dst->Feature[ctrIdx]);
+                    &dst->Feature[ctrIdx],
+                    ctx->LocalExecutor);
             }
         },
         0,
@@ -795,22 +869,21 @@ void CalcFinalCtrsImpl(
 }
 
 
-static void CalcFinalCtrs(
-    const ECtrType ctrType,
+static bool IsTestDataNeededForFinalCtr(ECtrType ctrType, ECounterCalc counterCalcMethod) {
+    return ctrType == ECtrType::Counter && counterCalcMethod == ECounterCalc::Full;
+}
+
+static TVector<ui64> CalcFinalCtrsHashes(
     const TProjection& projection,
     const TDatasetDataForFinalCtrs& datasetDataForFinalCtrs,
     const NCB::TFeaturesArraySubsetIndexing& learnFeaturesSubsetIndexing,
     const NCB::TPerfectHashedToHashedCatValuesMap& perfectHashedToHashedCatValuesMap,
-    int targetBorderClassifierIdx,
-    ui64 ctrLeafCountLimit,
-    bool storeAllSimpleCtr,
-    ECounterCalc counterCalcMethod,
-    TCtrValueTable* result,
+    bool withTestData,
     NPar::TLocalExecutor* localExecutor) {
 
     ui32 learnSampleCount = datasetDataForFinalCtrs.Data.Learn->GetObjectCount();
     ui32 totalSampleCount = learnSampleCount;
-    if (ctrType == ECtrType::Counter && counterCalcMethod == ECounterCalc::Full) {
+    if (withTestData) {
         totalSampleCount += datasetDataForFinalCtrs.Data.GetTestSampleCount();
     }
     TVector<ui64> hashArr(totalSampleCount);
@@ -838,6 +911,19 @@ static void CalcFinalCtrs(
             testHashBegin = testHashEnd;
         }
     }
+    return hashArr;
+}
+
+// hashArr is calculated by CalcFinalCtrsHashes and is reindexed in place
+static void CalcFinalCtrs(
+    const ECtrType ctrType,
+    const TProjection& projection,
+    const TDatasetDataForFinalCtrs& datasetDataForFinalCtrs,
+    int targetBorderClassifierIdx,
+    ui64 ctrLeafCountLimit,
+    bool storeAllSimpleCtr,
+    TVector<ui64>* hashArr,
+    TCtrValueTable* result) {
 
     if (projection.IsSingleCatFeature() && storeAllSimpleCtr) {
         ctrLeafCountLimit = Max<ui64>();
@@ -848,10 +934,10 @@ static void CalcFinalCtrs(
         NeedTargetClassifier(ctrType) ?
             (**datasetDataForFinalCtrs.LearnTargetClass)[targetBorderClassifierIdx] : TVector<int>(),
         *datasetDataForFinalCtrs.Targets,
-        totalSampleCount,
+        SafeIntegerCast<ui32>(hashArr->size()),
         NeedTargetClassifier(ctrType) ?
             (**datasetDataForFinalCtrs.TargetClassesCount)[targetBorderClassifierIdx] : 0,
-        &hashArr,
+        hashArr,
         result
     );
 }
@@ -866,7 +952,7 @@ static ui64 EstimateCalcFinalCtrsCpuRamUsage(
     ui64 cpuRamUsageEstimate = 0;
 
     ui32 totalSampleCount = data.Learn->GetObjectCount();
-    if (ctrType == ECtrType::Counter && counterCalcMethod == ECounterCalc::Full) {
+    if (IsTestDataNeededForFinalCtr(ctrType, counterCalcMethod)) {
         totalSampleCount += data.GetTestSampleCount();
     }
     // for hashArr in CalcFinalCtrs
@@ -951,41 +1037,78 @@ void CalcFinalCtrsAndSaveToModel(
 
         const auto& layout = *datasetDataForFinalCtrs.Data.Learn->MetaInfo.FeaturesLayout;
 
-        auto ctrTableGenerator = [&] (const TModelCtrBase& ctr) -> TCtrValueTable {
-            TCtrValueTable resTable;
-            CalcFinalCtrs(
-                ctr.CtrType,
-                featureCombinationToProjectionMap.at(ctr.Projection),
-                datasetDataForFinalCtrs,
-                *learnFeaturesSubsetIndexing,
-                perfectHashedToHashedCatValuesMap,
-                ctr.TargetBorderClassifierIdx,
-                ctrLeafCountLimit,
-                storeAllSimpleCtrs,
-                counterCalcMethod,
-                &resTable,
-                localExecutor);
-            resTable.ModelCtrBase = ctr;
-            CATBOOST_DEBUG_LOG << "Finished CTR: " << ctr.CtrType << " "
-                << BuildDescription(layout, ctr.Projection) << Endl;
-            return resTable;
-        };
-
+        /* ctrs of the same projection (different ctr types and target borders) share hashes of objects,
+         * so they are calculated in one task and hashes are calculated only once for them
+         */
+        TMap<std::pair<TFeatureCombination, bool>, TVector<const TModelCtrBase*>> ctrsByHashes;
         for (const auto& ctr : usedCtrBases) {
-            finalCtrExecutor.Add(
-                {
+            const bool withTestData = IsTestDataNeededForFinalCtr(ctr.CtrType, counterCalcMethod);
+            ctrsByHashes[std::make_pair(ctr.Projection, withTestData)].push_back(&ctr);
+        }
+
+        for (const auto& hashesKeyAndCtrs : ctrsByHashes) {
+            const auto& ctrs = hashesKeyAndCtrs.second;
+            ui64 cpuRamUsageEstimate = 0;
+            for (const auto* ctr : ctrs) {
+                cpuRamUsageEstimate = Max(
+                    cpuRamUsageEstimate,
                     EstimateCalcFinalCtrsCpuRamUsage(
-                        ctr.CtrType,
+                        ctr->CtrType,
                         datasetDataForFinalCtrs.Data,
-                        NeedTargetClassifier(ctr.CtrType) ?
-                            (**datasetDataForFinalCtrs.TargetClassesCount)[ctr.TargetBorderClassifierIdx]
+                        NeedTargetClassifier(ctr->CtrType) ?
+                            (**datasetDataForFinalCtrs.TargetClassesCount)[ctr->TargetBorderClassifierIdx]
                             : 0,
                         ctrLeafCountLimit,
                         counterCalcMethod
-                    ),
-                    [&asyncCtrValueTableCallback, &ctrTableGenerator, &ctr] () {
-                        auto table = ctrTableGenerator(ctr);
-                        asyncCtrValueTableCallback(std::move(table));
+                    )
+                );
+            }
+            if (ctrs.size() > 1) {
+                // for the shared copy of hashes
+                ui64 hashCount = datasetDataForFinalCtrs.Data.Learn->GetObjectCount();
+                if (/*withTestData*/ hashesKeyAndCtrs.first.second) {
+                    hashCount += datasetDataForFinalCtrs.Data.GetTestSampleCount();
+                }
+                cpuRamUsageEstimate += sizeof(ui64) * hashCount;
+            }
+
+            finalCtrExecutor.Add(
+                {
+                    cpuRamUsageEstimate,
+                    [&] () {
+                        const auto& ctrs = hashesKeyAndCtrs.second;
+                        const TProjection& projection
+                            = featureCombinationToProjectionMap.at(hashesKeyAndCtrs.first.first);
+                        TVector<ui64> hashArr = CalcFinalCtrsHashes(
+                            projection,
+                            datasetDataForFinalCtrs,
+                            *learnFeaturesSubsetIndexing,
+                            perfectHashedToHashedCatValuesMap,
+                            /*withTestData*/ hashesKeyAndCtrs.first.second,
+                            localExecutor);
+                        TVector<ui64> reindexedHashArr;
+                        for (auto ctrIdx : xrange(ctrs.size())) {
+                            const auto* ctr = ctrs[ctrIdx];
+                            if (ctrIdx + 1 == ctrs.size()) {
+                                reindexedHashArr = std::move(hashArr);
+                            } else {
+                                reindexedHashArr = hashArr;
+                            }
+                            TCtrValueTable resTable;
+                            CalcFinalCtrs(
+                                ctr->CtrType,
+                                projection,
+                                datasetDataForFinalCtrs,
+                                ctr->TargetBorderClassifierIdx,
+                                ctrLeafCountLimit,
+                                storeAllSimpleCtrs,
+                                &reindexedHashArr,
+                                &resTable);
+                            resTable.ModelCtrBase = *ctr;
+                            CATBOOST_DEBUG_LOG << "Finished CTR: " << ctr->CtrType << " "
+                                << BuildDescription(layout, ctr->Projection) << Endl;
+                            asyncCtrValueTableCallback(std::move(resTable));
+                        }
                     }
                 }
             );
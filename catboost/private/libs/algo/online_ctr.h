@@ -7,6 +7,7 @@
 #include <catboost/libs/model/online_ctr.h>
 
 #include <util/generic/maybe.h>
+#include <util/generic/xrange.h>
 #include <util/system/types.h>
 
 #include <functional>
@@ -36,6 +37,9 @@ struct TOnlineCTR {
     // Counter ctrs could have more values than other types when counter_calc_method == Full
     size_t CounterUniqueValuesCount = 0;
 
+    // TFold::CtrUseTime of the last tree search this projection was a candidate in
+    ui64 LastUseTime = 0;
+
 public:
     size_t GetMaxUniqueValueCount() const {
         return Max(UniqueValuesCount, CounterUniqueValuesCount);
@@ -47,6 +51,17 @@ public:
             return UniqueValuesCount;
         }
     }
+    ui64 GetMemoryUsage() const {
+        ui64 memoryUsage = 0;
+        for (const auto& ctrFeature : Feature) {
+            for (auto border : xrange(ctrFeature.GetYSize())) {
+                for (auto prior : xrange(ctrFeature.GetXSize())) {
+                    memoryUsage += ctrFeature[border][prior].capacity();
+                }
+            }
+        }
+        return memoryUsage;
+    }
 };
 
 using TOnlineCTRHash = THashMap<TProjection, TOnlineCTR>;
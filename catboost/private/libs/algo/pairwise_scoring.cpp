@@ -4,13 +4,56 @@
 #include <catboost/private/libs/algo_helpers/pairwise_leaves_calculation.h>
 #include <catboost/libs/helpers/short_vector_ops.h>
 
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/algorithm.h>
 #include <util/generic/xrange.h>
 #include <util/system/yassert.h>
 
+#include <tuple>
+
 
 using namespace NCB;
 
 
+void SortPairsByLeaves(
+    TConstArrayRef<TIndexType> leafIndices,
+    NPar::TLocalExecutor* localExecutor,
+    TFlatPairsInfo* pairs
+) {
+    const int pairCount = pairs->ysize();
+    // (winner leaf, loser leaf, winner, index in pairs) - the last component makes the order deterministic
+    TVector<std::tuple<TIndexType, TIndexType, ui32, ui32>> keys;
+    keys.yresize(pairCount);
+    NPar::ParallelFor(
+        *localExecutor,
+        0,
+        pairCount,
+        [&] (int pairIdx) {
+            const auto& pair = (*pairs)[pairIdx];
+            keys[pairIdx] = std::make_tuple(
+                leafIndices[pair.WinnerId],
+                leafIndices[pair.LoserId],
+                pair.WinnerId,
+                (ui32)pairIdx);
+        }
+    );
+    Sort(keys);
+
+    TFlatPairsInfo sortedPairs;
+    sortedPairs.yresize(pairCount);
+    NPar::ParallelFor(
+        *localExecutor,
+        0,
+        pairCount,
+        [&] (int pairIdx) {
+            sortedPairs[pairIdx] = (*pairs)[std::get<3>(keys[pairIdx])];
+        }
+    );
+    pairs->swap(sortedPairs);
+}
+
+
 void TPairwiseStats::Add(const TPairwiseStats& rhs) {
     Y_ASSERT(SplitEnsembleSpec == rhs.SplitEnsembleSpec);
 
@@ -46,9 +46,47 @@ public:
 };
 
 
+// Pairs sorted by SortPairsByLeaves come in runs with the same (winner leaf, loser leaf),
+// so rows of weightSums are looked up only when the leaves change.
+class TPairWeightStatisticsRows {
+public:
+    explicit TPairWeightStatisticsRows(TArray2D<TVector<TBucketPairWeightStatistics>>* weightSums)
+        : WeightSums(*weightSums)
+    {}
+
+    void SetLeaves(TIndexType winnerLeafId, TIndexType loserLeafId) {
+        if (winnerLeafId != WinnerLeafId || loserLeafId != LoserLeafId) {
+            WinnerLeafId = winnerLeafId;
+            LoserLeafId = loserLeafId;
+            WinnerLoser = WeightSums[winnerLeafId][loserLeafId].data();
+            LoserWinner = WeightSums[loserLeafId][winnerLeafId].data();
+        }
+    }
+
+public:
+    TBucketPairWeightStatistics* WinnerLoser = nullptr; // weightSums[winnerLeafId][loserLeafId]
+    TBucketPairWeightStatistics* LoserWinner = nullptr; // weightSums[loserLeafId][winnerLeafId]
+
+private:
+    TArray2D<TVector<TBucketPairWeightStatistics>>& WeightSums;
+    TIndexType WinnerLeafId = Max<TIndexType>();
+    TIndexType LoserLeafId = Max<TIndexType>();
+};
+
+/* Sort pairs by (winner leaf, loser leaf, winner) to make accesses to pair statistics and to feature
+ * values of winners local. Pairs are sorted once per depth and used for all split candidates.
+ */
+void SortPairsByLeaves(
+    TConstArrayRef<TIndexType> leafIndices,
+    NPar::TLocalExecutor* localExecutor,
+    TFlatPairsInfo* pairs
+);
+
+
 // TGetBucketFunc is of type ui32(ui32 docId)
 template <class TGetBucketFunc>
 inline TVector<TVector<double>> ComputeDerSums(
+
     TConstArrayRef<double> weightedDerivativesData,
     int leafCount,
     int bucketCount,
@@ -78,6 +116,7 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
 ) {
     TArray2D<TVector<TBucketPairWeightStatistics>> weightSums(leafCount, leafCount);
     weightSums.FillEvery(TVector<TBucketPairWeightStatistics>(bucketCount));
+    TPairWeightStatisticsRows rows(&weightSums);
     for (size_t pairIdx : pairIndexRange.Iter()) {
         const auto winnerIdx = pairs[pairIdx].WinnerId;
         const auto loserIdx = pairs[pairIdx].LoserId;
@@ -89,12 +128,13 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
         const size_t loserBucketId = getBucketFunc(loserIdx);
         const auto loserLeafId = leafIndices[loserIdx];
         const float weight = pairs[pairIdx].Weight;
+        rows.SetLeaves(winnerLeafId, loserLeafId);
         if (winnerBucketId > loserBucketId) {
-            weightSums[loserLeafId][winnerLeafId][loserBucketId].SmallerBorderWeightSum -= weight;
-            weightSums[loserLeafId][winnerLeafId][winnerBucketId].GreaterBorderRightWeightSum -= weight;
+            rows.LoserWinner[loserBucketId].SmallerBorderWeightSum -= weight;
+            rows.LoserWinner[winnerBucketId].GreaterBorderRightWeightSum -= weight;
         } else {
-            weightSums[winnerLeafId][loserLeafId][winnerBucketId].SmallerBorderWeightSum -= weight;
-            weightSums[winnerLeafId][loserLeafId][loserBucketId].GreaterBorderRightWeightSum -= weight;
+            rows.WinnerLoser[winnerBucketId].SmallerBorderWeightSum -= weight;
+            rows.WinnerLoser[loserBucketId].GreaterBorderRightWeightSum -= weight;
         }
     }
 
@@ -115,6 +155,7 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
 
     TArray2D<TVector<TBucketPairWeightStatistics>> weightSums(leafCount, leafCount);
     weightSums.FillEvery(TVector<TBucketPairWeightStatistics>(2 * binaryFeaturesCount));
+    TPairWeightStatisticsRows rows(&weightSums);
     for (size_t pairIdx : pairIndexRange.Iter()) {
         const auto winnerIdx = pairs[pairIdx].WinnerId;
         const auto loserIdx = pairs[pairIdx].LoserId;
@@ -126,19 +167,20 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
         const NCB::TBinaryFeaturesPack loserFeaturesPack = getBinaryFeaturesPack(loserIdx);
         const auto loserLeafId = leafIndices[loserIdx];
         const float weight = pairs[pairIdx].Weight;
+        rows.SetLeaves(winnerLeafId, loserLeafId);
 
         for (auto bitIndex : xrange<NCB::TBinaryFeaturesPack>(binaryFeaturesCount)) {
             auto winnerBit = (winnerFeaturesPack >> bitIndex) & 1;
             auto loserBit = (loserFeaturesPack >> bitIndex) & 1;
 
             if (winnerBit > loserBit) {
-                weightSums[loserLeafId][winnerLeafId][2 * bitIndex].SmallerBorderWeightSum -= weight;
-                weightSums[loserLeafId][winnerLeafId][2 * bitIndex + 1].GreaterBorderRightWeightSum -= weight;
+                rows.LoserWinner[2 * bitIndex].SmallerBorderWeightSum -= weight;
+                rows.LoserWinner[2 * bitIndex + 1].GreaterBorderRightWeightSum -= weight;
             } else {
                 auto winnerBucketId = 2 * bitIndex + winnerBit;
-                weightSums[winnerLeafId][loserLeafId][winnerBucketId].SmallerBorderWeightSum -= weight;
+                rows.WinnerLoser[winnerBucketId].SmallerBorderWeightSum -= weight;
                 auto loserBucketId = 2 * bitIndex + loserBit;
-                weightSums[winnerLeafId][loserLeafId][loserBucketId].GreaterBorderRightWeightSum -= weight;
+                rows.WinnerLoser[loserBucketId].GreaterBorderRightWeightSum -= weight;
             }
         }
     }
@@ -174,6 +216,7 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
 
     TArray2D<TVector<TBucketPairWeightStatistics>> weightSums(leafCount, leafCount);
     weightSums.FillEvery(TVector<TBucketPairWeightStatistics>(totalBucketCount));
+    TPairWeightStatisticsRows rows(&weightSums);
     for (size_t pairIdx : pairIndexRange.Iter()) {
         const auto winnerIdx = pairs[pairIdx].WinnerId;
         const auto loserIdx = pairs[pairIdx].LoserId;
@@ -185,6 +228,7 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
         const ui32 loserBundleValue = getExclusiveFeaturesBundleValue(loserIdx);
         const auto loserLeafId = leafIndices[loserIdx];
         const float weight = pairs[pairIdx].Weight;
+        rows.SetLeaves(winnerLeafId, loserLeafId);
 
         ui32 bucketOffset = 0;
         for (auto bundlePartIdx : xrange(exclusiveFeaturesBundle.Parts.size())) {
@@ -198,14 +242,14 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
             auto loserBucketId = NCB::GetBinFromBundle<ui32>(loserBundleValue, boundsInBundle);
 
             if (winnerBucketId > loserBucketId) {
-                weightSums[loserLeafId][winnerLeafId][bucketOffset + loserBucketId].SmallerBorderWeightSum
+                rows.LoserWinner[bucketOffset + loserBucketId].SmallerBorderWeightSum
                     -= weight;
-                weightSums[loserLeafId][winnerLeafId][bucketOffset + winnerBucketId].GreaterBorderRightWeightSum
+                rows.LoserWinner[bucketOffset + winnerBucketId].GreaterBorderRightWeightSum
                     -= weight;
             } else {
-                weightSums[winnerLeafId][loserLeafId][bucketOffset + winnerBucketId].SmallerBorderWeightSum
+                rows.WinnerLoser[bucketOffset + winnerBucketId].SmallerBorderWeightSum
                     -= weight;
-                weightSums[winnerLeafId][loserLeafId][bucketOffset + loserBucketId].GreaterBorderRightWeightSum
+                rows.WinnerLoser[bucketOffset + loserBucketId].GreaterBorderRightWeightSum
                     -= weight;
             }
 
@@ -229,6 +273,7 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
 ) {
     TArray2D<TVector<TBucketPairWeightStatistics>> weightSums(leafCount, leafCount);
     weightSums.FillEvery(TVector<TBucketPairWeightStatistics>(featuresGroup.TotalBucketCount));
+    TPairWeightStatisticsRows rows(&weightSums);
     for (size_t pairIdx : pairIndexRange.Iter()) {
         const auto winnerIdx = pairs[pairIdx].WinnerId;
         const auto loserIdx = pairs[pairIdx].LoserId;
@@ -240,6 +285,7 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
         const auto loserGroupValue = getFeaturesGroupValue(loserIdx);
         const auto loserLeafId = leafIndices[loserIdx];
         const float weight = pairs[pairIdx].Weight;
+        rows.SetLeaves(winnerLeafId, loserLeafId);
 
         ui32 bucketOffset = 0;
         for (auto partIdx : xrange(featuresGroup.Parts.size())) {
@@ -247,14 +293,14 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
             auto loserBucketId = NCB::GetPartValueFromGroup(loserGroupValue, partIdx);
 
             if (winnerBucketId > loserBucketId) {
-                weightSums[loserLeafId][winnerLeafId][bucketOffset + loserBucketId].SmallerBorderWeightSum
+                rows.LoserWinner[bucketOffset + loserBucketId].SmallerBorderWeightSum
                     -= weight;
-                weightSums[loserLeafId][winnerLeafId][bucketOffset + winnerBucketId].GreaterBorderRightWeightSum
+                rows.LoserWinner[bucketOffset + winnerBucketId].GreaterBorderRightWeightSum
                     -= weight;
             } else {
-                weightSums[winnerLeafId][loserLeafId][bucketOffset + winnerBucketId].SmallerBorderWeightSum
+                rows.WinnerLoser[bucketOffset + winnerBucketId].SmallerBorderWeightSum
                     -= weight;
-                weightSums[winnerLeafId][loserLeafId][bucketOffset + loserBucketId].GreaterBorderRightWeightSum
+                rows.WinnerLoser[bucketOffset + loserBucketId].GreaterBorderRightWeightSum
                     -= weight;
             }
 
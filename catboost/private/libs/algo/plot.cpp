@@ -94,24 +94,6 @@ void TMetricsPlotCalcer::ComputeAdditiveMetric(
     }
 }
 
-void TMetricsPlotCalcer::Append(
-    const TVector<TVector<double>>& approx,
-    int dstStartDoc,
-    TVector<TVector<double>>* dst
-) {
-    const ui32 docCount = approx[0].size();
-
-    for (ui32 dim = 0; dim < approx.size(); ++dim) {
-        NPar::ParallelFor(
-            Executor,
-            0,
-            docCount,
-            [&](int i) {
-                (*dst)[dim][dstStartDoc + i] += approx[dim][i];
-            });
-    };
-}
-
 TMetricsPlotCalcer& TMetricsPlotCalcer::ProceedDataSetForAdditiveMetrics(
     const TProcessedDataProvider& processedData
 ) {
@@ -262,13 +244,7 @@ TMetricsPlotCalcer& TMetricsPlotCalcer::ProceedDataSet(
 
     for (ui32 iterationIndex = beginIterationIndex; iterationIndex < endIterationIndex; ++iterationIndex) {
         end = Iterations[iterationIndex] + 1;
-        modelCalcerOnPool.ApplyModelMulti(
-            EPredictionType::InternalRawFormulaVal,
-            begin,
-            end,
-            &FlatApproxBuffer,
-            &NextApproxBuffer);
-        Append(NextApproxBuffer, 0, &CurApproxBuffer);
+        modelCalcerOnPool.AddRawFormulaValsToApprox(begin, end, 0, &FlatApproxBuffer, &CurApproxBuffer);
 
         if (isAdditiveMetrics) {
             ComputeAdditiveMetric(
@@ -283,7 +259,6 @@ TMetricsPlotCalcer& TMetricsPlotCalcer::ProceedDataSet(
         begin = end;
     }
     ClearApproxBuffer(&CurApproxBuffer);
-    ClearApproxBuffer(&NextApproxBuffer);
 
     return *this;
 }
@@ -378,13 +353,7 @@ void TMetricsPlotCalcer::ComputeNonAdditiveMetrics(const TVector<TProcessedDataP
         int end = Iterations[iterationIndex] + 1;
         for (int poolPartIdx = 0; poolPartIdx < modelCalcers.ysize(); ++poolPartIdx) {
             auto& calcer = modelCalcers[poolPartIdx];
-            calcer.ApplyModelMulti(
-                EPredictionType::InternalRawFormulaVal,
-                begin,
-                end,
-                &FlatApproxBuffer,
-                &NextApproxBuffer);
-            Append(NextApproxBuffer, startDocIdx[poolPartIdx], &curApprox);
+            calcer.AddRawFormulaValsToApprox(begin, end, startDocIdx[poolPartIdx], &FlatApproxBuffer, &curApprox);
         }
 
         auto results = EvalErrorsWithCaching(
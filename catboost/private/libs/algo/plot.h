@@ -121,12 +121,6 @@ private:
         ui32 plotLineIndex
     );
 
-    void Append(
-        const TVector<TVector<double>>& approx,
-        int dstStartDoc /*= 0*/,
-        TVector<TVector<double>>* dst
-    );
-
     void EnsureCorrectParams() {
         CB_ENSURE(First < Last, "First iteration should be less than last");
         CB_ENSURE(Step <= (Last - First), "Step should be less than plot size");
@@ -200,7 +194,6 @@ private:
 
     TVector<double> FlatApproxBuffer;
     TVector<TVector<double>> CurApproxBuffer;
-    TVector<TVector<double>> NextApproxBuffer;
 };
 
 TMetricsPlotCalcer CreateMetricCalcer(
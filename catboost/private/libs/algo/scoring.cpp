@@ -10,6 +10,7 @@
 #include "tensor_search_helpers.h"
 
 #include <catboost/libs/data/objects.h>
+#include <catboost/libs/data/sparse_columns.h>
 #include <catboost/libs/helpers/map_merge.h>
 #include <catboost/private/libs/algo_helpers/online_predictor.h>
 #include <catboost/private/libs/algo_helpers/scoring_helpers.h>
@@ -62,16 +63,16 @@ inline static void SetSingleIndex(
     const ui32* bucketIndexing, // can be nullptr for simple case, use bucketBeginOffset instead then
     const int bucketBeginOffset,
     const int permBlockSize,
-    NCB::TIndexRange<int> docIndexRange, // aligned by permutation blocks in docPermutation
-    TVector<TFullIndexType>* singleIdx // already of proper size
+    NCB::TIndexRange<int> docIndexRange,
+    TArrayRef<TFullIndexType> singleIdx // for objects in docIndexRange
 ) {
     const int docCount = fold.GetDocCount();
     const TIndexType* indices = GetDataPtr(fold.Indices);
-    const TArrayRef<TFullIndexType> singleIdxRef(*singleIdx);
+    Y_ASSERT(singleIdx.size() >= (size_t)docIndexRange.GetSize());
 
     if (bucketIndexing == nullptr) {
         for (int doc : docIndexRange.Iter()) {
-            singleIdxRef[doc] = indexer.GetIndex(indices[doc], bucketIndex[bucketBeginOffset + doc]);
+            singleIdx[doc - docIndexRange.Begin] = indexer.GetIndex(indices[doc], bucketIndex[bucketBeginOffset + doc]);
         }
     } else if (permBlockSize > 1) {
         const int blockCount = (docCount + permBlockSize - 1) / permBlockSize;
@@ -80,24 +81,27 @@ inline static void SetSingleIndex(
             || (static_cast<int>(bucketIndexing[0]) + permBlockSize - 1
             == static_cast<int>(bucketIndexing[permBlockSize - 1]))
         );
+        // docIndexRange.Begin can be in the middle of a permutation block
         int blockStart = docIndexRange.Begin;
         while (blockStart < docIndexRange.End) {
-            const int blockIdx = static_cast<int>(bucketIndexing[blockStart]) / permBlockSize;
+            const int originalBlockStart = static_cast<int>(bucketIndexing[blockStart]);
+            const int blockIdx = originalBlockStart / permBlockSize;
+            const int originalBlockEnd
+                = (blockIdx + 1 == blockCount) ? docCount : (blockIdx + 1) * permBlockSize;
             const int nextBlockStart = Min(
-                blockStart + (blockIdx + 1 == blockCount ? docCount - blockIdx * permBlockSize : permBlockSize),
+                blockStart + (originalBlockEnd - originalBlockStart),
                 docIndexRange.End
             );
-            const int originalBlockIdx = static_cast<int>(bucketIndexing[blockStart]);
             for (int doc = blockStart; doc < nextBlockStart; ++doc) {
-                const int originalDocIdx = originalBlockIdx + doc - blockStart;
-                singleIdxRef[doc] = indexer.GetIndex(indices[doc], bucketIndex[originalDocIdx]);
+                const int originalDocIdx = originalBlockStart + doc - blockStart;
+                singleIdx[doc - docIndexRange.Begin] = indexer.GetIndex(indices[doc], bucketIndex[originalDocIdx]);
             }
             blockStart = nextBlockStart;
         }
     } else {
         for (int doc : docIndexRange.Iter()) {
             const ui32 originalDocIdx = bucketIndexing[doc];
-            singleIdxRef[doc] = indexer.GetIndex(indices[doc], bucketIndex[originalDocIdx]);
+            singleIdx[doc - docIndexRange.Begin] = indexer.GetIndex(indices[doc], bucketIndex[originalDocIdx]);
         }
     }
 }
@@ -139,7 +143,7 @@ inline static void BuildSingleIndex(
     bool isOnlineData,
     const TStatsIndexer& indexer,
     NCB::TIndexRange<int> docIndexRange,
-    TVector<TFullIndexType>* singleIdx // already of proper size
+    TArrayRef<TFullIndexType> singleIdx // for objects in docIndexRange
 ) {
     if (const auto* denseColumnData
             = dynamic_cast<const TCompressedValuesHolderImpl<TColumn>*>(&column))
@@ -188,7 +192,7 @@ inline static void BuildSingleIndex(
     const TSplitEnsemble& splitEnsemble,
     const TStatsIndexer& indexer,
     NCB::TIndexRange<int> docIndexRange,
-    TVector<TFullIndexType>* singleIdx // already of proper size
+    TArrayRef<TFullIndexType> singleIdx // for objects in docIndexRange
 ) {
     if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
         const TCtr& ctr = splitEnsemble.SplitCandidate.Ctr;
@@ -266,72 +270,172 @@ inline static void BuildSingleIndex(
 }
 
 
+// Bucket stats accumulated in single precision, used in EHistogramPrecision::Float mode.
+// Sums are added to TBucketStats after each block of objects, so score calculation and caching
+// still work with double stats.
+struct TBucketStatsFloat {
+    float SumWeightedDelta;
+    float SumWeight;
+    float SumDelta;
+    float Count;
+
+public:
+    inline void Add(const TBucketStatsFloat& other) {
+        SumWeightedDelta += other.SumWeightedDelta;
+        SumDelta += other.SumDelta;
+        SumWeight += other.SumWeight;
+        Count += other.Count;
+    }
+};
+
+static_assert(
+    std::is_pod<TBucketStatsFloat>::value,
+    "TBucketStatsFloat must be pod to avoid memory initialization in yresize"
+);
+
+
+// Objects are processed by tiles of this size in CalcStatsImpl so that leaf and bucket indices
+// of a tile stay in L1 cache between building and accumulation of stats.
+static constexpr int CalcStatsTileSize = 4096;
+
+
+// Small histograms are accumulated into several copies of stats that are summed after the loop.
+// Otherwise the same hot buckets are updated by consecutive objects, and each update has to wait
+// for the store of the previous one.
+static constexpr int StatsCopyCount = 4;
+static constexpr int MaxStatsCountForCopies = 64;
+
+
+// addFunc must accept (doc, stats) params
+template <typename TStats, typename TAddFunc>
+inline static void AccumulateStats(
+    NCB::TIndexRange<int> docIndexRange,
+    int statsCount,
+    TAddFunc addFunc,
+    TStats* stats
+) {
+    if ((statsCount > MaxStatsCountForCopies) || (docIndexRange.GetSize() < statsCount * StatsCopyCount)) {
+        for (int doc : docIndexRange.Iter()) {
+            addFunc(doc, stats);
+        }
+        return;
+    }
+
+    TStats statsCopies[StatsCopyCount - 1][MaxStatsCountForCopies];
+    for (auto& statsCopy : statsCopies) {
+        Fill(statsCopy, statsCopy + statsCount, TStats{0, 0, 0, 0});
+    }
+
+    int doc = docIndexRange.Begin;
+    for (; doc + StatsCopyCount <= docIndexRange.End; doc += StatsCopyCount) {
+        addFunc(doc, stats);
+        addFunc(doc + 1, statsCopies[0]);
+        addFunc(doc + 2, statsCopies[1]);
+        addFunc(doc + 3, statsCopies[2]);
+    }
+    for (; doc < docIndexRange.End; ++doc) {
+        addFunc(doc, stats);
+    }
+
+    for (const auto& statsCopy : statsCopies) {
+        for (auto i : xrange(statsCount)) {
+            stats[i].Add(statsCopy[i]);
+        }
+    }
+}
+
+
 // Update bootstraped sums on docIndexRange in a bucket
-template <typename TFullIndexType>
+template <typename TFullIndexType, typename TStats>
 inline static void UpdateWeighted(
-    const TVector<TFullIndexType>& singleIdx,
+    const TFullIndexType* singleIdx, // for objects in docIndexRange
     const double* weightedDer,
     const float* sampleWeights,
     NCB::TIndexRange<int> docIndexRange,
-    TBucketStats* stats
+    int statsCount,
+    TStats* stats
 ) {
-    for (int doc : docIndexRange.Iter()) {
-        TBucketStats& leafStats = stats[singleIdx[doc]];
-        leafStats.SumWeightedDelta += weightedDer[doc];
-        leafStats.SumWeight += sampleWeights[doc];
-    }
+    AccumulateStats(
+        docIndexRange,
+        statsCount,
+        [&] (int doc, TStats* statsToUpdate) {
+            TStats& leafStats = statsToUpdate[singleIdx[doc - docIndexRange.Begin]];
+            leafStats.SumWeightedDelta += weightedDer[doc];
+            leafStats.SumWeight += sampleWeights[doc];
+        },
+        stats
+    );
 }
 
 
 // Update not bootstraped sums on docIndexRange in a bucket
-template <typename TFullIndexType>
+template <typename TFullIndexType, typename TStats>
 inline static void UpdateDeltaCount(
-    const TVector<TFullIndexType>& singleIdx,
+    const TFullIndexType* singleIdx, // for objects in docIndexRange
     const double* derivatives,
     const float* learnWeights,
     NCB::TIndexRange<int> docIndexRange,
-    TBucketStats* stats
+    int statsCount,
+    TStats* stats
 ) {
     if (learnWeights == nullptr) {
-        for (int doc : docIndexRange.Iter()) {
-            TBucketStats& leafStats = stats[singleIdx[doc]];
-            leafStats.SumDelta += derivatives[doc];
-            leafStats.Count += 1;
-        }
+        AccumulateStats(
+            docIndexRange,
+            statsCount,
+            [&] (int doc, TStats* statsToUpdate) {
+                TStats& leafStats = statsToUpdate[singleIdx[doc - docIndexRange.Begin]];
+                leafStats.SumDelta += derivatives[doc];
+                leafStats.Count += 1;
+            },
+            stats
+        );
     } else {
-        for (int doc : docIndexRange.Iter()) {
-            TBucketStats& leafStats = stats[singleIdx[doc]];
-            leafStats.SumDelta += derivatives[doc];
-            leafStats.Count += learnWeights[doc];
-        }
+        AccumulateStats(
+            docIndexRange,
+            statsCount,
+            [&] (int doc, TStats* statsToUpdate) {
+                TStats& leafStats = statsToUpdate[singleIdx[doc - docIndexRange.Begin]];
+                leafStats.SumDelta += derivatives[doc];
+                leafStats.Count += learnWeights[doc];
+            },
+            stats
+        );
     }
 }
 
 
-template <typename TFullIndexType>
-inline static void CalcStatsKernel(
+// Zero stats before accumulation, stats for the previous depth are kept if isCaching
+template <typename TStats>
+inline static void ResetStats(
     bool isCaching,
-    const TVector<TFullIndexType>& singleIdx,
-    const TCalcScoreFold& fold,
-    bool isPlainMode,
     const TStatsIndexer& indexer,
     int depth,
-    const TCalcScoreFold::TBodyTail& bt,
-    int dim,
-    NCB::TIndexRange<int> docIndexRange,
-    TBucketStats* stats
+    TStats* stats
 ) {
     Y_ASSERT(!isCaching || depth > 0);
     if (isCaching) {
         Fill(
             stats + indexer.CalcSize(depth - 1),
             stats + indexer.CalcSize(depth),
-            TBucketStats{0, 0, 0, 0}
+            TStats{0, 0, 0, 0}
         );
     } else {
-        Fill(stats, stats + indexer.CalcSize(depth), TBucketStats{0, 0, 0, 0});
+        Fill(stats, stats + indexer.CalcSize(depth), TStats{0, 0, 0, 0});
     }
+}
+
 
+template <typename TFullIndexType, typename TStats>
+inline static void CalcStatsKernel(
+    const TFullIndexType* singleIdx, // for objects in docIndexRange
+    const TCalcScoreFold& fold,
+    bool isPlainMode,
+    const TCalcScoreFold::TBodyTail& bt,
+    int dim,
+    NCB::TIndexRange<int> docIndexRange,
+    int statsCount,
+    TStats* stats
+) {
     if (bt.TailFinish > docIndexRange.Begin) {
         const bool hasPairwiseWeights = !bt.PairwiseWeights.empty();
         const float* weightsData = hasPairwiseWeights ?
@@ -347,6 +451,7 @@ inline static void CalcStatsKernel(
                 GetDataPtr(bt.SampleWeightedDerivatives[dim]),
                 sampleWeightsData,
                 NCB::TIndexRange<int>(docIndexRange.Begin, tailFinishInRange),
+                statsCount,
                 stats
             );
         } else {
@@ -356,15 +461,17 @@ inline static void CalcStatsKernel(
                     GetDataPtr(bt.WeightedDerivatives[dim]),
                     weightsData,
                     NCB::TIndexRange<int>(docIndexRange.Begin, Min((int)bt.BodyFinish, docIndexRange.End)),
+                    statsCount,
                     stats
                 );
             }
             if (tailFinishInRange > bt.BodyFinish) {
                 UpdateWeighted(
-                    singleIdx,
+                    singleIdx + (Max((int)bt.BodyFinish, docIndexRange.Begin) - docIndexRange.Begin),
                     GetDataPtr(bt.SampleWeightedDerivatives[dim]),
                     sampleWeightsData,
                     NCB::TIndexRange<int>(Max((int)bt.BodyFinish, docIndexRange.Begin), tailFinishInRange),
+                    statsCount,
                     stats
                 );
             }
@@ -402,6 +509,7 @@ static void CalcStatsImpl(
     const TStatsIndexer& indexer,
     const TIsCaching& /*isCaching*/,
     bool /*isPlainMode*/,
+    EHistogramPrecision /*histogramPrecision*/,
     ui32 oneHotMaxSize,
     int depth,
     int /*splitStatsCount*/,
@@ -542,6 +650,150 @@ static void CalcStatsImpl(
 }
 
 
+// Stats of a sparse column are accumulated only for objects with non-default values, stats of the
+// default bucket are obtained by subtraction from the stats of all objects in each leaf.
+// Returns false if the column is not sparse, stats are final (fixed up if isCaching) otherwise.
+template <class TColumn>
+static bool CalcSparseColumnStats(
+    const TCalcScoreFold& fold,
+    const TFeaturesArraySubsetIndexing& featuresArraySubsetIndexing,
+    const TColumn& column,
+    const TStatsIndexer& indexer,
+    bool isCaching,
+    bool isPlainMode,
+    int depth,
+    int splitStatsCount,
+    NPar::TLocalExecutor* localExecutor,
+    TBucketStatsRefOptionalHolder* stats
+) {
+    const auto* sparseColumnData = dynamic_cast<const TSparseCompressedValuesHolderImpl<TColumn>*>(&column);
+    if (!sparseColumnData) {
+        return false;
+    }
+    const auto& sparseArray = sparseColumnData->GetData();
+    Y_ASSERT(sparseArray.GetSize() == featuresArraySubsetIndexing.Size());
+
+    const int leafCount = 1 << depth;
+    const TCalcScoreFold::TSparseScoringData& sparseScoringData = fold.GetSparseScoringData(
+        featuresArraySubsetIndexing,
+        leafCount,
+        isPlainMode,
+        localExecutor
+    );
+
+    const int bodyTailCount = fold.GetBodyTailCount();
+    const int approxDimension = fold.GetApproxDimension();
+    if (stats->NonInited()) {
+        (*stats) = TBucketStatsRefOptionalHolder(bodyTailCount * approxDimension * splitStatsCount);
+    }
+    TBucketStats* statsData = stats->GetData().data();
+    for (auto statsSubsetIdx : xrange(bodyTailCount * approxDimension)) {
+        ResetStats(isCaching, indexer, depth, statsData + statsSubsetIdx * splitStatsCount);
+    }
+
+    // [bodyTail][dim][leaf]
+    TVector<TBucketStats> nonDefaultLeafStats(bodyTailCount * approxDimension * leafCount, TBucketStats{0, 0, 0, 0});
+
+    const TIndexType* indices = GetDataPtr(fold.Indices);
+    TConstArrayRef<ui32> foldPositions = sparseScoringData.FoldPositions;
+    sparseArray.ForEachNonDefault(
+        [&] (ui32 objectIdx, auto bucket) {
+            const ui32 doc = foldPositions[objectIdx];
+            if (doc == TCalcScoreFold::TSparseScoringData::InvalidFoldPosition) {
+                return;
+            }
+            const int statsIdx = indexer.GetIndex(indices[doc], bucket);
+            for (int bodyTailIdx : xrange(bodyTailCount)) {
+                for (int dim : xrange(approxDimension)) {
+                    const int statsSubsetIdx = bodyTailIdx * approxDimension + dim;
+                    fold.AddDocStats(
+                        bodyTailIdx,
+                        dim,
+                        isPlainMode,
+                        doc,
+                        &statsData[statsSubsetIdx * splitStatsCount + statsIdx]
+                    );
+                    fold.AddDocStats(
+                        bodyTailIdx,
+                        dim,
+                        isPlainMode,
+                        doc,
+                        &nonDefaultLeafStats[statsSubsetIdx * leafCount + indices[doc]]
+                    );
+                }
+            }
+        }
+    );
+
+    const int defaultBucket = sparseArray.GetDefaultValue();
+    for (auto statsSubsetIdx : xrange(bodyTailCount * approxDimension)) {
+        for (auto leaf : xrange(leafCount)) {
+            TBucketStats defaultBucketStats = sparseScoringData.LeafStats[statsSubsetIdx * leafCount + leaf];
+            defaultBucketStats.Remove(nonDefaultLeafStats[statsSubsetIdx * leafCount + leaf]);
+            statsData[statsSubsetIdx * splitStatsCount + indexer.GetIndex(leaf, defaultBucket)].Add(
+                defaultBucketStats
+            );
+        }
+        if (isCaching) {
+            FixUpStats(depth, indexer, fold.SmallestSplitSideValue, statsData + statsSubsetIdx * splitStatsCount);
+        }
+    }
+    return true;
+}
+
+
+// Only columns of features from the main data can be scored as sparse,
+// because fold positions are built from the main features subset indexing.
+static bool CalcSparseStats(
+    const TCalcScoreFold& fold,
+    const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
+    const TSplitEnsemble& splitEnsemble,
+    const TStatsIndexer& indexer,
+    bool isCaching,
+    bool isPlainMode,
+    int depth,
+    int splitStatsCount,
+    NPar::TLocalExecutor* localExecutor,
+    TBucketStatsRefOptionalHolder* stats
+) {
+    if ((splitEnsemble.Type != ESplitEnsembleType::OneFeature)
+        || splitEnsemble.IsEstimated
+        || splitEnsemble.IsOnlineEstimated)
+    {
+        return false;
+    }
+
+    auto calcSparseColumnStats = [&] (const auto& column) {
+        return CalcSparseColumnStats(
+            fold,
+            objectsDataProvider.GetFeaturesArraySubsetIndexing(),
+            column,
+            indexer,
+            isCaching,
+            isPlainMode,
+            depth,
+            splitStatsCount,
+            localExecutor,
+            stats
+        );
+    };
+
+    const auto& splitCandidate = splitEnsemble.SplitCandidate;
+    switch (splitCandidate.Type) {
+        case ESplitType::FloatFeature:
+            return calcSparseColumnStats(
+                **objectsDataProvider.GetNonPackedFloatFeature((ui32)splitCandidate.FeatureIdx)
+            );
+        case ESplitType::OneHotFeature:
+            return calcSparseColumnStats(
+                **objectsDataProvider.GetNonPackedCatFeature((ui32)splitCandidate.FeatureIdx)
+            );
+        default:
+            return false;
+    }
+}
+
+
 template <typename TFullIndexType, typename TIsCaching>
 static void CalcStatsImpl(
     const TCalcScoreFold& fold,
@@ -552,6 +804,7 @@ static void CalcStatsImpl(
     const TStatsIndexer& indexer,
     const TIsCaching& isCaching,
     bool isPlainMode,
+    EHistogramPrecision histogramPrecision,
     ui32 /*oneHotMaxSize*/,
     int depth,
     int splitStatsCount,
@@ -560,11 +813,6 @@ static void CalcStatsImpl(
 ) {
     Y_ASSERT(!isCaching || depth > 0);
 
-    const int docCount = fold.GetDocCount();
-
-    TVector<TFullIndexType> singleIdx;
-    singleIdx.yresize(docCount);
-
     const int statsCount = fold.GetBodyTailCount() * fold.GetApproxDimension() * splitStatsCount;
     const int filledSplitStatsCount = indexer.CalcSize(depth);
 
@@ -578,6 +826,21 @@ static void CalcStatsImpl(
         }
     };
 
+    if (CalcSparseStats(
+            fold,
+            objectsDataProvider,
+            splitEnsemble,
+            indexer,
+            isCaching,
+            isPlainMode,
+            depth,
+            splitStatsCount,
+            localExecutor,
+            stats))
+    {
+        return;
+    }
+
     NCB::MapMerge(
         localExecutor,
         fold.GetCalcStatsIndexRanges(),
@@ -589,39 +852,94 @@ static void CalcStatsImpl(
                 )
                 : indexRange;
 
-            BuildSingleIndex(
-                fold,
-                objectsDataProvider,
-                allCtrs,
-                splitEnsemble,
-                indexer,
-                docIndexRange,
-                &singleIdx
-            );
-
             if (output->NonInited()) {
                 (*output) = TBucketStatsRefOptionalHolder(statsCount);
             } else {
                 Y_ASSERT(docIndexRange.Begin == 0);
             }
 
+            const bool useFloatStats = (histogramPrecision == EHistogramPrecision::Float);
+            TVector<TBucketStatsFloat> floatStats;
+            if (useFloatStats) {
+                floatStats.yresize(statsCount);
+            }
+
             forEachBodyTailAndApproxDimension(
-                [&](int bodyTailIdx, int dim, int bucketStatsArrayBegin) {
-                    TBucketStats* statsSubset = output->GetData().data() + bucketStatsArrayBegin;
-                    CalcStatsKernel(
+                [&](int /*bodyTailIdx*/, int /*dim*/, int bucketStatsArrayBegin) {
+                    ResetStats(
                         isCaching && (indexRange.Begin == 0),
-                        singleIdx,
-                        fold,
-                        isPlainMode,
                         indexer,
                         depth,
-                        fold.BodyTailArr[bodyTailIdx],
-                        dim,
-                        docIndexRange,
-                        statsSubset
+                        output->GetData().data() + bucketStatsArrayBegin
                     );
+                    if (useFloatStats) {
+                        ResetStats(/*isCaching*/ false, indexer, depth, floatStats.data() + bucketStatsArrayBegin);
+                    }
                 }
             );
+
+            // singleIdx for a tile of objects is used for all body tails and approx dimensions right after
+            // it is built, while it is still in cache
+            TVector<TFullIndexType> singleIdx;
+            singleIdx.yresize(Min(CalcStatsTileSize, docIndexRange.GetSize()));
+
+            for (int tileBegin = docIndexRange.Begin; tileBegin < docIndexRange.End; tileBegin += CalcStatsTileSize) {
+                const NCB::TIndexRange<int> tileIndexRange(
+                    tileBegin,
+                    Min(tileBegin + CalcStatsTileSize, docIndexRange.End)
+                );
+
+                BuildSingleIndex(
+                    fold,
+                    objectsDataProvider,
+                    allCtrs,
+                    splitEnsemble,
+                    indexer,
+                    tileIndexRange,
+                    TArrayRef<TFullIndexType>(singleIdx)
+                );
+
+                forEachBodyTailAndApproxDimension(
+                    [&](int bodyTailIdx, int dim, int bucketStatsArrayBegin) {
+                        auto calcStatsKernel = [&] (auto* stats) {
+                            CalcStatsKernel(
+                                singleIdx.data(),
+                                fold,
+                                isPlainMode,
+                                fold.BodyTailArr[bodyTailIdx],
+                                dim,
+                                tileIndexRange,
+                                filledSplitStatsCount,
+                                stats + bucketStatsArrayBegin
+                            );
+                        };
+                        if (useFloatStats) {
+                            calcStatsKernel(floatStats.data());
+                        } else {
+                            calcStatsKernel(output->GetData().data());
+                        }
+                    }
+                );
+            }
+
+            if (useFloatStats) {
+                forEachBodyTailAndApproxDimension(
+                    [&](int /*bodyTailIdx*/, int /*dim*/, int bucketStatsArrayBegin) {
+                        TBucketStats* statsSubset = output->GetData().data() + bucketStatsArrayBegin;
+                        const TBucketStatsFloat* floatStatsSubset = floatStats.data() + bucketStatsArrayBegin;
+                        for (auto i : xrange(filledSplitStatsCount)) {
+                            statsSubset[i].Add(
+                                TBucketStats{
+                                    floatStatsSubset[i].SumWeightedDelta,
+                                    floatStatsSubset[i].SumWeight,
+                                    floatStatsSubset[i].SumDelta,
+                                    floatStatsSubset[i].Count
+                                }
+                            );
+                        }
+                    }
+                );
+            }
         },
         /*mergeFunc*/[&](
             TBucketStatsRefOptionalHolder* output,
@@ -902,6 +1220,8 @@ void CalcStatsAndScores(
     const TStatsIndexer indexer(bucketCount);
     const int fullIndexBitCount = depth + GetValueBitCount(bucketCount - 1);
     const bool isPlainMode = IsPlainMode(fitParams.BoostingOptions->BoostingType);
+    const EHistogramPrecision histogramPrecision
+        = fitParams.ObliviousTreeOptions->HistogramPrecision.GetUnchecked();
 
     const float l2Regularizer = static_cast<const float>(fitParams.ObliviousTreeOptions->L2Reg);
     const ui32 oneHotMaxSize = fitParams.CatFeatureParams.Get().OneHotMaxSize.Get();
@@ -922,6 +1242,7 @@ void CalcStatsAndScores(
                 indexer,
                 isCaching,
                 isPlainMode,
+                histogramPrecision,
                 oneHotMaxSize,
                 depth,
                 splitStatsCount,
@@ -938,6 +1259,7 @@ void CalcStatsAndScores(
                 indexer,
                 isCaching,
                 isPlainMode,
+                histogramPrecision,
                 oneHotMaxSize,
                 depth,
                 splitStatsCount,
@@ -954,6 +1276,7 @@ void CalcStatsAndScores(
                 indexer,
                 isCaching,
                 isPlainMode,
+                histogramPrecision,
                 oneHotMaxSize,
                 depth,
                 splitStatsCount,
@@ -443,6 +443,7 @@ void Bootstrap(
     const float takenFraction = params.ObliviousTreeOptions->BootstrapConfig->GetTakenFraction();
     const bool isPairwiseScoring = IsPairwiseScoring(params.LossFunctionDescription->GetLossFunction());
     const TMaybe<float> mvsReg = params.ObliviousTreeOptions->BootstrapConfig->GetMvsReg();
+    const float gossTopRate = params.ObliviousTreeOptions->BootstrapConfig->GetGossTopRate();
     bool performRandomChoice = true;
     if (bootstrapType != EBootstrapType::No && samplingUnit == ESamplingUnit::Group) {
         CB_ENSURE(!fold->LearnQueriesInfo.empty(), "No groups in dataset. Please disable sampling or use per object sampling");
@@ -479,6 +480,17 @@ void Bootstrap(
                 sampler.GenSampleWeights(boostingType, leafValues, rand, localExecutor, fold);
             }
             break;
+        case EBootstrapType::GOSS:
+            CB_ENSURE(
+                samplingUnit != ESamplingUnit::Group,
+                "GOSS bootstrap is not implemented for groupwise sampling (sampling_unit=Group)"
+            );
+            if (!isPairwiseScoring) {
+                performRandomChoice = false;
+                TGossSampler sampler(learnSampleCount, takenFraction, gossTopRate);
+                sampler.GenSampleWeights(boostingType, rand, localExecutor, fold);
+            }
+            break;
         case EBootstrapType::No:
             if (!isPairwiseScoring) {
                 Fill(fold->SampleWeights.begin(), fold->SampleWeights.end(), 1);
@@ -597,6 +609,11 @@ void CalcWeightedDerivatives(
                 blockParams.GetBlockCount(),
                 NPar::TLocalExecutor::WAIT_COMPLETE);
         } else if (approxDimension == 1) {
+            if (bt.AreWeightedDerivativesActual) {
+                // already calculated by UpdateBodyTailApproxAndDers
+                bt.AreWeightedDerivativesActual = false;
+                return;
+            }
             localExecutor->ExecRangeWithThrow(
                 [&](int blockId) {
                     const int blockOffset = blockId * blockParams.GetBlockSize();
@@ -53,17 +53,32 @@ static void UpdateLearningFold(
         &approxDelta
     );
 
-    if (error.GetIsExpApprox()) {
+    // with a single learn fold it is the fold taken for the next iteration,
+    // so its derivatives can be calculated right after the approx update
+    const bool calcDersForNextIteration = ctx->LearnProgress->Folds.size() == 1
+        && ctx->Params.BoostingOptions->ModelShrinkRate.Get() == 0
+        && error.GetErrorType() == EErrorType::PerObjectError
+        && fold->GetApproxDimension() == 1
+        && !dynamic_cast<const TMultiDerCalcer*>(&error);
+    const double learningRate = ctx->Params.BoostingOptions->LearningRate;
+
+    if (calcDersForNextIteration) {
+        if (error.GetIsExpApprox()) {
+            UpdateBodyTailApproxAndDers</*StoreExpApprox*/true>(approxDelta, learningRate, error, ctx->LocalExecutor, fold);
+        } else {
+            UpdateBodyTailApproxAndDers</*StoreExpApprox*/false>(approxDelta, learningRate, error, ctx->LocalExecutor, fold);
+        }
+    } else if (error.GetIsExpApprox()) {
         UpdateBodyTailApprox</*StoreExpApprox*/true>(
             approxDelta,
-            ctx->Params.BoostingOptions->LearningRate,
+            learningRate,
             ctx->LocalExecutor,
             fold
         );
     } else {
         UpdateBodyTailApprox</*StoreExpApprox*/false>(
             approxDelta,
-            ctx->Params.BoostingOptions->LearningRate,
+            learningRate,
             ctx->LocalExecutor,
             fold
         );
@@ -80,6 +95,7 @@ static void ScaleAllApproxes(
     for (auto& fold : learnProgress->Folds) {
         for (auto &bodyTail : fold.BodyTailArr) {
             allApproxes.push_back(&bodyTail.Approx);
+            bodyTail.AreWeightedDerivativesActual = false;
         }
     }
     allApproxes.push_back(&learnProgress->AveragingFold.BodyTailArr[0].Approx);
@@ -188,6 +204,7 @@ void TrainOneIteration(const NCB::TTrainingDataProviders& data, TLearnContext* c
                 ctx->Params.BoostingOptions->ModelShrinkMode == EModelShrinkMode::Constant
                 ? (1 - modelShrinkRate * ctx->Params.BoostingOptions->LearningRate)
                 : (1 - modelShrinkRate / static_cast<double>(iterationIndex));
+            ApplyPendingTestApproxUpdates(data, ctx);
             ScaleAllApproxes(
                 modelShrinkage,
                 error->GetIsExpApprox(),
@@ -248,8 +265,8 @@ void TrainOneIteration(const NCB::TTrainingDataProviders& data, TLearnContext* c
             trainFolds.push_back(&ctx->LearnProgress->Folds[foldId]);
         }
 
-        TrimOnlineCTRcache(trainFolds);
-        TrimOnlineCTRcache({ &ctx->LearnProgress->AveragingFold });
+        TrimOnlineCTRcache(trainFolds, *ctx);
+        TrimOnlineCTRcache({ &ctx->LearnProgress->AveragingFold }, *ctx);
         {
             TVector<TFold*> allFolds = trainFolds;
             allFolds.push_back(&ctx->LearnProgress->AveragingFold);
@@ -321,6 +338,14 @@ void TrainOneIteration(const NCB::TTrainingDataProviders& data, TLearnContext* c
 
             TVector<TIndexType> indices;
 
+            /* test approxes are needed only for metrics, so they are updated lazily,
+             * trees with ctrs are applied immediately because ctr values can be dropped from the fold
+             */
+            const bool deferTestApproxUpdate = !data.Test.empty() && GetUsedCtrs(bestTree).empty();
+            if (!deferTestApproxUpdate) {
+                ApplyPendingTestApproxUpdates(data, ctx);
+            }
+
             const bool treeHasMonotonicConstraints = !ctx->Params.ObliviousTreeOptions->MonotoneConstraints.GetUnchecked().empty();
             if (
                 ctx->Params.ObliviousTreeOptions->DevLeafwiseApproxes.Get() &&
@@ -342,6 +367,7 @@ void TrainOneIteration(const NCB::TTrainingDataProviders& data, TLearnContext* c
                     *error,
                     ctx->LearnProgress->AveragingFold,
                     bestTree,
+                    deferTestApproxUpdate ? EBuildIndicesDataParts::LearnOnly : EBuildIndicesDataParts::All,
                     ctx,
                     &treeValues,
                     &indices
@@ -367,15 +393,22 @@ void TrainOneIteration(const NCB::TTrainingDataProviders& data, TLearnContext* c
                 &treeValues
             );
 
+            TConstArrayRef<NCB::TTrainingDataProviderPtr> testDataToUpdate = data.Test;
+            if (deferTestApproxUpdate) {
+                testDataToUpdate = {};
+            }
             UpdateAvrgApprox(
                 error->GetIsExpApprox(),
                 data.Learn->GetObjectCount(),
                 indices,
                 treeValues,
-                data.Test,
+                testDataToUpdate,
                 ctx->LearnProgress.Get(),
                 ctx->LocalExecutor
             );
+            if (deferTestApproxUpdate) {
+                ++ctx->PendingTestApproxTreeCount; // for bestTree added to TreeStruct below
+            }
         } else {
             const bool isMultiRegression = dynamic_cast<const TMultiDerCalcer*>(error.Get()) != nullptr;
 
@@ -0,0 +1,77 @@
+#include <catboost/private/libs/algo/calc_score_cache.h>
+
+#include <library/cpp/binsaver/mem_io.h>
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+
+
+static TStats3D SerializeAndDeserialize(TStats3D& stats3D) {
+    TVector<char> buffer;
+    SerializeToMem(&buffer, stats3D);
+
+    TStats3D result;
+    SerializeFromMem(&buffer, result);
+    return result;
+}
+
+static void AssertEqual(const TStats3D& lhs, const TStats3D& rhs) {
+    UNIT_ASSERT_VALUES_EQUAL(lhs.BucketCount, rhs.BucketCount);
+    UNIT_ASSERT_VALUES_EQUAL(lhs.MaxLeafCount, rhs.MaxLeafCount);
+    UNIT_ASSERT(lhs.SplitEnsembleSpec == rhs.SplitEnsembleSpec);
+    UNIT_ASSERT_VALUES_EQUAL(lhs.Stats.size(), rhs.Stats.size());
+    for (auto i : xrange(lhs.Stats.size())) {
+        UNIT_ASSERT_VALUES_EQUAL(lhs.Stats[i].SumWeightedDelta, rhs.Stats[i].SumWeightedDelta);
+        UNIT_ASSERT_VALUES_EQUAL(lhs.Stats[i].SumWeight, rhs.Stats[i].SumWeight);
+        UNIT_ASSERT_VALUES_EQUAL(lhs.Stats[i].SumDelta, rhs.Stats[i].SumDelta);
+        UNIT_ASSERT_VALUES_EQUAL(lhs.Stats[i].Count, rhs.Stats[i].Count);
+    }
+}
+
+
+Y_UNIT_TEST_SUITE(TStats3DSerialization) {
+    Y_UNIT_TEST(TestPlain) {
+        TStats3D stats3D;
+        stats3D.BucketCount = 3;
+        stats3D.MaxLeafCount = 2;
+        for (auto i : xrange(6)) {
+            stats3D.Stats.push_back(TBucketStats{0.5 * i, 1.0 + i, 0, 0});
+        }
+
+        AssertEqual(stats3D, SerializeAndDeserialize(stats3D));
+    }
+
+    Y_UNIT_TEST(TestOrdered) {
+        TStats3D stats3D;
+        stats3D.BucketCount = 3;
+        stats3D.MaxLeafCount = 2;
+        for (auto i : xrange(6)) {
+            stats3D.Stats.push_back(TBucketStats{0.5 * i, 1.0 + i, -0.25 * i, 2.0 * i});
+        }
+
+        AssertEqual(stats3D, SerializeAndDeserialize(stats3D));
+    }
+
+    Y_UNIT_TEST(TestSparsePlain) {
+        TStats3D stats3D;
+        stats3D.BucketCount = 16;
+        stats3D.MaxLeafCount = 2;
+        stats3D.Stats.resize(32, TBucketStats{0, 0, 0, 0});
+        stats3D.Stats[3] = TBucketStats{1.5, 2.0, 0, 0};
+        stats3D.Stats[31] = TBucketStats{-0.5, 1.0, 0, 0};
+
+        AssertEqual(stats3D, SerializeAndDeserialize(stats3D));
+    }
+
+    Y_UNIT_TEST(TestSparseOrdered) {
+        TStats3D stats3D;
+        stats3D.BucketCount = 16;
+        stats3D.MaxLeafCount = 2;
+        stats3D.Stats.resize(32, TBucketStats{0, 0, 0, 0});
+        stats3D.Stats[0] = TBucketStats{1.5, 2.0, 0.25, 3.0};
+        stats3D.Stats[17] = TBucketStats{0, 0, -0.75, 1.0};
+
+        AssertEqual(stats3D, SerializeAndDeserialize(stats3D));
+    }
+}
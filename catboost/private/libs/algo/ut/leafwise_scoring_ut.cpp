@@ -0,0 +1,64 @@
+#include <catboost/private/libs/algo/leafwise_scoring.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/bitops.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+
+static void CheckBinarySplitsStats(int bucketCount) {
+    TFastRng<ui64> rng(bucketCount);
+    TVector<TBucketStats> bucketStats;
+    for (auto bucketIdx : xrange(bucketCount)) {
+        Y_UNUSED(bucketIdx);
+        bucketStats.push_back(
+            TBucketStats{rng.GenRandReal1() - 0.5, rng.GenRandReal1(), rng.GenRandReal1() - 0.5, 1.0}
+        );
+    }
+
+    const int binaryFeaturesCount = (int)GetValueBitCount(bucketCount - 1);
+    TVector<bool> isSplitProcessed(binaryFeaturesCount, false);
+
+    CalcScoresForLeaf(
+        TSplitEnsembleSpec::BinarySplitsPack(),
+        /*oneHotMaxSize*/ 2,
+        bucketCount,
+        [&] (int bucketIdx) { return bucketStats[bucketIdx]; },
+        [&] (const TBucketStats& trueStats, const TBucketStats& falseStats, int splitIdx) {
+            UNIT_ASSERT(splitIdx < binaryFeaturesCount);
+            UNIT_ASSERT(!isSplitProcessed[splitIdx]);
+            isSplitProcessed[splitIdx] = true;
+
+            TBucketStats expectedTrueStats{0, 0, 0, 0};
+            TBucketStats expectedFalseStats{0, 0, 0, 0};
+            for (auto bucketIdx : xrange(bucketCount)) {
+                auto& dstStats = ((bucketIdx >> splitIdx) & 1) ? expectedTrueStats : expectedFalseStats;
+                dstStats.Add(bucketStats[bucketIdx]);
+            }
+            const std::pair<TBucketStats, TBucketStats> statsPairs[] = {
+                {trueStats, expectedTrueStats},
+                {falseStats, expectedFalseStats}
+            };
+            for (const auto& stats : statsPairs) {
+                UNIT_ASSERT_DOUBLES_EQUAL(stats.first.SumWeightedDelta, stats.second.SumWeightedDelta, 1e-9);
+                UNIT_ASSERT_DOUBLES_EQUAL(stats.first.SumWeight, stats.second.SumWeight, 1e-9);
+                UNIT_ASSERT_DOUBLES_EQUAL(stats.first.SumDelta, stats.second.SumDelta, 1e-9);
+                UNIT_ASSERT_DOUBLES_EQUAL(stats.first.Count, stats.second.Count, 1e-9);
+            }
+        }
+    );
+
+    UNIT_ASSERT(AllOf(isSplitProcessed, [] (bool isProcessed) { return isProcessed; }));
+}
+
+
+Y_UNIT_TEST_SUITE(TCalcScoresForLeaf) {
+    Y_UNIT_TEST(TestBinarySplits) {
+        for (int bucketCount : {2, 8, 32, 256}) {
+            CheckBinarySplitsStats(bucketCount);
+        }
+    }
+}
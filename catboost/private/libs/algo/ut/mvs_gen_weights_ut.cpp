@@ -6,6 +6,7 @@
 #include <util/generic/ymath.h>
 #include <util/generic/maybe.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
 
 Y_UNIT_TEST_SUITE(mvs) {
     Y_UNIT_TEST(mvs_GenWeights) {
@@ -126,4 +127,79 @@ Y_UNIT_TEST_SUITE(mvs) {
             }
         }
     }
+
+    Y_UNIT_TEST(mvs_GenWeights_ordered) {
+        const ui32 SampleCount = 3 * 8192 + 100;
+        const ui32 BodyFinish = 8192 + 17;
+        TVector<double> derivatives(SampleCount);
+        for (auto i : xrange(SampleCount)) {
+            derivatives[i] = (i % 37) * 0.5 + 0.1;
+        }
+
+        TFold plainFold;
+        plainFold.SampleWeights.resize(SampleCount, 1);
+        TFold::TBodyTail plainBodyTail(0, 0, SampleCount, SampleCount, (double)SampleCount);
+        plainBodyTail.WeightedDerivatives.resize(1, derivatives);
+        plainFold.BodyTailArr.emplace_back(std::move(plainBodyTail));
+
+        TFold orderedFold;
+        orderedFold.SampleWeights.resize(SampleCount, 1);
+        TFold::TBodyTail firstBodyTail(0, 0, 1, BodyFinish, 1.0);
+        firstBodyTail.WeightedDerivatives.resize(1, TVector<double>(derivatives.begin(), derivatives.begin() + BodyFinish));
+        orderedFold.BodyTailArr.emplace_back(std::move(firstBodyTail));
+        TFold::TBodyTail secondBodyTail(0, 0, BodyFinish, SampleCount, (double)BodyFinish);
+        secondBodyTail.WeightedDerivatives.resize(1, derivatives);
+        Fill(secondBodyTail.WeightedDerivatives[0].begin(), secondBodyTail.WeightedDerivatives[0].begin() + BodyFinish, 1e6);
+        orderedFold.BodyTailArr.emplace_back(std::move(secondBodyTail));
+
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(1);
+
+        TMvsSampler sampler(SampleCount, 0.5, Nothing());
+
+        TRestorableFastRng64 plainRand(0);
+        sampler.GenSampleWeights(EBoostingType::Plain, {}, &plainRand, &executor, &plainFold);
+        TRestorableFastRng64 orderedRand(0);
+        sampler.GenSampleWeights(EBoostingType::Ordered, {}, &orderedRand, &executor, &orderedFold);
+
+        for (auto i : xrange(SampleCount)) {
+            UNIT_ASSERT_DOUBLES_EQUAL(plainFold.SampleWeights[i], orderedFold.SampleWeights[i], 1e-6);
+        }
+    }
+
+    Y_UNIT_TEST(goss_GenWeights) {
+        const ui32 SampleCount = 8192 * 2;
+        TFold ff;
+        ff.SampleWeights.resize(SampleCount, 1);
+
+        TFold::TBodyTail bt(0, 0, SampleCount, SampleCount, (double)SampleCount);
+        bt.WeightedDerivatives.resize(1, TVector<double>(SampleCount));
+        for (auto i : xrange(SampleCount)) {
+            // the largest 1/8 of each block are the objects with i % 8 == 0
+            bt.WeightedDerivatives[0][i] = (i % 8 == 0) ? -100.0 - i % 7 : (i % 7) * 0.1;
+        }
+        ff.BodyTailArr.emplace_back(std::move(bt));
+
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(1);
+
+        TGossSampler sampler(SampleCount, 0.4, 0.125);
+
+        TRestorableFastRng64 rand(0);
+        sampler.GenSampleWeights(EBoostingType::Plain, &rand, &executor, &ff);
+
+        const float otherWeight = 1 / ((0.4f - 0.125) / (1 - 0.125));
+        ui32 otherTakenCount = 0;
+        for (auto i : xrange(SampleCount)) {
+            const float weight = ff.SampleWeights[i];
+            if (i % 8 == 0) {
+                UNIT_ASSERT_DOUBLES_EQUAL(weight, 1.0, 1e-6);
+            } else {
+                UNIT_ASSERT(Abs(weight - otherWeight) < 1e-5 || Abs(weight) < 1e-6);
+                otherTakenCount += (weight > 0);
+            }
+        }
+        const double otherCount = SampleCount - SampleCount / 8;
+        UNIT_ASSERT_DOUBLES_EQUAL(otherTakenCount / otherCount, 1 / otherWeight, 0.02);
+    }
 }
@@ -3,6 +3,12 @@
 #include <catboost/private/libs/algo_helpers/pairwise_leaves_calculation.h>
 #include <catboost/libs/helpers/query_info_helper.h>
 
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/xrange.h>
+
+#include <tuple>
+
 static double CalculateScore(const TVector<double>& avrg, const TVector<double>& sumDer, const TArray2D<double>& sumWeights) {
     double score = 0;
     for (int x = 0; x < sumDer.ysize(); ++x) {
@@ -192,4 +198,58 @@ Y_UNIT_TEST_SUITE(PairwiseScoringTest) {
         UNIT_ASSERT_DOUBLES_EQUAL(scores1[1], scores2[1], 1e-6);
         UNIT_ASSERT_DOUBLES_EQUAL(scores1[2], scores2[2], 1e-6);
     }
+
+    Y_UNIT_TEST(PairWeightStatisticsForSortedPairs) {
+        const int docCount = 100;
+        const int leafCount = 4;
+        const int bucketCount = 5;
+        TVector<TIndexType> leafIndices(docCount);
+        TVector<ui8> bucketIndices(docCount);
+        for (int docId = 0; docId < docCount; ++docId) {
+            leafIndices[docId] = (docId * 7) % leafCount;
+            bucketIndices[docId] = (docId * 3) % bucketCount;
+        }
+        TFlatPairsInfo pairs;
+        for (ui32 pairIdx = 0; pairIdx < 1000; ++pairIdx) {
+            pairs.emplace_back((pairIdx * 13) % docCount, (pairIdx * 31 + 5) % docCount, 0.25f + pairIdx % 3);
+        }
+        const auto computeStats = [&] (const TFlatPairsInfo& pairs) {
+            return ComputePairWeightStatistics(
+                pairs,
+                leafCount,
+                bucketCount,
+                leafIndices,
+                [&](ui32 docId) { return bucketIndices[docId]; },
+                NCB::TIndexRange<int>(pairs.ysize()));
+        };
+        const auto expectedStats = computeStats(pairs);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(1);
+        TFlatPairsInfo sortedPairs = pairs;
+        SortPairsByLeaves(leafIndices, &localExecutor, &sortedPairs);
+        UNIT_ASSERT_VALUES_EQUAL(sortedPairs.size(), pairs.size());
+        for (auto pairIdx : xrange<size_t>(1, sortedPairs.size())) {
+            const auto& prev = sortedPairs[pairIdx - 1];
+            const auto& cur = sortedPairs[pairIdx];
+            UNIT_ASSERT(
+                std::make_tuple(leafIndices[prev.WinnerId], leafIndices[prev.LoserId], prev.WinnerId)
+                <= std::make_tuple(leafIndices[cur.WinnerId], leafIndices[cur.LoserId], cur.WinnerId));
+        }
+        const auto stats = computeStats(sortedPairs);
+        for (int leaf1 = 0; leaf1 < leafCount; ++leaf1) {
+            for (int leaf2 = 0; leaf2 < leafCount; ++leaf2) {
+                for (int bucket = 0; bucket < bucketCount; ++bucket) {
+                    UNIT_ASSERT_DOUBLES_EQUAL(
+                        stats[leaf1][leaf2][bucket].SmallerBorderWeightSum,
+                        expectedStats[leaf1][leaf2][bucket].SmallerBorderWeightSum,
+                        1e-9);
+                    UNIT_ASSERT_DOUBLES_EQUAL(
+                        stats[leaf1][leaf2][bucket].GreaterBorderRightWeightSum,
+                        expectedStats[leaf1][leaf2][bucket].GreaterBorderRightWeightSum,
+                        1e-9);
+                }
+            }
+        }
+    }
 }
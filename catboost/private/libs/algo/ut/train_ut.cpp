@@ -1,3 +1,4 @@
+#include <catboost/private/libs/algo/apply.h>
 #include <catboost/libs/data/data_provider_builders.h>
 #include <catboost/libs/helpers/vector_helpers.h>
 #include <catboost/libs/train_lib/train_model.h>
@@ -9,6 +10,8 @@
 #include <util/generic/vector.h>
 #include <util/generic/xrange.h>
 
+#include <cmath>
+
 
 using namespace NCB;
 
@@ -139,4 +142,188 @@ Y_UNIT_TEST_SUITE(TTrainTest) {
             );
         }
     }
+
+    Y_UNIT_TEST(TestFloatHistogramPrecision) {
+        const size_t TestDocCount = 5000;
+        const ui32 FactorCount = 10;
+
+        TReallyFastRng32 rng(123);
+
+        TVector<float> target(TestDocCount);
+        TVector<TVector<float>> features(FactorCount); // [featureIdx][objectIdx]
+
+        for (size_t j = 0; j < FactorCount; ++j) {
+            features[j].yresize(TestDocCount);
+        }
+
+        for (size_t i = 0; i < TestDocCount; ++i) {
+            for (size_t j = 0; j < FactorCount; ++j) {
+                features[j][i] = rng.GenRandReal2();
+            }
+            target[i] = (features[0][i] + features[1][i] * features[2][i] + 0.3 * rng.GenRandReal2()) > 0.7;
+        }
+
+        TDataProviders dataProviders;
+        dataProviders.Learn = CreateDataProvider(
+            [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                TDataMetaInfo metaInfo;
+                metaInfo.TargetType = ERawTargetType::Float;
+                metaInfo.TargetCount = 1;
+                metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                    FactorCount,
+                    TVector<ui32>{},
+                    TVector<ui32>{},
+                    TVector<TString>{});
+
+                visitor->Start(metaInfo, TestDocCount, EObjectsOrder::Undefined, {});
+
+                for (auto factorId : xrange(FactorCount)) {
+                    visitor->AddFloatFeature(
+                        factorId,
+                        MakeIntrusive<TTypeCastArrayHolder<float, float>>(TVector<float>(features[factorId]))
+                    );
+                }
+                visitor->AddTarget(
+                    MakeIntrusive<TTypeCastArrayHolder<float, float>>(TVector<float>(target))
+                );
+
+                visitor->Finish();
+            }
+        );
+
+        auto calcLogloss = [&] (const TFullModel& model) {
+            const TVector<TVector<double>> approx = ApplyModelMulti(model, *dataProviders.Learn);
+            double logloss = 0;
+            for (auto i : xrange(TestDocCount)) {
+                const double probability = 1.0 / (1.0 + std::exp(-approx[0][i]));
+                logloss -= target[i] ? std::log(probability) : std::log(1.0 - probability);
+            }
+            return logloss / TestDocCount;
+        };
+
+        TVector<double> loglosses;
+        for (TStringBuf histogramPrecision : {"Double", "Float"}) {
+            NJson::TJsonValue plainFitParams;
+            plainFitParams.InsertValue("loss_function", "Logloss");
+            plainFitParams.InsertValue("random_seed", 5);
+            plainFitParams.InsertValue("iterations", 20);
+            plainFitParams.InsertValue("train_dir", ".");
+            plainFitParams.InsertValue("thread_count", 4);
+            plainFitParams.InsertValue("cpu_histogram_precision", histogramPrecision);
+
+            TFullModel model;
+            TrainModel(
+                plainFitParams,
+                nullptr,
+                Nothing(),
+                Nothing(),
+                dataProviders,
+                /*initModel*/ Nothing(),
+                /*initLearnProgress*/ nullptr,
+                "",
+                &model,
+                /*evalResultPtrs*/ {}
+            );
+            loglosses.push_back(calcLogloss(model));
+        }
+
+        UNIT_ASSERT_DOUBLES_EQUAL(loglosses[0], loglosses[1], 1e-3);
+    }
+
+    Y_UNIT_TEST(TestSparseFeaturesStorage) {
+        const size_t TestDocCount = 5000;
+        const ui32 FactorCount = 8;
+
+        TReallyFastRng32 rng(321);
+
+        TVector<float> target(TestDocCount);
+        TVector<TVector<float>> features(FactorCount); // [featureIdx][objectIdx]
+
+        for (size_t j = 0; j < FactorCount; ++j) {
+            features[j].resize(TestDocCount, 0.0f);
+        }
+
+        // 10% of non-default values, features overlap so they are not bundled
+        for (size_t i = 0; i < TestDocCount; ++i) {
+            for (size_t j = 0; j < FactorCount; ++j) {
+                if (rng.GenRandReal2() < 0.1) {
+                    features[j][i] = rng.GenRandReal2();
+                }
+            }
+            target[i] = (features[0][i] + features[1][i] + 0.1 * rng.GenRandReal2()) > 0.3;
+        }
+
+        TDataProviders dataProviders;
+        dataProviders.Learn = CreateDataProvider(
+            [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                TDataMetaInfo metaInfo;
+                metaInfo.TargetType = ERawTargetType::Float;
+                metaInfo.TargetCount = 1;
+                metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                    FactorCount,
+                    TVector<ui32>{},
+                    TVector<ui32>{},
+                    TVector<TString>{});
+
+                visitor->Start(metaInfo, TestDocCount, EObjectsOrder::Undefined, {});
+
+                for (auto factorId : xrange(FactorCount)) {
+                    visitor->AddFloatFeature(
+                        factorId,
+                        MakeIntrusive<TTypeCastArrayHolder<float, float>>(TVector<float>(features[factorId]))
+                    );
+                }
+                visitor->AddTarget(
+                    MakeIntrusive<TTypeCastArrayHolder<float, float>>(TVector<float>(target))
+                );
+
+                visitor->Finish();
+            }
+        );
+
+        auto calcLogloss = [&] (const TFullModel& model) {
+            const TVector<TVector<double>> approx = ApplyModelMulti(model, *dataProviders.Learn);
+            double logloss = 0;
+            for (auto i : xrange(TestDocCount)) {
+                const double probability = 1.0 / (1.0 + std::exp(-approx[0][i]));
+                logloss -= target[i] ? std::log(probability) : std::log(1.0 - probability);
+            }
+            return logloss / TestDocCount;
+        };
+
+        TVector<double> loglosses;
+        for (TStringBuf boostingType : {"Plain", "Ordered"}) {
+            for (bool useSparseStorage : {false, true}) {
+                NJson::TJsonValue plainFitParams;
+                plainFitParams.InsertValue("loss_function", "Logloss");
+                plainFitParams.InsertValue("boosting_type", boostingType);
+                plainFitParams.InsertValue("random_seed", 5);
+                plainFitParams.InsertValue("iterations", 20);
+                plainFitParams.InsertValue("train_dir", ".");
+                plainFitParams.InsertValue("thread_count", 4);
+                if (useSparseStorage) {
+                    plainFitParams.InsertValue("dev_default_value_fraction_for_sparse", 0.83);
+                }
+
+                TFullModel model;
+                TrainModel(
+                    plainFitParams,
+                    nullptr,
+                    Nothing(),
+                    Nothing(),
+                    dataProviders,
+                    /*initModel*/ Nothing(),
+                    /*initLearnProgress*/ nullptr,
+                    "",
+                    &model,
+                    /*evalResultPtrs*/ {}
+                );
+                loglosses.push_back(calcLogloss(model));
+            }
+        }
+
+        // borders of sparse features can differ a little, so losses are compared approximately
+        UNIT_ASSERT_DOUBLES_EQUAL(loglosses[0], loglosses[1], 1e-2);
+        UNIT_ASSERT_DOUBLES_EQUAL(loglosses[2], loglosses[3], 1e-2);
+    }
 }
@@ -11,6 +11,15 @@
 #include <util/generic/vector.h>
 
 
+namespace {
+    // scratch buffers reused for all queries processed by one thread
+    struct TYetiRankQueryBuffers {
+        TVector<int> Indices;
+        TVector<double> BootstrappedApprox;
+        TVector<float> CompetitorsWeights; // querySize x querySize, winner-major
+    };
+}
+
 static void GenerateYetiRankPairsForQuery(
     const float* relevs,
     const double* expApproxes,
@@ -19,22 +28,28 @@ static void GenerateYetiRankPairsForQuery(
     int permutationCount,
     double decaySpeed,
     ui64 randomSeed,
+    TYetiRankQueryBuffers* buffers,
     TVector<TVector<TCompetitor>>* competitors
 ) {
     TFastRng64 rand(randomSeed);
     TVector<TVector<TCompetitor>>& competitorsRef = *competitors;
-    competitorsRef.clear();
     competitorsRef.resize(querySize);
+    for (auto& docCompetitors : competitorsRef) {
+        docCompetitors.clear();
+    }
 
-    TVector<int> indices(querySize);
-    TVector<TVector<float>> competitorsWeights(querySize, TVector<float>(querySize));
+    TVector<int>& indices = buffers->Indices;
+    TVector<double>& bootstrappedApprox = buffers->BootstrappedApprox;
+    TVector<float>& competitorsWeights = buffers->CompetitorsWeights;
+    indices.yresize(querySize);
+    bootstrappedApprox.yresize(querySize);
+    competitorsWeights.assign(size_t(querySize) * querySize, 0.0f);
     for (int permutationIndex = 0; permutationIndex < permutationCount; ++permutationIndex) {
         std::iota(indices.begin(), indices.end(), 0);
-        TVector<double> bootstrappedApprox(expApproxes, expApproxes + querySize);
         for (ui32 docId = 0; docId < querySize; ++docId) {
             const float uniformValue = rand.GenRandReal1();
             // TODO(nikitxskv): try to experiment with different bootstraps.
-            bootstrappedApprox[docId] *= uniformValue / (1.000001f - uniformValue);
+            bootstrappedApprox[docId] = expApproxes[docId] * (uniformValue / (1.000001f - uniformValue));
         }
 
         Sort(
@@ -53,19 +68,18 @@ static void GenerateYetiRankPairsForQuery(
             const float pairWeight = magicConst * decayCoefficient
                 * Abs(relevs[firstCandidate] - relevs[secondCandidate]);
             if (relevs[firstCandidate] > relevs[secondCandidate]) {
-                competitorsWeights[firstCandidate][secondCandidate] += pairWeight;
+                competitorsWeights[size_t(firstCandidate) * querySize + secondCandidate] += pairWeight;
             } else if (relevs[firstCandidate] < relevs[secondCandidate]) {
-                competitorsWeights[secondCandidate][firstCandidate] += pairWeight;
+                competitorsWeights[size_t(secondCandidate) * querySize + firstCandidate] += pairWeight;
             }
             decayCoefficient *= decaySpeed;
         }
     }
 
-    // TODO(nikitxskv): Can be optimized
     for (ui32 winnerIndex = 0; winnerIndex < querySize; ++winnerIndex) {
+        const float* winnerWeights = competitorsWeights.data() + size_t(winnerIndex) * querySize;
         for (ui32 loserIndex = 0; loserIndex < querySize; ++loserIndex) {
-            const float competitorsWeight
-                = queryWeight * competitorsWeights[winnerIndex][loserIndex] / permutationCount;
+            const float competitorsWeight = queryWeight * winnerWeights[loserIndex] / permutationCount;
             if (competitorsWeight != 0) {
                 competitorsRef[winnerIndex].push_back({loserIndex, competitorsWeight});
             }
@@ -97,6 +111,7 @@ void UpdatePairsForYetiRank(
         blockCount,
         [&](int blockId) {
             TFastRng64 rand(randomSeeds[blockId]);
+            TYetiRankQueryBuffers buffers;
             const int from = queryBegin + blockId * blockSize;
             const int to = Min<int>(queryBegin + (blockId + 1) * blockSize, queryEnd);
             for (int queryIndex = from; queryIndex < to; ++queryIndex) {
@@ -109,6 +124,7 @@ void UpdatePairsForYetiRank(
                     permutationCount,
                     decaySpeed,
                     rand.GenRand(),
+                    &buffers,
                     &queryInfoRef.Competitors
                 );
             }
@@ -2,6 +2,8 @@
 
 #include <catboost/libs/helpers/dispatch_generic_lambda.h>
 
+#include <util/generic/ymath.h>
+
 inline void AddDersRangeMulti(
     TConstArrayRef<TIndexType> leafIndices,
     TConstArrayRef<TConstArrayRef<float>> target,
@@ -77,10 +79,13 @@ void CalcLeafDersMulti(
         curLeafDers.SetZeroDers();
     }
     const auto& zeroDers = MakeZeroDers(approxDimension, estimationMethod, error.GetHessianType());
-    const auto hessianSize = zeroDers.SumDer2.Data.size();
+    /* each block accumulates ders for all leaves in its own copy of leafDers (with Hessians of
+     * approxDimension^2 size for Newton), so use a block per thread instead of small blocks
+     */
+    const int blockSize = Max(1000, CeilDiv(sampleCount, localExecutor->GetThreadCount() + 1));
     NCB::MapMerge(
         localExecutor,
-        NCB::TSimpleIndexRangesGenerator<int>(NCB::TIndexRange<int>(sampleCount), /*blockSize*/Max<ui32>(1000, hessianSize / CB_THREAD_LIMIT)),
+        NCB::TSimpleIndexRangesGenerator<int>(NCB::TIndexRange<int>(sampleCount), blockSize),
         /*mapFunc*/[&](NCB::TIndexRange<int> partIndexRange, TVector<TSumMulti>* leafDers) {
             Y_ASSERT(!partIndexRange.Empty());
             leafDers->resize(leafCount, zeroDers);
@@ -1,9 +1,37 @@
 #include "error_functions.h"
 
 #include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
 #include <util/random/normal.h>
 
 
+TVector<int> GetQueryBlocksBounds(
+    int queryStartIndex,
+    int queryEndIndex,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int blockCount
+) {
+    TVector<int> blockBounds = {queryStartIndex};
+    if (queryStartIndex >= queryEndIndex) {
+        return blockBounds;
+    }
+    const ui64 docCount = queriesInfo[queryEndIndex - 1].End - queriesInfo[queryStartIndex].Begin;
+    const ui64 blockDocCount = Max<ui64>(CeilDiv<ui64>(docCount, Max(blockCount, 1)), 1);
+    ui64 curBlockDocCount = 0;
+    for (int queryIndex : xrange(queryStartIndex, queryEndIndex)) {
+        curBlockDocCount += queriesInfo[queryIndex].End - queriesInfo[queryIndex].Begin;
+        if (curBlockDocCount >= blockDocCount) {
+            blockBounds.push_back(queryIndex + 1);
+            curBlockDocCount = 0;
+        }
+    }
+    if (blockBounds.back() != queryEndIndex) {
+        blockBounds.push_back(queryEndIndex);
+    }
+    return blockBounds;
+}
+
+
 template <int MaxDerivativeOrder, bool UseTDers, bool UseExpApprox, bool HasDelta>
 void IDerCalcer::CalcDersRangeImpl(
     int start,
@@ -499,6 +527,222 @@ void TCrossEntropyError::CalcDersRange(
     }
 }
 
+namespace {
+    struct TRMSEDers {
+        double CalcDer(double approx, float target) const {
+            return target - approx;
+        }
+        double CalcDer2(double /*approx*/, float /*target*/) const {
+            return TRMSEError::RMSE_DER2;
+        }
+        double CalcDer3(double /*approx*/, float /*target*/) const {
+            return TRMSEError::RMSE_DER3;
+        }
+    };
+
+    struct TQuantileDers {
+        double Alpha;
+        double Delta;
+
+    public:
+        double CalcDer(double approx, float target) const {
+            const double val = target - approx;
+            if (abs(val) < Delta) return 0;
+            return (target - approx > 0) ? Alpha : -(1 - Alpha);
+        }
+        double CalcDer2(double /*approx*/, float /*target*/) const {
+            return TQuantileError::QUANTILE_DER2_AND_DER3;
+        }
+        double CalcDer3(double /*approx*/, float /*target*/) const {
+            return TQuantileError::QUANTILE_DER2_AND_DER3;
+        }
+    };
+}
+
+// same as IDerCalcer::CalcDersRangeImpl for errors without exp approxes, but with inlined derivatives
+template <class TDersCalcer, int MaxDerivativeOrder, bool UseTDers, bool HasDelta>
+static void CalcNonExpDersRangeImpl(
+    const TDersCalcer& dersCalcer,
+    int start,
+    int count,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders,
+    double* firstDers
+) {
+    Y_ASSERT(HasDelta == (approxDeltas != nullptr));
+    Y_ASSERT(UseTDers == (ders != nullptr) && (ders != nullptr) == (firstDers == nullptr));
+    for (int i = start; i < start + count; ++i) {
+        double updatedApprox = approxes[i];
+        if (HasDelta) {
+            updatedApprox = UpdateApprox</*StoreExpApprox*/false>(updatedApprox, approxDeltas[i]);
+        }
+        if (UseTDers) {
+            ders[i].Der1 = dersCalcer.CalcDer(updatedApprox, targets[i]);
+        } else {
+            firstDers[i] = dersCalcer.CalcDer(updatedApprox, targets[i]);
+        }
+        if (MaxDerivativeOrder >= 2) {
+            ders[i].Der2 = dersCalcer.CalcDer2(updatedApprox, targets[i]);
+        }
+        if (MaxDerivativeOrder >= 3) {
+            ders[i].Der3 = dersCalcer.CalcDer3(updatedApprox, targets[i]);
+        }
+    }
+    if (weights != nullptr) {
+        for (int i = start; i < start + count; ++i) {
+            if (UseTDers) {
+                ders[i].Der1 *= weights[i];
+            } else {
+                firstDers[i] *= weights[i];
+            }
+            if (MaxDerivativeOrder >= 2) {
+                ders[i].Der2 *= weights[i];
+            }
+            if (MaxDerivativeOrder >= 3) {
+                ders[i].Der3 *= weights[i];
+            }
+        }
+    }
+}
+
+template <class TDersCalcer>
+static void CalcNonExpDersRange(
+    const TDersCalcer& dersCalcer,
+    int start,
+    int count,
+    int maxDerivativeOrder,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders,
+    double* firstDers
+) {
+    const bool hasDelta = approxDeltas != nullptr;
+    const bool useTDers = ders != nullptr;
+    switch (EncodeImplParameters(maxDerivativeOrder, useTDers, /*isExpApprox*/ false, hasDelta)) {
+        case EncodeImplParameters(1, false, false, false):
+            return CalcNonExpDersRangeImpl<TDersCalcer, 1, false, false>(
+                dersCalcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+        case EncodeImplParameters(1, false, false, true):
+            return CalcNonExpDersRangeImpl<TDersCalcer, 1, false, true>(
+                dersCalcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+        case EncodeImplParameters(1, true, false, false):
+            return CalcNonExpDersRangeImpl<TDersCalcer, 1, true, false>(
+                dersCalcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+        case EncodeImplParameters(1, true, false, true):
+            return CalcNonExpDersRangeImpl<TDersCalcer, 1, true, true>(
+                dersCalcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+        case EncodeImplParameters(2, true, false, false):
+            return CalcNonExpDersRangeImpl<TDersCalcer, 2, true, false>(
+                dersCalcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+        case EncodeImplParameters(2, true, false, true):
+            return CalcNonExpDersRangeImpl<TDersCalcer, 2, true, true>(
+                dersCalcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+        case EncodeImplParameters(3, true, false, false):
+            return CalcNonExpDersRangeImpl<TDersCalcer, 3, true, false>(
+                dersCalcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+        case EncodeImplParameters(3, true, false, true):
+            return CalcNonExpDersRangeImpl<TDersCalcer, 3, true, true>(
+                dersCalcer, start, count, approxes, approxDeltas, targets, weights, ders, firstDers);
+        default:
+            Y_ASSERT(false);
+    }
+}
+
+void TRMSEError::CalcFirstDerRange(
+    int start,
+    int count,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    double* ders
+) const {
+    CalcNonExpDersRange(
+        TRMSEDers(),
+        start,
+        count,
+        /*maxDerivativeOrder*/ 1,
+        approxes,
+        approxDeltas,
+        targets,
+        weights,
+        /*ders*/ nullptr,
+        ders);
+}
+
+void TRMSEError::CalcDersRange(
+    int start,
+    int count,
+    bool calcThirdDer,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders
+) const {
+    CalcNonExpDersRange(
+        TRMSEDers(),
+        start,
+        count,
+        /*maxDerivativeOrder*/ calcThirdDer ? 3 : 2,
+        approxes,
+        approxDeltas,
+        targets,
+        weights,
+        ders,
+        /*firstDers*/ nullptr);
+}
+
+void TQuantileError::CalcFirstDerRange(
+    int start,
+    int count,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    double* ders
+) const {
+    CalcNonExpDersRange(
+        TQuantileDers{Alpha, Delta},
+        start,
+        count,
+        /*maxDerivativeOrder*/ 1,
+        approxes,
+        approxDeltas,
+        targets,
+        weights,
+        /*ders*/ nullptr,
+        ders);
+}
+
+void TQuantileError::CalcDersRange(
+    int start,
+    int count,
+    bool calcThirdDer,
+    const double* approxes,
+    const double* approxDeltas,
+    const float* targets,
+    const float* weights,
+    TDers* ders
+) const {
+    CalcNonExpDersRange(
+        TQuantileDers{Alpha, Delta},
+        start,
+        count,
+        /*maxDerivativeOrder*/ calcThirdDer ? 3 : 2,
+        approxes,
+        approxDeltas,
+        targets,
+        weights,
+        ders,
+        /*firstDers*/ nullptr);
+}
+
 void TQuerySoftMaxError::CalcDersForSingleQuery(
     int start,
     int offset,
@@ -604,7 +848,7 @@ void TStochasticRankError::CalcDersForQueries(
     NPar::TLocalExecutor* localExecutor
 ) const {
     auto start = queriesInfo[queryStartIndex].Begin;
-    NPar::ParallelFor(*localExecutor, queryStartIndex, queryEndIndex, [&](int queryIndex) {
+    ParallelForQueries(queryStartIndex, queryEndIndex, queriesInfo, localExecutor, [&](int queryIndex) {
         auto begin = queriesInfo[queryIndex].Begin;
         auto end = queriesInfo[queryIndex].End;
         auto count = end - begin;
@@ -6,6 +6,7 @@
 #include "hessian.h"
 
 #include <catboost/private/libs/data_types/pair.h>
+#include <catboost/private/libs/data_types/query.h>
 #include <catboost/libs/model/eval_processing.h>
 #include <catboost/private/libs/options/catboost_options.h>
 #include <catboost/private/libs/options/enums.h>
@@ -17,12 +18,49 @@
 
 #include <util/generic/algorithm.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
 #include <util/string/split.h>
 #include <util/system/yassert.h>
 
 #include <cmath>
 
+// query index bounds of blocks with similar document counts, blockBounds[blockId] .. blockBounds[blockId + 1]
+TVector<int> GetQueryBlocksBounds(
+    int queryStartIndex,
+    int queryEndIndex,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int blockCount
+);
+
+/* Calls queryFunc(queryIndex) for each query in [queryStartIndex, queryEndIndex) in parallel.
+ * Queries are grouped to several blocks per thread by document count, so threads that finish
+ * blocks of small queries take next blocks while other threads process large queries.
+ */
+template <class TQueryFunc>
+inline void ParallelForQueries(
+    int queryStartIndex,
+    int queryEndIndex,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    NPar::TLocalExecutor* localExecutor,
+    TQueryFunc&& queryFunc
+) {
+    const TVector<int> blockBounds = GetQueryBlocksBounds(
+        queryStartIndex,
+        queryEndIndex,
+        queriesInfo,
+        /*blockCount*/ 8 * (localExecutor->GetThreadCount() + 1));
+    localExecutor->ExecRange(
+        [&] (int blockId) {
+            for (int queryIndex : xrange(blockBounds[blockId], blockBounds[blockId + 1])) {
+                queryFunc(queryIndex);
+            }
+        },
+        0,
+        blockBounds.ysize() - 1,
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
 class IDerCalcer {
 public:
     explicit IDerCalcer(
@@ -257,18 +295,26 @@ public:
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
     }
 
-private:
-    double CalcDer(double approx, float target) const override {
-        return target - approx;
-    }
-
-    double CalcDer2(double /*approx*/, float /*target*/) const override {
-        return RMSE_DER2;
-    }
+    void CalcFirstDerRange(
+        int start,
+        int count,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        double* ders
+    ) const override;
 
-    double CalcDer3(double /*approx*/, float /*target*/) const override {
-        return RMSE_DER3;
-    }
+    void CalcDersRange(
+        int start,
+        int count,
+        bool calcThirdDer,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        TDers* ders
+    ) const override;
 };
 
 class TQuantileError final : public IDerCalcer {
@@ -298,20 +344,26 @@ public:
         CB_ENSURE(isExpApprox == false, "Approx format does not match");
     }
 
-private:
-    double CalcDer(double approx, float target) const override {
-        const double val = target - approx;
-        if (abs(val) < Delta) return 0;
-        return (target - approx > 0) ? Alpha : -(1 - Alpha);
-    }
-
-    double CalcDer2(double /*approx*/, float /*target*/) const override {
-        return QUANTILE_DER2_AND_DER3;
-    }
+    void CalcFirstDerRange(
+        int start,
+        int count,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        double* ders
+    ) const override;
 
-    double CalcDer3(double /*approx*/, float /*target*/) const override {
-        return QUANTILE_DER2_AND_DER3;
-    }
+    void CalcDersRange(
+        int start,
+        int count,
+        bool calcThirdDer,
+        const double* approxes,
+        const double* approxDeltas,
+        const float* targets,
+        const float* weights,
+        TDers* ders
+    ) const override;
 };
 
 class TExpectileError final : public IDerCalcer {
@@ -538,22 +590,27 @@ public:
     ) const override {
         const int approxDimension = approx.ysize();
 
-        TVector<double> prob = approx;
-        FastExpInplace(prob.data(), prob.ysize());
+        // probabilities are calculated in der to avoid allocations for each object
+        const auto derRef = MakeArrayRef(*der);
+        Copy(approx.begin(), approx.end(), derRef.begin());
+        FastExpInplace(derRef.data(), approxDimension);
         for (int dim = 0; dim < approxDimension; ++dim) {
-            prob[dim] /= (1 + prob[dim]);
-            (*der)[dim] = -prob[dim];
+            derRef[dim] /= (1 + derRef[dim]);
         }
-        int targetClass = static_cast<int>(target);
-        (*der)[targetClass] += 1;
 
         if (der2 != nullptr) {
             Y_ASSERT(der2->HessianType == EHessianType::Diagonal && der2->ApproxDimension == approxDimension);
             for (int dim = 0; dim < approxDimension; ++ dim) {
-                der2->Data[dim] = -prob[dim] * (1 - prob[dim]);
+                der2->Data[dim] = -derRef[dim] * (1 - derRef[dim]);
             }
         }
 
+        for (int dim = 0; dim < approxDimension; ++dim) {
+            derRef[dim] = -derRef[dim];
+        }
+        int targetClass = static_cast<int>(target);
+        derRef[targetClass] += 1;
+
         if (weight != 1) {
             for (int dim = 0; dim < approxDimension; ++dim) {
                 (*der)[dim] *= weight;
@@ -588,11 +645,12 @@ public:
     ) const override {
         CB_ENSURE(queryStartIndex < queryEndIndex);
         const int start = queriesInfo[queryStartIndex].Begin;
-        NPar::ParallelFor(
-            *localExecutor,
+        ParallelForQueries(
             queryStartIndex,
             queryEndIndex,
-            [&] (ui32 queryIndex) {
+            queriesInfo,
+            localExecutor,
+            [&] (int queryIndex) {
                 const int begin = queriesInfo[queryIndex].Begin;
                 const int end = queriesInfo[queryIndex].End;
                 TDers* dersData = ders.data() + begin - start;
@@ -635,11 +693,12 @@ public:
         NPar::TLocalExecutor* localExecutor
     ) const override {
         const int start = queriesInfo[queryStartIndex].Begin;
-        NPar::ParallelFor(
-            *localExecutor,
+        ParallelForQueries(
             queryStartIndex,
             queryEndIndex,
-            [&] (ui32 queryIndex) {
+            queriesInfo,
+            localExecutor,
+            [&] (int queryIndex) {
                 const int begin = queriesInfo[queryIndex].Begin;
                 const int end = queriesInfo[queryIndex].End;
                 const int querySize = end - begin;
@@ -703,10 +762,11 @@ public:
         NPar::TLocalExecutor* localExecutor
     ) const override {
         int start = queriesInfo[queryStartIndex].Begin;
-        NPar::ParallelFor(
-            *localExecutor,
+        ParallelForQueries(
             queryStartIndex,
             queryEndIndex,
+            queriesInfo,
+            localExecutor,
             [&](int queryIndex) {
                 int begin = queriesInfo[queryIndex].Begin;
                 int end = queriesInfo[queryIndex].End;
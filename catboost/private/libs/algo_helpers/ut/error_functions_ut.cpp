@@ -0,0 +1,82 @@
+#include <library/cpp/testing/unittest/registar.h>
+#include <catboost/private/libs/algo_helpers/error_functions.h>
+
+#include <util/generic/xrange.h>
+
+Y_UNIT_TEST_SUITE(ErrorFunctionsTest) {
+    static const TVector<double> Approxes = {0.5, -1.0, 2.0, 0.0, 3.0};
+    static const TVector<double> ApproxDeltas = {0.5, 0.0, -1.0, 0.25, -3.0};
+    static const TVector<float> Targets = {1.0f, -1.0f, 0.0f, 2.0f, 0.0f};
+    static const TVector<float> Weights = {1.0f, 2.0f, 0.5f, 0.0f, 3.0f};
+
+    Y_UNIT_TEST(RMSEDersRange) {
+        const TRMSEError error(/*isExpApprox*/ false);
+        const int count = Approxes.ysize();
+
+        TVector<double> firstDers(count);
+        error.CalcFirstDerRange(0, count, Approxes.data(), nullptr, Targets.data(), nullptr, firstDers.data());
+        for (int i : xrange(count)) {
+            UNIT_ASSERT_DOUBLES_EQUAL(firstDers[i], Targets[i] - Approxes[i], 1e-12);
+        }
+
+        TVector<TDers> ders(count);
+        error.CalcDersRange(
+            1,
+            count - 1,
+            /*calcThirdDer*/ true,
+            Approxes.data(),
+            ApproxDeltas.data(),
+            Targets.data(),
+            Weights.data(),
+            ders.data());
+        for (int i : xrange(1, count)) {
+            UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der1, (Targets[i] - Approxes[i] - ApproxDeltas[i]) * Weights[i], 1e-12);
+            UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der2, TRMSEError::RMSE_DER2 * Weights[i], 1e-12);
+            UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der3, 0.0, 1e-12);
+        }
+    }
+
+    Y_UNIT_TEST(QuantileDersRange) {
+        const double alpha = 0.3;
+        const TQuantileError error(alpha, /*delta*/ 1e-6, /*isExpApprox*/ false);
+        const int count = Approxes.ysize();
+
+        TVector<double> firstDers(count);
+        error.CalcFirstDerRange(0, count, Approxes.data(), ApproxDeltas.data(), Targets.data(), Weights.data(), firstDers.data());
+        const TVector<double> expectedDers = {0.0, 0.0, -(1 - alpha) * 0.5, 0.0, 0.0};
+        for (int i : xrange(count)) {
+            UNIT_ASSERT_DOUBLES_EQUAL(firstDers[i], expectedDers[i], 1e-12);
+        }
+
+        TVector<TDers> ders(count);
+        error.CalcDersRange(0, count, /*calcThirdDer*/ false, Approxes.data(), nullptr, Targets.data(), nullptr, ders.data());
+        for (int i : xrange(count)) {
+            const double diff = Targets[i] - Approxes[i];
+            const double expectedDer = (diff == 0) ? 0.0 : ((diff > 0) ? alpha : -(1 - alpha));
+            UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der1, expectedDer, 1e-12);
+            UNIT_ASSERT_DOUBLES_EQUAL(ders[i].Der2, 0.0, 1e-12);
+        }
+    }
+
+    Y_UNIT_TEST(QueryBlocksBoundsByDocCount) {
+        // a large query in the middle of small ones
+        const TVector<ui32> querySizes = {1, 1, 1, 10, 1, 2, 1, 1};
+        TVector<TQueryInfo> queriesInfo;
+        ui32 begin = 0;
+        for (auto size : querySizes) {
+            queriesInfo.emplace_back(begin, begin + size);
+            begin += size;
+        }
+
+        UNIT_ASSERT_VALUES_EQUAL(
+            GetQueryBlocksBounds(0, queriesInfo.ysize(), queriesInfo, /*blockCount*/ 3),
+            TVector<int>({0, 4, 8}));
+        UNIT_ASSERT_VALUES_EQUAL(
+            GetQueryBlocksBounds(4, queriesInfo.ysize(), queriesInfo, /*blockCount*/ 2),
+            TVector<int>({4, 6, 8}));
+        UNIT_ASSERT_VALUES_EQUAL(
+            GetQueryBlocksBounds(1, 3, queriesInfo, /*blockCount*/ 10),
+            TVector<int>({1, 2, 3}));
+        UNIT_ASSERT_VALUES_EQUAL(GetQueryBlocksBounds(2, 2, queriesInfo, /*blockCount*/ 4), TVector<int>({2}));
+    }
+}
@@ -1,14 +1,20 @@
 #include "mode_calc_helpers.h"
 
 #include <catboost/private/libs/algo/apply.h>
+#include <catboost/libs/data/baseline.h>
 #include <catboost/libs/data/proceed_pool_in_blocks.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/vector_helpers.h>
 #include <catboost/libs/eval_result/eval_result.h>
 #include <catboost/private/libs/labels/external_label_helper.h>
+#include <catboost/private/libs/labels/helpers.h>
 #include <catboost/libs/logging/logging.h>
 
 #include <library/cpp/getopt/small/last_getopt.h>
+#include <library/cpp/threading/future/async.h>
+
+#include <util/generic/scope.h>
+#include <util/thread/pool.h>
 
 #include <util/string/cast.h>
 #include <util/string/split.h>
@@ -53,6 +59,11 @@ void NCB::PrepareCalcModeParamsParser(
         });
     parser.AddLongOption("eval-period", "predictions are evaluated every <eval-period> trees")
         .StoreResult(&evalPeriod);
+    parser.AddLongOption(
+        "binary-baseline-output-path",
+        "also save raw formula values up to tree-count-limit in binary baseline format, to be used as cbbinary://<path> baseline")
+        .RequiredArgument("PATH")
+        .StoreResult(&params.BinaryBaselineOutputPath);
     parser.SetFreeArgsNum(0);
 }
 
@@ -171,6 +182,24 @@ void NCB::CalcModelSingleHost(
         32,
         static_cast<int>(10000. / (static_cast<double>(iterationsLimit) / evalPeriod) / model.GetDimensionsCount())
     );
+    const TExternalLabelsHelper visibleLabelsHelper(model);
+
+    THolder<TOFStream> binaryBaselineOutput;
+    if (params.BinaryBaselineOutputPath) {
+        const auto classLabels = model.GetModelClassLabels();
+        binaryBaselineOutput = MakeHolder<TOFStream>(params.BinaryBaselineOutputPath);
+        SaveBinaryBaselineHeader(
+            model.GetDimensionsCount(),
+            (classLabels.size() == model.GetDimensionsCount()) ? ClassLabelsToStrings(classLabels) : TVector<TString>(),
+            binaryBaselineOutput.Get());
+    }
+
+    // output of a block is overlapped with reading and applying the model to the next one,
+    // at most one block is being written at a time
+    auto outputQueue = CreateThreadPool(1);
+    NThreading::TFuture<void> outputFuture = NThreading::MakeFuture();
+    Y_DEFER { outputFuture.Wait(); };
+
     ReadAndProceedPoolInBlocks(
         params.DatasetReadingParams,
         blockSize,
@@ -179,28 +208,39 @@ void NCB::CalcModelSingleHost(
                 ValidateColumnOutput(params.OutputColumnsIds, *datasetPart);
             }
             auto approx = Apply(model, *datasetPart, 0, iterationsLimit, evalPeriod, &executor);
-            const TExternalLabelsHelper visibleLabelsHelper(model);
-
-            poolColumnsPrinter->UpdateColumnTypeInfo(datasetPart->MetaInfo.ColumnsInfo);
-
-            TSetLoggingSilent inThisScope;
-            OutputEvalResultToFile(
-                approx,
-                &executor,
-                params.OutputColumnsIds,
-                model.GetLossFunctionName(),
-                visibleLabelsHelper,
-                *datasetPart,
-                outputStream.Get(),
-                // TODO: src file columns output is incompatible with block processing
-                poolColumnsPrinter,
-                /*testFileWhichOf*/ {0, 0},
-                IsFirstBlock,
-                docIdOffset,
-                std::make_pair(evalPeriod, iterationsLimit));
+
+            outputFuture.GetValueSync();
+            outputFuture = NThreading::Async(
+                [&, datasetPart, approx = std::move(approx), isFirstBlock = IsFirstBlock, docIdOffset = docIdOffset] () {
+                    poolColumnsPrinter->UpdateColumnTypeInfo(datasetPart->MetaInfo.ColumnsInfo);
+
+                    TSetLoggingSilent inThisScope;
+                    OutputEvalResultToFile(
+                        approx,
+                        &executor,
+                        params.OutputColumnsIds,
+                        model.GetLossFunctionName(),
+                        visibleLabelsHelper,
+                        *datasetPart,
+                        outputStream.Get(),
+                        // TODO: src file columns output is incompatible with block processing
+                        poolColumnsPrinter,
+                        /*testFileWhichOf*/ {0, 0},
+                        isFirstBlock,
+                        docIdOffset,
+                        std::make_pair(evalPeriod, iterationsLimit));
+                    if (binaryBaselineOutput) {
+                        SaveBinaryBaselineRows(approx.GetRawValuesConstRef().back(), binaryBaselineOutput.Get());
+                    }
+                },
+                *outputQueue
+            );
             docIdOffset += datasetPart->ObjectsGrouping->GetObjectCount();
             IsFirstBlock = false;
         },
         &executor);
+    outputFuture.GetValueSync();
+    if (binaryBaselineOutput) {
+        binaryBaselineOutput->Finish();
+    }
 }
-
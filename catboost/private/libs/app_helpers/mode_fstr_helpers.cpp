@@ -2,18 +2,22 @@
 
 #include <catboost/libs/data/load_data.h>
 #include <catboost/libs/data/model_dataset_compatibility.h>
+#include <catboost/libs/data/proceed_pool_in_blocks.h>
 #include <catboost/libs/fstr/compare_documents.h>
 #include <catboost/libs/fstr/output_fstr.h>
 #include <catboost/libs/fstr/shap_values.h>
 #include <catboost/libs/logging/logging.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/model/model.h>
+#include <catboost/private/libs/options/restrictions.h>
 
 #include <library/cpp/getopt/small/last_getopt.h>
 
 #include <util/folder/path.h>
 #include <util/generic/ptr.h>
 #include <util/generic/serialized_enum.h>
+#include <util/generic/utility.h>
+#include <util/stream/file.h>
 #include <util/string/cast.h>
 #include <util/system/yassert.h>
 
@@ -66,6 +70,47 @@ namespace {
 
         NCB::TDataProviderPtr Dataset;
     };
+
+    // the pool is not loaded as a whole, so memory does not depend on its size
+    void CalcAndOutputShapValuesInBlocks(
+        const NCB::TAnalyticalModeCommonParams& params,
+        const TFullModel& model,
+        NPar::TLocalExecutor* localExecutor) {
+
+        if (model.HasCategoricalFeatures()) {
+            CB_ENSURE(
+                params.DatasetReadingParams.ColumnarPoolFormatParams.CdFilePath.Inited(),
+                "Model has categorical features. Specify column_description file with correct categorical features.");
+        }
+
+        const TShapPreparedTrees preparedTrees = PrepareTreesForShapValuesOutputInBlocks(
+            model,
+            params.Verbose,
+            EPreCalcShapValues::Auto,
+            localExecutor,
+            params.ShapCalcType);
+
+        // limit the size of block SHAP values to about 10^7 doubles
+        const ui32 valuesPerObject
+            = model.GetDimensionsCount() * (model.GetNumFloatFeatures() + model.GetNumCatFeatures() + 1);
+        const ui32 blockSize = Max<ui32>(CB_THREAD_LIMIT, 10000000 / valuesPerObject);
+
+        TFileOutput out(params.OutputPath.Path);
+        ReadAndProceedPoolInBlocks(
+            params.DatasetReadingParams,
+            blockSize,
+            [&](const NCB::TDataProviderPtr datasetPart) {
+                CheckModelAndDatasetCompatibility(model, *datasetPart->ObjectsData.Get());
+                CalcAndOutputShapValuesForBlock(
+                    model,
+                    preparedTrees,
+                    *datasetPart,
+                    localExecutor,
+                    params.ShapCalcType,
+                    &out);
+            },
+            localExecutor);
+    }
 }
 
 void NCB::PrepareFstrModeParamsParser(
@@ -145,16 +190,22 @@ void NCB::ModeFstrSingleHost(const NCB::TAnalyticalModeCommonParams& params) {
                               params.FstrType);
             break;
         case EFstrType::Interaction:
-            CalcAndOutputInteraction(model, fstrPathPtr, internalFstrPathPtr);
+            CalcAndOutputInteraction(model, localExecutor.Get(), fstrPathPtr, internalFstrPathPtr);
             break;
         case EFstrType::ShapValues:
-            CalcAndOutputShapValues(model,
-                                    *poolLoader(),
-                                    params.OutputPath.Path,
-                                    params.Verbose,
-                                    EPreCalcShapValues::Auto,
-                                    localExecutor.Get(),
-                                    params.ShapCalcType);
+            if (!model.ModelTrees->GetLeafWeights().empty()
+                && params.ShapCalcType != ECalcTypeShapValues::Independent)
+            {
+                CalcAndOutputShapValuesInBlocks(params, model, localExecutor.Get());
+            } else {
+                CalcAndOutputShapValues(model,
+                                        *poolLoader(),
+                                        params.OutputPath.Path,
+                                        params.Verbose,
+                                        EPreCalcShapValues::Auto,
+                                        localExecutor.Get(),
+                                        params.ShapCalcType);
+            }
             break;
         case EFstrType::PredictionDiff:
             CalcAndOutputPredictionDiff(
@@ -1,15 +1,20 @@
 #include "line_data_reader.h"
 
+#include <util/generic/cast.h>
+#include <util/generic/ymath.h>
 #include <util/system/fs.h>
 
+#include <cstring>
+
 
 namespace NCB {
 
     THolder<ILineDataReader> GetLineDataReader(const TPathWithScheme& pathWithScheme,
-                                               const TDsvFormatOptions& format)
+                                               const TDsvFormatOptions& format,
+                                               NPar::TLocalExecutor* localExecutor)
     {
         return GetProcessor<ILineDataReader, TLineDataReaderArgs>(
-            pathWithScheme, TLineDataReaderArgs{pathWithScheme, format}
+            pathWithScheme, TLineDataReaderArgs{pathWithScheme, format, localExecutor}
         );
     }
 
@@ -24,6 +29,109 @@ namespace NCB {
         return count;
     }
 
+
+    static void StripCarriageReturn(TString* line) {
+        if (!line->empty() && line->back() == '\r') {
+            line->pop_back();
+        }
+    }
+
+    namespace {
+        struct TFileChunk {
+            TString Data;
+            bool HasNewLine = false;
+            size_t FirstNewLine = 0;
+            size_t LastNewLine = 0;
+            TVector<TString> Lines; // complete lines between FirstNewLine and LastNewLine
+        };
+    }
+
+    TFileLineDataReader::TFileLineDataReader(const TLineDataReaderArgs& args)
+        : Args(args)
+        , ParallelRead(args.LocalExecutor && (args.LocalExecutor->GetThreadCount() > 0))
+        , HeaderProcessed(!Args.Format.HasHeader)
+    {
+        if (ParallelRead) {
+            CB_ENSURE(
+                NFs::Exists(Args.PathWithScheme.Path),
+                "file '" << Args.PathWithScheme.Path << "' is not found"
+            );
+            File = TFile(Args.PathWithScheme.Path, OpenExisting | RdOnly | Seq);
+            FileLength = File.GetLength();
+        } else {
+            IFStream = MakeHolder<TIFStream>(Args.PathWithScheme.Path);
+        }
+    }
+
+    bool TFileLineDataReader::ReadNextChunks() {
+        if (Offset == FileLength) {
+            if (Carry.empty()) {
+                return false;
+            }
+            StripCarriageReturn(&Carry);
+            Lines.push_back(std::move(Carry));
+            Carry.clear();
+            return true;
+        }
+
+        const i64 threadCount = Args.LocalExecutor->GetThreadCount() + 1;
+        const i64 batchSize = Min<i64>(FileLength - Offset, (i64)ChunkSize * threadCount);
+        const int chunkCount = SafeIntegerCast<int>(CeilDiv<i64>(batchSize, ChunkSize));
+
+        TVector<TFileChunk> chunks(chunkCount);
+        Args.LocalExecutor->ExecRangeWithThrow(
+            [&] (int chunkIdx) {
+                auto& chunk = chunks[chunkIdx];
+                const i64 chunkOffset = (i64)chunkIdx * ChunkSize;
+                const size_t chunkSize = (size_t)Min<i64>(ChunkSize, batchSize - chunkOffset);
+
+                chunk.Data.ReserveAndResize(chunkSize);
+                CB_ENSURE(
+                    File.Pread(chunk.Data.begin(), chunkSize, Offset + chunkOffset) == chunkSize,
+                    "TFileLineDataReader: unexpected end of file '" << Args.PathWithScheme.Path << "'"
+                );
+
+                const char* data = chunk.Data.data();
+                const char* firstNewLine = (const char*)memchr(data, '\n', chunkSize);
+                if (!firstNewLine) {
+                    return;
+                }
+                chunk.HasNewLine = true;
+                chunk.FirstNewLine = firstNewLine - data;
+                chunk.LastNewLine = chunk.Data.rfind('\n');
+
+                const char* lineBegin = firstNewLine + 1;
+                const char* dataEnd = data + chunk.LastNewLine;
+                while (lineBegin <= dataEnd) {
+                    const char* lineEnd = (const char*)memchr(lineBegin, '\n', dataEnd - lineBegin + 1);
+                    chunk.Lines.emplace_back(lineBegin, lineEnd);
+                    StripCarriageReturn(&chunk.Lines.back());
+                    lineBegin = lineEnd + 1;
+                }
+            },
+            0,
+            chunkCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+
+        // stitch lines crossing chunk boundaries, order of lines is the order of chunks
+        for (auto& chunk : chunks) {
+            if (!chunk.HasNewLine) {
+                Carry += chunk.Data;
+                continue;
+            }
+            Carry.append(chunk.Data.data(), chunk.FirstNewLine);
+            StripCarriageReturn(&Carry);
+            Lines.push_back(std::move(Carry));
+            for (auto& line : chunk.Lines) {
+                Lines.push_back(std::move(line));
+            }
+            Carry = chunk.Data.substr(chunk.LastNewLine + 1);
+        }
+        Offset += batchSize;
+        return true;
+    }
+
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> DefLineDataReaderReg("");
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> FileLineDataReaderReg("file");
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> DsvLineDataReaderReg("dsv");
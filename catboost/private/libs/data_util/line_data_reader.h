@@ -5,11 +5,14 @@
 #include <catboost/libs/helpers/exception.h>
 
 #include <library/cpp/object_factory/object_factory.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
 
 #include <util/generic/maybe.h>
 #include <util/generic/string.h>
+#include <util/generic/vector.h>
 
 #include <util/stream/file.h>
+#include <util/system/file.h>
 
 
 
@@ -24,6 +27,11 @@ namespace NCB {
     struct TLineDataReaderArgs {
         TPathWithScheme PathWithScheme;
         TDsvFormatOptions Format;
+
+        /* if specified (and has threads) readers can use it to read and split data in parallel
+           (the order of lines returned by ReadLine is preserved)
+        */
+        NPar::TLocalExecutor* LocalExecutor = nullptr;
     };
 
 
@@ -50,18 +58,23 @@ namespace NCB {
         NObjectFactory::TParametrizedObjectFactory<ILineDataReader, TString, TLineDataReaderArgs>;
 
     THolder<ILineDataReader> GetLineDataReader(const TPathWithScheme& pathWithScheme,
-                                               const TDsvFormatOptions& format = {});
+                                               const TDsvFormatOptions& format = {},
+                                               NPar::TLocalExecutor* localExecutor = nullptr);
 
 
     int CountLines(const TString& poolFile);
 
+    /* If Args.LocalExecutor has threads the file is read in batches of byte ranges (one range per thread),
+       each range is read and split into lines in parallel, lines crossing range boundaries are stitched
+       afterwards, and lines are returned in the original file order.
+       Otherwise lines are read sequentially from the stream.
+    */
     class TFileLineDataReader : public ILineDataReader {
     public:
-        TFileLineDataReader(const TLineDataReaderArgs& args)
-            : Args(args)
-            , IFStream(args.PathWithScheme.Path)
-            , HeaderProcessed(!Args.Format.HasHeader)
-        {}
+        static constexpr size_t ChunkSize = 8 << 20;
+
+    public:
+        TFileLineDataReader(const TLineDataReaderArgs& args);
 
         ui64 GetDataLineCount() override {
             ui64 nLines = (ui64)CountLines(Args.PathWithScheme.Path);
@@ -75,7 +88,7 @@ namespace NCB {
             if (Args.Format.HasHeader) {
                 CB_ENSURE(!HeaderProcessed, "TFileLineDataReader: multiple calls to GetHeader");
                 TString header;
-                CB_ENSURE(IFStream.ReadLine(header), "TFileLineDataReader: no header in file");
+                CB_ENSURE(ReadLineImpl(&header), "TFileLineDataReader: no header in file");
                 HeaderProcessed = true;
                 return header;
             }
@@ -88,13 +101,45 @@ namespace NCB {
             if (!HeaderProcessed) {
                 GetHeader();
             }
-            return IFStream.ReadLine(*line) != 0;
+            return ReadLineImpl(line);
+        }
+
+    private:
+        bool ReadLineImpl(TString* line) {
+            if (!ParallelRead) {
+                return IFStream->ReadLine(*line) != 0;
+            }
+            if (NextLineIdx == Lines.size()) {
+                Lines.clear();
+                NextLineIdx = 0;
+                while (Lines.empty() && ReadNextChunks()) {
+                }
+                if (Lines.empty()) {
+                    return false;
+                }
+            }
+            *line = std::move(Lines[NextLineIdx++]);
+            return true;
         }
 
+        // returns false if the end of file has been reached before the call
+        bool ReadNextChunks();
+
     private:
         TLineDataReaderArgs Args;
-        TIFStream IFStream;
+        bool ParallelRead;
         bool HeaderProcessed;
+
+        // for sequential read
+        THolder<TIFStream> IFStream;
+
+        // for parallel read
+        TFile File;
+        i64 FileLength = 0;
+        i64 Offset = 0;
+        TString Carry; // incomplete last line of the previous batch
+        TVector<TString> Lines;
+        size_t NextLineIdx = 0;
     };
 
 }
@@ -0,0 +1,78 @@
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <catboost/private/libs/data_util/line_data_reader.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/file.h>
+#include <util/system/tempfile.h>
+
+
+using namespace NCB;
+
+
+static TVector<TString> ReadAllLines(const TString& path, bool hasHeader, NPar::TLocalExecutor* localExecutor) {
+    TDsvFormatOptions format;
+    format.HasHeader = hasHeader;
+    auto reader = GetLineDataReader(TPathWithScheme(path), format, localExecutor);
+
+    TVector<TString> lines;
+    if (hasHeader) {
+        lines.push_back(*reader->GetHeader());
+    }
+    TString line;
+    while (reader->ReadLine(&line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+static void TestParallelReadSameAsSequential(const TString& data, bool hasHeader) {
+    TTempFile tempFile(MakeTempName());
+    {
+        TOFStream out(tempFile.Name());
+        out << data;
+    }
+
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(3);
+
+    const auto expectedLines = ReadAllLines(tempFile.Name(), hasHeader, nullptr);
+    const auto lines = ReadAllLines(tempFile.Name(), hasHeader, &localExecutor);
+    UNIT_ASSERT_VALUES_EQUAL(lines.size(), expectedLines.size());
+    for (auto i : xrange(lines.size())) {
+        UNIT_ASSERT_VALUES_EQUAL(lines[i], expectedLines[i]);
+    }
+}
+
+
+Y_UNIT_TEST_SUITE(TFileLineDataReaderTest) {
+    Y_UNIT_TEST(TestSmallFiles) {
+        for (bool hasHeader : {false, true}) {
+            TestParallelReadSameAsSequential("", false);
+            TestParallelReadSameAsSequential("h\n", hasHeader);
+            TestParallelReadSameAsSequential("h\na\tb\n\nc\r\nd", hasHeader);
+            TestParallelReadSameAsSequential("h\r\n\n\n1\t2\n", hasHeader);
+        }
+    }
+
+    Y_UNIT_TEST(TestLinesCrossingChunkBoundaries) {
+        TFastRng<ui64> rng(0);
+        TString data;
+        // more than one batch (4 chunks with 3 additional threads), some lines longer than a chunk
+        while (data.size() < 5 * TFileLineDataReader::ChunkSize) {
+            const size_t lineSize = rng.Uniform(100) ? rng.Uniform(1000) : rng.Uniform(2 * TFileLineDataReader::ChunkSize);
+            for (auto i : xrange(lineSize)) {
+                Y_UNUSED(i);
+                data.push_back('a' + rng.Uniform(26));
+            }
+            if (!rng.Uniform(10)) {
+                data.push_back('\r');
+            }
+            data.push_back('\n');
+        }
+        data += "last line without new line";
+
+        TestParallelReadSameAsSequential(data, true);
+    }
+}
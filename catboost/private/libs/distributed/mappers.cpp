@@ -195,6 +195,7 @@ namespace NCatboostDistributed {
             trainParams.ObliviousTreeOptions.Get(),
             /*initModel*/ Nothing(),
             /*initModelApplyCompatiblePools*/ NCB::TDataProviders(),
+            /*initModelApproxesCachePath*/ TString(),
             &NPar::LocalExecutor());
         Y_ASSERT(localData.Progress->AveragingFold.BodyTailArr.ysize() == 1);
 
@@ -205,7 +206,8 @@ namespace NCatboostDistributed {
         localData.UseTreeLevelCaching = NeedToUseTreeLevelCaching(
             trainParams,
             /*maxBodyTailCount=*/1,
-            localData.Progress->AveragingFold.GetApproxDimension());
+            localData.Progress->AveragingFold.GetApproxDimension(),
+            trainingDataProviders);
 
         const bool isPairwiseScoring = IsPairwiseScoring(
             trainParams.LossFunctionDescription->GetLossFunction());
@@ -422,19 +424,6 @@ namespace NCatboostDistributed {
             /*scoreCalcer*/nullptr);
     }
 
-    void TScoreCalcer::DoMap(
-        NPar::IUserContext* ctx,
-        int hostId,
-        TInput* candidateList,
-        TOutput* bucketStats
-    ) const {
-        NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
-        auto calcStats3D = [&](const TCandidateInfo& candidate, TStats3D* stats3D) {
-            CalcStats3D(trainData, candidate, stats3D);
-        };
-        MapCandidateList(calcStats3D, *candidateList, bucketStats);
-    }
-
     void TPairwiseScoreCalcer::DoMap(
         NPar::IUserContext* ctx,
         int hostId,
@@ -557,7 +546,7 @@ namespace NCatboostDistributed {
         NPar::IUserContext* ctx,
         int hostId,
         TInput* bestSplit,
-        TOutput* /*unused*/
+        TOutput* isLeafEmpty
     ) const {
         Y_ASSERT(bestSplit->Type != ESplitType::OnlineCtr);
         auto& localData = TLocalTensorSearchData::GetRef();
@@ -578,15 +567,6 @@ namespace NCatboostDistributed {
                     &NPar::LocalExecutor());
             }
         }
-    }
-
-    void TEmptyLeafFinder::DoMap(
-        NPar::IUserContext* /*ctx*/,
-        int /*hostId*/,
-        TInput* /*unused*/,
-        TOutput* isLeafEmpty
-    ) const {
-        auto& localData = TLocalTensorSearchData::GetRef();
         *isLeafEmpty = GetIsLeafEmpty(localData.Depth + 1, localData.Indices);
         ++localData.Depth; // tree level completed
     }
@@ -1042,11 +1022,9 @@ REGISTER_SAVELOAD_NM_CLASS(0xd66d482, NCatboostDistributed, TPlainFoldBuilder);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d483, NCatboostDistributed, TTensorSearchStarter);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d484, NCatboostDistributed, TBootstrapMaker);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d584, NCatboostDistributed, TDerivativesStDevFromZeroCalcer);
-REGISTER_SAVELOAD_NM_CLASS(0xd66d485, NCatboostDistributed, TScoreCalcer);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d585, NCatboostDistributed, TRemoteBinCalcer);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d685, NCatboostDistributed, TRemoteScoreCalcer);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d486, NCatboostDistributed, TLeafIndexSetter);
-REGISTER_SAVELOAD_NM_CLASS(0xd66d487, NCatboostDistributed, TEmptyLeafFinder);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d488, NCatboostDistributed, TCalcApproxStarter);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d489, NCatboostDistributed, TDeltaSimpleUpdater);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d48a, NCatboostDistributed, TApproxUpdater);
@@ -46,16 +46,6 @@ namespace NCatboostDistributed {
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* /*unused*/, TOutput* /*unused*/) const final;
     };
 
-    // [cand][subcand]
-    class TScoreCalcer: public NPar::TMapReduceCmd<TCandidateList, TStats5D> {
-        OBJECT_NOCOPY_METHODS(TScoreCalcer);
-        void DoMap(
-            NPar::IUserContext* ctx,
-            int hostId,
-            TInput* candidateList,
-            TOutput* bucketStats) const final;
-    };
-
     // [cand][subcand]
     class TPairwiseScoreCalcer:
         public NPar::TMapReduceCmd<TCandidateList, TWorkerPairwiseStats> {
@@ -93,20 +83,13 @@ namespace NCatboostDistributed {
         OBJECT_NOCOPY_METHODS(TRemoteScoreCalcer);
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* bucketStats, TOutput* scores) const final;
     };
-    class TLeafIndexSetter: public NPar::TMapReduceCmd<TSplit, TUnusedInitializedParam> {
+    // sets leaf indices for the new tree level and returns its empty leaves
+    class TLeafIndexSetter: public NPar::TMapReduceCmd<TSplit, TIsLeafEmpty> {
         OBJECT_NOCOPY_METHODS(TLeafIndexSetter);
         void DoMap(
             NPar::IUserContext* ctx,
             int hostId,
             TInput* bestSplit,
-            TOutput* /*unused*/) const final;
-    };
-    class TEmptyLeafFinder: public NPar::TMapReduceCmd<TUnusedInitializedParam, TIsLeafEmpty> {
-        OBJECT_NOCOPY_METHODS(TEmptyLeafFinder);
-        void DoMap(
-            NPar::IUserContext* /*ctx*/,
-            int /*hostId*/,
-            TInput* /*unused*/,
             TOutput* isLeafEmpty) const final;
     };
     class TBucketSimpleUpdater:
@@ -187,67 +187,6 @@ double MapCalcDerivativesStDevFromZero(ui32 learnSampleCount, TLearnContext* ctx
     return sqrt(sum2 / learnSampleCount);
 }
 
-template <typename TScoreCalcMapper, typename TGetScore>
-void MapGenericCalcScore(
-    TGetScore getScore,
-    double scoreStDev,
-    TCandidatesContext* candidatesContext,
-    TLearnContext* ctx) {
-
-    Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
-
-    auto& candidateList = candidatesContext->CandidateList;
-
-    const int workerCount = TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount();
-    auto allStatsFromAllWorkers = ApplyMapper<TScoreCalcMapper>(
-        workerCount,
-        TMasterEnvironment::GetRef().SharedTrainData,
-        candidateList);
-    const int candidateCount = candidateList.ysize();
-    const ui64 randSeed = ctx->LearnProgress->Rand.GenRand();
-    // set best split for each candidate
-    NPar::ParallelFor(
-        *ctx->LocalExecutor,
-        0,
-        candidateCount,
-        [&] (int candidateIdx) {
-            auto& subCandidates = candidateList[candidateIdx].Candidates;
-            const int subcandidateCount = subCandidates.ysize();
-            TVector<TVector<double>> allScores(subcandidateCount);
-            for (int subcandidateIdx = 0; subcandidateIdx < subcandidateCount; ++subcandidateIdx) {
-                // reduce across workers
-                auto& reducedStats = allStatsFromAllWorkers[0][candidateIdx][subcandidateIdx];
-                for (int workerIdx = 1; workerIdx < workerCount; ++workerIdx) {
-                    const auto& stats = allStatsFromAllWorkers[workerIdx][candidateIdx][subcandidateIdx];
-                    reducedStats.Add(stats);
-                }
-                const auto& splitInfo = subCandidates[subcandidateIdx];
-                allScores[subcandidateIdx] = getScore(reducedStats, splitInfo);
-            }
-            SetBestScore(randSeed + candidateIdx, allScores, scoreStDev, *candidatesContext, &subCandidates);
-        });
-}
-
-// TODO(espetrov): Remove unused code.
-void MapCalcScore(
-    double scoreStDev,
-    int depth,
-    TCandidatesContext* candidatesContext,
-    TLearnContext* ctx) {
-
-    const auto& plainFold = ctx->LearnProgress->Folds[0];
-    const auto getScore = [&] (const TStats3D& stats3D, const TCandidateInfo& splitInfo) {
-        Y_UNUSED(splitInfo);
-
-        return GetScores(stats3D,
-                         depth,
-                         plainFold.GetSumWeight(),
-                         plainFold.GetLearnSampleCount(),
-                         ctx->Params);
-    };
-    MapGenericCalcScore<TScoreCalcer>(getScore, scoreStDev, candidatesContext, ctx);
-}
-
 template <typename TBinCalcMapper, typename TScoreCalcMapper>
 void MapGenericRemoteCalcScore(
     double scoreStDev,
@@ -319,17 +258,13 @@ void MapRemoteCalcScore(
         ctx);
 }
 
-void MapSetIndices(const TSplit& bestSplit, TLearnContext* ctx) {
+int MapSetIndicesAndGetRedundantSplitIdx(const TSplit& bestSplit, TLearnContext* ctx) {
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
     const int workerCount = TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount();
-    ApplyMapper<TLeafIndexSetter>(workerCount, TMasterEnvironment::GetRef().SharedTrainData, bestSplit);
-}
-
-int MapGetRedundantSplitIdx(TLearnContext* ctx) {
-    Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
-    const int workerCount = TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount();
-    TVector<TEmptyLeafFinder::TOutput> isLeafEmptyFromAllWorkers
-        = ApplyMapper<TEmptyLeafFinder>(workerCount, TMasterEnvironment::GetRef().SharedTrainData); // poll workers
+    TVector<TLeafIndexSetter::TOutput> isLeafEmptyFromAllWorkers = ApplyMapper<TLeafIndexSetter>(
+        workerCount,
+        TMasterEnvironment::GetRef().SharedTrainData,
+        bestSplit);
     for (int workerIdx = 1; workerIdx < workerCount; ++workerIdx) {
         for (int leafIdx = 0; leafIdx < isLeafEmptyFromAllWorkers[0].ysize(); ++leafIdx) {
             isLeafEmptyFromAllWorkers[0][leafIdx] &= isLeafEmptyFromAllWorkers[workerIdx][leafIdx];
@@ -422,11 +357,13 @@ static void UpdateLeavesExact(
     for (auto iter : xrange(BINARY_SEARCH_ITERATIONS)) {
         Y_UNUSED(iter);
         // calc new pivots
+        bool haveUnfinishedSearches = false;
         for (auto dimension : xrange(approxDimension)) {
             for (auto leaf : xrange(leafCount)) {
                 const double leftValue = searchIntervals[dimension][leaf].Min;
                 const double rightValue = searchIntervals[dimension][leaf].Max;
                 pivots[dimension][leaf] = (leftValue + rightValue) / 2;
+                haveUnfinishedSearches |= (leftValue < pivots[dimension][leaf]) && (pivots[dimension][leaf] < rightValue);
             }
         }
         TVector<TVector<TVector<double>>> splitCmdInput(1, pivots);
@@ -440,6 +377,12 @@ static void UpdateLeavesExact(
                 }
             }
         }
+        /* each map-reduce is a round trip to all workers, so stop when no interval can be narrowed further,
+         * pivots and left weights of the remaining iterations would be the same
+         */
+        if (!haveUnfinishedSearches) {
+            break;
+        }
     }
 
     TVector<TVector<double>> leafValues(approxDimension, TVector<double>(leafCount));
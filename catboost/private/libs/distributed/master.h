@@ -9,6 +9,10 @@
 #include <catboost/libs/data/data_provider.h>
 #include <catboost/libs/data/loader.h>
 #include <catboost/private/libs/options/load_options.h>
+#include <catboost/libs/logging/logging.h>
+
+#include <util/datetime/base.h>
+#include <util/generic/type_name.h>
 
 void InitializeMaster(const NCatboostOptions::TSystemOptions& systemOptions);
 void FinalizeMaster(TLearnContext* ctx);
@@ -28,11 +32,6 @@ void MapRestoreApproxFromTreeStruct(TLearnContext* ctx);
 void MapTensorSearchStart(TLearnContext* ctx);
 void MapBootstrap(TLearnContext* ctx);
 double MapCalcDerivativesStDevFromZero(ui32 learnSampleCount, TLearnContext* ctx);
-void MapCalcScore(
-    double scoreStDev,
-    int depth,
-    TCandidatesContext* candidatesContext,
-    TLearnContext* ctx);
 void MapRemoteCalcScore(
     double scoreStDev,
     TVector<TCandidatesContext>* candidatesContext,
@@ -41,8 +40,8 @@ void MapRemotePairwiseCalcScore(
     double scoreStDev,
     TVector<TCandidatesContext>* candidatesContext,
     TLearnContext* ctx);
-void MapSetIndices(const TSplit& bestSplit, TLearnContext* ctx);
-int MapGetRedundantSplitIdx(TLearnContext* ctx);
+// applies bestSplit to workers' leaf indices, returns redundant split index or -1
+int MapSetIndicesAndGetRedundantSplitIdx(const TSplit& bestSplit, TLearnContext* ctx);
 void MapCalcErrors(TLearnContext* ctx);
 
 template <typename TMapper>
@@ -56,9 +55,13 @@ TVector<typename TMapper::TOutput> ApplyMapper(
     mapperInput[0] = value;
     NPar::Map(&job, new TMapper(), &mapperInput);
     job.SeparateResults(workerCount);
+    const TInstant startTime = TInstant::Now();
     NPar::TJobExecutor exec(&job, environment);
     TVector<typename TMapper::TOutput> mapperOutput;
     exec.GetResultVec(&mapperOutput);
+    // the call waits for the slowest worker, so long calls point to stragglers
+    CATBOOST_DEBUG_LOG << TypeName<TMapper>() << " on " << workerCount << " workers took "
+        << (TInstant::Now() - startTime) << Endl;
     return mapperOutput;
 }
 
@@ -10,15 +10,20 @@
 #include <catboost/libs/logging/logging.h>
 #include <catboost/private/libs/target/data_providers.h>
 
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
 #include <util/generic/maybe.h>
 #include <util/generic/ptr.h>
+#include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
 #include <util/string/cast.h>
 #include <util/string/split.h>
 
 #include <functional>
 #include <numeric>
+#include <utility>
 
 
 using namespace NCB;
@@ -42,73 +47,122 @@ static TUpdateMethod ParseUpdateMethod(const TString& updateMethod) {
     return TUpdateMethod(updateType, topSize);
 }
 
-static TDStrResult GetFinalDocumentImportances(
-    const TVector<TVector<double>>& rawImportances,
-    EDocumentStrengthType docImpMethod,
-    int topSize,
-    EImportanceValuesSign importanceValuesSign
-) {
-    const ui32 trainDocCount = rawImportances.size();
-    Y_ASSERT(rawImportances.size() != 0);
-    const ui32 testDocCount = rawImportances[0].size();
-    TVector<TVector<double>> preprocessedImportances;
-    if (docImpMethod == EDocumentStrengthType::Average) {
-        preprocessedImportances = TVector<TVector<double>>(1, TVector<double>(trainDocCount));
-        for (ui32 trainDocId = 0; trainDocId < trainDocCount; ++trainDocId) {
-            for (ui32 testDocId = 0; testDocId < testDocCount; ++testDocId) {
-                preprocessedImportances[0][trainDocId] += rawImportances[trainDocId][testDocId];
+namespace {
+    /* Collects final importances from blocks of raw importances ([trainDocId][testDocId]) keeping only
+     * topSize selected values for every test object, so memory depends on topSize, not on train pool size.
+     */
+    class TFinalDocumentImportancesCollector {
+    public:
+        TFinalDocumentImportancesCollector(
+            EDocumentStrengthType docImpMethod,
+            int topSize,
+            EImportanceValuesSign importanceValuesSign,
+            ui32 trainDocCount,
+            ui32 testDocCount,
+            NPar::TLocalExecutor* localExecutor
+        )
+            : DocImpMethod(docImpMethod)
+            , TopSize(SafeIntegerCast<size_t>(topSize))
+            , ImportanceValuesSign(importanceValuesSign)
+            , TestDocCount(testDocCount)
+            , Tops(docImpMethod == EDocumentStrengthType::Average ? 1 : testDocCount)
+            , LocalExecutor(localExecutor)
+        {
+            if (DocImpMethod == EDocumentStrengthType::Average) {
+                AverageImportances.yresize(trainDocCount);
             }
         }
-        for (ui32 trainDocId = 0; trainDocId < trainDocCount; ++trainDocId) {
-            preprocessedImportances[0][trainDocId] /= testDocCount;
-        }
 
-    } else {
-        Y_ASSERT(docImpMethod == EDocumentStrengthType::PerObject || docImpMethod == EDocumentStrengthType::Raw);
-        preprocessedImportances = TVector<TVector<double>>(testDocCount, TVector<double>(trainDocCount));
-        for (ui32 trainDocId = 0; trainDocId < trainDocCount; ++trainDocId) {
-            for (ui32 testDocId = 0; testDocId < testDocCount; ++testDocId) {
-                preprocessedImportances[testDocId][trainDocId] = rawImportances[trainDocId][testDocId];
+        void AddBlock(ui32 trainDocBegin, TConstArrayRef<TVector<double>> rawImportances) {
+            if (DocImpMethod == EDocumentStrengthType::Average) {
+                NPar::ParallelFor(*LocalExecutor, 0, rawImportances.size(), [&] (ui32 blockDocIdx) {
+                    const auto& trainDocImportances = rawImportances[blockDocIdx];
+                    AverageImportances[trainDocBegin + blockDocIdx]
+                        = Accumulate(trainDocImportances.begin(), trainDocImportances.end(), 0.0) / TestDocCount;
+                });
+                return;
             }
+
+            Y_ASSERT(DocImpMethod == EDocumentStrengthType::PerObject || DocImpMethod == EDocumentStrengthType::Raw);
+            NPar::ParallelFor(*LocalExecutor, 0, TestDocCount, [&] (ui32 testDocId) {
+                for (auto blockDocIdx : xrange(rawImportances.size())) {
+                    AddToTop(rawImportances[blockDocIdx][testDocId], trainDocBegin + blockDocIdx, &Tops[testDocId]);
+                }
+            });
         }
-    }
 
-    TDStrResult result(preprocessedImportances.size());
-    for (ui32 testDocId = 0; testDocId < preprocessedImportances.size(); ++testDocId) {
-        TVector<double>& preprocessedImportancesRef = preprocessedImportances[testDocId];
+        TDStrResult GetResult() {
+            if (DocImpMethod == EDocumentStrengthType::Average) {
+                for (auto trainDocId : xrange(AverageImportances.size())) {
+                    AddToTop(AverageImportances[trainDocId], trainDocId, &Tops[0]);
+                }
+            }
 
-        const ui32 docCount = preprocessedImportancesRef.size();
-        TVector<ui32> indices(docCount);
-        std::iota(indices.begin(), indices.end(), 0);
-        if (docImpMethod != EDocumentStrengthType::Raw) {
-            Sort(indices.begin(), indices.end(), [&](ui32 first, ui32 second) {
-                return Abs(preprocessedImportancesRef[first]) > Abs(preprocessedImportancesRef[second]);
+            TDStrResult result(Tops.size());
+            NPar::ParallelFor(*LocalExecutor, 0, Tops.size(), [&] (ui32 resultIdx) {
+                auto& top = Tops[resultIdx];
+                if (DocImpMethod != EDocumentStrengthType::Raw) {
+                    Sort(top, IsMoreImportant);
+                }
+                for (const auto& [importance, trainDocId] : top) {
+                    result.Scores[resultIdx].push_back(importance);
+                    result.Indices[resultIdx].push_back(trainDocId);
+                }
+                TVector<std::pair<double, ui32>>().swap(top);
             });
+            return result;
         }
 
-        std::function<bool(double)> predicate;
-        if (importanceValuesSign == EImportanceValuesSign::Positive) {
-            predicate = [](double v){return v > 0;};
-        } else if (importanceValuesSign == EImportanceValuesSign::Negative) {
-            predicate = [](double v){return v < 0;};
-        } else {
-            Y_ASSERT(importanceValuesSign == EImportanceValuesSign::All);
-            predicate = [](double){return true;};
+    private:
+        static bool IsMoreImportant(const std::pair<double, ui32>& lhs, const std::pair<double, ui32>& rhs) {
+            const double lhsAbs = Abs(lhs.first);
+            const double rhsAbs = Abs(rhs.first);
+            return (lhsAbs > rhsAbs) || ((lhsAbs == rhsAbs) && (lhs.second < rhs.second));
         }
 
-        int currentSize = 0;
-        for (ui32 i = 0; i < docCount; ++i) {
-            if (currentSize == topSize) {
-                break;
+        bool IsSelected(double importance) const {
+            switch (ImportanceValuesSign) {
+                case EImportanceValuesSign::Positive:
+                    return importance > 0;
+                case EImportanceValuesSign::Negative:
+                    return importance < 0;
+                case EImportanceValuesSign::All:
+                    return true;
             }
-            if (predicate(preprocessedImportancesRef[indices[i]])) {
-                result.Scores[testDocId].push_back(preprocessedImportancesRef[indices[i]]);
-                result.Indices[testDocId].push_back(indices[i]);
-                ++currentSize;
+            Y_UNREACHABLE();
+        }
+
+        // train objects are added in increasing trainDocId order
+        void AddToTop(double importance, ui32 trainDocId, TVector<std::pair<double, ui32>>* top) const {
+            if ((TopSize == 0) || !IsSelected(importance)) {
+                return;
+            }
+            if (DocImpMethod == EDocumentStrengthType::Raw) {
+                if (top->size() < TopSize) {
+                    top->emplace_back(importance, trainDocId);
+                }
+                return;
+            }
+            // heap with the least important value on top
+            if (top->size() < TopSize) {
+                top->emplace_back(importance, trainDocId);
+                PushHeap(top->begin(), top->end(), IsMoreImportant);
+            } else if (IsMoreImportant({importance, trainDocId}, top->front())) {
+                PopHeap(top->begin(), top->end(), IsMoreImportant);
+                top->back() = {importance, trainDocId};
+                PushHeap(top->begin(), top->end(), IsMoreImportant);
             }
         }
-    }
-    return result;
+
+    private:
+        EDocumentStrengthType DocImpMethod;
+        size_t TopSize;
+        EImportanceValuesSign ImportanceValuesSign;
+        ui32 TestDocCount;
+        TVector<double> AverageImportances; // [trainDocCount], only for Average
+        TVector<TVector<std::pair<double, ui32>>> Tops; // [testDocCount or 1 for Average][<= TopSize]
+        NPar::TLocalExecutor* LocalExecutor;
+    };
 }
 
 TDStrResult GetDocumentImportances(
@@ -166,7 +220,20 @@ TDStrResult GetDocumentImportances(
     ExecuteTasksInParallel(&tasks, localExecutor.Get());
 
     TDocumentImportancesEvaluator leafInfluenceEvaluator(model, *trainProcessedData, updateMethod, localExecutor, logPeriod);
-    const TVector<TVector<double>> documentImportances
-        = leafInfluenceEvaluator.GetDocumentImportances(*testProcessedData, logPeriod);
-    return GetFinalDocumentImportances(documentImportances, dstrType, topSize, importanceValuesSign);
+    TFinalDocumentImportancesCollector finalImportancesCollector(
+        dstrType,
+        topSize,
+        importanceValuesSign,
+        trainProcessedData->GetObjectCount(),
+        testProcessedData->GetObjectCount(),
+        localExecutor.Get()
+    );
+    leafInfluenceEvaluator.GetDocumentImportances(
+        *testProcessedData,
+        [&] (ui32 trainDocBegin, TConstArrayRef<TVector<double>> importances) {
+            finalImportancesCollector.AddBlock(trainDocBegin, importances);
+        },
+        logPeriod
+    );
+    return finalImportancesCollector.GetResult();
 }
@@ -18,8 +18,13 @@
 using namespace NCB;
 
 
-TVector<TVector<double>> TDocumentImportancesEvaluator::GetDocumentImportances(
-    const TProcessedDataProvider& processedData, int logPeriod
+// limits the size of importances block for large pools
+static constexpr size_t MAX_IMPORTANCES_BLOCK_VALUE_COUNT = 1 << 24;
+
+void TDocumentImportancesEvaluator::GetDocumentImportances(
+    const TProcessedDataProvider& processedData,
+    const TOnImportancesBlock& onImportancesBlock,
+    int logPeriod
 ) {
     TVector<TVector<ui32>> leafIndices(TreeCount);
     auto binarizedFeatures = MakeQuantizedFeaturesForEvaluator(Model, *processedData.ObjectsData.Get());
@@ -28,8 +33,12 @@ TVector<TVector<double>> TDocumentImportancesEvaluator::GetDocumentImportances(
     }, NPar::TLocalExecutor::TExecRangeParams(0, TreeCount), NPar::TLocalExecutor::WAIT_COMPLETE);
 
     UpdateFinalFirstDerivatives(leafIndices, *processedData.TargetData->GetOneDimensionalTarget());
-    TVector<TVector<double>> documentImportances(DocCount, TVector<double>(processedData.GetObjectCount()));
-    const size_t docBlockSize = 1000;
+    const size_t testDocCount = processedData.GetObjectCount();
+    const size_t docBlockSize = Max<size_t>(
+        LocalExecutor->GetThreadCount() + 1,
+        Min<size_t>(1000, MAX_IMPORTANCES_BLOCK_VALUE_COUNT / Max<size_t>(testDocCount, 1))
+    );
+    TVector<TVector<double>> documentImportances(Min<size_t>(docBlockSize, DocCount), TVector<double>(testDocCount));
     TImportanceLogger documentsLogger(DocCount, "documents processed", "Processing documents...", logPeriod);
     TProfileInfo processDocumentsProfile(DocCount);
 
@@ -41,14 +50,14 @@ TVector<TVector<double>> TDocumentImportancesEvaluator::GetDocumentImportances(
             // The derivative of leaf values with respect to train doc weight.
             TVector<TVector<TVector<double>>> leafDerivatives(TreeCount, TVector<TVector<double>>(LeavesEstimationIterations)); // [treeCount][LeavesEstimationIterationsCount][leafCount]
             UpdateLeavesDerivatives(docId, &leafDerivatives);
-            GetDocumentImportancesForOneTrainDoc(leafDerivatives, leafIndices, &documentImportances[docId]);
+            GetDocumentImportancesForOneTrainDoc(leafDerivatives, leafIndices, &documentImportances[docId - start]);
         }, NPar::TLocalExecutor::TExecRangeParams(start, end), NPar::TLocalExecutor::WAIT_COMPLETE);
+        onImportancesBlock(start, MakeArrayRef(documentImportances.data(), end - start));
 
         processDocumentsProfile.FinishIterationBlock(end - start);
         auto profileResults = processDocumentsProfile.GetProfileResults();
         documentsLogger.Log(profileResults);
-        }
-    return documentImportances;
+    }
 }
 
 void TDocumentImportancesEvaluator::UpdateFinalFirstDerivatives(const TVector<TVector<ui32>>& leafIndices, TConstArrayRef<float> target) {
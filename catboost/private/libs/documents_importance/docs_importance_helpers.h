@@ -12,11 +12,14 @@
 
 #include <library/cpp/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/fwd.h>
 #include <util/generic/ptr.h>
 #include <util/system/types.h>
 #include <util/system/yassert.h>
 
+#include <functional>
+
 
 /*
  * This is the implementation of the LeafInfluence algorithm from the following paper:
@@ -40,6 +43,10 @@ struct TUpdateMethod {
 
 // The class for document importances evaluation.
 class TDocumentImportancesEvaluator {
+public:
+    // importances are [trainDocId - trainDocBegin][docId]
+    using TOnImportancesBlock = std::function<void(ui32 trainDocBegin, TConstArrayRef<TVector<double>> importances)>;
+
 public:
     TDocumentImportancesEvaluator(
         const TFullModel& model,
@@ -76,11 +83,23 @@ public:
         Y_ASSERT(leavesEstimationMethod == ELeavesEstimation::Newton);
             treeStatisticsEvaluator = MakeHolder<TNewtonTreeStatisticsEvaluator>(DocCount);
         }
-        TreesStatistics = treeStatisticsEvaluator->EvaluateTreeStatistics(model, processedData, startingApprox, logPeriod);
+        TreesStatistics = treeStatisticsEvaluator->EvaluateTreeStatistics(
+            model,
+            processedData,
+            startingApprox,
+            LocalExecutor.Get(),
+            logPeriod
+        );
     }
 
     // Getting the importance of all train objects for all objects from pool.
-    TVector<TVector<double>> GetDocumentImportances(const NCB::TProcessedDataProvider& processedData, int logPeriod = 0);
+    // Importances are passed to onImportancesBlock for consecutive blocks of train objects,
+    // so that they are never kept in memory for all train objects at once.
+    void GetDocumentImportances(
+        const NCB::TProcessedDataProvider& processedData,
+        const TOnImportancesBlock& onImportancesBlock,
+        int logPeriod = 0
+    );
 
 private:
     // Evaluate first derivatives at the final approxes
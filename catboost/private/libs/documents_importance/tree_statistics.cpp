@@ -16,6 +16,7 @@ TVector<TTreeStatistics> ITreeStatisticsEvaluator::EvaluateTreeStatistics(
     const TFullModel& model,
     const NCB::TProcessedDataProvider& processedData,
     const TMaybe<double> startingApprox,
+    NPar::TLocalExecutor* localExecutor,
     int logPeriod
 ) {
     //TODO(eermishkina): support non symmetric trees
@@ -30,6 +31,12 @@ TVector<TTreeStatistics> ITreeStatisticsEvaluator::EvaluateTreeStatistics(
     const ui32 treeCount = model.GetTreeCount();
 
     auto binarizedFeatures = MakeQuantizedFeaturesForEvaluator(model, *processedData.ObjectsData.Get());
+    // leaf indices don't depend on the approxes, so only leaf values are computed tree by tree
+    TVector<TVector<ui32>> treesLeafIndices(treeCount);
+    localExecutor->ExecRange([&] (int treeId) {
+        treesLeafIndices[treeId] = BuildIndicesForBinTree(model, binarizedFeatures.Get(), treeId);
+    }, NPar::TLocalExecutor::TExecRangeParams(0, treeCount), NPar::TLocalExecutor::WAIT_COMPLETE);
+
     TVector<TTreeStatistics> treeStatistics;
     treeStatistics.reserve(treeCount);
     TVector<double> approxes(DocCount, startingApprox ? *startingApprox : 0);
@@ -41,7 +48,7 @@ TVector<TTreeStatistics> ITreeStatisticsEvaluator::EvaluateTreeStatistics(
         processTreesProfile.StartIterationBlock();
 
         LeafCount = 1 << model.ModelTrees->GetTreeSizes()[treeId];
-        LeafIndices = BuildIndicesForBinTree(model, binarizedFeatures.Get(), treeId);
+        LeafIndices = std::move(treesLeafIndices[treeId]);
 
         TVector<TVector<ui32>> leavesDocId(LeafCount);
         for (ui32 docId = 0; docId < DocCount; ++docId) {
@@ -3,6 +3,8 @@
 #include <catboost/libs/data/data_provider.h>
 #include <catboost/libs/model/model.h>
 
+#include <library/cpp/threading/local_executor/local_executor.h>
+
 #include <util/generic/fwd.h>
 #include <util/generic/vector.h>
 #include <util/system/types.h>
@@ -36,6 +38,7 @@ public:
         const TFullModel& model,
         const NCB::TProcessedDataProvider& processedData,
         const TMaybe<double> startingApprox,
+        NPar::TLocalExecutor* localExecutor,
         int logPeriod = 0
     );
 
@@ -21,18 +21,18 @@ namespace NCB {
         void ComputeFeatures(
             TCalculatedFeatureVisitor learnVisitor,
             TConstArrayRef<TCalculatedFeatureVisitor> testVisitors,
-            NPar::TLocalExecutor*) const override {
+            NPar::TLocalExecutor* executor) const override {
 
             THolder<TFeatureCalcer> featureCalcer = EstimateFeatureCalcer();
 
             TVector<TTextDataSetPtr> learnDs{GetLearnDataSetPtr()};
             TVector<TCalculatedFeatureVisitor> learnVisitors{std::move(learnVisitor)};
-            Calc(*featureCalcer, learnDs, learnVisitors);
+            Calc(*featureCalcer, learnDs, learnVisitors, executor);
 
             if (!testVisitors.empty()) {
                 CB_ENSURE(testVisitors.size() == NumberOfTestDataSets(),
                           "If specified, testVisitors should be the same number as test sets");
-                Calc(*featureCalcer, GetTestDataSets(), testVisitors);
+                Calc(*featureCalcer, GetTestDataSets(), testVisitors, executor);
             }
         }
 
@@ -40,7 +40,7 @@ namespace NCB {
             TConstArrayRef<ui32> learnPermutation,
             TCalculatedFeatureVisitor learnVisitor,
             TConstArrayRef<TCalculatedFeatureVisitor> testVisitors,
-            NPar::TLocalExecutor*) const override {
+            NPar::TLocalExecutor* executor) const override {
 
             TFeatureCalcer featureCalcer = CreateFeatureCalcer();
             TCalcerVisitor calcerVisitor = CreateCalcerVisitor();
@@ -72,7 +72,7 @@ namespace NCB {
             if (!testVisitors.empty()) {
                 CB_ENSURE(testVisitors.size() == NumberOfTestDataSets(),
                           "If specified, testVisitors should be the same number as test sets");
-                Calc(featureCalcer, GetTestDataSets(), testVisitors);
+                Calc(featureCalcer, GetTestDataSets(), testVisitors, executor);
             }
         }
 
@@ -93,10 +93,12 @@ namespace NCB {
         }
 
     protected:
+        // featureCalcer is fixed here, so texts are computed in parallel
         void Calc(
             const TFeatureCalcer& featureCalcer,
             TConstArrayRef<TTextDataSetPtr> dataSets,
-            TConstArrayRef<TCalculatedFeatureVisitor> visitors) const {
+            TConstArrayRef<TCalculatedFeatureVisitor> visitors,
+            NPar::TLocalExecutor* executor) const {
 
             const ui32 featuresCount = featureCalcer.FeatureCount();
             for (ui32 id = 0; id < dataSets.size(); ++id) {
@@ -104,9 +106,11 @@ namespace NCB {
                 const ui64 samplesCount = ds.SamplesCount();
                 TVector<float> features(featuresCount * samplesCount);
 
-                for (ui64 line = 0; line < samplesCount; ++line) {
-                    Compute(featureCalcer, ds.GetText(line), line, samplesCount, features);
-                }
+                NPar::ParallelFor(
+                    *executor, 0, samplesCount, [&](ui32 line) {
+                        Compute(featureCalcer, ds.GetText(line), line, samplesCount, features);
+                    }
+                );
 
                 for (ui32 f = 0; f < featuresCount; ++f) {
                     visitors[id](
@@ -16,10 +16,13 @@
 
 #include <util/generic/algorithm.h>
 #include <util/generic/deque.h>
+#include <util/generic/mapfindptr.h>
 #include <util/generic/set.h>
 #include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
 #include <util/random/shuffle.h>
 
+#include <limits>
 #include <numeric>
 
 namespace {
@@ -391,6 +394,7 @@ namespace {
 
     bool QuantizeDataIfNeeded(
         bool allowWriteFiles,
+        bool ensureConsecutiveFeaturesDataForCpu,
         const TString& tmpDir,
         NCB::TFeaturesLayoutPtr featuresLayout,
         NCB::TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
@@ -430,7 +434,7 @@ namespace {
                 /*datasetName*/ TStringBuf(),
                 /*bordersFile*/ Nothing(),  // Already at quantizedFeaturesInfo
                 /*unloadCatFeaturePerfectHashFromRam*/ allowWriteFiles,
-                /*ensureConsecutiveLearnFeaturesDataForCpu*/ true,
+                ensureConsecutiveFeaturesDataForCpu,
                 tmpDir,
                 quantizedFeaturesInfo,
                 catBoostOptions,
@@ -463,6 +467,7 @@ namespace {
         NCB::TTrainingDataProviderPtr quantizedData;
         bool isNeedSplit = QuantizeDataIfNeeded(
             allowWriteFiles,
+            /*ensureConsecutiveFeaturesDataForCpu*/ true,
             tmpDir,
             featuresLayout,
             quantizedFeaturesInfo,
@@ -709,6 +714,59 @@ namespace {
         }
     }
 
+    /* Successive-halving style early stopping of candidates in train-test search:
+     * at iterations pruningStartIteration * 2^k - 1 the candidate's best eval metric value on test
+     * is compared with the best value that the best candidate so far had reached by the same iteration.
+     * The best candidate's metric can only improve after that iteration, so a pruned candidate
+     * would never have been chosen.
+     */
+    class TCandidatePruningCallbacks : public ITrainingCallbacks {
+    public:
+        TCandidatePruningCallbacks(
+            ui32 pruningStartIteration,
+            const TString& metricDescription,
+            int metricSign,
+            const TMetricsAndTimeLeftHistory& bestCandidateHistory)
+            : NextCheckIteration(pruningStartIteration - 1)
+            , MetricDescription(metricDescription)
+            , MetricSign(metricSign)
+        {
+            Y_ASSERT(pruningStartIteration > 0);
+            double bestValue = std::numeric_limits<double>::quiet_NaN();
+            for (const auto& iterationTestMetrics : bestCandidateHistory.TestMetricsHistory) {
+                const double* value = iterationTestMetrics.empty() ?
+                    nullptr : MapFindPtr(iterationTestMetrics[0], MetricDescription);
+                if (value && (IsNan(bestValue) || MetricSign * *value < MetricSign * bestValue)) {
+                    bestValue = *value;
+                }
+                BestCandidateBestValues.push_back(bestValue);
+            }
+        }
+
+        bool IsContinueTraining(const TMetricsAndTimeLeftHistory& history) override {
+            const size_t iteration = history.TimeHistory.size() - 1;
+            if (iteration < NextCheckIteration || BestCandidateBestValues.empty()) {
+                return true;
+            }
+            NextCheckIteration = 2 * (NextCheckIteration + 1) - 1;
+
+            const double bestCandidateValue
+                = BestCandidateBestValues[Min(iteration, BestCandidateBestValues.size() - 1)];
+            const double* value = history.TestBestError.empty() ?
+                nullptr : MapFindPtr(history.TestBestError[0], MetricDescription);
+            if (!value || IsNan(bestCandidateValue)) {
+                return true;
+            }
+            return MetricSign * *value <= MetricSign * bestCandidateValue;
+        }
+
+    private:
+        size_t NextCheckIteration;
+        TString MetricDescription;
+        int MetricSign;
+        TVector<double> BestCandidateBestValues; // [iter], best value reached up to this iteration
+    };
+
     double TuneHyperparamsCV(
         const TVector<TString>& paramNames,
         const TMaybe<TCustomObjectiveDescriptor>& objectiveDescriptor,
@@ -795,8 +853,12 @@ namespace {
             TVector<TCVResult> cvResult;
             {
                 TSetLogging inThisScope(catBoostOptions.LoggingLevel);
+                /* folds are created as subset views over quantizedData in CrossValidate,
+                   so making its features data consecutive would only add a full copy
+                */
                 QuantizeDataIfNeeded(
                     outputFileOptions.AllowWriteFiles(),
+                    /*ensureConsecutiveFeaturesDataForCpu*/ false,
                     tmpDir,
                     featuresLayout,
                     quantizedFeaturesInfo,
@@ -919,6 +981,7 @@ namespace {
         TMetricsAndTimeLeftHistory* trainTestResult,
         NPar::TLocalExecutor* localExecutor,
         int verbose,
+        ui32 pruningStartIteration,
         const THashMap<TString, NCB::TCustomRandomDistributionGenerator>& randDistGenerators = {}) {
         TRestorableFastRng64 rand(trainTestSplitParams.PartitionRandSeed);
 
@@ -990,6 +1053,7 @@ namespace {
             NCB::TQuantizedFeaturesInfoPtr quantizedFeaturesInfo;
 
             TMetricsAndTimeLeftHistory metricsAndTimeHistory;
+            TVector<THolder<IMetric>> metrics;
             {
                 TSetLogging inThisScope(catBoostOptions.LoggingLevel);
                 QuantizeAndSplitDataIfNeeded(
@@ -1011,14 +1075,31 @@ namespace {
                 lastQuantizationParamsSet = quantizationParamsSet;
                 THolder<IModelTrainer> modelTrainerHolder = TTrainerFactory::Construct(catBoostOptions.GetTaskType());
 
+                ui32 approxDimension = NCB::GetApproxDimension(catBoostOptions, labelConverter, data->RawTargetData.GetTargetDimension());
+                metrics = CreateMetrics(
+                    catBoostOptions.MetricOptions,
+                    evalMetricDescriptor,
+                    approxDimension,
+                    data->MetaInfo.HasWeights
+                );
+
                 TEvalResult evalRes;
 
                 TTrainModelInternalOptions internalOptions;
                 internalOptions.CalcMetricsOnly = true;
-                internalOptions.ForceCalcEvalMetricOnEveryIteration = false;
+                internalOptions.ForceCalcEvalMetricOnEveryIteration = pruningStartIteration > 0;
                 internalOptions.OffsetMetricPeriodByInitModelSize = true;
                 outputFileOptions.SetAllowWriteFiles(false);
-                const auto defaultTrainingCallbacks = MakeHolder<ITrainingCallbacks>();
+                THolder<ITrainingCallbacks> trainingCallbacks;
+                if (pruningStartIteration > 0 && iterationIdx > 0) {
+                    trainingCallbacks = MakeHolder<TCandidatePruningCallbacks>(
+                        pruningStartIteration,
+                        metrics[0]->GetDescription(),
+                        GetSignForMetricMinimization(metrics[0]),
+                        *trainTestResult);
+                } else {
+                    trainingCallbacks = MakeHolder<ITrainingCallbacks>(); // TODO(ilikepugs): MLTOOLS-3540
+                }
                 // Training model
                 modelTrainerHolder->TrainModel(
                     internalOptions,
@@ -1028,7 +1109,7 @@ namespace {
                     evalMetricDescriptor,
                     trainTestData,
                     labelConverter,
-                    defaultTrainingCallbacks.Get(), // TODO(ilikepugs): MLTOOLS-3540
+                    trainingCallbacks.Get(),
                     /*initModel*/ Nothing(),
                     /*initLearnProgress*/ nullptr,
                     /*initModelApplyCompatiblePools*/ NCB::TDataProviders(),
@@ -1041,14 +1122,6 @@ namespace {
                 );
             }
 
-            ui32 approxDimension = NCB::GetApproxDimension(catBoostOptions, labelConverter, data->RawTargetData.GetTargetDimension());
-            const TVector<THolder<IMetric>> metrics = CreateMetrics(
-                catBoostOptions.MetricOptions,
-                evalMetricDescriptor,
-                approxDimension,
-                data->MetaInfo.HasWeights
-            );
-
             const TString& lossDescription = metrics[0]->GetDescription();
             double bestMetricValue = metricsAndTimeHistory.TestBestError[0][lossDescription]; //[testId][lossDescription]
             if (iterationIdx == 0) {
@@ -1188,7 +1261,8 @@ namespace NCB {
         TMetricsAndTimeLeftHistory* trainTestResult,
         bool isSearchUsingTrainTestSplit,
         bool returnCvStat,
-        int verbose) {
+        int verbose,
+        ui32 pruningStartIteration) {
 
         // CatBoost options
         NJson::TJsonValue jsonParams;
@@ -1259,7 +1333,8 @@ namespace NCB {
                     &gridParams,
                     trainTestResult,
                     &localExecutor,
-                    verbose
+                    verbose,
+                    pruningStartIteration
                 );
             } else {
                 metricValue = TuneHyperparamsCV(
@@ -1320,7 +1395,8 @@ namespace NCB {
         TMetricsAndTimeLeftHistory* trainTestResult,
         bool isSearchUsingTrainTestSplit,
         bool returnCvStat,
-        int verbose) {
+        int verbose,
+        ui32 pruningStartIteration) {
 
         // CatBoost options
         NJson::TJsonValue jsonParams;
@@ -1386,6 +1462,7 @@ namespace NCB {
                 trainTestResult,
                 &localExecutor,
                 verbose,
+                pruningStartIteration,
                 randDistGenerators
             );
         } else {
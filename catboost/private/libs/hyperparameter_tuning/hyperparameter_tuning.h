@@ -56,7 +56,8 @@ namespace NCB {
         TMetricsAndTimeLeftHistory* trainTestResult,
         bool isSearchUsingTrainTestSplit = true,
         bool returnCvStat = true,
-        int verbose = 1);
+        int verbose = 1,
+        ui32 pruningStartIteration = 0); // 0 - don't stop training of unpromising candidates early
 
     void RandomizedSearch(
         ui32 numberOfTries,
@@ -72,5 +73,6 @@ namespace NCB {
         TMetricsAndTimeLeftHistory* trainTestResult,
         bool isSearchUsingTrainTestSplit = true,
         bool returnCvStat = true,
-        int verbose = 1);
+        int verbose = 1,
+        ui32 pruningStartIteration = 0); // 0 - don't stop training of unpromising candidates early
 }
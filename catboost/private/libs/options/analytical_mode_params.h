@@ -19,6 +19,7 @@ namespace NCB {
         TString ModelFileName;
         EModelType ModelFormat = EModelType::CatboostBinary;
         NCB::TPathWithScheme OutputPath;
+        TString BinaryBaselineOutputPath; // calc mode only, can be empty
 
         int Verbose;
 
@@ -42,6 +42,21 @@ namespace NCatboostOptions {
                 );
                 break;
             }
+            case EBootstrapType::GOSS: {
+                if (TaskType != ETaskType::CPU) {
+                    ythrow TCatBoostException()
+                        << "Error: GOSS bootstrap is supported only on CPU";
+                }
+                CB_ENSURE(
+                    GetSamplingUnit() == ESamplingUnit::Object,
+                    "GOSS bootstrap supports per object sampling only."
+                );
+                CB_ENSURE(
+                    (GetGossTopRate() >= 0) && (GetGossTopRate() <= GetTakenFraction()),
+                    "GOSS top rate should be in [0, subsample]"
+                );
+                break;
+            }
             default: {
                 Y_ASSERT(type == EBootstrapType::Bernoulli);
                 if (BaggingTemperature.IsSet()) {
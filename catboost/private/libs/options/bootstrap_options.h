@@ -15,6 +15,7 @@ namespace NCatboostOptions {
             : TakenFraction("subsample", 0.66f)
             , BaggingTemperature("bagging_temperature", 1.0)
             , MvsReg("mvs_reg", Nothing(), ETaskType::CPU)
+            , GossTopRate("goss_top_rate", 0.2f, ETaskType::CPU)
             , BootstrapType("type", EBootstrapType::Bayesian)
             , SamplingUnit("sampling_unit", ESamplingUnit::Object)
             , TaskType(taskType)
@@ -46,6 +47,10 @@ namespace NCatboostOptions {
             return MvsReg.Get();
         }
 
+        float GetGossTopRate() const {
+            return GossTopRate.Get();
+        }
+
         void Validate() const;
 
         TOption<float>& GetTakenFraction() {
@@ -60,12 +65,16 @@ namespace NCatboostOptions {
             return MvsReg;
         }
 
+        TOption<float>& GetGossTopRate() {
+            return GossTopRate;
+        }
+
         TOption<EBootstrapType>& GetBootstrapType() {
             return BootstrapType;
         }
 
         void Load(const NJson::TJsonValue& options) {
-            CheckedLoad(options, &TakenFraction, &BaggingTemperature, &MvsReg, &BootstrapType, &SamplingUnit);
+            CheckedLoad(options, &TakenFraction, &BaggingTemperature, &MvsReg, &GossTopRate, &BootstrapType, &SamplingUnit);
         }
 
         void Save(NJson::TJsonValue* options) const {
@@ -82,6 +91,10 @@ namespace NCatboostOptions {
                     SaveFields(options, TakenFraction, MvsReg, BootstrapType);
                     break;
                 }
+                case EBootstrapType::GOSS: {
+                    SaveFields(options, TakenFraction, GossTopRate, BootstrapType);
+                    break;
+                }
                 default: {
                     SaveFields(options, TakenFraction, BootstrapType);
                     break;
@@ -90,8 +103,8 @@ namespace NCatboostOptions {
         }
 
         bool operator==(const TBootstrapConfig& rhs) const {
-            return std::tie(TakenFraction, BaggingTemperature, MvsReg, BootstrapType, SamplingUnit) ==
-                   std::tie(rhs.TakenFraction, rhs.BaggingTemperature, rhs.MvsReg, rhs.BootstrapType, rhs.SamplingUnit);
+            return std::tie(TakenFraction, BaggingTemperature, MvsReg, GossTopRate, BootstrapType, SamplingUnit) ==
+                   std::tie(rhs.TakenFraction, rhs.BaggingTemperature, rhs.MvsReg, rhs.GossTopRate, rhs.BootstrapType, rhs.SamplingUnit);
         }
 
         bool operator!=(const TBootstrapConfig& rhs) const {
@@ -103,6 +116,7 @@ namespace NCatboostOptions {
         TOption<float> TakenFraction;
         TOption<float> BaggingTemperature;
         TCpuOnlyOption<TMaybe<float>> MvsReg;
+        TCpuOnlyOption<float> GossTopRate;
         TOption<EBootstrapType> BootstrapType;
         TOption<ESamplingUnit> SamplingUnit;
         ETaskType TaskType;
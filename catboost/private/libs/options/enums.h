@@ -17,6 +17,11 @@ enum class ESamplingFrequency {
     PerTreeLevel
 };
 
+enum class EHistogramPrecision {
+    Double,
+    Float
+};
+
 enum class ESamplingUnit {
     Object,
     Group
@@ -83,6 +88,7 @@ enum class EBootstrapType {
     Bayesian,
     Bernoulli,
     MVS, // Minimal Variance Sampling, scheme of bootstrap with subsampling, which reduces variance in score approximation
+    GOSS, // Gradient-based One-Side Sampling, objects with the largest gradients are taken, the rest are subsampled
     No
 };
 
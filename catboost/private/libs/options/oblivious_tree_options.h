@@ -46,6 +46,9 @@ namespace NCatboostOptions {
 
         TCpuOnlyOption<float> SparseFeaturesConflictFraction;
 
+        // precision of bucket statistics accumulation in score calculation
+        TCpuOnlyOption<EHistogramPrecision> HistogramPrecision;
+
         TGpuOnlyOption<EObservationsToBootstrap> ObservationsToBootstrap;
         TGpuOnlyOption<bool> FoldSizeLossNormalization;
         TGpuOnlyOption<bool> AddRidgeToTargetFunctionFlag;
@@ -97,7 +97,8 @@ NCatboostOptions::TOutputFilesOptions::TOutputFilesOptions()
     , MetricPeriod("metric_period", 1)
     , PredictionTypes("prediction_type", {EPredictionType::RawFormulaVal})
     , OutputColumns("output_columns", {"SampleId", "RawFormulaVal", "Label"})
-    , RocOutputPath("roc_file", "") {
+    , RocOutputPath("roc_file", "")
+    , InitModelApproxesCachePath("init_model_approxes_cache", "") {
 }
 
 const TString& NCatboostOptions::TOutputFilesOptions::GetTrainDir() const {
@@ -223,6 +224,10 @@ ui64 NCatboostOptions::TOutputFilesOptions::GetSnapshotSaveInterval() const {
     return SnapshotSaveIntervalSeconds.Get();
 }
 
+const TString& NCatboostOptions::TOutputFilesOptions::GetInitModelApproxesCachePath() const {
+    return InitModelApproxesCachePath.Get();
+}
+
 int NCatboostOptions::TOutputFilesOptions::GetVerbosePeriod() const {
     return VerbosePeriod.IsSet() ? VerbosePeriod.Get() : MetricPeriod.IsSet() ? MetricPeriod.Get() : VerbosePeriod.Get();
 }
@@ -265,7 +270,7 @@ bool NCatboostOptions::TOutputFilesOptions::operator==(const TOutputFilesOptions
             TimeLeftLog, ResultModelPath, SnapshotPath, ModelFormats, SaveSnapshotFlag,
             AllowWriteFilesFlag, FinalCtrComputationMode, FinalFeatureCalcerComputationMode, UseBestModel, BestModelMinTrees,
             SnapshotSaveIntervalSeconds, EvalFileName, FstrRegularFileName, FstrInternalFileName, FstrType,
-            TrainingOptionsFileName, OutputBordersFileName, RocOutputPath
+            TrainingOptionsFileName, OutputBordersFileName, RocOutputPath, InitModelApproxesCachePath
             ) == std::tie(
                 rhs.TrainDir, rhs.Name, rhs.JsonLogPath, rhs.ProfileLogPath,
                 rhs.LearnErrorLogPath, rhs.TestErrorLogPath, rhs.TimeLeftLog, rhs.ResultModelPath,
@@ -273,7 +278,7 @@ bool NCatboostOptions::TOutputFilesOptions::operator==(const TOutputFilesOptions
                 rhs.FinalCtrComputationMode, rhs.FinalFeatureCalcerComputationMode, rhs.UseBestModel, rhs.BestModelMinTrees,
                 rhs.SnapshotSaveIntervalSeconds, rhs.EvalFileName, rhs.FstrRegularFileName,
                 rhs.FstrInternalFileName, rhs.FstrType, rhs.TrainingOptionsFileName, rhs.OutputBordersFileName,
-                rhs.RocOutputPath
+                rhs.RocOutputPath, rhs.InitModelApproxesCachePath
                 );
 }
 
@@ -289,7 +294,8 @@ void NCatboostOptions::TOutputFilesOptions::Load(const NJson::TJsonValue& option
             &SaveSnapshotFlag, &AllowWriteFilesFlag, &FinalCtrComputationMode, &FinalFeatureCalcerComputationMode,
             &UseBestModel, &BestModelMinTrees, &SnapshotSaveIntervalSeconds, &EvalFileName, &OutputColumns,
             &FstrRegularFileName, &FstrInternalFileName, &FstrType, &TrainingOptionsFileName, &MetricPeriod,
-            &VerbosePeriod, &PredictionTypes, &OutputBordersFileName, &RocOutputPath
+            &VerbosePeriod, &PredictionTypes, &OutputBordersFileName, &RocOutputPath,
+            &InitModelApproxesCachePath
             );
     if (!VerbosePeriod.IsSet() || VerbosePeriod.Get() == 1) {
         VerbosePeriod.Set(MetricPeriod.Get());
@@ -305,7 +311,7 @@ void NCatboostOptions::TOutputFilesOptions::Save(NJson::TJsonValue* options) con
             AllowWriteFilesFlag, FinalCtrComputationMode, FinalFeatureCalcerComputationMode, UseBestModel,
             BestModelMinTrees, SnapshotSaveIntervalSeconds, EvalFileName, OutputColumns, FstrRegularFileName,
             FstrInternalFileName, FstrType, TrainingOptionsFileName, MetricPeriod, VerbosePeriod, PredictionTypes,
-            OutputBordersFileName, RocOutputPath
+            OutputBordersFileName, RocOutputPath, InitModelApproxesCachePath
             );
 }
 
@@ -77,6 +77,11 @@ namespace NCatboostOptions {
 
         ui64 GetSnapshotSaveInterval() const;
 
+        /* file with approxes of the init model on learn and eval datasets,
+         * reused instead of applying the init model when training is continued on the same data
+         */
+        const TString& GetInitModelApproxesCachePath() const;
+
         int GetVerbosePeriod() const;
 
         int GetMetricPeriod() const;
@@ -155,5 +160,6 @@ namespace NCatboostOptions {
         TOption<TVector<EPredictionType>> PredictionTypes;
         TOption<TVector<TString>> OutputColumns;
         TOption<TString> RocOutputPath;
+        TOption<TString> InitModelApproxesCachePath;
     };
 }
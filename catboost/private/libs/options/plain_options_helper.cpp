@@ -308,6 +308,7 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "model_format",  &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "output_borders",  &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "roc_file",  &outputFilesJson, &seenKeys);
+    CopyOption(plainOptions, "init_model_approxes_cache", &outputFilesJson, &seenKeys);
 
 
     //boosting options
@@ -349,6 +350,7 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "dev_score_calc_obj_block_size", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "dev_efb_max_buckets", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "sparse_features_conflict_fraction", &treeOptions, &seenKeys);
+    CopyOption(plainOptions, "cpu_histogram_precision", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "random_strength", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "leaf_estimation_method", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "grow_policy", &treeOptions, &seenKeys);
@@ -370,6 +372,7 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "bagging_temperature", &bootstrapOptions, &seenKeys);
     CopyOption(plainOptions, "subsample", &bootstrapOptions, &seenKeys);
     CopyOption(plainOptions, "mvs_reg", &bootstrapOptions, &seenKeys);
+    CopyOption(plainOptions, "goss_top_rate", &bootstrapOptions, &seenKeys);
     CopyOption(plainOptions, "sampling_unit", &bootstrapOptions, &seenKeys);
 
     auto& featurePenaltiesOptions = treeOptions["penalties"];
@@ -558,6 +561,7 @@ void NCatboostOptions::ConvertOptionsToPlainJson(
     DeleteSeenOption(&outputoptionsCopy, "model_format");
     DeleteSeenOption(&outputoptionsCopy, "output_borders");
     DeleteSeenOption(&outputoptionsCopy, "roc_file");
+    DeleteSeenOption(&outputoptionsCopy, "init_model_approxes_cache");
     CB_ENSURE(outputoptionsCopy.GetMapSafe().empty(), "output_options: key " + outputoptionsCopy.GetMapSafe().begin()->first + " wasn't added to plain options.");
 
     // boosting options
@@ -659,6 +663,9 @@ void NCatboostOptions::ConvertOptionsToPlainJson(
         CopyOption(treeOptions, "sparse_features_conflict_fraction", &plainOptionsJson, &seenKeys);
         DeleteSeenOption(&optionsCopyTree, "sparse_features_conflict_fraction");
 
+        CopyOption(treeOptions, "cpu_histogram_precision", &plainOptionsJson, &seenKeys);
+        DeleteSeenOption(&optionsCopyTree, "cpu_histogram_precision");
+
         CopyOption(treeOptions, "random_strength", &plainOptionsJson, &seenKeys);
         DeleteSeenOption(&optionsCopyTree, "random_strength");
 
@@ -714,6 +721,9 @@ void NCatboostOptions::ConvertOptionsToPlainJson(
             CopyOption(bootstrapOptions, "mvs_reg", &plainOptionsJson, &seenKeys);
             DeleteSeenOption(&optionsCopyTreeBootstrap, "mvs_reg");
 
+            CopyOption(bootstrapOptions, "goss_top_rate", &plainOptionsJson, &seenKeys);
+            DeleteSeenOption(&optionsCopyTreeBootstrap, "goss_top_rate");
+
             CopyOption(bootstrapOptions, "sampling_unit", &plainOptionsJson, &seenKeys);
             DeleteSeenOption(&optionsCopyTreeBootstrap, "sampling_unit");
 
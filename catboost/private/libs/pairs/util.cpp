@@ -3,40 +3,36 @@
 #include <catboost/libs/data/util.h>
 #include <catboost/private/libs/options/loss_description.h>
 
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
 #include <util/generic/set.h>
 #include <util/generic/hash.h>
+#include <util/generic/xrange.h>
 #include <util/random/shuffle.h>
 
 
 using namespace NCB;
 
 
+// writes all pairs of objects with different targets to dst
 static void GenerateBruteForce(
     ui32 groupBegin,
     ui32 groupEnd,
-    int maxPairCount,
-    int pairCount,
     TConstArrayRef<float> targetId,
-    TRestorableFastRng64* rand,
-    TVector<TPair>* result
+    TPair* dst
 ) {
-    auto resultShift = result->size();
     for (ui32 firstIdx = groupBegin; firstIdx < groupEnd; ++firstIdx) {
         for (ui32 secondIdx = firstIdx + 1; secondIdx < groupEnd; ++secondIdx) {
             if (targetId[firstIdx] == targetId[secondIdx]) {
                 continue;
             }
             if (targetId[firstIdx] > targetId[secondIdx]) {
-                result->push_back(TPair(firstIdx, secondIdx, 1));
+                *dst++ = TPair(firstIdx, secondIdx, 1);
             } else {
-                result->push_back(TPair(secondIdx, firstIdx, 1));
+                *dst++ = TPair(secondIdx, firstIdx, 1);
             }
         }
     }
-    if (maxPairCount != NCatboostOptions::MAX_AUTOGENERATED_PAIRS_COUNT && maxPairCount < pairCount) {
-        Shuffle(result->begin() + resultShift, result->end(), *rand);
-        result->resize(resultShift + maxPairCount);
-    }
 }
 
 static bool TryGeneratePair(
@@ -61,13 +57,14 @@ static bool TryGeneratePair(
     return true;
 }
 
+// writes maxPairCount pairs to dst
 static void GenerateRandomly(
     ui32 groupBegin,
     ui32 groupEnd,
     int maxPairCount,
     TConstArrayRef<float> targetId,
     TRestorableFastRng64* rand,
-    TVector<TPair>* result
+    TPair* dst
 ) {
     TSet<std::pair<ui32, ui32>> generatedPairs;
     while (int(generatedPairs.size()) < maxPairCount) {
@@ -77,15 +74,25 @@ static void GenerateRandomly(
         }
     }
     for (const auto& pair : generatedPairs) {
-        result->push_back(TPair(pair.first, pair.second, 1));
+        *dst++ = TPair(pair.first, pair.second, 1);
     }
 }
 
+namespace {
+    struct TGroupPairsInfo {
+        ui64 PairCount = 0; // count of pairs of objects with different targets
+        bool IsBruteForce = true;
+        ui64 Offset = 0; // in result
+        ui64 Size = 0;
+    };
+}
+
 void GeneratePairLogitPairs(
     const TObjectsGrouping& objectsGrouping,
     TConstArrayRef<float> targetId,
     int maxPairCount,
     TRestorableFastRng64* rand,
+    NPar::TLocalExecutor* localExecutor,
     TVector<TPair>* result
 ) {
     CB_ENSURE(!objectsGrouping.IsTrivial(), "Cannot generate pairs for data without groups");
@@ -98,24 +105,99 @@ void GeneratePairLogitPairs(
         "object count",
         true);
 
-    THashMap<float, int> targetCount;
-    for (const auto& group : objectsGrouping.GetNonTrivialGroups()) {
-        for (auto objectIdx : group.Iter()) {
-            targetCount[targetId[objectIdx]]++;
-        }
-        unsigned long long pairCount = 0;
-        for (auto target: targetCount) {
-            pairCount += target.second * static_cast<unsigned long long>(group.GetSize() - target.second);
-        }
-        pairCount /= 2;
-        if (maxPairCount == NCatboostOptions::MAX_AUTOGENERATED_PAIRS_COUNT || pairCount / 2 < static_cast<unsigned long long>(maxPairCount)) {
-            CB_ENSURE(pairCount <= 1022 * 1023  / 2,  // cause 1023 is max group size for gpu
-                "Toо many pairs should be generated for group: " << pairCount << " , use max_pairs option to limit generated pair count");
-            GenerateBruteForce(group.Begin, group.End, maxPairCount, static_cast<int>(pairCount), targetId, rand, result);
+    const auto groups = objectsGrouping.GetNonTrivialGroups();
+    if (groups.empty()) {
+        return;
+    }
+    const bool isPairCountLimited = maxPairCount != NCatboostOptions::MAX_AUTOGENERATED_PAIRS_COUNT;
+
+    TVector<TGroupPairsInfo> groupPairsInfos(groups.size());
+
+    NPar::TLocalExecutor::TExecRangeParams rangeParams(0, SafeIntegerCast<int>(groups.size()));
+    rangeParams.SetBlockCountToThreadCount();
+
+    localExecutor->ExecRangeWithThrow(
+        [&] (int blockIdx) {
+            THashMap<float, int> targetCount;
+            const int blockBegin = blockIdx * rangeParams.GetBlockSize();
+            const int blockEnd = Min(blockBegin + rangeParams.GetBlockSize(), rangeParams.LastId);
+            for (auto groupIdx : xrange(blockBegin, blockEnd)) {
+                const auto& group = groups[groupIdx];
+                for (auto objectIdx : group.Iter()) {
+                    targetCount[targetId[objectIdx]]++;
+                }
+                unsigned long long pairCount = 0;
+                for (auto target: targetCount) {
+                    pairCount += target.second * static_cast<unsigned long long>(group.GetSize() - target.second);
+                }
+                pairCount /= 2;
+                auto& groupPairsInfo = groupPairsInfos[groupIdx];
+                groupPairsInfo.PairCount = pairCount;
+                groupPairsInfo.IsBruteForce
+                    = !isPairCountLimited || pairCount / 2 < static_cast<unsigned long long>(maxPairCount);
+                if (groupPairsInfo.IsBruteForce) {
+                    CB_ENSURE(pairCount <= 1022 * 1023  / 2,  // cause 1023 is max group size for gpu
+                        "Toо many pairs should be generated for group: " << pairCount << " , use max_pairs option to limit generated pair count");
+                    groupPairsInfo.Size
+                        = (isPairCountLimited && static_cast<unsigned long long>(maxPairCount) < pairCount) ?
+                            maxPairCount : pairCount;
+                } else {
+                    groupPairsInfo.Size = maxPairCount;
+                }
+                targetCount.clear();
+            }
+        },
+        0,
+        rangeParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    // pairs are written to their final place in result, so it is allocated only once
+    ui64 offset = result->size();
+    for (auto& groupPairsInfo : groupPairsInfos) {
+        groupPairsInfo.Offset = offset;
+        offset += groupPairsInfo.Size;
+    }
+    result->yresize(offset);
+    TPair* resultData = result->data();
+
+    // groups that do not need random numbers are processed in parallel
+    localExecutor->ExecRange(
+        [&] (int groupIdx) {
+            const auto& groupPairsInfo = groupPairsInfos[groupIdx];
+            if (groupPairsInfo.IsBruteForce && (groupPairsInfo.Size == groupPairsInfo.PairCount)) {
+                GenerateBruteForce(
+                    groups[groupIdx].Begin,
+                    groups[groupIdx].End,
+                    targetId,
+                    resultData + groupPairsInfo.Offset);
+            }
+        },
+        rangeParams,
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    // other groups use rand sequentially in groups order
+    TVector<TPair> groupPairs;
+    for (auto groupIdx : xrange(groups.size())) {
+        const auto& group = groups[groupIdx];
+        const auto& groupPairsInfo = groupPairsInfos[groupIdx];
+        if (groupPairsInfo.IsBruteForce) {
+            if (groupPairsInfo.Size < groupPairsInfo.PairCount) {
+                groupPairs.yresize(groupPairsInfo.PairCount);
+                GenerateBruteForce(group.Begin, group.End, targetId, groupPairs.data());
+                Shuffle(groupPairs.begin(), groupPairs.end(), *rand);
+                Copy(
+                    groupPairs.begin(),
+                    groupPairs.begin() + groupPairsInfo.Size,
+                    resultData + groupPairsInfo.Offset);
+            }
         } else {
-            GenerateRandomly(group.Begin, group.End, maxPairCount, targetId, rand, result);
+            GenerateRandomly(
+                group.Begin,
+                group.End,
+                maxPairCount,
+                targetId,
+                rand,
+                resultData + groupPairsInfo.Offset);
         }
-        targetCount.clear();
     }
 }
-
@@ -5,6 +5,8 @@
 
 #include <catboost/libs/helpers/restorable_rng.h>
 
+#include <library/cpp/threading/local_executor/local_executor.h>
+
 #include <util/generic/array_ref.h>
 #include <util/generic/vector.h>
 
@@ -14,4 +16,5 @@ void GeneratePairLogitPairs(
     TConstArrayRef<float> targetId,
     int maxPairCount,
     TRestorableFastRng64* rand,
+    NPar::TLocalExecutor* localExecutor,
     TVector<TPair>* result);
@@ -21,6 +21,7 @@
 #include <util/generic/scope.h>
 #include <util/generic/vector.h>
 #include <util/generic/ylimits.h>
+#include <util/system/align.h>
 #include <util/system/madvise.h>
 #include <util/system/types.h>
 #include <util/system/unaligned_mem.h>
@@ -42,7 +43,10 @@ using NCB::TUnalignedArrayBuf;
 
 NCB::TCBQuantizedDataLoader::TCBQuantizedDataLoader(TDatasetLoaderPullArgs&& args)
     : ObjectCount(0) // inited later
-    , QuantizedPool(std::forward<TQuantizedPool>(LoadQuantizedPool(args.PoolPath, GetLoadParameters(args.CommonArgs.DatasetSubset))))
+    , QuantizedPool(std::forward<TQuantizedPool>(LoadQuantizedPool(args.PoolPath, GetLoadParameters(
+        args.CommonArgs.DatasetSubset,
+        args.CommonArgs.LocalExecutor,
+        args.CommonArgs.IgnoredFeatures))))
     , PairsPath(args.CommonArgs.PairsFilePath)
     , GroupWeightsPath(args.CommonArgs.GroupWeightsFilePath)
     , BaselinePath(args.CommonArgs.BaselineFilePath)
@@ -103,6 +107,10 @@ namespace {
         explicit TSequentialChunkEvictor(ui64 minSizeInBytesToEvict);
 
         void Push(const TChunkRef& chunk);
+
+        // evict pushed data and exclude chunk from eviction (its data is still used after loading)
+        void Skip(const TChunkRef& chunk) noexcept;
+
         void MaybeEvict(bool force = false) noexcept;
 
     private:
@@ -138,10 +146,24 @@ void TSequentialChunkEvictor::Push(const TChunkRef& chunk) {
     }
 }
 
+void TSequentialChunkEvictor::Skip(const TChunkRef& chunk) noexcept {
+    if (Data_) {
+        MaybeEvict(/*force*/ true);
+    }
+    Data_ = reinterpret_cast<const ui8*>(chunk.Description->Chunk->Quants()->data())
+        + chunk.Description->Chunk->Quants()->size();
+    Size_ = 0;
+    Evicted_ = true;
+}
+
 void TSequentialChunkEvictor::MaybeEvict(const bool force) noexcept {
     if (Evicted_ || !force && Size_ < MinSizeInBytesToEvict_) {
         return;
     }
+    if (!Size_) {
+        Evicted_ = true;
+        return;
+    }
 
     try {
 #if !defined(_win_)
@@ -214,7 +236,7 @@ void NCB::TCBQuantizedDataLoader::AddQuantizedFeatureChunk(
         flatFeatureIdx,
         GetDatasetOffset(chunk),
         chunk.Chunk->BitsPerDocument(),
-        TMaybeOwningConstArrayHolder<ui8>::CreateNonOwning(quants));
+        GetFeatureChunkData(chunk));
 }
 
  void NCB::TCBQuantizedDataLoader::AddQuantizedCatFeatureChunk(
@@ -232,7 +254,7 @@ void NCB::TCBQuantizedDataLoader::AddQuantizedFeatureChunk(
         flatFeatureIdx,
         GetDatasetOffset(chunk),
         chunk.Chunk->BitsPerDocument(),
-        TMaybeOwningConstArrayHolder<ui8>::CreateNonOwning(quants));
+        GetFeatureChunkData(chunk));
 }
 
 void NCB::TCBQuantizedDataLoader::AddChunk(
@@ -323,6 +345,38 @@ TConstArrayRef<ui8> NCB::TCBQuantizedDataLoader::ClipByDatasetSubset(const TQuan
     }
 }
 
+bool NCB::TCBQuantizedDataLoader::CanUseMappedChunk(const TQuantizedPool::TChunkDescription& chunk) const {
+    if (!MappedPoolHolder || (chunk.DocumentOffset != DatasetSubset.Range.Begin)) {
+        return false;
+    }
+    const auto quants = ClipByDatasetSubset(chunk);
+    const auto valueBytes = static_cast<size_t>(chunk.Chunk->BitsPerDocument() / CHAR_BIT);
+    if (quants.size() != static_cast<size_t>(ObjectCount) * valueBytes) {
+        return false;
+    }
+    if (reinterpret_cast<uintptr_t>(quants.data()) % alignof(ui64)) {
+        return false;
+    }
+
+    /* data provider accesses data in whole ui64 words, so the last word can extend beyond chunk data but it
+     * still must be inside the file (it always is for the file format because pool metainfo follows chunks)
+     */
+    const auto& blob = QuantizedPool.Blobs.back();
+    const auto* const blobEnd = blob.AsUnsignedCharPtr() + blob.Size();
+    return quants.data() + AlignUp(quants.size(), sizeof(ui64)) <= blobEnd;
+}
+
+TMaybeOwningConstArrayHolder<ui8> NCB::TCBQuantizedDataLoader::GetFeatureChunkData(
+    const TQuantizedPool::TChunkDescription& chunk) const
+{
+    const auto quants = ClipByDatasetSubset(chunk);
+    if (CanUseMappedChunk(chunk)) {
+        // owning holder signals that data can be referenced after the loading has finished
+        return TMaybeOwningConstArrayHolder<ui8>::CreateOwning(quants, MappedPoolHolder);
+    }
+    return TMaybeOwningConstArrayHolder<ui8>::CreateNonOwning(quants);
+}
+
 ui32 NCB::TCBQuantizedDataLoader::GetDatasetOffset(const TQuantizedPool::TChunkDescription& chunk) const {
     const auto documentCount = chunk.Chunk->Quants()->size()
          / static_cast<size_t>(chunk.Chunk->BitsPerDocument() / CHAR_BIT);
@@ -352,11 +406,23 @@ void NCB::TCBQuantizedDataLoader::Do(IQuantizedFeaturesDataVisitor* visitor) {
     const auto columnIdxToBaselineIdx = GetColumnIndexToBaselineIndexMap(QuantizedPool);
     const auto chunkRefs = GatherAndSortChunks(QuantizedPool);
 
+    const bool readingFromMappedFile = QuantizedPool.ChunkStorage.empty();
+    if (readingFromMappedFile && (QuantizedPool.Blobs.size() == 1)) {
+        MappedPoolHolder = MakeIntrusive<NCB::TBlobHolder>(QuantizedPool.Blobs.back());
+    }
+
     TSequentialChunkEvictor evictor(1ULL << 24);
     CATBOOST_DEBUG_LOG << "Number of chunks to process " << chunkRefs.size() << Endl;
     for (const auto chunkRef : chunkRefs) {
-        if (QuantizedPool.ChunkStorage.empty()) { // reading from mapped file
-            evictor.Push(chunkRef);
+        if (readingFromMappedFile) {
+            const bool isFeatureChunk = (chunkRef.LocalIndex < QuantizedPool.ColumnTypes.size())
+                && EqualToOneOf(QuantizedPool.ColumnTypes[chunkRef.LocalIndex], EColumn::Num, EColumn::Categ);
+            if (isFeatureChunk && CanUseMappedChunk(*chunkRef.Description))
+            {
+                evictor.Skip(chunkRef);
+            } else {
+                evictor.Push(chunkRef);
+            }
         }
         Y_DEFER { evictor.MaybeEvict(); };
 
@@ -400,7 +466,8 @@ void NCB::TCBQuantizedDataLoader::Do(IQuantizedFeaturesDataVisitor* visitor) {
 
     evictor.MaybeEvict(true);
 
-    QuantizedPool = TQuantizedPool(); // release memory
+    QuantizedPool = TQuantizedPool(); // release memory (mapping is still held by MappedPoolHolder if used)
+    MappedPoolHolder.Reset();
     SetGroupWeights(GroupWeightsPath, ObjectCount, DatasetSubset, visitor);
     SetPairs(PairsPath, ObjectCount, DatasetSubset, visitor);
     SetBaseline(BaselinePath, ObjectCount, DatasetSubset, NCB::ClassLabelsToStrings(DataMetaInfo.ClassLabels), visitor);
@@ -411,5 +478,8 @@ void NCB::TCBQuantizedDataLoader::Do(IQuantizedFeaturesDataVisitor* visitor) {
 namespace {
     TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSQuantizedExistsCheckerReg("quantized");
     TDatasetLoaderFactory::TRegistrator<NCB::TCBQuantizedDataLoader> CBQuantizedDataLoaderReg("quantized");
+
+    TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSQuantizedShardedExistsCheckerReg("quantized-sharded");
+    TDatasetLoaderFactory::TRegistrator<NCB::TCBQuantizedDataLoader> CBQuantizedShardedDataLoaderReg("quantized-sharded");
 }
 
@@ -4,6 +4,8 @@
 #include "serialization.h"
 
 #include <catboost/libs/data/loader.h>
+#include <catboost/libs/helpers/maybe_owning_array_holder.h>
+#include <catboost/libs/helpers/resource_holder.h>
 #include <catboost/private/libs/index_range/index_range.h>
 
 #include <library/cpp/object_factory/object_factory.h>
@@ -37,10 +39,26 @@ namespace NCB {
             IQuantizedFeaturesDataVisitor* visitor) const;
 
         TConstArrayRef<ui8> ClipByDatasetSubset(const TQuantizedPool::TChunkDescription& chunk) const;
+
+        /* returns true if feature chunk data can be used by data provider directly from the mapped file:
+         * chunk contains all loaded objects and its data is properly aligned
+         */
+        bool CanUseMappedChunk(const TQuantizedPool::TChunkDescription& chunk) const;
+        TMaybeOwningConstArrayHolder<ui8> GetFeatureChunkData(const TQuantizedPool::TChunkDescription& chunk) const;
         ui32 GetDatasetOffset(const TQuantizedPool::TChunkDescription& chunk) const;
 
-        static TLoadQuantizedPoolParameters GetLoadParameters(NCB::TDatasetSubset loadSubset) {
-            return {/*LockMemory*/ false, /*Precharge*/ false, loadSubset};
+        static TLoadQuantizedPoolParameters GetLoadParameters(
+            NCB::TDatasetSubset loadSubset,
+            NPar::TLocalExecutor* localExecutor,
+            TConstArrayRef<ui32> ignoredFeatures
+        ) {
+            return {
+                /*LockMemory*/ false,
+                /*Precharge*/ false,
+                loadSubset,
+                localExecutor,
+                TVector<ui32>(ignoredFeatures.begin(), ignoredFeatures.end())
+            };
         }
 
     private:
@@ -55,6 +73,9 @@ namespace NCB {
         TDataMetaInfo DataMetaInfo;
         EObjectsOrder ObjectsOrder;
         TDatasetSubset DatasetSubset;
+
+        // holds pool file mapping for feature columns that are used without copying, null if pool is not mapped
+        TIntrusivePtr<IResourceHolder> MappedPoolHolder;
     };
 
     struct IQuantizedPoolLoader {
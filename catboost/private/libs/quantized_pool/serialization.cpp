@@ -12,6 +12,9 @@
 
 #include <contrib/libs/flatbuffers/include/flatbuffers/flatbuffers.h>
 
+#include <library/cpp/blockcodecs/codecs.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
 #include <catboost/idl/pool/flat/quantized_chunk_t.fbs.h>
 
 #include <util/digest/numeric.h>
@@ -19,19 +22,26 @@
 #include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/array_size.h>
+#include <util/generic/buffer.h>
 #include <util/generic/cast.h>
 #include <util/generic/deque.h>
+#include <util/generic/hash_set.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/string.h>
 #include <util/generic/utility.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
 #include <util/memory/blob.h>
 #include <util/stream/file.h>
 #include <util/stream/input.h>
 #include <util/stream/length.h>
 #include <util/stream/mem.h>
 #include <util/stream/output.h>
+#include <util/string/cast.h>
+#include <util/string/split.h>
 #include <util/system/byteorder.h>
+#include <util/system/fs.h>
 #include <util/system/unaligned_mem.h>
 #include <util/system/info.h>
 
@@ -47,7 +57,8 @@ static const size_t MagicSize = Y_ARRAY_SIZE(Magic);  // yes, with terminating z
 static const char MagicEnd[] = "CatboostQuantizedPoolEnd";
 static const size_t MagicEndSize = Y_ARRAY_SIZE(MagicEnd);  // yes, with terminating zero
 static const ui32 Version = 1;
-static const ui32 VersionHash = IntHash(Version);
+// chunks have headers with compression codec name, written only if chunks compression is enabled
+static const ui32 VersionWithChunkHeaders = 2;
 
 template <typename T>
 static TDeque<ui32> CollectAndSortKeys(const T& m) {
@@ -120,9 +131,12 @@ namespace {
 
 static void WriteChunk(
     const NCB::TQuantizedPool::TChunkDescription& chunk,
+    const ui32 version,
+    const NBlockCodecs::ICodec* const codec, // can be nullptr to write raw chunks
     TCountingOutput* const output,
     TDeque<TChunkInfo>* const chunkInfos,
-    flatbuffers::FlatBufferBuilder* const builder) {
+    flatbuffers::FlatBufferBuilder* const builder,
+    TBuffer* const compressedBuffer) {
 
     builder->Clear();
 
@@ -137,15 +151,39 @@ static void WriteChunk(
     AddPadding(16, output);
 
     const auto chunkOffset = output->Counter();
-    output->Write(builder->GetBufferPointer(), builder->GetSize());
+    if (version == VersionWithChunkHeaders) {
+        const TStringBuf chunkData(
+            reinterpret_cast<const char*>(builder->GetBufferPointer()),
+            builder->GetSize());
+        const bool isCompressed = codec && [&] {
+            codec->Encode(chunkData, *compressedBuffer);
+            return compressedBuffer->Size() < chunkData.size();
+        }();
+
+        // chunk header: | 4-byte codec name size | codec name (empty for raw chunk) | padding |
+        const TStringBuf codecName = isCompressed ? codec->Name() : TStringBuf();
+        WriteLittleEndian(SafeIntegerCast<ui32>(codecName.size()), output);
+        output->Write(codecName.data(), codecName.size());
+
+        // raw chunk data is aligned to be used directly from mapped file
+        AddPadding(16, output);
+        if (isCompressed) {
+            output->Write(compressedBuffer->Data(), compressedBuffer->Size());
+        } else {
+            output->Write(chunkData.data(), chunkData.size());
+        }
+    } else {
+        output->Write(builder->GetBufferPointer(), builder->GetSize());
+    }
+    const ui32 chunkSize = output->Counter() - chunkOffset;
 
-    chunkInfos->emplace_back(builder->GetSize(), chunkOffset, chunk.DocumentOffset, chunk.DocumentCount);
+    chunkInfos->emplace_back(chunkSize, chunkOffset, chunk.DocumentOffset, chunk.DocumentCount);
 }
 
-static void WriteHeader(TCountingOutput* const output) {
+static void WriteHeader(const ui32 version, TCountingOutput* const output) {
     output->Write(Magic, MagicSize);
-    WriteLittleEndian(Version, output);
-    WriteLittleEndian(VersionHash, output);
+    WriteLittleEndian(version, output);
+    WriteLittleEndian(IntHash(version), output);
 
     const ui32 metainfoSize = 0;
     WriteLittleEndian(metainfoSize, output);
@@ -230,10 +268,19 @@ static TPoolMetainfo MakePoolMetainfo(
     return metainfo;
 }
 
-static void WriteAsOneFile(const NCB::TQuantizedPool& pool, IOutputStream* slave) {
+static void WriteAsOneFile(
+    const NCB::TQuantizedPool& pool,
+    const TStringBuf chunksCompressionCodec,
+    IOutputStream* slave) {
+
+    const NBlockCodecs::ICodec* const codec = chunksCompressionCodec
+        ? NBlockCodecs::Codec(chunksCompressionCodec)
+        : nullptr;
+    const ui32 version = codec ? VersionWithChunkHeaders : Version;
+
     TCountingOutput output(slave);
 
-    WriteHeader(&output);
+    WriteHeader(version, &output);
 
     const auto chunksOffset = output.Counter();
 
@@ -242,11 +289,12 @@ static void WriteAsOneFile(const NCB::TQuantizedPool& pool, IOutputStream* slave
     perFeatureChunkInfos.resize(pool.ColumnIndexToLocalIndex.size());
     {
         flatbuffers::FlatBufferBuilder builder;
+        TBuffer compressedBuffer;
         for (const auto trueFeatureIndex : sortedTrueFeatureIndices) {
             const auto localIndex = pool.ColumnIndexToLocalIndex.at(trueFeatureIndex);
             auto* const chunkInfos = &perFeatureChunkInfos[localIndex];
             for (const auto& chunk : pool.Chunks[localIndex]) {
-                WriteChunk(chunk, &output, chunkInfos, &builder);
+                WriteChunk(chunk, version, codec, &output, chunkInfos, &builder, &compressedBuffer);
             }
         }
     }
@@ -293,8 +341,12 @@ static void WriteAsOneFile(const NCB::TQuantizedPool& pool, IOutputStream* slave
     output.Write(MagicEnd, MagicEndSize);
 }
 
-void NCB::SaveQuantizedPool(const TQuantizedPool& pool, IOutputStream* const output) {
-    WriteAsOneFile(pool, output);
+void NCB::SaveQuantizedPool(
+    const TQuantizedPool& pool,
+    IOutputStream* const output,
+    const TStringBuf chunksCompressionCodec) {
+
+    WriteAsOneFile(pool, chunksCompressionCodec, output);
 }
 
 static void ValidatePoolPart(const TConstArrayRef<char> blob) {
@@ -302,7 +354,8 @@ static void ValidatePoolPart(const TConstArrayRef<char> blob) {
     (void)blob;
 }
 
-static void ReadHeader(TCountingInput* const input) {
+// returns version
+static ui32 ReadHeader(TCountingInput* const input) {
     char magic[MagicSize];
     const auto magicSize = input->Load(magic, MagicSize);
     CB_ENSURE(MagicSize == magicSize);
@@ -310,11 +363,13 @@ static void ReadHeader(TCountingInput* const input) {
 
     ui32 version;
     ReadLittleEndian(&version, input);
-    CB_ENSURE(Version == version);
+    CB_ENSURE(
+        Version == version || VersionWithChunkHeaders == version,
+        "Unsupported quantized pool version " << version);
 
     ui32 versionHash;
     ReadLittleEndian(&versionHash, input);
-    CB_ENSURE(VersionHash == versionHash);
+    CB_ENSURE(IntHash(version) == versionHash);
 
     ui32 metainfoSize;
     ReadLittleEndian(&metainfoSize, input);
@@ -323,6 +378,8 @@ static void ReadHeader(TCountingInput* const input) {
 
     const auto metainfoBytesSkipped = input->Skip(metainfoSize);
     CB_ENSURE(metainfoSize == metainfoBytesSkipped);
+
+    return version;
 }
 
 template <typename T>
@@ -479,6 +536,36 @@ namespace {
     };
 }
 
+// Feature columns with flat indices from `ignoredFeatures`, flat indices enumerate factor columns in
+// ascending column index order (see `GetColumnIndexToFlatIndexMap`).
+static THashSet<ui32> GetSkippedColumnIndices(
+    const TPoolMetainfo& poolMetainfo,
+    const TConstArrayRef<ui32> ignoredFeatures)
+{
+    THashSet<ui32> skippedColumnIndices;
+    if (ignoredFeatures.empty()) {
+        return skippedColumnIndices;
+    }
+
+    TVector<ui32> factorColumnIndices;
+    for (const auto [columnIndex, pbType] : poolMetainfo.GetColumnIndexToType()) {
+        if (pbType == NCB::NIdl::CT_NUMERIC ||
+            pbType == NCB::NIdl::CT_CATEGORICAL ||
+            pbType == NCB::NIdl::CT_SPARSE)
+        {
+            factorColumnIndices.push_back(columnIndex);
+        }
+    }
+    Sort(factorColumnIndices);
+
+    for (const auto flatFeatureIndex : ignoredFeatures) {
+        if (flatFeatureIndex < factorColumnIndices.size()) {
+            skippedColumnIndices.insert(factorColumnIndices[flatFeatureIndex]);
+        }
+    }
+    return skippedColumnIndices;
+}
+
 NCB::TQuantizedPool TFileQuantizedPoolLoader::LoadQuantizedPool(NCB::TLoadQuantizedPoolParameters params) {
     CB_ENSURE_INTERNAL(
         params.DatasetSubset.Range == NCB::TDatasetSubset().Range &&
@@ -500,10 +587,11 @@ NCB::TQuantizedPool TFileQuantizedPoolLoader::LoadQuantizedPool(NCB::TLoadQuanti
 
     ValidatePoolPart(blob);
 
-    const auto chunksOffsetByReading = [blob] {
+    ui32 version;
+    const auto chunksOffsetByReading = [blob, &version] {
         TMemoryInput slave(blob.data(), blob.size());
         TCountingInput input(&slave);
-        ReadHeader(&input);
+        version = ReadHeader(&input);
         return input.Counter();
     }();
     const auto epilogOffsets = ReadEpilogOffsets(blob);
@@ -524,6 +612,8 @@ NCB::TQuantizedPool TFileQuantizedPoolLoader::LoadQuantizedPool(NCB::TLoadQuanti
         quantizationSchemaSize);
     CB_ENSURE(quantizationSchemaParsed);
 
+    const auto skippedColumnIndices = GetSkippedColumnIndices(poolMetainfo, params.IgnoredFeatures);
+
     TMemoryInput epilog(
         blob.data() + epilogOffsets.FeatureCountOffset,
         blob.size() - epilogOffsets.FeatureCountOffset - MagicEndSize - sizeof(ui64) + 4);
@@ -531,6 +621,16 @@ NCB::TQuantizedPool TFileQuantizedPoolLoader::LoadQuantizedPool(NCB::TLoadQuanti
     TVector<TVector<NCB::TQuantizedPool::TChunkDescription>> stringColumnChunks;
     THashMap<ui32, EColumn> stringColumnIndexToColumnType;
 
+    // chunks are decompressed after reading the epilog, Chunk pointers are set after that
+    struct TCompressedChunk {
+        bool IsStringColumn;
+        size_t ColumnChunksIdx; // in pool.Chunks or in stringColumnChunks
+        size_t ChunkIdx;
+        const NBlockCodecs::ICodec* Codec;
+        TStringBuf Data;
+    };
+    TVector<TCompressedChunk> compressedChunks;
+
     ui32 featureCount;
     ReadLittleEndian(&featureCount, &epilog);
     for (ui32 i = 0; i < featureCount; ++i) {
@@ -570,6 +670,12 @@ NCB::TQuantizedPool TFileQuantizedPoolLoader::LoadQuantizedPool(NCB::TLoadQuanti
         ui32 docOffset;
         ui32 docsInChunkCount;
         const size_t featureEpilogBytes = chunkCount * (sizeof(chunkSize) + sizeof(chunkOffset) + sizeof(docOffset) + sizeof(docsInChunkCount));
+        if (!isFakeColumn && skippedColumnIndices.contains(featureIndex)) {
+            // leave chunks of the column empty: its data is neither decompressed nor touched in the
+            // mapped file
+            CB_ENSURE(featureEpilogBytes == epilog.Skip(featureEpilogBytes));
+            continue;
+        }
         TVector<ui8> featureEpilog(featureEpilogBytes);
         CB_ENSURE(featureEpilogBytes == epilog.Load(featureEpilog.data(), featureEpilogBytes));
         const auto* featureEpilogPtr = featureEpilog.data();
@@ -584,7 +690,30 @@ NCB::TQuantizedPool TFileQuantizedPoolLoader::LoadQuantizedPool(NCB::TLoadQuanti
 
             ReadLittleEndian(&docsInChunkCount, &featureEpilogPtr);
 
-            const TConstArrayRef<char> chunkBlob{blob.data() + chunkOffset, chunkSize};
+            CB_ENSURE(chunkOffset + chunkSize <= blob.size());
+            TConstArrayRef<char> chunkBlob{blob.data() + chunkOffset, chunkSize};
+            if (version == VersionWithChunkHeaders) {
+                CB_ENSURE(chunkSize >= sizeof(ui32));
+                const ui32 codecNameSize = LittleToHost(ReadUnaligned<ui32>(chunkBlob.data()));
+                const ui64 dataOffset = RoundUpTo<ui64>(chunkOffset + sizeof(ui32) + codecNameSize, 16);
+                CB_ENSURE(dataOffset <= chunkOffset + chunkSize, "Chunk header is bigger than chunk");
+                const TStringBuf codecName(chunkBlob.data() + sizeof(ui32), codecNameSize);
+                chunkBlob = TConstArrayRef<char>(blob.data() + dataOffset, chunkOffset + chunkSize - dataOffset);
+                if (codecName) {
+                    compressedChunks.push_back(
+                        TCompressedChunk{
+                            isFakeColumn,
+                            isFakeColumn ? stringColumnChunks.size() - 1 : localFeatureIndex,
+                            chunks.size(),
+                            NBlockCodecs::Codec(codecName),
+                            TStringBuf(chunkBlob.data(), chunkBlob.size())
+                        }
+                    );
+                    chunks.emplace_back(docOffset, docsInChunkCount, nullptr);
+                    continue;
+                }
+            }
+
             // TODO(yazevnul): validate flatbuffer, including document count
             const auto* const chunk = flatbuffers::GetRoot<NCB::NIdl::TQuantizedFeatureChunk>(chunkBlob.data());
 
@@ -592,6 +721,31 @@ NCB::TQuantizedPool TFileQuantizedPoolLoader::LoadQuantizedPool(NCB::TLoadQuanti
         }
     }
 
+    if (!compressedChunks.empty()) {
+        pool.ChunkStorage.resize(compressedChunks.size());
+        auto decompressChunk = [&] (int i) {
+            const auto& compressedChunk = compressedChunks[i];
+            auto& chunkStorage = pool.ChunkStorage[i];
+            chunkStorage.yresize(compressedChunk.Codec->DecompressedLength(compressedChunk.Data));
+            chunkStorage.resize(compressedChunk.Codec->Decompress(compressedChunk.Data, chunkStorage.data()));
+        };
+        if (params.LocalExecutor) {
+            NPar::ParallelFor(*params.LocalExecutor, 0, SafeIntegerCast<ui32>(compressedChunks.size()), decompressChunk);
+        } else {
+            for (auto i : xrange(compressedChunks.size())) {
+                decompressChunk(i);
+            }
+        }
+        for (auto i : xrange(compressedChunks.size())) {
+            const auto& compressedChunk = compressedChunks[i];
+            auto& columnChunks = compressedChunk.IsStringColumn
+                ? stringColumnChunks[compressedChunk.ColumnChunksIdx]
+                : pool.Chunks[compressedChunk.ColumnChunksIdx];
+            columnChunks[compressedChunk.ChunkIdx].Chunk
+                = flatbuffers::GetRoot<NCB::NIdl::TQuantizedFeatureChunk>(pool.ChunkStorage[i].data());
+        }
+    }
+
     AddPoolMetainfo(poolMetainfo, &pool);
 
     // `pool.ColumnTypes` expected to have the same size as number of columns in pool,
@@ -624,6 +778,104 @@ TVector<ui8> TFileQuantizedPoolLoader::LoadQuantizedColumn(ui32 /*columnIdx*/) {
 
 NCB::TQuantizedPoolLoaderFactory::TRegistrator<TFileQuantizedPoolLoader> FileQuantizedPoolLoaderReg("quantized");
 
+
+namespace {
+    struct TQuantizedPoolShard {
+        size_t ObjectOffset = 0;
+        size_t ObjectCount = 0;
+        TString Path;
+    };
+
+    /* Sharded quantized pool is a manifest file with lines
+     *  <object offset>\t<object count>\t<shard path relative to manifest directory>
+     * and shard files in "quantized" format. Only shards intersecting with loaded range are mapped.
+     */
+    class TShardedQuantizedPoolLoader : public NCB::IQuantizedPoolLoader {
+    public:
+        explicit TShardedQuantizedPoolLoader(const NCB::TPathWithScheme& pathWithScheme)
+            : PathWithScheme(pathWithScheme)
+        {}
+        NCB::TQuantizedPool LoadQuantizedPool(NCB::TLoadQuantizedPoolParameters params) override;
+        TVector<ui8> LoadQuantizedColumn(ui32 columnIdx) override;
+    private:
+        NCB::TPathWithScheme PathWithScheme;
+    };
+}
+
+static TVector<TQuantizedPoolShard> ReadQuantizedPoolShards(const TString& manifestPath) {
+    const TFsPath manifestDir = TFsPath(manifestPath).Parent();
+
+    TVector<TQuantizedPoolShard> shards;
+    TFileInput input(manifestPath);
+    TString line;
+    while (input.ReadLine(line)) {
+        if (line.empty()) {
+            continue;
+        }
+        TVector<TStringBuf> tokens = StringSplitter(line).Split('\t');
+        CB_ENSURE(
+            tokens.size() == 3,
+            "Wrong quantized pool shards manifest line \"" << line << "\", expected 3 columns"
+        );
+        TQuantizedPoolShard shard;
+        shard.ObjectOffset = FromString<size_t>(tokens[0]);
+        shard.ObjectCount = FromString<size_t>(tokens[1]);
+        shard.Path = (manifestDir / TString(tokens[2])).GetPath();
+        CB_ENSURE(
+            shards.empty() || (shards.back().ObjectOffset + shards.back().ObjectCount == shard.ObjectOffset),
+            "Quantized pool shards must follow each other without gaps"
+        );
+        shards.push_back(std::move(shard));
+    }
+    CB_ENSURE(!shards.empty(), "Quantized pool shards manifest " << manifestPath << " is empty");
+    CB_ENSURE(shards.front().ObjectOffset == 0, "First quantized pool shard must start from object 0");
+    return shards;
+}
+
+NCB::TQuantizedPool TShardedQuantizedPoolLoader::LoadQuantizedPool(NCB::TLoadQuantizedPoolParameters params) {
+    const auto& range = params.DatasetSubset.Range;
+
+    NCB::TQuantizedPool pool;
+    bool isFirstShard = true;
+    for (const auto& shard : ReadQuantizedPoolShards(PathWithScheme.Path)) {
+        if ((shard.ObjectOffset + shard.ObjectCount <= range.Begin) || (shard.ObjectOffset >= range.End)) {
+            continue;
+        }
+        auto shardPool = NCB::LoadQuantizedPool(
+            NCB::TPathWithScheme(shard.Path, "quantized"),
+            {params.LockMemory, params.Precharge, NCB::TDatasetSubset(), params.LocalExecutor, params.IgnoredFeatures}
+        );
+        CB_ENSURE(
+            shardPool.DocumentCount == shard.ObjectCount,
+            "Quantized pool shard " << shard.Path << " contains " << shardPool.DocumentCount
+            << " objects, but manifest specifies " << shard.ObjectCount
+        );
+        if (isFirstShard) {
+            // chunks of the result have offsets in the whole pool
+            for (auto& chunks : shardPool.Chunks) {
+                for (auto& chunk : chunks) {
+                    chunk.DocumentOffset += shard.ObjectOffset;
+                }
+            }
+            shardPool.DocumentCount += shard.ObjectOffset;
+            pool = std::move(shardPool);
+            isFirstShard = false;
+        } else {
+            NCB::AppendQuantizedPool(std::move(shardPool), &pool);
+        }
+    }
+    CB_ENSURE(!isFirstShard, "No quantized pool shards intersect with the loaded objects range");
+
+    return pool;
+}
+
+TVector<ui8> TShardedQuantizedPoolLoader::LoadQuantizedColumn(ui32 /*columnIdx*/) {
+    CB_ENSURE_INTERNAL(false, "Schema quantized-sharded does not support columnwise loading");
+}
+
+
+NCB::TQuantizedPoolLoaderFactory::TRegistrator<TShardedQuantizedPoolLoader> ShardedQuantizedPoolLoaderReg("quantized-sharded");
+
 NCB::TQuantizedPool NCB::LoadQuantizedPool(
     const NCB::TPathWithScheme& pathWithScheme,
     const TLoadQuantizedPoolParameters& params
@@ -817,7 +1069,7 @@ namespace NCB {
 
             chunks.emplace_back(
                 documentOffset,
-                documentOffset + dataPart.size(),
+                dataPart.size(),
                 flatbuffers::GetRoot<NIdl::TQuantizedFeatureChunk>(
                     quantizedPool->Blobs.back().AsCharPtr()
                 )
@@ -836,10 +1088,7 @@ namespace NCB {
     }
 
 
-    void SaveQuantizedPool(
-        const TSrcData& srcData,
-        TString fileName
-    ) {
+    static TQuantizedPool MakeQuantizedPool(const TSrcData& srcData) {
         TQuantizedPool pool;
         pool.DocumentCount = srcData.DocumentCount;
         for (auto localIndex : xrange(srcData.LocalIndexToColumnIndex.size())) {
@@ -869,9 +1118,126 @@ namespace NCB {
         AddToPool(srcData.Weights, &pool);
         AddToPool(srcData.GroupWeights, &pool);
 
+        return pool;
+    }
+
+
+    void SaveQuantizedPool(
+        const TSrcData& srcData,
+        TString fileName,
+        TStringBuf chunksCompressionCodec
+    ) {
+        const TQuantizedPool pool = MakeQuantizedPool(srcData);
 
         TFileOutput output(fileName);
-        SaveQuantizedPool(pool, &output);
+        SaveQuantizedPool(pool, &output, chunksCompressionCodec);
+    }
+
+
+    // columns are matched by type and index among the columns of the same type
+    static THashMap<std::pair<EColumn, size_t>, size_t> GetColumnKeyToLocalIndex(const TQuantizedPool& pool) {
+        THashMap<EColumn, size_t> columnCountByType;
+        THashMap<std::pair<EColumn, size_t>, size_t> result;
+        for (const auto columnIndex : CollectAndSortKeys(pool.ColumnIndexToLocalIndex)) {
+            const auto localIndex = pool.ColumnIndexToLocalIndex.at(columnIndex);
+            const auto columnType = pool.ColumnTypes[localIndex];
+            result.emplace(std::make_pair(columnType, columnCountByType[columnType]++), localIndex);
+        }
+        return result;
+    }
+
+    static bool HasData(const TVector<TQuantizedPool::TChunkDescription>& chunks) {
+        return AnyOf(
+            chunks,
+            [] (const TQuantizedPool::TChunkDescription& chunk) { return chunk.DocumentCount != 0; }
+        );
+    }
+
+    static void CheckQuantizationSchemasAreCompatible(
+        const TPoolQuantizationSchema& poolSchema,
+        const TPoolQuantizationSchema& tailSchema
+    ) {
+        CB_ENSURE(
+            poolSchema.ClassLabels == tailSchema.ClassLabels,
+            "Appended data has class labels that are different from the quantized pool ones"
+        );
+
+        THashMap<size_t, size_t> poolFeatureIndexToSchemaIndex;
+        for (auto i : xrange(poolSchema.FeatureIndices.size())) {
+            poolFeatureIndexToSchemaIndex.emplace(poolSchema.FeatureIndices[i], i);
+        }
+        for (auto i : xrange(tailSchema.FeatureIndices.size())) {
+            if (tailSchema.Borders[i].empty()) {
+                continue;
+            }
+            const auto featureIndex = tailSchema.FeatureIndices[i];
+            const auto* poolSchemaIndex = poolFeatureIndexToSchemaIndex.FindPtr(featureIndex);
+            CB_ENSURE(
+                poolSchemaIndex
+                && (poolSchema.Borders[*poolSchemaIndex] == tailSchema.Borders[i])
+                && (poolSchema.NanModes[*poolSchemaIndex] == tailSchema.NanModes[i]),
+                "Feature #" << featureIndex << " of appended data is quantized differently from the"
+                " quantized pool. Quantize appended data using quantized pool borders"
+            );
+        }
+    }
+
+    void AppendQuantizedPool(TQuantizedPool&& tail, TQuantizedPool* pool) {
+        CB_ENSURE(
+            !pool->HasStringColumns && !tail.HasStringColumns,
+            "Appending quantized pools with string columns is not supported"
+        );
+        CheckQuantizationSchemasAreCompatible(
+            QuantizationSchemaFromProto(pool->QuantizationSchema),
+            QuantizationSchemaFromProto(tail.QuantizationSchema)
+        );
+
+        const auto poolColumnKeyToLocalIndex = GetColumnKeyToLocalIndex(*pool);
+        const auto tailColumnKeyToLocalIndex = GetColumnKeyToLocalIndex(tail);
+
+        for (const auto& [columnKey, localIndex] : tailColumnKeyToLocalIndex) {
+            CB_ENSURE(
+                poolColumnKeyToLocalIndex.contains(columnKey) || !HasData(tail.Chunks[localIndex]),
+                "Appended data has column of type " << columnKey.first << " #" << columnKey.second
+                << " that is absent in the quantized pool"
+            );
+        }
+
+        const size_t documentOffset = pool->DocumentCount;
+        for (const auto& [columnKey, localIndex] : poolColumnKeyToLocalIndex) {
+            auto& poolChunks = pool->Chunks[localIndex];
+            const auto* tailLocalIndex = tailColumnKeyToLocalIndex.FindPtr(columnKey);
+            const bool tailHasData = tailLocalIndex && HasData(tail.Chunks[*tailLocalIndex]);
+            if (HasData(poolChunks) != tailHasData) {
+                CB_ENSURE(
+                    (pool->DocumentCount == 0) || (tail.DocumentCount == 0),
+                    "Column of type " << columnKey.first << " #" << columnKey.second
+                    << " is present only in one of the appended quantized pools"
+                );
+            }
+            if (!tailHasData) {
+                continue;
+            }
+            for (const auto& chunk : tail.Chunks[*tailLocalIndex]) {
+                if (chunk.DocumentCount) {
+                    poolChunks.emplace_back(
+                        documentOffset + chunk.DocumentOffset,
+                        chunk.DocumentCount,
+                        chunk.Chunk
+                    );
+                }
+            }
+        }
+        pool->DocumentCount += tail.DocumentCount;
+
+        // chunks point to the data owned by these containers, moving them does not invalidate pointers
+        for (auto& blob : tail.Blobs) {
+            pool->Blobs.push_back(std::move(blob));
+        }
+        for (auto& chunkStorage : tail.ChunkStorage) {
+            pool->ChunkStorage.push_back(std::move(chunkStorage));
+        }
+        tail = TQuantizedPool();
     }
 
 
@@ -1098,4 +1464,130 @@ namespace NCB {
 
         SaveQuantizedPool(srcData, fileName);
     }
+
+    template <class T>
+    static TSrcColumn<T> GetSrcColumnSlice(const TSrcColumn<T>& srcColumn, size_t begin, size_t end) {
+        TVector<T> values;
+        values.reserve(end - begin);
+        size_t partBegin = 0;
+        for (const auto& part : srcColumn.Data) {
+            const size_t partEnd = partBegin + part.size();
+            const size_t sliceBegin = Max(begin, partBegin);
+            const size_t sliceEnd = Min(end, partEnd);
+            if (sliceBegin < sliceEnd) {
+                values.insert(
+                    values.end(),
+                    part.begin() + (sliceBegin - partBegin),
+                    part.begin() + (sliceEnd - partBegin)
+                );
+            }
+            partBegin = partEnd;
+        }
+        return GenerateSrcColumn<T>(TConstArrayRef<T>(values), srcColumn.Type);
+    }
+
+    template <class T>
+    static TMaybe<TSrcColumn<T>> GetSrcColumnSlice(const TMaybe<TSrcColumn<T>>& srcColumn, size_t begin, size_t end) {
+        if (!srcColumn) {
+            return Nothing();
+        }
+        return GetSrcColumnSlice(*srcColumn, begin, end);
+    }
+
+    // objects [begin, end)
+    static TSrcData GetSrcDataSlice(const TSrcData& srcData, size_t begin, size_t end) {
+        TSrcData result;
+        result.DocumentCount = end - begin;
+        result.LocalIndexToColumnIndex = srcData.LocalIndexToColumnIndex;
+        result.PoolQuantizationSchema = srcData.PoolQuantizationSchema;
+        result.ColumnNames = srcData.ColumnNames;
+        result.GroupIds = GetSrcColumnSlice(srcData.GroupIds, begin, end);
+        result.SubgroupIds = GetSrcColumnSlice(srcData.SubgroupIds, begin, end);
+        for (const auto& floatFeature : srcData.FloatFeatures) {
+            result.FloatFeatures.push_back(GetSrcColumnSlice(floatFeature, begin, end));
+        }
+        result.Target = GetSrcColumnSlice(srcData.Target, begin, end);
+        for (const auto& oneBaseline : srcData.Baseline) {
+            result.Baseline.push_back(GetSrcColumnSlice(oneBaseline, begin, end));
+        }
+        result.Weights = GetSrcColumnSlice(srcData.Weights, begin, end);
+        result.GroupWeights = GetSrcColumnSlice(srcData.GroupWeights, begin, end);
+        result.IgnoredColumnIndices = srcData.IgnoredColumnIndices;
+        result.ObjectsOrder = srcData.ObjectsOrder;
+        return result;
+    }
+
+    /* The same split as used for distributed training workers,
+     * so each worker maps only its own shard if shardCount is equal to the number of workers
+     */
+    static TVector<size_t> GetShardObjectOffsets(const TObjectsGrouping& objectsGrouping, ui32 shardCount) {
+        const ui32 groupCount = objectsGrouping.GetGroupCount();
+        CB_ENSURE(groupCount >= shardCount, "Pool must contain at least " << shardCount << " groups");
+
+        TVector<size_t> result; // [shardIdx], with objectCount at the end
+        const ui32 groupsPerShard = CeilDiv(groupCount, shardCount);
+        for (ui32 shardIdx : xrange(shardCount)) {
+            const ui32 shardStartGroup = Min(groupsPerShard * shardIdx, groupCount);
+            result.push_back(
+                shardStartGroup == groupCount
+                    ? objectsGrouping.GetObjectCount()
+                    : objectsGrouping.GetGroup(shardStartGroup).Begin
+            );
+        }
+        result.push_back(objectsGrouping.GetObjectCount());
+        return result;
+    }
+
+    void SaveQuantizedPoolShards(const TDataProviderPtr& dataProvider, ui32 shardCount, TString manifestPath) {
+        CB_ENSURE(shardCount > 0, "Shard count must be positive");
+
+        const auto threadCount = NSystemInfo::CachedNumberOfCpus();
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(threadCount);
+
+        TSrcData srcData;
+        BuildSrcDataFromDataProvider(dataProvider, &localExecutor, &srcData);
+
+        const auto shardObjectOffsets = GetShardObjectOffsets(*dataProvider->ObjectsGrouping, shardCount);
+        const TString manifestName = TFsPath(manifestPath).GetName();
+
+        TFileOutput manifest(manifestPath);
+        for (ui32 shardIdx : xrange(shardCount)) {
+            const size_t shardBegin = shardObjectOffsets[shardIdx];
+            const size_t shardEnd = shardObjectOffsets[shardIdx + 1];
+            const TString shardName = manifestName + "." + ToString(shardIdx);
+
+            SaveQuantizedPool(
+                GetSrcDataSlice(srcData, shardBegin, shardEnd),
+                (TFsPath(manifestPath).Parent() / shardName).GetPath()
+            );
+            manifest << shardBegin << '\t' << (shardEnd - shardBegin) << '\t' << shardName << '\n';
+        }
+        manifest.Finish();
+    }
+
+    void AppendQuantizedPool(const TDataProviderPtr& dataProvider, TString fileName) {
+        const auto threadCount = NSystemInfo::CachedNumberOfCpus();
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(threadCount);
+
+        TSrcData srcData;
+        BuildSrcDataFromDataProvider(dataProvider, &localExecutor, &srcData);
+
+        TLoadQuantizedPoolParameters loadParameters;
+        loadParameters.LockMemory = false;
+        loadParameters.Precharge = false;
+        TQuantizedPool pool = LoadQuantizedPool(TPathWithScheme(fileName, "quantized"), loadParameters);
+
+        AppendQuantizedPool(MakeQuantizedPool(srcData), &pool);
+
+        // existing chunks are mapped from fileName so write to a temporary file first
+        const TString tmpFileName = fileName + ".tmp";
+        {
+            TFileOutput output(tmpFileName);
+            SaveQuantizedPool(pool, &output);
+        }
+        pool = TQuantizedPool();
+        NFs::Rename(tmpFileName, fileName);
+    }
 }
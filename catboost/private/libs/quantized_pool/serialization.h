@@ -61,12 +61,30 @@ namespace NCB {
 }
 
 namespace NCB {
+    /* chunksCompressionCodec is a name of NBlockCodecs codec (e.g. "lz4" or "zstd_1") to compress chunks with,
+     * chunks are saved raw if it is empty (default) or if compression does not decrease chunk size.
+     * Raw chunks can be used directly from the mapped file, compressed chunks are decompressed on load.
+     */
     //only for used C++
-    void SaveQuantizedPool(const TQuantizedPool& pool, IOutputStream* output);
-    void SaveQuantizedPool(const TSrcData& srcData, TString fileName);
+    void SaveQuantizedPool(const TQuantizedPool& pool, IOutputStream* output, TStringBuf chunksCompressionCodec = {});
+    void SaveQuantizedPool(const TSrcData& srcData, TString fileName, TStringBuf chunksCompressionCodec = {});
     //only for python
     void SaveQuantizedPool(const TDataProviderPtr& dataProvider, TString fileName);
 
+    /* Append documents from `tail` to `pool` without requantization, `tail` must be quantized with
+     * the same borders (e.g. with `TQuantizedFeaturesInfo` of the data loaded from `pool`).
+     * Existing chunks are reused, so result can be saved with `SaveQuantizedPool`.
+     */
+    void AppendQuantizedPool(TQuantizedPool&& tail, TQuantizedPool* pool);
+    // Append quantized dataProvider data to quantized pool file
+    void AppendQuantizedPool(const TDataProviderPtr& dataProvider, TString fileName);
+
+    /* Save quantized data to shardCount quantized pool files "<manifestPath>.<shardIdx>" split by groups
+     * and manifest loadable with "quantized-sharded" scheme. When loading a range of objects only intersecting
+     * shards are mapped, so distributed training workers do not touch other workers' data.
+     */
+    void SaveQuantizedPoolShards(const TDataProviderPtr& dataProvider, ui32 shardCount, TString manifestPath);
+
     template<class T>
     TSrcColumn<T> GenerateSrcColumn(TConstArrayRef<T> data, EColumn columnType);
 
@@ -74,6 +92,8 @@ namespace NCB {
         bool LockMemory = true;
         bool Precharge = true;
         TDatasetSubset DatasetSubset;
+        NPar::TLocalExecutor* LocalExecutor = nullptr; // used for parallel chunks decompression if not null
+        TVector<ui32> IgnoredFeatures; // flat indices, chunks of these features are not loaded
     };
 
     // Load quantized pool saved by `SaveQuantizedPool` from file.
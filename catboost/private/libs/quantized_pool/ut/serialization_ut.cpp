@@ -4,11 +4,14 @@
 
 #include <library/cpp/testing/unittest/registar.h>
 
+#include <library/cpp/threading/local_executor/local_executor.h>
+
 #include <contrib/libs/flatbuffers/include/flatbuffers/flatbuffers.h>
 #include <contrib/libs/protobuf/util/message_differencer.h>
 
 #include <catboost/idl/pool/flat/quantized_chunk_t.fbs.h>
 #include <catboost/idl/pool/proto/quantization_schema.pb.h>
+#include <catboost/libs/helpers/exception.h>
 
 #include <util/folder/dirut.h>
 #include <util/folder/path.h>
@@ -94,6 +97,34 @@ static NCB::TQuantizedPool MakeQuantizedPool() {
     return pool;
 }
 
+static NCB::TQuantizedPool MakeCompressibleQuantizedPool() {
+    NCB::TQuantizedPool pool;
+    {
+        const TVector<ui8> bins(4096, 1);
+        flatbuffers::FlatBufferBuilder builder;
+        builder.Finish(NCB::NIdl::CreateTQuantizedFeatureChunk(
+            builder,
+            NCB::NIdl::EBitsPerDocumentFeature_BPDF_8,
+            builder.CreateVector(bins.data(), bins.size())));
+        pool.Blobs.push_back(TBlob::Copy(
+            builder.GetBufferPointer(),
+            builder.GetSize()));
+    }
+    pool.ColumnIndexToLocalIndex.emplace(0, 0);
+    pool.ColumnTypes = {EColumn::Num};
+    pool.QuantizationSchema = MakeQuantizationSchema();
+    pool.DocumentCount = 4096;
+    {
+        TVector<NCB::TQuantizedPool::TChunkDescription> chunks;
+        chunks.emplace_back(
+            0,
+            4096,
+            flatbuffers::GetRoot<NCB::NIdl::TQuantizedFeatureChunk>(pool.Blobs[0].AsCharPtr()));
+        pool.Chunks.push_back(std::move(chunks));
+    }
+    return pool;
+}
+
 static TString QuantizedPoolToString(const NCB::TQuantizedPool& pool) {
     TString str;
     TStringOutput output{str};
@@ -155,6 +186,37 @@ Y_UNIT_TEST_SUITE(SerializationTests) {
         UNIT_ASSERT_VALUES_EQUAL(loadedPoolAsText, poolAsText);
     }
 
+    Y_UNIT_TEST(TestSerializeDeserializeWithCompression) {
+        for (const auto& pool : {MakeQuantizedPool(), MakeCompressibleQuantizedPool()}) {
+            const auto path = TFsPath(GetSystemTempDir()) / "quantized_pool.bin";
+            const auto compressedPath = TFsPath(GetSystemTempDir()) / "quantized_pool_compressed.bin";
+
+            {
+                TFileOutput output(path.GetPath());
+                NCB::SaveQuantizedPool(pool, &output);
+            }
+            {
+                TFileOutput output(compressedPath.GetPath());
+                NCB::SaveQuantizedPool(pool, &output, "lz4");
+            }
+
+            NPar::TLocalExecutor localExecutor;
+            localExecutor.RunAdditionalThreads(1);
+            const auto loadedPool = NCB::LoadQuantizedPool(
+                NCB::TPathWithScheme(compressedPath.GetPath(), "quantized"),
+                {false, false, NCB::TDatasetSubset::MakeColumns(), &localExecutor});
+
+            UNIT_ASSERT_VALUES_EQUAL(QuantizedPoolToString(loadedPool), QuantizedPoolToString(pool));
+            if (pool.DocumentCount == 4096) {
+                UNIT_ASSERT_VALUES_EQUAL(loadedPool.ChunkStorage.size(), 1);
+                UNIT_ASSERT(TFileStat(compressedPath).Size < TFileStat(path).Size);
+            } else {
+                // chunks too small to be compressed are stored raw
+                UNIT_ASSERT(loadedPool.ChunkStorage.empty());
+            }
+        }
+    }
+
     Y_UNIT_TEST(TestLoadQuantizationSchema) {
         const auto pool = MakeQuantizedPool();
         const auto path = TFsPath(GetSystemTempDir()) / "quantized_pool.bin";
@@ -170,6 +232,70 @@ Y_UNIT_TEST_SUITE(SerializationTests) {
         TString diff;
         UNIT_ASSERT_C(IsEqual(expectedQuantizationSchema, quantizationSchema, &diff), diff.data());
     }
+
+    Y_UNIT_TEST(TestAppend) {
+        auto pool = MakeQuantizedPool();
+        NCB::AppendQuantizedPool(MakeQuantizedPool(), &pool);
+
+        UNIT_ASSERT_VALUES_EQUAL(pool.DocumentCount, 4);
+        UNIT_ASSERT_VALUES_EQUAL(pool.Blobs.size(), 4);
+        for (const auto& chunks : pool.Chunks) {
+            UNIT_ASSERT_VALUES_EQUAL(chunks.size(), 2);
+            UNIT_ASSERT_VALUES_EQUAL(chunks[0].DocumentOffset, 0);
+            UNIT_ASSERT_VALUES_EQUAL(chunks[1].DocumentOffset, 2);
+            UNIT_ASSERT_VALUES_EQUAL(chunks[1].DocumentCount, 3);
+        }
+
+        const auto path = TFsPath(GetSystemTempDir()) / "quantized_pool.bin";
+        {
+            TFileOutput output(path.GetPath());
+            NCB::SaveQuantizedPool(pool, &output);
+        }
+
+        const auto loadedPool = NCB::LoadQuantizedPool(NCB::TPathWithScheme(path.GetPath(), "quantized"), {false, false, NCB::TDatasetSubset::MakeColumns()});
+
+        UNIT_ASSERT_VALUES_EQUAL(QuantizedPoolToString(loadedPool), QuantizedPoolToString(pool));
+    }
+
+    Y_UNIT_TEST(TestAppendWithDifferentBorders) {
+        auto pool = MakeQuantizedPool();
+        auto tail = MakeQuantizedPool();
+        tail.QuantizationSchema.MutableFeatureIndexToSchema()->at(0).AddBorders(0.9);
+
+        UNIT_ASSERT_EXCEPTION(NCB::AppendQuantizedPool(std::move(tail), &pool), TCatBoostException);
+    }
+
+    Y_UNIT_TEST(TestLoadShards) {
+        const auto pool = MakeQuantizedPool();
+        const auto dir = TFsPath(GetSystemTempDir());
+        for (auto shardName : {"quantized_pool_shards.0", "quantized_pool_shards.1"}) {
+            TFileOutput output((dir / shardName).GetPath());
+            NCB::SaveQuantizedPool(pool, &output);
+        }
+        const auto manifestPath = dir / "quantized_pool_shards";
+        {
+            TFileOutput output(manifestPath.GetPath());
+            output << "0\t2\tquantized_pool_shards.0\n";
+            output << "2\t2\tquantized_pool_shards.1\n";
+        }
+        const NCB::TPathWithScheme pathWithScheme(manifestPath.GetPath(), "quantized-sharded");
+
+        const auto wholePool = NCB::LoadQuantizedPool(pathWithScheme, {false, false, NCB::TDatasetSubset()});
+        UNIT_ASSERT_VALUES_EQUAL(wholePool.DocumentCount, 4);
+        UNIT_ASSERT_VALUES_EQUAL(wholePool.Blobs.size(), 2);
+        for (const auto& chunks : wholePool.Chunks) {
+            UNIT_ASSERT_VALUES_EQUAL(chunks.size(), 2);
+            UNIT_ASSERT_VALUES_EQUAL(chunks[1].DocumentOffset, 2);
+        }
+
+        const auto secondShardPool = NCB::LoadQuantizedPool(pathWithScheme, {false, false, NCB::TDatasetSubset::MakeRange(2, 4)});
+        UNIT_ASSERT_VALUES_EQUAL(secondShardPool.DocumentCount, 4);
+        UNIT_ASSERT_VALUES_EQUAL(secondShardPool.Blobs.size(), 1);
+        for (const auto& chunks : secondShardPool.Chunks) {
+            UNIT_ASSERT_VALUES_EQUAL(chunks.size(), 1);
+            UNIT_ASSERT_VALUES_EQUAL(chunks[0].DocumentOffset, 2);
+        }
+    }
 }
 
 Y_UNIT_TEST_SUITE(DigestTests) {
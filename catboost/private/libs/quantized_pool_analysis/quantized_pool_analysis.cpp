@@ -4,7 +4,10 @@
 #include <catboost/libs/helpers/mem_usage.h>
 #include <catboost/private/libs/quantization/utils.h>
 
+#include <util/generic/cast.h>
 #include <util/generic/fwd.h>
+#include <util/generic/hash.h>
+#include <util/generic/mapfindptr.h>
 #include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
 #include <util/system/types.h>
@@ -155,15 +158,113 @@ namespace NCB {
             return builderData.ObjectsData.Data;
         }
 
+        // target data is the same for all features, so it is prepared once
+        struct TTargetForStatistics {
+            TVector<float> Target;
+            TVector<float> Weights; // empty if weights are trivial
+        };
+
+        struct TBinSums {
+            TVector<double> Target;
+            TVector<double> WeightedTarget; // empty if weights are trivial
+            TVector<double> Weight; // empty if weights are trivial
+            TVector<double> Prediction;
+            TVector<size_t> ObjectCount;
+
+        public:
+            TBinSums(size_t binCount, bool useWeights)
+                : Target(binCount, 0.0)
+                , WeightedTarget(useWeights ? binCount : 0, 0.0)
+                , Weight(useWeights ? binCount : 0, 0.0)
+                , Prediction(binCount, 0.0)
+                , ObjectCount(binCount, 0)
+            {}
+
+            void Add(const TBinSums& other) {
+                for (auto binNum : xrange(Target.size())) {
+                    Target[binNum] += other.Target[binNum];
+                    Prediction[binNum] += other.Prediction[binNum];
+                    ObjectCount[binNum] += other.ObjectCount[binNum];
+                }
+                for (auto binNum : xrange(Weight.size())) {
+                    WeightedTarget[binNum] += other.WeightedTarget[binNum];
+                    Weight[binNum] += other.Weight[binNum];
+                }
+            }
+        };
+
     }  // anonymous namespace
 
+    static TTargetForStatistics GetTargetForStatistics(
+        const TFullModel& model,
+        const TDataProvider& dataset,
+        NPar::TLocalExecutor* executor) {
+
+        TRestorableFastRng64 rand(0);
+        TProcessedDataProvider processedDataProvider = CreateModelCompatibleProcessedDataProvider(
+            dataset, {}, model, GetMonopolisticFreeCpuRam(), &rand, executor);
+
+        TTargetForStatistics result;
+        result.Target.assign(
+            processedDataProvider.TargetData->GetOneDimensionalTarget()->begin(),
+            processedDataProvider.TargetData->GetOneDimensionalTarget()->end());
+        auto maybeWeights = processedDataProvider.TargetData->GetWeights();
+        if (maybeWeights && !maybeWeights->IsTrivial()) {
+            const auto weights = maybeWeights->GetNonTrivialData();
+            result.Weights.assign(weights.begin(), weights.end());
+        }
+        return result;
+    }
+
+    // objects are processed in parallel blocks, sums of the blocks are merged at the end
+    static TBinSums CalcBinSums(
+        TConstArrayRef<int> binNums,
+        size_t binCount,
+        const TTargetForStatistics& target,
+        TConstArrayRef<double> prediction,
+        NPar::TLocalExecutor* executor) {
+
+        const bool useWeights = !target.Weights.empty();
+        if (binNums.empty()) {
+            return TBinSums(binCount, useWeights);
+        }
+
+        NPar::TLocalExecutor::TExecRangeParams blockParams(0, SafeIntegerCast<int>(binNums.size()));
+        blockParams.SetBlockCountToThreadCount();
+        TVector<TBinSums> blockSums(blockParams.GetBlockCount(), TBinSums(binCount, useWeights));
+        executor->ExecRangeWithThrow(
+            [&] (int blockId) {
+                auto& sums = blockSums[blockId];
+                const int blockEnd = Min(blockParams.FirstId + (blockId + 1) * blockParams.GetBlockSize(), blockParams.LastId);
+                for (int numObj = blockParams.FirstId + blockId * blockParams.GetBlockSize(); numObj < blockEnd; ++numObj) {
+                    const int binNum = binNums[numObj];
+
+                    sums.Target[binNum] += target.Target[numObj];
+                    sums.Prediction[binNum] += prediction[numObj];
+                    sums.ObjectCount[binNum] += 1;
+                    if (useWeights) {
+                        const double weight = target.Weights[numObj];
+                        sums.WeightedTarget[binNum] += target.Target[numObj] * weight;
+                        sums.Weight[binNum] += weight;
+                    }
+                }
+            },
+            0,
+            blockParams.GetBlockCount(),
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+
+        for (auto blockId : xrange<size_t>(1, blockSums.size())) {
+            blockSums[0].Add(blockSums[blockId]);
+        }
+        return std::move(blockSums[0]);
+    }
+
     template <class TTObjectsDataProvider, EFeatureType FeatureType, class TFeatureHolderGenerator>
     static void GetPredictionsOnVaryingFeature(
         const TFullModel& model,
         const size_t featureNum,
         TFeatureHolderGenerator featureHolderGenerator,
         const EPredictionType predictionType,
-        const int threadCount,
         TDataProvider& dataProvider,
         TVector<double>* predictions,
         NPar::TLocalExecutor* executor) {
@@ -199,7 +300,7 @@ namespace NCB {
                 executor
             );
 
-            auto pred = ApplyModelMulti(model, *(dataProviderPtr->ObjectsData), false, predictionType, 0, 0, threadCount)[0];
+            auto pred = ApplyModelMulti(model, *(dataProviderPtr->ObjectsData), predictionType, 0, 0, executor)[0];
             (*predictions)[numVal] = std::accumulate(pred.begin(), pred.end(), 0.) / static_cast<double>(pred.size());
             data = TBuilderDataHelper<TTObjectsDataProvider>::Extract(std::move(*dataProviderPtr));
             ++numVal;
@@ -221,16 +322,15 @@ namespace NCB {
         dataProvider = std::move(*(dataProviderPtr->template CastMoveTo<TObjectsDataProvider>()));
     }
 
-    TBinarizedFeatureStatistics GetBinarizedFloatFeatureStatistics(
+    static TBinarizedFeatureStatistics GetBinarizedFloatFeatureStatistics(
         const TFullModel& model,
         TDataProvider& dataset,
         const size_t featureNum,
         const TVector<double>& prediction,
+        const TTargetForStatistics& target,
         const EPredictionType predictionType,
-        const int threadCount) {
+        NPar::TLocalExecutor* executor) {
 
-        NPar::TLocalExecutor executor;
-        executor.RunAdditionalThreads(threadCount - 1);
         TRestorableFastRng64 rand(0);
 
         const TVector<float>& modelBorders = model.ModelTrees->GetFloatFeatures()[featureNum].Borders;
@@ -240,12 +340,6 @@ namespace NCB {
         }
         size_t numModelBins = modelBordersSize + 1;
 
-        TProcessedDataProvider processedDataProvider = CreateModelCompatibleProcessedDataProvider(
-            dataset, {}, model, GetMonopolisticFreeCpuRam(), &rand, &executor);
-        TVector<float> target(
-            processedDataProvider.TargetData->GetOneDimensionalTarget()->begin(),
-            processedDataProvider.TargetData->GetOneDimensionalTarget()->end());
-
         TQuantizedObjectsDataProviderPtr quantizedPtr;
         bool isDatasetQuantized = false;
         if (auto* rawObjectsDataProvider =
@@ -284,7 +378,7 @@ namespace NCB {
                 rawObjectsDataProviderPtr,
                 quantizedFeaturesInfo,
                 &rand,
-                &executor);
+                executor);
         } else if (auto* quantizedForCpuObjectsData =
                    dynamic_cast<TQuantizedForCPUObjectsDataProvider*>(dataset.ObjectsData.Get()))
         {
@@ -326,45 +420,23 @@ namespace NCB {
             values->ForEachBlock(std::move(blockFunc));
         }
 
+        const TBinSums binSums = CalcBinSums(binNums, numModelBins, target, prediction, executor);
+        const bool useWeights = !target.Weights.empty();
+
         TVector<float> meanTarget(numModelBins, 0.);
         TVector<float> meanPrediction(numModelBins, 0.);
-        TVector<size_t> countObjectsPerBin(numModelBins, 0);
-
-        TVector<float> meanWeightedTarget;
-        TVector<double> sumWeightsObjectsPerBin;
-        auto maybeWeights = processedDataProvider.TargetData->GetWeights();
-        bool useWeights = maybeWeights && !maybeWeights->IsTrivial();
-        if (useWeights) {
-            meanWeightedTarget.resize(numModelBins, 0);
-            sumWeightsObjectsPerBin.resize(numModelBins, 0);
-        }
-        for (size_t numObj = 0; numObj < binNums.size(); ++numObj) {
-            int binNum = binNums[numObj];
-
-            meanTarget[binNum] += target[numObj];
-            meanPrediction[binNum] += prediction[numObj];
-
-            countObjectsPerBin[binNum] += 1;
-            if (useWeights) {
-                double weight = (*maybeWeights)[numObj];
-                meanWeightedTarget[binNum] += target[numObj] * weight;
-                sumWeightsObjectsPerBin[binNum] += weight;
-            }
-        }
-
-        TVector<size_t> skippedValues;
+        TVector<size_t> countObjectsPerBin = binSums.ObjectCount;
+        TVector<float> meanWeightedTarget(useWeights ? numModelBins : 0, 0.);
         for (size_t binNum = 0; binNum < numModelBins; ++binNum) {
             size_t numObjs = countObjectsPerBin[binNum];
             if (numObjs == 0) {
                 continue;
             }
-            countObjectsPerBin[binNum] = countObjectsPerBin[binNum];
-            meanTarget[binNum] /= static_cast<float>(numObjs);
-            meanPrediction[binNum] /= static_cast<float>(numObjs);
+            meanTarget[binNum] = binSums.Target[binNum] / numObjs;
+            meanPrediction[binNum] = binSums.Prediction[binNum] / numObjs;
 
             if (useWeights) {
-                double sumWeight = sumWeightsObjectsPerBin[binNum];
-                meanWeightedTarget[binNum ] /= sumWeight;
+                meanWeightedTarget[binNum] = binSums.WeightedTarget[binNum] / binSums.Weight[binNum];
             }
         }
 
@@ -382,20 +454,18 @@ namespace NCB {
                     modelBinsToPoolBins,
                     CalcHistogramWidthForBorders(poolBinsRemap.size() - 1)),
                 predictionType,
-                threadCount,
                 dataset,
                 &predictionsOnVarying,
-                &executor);
+                executor);
         } else {
             GetPredictionsOnVaryingFeature<TRawObjectsDataProvider, EFeatureType::Float>(
                 model,
                 featureNum,
                 TFloatFeatureHolderGenerator(featureNum, modelBorders),
                 predictionType,
-                threadCount,
                 dataset,
                 &predictionsOnVarying,
-                &executor);
+                executor);
         }
 
         return TBinarizedFeatureStatistics{
@@ -426,24 +496,15 @@ namespace NCB {
         return -1;
     }
 
-    TBinarizedFeatureStatistics GetBinarizedOneHotFeatureStatistics(
+    static TBinarizedFeatureStatistics GetBinarizedOneHotFeatureStatistics(
         const TFullModel& model,
         TDataProvider& dataset,
         const size_t featureNum,
         const int featureFlatNum,
         const TVector<double>& prediction,
+        const TTargetForStatistics& target,
         const EPredictionType predictionType,
-        const int threadCount) {
-
-        NPar::TLocalExecutor executor;
-        executor.RunAdditionalThreads(threadCount - 1);
-        TRestorableFastRng64 rand(0);
-
-        TProcessedDataProvider processedDataProvider = CreateModelCompatibleProcessedDataProvider(
-            dataset, {}, model, GetMonopolisticFreeCpuRam(), &rand, &executor);
-        TVector<float> target(
-            processedDataProvider.TargetData->GetOneDimensionalTarget()->begin(),
-            processedDataProvider.TargetData->GetOneDimensionalTarget()->end());
+        NPar::TLocalExecutor* executor) {
 
         auto objectsPtr = dynamic_cast<TRawObjectsDataProvider*>(dataset.ObjectsData.Get());
         CB_ENSURE_INTERNAL(objectsPtr, "Zero pointer to raw objects");
@@ -460,42 +521,32 @@ namespace NCB {
         const THashedCatValuesHolder* catFeatureHolder = catFeatureMaybe.GetRef();
         CB_ENSURE_INTERNAL(catFeatureHolder, "Cannot access values of categorical feature #" << featureNum);
 
+        THashMap<ui32, int> valueToBinNum;
+        for (auto binNum : xrange(oneHotUniqueValues.ysize())) {
+            valueToBinNum.emplace(static_cast<ui32>(oneHotUniqueValues[binNum]), binNum);
+        }
+        const int unknownValueBinNum = oneHotUniqueValues.ysize();
+
         TVector<int> binNums;
-        binNums.reserve(oneHotUniqueValues.size());
+        binNums.reserve(catFeatureHolder->GetSize());
         auto blockIterator = catFeatureHolder->GetBlockIterator();
         while (auto block = blockIterator->Next(1024)) {
             for (auto val : block) {
-                auto it = std::find(oneHotUniqueValues.begin(), oneHotUniqueValues.end(), val);
-                binNums.push_back(it - oneHotUniqueValues.begin()); // Unknown values will be at bin #oneHotUniqueValues.size()
+                const int* binNum = MapFindPtr(valueToBinNum, val);
+                binNums.push_back(binNum ? *binNum : unknownValueBinNum);
             }
         };
 
         size_t numBins = oneHotUniqueValues.size() + 1;
-        TVector<float> meanTarget(numBins, 0.);
-        TVector<float> meanPrediction(numBins, 0.);
-        TVector<size_t> countObjectsPerBin(numBins, 0);
-
-        TVector<float> meanWeightedTarget;
-        TVector<double> sumWeightsObjectsPerBin;
-        auto maybeWeights = processedDataProvider.TargetData->GetWeights();
-        bool useWeights = maybeWeights && !maybeWeights->IsTrivial();
-        if (useWeights) {
-            meanWeightedTarget.resize(numBins, 0);
-            sumWeightsObjectsPerBin.resize(numBins, 0);
-        }
-        for (size_t numObj = 0; numObj < binNums.size(); ++numObj) {
-            ui8 binNum = binNums[numObj];
+        const TBinSums binSums = CalcBinSums(binNums, numBins, target, prediction, executor);
+        const bool useWeights = !target.Weights.empty();
 
-            meanTarget[binNum] += target[numObj];
-            meanPrediction[binNum] += prediction[numObj];
-            countObjectsPerBin[binNum] += 1;
+        TVector<float> meanTarget(binSums.Target.begin(), binSums.Target.end());
+        TVector<float> meanPrediction(binSums.Prediction.begin(), binSums.Prediction.end());
+        TVector<size_t> countObjectsPerBin = binSums.ObjectCount;
 
-            if (useWeights) {
-                double weight = (*maybeWeights)[numObj];
-                meanWeightedTarget[binNum] += target[numObj] * weight;
-                sumWeightsObjectsPerBin[binNum] += weight;
-            }
-        }
+        TVector<float> meanWeightedTarget(binSums.WeightedTarget.begin(), binSums.WeightedTarget.end());
+        TVector<double> sumWeightsObjectsPerBin = binSums.Weight;
 
         if (countObjectsPerBin[numBins - 1] == 0) {
             meanTarget.pop_back();
@@ -537,10 +588,9 @@ namespace NCB {
             featureNum,
             TCatFeatureHolderGenerator(featureNum, oneHotUniqueValues, skippedValues),
             predictionType,
-            threadCount,
             dataset,
             &predictionsOnVarying,
-            &executor);
+            executor);
 
         return TBinarizedFeatureStatistics{
             TVector<float>(),
@@ -553,13 +603,14 @@ namespace NCB {
         };
     }
 
-    TBinarizedFeatureStatistics GetBinarizedCatFeatureStatistics(
+    static TBinarizedFeatureStatistics GetBinarizedCatFeatureStatistics(
         const TFullModel& model,
         TDataProvider& dataset,
         const size_t featureNum,
         const TVector<double>& prediction,
+        const TTargetForStatistics& target,
         const EPredictionType predictionType,
-        const int threadCount) {
+        NPar::TLocalExecutor* executor) {
         const int featureFlatNum = GetOneHotFeatureFlatNum(model, featureNum);
         CB_ENSURE_INTERNAL(
             featureFlatNum != -1,
@@ -571,8 +622,9 @@ namespace NCB {
             featureNum,
             featureFlatNum,
             prediction,
+            target,
             predictionType,
-            threadCount
+            executor
         );
     }
 
@@ -587,14 +639,19 @@ namespace NCB {
         const TVector<double> prediction = ApplyModelMulti(model, dataset, false, predictionType, 0, 0, threadCount)[0];
         TVector<TBinarizedFeatureStatistics> statistics;
 
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(threadCount - 1);
+        const TTargetForStatistics target = GetTargetForStatistics(model, dataset, &executor);
+
         for (const auto catFeatureNum: catFeaturesNums) {
             statistics.push_back(
                 GetBinarizedCatFeatureStatistics(
                     model, dataset,
                     catFeatureNum,
                     prediction,
+                    target,
                     predictionType,
-                    threadCount
+                    &executor
                 )
             );
         }
@@ -605,8 +662,9 @@ namespace NCB {
                     model, dataset,
                     floatFeatureNum,
                     prediction,
+                    target,
                     predictionType,
-                    threadCount
+                    &executor
                 )
             );
         }
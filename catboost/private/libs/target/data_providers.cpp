@@ -22,6 +22,8 @@
 #include <util/generic/ymath.h>
 #include <util/stream/labeled.h>
 
+#include <numeric>
+
 
 namespace NCB {
 
@@ -234,7 +236,8 @@ namespace NCB {
         const TObjectsGrouping& objectsGrouping,
         TConstArrayRef<float> targetData,
         int maxPairsCount,
-        TRestorableFastRng64* rand)
+        TRestorableFastRng64* rand,
+        NPar::TLocalExecutor* localExecutor)
     {
         CB_ENSURE(
             targetData,
@@ -254,6 +257,7 @@ namespace NCB {
             targetData,
             maxPairsCount,
             rand,
+            localExecutor,
             &result);
 
         return result;
@@ -264,7 +268,8 @@ namespace NCB {
         const TObjectsGrouping& objectsGrouping,
         TMaybeData<TConstArrayRef<TSubgroupId>> subgroupIds,
         const TWeights<float>& groupWeights,
-        TConstArrayRef<TPair> pairs) // can be empty
+        TConstArrayRef<TPair> pairs, // can be empty
+        NPar::TLocalExecutor* localExecutor)
     {
         CB_ENSURE(!objectsGrouping.IsTrivial(), "Groupwise loss/metrics require nontrivial groups");
 
@@ -277,40 +282,69 @@ namespace NCB {
             objectToGroupIdxMap.yresize(objectsGrouping.GetObjectCount());
         }
 
-        for (auto groupIdx : xrange((ui32)groupsBounds.size())) {
-            auto& group = result[groupIdx];
+        NPar::TLocalExecutor::TExecRangeParams groupsRangeParams(0, SafeIntegerCast<int>(groupsBounds.size()));
+        groupsRangeParams.SetBlockCountToThreadCount();
 
-            if (group.GetSize()) {
-                group.Weight = groupWeights[group.Begin];
-                if (subgroupIds) {
-                    group.SubgroupId.yresize(group.GetSize());
-                    const auto subgroupIdsData = *subgroupIds;
-                    for (auto objectInGroupIdx : xrange(group.GetSize())) {
-                        group.SubgroupId[objectInGroupIdx] = subgroupIdsData[group.Begin + objectInGroupIdx];
+        localExecutor->ExecRange(
+            [&] (int groupIdx) {
+                auto& group = result[groupIdx];
+
+                if (group.GetSize()) {
+                    group.Weight = groupWeights[group.Begin];
+                    if (subgroupIds) {
+                        group.SubgroupId.yresize(group.GetSize());
+                        const auto subgroupIdsData = *subgroupIds;
+                        for (auto objectInGroupIdx : xrange(group.GetSize())) {
+                            group.SubgroupId[objectInGroupIdx] = subgroupIdsData[group.Begin + objectInGroupIdx];
+                        }
                     }
-                }
-                if (!pairs.empty()) {
-                    group.Competitors.resize(group.GetSize());
-                    for (auto objectIdx : group.Iter()) {
-                        objectToGroupIdxMap[objectIdx] = groupIdx;
+                    if (!pairs.empty()) {
+                        group.Competitors.resize(group.GetSize());
+                        for (auto objectIdx : group.Iter()) {
+                            objectToGroupIdxMap[objectIdx] = groupIdx;
+                        }
                     }
                 }
-            }
-        }
+            },
+            groupsRangeParams,
+            NPar::TLocalExecutor::WAIT_COMPLETE);
 
         if (!pairs.empty()) {
+            /* pairs are distributed by groups (preserving their order) first
+             * so competitors lists of different groups can be filled in parallel
+             */
+            TVector<size_t> groupPairsOffsets(groupsBounds.size() + 1, 0);
             for (const auto& pair : pairs) {
-                ui32 groupIdx = objectToGroupIdxMap[pair.WinnerId];
-                /* it has been already checked on RawTargetData creation that WinnerId and LoserId
-                  belong to the same group, so don't recheck it in non-debug here
-                */
-                Y_ASSERT(objectToGroupIdxMap[pair.LoserId] == groupIdx);
+                ++groupPairsOffsets[objectToGroupIdxMap[pair.WinnerId] + 1];
+            }
+            std::partial_sum(groupPairsOffsets.begin(), groupPairsOffsets.end(), groupPairsOffsets.begin());
 
-                auto& group = result[groupIdx];
-                group.Competitors[pair.WinnerId - group.Begin].emplace_back(
-                    pair.LoserId - group.Begin,
-                    pair.Weight);
+            TVector<size_t> pairsByGroups;
+            pairsByGroups.yresize(pairs.size());
+            {
+                TVector<size_t> groupPairsEnds(groupPairsOffsets.begin(), groupPairsOffsets.end() - 1);
+                for (auto pairIdx : xrange(pairs.size())) {
+                    pairsByGroups[groupPairsEnds[objectToGroupIdxMap[pairs[pairIdx].WinnerId]]++] = pairIdx;
+                }
             }
+
+            localExecutor->ExecRange(
+                [&] (int groupIdx) {
+                    auto& group = result[groupIdx];
+                    for (auto i : xrange(groupPairsOffsets[groupIdx], groupPairsOffsets[groupIdx + 1])) {
+                        const auto& pair = pairs[pairsByGroups[i]];
+                        /* it has been already checked on RawTargetData creation that WinnerId and LoserId
+                          belong to the same group, so don't recheck it in non-debug here
+                        */
+                        Y_ASSERT(objectToGroupIdxMap[pair.LoserId] == (ui32)groupIdx);
+
+                        group.Competitors[pair.WinnerId - group.Begin].emplace_back(
+                            pair.LoserId - group.Begin,
+                            pair.Weight);
+                    }
+                },
+                groupsRangeParams,
+                NPar::TLocalExecutor::WAIT_COMPLETE);
         }
 
         return MakeAtomicShared<TVector<TQueryInfo>>(std::move(result));
@@ -692,7 +726,8 @@ namespace NCB {
                     *rawData.GetObjectsGrouping(),
                     *maybeConvertedTarget[0],
                     *targetCreationOptions.MaxPairsCount,
-                    rand);
+                    rand,
+                    localExecutor);
 
                 pairs = generatedPairs;
             }
@@ -722,7 +757,8 @@ namespace NCB {
                         *rawData.GetObjectsGrouping(),
                         subgroupIds,
                         rawData.GetGroupWeights(),
-                        pairs
+                        pairs,
+                        localExecutor
                     )
                 );
             }
@@ -784,7 +820,8 @@ namespace NCB {
                 outputPairsInfo.FakeObjectsGrouping,
                 Nothing(),
                 TWeights(outputPairsInfo.PermutationForGrouping.size()),
-                TConstArrayRef<TPair>(outputPairsInfo.PairsInPermutedDataset)
+                TConstArrayRef<TPair>(outputPairsInfo.PairsInPermutedDataset),
+                localExecutor
             )
         );
     }
@@ -109,6 +109,7 @@ namespace NCB {
         const TObjectsGrouping& objectsGrouping,
         TMaybeData<TConstArrayRef<TSubgroupId>> subgroupIds,
         const TWeights<float>& groupWeights,
-        TConstArrayRef<TPair> pairs);
+        TConstArrayRef<TPair> pairs, // can be empty
+        NPar::TLocalExecutor* localExecutor);
 
 }
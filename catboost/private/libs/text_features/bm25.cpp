@@ -2,6 +2,8 @@
 
 #include <catboost/private/libs/text_features/flatbuffers/feature_calcers.fbs.h>
 
+#include <library/cpp/containers/stack_vector/stack_vec.h>
+
 #include <util/generic/ymath.h>
 
 using namespace NCB;
@@ -38,13 +40,14 @@ static inline double Score(double termFreq, double k, double b, double meanLengt
 }
 
 void TBM25::Compute(const TText& text, TOutputFloatIterator iterator) const {
-    TVector<ui32> termFreqInClass(NumClasses);
-    TVector<double> scores(NumClasses);
+    // called per document at apply time, avoid heap allocations for usual class counts
+    TStackVec<ui32> termFreqInClass(NumClasses);
+    TStackVec<double> scores(NumClasses);
+    const double meanClassLength = TotalTokens * 1.0 / NumClasses;
 
     for (const auto& tokenToCount : text) {
         ExtractTermFreq(Frequencies, tokenToCount.Token(), termFreqInClass);
         double inverseClassFreq = CalcTruncatedInvClassFreq(termFreqInClass, TruncateBorder);
-        double meanClassLength = TotalTokens * 1.0 / NumClasses;
 
         for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
             scores[clazz] += inverseClassFreq * Score(termFreqInClass[clazz], K, B, meanClassLength,  ClassTotalTokens[clazz]);
@@ -19,7 +19,7 @@ static inline void SolveLinearSystemCholesky(TArrayRef<double> matrix,
 }
 
 
-inline double LogProbNormal(TConstArrayRef<float> x, TConstArrayRef<double> mu, TConstArrayRef<double> sigma) {
+inline double LogProbNormal(TConstArrayRef<double> x, TConstArrayRef<double> mu, TConstArrayRef<double> sigma) {
     const ui32 dim = x.size();
 
     TVector<double> target(x.begin(), x.end());
@@ -50,23 +50,26 @@ void NCB::TEmbeddingOnlineFeatures::Compute(
     TVector<double> classProbsHomoscedastic(NumClasses);
     TVector<double> classProbsHeteroscedastic(NumClasses);
 
+    // converted once so that distances to all class means use the double dot product kernels
+    const TVector<double> embeddingAsDouble(embedding.begin(), embedding.end());
+
     for (ui32 i = 0; i < NumClasses; ++i) {
         const double weight = ClassSizes[i] + Prior;
         const double classPrior = log(weight) - log(TotalWeight);
 
         if (ComputeHomoscedasticModel) {
             classProbsHomoscedastic[i] += classPrior;
-            classProbsHomoscedastic[i] += LogProbNormal(embedding, Means[i], TotalSigma);
+            classProbsHomoscedastic[i] += LogProbNormal(embeddingAsDouble, Means[i], TotalSigma);
         }
         if (ComputeHeteroscedasticModel) {
             classProbsHeteroscedastic[i] += classPrior;
-            classProbsHeteroscedastic[i] += LogProbNormal(embedding, Means[i], PerClassSigma[i]);
+            classProbsHeteroscedastic[i] += LogProbNormal(embeddingAsDouble, Means[i], PerClassSigma[i]);
         }
 
         if (ComputeCosDistance) {
             *outputFeaturesIterator = CosDistance(
                 MakeConstArrayRef(Means[i]),
-                embedding
+                MakeConstArrayRef(embeddingAsDouble)
             );
             ++outputFeaturesIterator;
         }
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <catboost/libs/helpers/exception.h>
+
+#include <library/cpp/dot_product/dot_product.h>
+
 #include <util/generic/array_ref.h>
 #include <util/generic/ymath.h>
 
@@ -29,6 +32,15 @@ inline double CosDistance(
     return dotProduct / sqrt(normLeft * normRight);
 }
 
+// vectorized version, preferred over the generic one for double vectors
+inline double CosDistance(TConstArrayRef<double> left, TConstArrayRef<double> right) {
+    CB_ENSURE(left.size() == right.size(), "Embedding dim should be equal");
+    const double dotProduct = DotProduct(left.data(), right.data(), left.size()) + 1e-10;
+    const double normLeft = DotProduct(left.data(), left.data(), left.size()) + 1e-10;
+    const double normRight = DotProduct(right.data(), right.data(), right.size()) + 1e-10;
+    return dotProduct / sqrt(normLeft * normRight);
+}
+
 
 inline void Softmax(TArrayRef<double> vals) {
     double maxValue = vals[0];
@@ -3,6 +3,8 @@
 
 #include <catboost/private/libs/text_features/flatbuffers/feature_calcers.fbs.h>
 
+#include <library/cpp/containers/stack_vector/stack_vec.h>
+
 #include <util/generic/array_ref.h>
 #include <util/generic/ymath.h>
 
@@ -48,7 +50,8 @@ void TMultinomialNaiveBayes::Compute(
     const TText& text,
     TOutputFloatIterator outputFeaturesIterator) const {
 
-    TVector<double> logProbs(NumClasses);
+    // called per document at apply time, avoid heap allocations for usual class counts
+    TStackVec<double> logProbs(NumClasses);
     for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
         logProbs[clazz] = LogProb(Frequencies[clazz], ClassDocs[clazz], ClassTotalTokens[clazz], text);
     }
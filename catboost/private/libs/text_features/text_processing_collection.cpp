@@ -13,22 +13,30 @@
 
 namespace NCB {
     static void CalcFeatures(
-        const TVector<TTokensWithBuffer>& tokens,
-        const TDictionaryProxy& dictionary,
+        TConstArrayRef<TText> texts,
         const TTextFeatureCalcer& calcer,
         TArrayRef<float> result
     ) {
-        const ui64 docCount = tokens.size();
+        const ui64 docCount = texts.size();
         for (ui32 docId: xrange(docCount)) {
-            TText text = dictionary.Apply(tokens[docId].View);
-
             calcer.Compute(
-                text,
+                texts[docId],
                 TOutputFloatIterator(result.data() + docId, docCount, result.size())
             );
         }
     }
 
+    static void ApplyDictionary(
+        const TVector<TTokensWithBuffer>& tokens,
+        const TDictionaryProxy& dictionary,
+        TVector<TText>* texts
+    ) {
+        TVector<ui32> tokenIdsBuffer;
+        for (ui32 docId: xrange(tokens.size())) {
+            dictionary.Apply(tokens[docId].View, &(*texts)[docId], &tokenIdsBuffer);
+        }
+    }
+
     static void TokenizeTextFeature(
         TConstArrayRef<TStringBuf> textFeature,
         size_t docCount,
@@ -54,6 +62,7 @@ namespace NCB {
         TVector<TTokensWithBuffer> tokens;
         tokens.yresize(docCount);
         TTokenizerPtr previousTokenizer;
+        TVector<TText> texts(docCount);
 
         for (ui32 digitizerId: PerFeatureDigitizers[textFeatureIdx]) {
             const auto& dictionary = Digitizers[digitizerId].Dictionary;
@@ -63,6 +72,8 @@ namespace NCB {
                 TokenizeTextFeature(textFeature, docCount, Digitizers[digitizerId].Tokenizer, &tokens);
                 previousTokenizer = Digitizers[digitizerId].Tokenizer;
             }
+            // dictionary is applied once and its result is shared by all calcers of the tokenized feature
+            ApplyDictionary(tokens, *dictionary, &texts);
 
             for (ui32 calcerId: PerTokenizedFeatureCalcers[tokenizedFeatureIdx]) {
                 const auto& calcer = FeatureCalcers[calcerId];
@@ -74,7 +85,7 @@ namespace NCB {
                     result.data() + calcerOffset,
                     result.data() + calcerOffset + calculatedFeaturesSize
                 );
-                NCB::CalcFeatures(tokens, *dictionary, *calcer, currentResult);
+                NCB::CalcFeatures(texts, *calcer, currentResult);
             }
         }
     }
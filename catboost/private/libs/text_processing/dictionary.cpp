@@ -16,6 +16,15 @@ namespace NCB {
         *text = TText{std::move(tokenIds)};
     }
 
+    void TDictionaryProxy::Apply(
+        TConstArrayRef<TStringBuf> tokens,
+        TText* text,
+        TVector<ui32>* tokenIdsBuffer
+    ) const {
+        DictionaryImpl->Apply(tokens, tokenIdsBuffer);
+        text->Assign(*tokenIdsBuffer);
+    }
+
     ui32 TDictionaryProxy::Size() const {
         return DictionaryImpl->Size();
     }
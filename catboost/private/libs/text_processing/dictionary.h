@@ -32,6 +32,8 @@ namespace NCB {
         TTokenId Apply(TStringBuf token) const;
         TText Apply(TConstArrayRef<TStringBuf> tokens) const;
         void Apply(TConstArrayRef<TStringBuf> tokens, TText* text) const;
+        // tokenIdsBuffer is reused between calls to avoid per-document allocations
+        void Apply(TConstArrayRef<TStringBuf> tokens, TText* text, TVector<ui32>* tokenIdsBuffer) const;
 
         ui32 Size() const;
 
@@ -1,13 +1,19 @@
 #include "text_column_builder.h"
 
+#include <util/system/tls.h>
+
 using namespace NCB;
 
 
 void TTextColumnBuilder::AddText(ui32 index, const TStringBuf text) {
     CB_ENSURE_INTERNAL(index < Texts.size(), "Text index is out of range");
-    TTokensWithBuffer tokens;
+
+    // AddText is called concurrently for different indices, so buffers are per-thread
+    Y_STATIC_THREAD(TTokensWithBuffer) tlsTokens;
+    Y_STATIC_THREAD(TVector<ui32>) tlsTokenIds;
+    TTokensWithBuffer& tokens = tlsTokens.Get();
     Tokenizer->Tokenize(text, &tokens);
-    Dictionary->Apply(tokens.View, &Texts[index]);
+    Dictionary->Apply(tokens.View, &Texts[index], &tlsTokenIds.Get());
 }
 
 TVector<TText> TTextColumnBuilder::Build() {
@@ -73,4 +73,28 @@ Y_UNIT_TEST_SUITE(TestTextDataset) {
         UNIT_ASSERT_EQUAL(lastText.Find(haId), lastText.end());
         UNIT_ASSERT_EQUAL(lastText.Find(hoId), lastText.end());
     }
+
+    Y_UNIT_TEST(TestDictionaryApplyWithBuffer) {
+        TVector<TString> text = {
+            "ho ho ho",
+            "hi ha ho",
+            "ha",
+            ""
+        };
+        NCatboostOptions::TTextColumnDictionaryOptions options;
+        NTextProcessing::NDictionary::TDictionaryBuilderOptions builderOptions;
+        builderOptions.OccurrenceLowerBound = 1;
+        options.DictionaryBuilderOptions.Set(builderOptions);
+
+        TDictionaryPtr dictionary = CreateDictionary(TIterableTextFeature(text), options, tokenizer);
+
+        TTokensWithBuffer tokens;
+        TVector<ui32> tokenIdsBuffer;
+        TText bufferedText;
+        for (const auto& line : text) {
+            tokenizer->Tokenize(line, &tokens);
+            dictionary->Apply(tokens.View, &bufferedText, &tokenIdsBuffer);
+            UNIT_ASSERT_EQUAL(bufferedText, dictionary->Apply(tokens.View));
+        }
+    }
 }
@@ -203,6 +203,7 @@ cdef extern from "library/cpp/threading/local_executor/local_executor.h" namespa
     cdef cppclass TLocalExecutor:
         TLocalExecutor() nogil
         void RunAdditionalThreads(int threadCount) nogil except +ProcessException
+        int GetThreadCount() nogil
 
 
 cdef extern from "catboost/libs/logging/logging.h":
@@ -700,6 +701,15 @@ cdef extern from "catboost/private/libs/quantized_pool/serialization.h" namespac
     cdef void SaveQuantizedPool(const TDataProviderPtr& dataProvider, TString fileName) except +ProcessException
 
 
+cdef extern from "catboost/libs/data/columnar_binary_loader.h" namespace "NCB":
+    cdef void SaveRawDataProviderAsColumnarBinaryPool(
+        const TDataProvider& dataProvider,
+        const TString& poolPath,
+        const TString& cdPath,
+        TLocalExecutor* localExecutor
+    ) nogil except +ProcessException
+
+
 cdef extern from "catboost/private/libs/data_util/path_with_scheme.h" namespace "NCB":
     cdef cppclass TPathWithScheme:
         TString Scheme
@@ -979,6 +989,8 @@ cdef extern from "catboost/libs/model/model.h":
         void Swap(TFullModel& other) except +ProcessException
         size_t GetTreeCount() nogil except +ProcessException
         size_t GetDimensionsCount() nogil except +ProcessException
+        bool_t HasCategoricalFeatures() nogil except +ProcessException
+        bool_t HasTextFeatures() nogil except +ProcessException
         void Truncate(size_t begin, size_t end) except +ProcessException
         bool_t IsOblivious() except +ProcessException
         TString GetLossFunctionName() except +ProcessException
@@ -1252,6 +1264,13 @@ cdef extern from "catboost/private/libs/algo/apply.h":
             TVector[double]* flatApprox,
             TVector[TVector[double]]* approx
         ) nogil except +ProcessException
+        void AddRawFormulaValsToApprox(
+            int begin,
+            int end,
+            size_t approxStartDocIdx,
+            TVector[double]* flatApprox,
+            TVector[TVector[double]]* approx
+        ) nogil except +ProcessException
 
     cdef cppclass TLeafIndexCalcerOnPool:
         TLeafIndexCalcerOnPool(
@@ -1344,6 +1363,13 @@ cdef extern from "catboost/libs/eval_result/eval_helpers.h":
         int threadCount
     ) nogil except +ProcessException
 
+    cdef TVector[TVector[double]] PrepareEvalForInternalApprox(
+        const EPredictionType predictionType,
+        const TFullModel& model,
+        const TVector[TVector[double]]& approx,
+        TLocalExecutor* localExecutor
+    ) nogil except +ProcessException
+
 cdef extern from "catboost/libs/eval_result/eval_result.h" namespace "NCB":
     cdef cppclass TEvalResult:
         TVector[TVector[TVector[double]]] GetRawValuesRef() except * with gil
@@ -1385,6 +1411,19 @@ cdef extern from "catboost/libs/fstr/calc_fstr.h":
         EExplainableModelOutput modelOutputType
     ) nogil except +ProcessException
 
+    cdef void GetFeatureImportancesMulti(
+        const EFstrType type,
+        const TFullModel& model,
+        const TDataProviderPtr dataset,
+        const TDataProviderPtr referenceDataset,
+        int threadCount,
+        EPreCalcShapValues mode,
+        TArrayRef[double] result,
+        int logPeriod,
+        ECalcTypeShapValues calcType,
+        EExplainableModelOutput modelOutputType
+    ) nogil except +ProcessException
+
     cdef TVector[TVector[TVector[TVector[double]]]] CalcShapFeatureInteractionMulti(
         const EFstrType type,
         const TFullModel& model,
@@ -1471,6 +1510,32 @@ cdef extern from "catboost/python-package/catboost/helpers.h":
         const TVector[TString]& metricsDescription
     ) nogil except +ProcessException
 
+    cdef void AddFloatFeaturesFromRowMajorMatrix(
+        const float* matrix,
+        ui32 objectCount,
+        ui32 featureCount,
+        TLocalExecutor* localExecutor,
+        IRawFeaturesOrderDataVisitor* builderVisitor
+    ) nogil except +ProcessException
+
+    cdef TVector[ui32] MapCategoricalCodesToHashedCatValues(
+        ui32 flatFeatureIdx,
+        TConstArrayRef[i32] codes,
+        TConstArrayRef[ui32] categoriesAsHashedCatValues,
+        TLocalExecutor* localExecutor
+    ) nogil except +ProcessException
+
+    cdef void CalcRawFormulaValsOnFloatFeaturesMatrix(
+        const TFullModel& model,
+        const float* matrix,
+        size_t objectCount,
+        size_t featureCount,
+        int treeBegin,
+        int treeEnd,
+        TArrayRef[double] results,
+        TLocalExecutor* localExecutor
+    ) nogil except +ProcessException
+
     cdef TVector[double] EvalMetricsForUtils(
         TConstArrayRef[TVector[float]] label,
         const TVector[TVector[double]]& approx,
@@ -1563,7 +1628,8 @@ cdef extern from "catboost/private/libs/hyperparameter_tuning/hyperparameter_tun
         TMetricsAndTimeLeftHistory* trainTestResult,
         bool_t isSearchUsingCV,
         bool_t isReturnCvResults,
-        int verbose) nogil except +ProcessException
+        int verbose,
+        ui32 pruningStartIteration) nogil except +ProcessException
 
     cdef void RandomizedSearch(
         ui32 numberOfTries,
@@ -1579,7 +1645,8 @@ cdef extern from "catboost/private/libs/hyperparameter_tuning/hyperparameter_tun
         TMetricsAndTimeLeftHistory* trainTestResult,
         bool_t isSearchUsingCV,
         bool_t isReturnCvResults,
-        int verbose) nogil except +ProcessException
+        int verbose,
+        ui32 pruningStartIteration) nogil except +ProcessException
 
 
 cpdef run_atexit_finalizers():
@@ -2474,6 +2541,26 @@ def _set_features_order_data_ndarray(
             builder_visitor[0].AddFloatFeature(flat_feature_idx, num_factor_data)
 
 
+cdef _set_features_order_data_c_contiguous_float_ndarray(
+    const float [:,::1] feature_values,
+    Py_FeaturesOrderBuilderVisitor py_builder_visitor
+):
+    cdef IRawFeaturesOrderDataVisitor* builder_visitor
+    py_builder_visitor.get_raw_features_order_data_visitor(&builder_visitor)
+
+    cdef ui32 doc_count = <ui32>(feature_values.shape[0])
+    cdef ui32 feature_count = <ui32>(feature_values.shape[1])
+
+    with nogil:
+        AddFloatFeaturesFromRowMajorMatrix(
+            &feature_values[0, 0],
+            doc_count,
+            feature_count,
+            &py_builder_visitor.local_executor,
+            builder_visitor
+        )
+
+
 cdef float get_float_feature(ui32 non_default_doc_idx, ui32 flat_feature_idx, src_value) except*:
     try:
         return _FloatOrNan(src_value)
@@ -2697,12 +2784,16 @@ cdef _set_features_order_data_pd_data_frame_categorical_column(
     # array of [dst_value_for_cateory0, dst_value_for_category1 ...]
     TVector[ui32]* categories_as_hashed_cat_values,
 
-    IRawFeaturesOrderDataVisitor* builder_visitor
+    IRawFeaturesOrderDataVisitor* builder_visitor,
+    TLocalExecutor* local_executor
 ):
     cdef np.ndarray categories_values = column_values.categories.values
     cdef ui32 categories_values_size = categories_values.shape[0]
 
-    cdef np.ndarray categories_codes = column_values.codes
+    cdef np.ndarray[np.int32_t, ndim=1, mode='c'] categories_codes = np.ascontiguousarray(
+        column_values.codes,
+        dtype=np.int32
+    )
     cdef ui32 doc_count = categories_codes.shape[0]
 
     # access through TArrayRef is faster
@@ -2710,9 +2801,9 @@ cdef _set_features_order_data_pd_data_frame_categorical_column(
     cdef TVector[ui32] hashed_cat_values
 
     cdef ui32 category_idx
-    cdef ui32 doc_idx
-    cdef i32 category_code
-
+    cdef TConstArrayRef[i32] categories_codes_ref
+    if doc_count != 0:
+        categories_codes_ref = TConstArrayRef[i32](<i32*>&categories_codes[0], doc_count)
 
     # TODO(akhropov): make yresize accessible in Cython
     categories_as_hashed_cat_values[0].resize(categories_values_size)
@@ -2732,18 +2823,14 @@ cdef _set_features_order_data_pd_data_frame_categorical_column(
             factor_string[0]
         )
 
-    # TODO(akhropov): make yresize accessible in Cython
-    hashed_cat_values.resize(doc_count)
-    for doc_idx in range(doc_count):
-        category_code = categories_codes[doc_idx]
-        if category_code == -1:
-            raise CatBoostError(
-                'Invalid type for cat_feature[object_idx={},feature_idx={}]=NaN :'
-                ' cat_features must be integer or string, real number values and NaN values'
-                ' should be converted to string.'.format(doc_idx, flat_feature_idx)
-            )
-
-        hashed_cat_values[doc_idx] = categories_as_hashed_cat_values_ref[category_code]
+    # categories are hashed once above, codes are mapped to them in parallel without GIL
+    with nogil:
+        hashed_cat_values = MapCategoricalCodesToHashedCatValues(
+            flat_feature_idx,
+            categories_codes_ref,
+            <TConstArrayRef[ui32]>categories_as_hashed_cat_values[0],
+            local_executor
+        )
 
     builder_visitor[0].AddCatFeature(
         flat_feature_idx,
@@ -2755,7 +2842,8 @@ cdef _set_features_order_data_pd_data_frame_categorical_column(
 cdef object _set_features_order_data_pd_data_frame(
     data_frame,
     const TFeaturesLayout* features_layout,
-    IRawFeaturesOrderDataVisitor* builder_visitor
+    IRawFeaturesOrderDataVisitor* builder_visitor,
+    TLocalExecutor* local_executor
 ):
     cdef TVector[bool_t] is_cat_feature_mask = _get_is_feature_type_mask(features_layout, EFeatureType_Categorical)
     cdef TVector[bool_t] is_text_feature_mask = _get_is_feature_type_mask(features_layout, EFeatureType_Text)
@@ -2802,7 +2890,8 @@ cdef object _set_features_order_data_pd_data_frame(
                 column_data.values,
                 &factor_string,
                 &categories_as_hashed_cat_values,
-                builder_visitor
+                builder_visitor,
+                local_executor
             )
         else:
             column_values = column_data.values
@@ -3668,7 +3757,8 @@ cdef class _PoolBase:
             new_data_holders = _set_features_order_data_pd_data_frame(
                 data,
                 features_layout,
-                builder_visitor
+                builder_visitor,
+                &py_builder_visitor.local_executor
             )
         elif isinstance(data, scipy.sparse.spmatrix):
             new_data_holders = _set_features_order_data_scipy_sparse_matrix(
@@ -3676,6 +3766,9 @@ cdef class _PoolBase:
                 features_layout,
                 py_builder_visitor
             )
+        elif isinstance(data, np.ndarray) and not data.flags.f_contiguous:
+            # C-contiguous float32 data without categorical and text features, columns are copied
+            _set_features_order_data_c_contiguous_float_ndarray(data, py_builder_visitor)
         elif isinstance(data, np.ndarray):
             if data_meta_info.FeaturesLayout.Get()[0].GetFloatFeatureCount():
                 new_data_holders = data
@@ -3814,6 +3907,16 @@ cdef class _PoolBase:
             if isinstance(data, np.ndarray) and (data.dtype in numpy_num_dtype_list):
                 if data.flags.aligned and data.flags.f_contiguous and (len(data) != 0):
                     do_use_raw_data_in_features_order = True
+                elif (data.dtype == np.float32 and
+                      data.flags.aligned and
+                      data.flags.c_contiguous and
+                      (len(data) != 0) and
+                      (data.ndim == 2) and
+                      (data.shape[1] != 0)):
+                    # transposing whole columns at once is much faster than visiting values one by one
+                    if (data_meta_info.FeaturesLayout.Get()[0].GetFloatFeatureCount() ==
+                        data_meta_info.FeaturesLayout.Get()[0].GetExternalFeatureCount()):
+                        do_use_raw_data_in_features_order = True
 
         if do_use_raw_data_in_features_order:
             self._init_features_order_layout_pool(
@@ -3848,6 +3951,19 @@ cdef class _PoolBase:
         cdef TString file_name = to_arcadia_string(fname)
         SaveQuantizedPool(self.__pool, file_name)
 
+    cpdef _save_columnar(self, fname, cd_fname, thread_count):
+        cdef TString file_name = to_arcadia_string(fname)
+        cdef TString cd_file_name = to_arcadia_string(cd_fname)
+        cdef TLocalExecutor local_executor
+        local_executor.RunAdditionalThreads(UpdateThreadCount(thread_count) - 1)
+        with nogil:
+            SaveRawDataProviderAsColumnarBinaryPool(
+                dereference(self.__pool.Get()),
+                file_name,
+                cd_file_name,
+                &local_executor
+            )
+
 
     cpdef _set_pairs(self, pairs):
         cdef TVector[TPair] pairs_vector = _make_pairs_vector(pairs)
@@ -4334,6 +4450,7 @@ cdef class _CatBoost:
     cdef TVector[TEvalResult*] __test_evals
     cdef TMetricsAndTimeLeftHistory __metrics_history
     cdef THolder[TLearnProgress] __cached_learn_progress
+    cdef THolder[TLocalExecutor] __predict_local_executor
 
     def __cinit__(self):
         self.__model = new TFullModel()
@@ -4523,6 +4640,57 @@ cdef class _CatBoost:
 
         return transform_predictions(pred, predictionType, thread_count, self.__model)
 
+    cdef TLocalExecutor* _get_predict_local_executor(self, int thread_count):
+        # kept between calls, so that small batches don't pay for starting threads on every prediction
+        if (self.__predict_local_executor.Get() == NULL) or (self.__predict_local_executor.Get().GetThreadCount() != thread_count - 1):
+            self.__predict_local_executor.Reset(new TLocalExecutor())
+            self.__predict_local_executor.Get().RunAdditionalThreads(thread_count - 1)
+        return self.__predict_local_executor.Get()
+
+    cpdef _base_predict_float_matrix(self, np.ndarray[np.float32_t, ndim=2, mode='c'] data, str prediction_type, int ntree_start, int ntree_end, int thread_count):
+        cdef EPredictionType predictionType = string_to_prediction_type(prediction_type)
+        cdef size_t object_count = data.shape[0]
+        cdef size_t feature_count = data.shape[1]
+        cdef size_t approx_dimension = self.__model.GetDimensionsCount()
+        cdef np.ndarray[np.float64_t, ndim=2, mode='c'] raw_formula_vals = np.empty(
+            (object_count, approx_dimension),
+            dtype=np.float64
+        )
+        cdef const double* raw_formula_vals_data = <const double*>raw_formula_vals.data
+        cdef TVector[TVector[double]] pred
+        cdef size_t dim
+        cdef size_t object_idx
+
+        thread_count = UpdateThreadCount(thread_count)
+        cdef TLocalExecutor* local_executor = self._get_predict_local_executor(thread_count)
+        with nogil:
+            CalcRawFormulaValsOnFloatFeaturesMatrix(
+                dereference(self.__model),
+                <const float*>data.data,
+                object_count,
+                feature_count,
+                ntree_start,
+                ntree_end,
+                TArrayRef[double](<double*>raw_formula_vals.data, object_count * approx_dimension),
+                local_executor
+            )
+
+        if (approx_dimension == 1) and (predictionType == EPredictionType_RawFormulaVal):
+            return raw_formula_vals.reshape(object_count)
+
+        with nogil:
+            pred.resize(approx_dimension)
+            for dim in range(approx_dimension):
+                pred[dim].resize(object_count)
+                for object_idx in range(object_count):
+                    pred[dim][object_idx] = raw_formula_vals_data[object_idx * approx_dimension + dim]
+            pred = PrepareEvalForInternalApprox(predictionType, dereference(self.__model), pred, local_executor)
+
+        return transform_predictions(pred, predictionType, thread_count, self.__model)
+
+    cpdef _has_only_float_features(self):
+        return not self.__model.HasCategoricalFeatures() and not self.__model.HasTextFeatures()
+
     cpdef _staged_predict_iterator(self, _PoolBase pool, str prediction_type, int ntree_start, int ntree_end, int eval_period, int thread_count, verbose):
         thread_count = UpdateThreadCount(thread_count);
         stagedPredictIterator = _StagedPredictIterator(prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose)
@@ -4599,7 +4767,7 @@ cdef class _CatBoost:
         native_feature_ids = [to_native_str(s) for s in feature_ids]
 
         cdef TVector[TVector[double]] fstr
-        cdef TVector[TVector[TVector[double]]] fstr_multi
+        cdef np.ndarray[np.float64_t, ndim=3] shap_values_multi
         cdef TDataProviderPtr dataProviderPtr
         if pool:
             dataProviderPtr = pool.__pool
@@ -4618,19 +4786,29 @@ cdef class _CatBoost:
             TryFromString[ECalcTypeShapValues](to_arcadia_string("Independent"), calc_type)
 
         if type_name == 'ShapValues' and dereference(self.__model).GetDimensionsCount() > 1:
+            assert pool, "Dataset is not provided"
+            shap_values_multi = np.empty(
+                (
+                    pool.num_row(),
+                    dereference(self.__model).GetDimensionsCount(),
+                    dataProviderPtr.Get()[0].MetaInfo.GetFeatureCount() + 1
+                ),
+                dtype=_npfloat64
+            )
             with nogil:
-                fstr_multi = GetFeatureImportancesMulti(
+                GetFeatureImportancesMulti(
                     fstr_type,
                     dereference(self.__model),
                     dataProviderPtr,
                     referenceDataProviderPtr,
                     thread_count,
                     shap_mode,
+                    TArrayRef[double](<double*>shap_values_multi.data, shap_values_multi.size),
                     verbose,
                     calc_type,
                     model_output
                 )
-            return _3d_vector_of_double_to_np_array(fstr_multi), native_feature_ids
+            return shap_values_multi, native_feature_ids
         elif type_name == 'ShapInteractionValues':
             # TODO: Ensure sensible results of non-'Regular' calculation types for ShapInteractionValues
             assert shap_calc_type == "Regular", "Only 'Regular' calculation type is supported for ShapInteractionValues"
@@ -4845,7 +5023,7 @@ cdef class _CatBoost:
     cpdef _tune_hyperparams(self, list grids_list, _PoolBase train_pool, dict params, int n_iter,
                           int fold_count, int partition_random_seed, bool_t shuffle, bool_t stratified,
                           double train_size, bool_t choose_by_train_test_split, bool_t return_cv_results,
-                          custom_folds, int verbose):
+                          custom_folds, int verbose, int early_pruning_iterations):
 
         prep_params = _PreprocessParams(params)
         prep_grids = _PreprocessGrids(grids_list)
@@ -4874,6 +5052,9 @@ cdef class _CatBoost:
         ttParams.Stratified = False
         ttParams.TrainPart = train_size
 
+        if early_pruning_iterations < 0:
+            raise CatBoostError("early_pruning_iterations should be non-negative")
+
         cdef TBestOptionValuesWithCvResult results
         cdef TMetricsAndTimeLeftHistory trainTestResults
         with nogil:
@@ -4892,7 +5073,8 @@ cdef class _CatBoost:
                         &trainTestResults,
                         choose_by_train_test_split,
                         return_cv_results,
-                        verbose
+                        verbose,
+                        early_pruning_iterations
                     )
                 else:
                     RandomizedSearch(
@@ -4909,7 +5091,8 @@ cdef class _CatBoost:
                         &trainTestResults,
                         choose_by_train_test_split,
                         return_cv_results,
-                        verbose
+                        verbose,
+                        early_pruning_iterations
                     )
             finally:
                 ResetPythonInterruptHandler()
@@ -5260,7 +5443,7 @@ cdef _convert_to_visible_labels(EPredictionType predictionType, TVector[TVector[
 
 cdef class _StagedPredictIterator:
     cdef TVector[double] __flatApprox
-    cdef TVector[TVector[double]] __approx
+    cdef TVector[TVector[double]] __approx # running raw approx of trees [0, ntree_start)
     cdef TVector[TVector[double]] __pred
     cdef TFullModel* __model
     cdef TLocalExecutor __executor
@@ -5285,6 +5468,9 @@ cdef class _StagedPredictIterator:
             pool.__pool.Get()[0].ObjectsData,
             &self.__executor
         )
+        cdef TVector[double] zero_approx
+        zero_approx.resize(pool.num_row(), 0.0)
+        self.__approx.resize(dereference(self.__model).GetDimensionsCount(), zero_approx)
 
     def __dealloc__(self):
         del self.__modelCalcerOnPool
@@ -5296,21 +5482,14 @@ cdef class _StagedPredictIterator:
         if self.ntree_start >= self.ntree_end:
             raise StopIteration
 
-        dereference(self.__modelCalcerOnPool).ApplyModelMulti(
-            string_to_prediction_type('RawFormulaVal'),
+        dereference(self.__modelCalcerOnPool).AddRawFormulaValsToApprox(
             self.ntree_start,
             min(self.ntree_start + self.eval_period, self.ntree_end),
+            0,
             &self.__flatApprox,
-            &self.__pred
+            &self.__approx
         )
 
-        if self.__approx.empty():
-            self.__approx.swap(self.__pred)
-        else:
-            for i in range(self.__approx.size()):
-                for j in range(self.__approx[0].size()):
-                    self.__approx[i][j] += self.__pred[i][j]
-
         self.ntree_start += self.eval_period
         self.__pred = PrepareEvalForInternalApprox(self.predictionType, dereference(self.__model), self.__approx, self.thread_count)
 
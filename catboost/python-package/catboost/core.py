@@ -722,6 +722,40 @@ class Pool(_PoolBase):
 
         self._save(fname)
 
+    def save_columnar(self, fname, column_description=None, thread_count=-1):
+        """
+        Save the pool with raw float features to a file in the columnar binary format.
+
+        The saved pool can be loaded with Pool('cbcolumnar://' + fname, column_description=...).
+        Loaded pools memory-map the file, so it is not parsed and processes that load the same
+        file share its page-cached data.
+        Categorical and text features, string labels and pairs are not supported.
+
+        Parameters
+        ----------
+        fname : string
+            Output file name.
+
+        column_description : string, optional (default=None)
+            Output file name for the column description. If None, fname + '.cd' is used.
+
+        thread_count : int, optional (default=-1)
+            Number of threads used to extract feature values. -1 means the number of CPU cores.
+        """
+        if self.is_quantized():
+            raise CatBoostError('Pool is quantized, use save() instead')
+
+        if not isinstance(fname, STRING_TYPES):
+            raise CatBoostError("Invalid fname type={}: must be str().".format(type(fname)))
+        if column_description is None:
+            column_description = fname + '.cd'
+        if not isinstance(column_description, STRING_TYPES):
+            raise CatBoostError(
+                "Invalid column_description type={}: must be str().".format(type(column_description))
+            )
+
+        self._save_columnar(fname, column_description, thread_count)
+
     def quantize(self, ignored_features=None, per_float_feature_quantization=None, border_count=None,
                  max_bin=None, feature_border_type=None, sparse_features_conflict_fraction=None,
                  nan_mode=None, input_borders=None, task_type=None, used_ram_limit=None, random_seed=None, **kwargs):
@@ -1281,6 +1315,12 @@ class _CatBoostBase(object):
     def _base_predict(self, pool, prediction_type, ntree_start, ntree_end, thread_count, verbose):
         return self._object._base_predict(pool, prediction_type, ntree_start, ntree_end, thread_count, verbose)
 
+    def _base_predict_float_matrix(self, data, prediction_type, ntree_start, ntree_end, thread_count):
+        return self._object._base_predict_float_matrix(data, prediction_type, ntree_start, ntree_end, thread_count)
+
+    def _has_only_float_features(self):
+        return self._object._has_only_float_features()
+
     def _staged_predict_iterator(self, pool, prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose):
         return self._object._staged_predict_iterator(pool, prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose)
 
@@ -1907,12 +1947,33 @@ class CatBoost(_CatBoostBase):
         verbose = verbose or self.get_param('verbose')
         if verbose is None:
             verbose = False
+        if self._can_predict_on_float_ndarray_directly(data):
+            self._validate_prediction_type(prediction_type)
+            data_is_single_object = (data.ndim == 1)
+            matrix = np.ascontiguousarray(data.reshape(1, -1) if data_is_single_object else data, dtype=np.float32)
+            predictions = self._base_predict_float_matrix(matrix, prediction_type, ntree_start, ntree_end, thread_count)
+            return predictions[0] if data_is_single_object else predictions
+
         data, data_is_single_object = self._process_predict_input_data(data, parent_method_name, thread_count)
         self._validate_prediction_type(prediction_type)
 
         predictions = self._base_predict(data, prediction_type, ntree_start, ntree_end, thread_count, verbose)
         return predictions[0] if data_is_single_object else predictions
 
+    def _can_predict_on_float_ndarray_directly(self, data):
+        """
+        Numeric numpy arrays for models with float features only are passed to the model evaluator as is,
+        without intermediate Pool construction. This makes predictions on small batches much cheaper.
+        """
+        return (
+            isinstance(data, np.ndarray)
+            and (data.ndim in (1, 2))
+            and (data.dtype.kind == 'f')
+            and self.is_fitted()
+            and (self.tree_count_ is not None)
+            and self._has_only_float_features()
+        )
+
     def predict(self, data, prediction_type='RawFormulaVal', ntree_start=0, ntree_end=0, thread_count=-1, verbose=None):
         """
         Predict with data.
@@ -3192,7 +3253,8 @@ class CatBoost(_CatBoostBase):
 
     def _tune_hyperparams(self, param_grid, X, y=None, cv=3, n_iter=10, partition_random_seed=0,
                           calc_cv_statistics=True, search_by_train_test_split=True,
-                          refit=True, shuffle=True, stratified=None, train_size=0.8, verbose=1, plot=False):
+                          refit=True, shuffle=True, stratified=None, train_size=0.8, verbose=1, plot=False,
+                          early_pruning_iterations=0):
 
         currently_not_supported_params = {
             'ignored_features',
@@ -3254,7 +3316,8 @@ class CatBoost(_CatBoostBase):
             cv_result = self._object._tune_hyperparams(
                 param_grid, train_params["train_pool"], params, n_iter,
                 fold_count, partition_random_seed, shuffle, stratified, train_size,
-                search_by_train_test_split, calc_cv_statistics, custom_folds, verbose
+                search_by_train_test_split, calc_cv_statistics, custom_folds, verbose,
+                early_pruning_iterations
             )
 
         if refit:
@@ -3266,7 +3329,8 @@ class CatBoost(_CatBoostBase):
 
     def grid_search(self, param_grid, X, y=None, cv=3, partition_random_seed=0,
                     calc_cv_statistics=True, search_by_train_test_split=True,
-                    refit=True, shuffle=True, stratified=None, train_size=0.8, verbose=True, plot=False):
+                    refit=True, shuffle=True, stratified=None, train_size=0.8, verbose=True, plot=False,
+                    early_pruning_iterations=0):
         """
         Exhaustive search over specified parameter values for a model.
         Aafter calling this method model is fitted and can be used, if not specified otherwise (refit=False).
@@ -3333,6 +3397,12 @@ class CatBoost(_CatBoostBase):
 
         plot : bool, optional (default=False)
             If True, draw train and eval error for every set of parameters in Jupyter notebook
+
+        early_pruning_iterations : int, optional (default=0)
+            If positive, training of a set of parameters is stopped at iteration
+            early_pruning_iterations * 2^k if its eval metric on the test part is already worse
+            than the one of the best set of parameters at the same iteration.
+            Used only when search_by_train_test_split=True. 0 disables early pruning.
         Returns
         -------
         dict with two fields:
@@ -3353,12 +3423,14 @@ class CatBoost(_CatBoostBase):
             param_grid=param_grid, X=X, y=y, cv=cv, n_iter=-1,
             partition_random_seed=partition_random_seed, calc_cv_statistics=calc_cv_statistics,
             search_by_train_test_split=search_by_train_test_split, refit=refit, shuffle=shuffle,
-            stratified=stratified, train_size=train_size, verbose=verbose, plot=plot
+            stratified=stratified, train_size=train_size, verbose=verbose, plot=plot,
+            early_pruning_iterations=early_pruning_iterations
         )
 
     def randomized_search(self, param_distributions, X, y=None, cv=3, n_iter=10, partition_random_seed=0,
                           calc_cv_statistics=True, search_by_train_test_split=True, refit=True,
-                          shuffle=True, stratified=None, train_size=0.8, verbose=True, plot=False):
+                          shuffle=True, stratified=None, train_size=0.8, verbose=True, plot=False,
+                          early_pruning_iterations=0):
         """
         Randomized search on hyper parameters.
         After calling this method model is fitted and can be used, if not specified otherwise (refit=False).
@@ -3432,6 +3504,12 @@ class CatBoost(_CatBoostBase):
 
         plot : bool, optional (default=False)
             If True, draw train and eval error for every set of parameters in Jupyter notebook
+
+        early_pruning_iterations : int, optional (default=0)
+            If positive, training of a set of parameters is stopped at iteration
+            early_pruning_iterations * 2^k if its eval metric on the test part is already worse
+            than the one of the best set of parameters at the same iteration.
+            Used only when search_by_train_test_split=True. 0 disables early pruning.
         Returns
         -------
         dict with two fields:
@@ -3451,7 +3529,8 @@ class CatBoost(_CatBoostBase):
             param_grid=param_distributions, X=X, y=y, cv=cv, n_iter=n_iter,
             partition_random_seed=partition_random_seed, calc_cv_statistics=calc_cv_statistics,
             search_by_train_test_split=search_by_train_test_split, refit=refit, shuffle=shuffle,
-            stratified=stratified, train_size=train_size, verbose=verbose, plot=plot
+            stratified=stratified, train_size=train_size, verbose=verbose, plot=plot,
+            early_pruning_iterations=early_pruning_iterations
         )
 
     def _convert_to_asymmetric_representation(self):
@@ -3711,10 +3790,10 @@ class CatBoostClassifier(CatBoost):
         String format is: '0' for 1 device or '0:1:3' for multiple devices or '0-3' for range of devices.
         List format is : [0] for 1 device or [0,1,3] for multiple devices.
 
-    bootstrap_type : string, Bayesian, Bernoulli, Poisson, MVS.
+    bootstrap_type : string, Bayesian, Bernoulli, Poisson, MVS, GOSS.
         Default bootstrap is Bayesian for GPU and MVS for CPU.
         Poisson bootstrap is supported only on GPU.
-        MVS bootstrap is supported only on CPU.
+        MVS and GOSS bootstraps are supported only on CPU.
 
     subsample : float, [default=None]
         Sample rate for bagging. This parameter can be used Poisson or Bernoully bootstrap types.
@@ -3722,6 +3801,10 @@ class CatBoostClassifier(CatBoost):
     mvs-reg : float, [default is set automatically at each iteration based on gradient distribution]
         Regularization parameter for MVS sampling algorithm
 
+    goss_top_rate : float, [default=0.2]
+        Fraction of objects with the largest gradients that are always taken by GOSS sampling algorithm.
+        The rest of objects are sampled to get subsample fraction in total.
+
     monotone_constraints : list or numpy.ndarray or string or dict, [default=None]
         Monotone constraints for features.
 
@@ -3763,6 +3846,11 @@ class CatBoostClassifier(CatBoost):
         CPU only. Maximum allowed fraction of conflicting non-default values for features in exclusive features bundle.
         Should be a real value in [0, 1) interval.
 
+    cpu_histogram_precision : string, [Double,Float], [default=Double]
+        CPU only. Precision of bucket statistics accumulation in score calculation.
+        Float halves the memory traffic of statistics updates.
+        Changing this parameter can affect results due to numerical accuracy differences
+
     grow_policy : string, [SymmetricTree,Lossguide,Depthwise], [default=SymmetricTree]
         The tree growing policy. It describes how to perform greedy tree construction.
 
@@ -3974,11 +4062,13 @@ class CatBoostClassifier(CatBoost):
         bootstrap_type=None,
         subsample=None,
         mvs_reg=None,
+        goss_top_rate=None,
         sampling_unit=None,
         sampling_frequency=None,
         dev_score_calc_obj_block_size=None,
         dev_efb_max_buckets=None,
         sparse_features_conflict_fraction=None,
+        cpu_histogram_precision=None,
         max_depth=None,
         n_estimators=None,
         num_boost_round=None,
@@ -4529,11 +4619,13 @@ class CatBoostRegressor(CatBoost):
         bootstrap_type=None,
         subsample=None,
         mvs_reg=None,
+        goss_top_rate=None,
         sampling_frequency=None,
         sampling_unit=None,
         dev_score_calc_obj_block_size=None,
         dev_efb_max_buckets=None,
         sparse_features_conflict_fraction=None,
+        cpu_histogram_precision=None,
         max_depth=None,
         n_estimators=None,
         num_boost_round=None,
@@ -4,10 +4,16 @@
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/interrupt.h>
 #include <catboost/libs/helpers/matrix.h>
+#include <catboost/libs/helpers/polymorphic_type_containers.h>
 #include <catboost/libs/helpers/query_info_helper.h>
 #include <catboost/private/libs/options/plain_options_helper.h>
 #include <catboost/private/libs/target/data_providers.h>
 
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/cast.h>
+#include <util/generic/xrange.h>
+
 
 extern "C" PyObject* PyCatboostExceptionType;
 
@@ -106,6 +112,129 @@ TVector<TString> GetMetricNames(const TFullModel& model, const TVector<TString>&
     return metricNames;
 }
 
+void AddFloatFeaturesFromRowMajorMatrix(
+    const float* matrix,
+    ui32 objectCount,
+    ui32 featureCount,
+    NPar::TLocalExecutor* localExecutor,
+    NCB::IRawFeaturesOrderDataVisitor* builderVisitor
+) {
+    TVector<TVector<float>> columns(featureCount);
+    for (auto& column : columns) {
+        column.yresize(objectCount);
+    }
+
+    // transpose by small blocks of rows so that the source rows of a block stay in cache
+    constexpr ui32 ROWS_BLOCK_SIZE = 64;
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, SafeIntegerCast<int>(objectCount));
+    blockParams.SetBlockCountToThreadCount();
+    localExecutor->ExecRangeWithThrow(
+        [&] (int blockId) {
+            const ui32 blockBegin = blockId * blockParams.GetBlockSize();
+            const ui32 blockEnd = Min<ui32>(blockBegin + blockParams.GetBlockSize(), objectCount);
+            for (ui32 rowsBegin = blockBegin; rowsBegin < blockEnd; rowsBegin += ROWS_BLOCK_SIZE) {
+                const ui32 rowsEnd = Min(rowsBegin + ROWS_BLOCK_SIZE, blockEnd);
+                for (auto featureIdx : xrange(featureCount)) {
+                    float* dst = columns[featureIdx].data();
+                    const float* src = matrix + (size_t)rowsBegin * featureCount + featureIdx;
+                    for (ui32 objectIdx = rowsBegin; objectIdx < rowsEnd; ++objectIdx, src += featureCount) {
+                        dst[objectIdx] = *src;
+                    }
+                }
+            }
+        },
+        0,
+        blockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+
+    for (auto featureIdx : xrange(featureCount)) {
+        builderVisitor->AddFloatFeature(
+            featureIdx,
+            MakeIntrusive<NCB::TTypeCastArrayHolder<float, float>>(std::move(columns[featureIdx]))
+        );
+    }
+}
+
+TVector<ui32> MapCategoricalCodesToHashedCatValues(
+    ui32 flatFeatureIdx,
+    TConstArrayRef<i32> codes,
+    TConstArrayRef<ui32> categoriesAsHashedCatValues,
+    NPar::TLocalExecutor* localExecutor
+) {
+    TVector<ui32> hashedCatValues;
+    hashedCatValues.yresize(codes.size());
+    if (codes.empty()) {
+        return hashedCatValues;
+    }
+
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, SafeIntegerCast<int>(codes.size()));
+    blockParams.SetBlockCountToThreadCount();
+    localExecutor->ExecRangeWithThrow(
+        [&] (int blockId) {
+            const int blockEnd = Min(blockParams.FirstId + (blockId + 1) * blockParams.GetBlockSize(), blockParams.LastId);
+            for (int objectIdx = blockParams.FirstId + blockId * blockParams.GetBlockSize(); objectIdx < blockEnd; ++objectIdx) {
+                const i32 code = codes[objectIdx];
+                CB_ENSURE(
+                    code != -1,
+                    "Invalid type for cat_feature[object_idx=" << objectIdx << ",feature_idx=" << flatFeatureIdx
+                    << "]=NaN : cat_features must be integer or string, real number values and NaN values"
+                    " should be converted to string."
+                );
+                Y_ASSERT((size_t)code < categoriesAsHashedCatValues.size());
+                hashedCatValues[objectIdx] = categoriesAsHashedCatValues[code];
+            }
+        },
+        0,
+        blockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+
+    return hashedCatValues;
+}
+
+void CalcRawFormulaValsOnFloatFeaturesMatrix(
+    const TFullModel& model,
+    const float* matrix,
+    size_t objectCount,
+    size_t featureCount,
+    int treeBegin,
+    int treeEnd,
+    TArrayRef<double> results,
+    NPar::TLocalExecutor* localExecutor
+) {
+    CB_ENSURE(
+        !model.HasCategoricalFeatures() && !model.HasTextFeatures(),
+        "Model with categorical or text features can't be applied to a float features matrix"
+    );
+    CB_ENSURE(
+        featureCount >= model.GetNumFloatFeatures(),
+        "Matrix has " << featureCount << " features, but model expects at least " << model.GetNumFloatFeatures()
+    );
+    const int treeCount = SafeIntegerCast<int>(model.GetTreeCount());
+    if (treeBegin == 0 && treeEnd == 0) {
+        treeEnd = treeCount;
+    }
+    CB_ENSURE(0 <= treeBegin && treeBegin <= treeCount, "Out of range treeBegin=" << treeBegin);
+    CB_ENSURE(0 <= treeEnd && treeEnd <= treeCount, "Out of range treeEnd=" << treeEnd);
+    CB_ENSURE(treeBegin < treeEnd, "Empty tree range [" << treeBegin << ", " << treeEnd << ")");
+
+    if (objectCount == 0) {
+        return;
+    }
+    if (objectCount == 1) {
+        model.CalcFlatSingle(TConstArrayRef<float>(matrix, featureCount), treeBegin, treeEnd, results);
+        return;
+    }
+
+    TVector<TConstArrayRef<float>> features;
+    features.yresize(objectCount);
+    for (auto objectIdx : xrange(objectCount)) {
+        features[objectIdx] = TConstArrayRef<float>(matrix + objectIdx * featureCount, featureCount);
+    }
+    model.CalcFlatParallel(features, treeBegin, treeEnd, results, localExecutor);
+}
+
 TVector<double> EvalMetricsForUtils(
     TConstArrayRef<TVector<float>> label,
     const TVector<TVector<double>>& approx,
@@ -138,7 +267,8 @@ TVector<double> EvalMetricsForUtils(
             objectGrouping,
             subgroupId.empty() ? Nothing() : NCB::TMaybeData<TConstArrayRef<TSubgroupId>>(subgroupId),
             NCB::TWeights(groupId.size()),
-            pairs
+            pairs,
+            &executor
         ).Get();
     }
     TVector<double> metricResults;
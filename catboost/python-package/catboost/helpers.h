@@ -4,6 +4,7 @@
 
 #include <catboost/private/libs/algo/plot.h>
 #include <catboost/private/libs/data_types/groupid.h>
+#include <catboost/libs/data/visitor.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/mem_usage.h>
 #include <catboost/libs/metrics/metric.h>
@@ -49,6 +50,42 @@ TVector<TVector<double>> EvalMetrics(
 
 TVector<TString> GetMetricNames(const TFullModel& model, const TVector<TString>& metricsDescription);
 
+/* Adds all features of a C-contiguous objects x features float matrix as float feature columns.
+ * The matrix is transposed once in parallel instead of visiting it value by value.
+ */
+void AddFloatFeaturesFromRowMajorMatrix(
+    const float* matrix,
+    ui32 objectCount,
+    ui32 featureCount,
+    NPar::TLocalExecutor* localExecutor,
+    NCB::IRawFeaturesOrderDataVisitor* builderVisitor
+);
+
+/* Maps pandas.Categorical codes to the hashed values of the corresponding categories.
+ * Code -1 (NaN) is not allowed for categorical features.
+ */
+TVector<ui32> MapCategoricalCodesToHashedCatValues(
+    ui32 flatFeatureIdx,
+    TConstArrayRef<i32> codes,
+    TConstArrayRef<ui32> categoriesAsHashedCatValues,
+    NPar::TLocalExecutor* localExecutor
+);
+
+/* Calculates raw formula values of a model that uses only float features on a C-contiguous
+ * objects x features float matrix without building a data provider first.
+ * results are laid out as [objectIdx * approxDimension + dim], a single object is evaluated in the calling thread.
+ */
+void CalcRawFormulaValsOnFloatFeaturesMatrix(
+    const TFullModel& model,
+    const float* matrix,
+    size_t objectCount,
+    size_t featureCount,
+    int treeBegin,
+    int treeEnd,
+    TArrayRef<double> results,
+    NPar::TLocalExecutor* localExecutor
+);
+
 TVector<double> EvalMetricsForUtils(
     TConstArrayRef<TVector<float>> label,
     const TVector<TVector<double>>& approx,
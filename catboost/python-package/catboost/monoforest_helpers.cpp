@@ -5,13 +5,15 @@
 #include <catboost/libs/monoforest/model_import.h>
 #include <catboost/libs/monoforest/polynom.h>
 
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/system/info.h>
+
 namespace NMonoForest {
     static TPolynom BuildPolynom(const TAdditiveModel<TObliviousTree>& additiveModel) {
-        TPolynomBuilder polynomBuilder;
-        for (auto idx : xrange(additiveModel.Size())) {
-            polynomBuilder.AddTree(additiveModel.GetWeakModel(idx));
-        }
-        return polynomBuilder.Build();
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(NSystemInfo::CachedNumberOfCpus() - 1);
+        return BuildPolynom(additiveModel, /*minMonomWeight*/ 0, &localExecutor);
     }
 
     TVector<THumanReadableMonom> ConvertFullModelToPolynom(const TFullModel& fullModel) {